@@ -0,0 +1,435 @@
+//
+// AbstractConcurrentCache.h
+//
+// Library: Foundation
+// Package: Cache
+// Module:  AbstractConcurrentCache
+//
+// Definition of the AbstractConcurrentCache class.
+//
+// Copyright (c) 2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Foundation_AbstractConcurrentCache_INCLUDED
+#define Foundation_AbstractConcurrentCache_INCLUDED
+
+
+#include "Poco/KeyValueArgs.h"
+#include "Poco/FIFOEvent.h"
+#include "Poco/EventArgs.h"
+#include "Poco/SharedPtr.h"
+#include "Poco/Timestamp.h"
+#include "Poco/RWLock.h"
+#include "Poco/Mutex.h"
+#include "Poco/Exception.h"
+#include <unordered_map>
+#include <functional>
+#include <vector>
+#include <set>
+#include <atomic>
+#include <cstddef>
+
+
+namespace Poco {
+
+
+template <class TKey, class TValue, class THash = std::hash<TKey>, class TEventMutex = NullMutex>
+class AbstractConcurrentCache
+	/// AbstractConcurrentCache is the base class of the concurrent caches
+	/// (ConcurrentLRUCache, ConcurrentExpireLRUCache and
+	/// ConcurrentAccessExpireLRUCache).
+	///
+	/// It offers the same interface as AbstractCache, but is designed for
+	/// heavy concurrent use:
+	///
+	///   - The cache is split into a number of shards (selected by the
+	///     key's hash value), each with its own read/write lock, so that
+	///     threads accessing different keys rarely contend.
+	///
+	///   - Cache hits only acquire the shard's read lock. Instead of
+	///     maintaining an exact LRU list, each entry has a reference bit
+	///     that is set on access, and replacement uses the CLOCK
+	///     algorithm, an approximation of LRU.
+	///
+	///   - Events are only dispatched if delegates are registered.
+	///     To keep the fast path free of locks, events use a NullMutex
+	///     by default; delegates must therefore be registered before
+	///     the cache is accessed concurrently.
+	///
+	/// Entries can optionally expire a given time after they have been
+	/// added (or updated) or, if accessExpire is enabled, after they
+	/// have last been accessed.
+	///
+	/// The capacity is distributed evenly across the shards, so a cache
+	/// may start replacing entries slightly before it holds capacity
+	/// entries if the keys are distributed unevenly.
+	///
+	/// The key type must be default constructible, copyable, hashable
+	/// with THash and, for getAllKeys(), less-than comparable.
+{
+public:
+	FIFOEvent<const KeyValueArgs<TKey, TValue>, TEventMutex> Add;
+	FIFOEvent<const KeyValueArgs<TKey, TValue>, TEventMutex> Update;
+	FIFOEvent<const TKey, TEventMutex>                       Remove;
+	FIFOEvent<const TKey, TEventMutex>                       Get;
+	FIFOEvent<const EventArgs, TEventMutex>                  Clear;
+
+	typedef std::set<TKey> KeySet;
+
+	enum
+	{
+		DEFAULT_SHARDS     = 16,
+		MIN_SHARD_CAPACITY = 16
+	};
+
+	AbstractConcurrentCache(std::size_t capacity, Timestamp::TimeDiff expire, bool accessExpire, std::size_t shards):
+		_expire(expire*1000),
+		_accessExpire(accessExpire),
+		_shardCount(shardCount(capacity, shards)),
+		_pShards(new Shard[_shardCount])
+		/// Creates the AbstractConcurrentCache with the given total capacity,
+		/// distributed over the given number of shards (which is rounded to
+		/// a power of two, and reduced for small caches so that every
+		/// shard holds at least MIN_SHARD_CAPACITY entries).
+		///
+		/// If expire (given in milliseconds) is not zero, entries expire
+		/// after the given time. If accessExpire is true, the expiration
+		/// time is extended on every access.
+	{
+		std::size_t shardCapacity = (capacity + _shardCount - 1)/_shardCount;
+		for (std::size_t i = 0; i < _shardCount; ++i)
+		{
+			_pShards[i].init(shardCapacity);
+		}
+	}
+
+	virtual ~AbstractConcurrentCache()
+	{
+		delete [] _pShards;
+	}
+
+	void add(const TKey& key, const TValue& val)
+		/// Adds the key value pair to the cache.
+		/// If for the key already an entry exists, it will be overwritten.
+	{
+		SharedPtr<TValue> pVal(new TValue(val));
+		doAdd(key, pVal, false);
+	}
+
+	void add(const TKey& key, SharedPtr<TValue> val)
+		/// Adds the key value pair to the cache. Note that adding a NULL SharedPtr will fail!
+		/// If for the key already an entry exists, it will be overwritten, ie. first a remove event
+		/// is thrown, then a add event
+	{
+		doAdd(key, val, false);
+	}
+
+	void update(const TKey& key, const TValue& val)
+		/// Adds the key value pair to the cache.
+		/// If for the key already an entry exists, it will be overwritten.
+		/// The difference to add is that no remove or add events are thrown in this case,
+		/// just an Update is thrown.
+	{
+		SharedPtr<TValue> pVal(new TValue(val));
+		doAdd(key, pVal, true);
+	}
+
+	void update(const TKey& key, SharedPtr<TValue> val)
+		/// Adds the key value pair to the cache. Note that adding a NULL SharedPtr will fail!
+		/// If for the key already an entry exists, it will be overwritten.
+		/// The difference to add is that no remove or add events are thrown in this case,
+		/// just an Update is thrown.
+	{
+		doAdd(key, val, true);
+	}
+
+	void remove(const TKey& key)
+		/// Removes an entry from the cache. If the entry is not found,
+		/// the remove is ignored.
+	{
+		Shard& shard = shardFor(key);
+		RWLock::ScopedWriteLock lock(shard.lock);
+		typename Index::iterator it = shard.index.find(key);
+		if (it != shard.index.end()) doRemove(shard, it);
+	}
+
+	bool has(const TKey& key) const
+		/// Returns true if the cache contains a valid value for the key.
+	{
+		Shard& shard = shardFor(key);
+		RWLock::ScopedReadLock lock(shard.lock);
+		typename Index::const_iterator it = shard.index.find(key);
+		return it != shard.index.end() && !expired(shard.slots[it->second], Timestamp().epochMicroseconds());
+	}
+
+	SharedPtr<TValue> get(const TKey& key)
+		/// Returns a SharedPtr of the value. The SharedPointer will remain valid
+		/// even when cache replacement removes the element.
+		/// If for the key no value exists, an empty SharedPtr is returned.
+	{
+		Shard& shard = shardFor(key);
+		Timestamp::TimeVal now = _expire ? Timestamp().epochMicroseconds() : 0;
+		{
+			RWLock::ScopedReadLock lock(shard.lock);
+			typename Index::const_iterator it = shard.index.find(key);
+			if (it == shard.index.end()) return SharedPtr<TValue>();
+
+			Slot& slot = shard.slots[it->second];
+			if (!expired(slot, now))
+			{
+				slot.referenced.store(true, std::memory_order_relaxed);
+				if (_accessExpire) slot.expires.store(now + _expire, std::memory_order_relaxed);
+				if (!Get.empty()) Get.notify(this, key);
+				return slot.value;
+			}
+		}
+
+		RWLock::ScopedWriteLock lock(shard.lock);
+		typename Index::iterator it = shard.index.find(key);
+		if (it != shard.index.end() && expired(shard.slots[it->second], now))
+		{
+			doRemove(shard, it);
+		}
+		return SharedPtr<TValue>();
+	}
+
+	void clear()
+		/// Removes all elements from the cache.
+	{
+		if (!Clear.empty())
+		{
+			static EventArgs emptyArgs;
+			Clear.notify(this, emptyArgs);
+		}
+		for (std::size_t i = 0; i < _shardCount; ++i)
+		{
+			Shard& shard = _pShards[i];
+			RWLock::ScopedWriteLock lock(shard.lock);
+			shard.clear();
+		}
+	}
+
+	std::size_t size()
+		/// Returns the number of cached elements.
+	{
+		forceReplace();
+		std::size_t n = 0;
+		for (std::size_t i = 0; i < _shardCount; ++i)
+		{
+			Shard& shard = _pShards[i];
+			RWLock::ScopedReadLock lock(shard.lock);
+			n += shard.index.size();
+		}
+		return n;
+	}
+
+	std::size_t capacity() const
+		/// Returns the total capacity of the cache.
+	{
+		return _shardCount*_pShards[0].slots.size();
+	}
+
+	void forceReplace()
+		/// Removes all expired entries from the cache.
+	{
+		if (!_expire) return;
+
+		Timestamp::TimeVal now = Timestamp().epochMicroseconds();
+		for (std::size_t i = 0; i < _shardCount; ++i)
+		{
+			Shard& shard = _pShards[i];
+			RWLock::ScopedWriteLock lock(shard.lock);
+			typename Index::iterator it = shard.index.begin();
+			while (it != shard.index.end())
+			{
+				if (expired(shard.slots[it->second], now))
+					it = doRemove(shard, it);
+				else
+					++it;
+			}
+		}
+	}
+
+	KeySet getAllKeys()
+		/// Returns a copy of all keys stored in the cache.
+	{
+		forceReplace();
+		KeySet result;
+		for (std::size_t i = 0; i < _shardCount; ++i)
+		{
+			Shard& shard = _pShards[i];
+			RWLock::ScopedReadLock lock(shard.lock);
+			for (typename Index::const_iterator it = shard.index.begin(); it != shard.index.end(); ++it)
+			{
+				result.insert(it->first);
+			}
+		}
+		return result;
+	}
+
+protected:
+	struct Slot
+	{
+		Slot():
+			referenced(false),
+			expires(0)
+		{
+		}
+
+		TKey                             key;
+		SharedPtr<TValue>                value;
+		std::atomic<bool>                referenced;
+		std::atomic<Timestamp::TimeVal>  expires;
+	};
+
+	typedef std::unordered_map<TKey, std::size_t, THash> Index;
+
+	struct Shard
+	{
+		Shard():
+			hand(0)
+		{
+		}
+
+		void init(std::size_t capacity)
+		{
+			slots = std::vector<Slot>(capacity);
+			index.reserve(capacity);
+			clear();
+		}
+
+		void clear()
+		{
+			index.clear();
+			freeSlots.clear();
+			for (std::size_t i = slots.size(); i > 0; --i)
+			{
+				slots[i - 1].value = 0;
+				freeSlots.push_back(i - 1);
+			}
+			hand = 0;
+		}
+
+		RWLock                   lock;
+		Index                    index;
+		std::vector<Slot>        slots;
+		std::vector<std::size_t> freeSlots;
+		std::size_t              hand;
+		char                     padding[64];
+	};
+
+	static std::size_t shardCount(std::size_t capacity, std::size_t shards)
+	{
+		if (capacity < 1) throw InvalidArgumentException("capacity must be > 0");
+
+		// avoid tiny shards, which would make the effective
+		// capacity depend on the key distribution
+		if (shards > capacity/MIN_SHARD_CAPACITY) shards = capacity/MIN_SHARD_CAPACITY;
+		std::size_t n = 1;
+		while (n*2 <= shards) n *= 2;
+		return n;
+	}
+
+	Shard& shardFor(const TKey& key) const
+	{
+		UInt64 h = static_cast<UInt64>(_hash(key))*0x9E3779B97F4A7C15ULL;
+		return _pShards[static_cast<std::size_t>(h >> 32) & (_shardCount - 1)];
+	}
+
+	bool expired(const Slot& slot, Timestamp::TimeVal now) const
+	{
+		Timestamp::TimeVal expires = slot.expires.load(std::memory_order_relaxed);
+		return expires != 0 && expires <= now;
+	}
+
+	void doAdd(const TKey& key, SharedPtr<TValue>& val, bool isUpdate)
+	{
+		Shard& shard = shardFor(key);
+		Timestamp::TimeVal expires = _expire ? Timestamp().epochMicroseconds() + _expire : 0;
+		RWLock::ScopedWriteLock lock(shard.lock);
+
+		typename Index::iterator it = shard.index.find(key);
+		if (it != shard.index.end())
+		{
+			if (isUpdate)
+			{
+				if (!Update.empty())
+				{
+					KeyValueArgs<TKey, TValue> args(key, *val);
+					Update.notify(this, args);
+				}
+				Slot& slot = shard.slots[it->second];
+				slot.value = val;
+				slot.expires.store(expires, std::memory_order_relaxed);
+				return;
+			}
+			doRemove(shard, it);
+		}
+
+		if (!Add.empty())
+		{
+			KeyValueArgs<TKey, TValue> args(key, *val);
+			Add.notify(this, args);
+		}
+		std::size_t pos = freeSlot(shard);
+		Slot& slot = shard.slots[pos];
+		slot.key   = key;
+		slot.value = val;
+		slot.referenced.store(false, std::memory_order_relaxed);
+		slot.expires.store(expires, std::memory_order_relaxed);
+		shard.index.insert(typename Index::value_type(key, pos));
+	}
+
+	std::size_t freeSlot(Shard& shard)
+		/// Returns a free slot, evicting an entry using the
+		/// CLOCK algorithm if the shard is full.
+		/// Expired entries are evicted first.
+	{
+		if (shard.freeSlots.empty())
+		{
+			Timestamp::TimeVal now = _expire ? Timestamp().epochMicroseconds() : 0;
+			std::size_t n = shard.slots.size();
+			for (;;)
+			{
+				Slot& slot = shard.slots[shard.hand];
+				shard.hand = (shard.hand + 1) % n;
+				if (!expired(slot, now) && slot.referenced.exchange(false, std::memory_order_relaxed))
+					continue;
+				doRemove(shard, shard.index.find(slot.key));
+				break;
+			}
+		}
+		std::size_t pos = shard.freeSlots.back();
+		shard.freeSlots.pop_back();
+		return pos;
+	}
+
+	typename Index::iterator doRemove(Shard& shard, typename Index::iterator it)
+	{
+		if (!Remove.empty()) Remove.notify(this, it->first);
+		std::size_t pos = it->second;
+		shard.slots[pos].value = 0;
+		shard.freeSlots.push_back(pos);
+		return shard.index.erase(it);
+	}
+
+	Timestamp::TimeDiff _expire;
+	bool                _accessExpire;
+	std::size_t         _shardCount;
+	Shard*              _pShards;
+	THash               _hash;
+
+private:
+	AbstractConcurrentCache(const AbstractConcurrentCache& aCache);
+	AbstractConcurrentCache& operator = (const AbstractConcurrentCache& aCache);
+};
+
+
+} // namespace Poco
+
+
+#endif // Foundation_AbstractConcurrentCache_INCLUDED
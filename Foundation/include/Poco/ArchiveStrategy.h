@@ -36,9 +36,15 @@ class Foundation_API ArchiveStrategy
 	/// to rename a rotated log file for archiving.
 	///
 	/// Archived files can be automatically compressed,
-	/// using the gzip file format.
+	/// using the gzip or the LZ4 file format.
 {
 public:
+	enum CompressionMethod
+	{
+		COMPRESS_GZIP, /// Compress archived files in gzip format, adding a ".gz" extension.
+		COMPRESS_LZ4   /// Compress archived files in LZ4 frame format, adding a ".lz4" extension.
+	};
+
 	ArchiveStrategy();
 	virtual ~ArchiveStrategy();
 
@@ -50,6 +56,16 @@ public:
 	void compress(bool flag = true);
 		/// Enables or disables compression of archived files.	
 
+	void setCompressionMethod(CompressionMethod method);
+		/// Sets the method used for compressing archived files.
+		/// The default is COMPRESS_GZIP.
+		///
+		/// LZ4 compresses several times faster than gzip,
+		/// at the cost of larger files.
+
+	CompressionMethod getCompressionMethod() const;
+		/// Returns the method used for compressing archived files.
+
 protected:
 	void moveFile(const std::string& oldName, const std::string& newName);
 	bool exists(const std::string& name);
@@ -59,6 +75,7 @@ private:
 	ArchiveStrategy& operator = (const ArchiveStrategy&);
 	
 	bool _compress;
+	CompressionMethod _compressionMethod;
 	ArchiveCompressor* _pCompressor;
 };
 
@@ -0,0 +1,307 @@
+//
+// Arena.h
+//
+// Library: Foundation
+// Package: Core
+// Module:  Arena
+//
+// Definition of the Arena and ArenaAllocator classes.
+//
+// Copyright (c) 2005-2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Foundation_Arena_INCLUDED
+#define Foundation_Arena_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <type_traits>
+
+
+namespace Poco {
+
+
+class Foundation_API Arena
+	/// A monotonic ("bump pointer") memory arena.
+	///
+	/// Memory is carved sequentially out of large chunks obtained
+	/// from the heap. Individual allocations are never returned to
+	/// the heap; instead, all memory is released at once when the
+	/// Arena is reset or destroyed. This makes allocation a pointer
+	/// increment and freeing an object graph a single operation, which
+	/// is ideal for short-lived data structures such as the result of
+	/// parsing a small document.
+	///
+	/// Objects created with create() have their destructors called
+	/// (in reverse order of creation) when the Arena is reset or
+	/// destroyed. Memory obtained with allocate() is raw memory; any
+	/// objects constructed in it by the caller are not destroyed.
+	///
+	/// The initial chunk can be supplied by the caller (e.g., a
+	/// buffer on the stack), in which case no heap allocation takes
+	/// place until it is exhausted.
+	///
+	/// An Arena is not thread safe.
+{
+public:
+	enum
+	{
+		DEFAULT_CHUNK_SIZE = 4096,
+		MAX_CHUNK_SIZE     = 1024*1024
+	};
+
+	explicit Arena(std::size_t chunkSize = DEFAULT_CHUNK_SIZE);
+		/// Creates the Arena. The first chunk, of chunkSize bytes,
+		/// is allocated when memory is first requested. Subsequent
+		/// chunks double in size, up to MAX_CHUNK_SIZE.
+
+	Arena(void* pBuffer, std::size_t size, std::size_t chunkSize = DEFAULT_CHUNK_SIZE);
+		/// Creates the Arena using the given buffer as the first
+		/// chunk. The buffer is not owned by the Arena and must
+		/// remain valid for the lifetime of the Arena.
+
+	~Arena();
+		/// Destroys all objects created with create() and
+		/// releases all memory.
+
+	void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+		/// Returns a block of at least size bytes, aligned to
+		/// the given alignment, which must be a power of two.
+
+	void deallocate(void* ptr, std::size_t size);
+		/// Returns memory to the Arena. This only has an effect
+		/// if ptr is the most recent allocation, in which case the
+		/// memory is immediately reused. Otherwise, memory is
+		/// reclaimed when the Arena is reset.
+
+	template <typename T, typename... Args>
+	T* create(Args&&... args)
+		/// Creates an object of type T in the Arena. The object's
+		/// destructor is called when the Arena is reset or destroyed.
+	{
+		if (std::is_trivially_destructible<T>::value)
+		{
+			return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+		}
+		else
+		{
+			Finalizer* pFinalizer = static_cast<Finalizer*>(allocate(sizeof(Finalizer), alignof(Finalizer)));
+			T* pObj = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+			pFinalizer->destroy = &destroy<T>;
+			pFinalizer->pObj    = pObj;
+			pFinalizer->pNext   = _pFinalizers;
+			_pFinalizers = pFinalizer;
+			return pObj;
+		}
+	}
+
+	char* copy(const char* str, std::size_t length);
+		/// Copies length characters from str into the Arena, appends
+		/// a terminating zero byte and returns a pointer to the copy.
+
+	void reset();
+		/// Destroys all objects created with create() and makes all
+		/// memory available again. The largest chunk is retained
+		/// for subsequent allocations; all other chunks are freed.
+
+	void release();
+		/// Destroys all objects created with create() and frees
+		/// all chunks.
+
+	std::size_t allocated() const;
+		/// Returns the number of bytes handed out since the Arena
+		/// was created or last reset, including alignment padding.
+
+	std::size_t capacity() const;
+		/// Returns the total size of all chunks currently owned
+		/// by the Arena, excluding a user-supplied buffer.
+
+private:
+	struct Chunk
+	{
+		Chunk*      pNext;
+		std::size_t size;
+	};
+
+	struct Finalizer
+	{
+		void (*destroy)(void*);
+		void*      pObj;
+		Finalizer* pNext;
+	};
+
+	template <typename T>
+	static void destroy(void* pObj)
+	{
+		static_cast<T*>(pObj)->~T();
+	}
+
+	Arena(const Arena&);
+	Arena& operator = (const Arena&);
+
+	void* allocateSlow(std::size_t size, std::size_t alignment);
+	void finalize();
+	void freeChunks(Chunk* pKeep);
+
+	std::size_t _chunkSize;
+	Chunk*      _pChunks;
+	char*       _pBuffer;
+	std::size_t _bufferSize;
+	char*       _pCurrent;
+	char*       _pEnd;
+	char*       _pLast;
+	std::size_t _allocated;
+	std::size_t _capacity;
+	Finalizer*  _pFinalizers;
+};
+
+
+template <typename T>
+class ArenaAllocator
+	/// A standard library compatible allocator that obtains
+	/// its memory from an Arena.
+	///
+	/// This allows standard containers and strings to be placed in
+	/// an Arena, for example:
+	///
+	///     Poco::Arena arena;
+	///     std::vector<int, Poco::ArenaAllocator<int>> vec(Poco::ArenaAllocator<int>(arena));
+	///
+	/// Since the Arena does not free memory individually, a container
+	/// using an ArenaAllocator must not outlive the Arena, and the
+	/// Arena should not be reset while such a container is alive.
+	///
+	/// A default constructed ArenaAllocator uses the global heap
+	/// instead. This allows classes to offer an Arena as an option,
+	/// with a single container type.
+{
+public:
+	typedef T                 value_type;
+	typedef T*                pointer;
+	typedef const T*          const_pointer;
+	typedef T&                reference;
+	typedef const T&          const_reference;
+	typedef std::size_t       size_type;
+	typedef std::ptrdiff_t    difference_type;
+
+	template <typename U>
+	struct rebind
+	{
+		typedef ArenaAllocator<U> other;
+	};
+
+	ArenaAllocator() noexcept:
+		_pArena(0)
+		/// Creates an ArenaAllocator using the global heap.
+	{
+	}
+
+	ArenaAllocator(Arena& arena) noexcept:
+		_pArena(&arena)
+		/// Creates the ArenaAllocator for the given Arena.
+	{
+	}
+
+	template <typename U>
+	ArenaAllocator(const ArenaAllocator<U>& other) noexcept:
+		_pArena(other.arena())
+		/// Creates the ArenaAllocator from an ArenaAllocator for
+		/// another type, using the same Arena.
+	{
+	}
+
+	T* allocate(std::size_t n)
+		/// Allocates memory for n objects of type T.
+	{
+		if (_pArena)
+			return static_cast<T*>(_pArena->allocate(n*sizeof(T), alignof(T)));
+		else
+			return static_cast<T*>(::operator new(n*sizeof(T)));
+	}
+
+	void deallocate(T* p, std::size_t n) noexcept
+		/// Returns memory to the Arena. See Arena::deallocate().
+	{
+		if (_pArena)
+			_pArena->deallocate(p, n*sizeof(T));
+		else
+			::operator delete(p);
+	}
+
+	Arena* arena() const noexcept
+		/// Returns the Arena, or a null pointer if the
+		/// ArenaAllocator uses the global heap.
+	{
+		return _pArena;
+	}
+
+private:
+	Arena* _pArena;
+};
+
+
+template <typename T, typename U>
+inline bool operator == (const ArenaAllocator<T>& a1, const ArenaAllocator<U>& a2)
+{
+	return a1.arena() == a2.arena();
+}
+
+
+template <typename T, typename U>
+inline bool operator != (const ArenaAllocator<T>& a1, const ArenaAllocator<U>& a2)
+{
+	return a1.arena() != a2.arena();
+}
+
+
+//
+// inlines
+//
+inline void* Arena::allocate(std::size_t size, std::size_t alignment)
+{
+	std::size_t pad = (alignment - (reinterpret_cast<std::size_t>(_pCurrent) & (alignment - 1))) & (alignment - 1);
+	if (_pCurrent && size + pad <= static_cast<std::size_t>(_pEnd - _pCurrent))
+	{
+		_pLast = _pCurrent + pad;
+		_pCurrent = _pLast + size;
+		_allocated += size + pad;
+		return _pLast;
+	}
+	return allocateSlow(size, alignment);
+}
+
+
+inline void Arena::deallocate(void* ptr, std::size_t size)
+{
+	if (ptr && ptr == _pLast && _pLast + size == _pCurrent)
+	{
+		_allocated -= size;
+		_pCurrent = _pLast;
+		_pLast = 0;
+	}
+}
+
+
+inline std::size_t Arena::allocated() const
+{
+	return _allocated;
+}
+
+
+inline std::size_t Arena::capacity() const
+{
+	return _capacity;
+}
+
+
+} // namespace Poco
+
+
+#endif // Foundation_Arena_INCLUDED
@@ -94,6 +94,19 @@ public:
 	Base32Decoder(std::istream& istr);
 	~Base32Decoder();
 
+	static std::size_t decode(const char* encoded, std::size_t length, char* data);
+		/// Decodes length base32-encoded characters starting at encoded,
+		/// and stores the result in data, which must have room for at
+		/// least decodedLength(length) bytes. The final group may
+		/// be unpadded.
+		///
+		/// Returns the number of bytes written.
+		/// Throws a DataFormatException if the input is not valid base32.
+
+	static std::size_t decodedLength(std::size_t length);
+		/// Returns the maximum number of bytes decode() writes
+		/// for length characters.
+
 private:
 	Base32Decoder(const Base32Decoder&);
 	Base32Decoder& operator = (const Base32Decoder&);
@@ -43,6 +43,10 @@ public:
 	int close();
 		/// Closes the stream buffer.
 
+protected:
+	std::streamsize xsputn(const char* s, std::streamsize n);
+		/// Encodes complete groups of bytes in bulk.
+
 private:
 	int writeToDevice(char c);
 
@@ -54,6 +58,8 @@ private:
 	static const unsigned char OUT_ENCODING[32];
 	
 	friend class Base32DecoderBuf;
+	friend class Base32Encoder;
+	friend class Base32Decoder;
 
 	Base32EncoderBuf(const Base32EncoderBuf&);
 	Base32EncoderBuf& operator = (const Base32EncoderBuf&);
@@ -100,6 +106,17 @@ public:
 	Base32Encoder(std::ostream& ostr, bool padding = true);
 	~Base32Encoder();
 
+	static std::size_t encode(const char* data, std::size_t length, char* encoded, bool padding = true);
+		/// Base32-encodes length bytes starting at data, and
+		/// stores the result in encoded, which must have room
+		/// for at least encodedLength(length, padding) characters.
+		///
+		/// Returns the number of characters written.
+
+	static std::size_t encodedLength(std::size_t length, bool padding = true);
+		/// Returns the number of characters encode() writes
+		/// for length bytes.
+
 private:
 	Base32Encoder(const Base32Encoder&);
 	Base32Encoder& operator = (const Base32Encoder&);
@@ -98,6 +98,20 @@ public:
 	Base64Decoder(std::istream& istr, int options = 0);
 	~Base64Decoder();
 
+	static std::size_t decode(const char* encoded, std::size_t length, char* data, int options = 0);
+		/// Decodes length base64-encoded characters starting at encoded,
+		/// and stores the result in data, which must have room for at
+		/// least decodedLength(length) bytes. Whitespace is skipped
+		/// (unless BASE64_URL_ENCODING is given). If BASE64_NO_PADDING
+		/// is given, the final group may be incomplete.
+		///
+		/// Returns the number of bytes written.
+		/// Throws a DataFormatException if the input is not valid base64.
+
+	static std::size_t decodedLength(std::size_t length);
+		/// Returns the maximum number of bytes decode() writes
+		/// for length characters.
+
 private:
 	Base64Decoder(const Base64Decoder&);
 	Base64Decoder& operator = (const Base64Decoder&);
@@ -67,6 +67,10 @@ public:
 	int getLineLength() const;
 		/// Returns the currently set line length.
 
+protected:
+	std::streamsize xsputn(const char* s, std::streamsize n);
+		/// Encodes complete groups of bytes in bulk.
+
 private:
 	int writeToDevice(char c);
 
@@ -82,6 +86,8 @@ private:
 	static const unsigned char OUT_ENCODING_URL[64];
 
 	friend class Base64DecoderBuf;
+	friend class Base64Encoder;
+	friend class Base64Decoder;
 
 	Base64EncoderBuf(const Base64EncoderBuf&);
 	Base64EncoderBuf& operator = (const Base64EncoderBuf&);
@@ -128,6 +134,23 @@ public:
 	Base64Encoder(std::ostream& ostr, int options = 0);
 	~Base64Encoder();
 
+	static std::size_t encode(const char* data, std::size_t length, char* encoded, int options = 0);
+		/// Base64-encodes length bytes starting at data, and
+		/// stores the result in encoded, which must have room
+		/// for at least encodedLength(length, options) characters.
+		/// Only BASE64_URL_ENCODING and BASE64_NO_PADDING are
+		/// supported as options; no line breaks are written.
+		///
+		/// Returns the number of characters written.
+		///
+		/// This is considerably faster than writing the data
+		/// to a Base64Encoder and should be used for data that
+		/// is already completely in memory.
+
+	static std::size_t encodedLength(std::size_t length, int options = 0);
+		/// Returns the number of characters encode() writes
+		/// for length bytes.
+
 private:
 	Base64Encoder(const Base64Encoder&);
 	Base64Encoder& operator = (const Base64Encoder&);
@@ -0,0 +1,70 @@
+//
+// CPUFeatures.h
+//
+// Library: Foundation
+// Package: Core
+// Module:  CPUFeatures
+//
+// Definition of the CPUFeatures class.
+//
+// Copyright (c) 2004-2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Foundation_CPUFeatures_INCLUDED
+#define Foundation_CPUFeatures_INCLUDED
+
+
+#include "Poco/Foundation.h"
+
+
+//
+// Functions using intrinsics for instruction set extensions that
+// may not be available on all CPUs must be declared with POCO_TARGET,
+// and must only be called if CPUFeatures reports the extensions.
+//
+#if (POCO_ARCH == POCO_ARCH_AMD64 || POCO_ARCH == POCO_ARCH_IA32) && (defined(__GNUC__) || defined(__clang__) || defined(_MSC_VER))
+	#define POCO_HAVE_X86_INTRINSICS
+	#if defined(_MSC_VER) && !defined(__clang__)
+		#define POCO_TARGET(features)
+	#else
+		#define POCO_TARGET(features) __attribute__((target(features)))
+	#endif
+#endif
+
+
+namespace Poco {
+
+
+class Foundation_API CPUFeatures
+	/// This class detects, at runtime, which instruction
+	/// set extensions relevant for accelerated code paths
+	/// in Foundation are supported by the CPU.
+	///
+	/// On non-x86 architectures, all functions return false.
+{
+public:
+	static bool hasSSE42();
+		/// Returns true if the CPU supports SSE 4.2 (including
+		/// the CRC32 instruction) as well as SSSE3 and SSE 4.1.
+
+	static bool hasPCLMUL();
+		/// Returns true if the CPU supports carry-less multiplication
+		/// (PCLMULQDQ) and SSE 4.1.
+
+	static bool hasAVX2();
+		/// Returns true if the CPU and operating system support AVX2.
+
+	static bool hasSHA();
+		/// Returns true if the CPU supports the SHA extensions
+		/// (SHA-NI) as well as SSSE3 and SSE 4.1.
+};
+
+
+} // namespace Poco
+
+
+#endif // Foundation_CPUFeatures_INCLUDED
@@ -26,7 +26,7 @@ namespace Poco {
 
 
 class Foundation_API Checksum32 : public ChecksumImpl
-	/// This class calculates CRC-32 or Adler-32 checksums
+	/// This class calculates CRC-32, CRC-32C or Adler-32 checksums
 	/// for arbitrary data.
 	///
 	/// A cyclic redundancy check (CRC) is a type of hash function, which is used to produce a
@@ -37,7 +37,15 @@ class Foundation_API Checksum32 : public ChecksumImpl
 	/// It is almost as reliable as a 32-bit cyclic redundancy check for protecting against
 	/// accidental modification of data, such as distortions occurring during a transmission,
 	/// but is significantly faster to calculate in software.
-	
+	///
+	/// CRC-32C uses the Castagnoli polynomial (as used by iSCSI, ext4
+	/// and many storage formats), which has better error detection
+	/// properties than CRC-32.
+	///
+	/// On x86 CPUs supporting SSE 4.2 and PCLMULQDQ, CRC-32 and CRC-32C
+	/// are computed using the CPU's CRC32 and carry-less multiplication
+	/// instructions. The CPU features are detected at runtime; on other
+	/// CPUs a table-driven (slicing-by-8) implementation is used.
 {
 public:
 	Checksum32();
@@ -64,6 +72,18 @@ public:
 	ChecksumImpl::Type type() const;
 		/// Which type of checksum are we calculating.
 
+	static Poco::UInt32 updateCRC32(Poco::UInt32 crc, const char* data, std::size_t length);
+		/// Updates the given CRC-32 value (0 for the first block)
+		/// with the given data, and returns the updated value.
+
+	static Poco::UInt32 updateCRC32C(Poco::UInt32 crc, const char* data, std::size_t length);
+		/// Updates the given CRC-32C value (0 for the first block)
+		/// with the given data, and returns the updated value.
+
+	static bool isHardwareAccelerated(ChecksumImpl::Type t);
+		/// Returns true if the given checksum type is computed
+		/// using special CPU instructions on this machine.
+
 private:
 	Type         _type;
 	Poco::UInt32 _value;
@@ -26,7 +26,8 @@ namespace Poco {
 
 
 class Foundation_API Checksum64 : public ChecksumImpl
-	/// This class calculates CRC-64 checksums for arbitrary data.
+	/// This class calculates CRC-64 checksums or XXH64 hashes
+	/// for arbitrary data.
 	///
 	/// The algorithm and table are based on the polynomial
 	///
@@ -38,13 +39,23 @@ class Foundation_API Checksum64 : public ChecksumImpl
 	/// Implementation is adapted from the DLT1 spec:
 	///   ECMA - 182, http://www.ecma-international.org/publications/standards/Ecma-182.htm
 	///
+	/// Note that for CRC-64, every call to update() starts a new checksum.
+	///
+	/// XXH64 is the 64-bit variant of the xxHash non-cryptographic hash
+	/// function by Yann Collet (https://github.com/Cyan4973/xxHash), which
+	/// processes data several times faster than a table-driven CRC.
+	/// XXH64 hashes are computed incrementally over all calls to update().
 {
 public:
 	Checksum64();
 		/// Creates a CRC-64 checksum initialized to 0.
 
 	Checksum64(Type t);
-		/// Creates the Checksum64, using the given type.
+		/// Creates the Checksum64, using the given type,
+		/// which must be TYPE_CRC64_IMPL or TYPE_XXH64_IMPL.
+
+	Checksum64(Type t, Poco::UInt64 seed);
+		/// Creates a Checksum64 of type TYPE_XXH64_IMPL, using the given seed.
 
 	~Checksum64();
 		/// Destroys the Checksum64.
@@ -64,12 +75,24 @@ public:
 	ChecksumImpl::Type type() const;
 		/// Which type of checksum are we calculating.
 
+	static Poco::UInt64 xxHash64(const char* data, std::size_t length, Poco::UInt64 seed = 0);
+		/// Returns the XXH64 hash of the given data.
+
 private:
+	void updateXXH64(const unsigned char* data, std::size_t length);
+	void finalizeXXH64();
+
 	static Poco::UInt64 _initCRC64Val;
 	static Poco::UInt64 _finXORVal;
 	static const unsigned _tableSize = 256;
 	static Poco::UInt64 _crcTable[_tableSize];
-	Poco::UInt64 _value;
+	Type          _type;
+	Poco::UInt64  _value;
+	Poco::UInt64  _seed;
+	Poco::UInt64  _acc[4];
+	Poco::UInt64  _totalLength;
+	unsigned char _buffer[32];
+	unsigned      _bufferLength;
 };
 
 
@@ -96,7 +119,7 @@ inline Poco::UInt64 Checksum64::checksum() const
 
 inline ChecksumImpl::Type Checksum64::type() const
 {
-	return TYPE_CRC64_IMPL;
+	return _type;
 }
 
 
@@ -0,0 +1,61 @@
+//
+// ConcurrentAccessExpireLRUCache.h
+//
+// Library: Foundation
+// Package: Cache
+// Module:  ConcurrentAccessExpireLRUCache
+//
+// Definition of the ConcurrentAccessExpireLRUCache class.
+//
+// Copyright (c) 2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Foundation_ConcurrentAccessExpireLRUCache_INCLUDED
+#define Foundation_ConcurrentAccessExpireLRUCache_INCLUDED
+
+
+#include "Poco/AbstractConcurrentCache.h"
+
+
+namespace Poco {
+
+
+template <
+	class TKey,
+	class TValue,
+	class THash = std::hash<TKey>,
+	class TEventMutex = NullMutex
+>
+class ConcurrentAccessExpireLRUCache: public AbstractConcurrentCache<TKey, TValue, THash, TEventMutex>
+	/// A ConcurrentAccessExpireLRUCache combines approximated LRU caching and
+	/// time based expire caching for heavy concurrent use.
+	/// It caches entries for a fixed time period (per default 10 minutes),
+	/// which is extended on every access, but also limits the size of the
+	/// cache (per default: 1024).
+	///
+	/// See AbstractConcurrentCache for details.
+{
+public:
+	ConcurrentAccessExpireLRUCache(std::size_t cacheSize = 1024, Timestamp::TimeDiff expire = 600000, std::size_t shards = AbstractConcurrentCache<TKey, TValue, THash, TEventMutex>::DEFAULT_SHARDS):
+		AbstractConcurrentCache<TKey, TValue, THash, TEventMutex>(cacheSize, expire, true, shards)
+	{
+	}
+
+	~ConcurrentAccessExpireLRUCache()
+	{
+	}
+
+private:
+	ConcurrentAccessExpireLRUCache(const ConcurrentAccessExpireLRUCache& aCache);
+	ConcurrentAccessExpireLRUCache& operator = (const ConcurrentAccessExpireLRUCache& aCache);
+};
+
+
+} // namespace Poco
+
+
+#endif // Foundation_ConcurrentAccessExpireLRUCache_INCLUDED
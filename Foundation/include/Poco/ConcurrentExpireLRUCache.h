@@ -0,0 +1,60 @@
+//
+// ConcurrentExpireLRUCache.h
+//
+// Library: Foundation
+// Package: Cache
+// Module:  ConcurrentExpireLRUCache
+//
+// Definition of the ConcurrentExpireLRUCache class.
+//
+// Copyright (c) 2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Foundation_ConcurrentExpireLRUCache_INCLUDED
+#define Foundation_ConcurrentExpireLRUCache_INCLUDED
+
+
+#include "Poco/AbstractConcurrentCache.h"
+
+
+namespace Poco {
+
+
+template <
+	class TKey,
+	class TValue,
+	class THash = std::hash<TKey>,
+	class TEventMutex = NullMutex
+>
+class ConcurrentExpireLRUCache: public AbstractConcurrentCache<TKey, TValue, THash, TEventMutex>
+	/// A ConcurrentExpireLRUCache combines approximated LRU caching and time based
+	/// expire caching for heavy concurrent use.
+	/// It caches entries for a fixed time period (per default 10 minutes)
+	/// but also limits the size of the cache (per default: 1024).
+	///
+	/// See AbstractConcurrentCache for details.
+{
+public:
+	ConcurrentExpireLRUCache(std::size_t cacheSize = 1024, Timestamp::TimeDiff expire = 600000, std::size_t shards = AbstractConcurrentCache<TKey, TValue, THash, TEventMutex>::DEFAULT_SHARDS):
+		AbstractConcurrentCache<TKey, TValue, THash, TEventMutex>(cacheSize, expire, false, shards)
+	{
+	}
+
+	~ConcurrentExpireLRUCache()
+	{
+	}
+
+private:
+	ConcurrentExpireLRUCache(const ConcurrentExpireLRUCache& aCache);
+	ConcurrentExpireLRUCache& operator = (const ConcurrentExpireLRUCache& aCache);
+};
+
+
+} // namespace Poco
+
+
+#endif // Foundation_ConcurrentExpireLRUCache_INCLUDED
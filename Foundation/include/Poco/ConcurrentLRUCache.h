@@ -0,0 +1,58 @@
+//
+// ConcurrentLRUCache.h
+//
+// Library: Foundation
+// Package: Cache
+// Module:  ConcurrentLRUCache
+//
+// Definition of the ConcurrentLRUCache class.
+//
+// Copyright (c) 2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Foundation_ConcurrentLRUCache_INCLUDED
+#define Foundation_ConcurrentLRUCache_INCLUDED
+
+
+#include "Poco/AbstractConcurrentCache.h"
+
+
+namespace Poco {
+
+
+template <
+	class TKey,
+	class TValue,
+	class THash = std::hash<TKey>,
+	class TEventMutex = NullMutex
+>
+class ConcurrentLRUCache: public AbstractConcurrentCache<TKey, TValue, THash, TEventMutex>
+	/// A ConcurrentLRUCache implements approximated Least Recently Used caching
+	/// for heavy concurrent use. The default size for a cache is 1024 entries.
+	///
+	/// See AbstractConcurrentCache for details.
+{
+public:
+	ConcurrentLRUCache(std::size_t size = 1024, std::size_t shards = AbstractConcurrentCache<TKey, TValue, THash, TEventMutex>::DEFAULT_SHARDS):
+		AbstractConcurrentCache<TKey, TValue, THash, TEventMutex>(size, 0, false, shards)
+	{
+	}
+
+	~ConcurrentLRUCache()
+	{
+	}
+
+private:
+	ConcurrentLRUCache(const ConcurrentLRUCache& aCache);
+	ConcurrentLRUCache& operator = (const ConcurrentLRUCache& aCache);
+};
+
+
+} // namespace Poco
+
+
+#endif // Foundation_ConcurrentLRUCache_INCLUDED
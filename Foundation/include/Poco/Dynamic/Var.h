@@ -26,6 +26,7 @@
 #include "Poco/Dynamic/VarHolder.h"
 #include "Poco/Dynamic/VarIterator.h"
 #include <typeinfo>
+#include <utility>
 #include <map>
 #include <set>
 
@@ -104,9 +105,23 @@ public:
 	Var(const char* pVal);
 		// Convenience constructor for const char* which gets mapped to a std::string internally, i.e. pVal is deep-copied.
 
+	Var(std::string&& val);
+		/// Creates the Var from the given string, which is moved
+		/// into the Var instead of being copied.
+
 	Var(const Var& other);
 		/// Copy constructor.
 
+#ifdef POCO_NO_SOO
+	Var(Var&& other) noexcept;
+#else
+	Var(Var&& other);
+#endif
+		/// Move constructor. Takes over the value held by other,
+		/// which is left empty. No value holder is cloned, unless
+		/// small object optimization is enabled and the holder of
+		/// other is stored in place.
+
 	~Var();
 		/// Destroys the Var.
 
@@ -227,6 +242,25 @@ public:
 				std::string(typeid(T).name())));
 	}
 
+	template <typename T>
+	const T* tryGet() const
+		/// Returns a pointer to the actual value, or a null pointer
+		/// if the Var is empty or holds a value of another type.
+		///
+		/// Unlike extract(), this never throws, and unlike convert(),
+		/// the value is neither copied nor converted, so a string
+		/// can be inspected without allocating memory:
+		///     if (const std::string* pStr = var.tryGet<std::string>())
+		///         length += pStr->size();
+	{
+		VarHolder* pHolder = content();
+
+		if (pHolder && pHolder->type() == typeid(T))
+			return &static_cast<VarHolderImpl<T>*>(pHolder)->value();
+		else
+			return 0;
+	}
+
 	template <typename T>
 	Var& operator = (const T& other)
 		/// Assignment operator for assigning POD to Var
@@ -246,6 +280,17 @@ public:
 	Var& operator = (const Var& other);
 		/// Assignment operator specialization for Var
 
+#ifdef POCO_NO_SOO
+	Var& operator = (Var&& other) noexcept;
+#else
+	Var& operator = (Var&& other);
+#endif
+		/// Move assignment operator. Takes over the value
+		/// held by other, which is left empty.
+
+	Var& operator = (std::string&& other);
+		/// Assignment operator that moves the given string into the Var.
+
 	template <typename T>
 	const Var operator + (const T& other) const
 		/// Addition operator for adding POD to Var
@@ -660,6 +705,20 @@ private:
 		}
 	}
 
+	void construct(std::string&& value)
+	{
+		if (sizeof(VarHolderImpl<std::string>) <= Placeholder<std::string>::Size::value)
+		{
+			new (reinterpret_cast<VarHolder*>(_placeholder.holder)) VarHolderImpl<std::string>(std::move(value));
+			_placeholder.setLocal(true);
+		}
+		else
+		{
+			_placeholder.pHolder = new VarHolderImpl<std::string>(std::move(value));
+			_placeholder.setLocal(false);
+		}
+	}
+
 	void construct(const Var& other)
 	{
 		if (!other.isEmpty())
@@ -668,6 +727,28 @@ private:
 			_placeholder.erase();
 	}
 
+	void construct(Var&& other)
+		/// Takes over the holder of other if it is on the heap,
+		/// otherwise clones it. Either way, other is left empty.
+	{
+		if (other.isEmpty())
+		{
+			_placeholder.erase();
+		}
+		else if (other._placeholder.isLocal())
+		{
+			other.content()->clone(&_placeholder);
+			other.destruct();
+			other._placeholder.erase();
+		}
+		else
+		{
+			_placeholder.pHolder = other._placeholder.pHolder;
+			_placeholder.setLocal(false);
+			other._placeholder.erase();
+		}
+	}
+
 	void destruct()
 	{
 		if (!isEmpty())
@@ -2453,6 +2453,10 @@ public:
 	{
 	}
 
+	VarHolderImpl(std::string&& val) : _val(std::move(val))
+	{
+	}
+
 	~VarHolderImpl()
 	{
 	}
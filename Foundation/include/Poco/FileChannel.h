@@ -23,6 +23,7 @@
 #include "Poco/Timestamp.h"
 #include "Poco/Timespan.h"
 #include "Poco/Mutex.h"
+#include "Poco/ArchiveStrategy.h"
 
 
 namespace Poco {
@@ -30,7 +31,6 @@ namespace Poco {
 
 class LogFile;
 class RotateStrategy;
-class ArchiveStrategy;
 class PurgeStrategy;
 
 
@@ -118,12 +118,14 @@ class Foundation_API FileChannel: public Channel
 	///   * utc:        Rotation strategy is based on UTC time (default).
 	///   * local:      Rotation strategy is based on local time.
 	///
-	/// Archived log files can be compressed using the gzip compression
+	/// Archived log files can be compressed using the gzip or LZ4 compression
 	/// method. Compressing can be controlled with the "compress"
 	/// property. The following values for the "compress" property
 	/// are supported:
 	///
-	///   * true:       Compress archived log files.
+	///   * true:       Compress archived log files (gzip).
+	///   * gzip:       Compress archived log files in gzip format (.gz).
+	///   * lz4:        Compress archived log files in LZ4 frame format (.lz4).
 	///   * false:      Do not compress archived log files.
 	///
 	/// Archived log files can be automatically purged, either if
@@ -254,6 +256,7 @@ private:
 	std::string      _rotation;
 	std::string      _archive;
 	bool             _compress;
+	ArchiveStrategy::CompressionMethod _compressionMethod;
 	std::string      _purgeAge;
 	std::string      _purgeCount;
 	bool             _flush;
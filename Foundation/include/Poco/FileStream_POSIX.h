@@ -31,6 +31,8 @@ class Foundation_API FileStreamBuf: public BufferedBidirectionalStreamBuf
 	/// This stream buffer handles Fileio
 {
 public:
+	typedef int NativeHandle;
+
 	FileStreamBuf();
 		/// Creates a FileStreamBuf.
 		
@@ -50,6 +52,14 @@ public:
 	std::streampos seekpos(std::streampos pos, std::ios::openmode mode = std::ios::in | std::ios::out);
 		/// Change to specified position, according to mode.
 
+	NativeHandle nativeHandle() const;
+		/// Returns the native file descriptor of the open file,
+		/// or an invalid one if no file is open.
+		///
+		/// The stream buffer should be synchronized with the
+		/// file position (e.g., by calling pubseekoff(0, std::ios::cur))
+		/// before the handle is used for I/O.
+
 protected:
 	enum
 	{
@@ -66,6 +76,15 @@ private:
 };
 
 
+//
+// inlines
+//
+inline FileStreamBuf::NativeHandle FileStreamBuf::nativeHandle() const
+{
+	return _fd;
+}
+
+
 } // namespace Poco
 
 
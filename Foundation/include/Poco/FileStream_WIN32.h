@@ -30,6 +30,8 @@ class Foundation_API FileStreamBuf: public BufferedBidirectionalStreamBuf
 	/// This stream buffer handles Fileio
 {
 public:
+	typedef HANDLE NativeHandle;
+
 	FileStreamBuf();
 		/// Creates a FileStreamBuf.
 
@@ -49,6 +51,14 @@ public:
 	std::streampos seekpos(std::streampos pos, std::ios::openmode mode = std::ios::in | std::ios::out);
 		/// change to specified position, according to mode
 
+	NativeHandle nativeHandle() const;
+		/// Returns the native file handle of the open file,
+		/// or an invalid one if no file is open.
+		///
+		/// The stream buffer should be synchronized with the
+		/// file position (e.g., by calling pubseekoff(0, std::ios::cur))
+		/// before the handle is used for I/O.
+
 protected:
 	enum
 	{
@@ -65,6 +75,15 @@ private:
 };
 
 
+//
+// inlines
+//
+inline FileStreamBuf::NativeHandle FileStreamBuf::nativeHandle() const
+{
+	return _handle;
+}
+
+
 } // namespace Poco
 
 
@@ -0,0 +1,206 @@
+//
+// FlatHashMap.h
+//
+// Library: Foundation
+// Package: Hashing
+// Module:  FlatHashMap
+//
+// Definition of the FlatHashMap class.
+//
+// Copyright (c) 2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Foundation_FlatHashMap_INCLUDED
+#define Foundation_FlatHashMap_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include "Poco/FlatHashTable.h"
+#include "Poco/HashMap.h"
+#include "Poco/Exception.h"
+#include <utility>
+
+
+namespace Poco {
+
+
+template <class Key, class Mapped>
+struct FlatHashMapKey
+	/// This class template is used internally by FlatHashMap.
+{
+	typedef Key KeyType;
+
+	static const Key& key(const HashMapEntry<Key, Mapped>& entry)
+	{
+		return entry.first;
+	}
+};
+
+
+template <class Key, class Mapped, class HashFunc = Hash<Key> >
+class FlatHashMap
+	/// This class implements a map using a FlatHashTable.
+	///
+	/// A FlatHashMap has the same interface as a HashMap and
+	/// can be used just like a std::map. Since all entries are
+	/// stored in a single array, it uses less memory and has
+	/// much better cache locality than a HashMap, especially
+	/// for large maps.
+	///
+	/// Note that, unlike with HashMap, inserting an entry
+	/// invalidates all iterators and references to entries.
+{
+public:
+	typedef Key                 KeyType;
+	typedef Mapped              MappedType;
+	typedef Mapped&             Reference;
+	typedef const Mapped&       ConstReference;
+	typedef Mapped*             Pointer;
+	typedef const Mapped*       ConstPointer;
+
+	typedef HashMapEntry<Key, Mapped>      ValueType;
+	typedef std::pair<KeyType, MappedType> PairType;
+
+	typedef FlatHashTable<ValueType, HashFunc, FlatHashMapKey<Key, Mapped> > HashTable;
+
+	typedef typename HashTable::Iterator      Iterator;
+	typedef typename HashTable::ConstIterator ConstIterator;
+
+	FlatHashMap()
+		/// Creates an empty FlatHashMap.
+	{
+	}
+
+	FlatHashMap(std::size_t initialReserve):
+		_table(initialReserve)
+		/// Creates the FlatHashMap with room for initialReserve entries.
+	{
+	}
+
+	FlatHashMap(const FlatHashMap& map):
+		_table(map._table)
+		/// Creates the FlatHashMap by copying another one.
+	{
+	}
+
+	FlatHashMap& operator = (const FlatHashMap& map)
+		/// Assigns another FlatHashMap.
+	{
+		FlatHashMap tmp(map);
+		swap(tmp);
+		return *this;
+	}
+
+	void swap(FlatHashMap& map)
+		/// Swaps the FlatHashMap with another one.
+	{
+		_table.swap(map._table);
+	}
+
+	ConstIterator begin() const
+	{
+		return _table.begin();
+	}
+
+	ConstIterator end() const
+	{
+		return _table.end();
+	}
+
+	Iterator begin()
+	{
+		return _table.begin();
+	}
+
+	Iterator end()
+	{
+		return _table.end();
+	}
+
+	ConstIterator find(const KeyType& key) const
+	{
+		return _table.find(key);
+	}
+
+	Iterator find(const KeyType& key)
+	{
+		return _table.find(key);
+	}
+
+	std::size_t count(const KeyType& key) const
+	{
+		return _table.count(key);
+	}
+
+	std::pair<Iterator, bool> insert(const PairType& pair)
+	{
+		return _table.insert(ValueType(pair.first, pair.second));
+	}
+
+	std::pair<Iterator, bool> insert(const ValueType& value)
+	{
+		return _table.insert(value);
+	}
+
+	void erase(Iterator it)
+	{
+		_table.erase(it);
+	}
+
+	void erase(const KeyType& key)
+	{
+		_table.erase(key);
+	}
+
+	void clear()
+	{
+		_table.clear();
+	}
+
+	void reserve(std::size_t n)
+		/// Makes room for at least n entries.
+	{
+		_table.reserve(n);
+	}
+
+	std::size_t size() const
+	{
+		return _table.size();
+	}
+
+	bool empty() const
+	{
+		return _table.empty();
+	}
+
+	ConstReference operator [] (const KeyType& key) const
+	{
+		ConstIterator it = _table.find(key);
+		if (it != _table.end())
+			return it->second;
+		else
+			throw NotFoundException();
+	}
+
+	Reference operator [] (const KeyType& key)
+	{
+		Iterator it = _table.find(key);
+		if (it != _table.end())
+			return it->second;
+		else
+			return _table.insert(ValueType(key)).first->second;
+	}
+
+private:
+	HashTable _table;
+};
+
+
+} // namespace Poco
+
+
+#endif // Foundation_FlatHashMap_INCLUDED
@@ -0,0 +1,187 @@
+//
+// FlatHashSet.h
+//
+// Library: Foundation
+// Package: Hashing
+// Module:  FlatHashSet
+//
+// Definition of the FlatHashSet class.
+//
+// Copyright (c) 2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Foundation_FlatHashSet_INCLUDED
+#define Foundation_FlatHashSet_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include "Poco/FlatHashTable.h"
+
+
+namespace Poco {
+
+
+template <class Value, class HashFunc = Hash<Value> >
+class FlatHashSet
+	/// This class implements a set using a FlatHashTable.
+	///
+	/// A FlatHashSet has the same interface as a HashSet and
+	/// can be used just like a std::set.
+	///
+	/// Note that, unlike with HashSet, inserting an element
+	/// invalidates all iterators and references to elements.
+{
+public:
+	typedef Value        ValueType;
+	typedef Value&       Reference;
+	typedef const Value& ConstReference;
+	typedef Value*       Pointer;
+	typedef const Value* ConstPointer;
+	typedef HashFunc     Hash;
+
+	typedef FlatHashTable<ValueType, Hash> HashTable;
+
+	typedef typename HashTable::Iterator      Iterator;
+	typedef typename HashTable::ConstIterator ConstIterator;
+
+	FlatHashSet()
+		/// Creates an empty FlatHashSet.
+	{
+	}
+
+	FlatHashSet(std::size_t initialReserve):
+		_table(initialReserve)
+		/// Creates the FlatHashSet, using the given initialReserve.
+	{
+	}
+
+	FlatHashSet(const FlatHashSet& set):
+		_table(set._table)
+		/// Creates the FlatHashSet by copying another one.
+	{
+	}
+
+	~FlatHashSet()
+		/// Destroys the FlatHashSet.
+	{
+	}
+
+	FlatHashSet& operator = (const FlatHashSet& table)
+		/// Assigns another FlatHashSet.
+	{
+		FlatHashSet tmp(table);
+		swap(tmp);
+		return *this;
+	}
+
+	void swap(FlatHashSet& set)
+		/// Swaps the FlatHashSet with another one.
+	{
+		_table.swap(set._table);
+	}
+
+	ConstIterator begin() const
+		/// Returns an iterator pointing to the first entry, if one exists.
+	{
+		return _table.begin();
+	}
+
+	ConstIterator end() const
+		/// Returns an iterator pointing to the end of the table.
+	{
+		return _table.end();
+	}
+
+	Iterator begin()
+		/// Returns an iterator pointing to the first entry, if one exists.
+	{
+		return _table.begin();
+	}
+
+	Iterator end()
+		/// Returns an iterator pointing to the end of the table.
+	{
+		return _table.end();
+	}
+
+	ConstIterator find(const ValueType& value) const
+		/// Finds an entry in the table.
+	{
+		return _table.find(value);
+	}
+
+	Iterator find(const ValueType& value)
+		/// Finds an entry in the table.
+	{
+		return _table.find(value);
+	}
+
+	std::size_t count(const ValueType& value) const
+		/// Returns the number of elements with the given
+		/// value, with is either 1 or 0.
+	{
+		return _table.count(value);
+	}
+
+	std::pair<Iterator, bool> insert(const ValueType& value)
+		/// Inserts an element into the set.
+		///
+		/// If the element already exists in the set,
+		/// a pair(iterator, false) with iterator pointing to the
+		/// existing element is returned.
+		/// Otherwise, the element is inserted an a
+		/// pair(iterator, true) with iterator
+		/// pointing to the new element is returned.
+	{
+		return _table.insert(value);
+	}
+
+	void erase(Iterator it)
+		/// Erases the element pointed to by it.
+	{
+		_table.erase(it);
+	}
+
+	void erase(const ValueType& value)
+		/// Erases the element with the given value, if it exists.
+	{
+		_table.erase(value);
+	}
+
+	void clear()
+		/// Erases all elements.
+	{
+		_table.clear();
+	}
+
+	void reserve(std::size_t n)
+		/// Makes room for at least n elements.
+	{
+		_table.reserve(n);
+	}
+
+	std::size_t size() const
+		/// Returns the number of elements in the table.
+	{
+		return _table.size();
+	}
+
+	bool empty() const
+		/// Returns true iff the table is empty.
+	{
+		return _table.empty();
+	}
+
+private:
+	HashTable _table;
+};
+
+
+} // namespace Poco
+
+
+#endif // Foundation_FlatHashSet_INCLUDED
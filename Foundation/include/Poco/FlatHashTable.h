@@ -0,0 +1,744 @@
+//
+// FlatHashTable.h
+//
+// Library: Foundation
+// Package: Hashing
+// Module:  FlatHashTable
+//
+// Definition of the FlatHashTable class.
+//
+// Copyright (c) 2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Foundation_FlatHashTable_INCLUDED
+#define Foundation_FlatHashTable_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include "Poco/Hash.h"
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <new>
+#include <cstddef>
+#include <cstring>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define POCO_FLAT_HASH_TABLE_SSE2
+#endif
+
+
+namespace Poco {
+
+
+template <class Value>
+struct FlatHashTableIdentity
+	/// The key extractor used by FlatHashTable for sets,
+	/// where the value is the key.
+{
+	typedef Value KeyType;
+
+	static const Value& key(const Value& value)
+	{
+		return value;
+	}
+};
+
+
+template <class Value, class HashFunc = Hash<Value>, class KeyOf = FlatHashTableIdentity<Value> >
+class FlatHashTable
+	/// This class implements a hash table using open addressing
+	/// with all elements stored in a single contiguous array
+	/// ("Swiss table" design).
+	///
+	/// In addition to the element array, the table keeps an array
+	/// of one-byte control words, one per slot, which record
+	/// whether a slot is empty, deleted, or full, and, for full
+	/// slots, seven bits of the element's hash. A lookup scans
+	/// the control words in groups of 16 (using SSE2 instructions,
+	/// if available), and only compares elements whose hash bits
+	/// match. Most lookups therefore touch one cache line of
+	/// control words and one element, regardless of the table size.
+	///
+	/// The table grows (doubling its capacity) when it is 7/8 full.
+	/// Erased elements leave a tombstone, which is reused by later
+	/// insertions and removed when the table is rehashed.
+	///
+	/// Unlike with LinearHashTable, inserting an element may move
+	/// other elements, so iterators, pointers and references to
+	/// elements are invalidated by insert(). Erasing an element
+	/// only invalidates iterators to the erased element.
+	///
+	/// KeyOf extracts the key from a value; the key must
+	/// be hashable with HashFunc and comparable for equality.
+	///
+	/// The FlatHashTable is not thread safe.
+{
+public:
+	typedef Value                     ValueType;
+	typedef Value&                    Reference;
+	typedef const Value&              ConstReference;
+	typedef Value*                    Pointer;
+	typedef const Value*              ConstPointer;
+	typedef HashFunc                  Hash;
+	typedef typename KeyOf::KeyType   KeyType;
+
+	enum
+	{
+		GROUP_WIDTH = 16
+	};
+
+	class ConstIterator
+	{
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef Value                     value_type;
+		typedef std::ptrdiff_t            difference_type;
+		typedef const Value*              pointer;
+		typedef const Value&              reference;
+
+		ConstIterator():
+			_pCtrl(0),
+			_pSlot(0)
+		{
+		}
+
+		ConstIterator(const signed char* pCtrl, Value* pSlot):
+			_pCtrl(pCtrl),
+			_pSlot(pSlot)
+		{
+		}
+
+		bool operator == (const ConstIterator& it) const
+		{
+			return _pSlot == it._pSlot;
+		}
+
+		bool operator != (const ConstIterator& it) const
+		{
+			return _pSlot != it._pSlot;
+		}
+
+		const Value& operator * () const
+		{
+			return *_pSlot;
+		}
+
+		const Value* operator -> () const
+		{
+			return _pSlot;
+		}
+
+		ConstIterator& operator ++ () // prefix
+		{
+			++_pCtrl;
+			++_pSlot;
+			skipFree();
+			return *this;
+		}
+
+		ConstIterator operator ++ (int) // postfix
+		{
+			ConstIterator tmp(*this);
+			++*this;
+			return tmp;
+		}
+
+	protected:
+		void skipFree()
+		{
+			// the control word array is terminated by a sentinel
+			while (*_pCtrl < 0 && *_pCtrl != CTRL_SENTINEL)
+			{
+				++_pCtrl;
+				++_pSlot;
+			}
+		}
+
+		const signed char* _pCtrl;
+		Value*             _pSlot;
+
+		friend class FlatHashTable;
+	};
+
+	class Iterator: public ConstIterator
+	{
+	public:
+		typedef Value* pointer;
+		typedef Value& reference;
+
+		Iterator()
+		{
+		}
+
+		Iterator(const signed char* pCtrl, Value* pSlot):
+			ConstIterator(pCtrl, pSlot)
+		{
+		}
+
+		Value& operator * () const
+		{
+			return *this->_pSlot;
+		}
+
+		Value* operator -> () const
+		{
+			return this->_pSlot;
+		}
+
+		Iterator& operator ++ () // prefix
+		{
+			ConstIterator::operator ++ ();
+			return *this;
+		}
+
+		Iterator operator ++ (int) // postfix
+		{
+			Iterator tmp(*this);
+			++*this;
+			return tmp;
+		}
+
+		friend class FlatHashTable;
+	};
+
+	FlatHashTable():
+		_pCtrl(emptyGroup()),
+		_pSlots(0),
+		_capacity(0),
+		_size(0),
+		_growthLeft(0)
+		/// Creates an empty FlatHashTable. No memory is
+		/// allocated until the first element is inserted.
+	{
+	}
+
+	FlatHashTable(std::size_t initialReserve):
+		_pCtrl(emptyGroup()),
+		_pSlots(0),
+		_capacity(0),
+		_size(0),
+		_growthLeft(0)
+		/// Creates the FlatHashTable with room for at least
+		/// initialReserve elements.
+	{
+		reserve(initialReserve);
+	}
+
+	FlatHashTable(const FlatHashTable& table):
+		_pCtrl(emptyGroup()),
+		_pSlots(0),
+		_capacity(0),
+		_size(0),
+		_growthLeft(0),
+		_hash(table._hash)
+		/// Creates the FlatHashTable by copying another one.
+	{
+		reserve(table._size);
+		for (ConstIterator it = table.begin(); it != table.end(); ++it)
+		{
+			insertUnique(hashOf(KeyOf::key(*it)), *it);
+		}
+	}
+
+	FlatHashTable(FlatHashTable&& table) noexcept:
+		_pCtrl(table._pCtrl),
+		_pSlots(table._pSlots),
+		_capacity(table._capacity),
+		_size(table._size),
+		_growthLeft(table._growthLeft),
+		_hash(table._hash)
+		/// Creates the FlatHashTable by moving another one.
+	{
+		table._pCtrl = emptyGroup();
+		table._pSlots = 0;
+		table._capacity = 0;
+		table._size = 0;
+		table._growthLeft = 0;
+	}
+
+	~FlatHashTable()
+		/// Destroys the FlatHashTable.
+	{
+		destroy();
+	}
+
+	FlatHashTable& operator = (const FlatHashTable& table)
+		/// Assigns another FlatHashTable.
+	{
+		FlatHashTable tmp(table);
+		swap(tmp);
+		return *this;
+	}
+
+	FlatHashTable& operator = (FlatHashTable&& table) noexcept
+		/// Move-assigns another FlatHashTable.
+	{
+		FlatHashTable tmp(std::move(table));
+		swap(tmp);
+		return *this;
+	}
+
+	void swap(FlatHashTable& table)
+		/// Swaps the FlatHashTable with another one.
+	{
+		using std::swap;
+		swap(_pCtrl, table._pCtrl);
+		swap(_pSlots, table._pSlots);
+		swap(_capacity, table._capacity);
+		swap(_size, table._size);
+		swap(_growthLeft, table._growthLeft);
+		swap(_hash, table._hash);
+	}
+
+	ConstIterator begin() const
+		/// Returns an iterator pointing to the first entry, if one exists.
+	{
+		ConstIterator it(_pCtrl, _pSlots);
+		it.skipFree();
+		return it;
+	}
+
+	ConstIterator end() const
+		/// Returns an iterator pointing to the end of the table.
+	{
+		return ConstIterator(_pCtrl + _capacity, _pSlots + _capacity);
+	}
+
+	Iterator begin()
+		/// Returns an iterator pointing to the first entry, if one exists.
+	{
+		Iterator it(_pCtrl, _pSlots);
+		it.skipFree();
+		return it;
+	}
+
+	Iterator end()
+		/// Returns an iterator pointing to the end of the table.
+	{
+		return Iterator(_pCtrl + _capacity, _pSlots + _capacity);
+	}
+
+	ConstIterator find(const KeyType& key) const
+		/// Finds an entry in the table.
+	{
+		std::size_t index = findIndex(key, hashOf(key));
+		if (index != _capacity)
+			return ConstIterator(_pCtrl + index, _pSlots + index);
+		else
+			return end();
+	}
+
+	Iterator find(const KeyType& key)
+		/// Finds an entry in the table.
+	{
+		std::size_t index = findIndex(key, hashOf(key));
+		if (index != _capacity)
+			return Iterator(_pCtrl + index, _pSlots + index);
+		else
+			return end();
+	}
+
+	std::size_t count(const KeyType& key) const
+		/// Returns the number of elements with the given
+		/// key, with is either 1 or 0.
+	{
+		return findIndex(key, hashOf(key)) != _capacity ? 1 : 0;
+	}
+
+	std::pair<Iterator, bool> insert(const Value& value)
+		/// Inserts an element into the table.
+		///
+		/// If an element with the same key already exists in
+		/// the table, a pair(iterator, false) with iterator pointing
+		/// to the existing element is returned.
+		/// Otherwise, the element is inserted an a
+		/// pair(iterator, true) with iterator
+		/// pointing to the new element is returned.
+	{
+		std::size_t hash = hashOf(KeyOf::key(value));
+		std::size_t index = findIndex(KeyOf::key(value), hash);
+		if (index != _capacity)
+		{
+			return std::make_pair(Iterator(_pCtrl + index, _pSlots + index), false);
+		}
+		index = insertUnique(hash, value);
+		return std::make_pair(Iterator(_pCtrl + index, _pSlots + index), true);
+	}
+
+	std::pair<Iterator, bool> insert(Value&& value)
+		/// Inserts an element into the table, moving it if
+		/// it does not exist yet. See insert(const Value&).
+	{
+		std::size_t hash = hashOf(KeyOf::key(value));
+		std::size_t index = findIndex(KeyOf::key(value), hash);
+		if (index != _capacity)
+		{
+			return std::make_pair(Iterator(_pCtrl + index, _pSlots + index), false);
+		}
+		index = insertUnique(hash, std::move(value));
+		return std::make_pair(Iterator(_pCtrl + index, _pSlots + index), true);
+	}
+
+	void erase(Iterator it)
+		/// Erases the element pointed to by it.
+	{
+		if (it != end())
+		{
+			eraseIndex(it._pSlot - _pSlots);
+		}
+	}
+
+	void erase(const KeyType& key)
+		/// Erases the element with the given key, if it exists.
+	{
+		std::size_t index = findIndex(key, hashOf(key));
+		if (index != _capacity)
+		{
+			eraseIndex(index);
+		}
+	}
+
+	void clear()
+		/// Erases all elements.
+		///
+		/// The memory used by the table is retained.
+	{
+		if (_size > 0)
+		{
+			for (std::size_t i = 0; i < _capacity; ++i)
+			{
+				if (_pCtrl[i] >= 0) _pSlots[i].~Value();
+			}
+		}
+		if (_capacity > 0)
+		{
+			resetCtrl();
+		}
+		_size = 0;
+		_growthLeft = maxLoad(_capacity);
+	}
+
+	void reserve(std::size_t n)
+		/// Makes room for at least n elements, so that
+		/// inserting up to n elements does not rehash the table.
+	{
+		std::size_t capacity = GROUP_WIDTH - 1;
+		while (maxLoad(capacity) < n) capacity = 2*capacity + 1;
+		if (capacity > _capacity) rehash(capacity);
+	}
+
+	std::size_t size() const
+		/// Returns the number of elements in the table.
+	{
+		return _size;
+	}
+
+	bool empty() const
+		/// Returns true iff the table is empty.
+	{
+		return _size == 0;
+	}
+
+	std::size_t capacity() const
+		/// Returns the number of slots in the table.
+	{
+		return _capacity;
+	}
+
+protected:
+	enum
+	{
+		CTRL_EMPTY    = -128,
+		CTRL_DELETED  = -2,
+		CTRL_SENTINEL = -1
+	};
+
+	class Group
+		/// A group of GROUP_WIDTH control words.
+	{
+	public:
+#if defined(POCO_FLAT_HASH_TABLE_SSE2)
+		explicit Group(const signed char* pCtrl):
+			_ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pCtrl)))
+		{
+		}
+
+		unsigned match(signed char h2) const
+			/// Returns a bit mask of the full slots with the given hash bits.
+		{
+			return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), _ctrl)));
+		}
+
+		unsigned matchEmpty() const
+			/// Returns a bit mask of the empty slots.
+		{
+			return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(CTRL_EMPTY), _ctrl)));
+		}
+
+		unsigned matchFree() const
+			/// Returns a bit mask of the empty or deleted slots.
+		{
+			return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(CTRL_SENTINEL), _ctrl)));
+		}
+
+	private:
+		__m128i _ctrl;
+#else
+		explicit Group(const signed char* pCtrl)
+		{
+			std::memcpy(_ctrl, pCtrl, GROUP_WIDTH);
+		}
+
+		unsigned match(signed char h2) const
+		{
+			unsigned mask = 0;
+			for (int i = 0; i < GROUP_WIDTH; ++i)
+			{
+				if (_ctrl[i] == h2) mask |= 1u << i;
+			}
+			return mask;
+		}
+
+		unsigned matchEmpty() const
+		{
+			return match(CTRL_EMPTY);
+		}
+
+		unsigned matchFree() const
+		{
+			unsigned mask = 0;
+			for (int i = 0; i < GROUP_WIDTH; ++i)
+			{
+				if (_ctrl[i] < CTRL_SENTINEL) mask |= 1u << i;
+			}
+			return mask;
+		}
+
+	private:
+		signed char _ctrl[GROUP_WIDTH];
+#endif
+	};
+
+	static int lowestBit(unsigned mask)
+	{
+#if defined(__GNUC__)
+		return __builtin_ctz(mask);
+#else
+		int n = 0;
+		while (!(mask & 1))
+		{
+			mask >>= 1;
+			++n;
+		}
+		return n;
+#endif
+	}
+
+	static std::size_t maxLoad(std::size_t capacity)
+	{
+		return capacity - capacity/8;
+	}
+
+	static signed char* emptyGroup()
+		/// Returns a shared, read-only control word array for
+		/// tables without storage, so that iteration needs no
+		/// special case.
+	{
+		static const signed char sentinel = CTRL_SENTINEL;
+		return const_cast<signed char*>(&sentinel);
+	}
+
+	std::size_t hashOf(const KeyType& key) const
+	{
+		// spread the hash, since many hash functions (including
+		// Poco::Hash for integers) leave the upper bits unused
+		UInt64 h = static_cast<UInt64>(_hash(key))*0x9E3779B97F4A7C15ULL;
+		return static_cast<std::size_t>(h ^ (h >> 32));
+	}
+
+	static signed char h2(std::size_t hash)
+	{
+		return static_cast<signed char>(hash & 0x7F);
+	}
+
+	std::size_t findIndex(const KeyType& key, std::size_t hash) const
+		/// Returns the index of the element with the given key,
+		/// or _capacity if there is no such element.
+	{
+		if (_size == 0) return _capacity;
+
+		std::size_t mask = _capacity;
+		std::size_t pos = (hash >> 7) & mask;
+		std::size_t step = 0;
+		for (;;)
+		{
+			Group g(_pCtrl + pos);
+			for (unsigned m = g.match(h2(hash)); m; m &= m - 1)
+			{
+				std::size_t index = (pos + lowestBit(m)) & mask;
+				if (KeyOf::key(_pSlots[index]) == key) return index;
+			}
+			if (g.matchEmpty()) return _capacity;
+			step += GROUP_WIDTH;
+			pos = (pos + step) & mask;
+		}
+	}
+
+	std::size_t findFree(std::size_t hash) const
+		/// Returns the index of the first empty or deleted
+		/// slot in the probe sequence for the given hash.
+	{
+		std::size_t mask = _capacity;
+		std::size_t pos = (hash >> 7) & mask;
+		std::size_t step = 0;
+		for (;;)
+		{
+			unsigned m = Group(_pCtrl + pos).matchFree();
+			if (m) return (pos + lowestBit(m)) & mask;
+			step += GROUP_WIDTH;
+			pos = (pos + step) & mask;
+		}
+	}
+
+	template <class V>
+	std::size_t insertUnique(std::size_t hash, V&& value)
+		/// Inserts an element known not to be in the table
+		/// and returns its index.
+	{
+		std::size_t index = _capacity > 0 ? findFree(hash) : 0;
+		if (_capacity == 0 || (_growthLeft == 0 && _pCtrl[index] == CTRL_EMPTY))
+		{
+			grow();
+			index = findFree(hash);
+		}
+		new (_pSlots + index) Value(std::forward<V>(value));
+		if (_pCtrl[index] == CTRL_EMPTY) --_growthLeft;
+		setCtrl(index, h2(hash));
+		++_size;
+		return index;
+	}
+
+	void eraseIndex(std::size_t index)
+	{
+		_pSlots[index].~Value();
+		--_size;
+
+		// If the slot is followed by an empty slot, and preceded
+		// by one, no probe sequence can have passed over it while
+		// its group was full, so it can be marked empty again.
+		std::size_t mask = _capacity;
+		unsigned emptyAfter = Group(_pCtrl + index).matchEmpty();
+		unsigned emptyBefore = Group(_pCtrl + ((index - GROUP_WIDTH) & mask)).matchEmpty();
+		if (emptyAfter && emptyBefore && lowestBit(emptyAfter) + leadingZeros16(emptyBefore) < GROUP_WIDTH)
+		{
+			setCtrl(index, CTRL_EMPTY);
+			++_growthLeft;
+		}
+		else
+		{
+			setCtrl(index, CTRL_DELETED);
+		}
+	}
+
+	static int leadingZeros16(unsigned mask)
+	{
+		int n = 0;
+		for (unsigned bit = 1u << (GROUP_WIDTH - 1); bit && !(mask & bit); bit >>= 1) ++n;
+		return n;
+	}
+
+	void setCtrl(std::size_t index, signed char ctrl)
+	{
+		_pCtrl[index] = ctrl;
+		// the first GROUP_WIDTH - 1 control words are mirrored after
+		// the sentinel, so that a group can be loaded at any index
+		if (index < GROUP_WIDTH - 1) _pCtrl[_capacity + 1 + index] = ctrl;
+	}
+
+	void resetCtrl()
+	{
+		std::memset(_pCtrl, CTRL_EMPTY, _capacity + GROUP_WIDTH);
+		_pCtrl[_capacity] = CTRL_SENTINEL;
+	}
+
+	void grow()
+	{
+		if (_capacity == 0)
+			rehash(GROUP_WIDTH - 1);
+		else if (_size*32 <= _capacity*25)
+			rehash(_capacity); // many tombstones; clean up without growing
+		else
+			rehash(2*_capacity + 1);
+	}
+
+	void rehash(std::size_t capacity)
+	{
+		signed char* pOldCtrl = _pCtrl;
+		Value* pOldSlots = _pSlots;
+		std::size_t oldCapacity = _capacity;
+
+		_pSlots = static_cast<Value*>(::operator new(capacity*sizeof(Value)));
+		try
+		{
+			_pCtrl = new signed char[capacity + GROUP_WIDTH];
+		}
+		catch (...)
+		{
+			::operator delete(_pSlots);
+			_pSlots = pOldSlots;
+			throw;
+		}
+		_capacity = capacity;
+		resetCtrl();
+		_growthLeft = maxLoad(capacity) - _size;
+
+		for (std::size_t i = 0; i < oldCapacity; ++i)
+		{
+			if (pOldCtrl[i] >= 0)
+			{
+				std::size_t hash = hashOf(KeyOf::key(pOldSlots[i]));
+				std::size_t index = findFree(hash);
+				new (_pSlots + index) Value(std::move(pOldSlots[i]));
+				pOldSlots[i].~Value();
+				setCtrl(index, h2(hash));
+			}
+		}
+		if (oldCapacity > 0)
+		{
+			delete [] pOldCtrl;
+			::operator delete(pOldSlots);
+		}
+	}
+
+	void destroy()
+	{
+		if (_capacity > 0)
+		{
+			for (std::size_t i = 0; i < _capacity; ++i)
+			{
+				if (_pCtrl[i] >= 0) _pSlots[i].~Value();
+			}
+			delete [] _pCtrl;
+			::operator delete(_pSlots);
+		}
+	}
+
+private:
+	signed char* _pCtrl;
+	Value*       _pSlots;
+	std::size_t  _capacity;
+	std::size_t  _size;
+	std::size_t  _growthLeft;
+	HashFunc     _hash;
+};
+
+
+} // namespace Poco
+
+
+#endif // Foundation_FlatHashTable_INCLUDED
@@ -40,7 +40,7 @@ template <class T>
 struct Hash
 	/// A generic hash function.
 {
-	std::size_t operator () (T value) const
+	std::size_t operator () (const T& value) const
 		/// Returns the hash for the given value.
 	{
 		return Poco::hash(value);
@@ -85,6 +85,19 @@ class Foundation_API HexBinaryDecoder: public HexBinaryDecoderIOS, public std::i
 public:
 	HexBinaryDecoder(std::istream& istr);
 	~HexBinaryDecoder();
+
+	static std::size_t decode(const char* encoded, std::size_t length, char* data);
+		/// Decodes length hexBinary-encoded characters starting at
+		/// encoded, and stores the result in data, which must have
+		/// room for at least decodedLength(length) bytes.
+		/// Whitespace is skipped.
+		///
+		/// Returns the number of bytes written.
+		/// Throws a DataFormatException if the input is not valid.
+
+	static std::size_t decodedLength(std::size_t length);
+		/// Returns the maximum number of bytes decode() writes
+		/// for length characters.
 };
 
 
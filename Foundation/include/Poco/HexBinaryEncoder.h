@@ -60,7 +60,11 @@ public:
 		
 	void setUppercase(bool flag = true);
 		/// Specify whether hex digits a-f are written in upper or lower case.
-	
+
+protected:
+	std::streamsize xsputn(const char* s, std::streamsize n);
+		/// Encodes bytes in bulk.
+
 private:
 	int writeToDevice(char c);
 
@@ -108,6 +112,18 @@ class Foundation_API HexBinaryEncoder: public HexBinaryEncoderIOS, public std::o
 public:
 	HexBinaryEncoder(std::ostream& ostr);
 	~HexBinaryEncoder();
+
+	static std::size_t encode(const char* data, std::size_t length, char* encoded, bool uppercase = false);
+		/// Encodes length bytes starting at data in hexBinary encoding,
+		/// and stores the result in encoded, which must have room
+		/// for at least encodedLength(length) characters.
+		/// No line breaks are written.
+		///
+		/// Returns the number of characters written.
+
+	static std::size_t encodedLength(std::size_t length);
+		/// Returns the number of characters encode() writes
+		/// for length bytes.
 };
 
 
@@ -38,10 +38,17 @@ enum JSONOptions
 		/// unicode characters will be escaped in the resulting
 		/// string.
 
-	JSON_WRAP_STRINGS = 4
+	JSON_WRAP_STRINGS = 4,
 		/// If specified, the object will preserve the items
 		/// insertion order. Otherwise, items will be sorted
 		/// by keys.
+
+	JSON_FLAT_STORAGE = 8
+		/// Applies to JSON::Object. If specified, the Object will
+		/// store its items in insertion order in a single array,
+		/// rather than in a std::map.
+		///
+		/// Has no effect on toJSON() function.
 };
 
 
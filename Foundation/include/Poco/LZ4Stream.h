@@ -0,0 +1,209 @@
+//
+// LZ4Stream.h
+//
+// Library: Foundation
+// Package: Streams
+// Module:  LZ4Stream
+//
+// Definition of the LZ4StreamBuf, LZ4InputStream and LZ4OutputStream classes.
+//
+// Copyright (c) 2004-2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Foundation_LZ4Stream_INCLUDED
+#define Foundation_LZ4Stream_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include "Poco/BufferedStreamBuf.h"
+#include "Poco/Buffer.h"
+#include <istream>
+#include <ostream>
+
+
+namespace Poco {
+
+
+class Foundation_API LZ4StreamBuf: public BufferedStreamBuf
+	/// This is the streambuf class used by LZ4InputStream and LZ4OutputStream.
+	///
+	/// The stream buffer reads and writes the LZ4 frame format, as
+	/// specified in https://github.com/lz4/lz4/blob/dev/doc/lz4_Frame_format.md
+	/// and used by the lz4 command line tool. The LZ4 block compression
+	/// algorithm is implemented directly, so no external library is required.
+	///
+	/// LZ4 compresses and decompresses several times faster than
+	/// deflate, at the cost of a lower compression ratio.
+	///
+	/// When compressing, blocks are compressed independently and
+	/// a content checksum is written. When decompressing, both independent
+	/// and linked blocks, block and content checksums, as well as
+	/// concatenated and skippable frames are supported. Frames using a
+	/// preset dictionary are not supported.
+	///
+	/// Output streams should always call close() to ensure
+	/// proper completion of compression.
+{
+public:
+	enum BlockSize
+		/// Maximum size of the uncompressed blocks of an LZ4 frame.
+	{
+		BLOCK_64K  = 4,
+		BLOCK_256K = 5,
+		BLOCK_1M   = 6,
+		BLOCK_4M   = 7
+	};
+
+	LZ4StreamBuf(std::istream& istr);
+		/// Creates a LZ4StreamBuf for decompressing LZ4 frames
+		/// read from the given input stream.
+
+	LZ4StreamBuf(std::ostream& ostr, BlockSize blockSize);
+		/// Creates a LZ4StreamBuf for compressing data passed
+		/// through and forwarding it as LZ4 frame to the given output stream.
+
+	~LZ4StreamBuf();
+		/// Destroys the LZ4StreamBuf.
+
+	int close();
+		/// Finishes up the stream.
+		///
+		/// Must be called when compressing to an output stream.
+
+	static std::size_t compressBound(std::size_t length);
+		/// Returns the maximum size of the compressed form
+		/// of length bytes of data.
+
+	static std::size_t compressBlock(const char* source, std::size_t length, char* dest);
+		/// Compresses length bytes from source into a raw LZ4 block
+		/// and returns the size of the compressed block.
+		/// dest must have room for at least compressBound(length) bytes.
+
+	static std::size_t decompressBlock(const char* source, std::size_t length, char* dest, std::size_t capacity);
+		/// Decompresses the raw LZ4 block of the given length into
+		/// dest, which has room for capacity bytes, and returns the
+		/// size of the decompressed data.
+		///
+		/// Throws a DataFormatException if the block is malformed
+		/// or does not fit into dest.
+
+protected:
+	int readFromDevice(char* buffer, std::streamsize length);
+	int writeToDevice(const char* buffer, std::streamsize length);
+
+private:
+	class Hash;
+
+	enum
+	{
+		STREAM_BUFFER_SIZE = 65536
+	};
+
+	static const std::size_t WINDOW_SIZE = 65536;
+
+	void writeFrameHeader();
+	bool readFrameHeader();
+	bool readBlock();
+	std::size_t readBytes(char* buffer, std::size_t length);
+	void readFully(char* buffer, std::size_t length);
+	UInt32 readUInt32();
+	void writeUInt32(UInt32 value);
+
+	std::istream* _pIstr;
+	std::ostream* _pOstr;
+	Hash*         _pHash;
+	BlockSize     _blockSize;
+	std::size_t   _blockMax;
+	Buffer<char>  _input;
+	Buffer<char>  _window;
+	std::size_t   _outPos;
+	std::size_t   _outEnd;
+	bool          _inFrame;
+	bool          _linked;
+	bool          _blockChecksum;
+	bool          _contentChecksum;
+};
+
+
+class Foundation_API LZ4IOS: public virtual std::ios
+	/// The base class for LZ4OutputStream and LZ4InputStream.
+	///
+	/// This class is needed to ensure the correct initialization
+	/// order of the stream buffer and base classes.
+{
+public:
+	LZ4IOS(std::ostream& ostr, LZ4StreamBuf::BlockSize blockSize);
+		/// Creates a LZ4IOS for compressing data passed
+		/// through and forwarding it to the given output stream.
+
+	LZ4IOS(std::istream& istr);
+		/// Creates a LZ4IOS for decompressing data read
+		/// from the given input stream.
+
+	~LZ4IOS();
+		/// Destroys the LZ4IOS.
+
+	LZ4StreamBuf* rdbuf();
+		/// Returns a pointer to the underlying stream buffer.
+
+protected:
+	LZ4StreamBuf _buf;
+};
+
+
+class Foundation_API LZ4OutputStream: public std::ostream, public LZ4IOS
+	/// This stream compresses all data passing through it
+	/// into a LZ4 frame.
+	///
+	/// After all data has been written to the stream, close()
+	/// must be called to ensure completion of compression.
+	/// Example:
+	///     std::ofstream ostr("data.lz4", std::ios::binary);
+	///     LZ4OutputStream compressor(ostr);
+	///     compressor << "Hello, world!" << std::endl;
+	///     compressor.close();
+	///     ostr.close();
+{
+public:
+	LZ4OutputStream(std::ostream& ostr, LZ4StreamBuf::BlockSize blockSize = LZ4StreamBuf::BLOCK_64K);
+		/// Creates a LZ4OutputStream for compressing data passed
+		/// through and forwarding it to the given output stream.
+
+	~LZ4OutputStream();
+		/// Destroys the LZ4OutputStream.
+
+	int close();
+		/// Finishes up the stream.
+		///
+		/// Must be called when compressing to an output stream.
+};
+
+
+class Foundation_API LZ4InputStream: public std::istream, public LZ4IOS
+	/// This stream decompresses LZ4 frames read from
+	/// another input stream.
+	///
+	/// Example:
+	///     std::ifstream istr("data.lz4", std::ios::binary);
+	///     LZ4InputStream decompressor(istr);
+	///     std::string data;
+	///     StreamCopier::copyToString(decompressor, data);
+{
+public:
+	LZ4InputStream(std::istream& istr);
+		/// Creates a LZ4InputStream for decompressing data read
+		/// from the given input stream.
+
+	~LZ4InputStream();
+		/// Destroys the LZ4InputStream.
+};
+
+
+} // namespace Poco
+
+
+#endif // Foundation_LZ4Stream_INCLUDED
@@ -0,0 +1,225 @@
+//
+// MappedFile.h
+//
+// Library: Foundation
+// Package: Filesystem
+// Module:  MappedFile
+//
+// Definition of the MappedFile, MappedIOS and MappedInputStream classes.
+//
+// Copyright (c) 2007, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Foundation_MappedFile_INCLUDED
+#define Foundation_MappedFile_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include "Poco/MemoryStream.h"
+#include <algorithm>
+#include <cstddef>
+#include <istream>
+#include <string>
+
+
+namespace Poco {
+
+
+class MappedFileImpl;
+
+
+class Foundation_API MappedFile
+	/// MappedFile maps a file, or a window of it, into memory
+	/// for read-only access.
+	///
+	/// The contents of the file can then be accessed directly through
+	/// begin() and end(), without copying it into buffers with read(),
+	/// which avoids one copy of the data compared to reading the file
+	/// with FileInputStream. Pages are read from the file system cache
+	/// on demand.
+	///
+	/// A window is specified by an offset and a length, which do not need
+	/// to be page aligned. The system mapping is aligned to the allocation
+	/// granularity internally. Mapping windows allows processing files
+	/// larger than the available address space.
+	///
+	/// Hints about the expected access pattern can be given to the
+	/// system with advise(). Whether a hint has any effect is up to
+	/// the system.
+	///
+	/// Changing the size of the file while it is mapped results in
+	/// undefined behavior (on POSIX platforms, accessing pages beyond
+	/// the end of a truncated file raises SIGBUS).
+	///
+	/// A MappedFile object has value semantics, but
+	/// is implemented using a handle/implementation idiom.
+	/// Therefore, multiple MappedFile objects can share
+	/// a single, reference counted MappedFileImpl object.
+{
+public:
+	enum Advice
+	{
+		ADVICE_NORMAL = 0, /// No special treatment.
+		ADVICE_SEQUENTIAL, /// Data will be accessed sequentially; read ahead aggressively.
+		ADVICE_RANDOM,     /// Data will be accessed in random order; do not read ahead.
+		ADVICE_WILLNEED,   /// Data will be accessed soon; start reading it in.
+		ADVICE_DONTNEED,   /// Data will not be accessed soon; its pages can be dropped.
+		ADVICE_HUGEPAGE    /// Use huge pages for the mapping, if supported for files.
+	};
+
+	MappedFile();
+		/// Creates an unmapped MappedFile object.
+
+	MappedFile(const std::string& path, Advice advice = ADVICE_NORMAL);
+		/// Maps the entire file given by path and
+		/// gives the given advice for the mapping.
+		///
+		/// Throws a FileNotFoundException if the file does not exist,
+		/// or an OpenFileException if it cannot be opened.
+		/// An empty file results in an empty mapping.
+
+	MappedFile(const std::string& path, UInt64 offset, std::size_t length, Advice advice = ADVICE_NORMAL);
+		/// Maps length bytes of the file given by path, starting
+		/// at the given offset, and gives the given advice for
+		/// the mapping.
+		///
+		/// The window is truncated at the end of the file.
+
+	MappedFile(const MappedFile& other);
+		/// Creates a MappedFile object by copying another one.
+
+	~MappedFile();
+		/// Destroys the MappedFile, unmapping the file if
+		/// no other MappedFile refers to the mapping.
+
+	MappedFile& operator = (const MappedFile& other);
+		/// Assigns another MappedFile object.
+
+	void swap(MappedFile& other);
+		/// Swaps the MappedFile object with another one.
+
+	const char* begin() const;
+		/// Returns the start address of the mapped window.
+		/// Will be NULL if nothing is mapped.
+
+	const char* end() const;
+		/// Returns the one-past-end address of the mapped window.
+		/// Will be NULL if nothing is mapped.
+
+	std::size_t size() const;
+		/// Returns the size of the mapped window.
+
+	UInt64 offset() const;
+		/// Returns the offset of the mapped window in the file.
+
+	UInt64 fileSize() const;
+		/// Returns the size of the file at the time
+		/// it has been mapped.
+
+	bool advise(Advice advice) const;
+		/// Gives the system a hint about how the mapped window
+		/// will be accessed.
+		///
+		/// Returns true if the hint has been accepted,
+		/// or false if it is not supported.
+
+	bool advise(Advice advice, std::size_t offset, std::size_t length) const;
+		/// Gives the system a hint about how length bytes of the mapped
+		/// window, starting at offset (relative to begin()), will be accessed.
+		///
+		/// Returns true if the hint has been accepted,
+		/// or false if it is not supported.
+
+	static std::size_t pageSize();
+		/// Returns the size of a memory page.
+
+	static std::size_t allocationGranularity();
+		/// Returns the alignment required by the system
+		/// for the file offset of a mapping.
+
+private:
+	MappedFileImpl* _pImpl;
+};
+
+
+class Foundation_API MappedIOS: public virtual std::ios
+	/// The base class for MappedInputStream.
+	///
+	/// This class is needed to ensure the correct initialization
+	/// order of the stream buffer and base classes.
+{
+public:
+	MappedIOS(const MappedFile& file);
+		/// Creates the basic stream for the given mapping.
+
+	~MappedIOS();
+		/// Destroys the stream.
+
+	MemoryStreamBuf* rdbuf();
+		/// Returns a pointer to the underlying streambuf.
+
+	const MappedFile& file() const;
+		/// Returns the mapping the stream reads from.
+
+protected:
+	MappedFile      _file;
+	MemoryStreamBuf _buf;
+};
+
+
+class Foundation_API MappedInputStream: public MappedIOS, public std::istream
+	/// An input stream for reading a memory mapped file.
+	///
+	/// The stream reads directly from the mapped pages; unlike
+	/// FileInputStream, no data is copied into an intermediate
+	/// buffer. Positioning with seekg() and tellg() is supported.
+	///
+	/// Consumers that can work with a contiguous block of memory
+	/// can get it from file().begin() and file().end() instead.
+{
+public:
+	MappedInputStream(const std::string& path);
+		/// Creates a MappedInputStream for reading the file given by path,
+		/// which is mapped with MappedFile::ADVICE_SEQUENTIAL.
+		///
+		/// Throws a FileNotFoundException if the file does not exist,
+		/// or an OpenFileException if it cannot be opened.
+
+	MappedInputStream(const MappedFile& file);
+		/// Creates a MappedInputStream for reading the given mapping.
+
+	~MappedInputStream();
+		/// Destroys the MappedInputStream.
+};
+
+
+//
+// inlines
+//
+inline void MappedFile::swap(MappedFile& other)
+{
+	using std::swap;
+	swap(_pImpl, other._pImpl);
+}
+
+
+inline MemoryStreamBuf* MappedIOS::rdbuf()
+{
+	return &_buf;
+}
+
+
+inline const MappedFile& MappedIOS::file() const
+{
+	return _file;
+}
+
+
+} // namespace Poco
+
+
+#endif // Foundation_MappedFile_INCLUDED
@@ -0,0 +1,102 @@
+//
+// MappedFile_POSIX.h
+//
+// Library: Foundation
+// Package: Filesystem
+// Module:  MappedFile
+//
+// Definition of the MappedFileImpl class for POSIX.
+//
+// Copyright (c) 2007, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Foundation_MappedFile_POSIX_INCLUDED
+#define Foundation_MappedFile_POSIX_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include "Poco/MappedFile.h"
+#include "Poco/RefCountedObject.h"
+
+
+namespace Poco {
+
+
+class Foundation_API MappedFileImpl: public RefCountedObject
+	/// Memory mapped file implementation for POSIX platforms.
+{
+public:
+	MappedFileImpl(const std::string& path, UInt64 offset, std::size_t length, bool toEnd);
+		/// Maps length bytes of the file, starting at offset,
+		/// or the rest of the file if toEnd is true.
+
+	const char* begin() const;
+	const char* end() const;
+	std::size_t size() const;
+	UInt64 offset() const;
+	UInt64 fileSize() const;
+
+	bool advise(MappedFile::Advice advice, std::size_t offset, std::size_t length) const;
+
+	static std::size_t pageSize();
+	static std::size_t allocationGranularity();
+
+protected:
+	~MappedFileImpl();
+
+private:
+	MappedFileImpl();
+	MappedFileImpl(const MappedFileImpl&);
+	MappedFileImpl& operator = (const MappedFileImpl&);
+
+	std::string _path;
+	char*       _mapAddress;
+	std::size_t _mapSize;
+	const char* _address;
+	std::size_t _size;
+	UInt64      _offset;
+	UInt64      _fileSize;
+};
+
+
+//
+// inlines
+//
+inline const char* MappedFileImpl::begin() const
+{
+	return _address;
+}
+
+
+inline const char* MappedFileImpl::end() const
+{
+	return _address + _size;
+}
+
+
+inline std::size_t MappedFileImpl::size() const
+{
+	return _size;
+}
+
+
+inline UInt64 MappedFileImpl::offset() const
+{
+	return _offset;
+}
+
+
+inline UInt64 MappedFileImpl::fileSize() const
+{
+	return _fileSize;
+}
+
+
+} // namespace Poco
+
+
+#endif // Foundation_MappedFile_POSIX_INCLUDED
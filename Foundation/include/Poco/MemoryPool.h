@@ -61,6 +61,18 @@ public:
 	void release(void* ptr);
 	/// Releases a memory block and returns it to the pool.
 
+	std::size_t getBlocks(void** blocks, std::size_t n);
+	/// Obtains up to n memory blocks with a single lock
+	/// acquisition and stores them in blocks.
+	///
+	/// Returns the number of blocks obtained, which is less than
+	/// n only if maxAlloc blocks are already allocated. If no block
+	/// can be obtained at all, an OutOfMemoryException is thrown.
+
+	void releaseBlocks(void** blocks, std::size_t n);
+	/// Returns n memory blocks to the pool with a single
+	/// lock acquisition.
+
 	std::size_t blockSize() const;
 	/// Returns the block size.
 
@@ -347,6 +359,48 @@ public:
 		_firstBlock = new (ptr) Block(_firstBlock);
 	}
 
+	std::size_t getBlocks(void** blocks, std::size_t n)
+		/// Obtains up to n memory blocks with a single lock acquisition
+		/// and stores them in blocks. The pool is resized as needed.
+		///
+		/// Returns the number of blocks obtained, which is less than
+		/// n only if the pool cannot be resized. If no block can be
+		/// obtained at all, std::bad_alloc is thrown.
+	{
+		std::size_t i = 0;
+		{
+			ScopedLock l(_mutex);
+			try
+			{
+				for (; i < n; ++i)
+				{
+					if (_firstBlock == 0) resize();
+					blocks[i] = _firstBlock;
+					_firstBlock = _firstBlock->_memory.next;
+				}
+			}
+			catch (...)
+			{
+				if (i == 0) throw;
+			}
+		}
+		_available -= i;
+		return i;
+	}
+
+	void releaseBlocks(void** blocks, std::size_t n)
+		/// Returns n raw memory blocks, obtained with get() or
+		/// getBlocks(), to the pool with a single lock acquisition.
+		/// Unlike release(), no destructor is called.
+	{
+		_available += n;
+		ScopedLock l(_mutex);
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			_firstBlock = new (blocks[i]) Block(_firstBlock);
+		}
+	}
+
 	std::size_t blockSize() const
 		/// Returns the block size in bytes.
 	{
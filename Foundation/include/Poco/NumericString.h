@@ -731,6 +731,16 @@ Foundation_API double strToDouble(const char* str,
 	/// Converts the string of characters into double-precision floating point number.
 
 
+Foundation_API bool strToDouble(const char* str, std::size_t length, double& result);
+	/// Converts the length characters starting at str, which must form a
+	/// decimal floating point number in C notation without surrounding
+	/// whitespace, into a double-precision floating point number.
+	/// The string does not need to be zero terminated.
+	///
+	/// Returns true if all characters have been consumed and the
+	/// result is finite, otherwise false.
+
+
 Foundation_API bool strToDouble(const std::string& str, double& result,
 	char decSep = '.', char thSep = ',',
 	const char* inf = POCO_FLT_INF, const char* nan = POCO_FLT_NAN);
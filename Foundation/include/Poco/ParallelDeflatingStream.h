@@ -0,0 +1,182 @@
+//
+// ParallelDeflatingStream.h
+//
+// Library: Foundation
+// Package: Streams
+// Module:  ZLibStream
+//
+// Definition of the ParallelDeflatingStream class.
+//
+// Copyright (c) 2004-2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Foundation_ParallelDeflatingStream_INCLUDED
+#define Foundation_ParallelDeflatingStream_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include "Poco/BufferedStreamBuf.h"
+#include "Poco/DeflatingStream.h"
+#include <ostream>
+#include <string>
+#include <deque>
+#include <vector>
+
+
+namespace Poco {
+
+
+class ThreadPool;
+
+
+class Foundation_API ParallelDeflatingStreamBuf: public BufferedStreamBuf
+	/// This is the streambuf class used by ParallelDeflatingOutputStream.
+	///
+	/// Data written to the stream buffer is split into blocks of
+	/// a fixed size, which are compressed concurrently by the threads
+	/// of a ThreadPool. Each block is primed with the last 32 Kbytes
+	/// of the preceding data as preset dictionary, so the compression
+	/// ratio is almost the same as with DeflatingStreamBuf.
+	/// The compressed blocks are written to the output stream in order,
+	/// forming a single valid zlib or gzip stream that can be read
+	/// with InflatingInputStream or any other inflater.
+	///
+	/// If the thread pool has no idle thread available, a block
+	/// is compressed on the calling thread.
+	///
+	/// Flushing the stream (sync()) ends the current block and waits
+	/// until all pending blocks have been written to the output stream.
+	///
+	/// close() must be called to ensure proper completion
+	/// of compression.
+{
+public:
+	enum
+	{
+		DEFAULT_BLOCK_SIZE = 131072
+	};
+
+	ParallelDeflatingStreamBuf(std::ostream& ostr, DeflatingStreamBuf::StreamType type, int level, std::size_t blockSize, ThreadPool& pool);
+		/// Creates a ParallelDeflatingStreamBuf for compressing data passed
+		/// through and forwarding it to the given output stream.
+		///
+		/// The compression level (0 to 9, or Z_DEFAULT_COMPRESSION) and the
+		/// size of the uncompressed blocks compressed independently
+		/// can be specified. Blocks are compressed using the given ThreadPool.
+		///
+		/// Throws an InvalidArgumentException if level or blockSize is out of range.
+
+	~ParallelDeflatingStreamBuf();
+		/// Destroys the ParallelDeflatingStreamBuf.
+
+	int close();
+		/// Finishes up the stream.
+		///
+		/// Compresses the remaining data, waits for all blocks
+		/// and writes the stream trailer.
+
+protected:
+	int writeToDevice(const char* buffer, std::streamsize length);
+	virtual int sync();
+
+private:
+	class Block;
+
+	enum
+	{
+		DICTIONARY_SIZE = 32768
+	};
+
+	void submit(const char* buffer, std::size_t length, bool last);
+	void writeFront();
+	void drain();
+	void writeHeader();
+	void writeTrailer();
+
+	std::ostream*                  _pOstr;
+	DeflatingStreamBuf::StreamType _type;
+	int                            _level;
+	ThreadPool&                    _pool;
+	std::size_t                    _maxPending;
+	std::deque<Block*>             _pending;
+	std::vector<Block*>            _idle;
+	std::string                    _dictionary;
+	UInt32                         _checksum;
+	UInt64                         _totalIn;
+	bool                           _headerWritten;
+};
+
+
+class Foundation_API ParallelDeflatingIOS: public virtual std::ios
+	/// The base class for ParallelDeflatingOutputStream.
+	///
+	/// This class is needed to ensure the correct initialization
+	/// order of the stream buffer and base classes.
+{
+public:
+	ParallelDeflatingIOS(std::ostream& ostr, DeflatingStreamBuf::StreamType type, int level, std::size_t blockSize, ThreadPool& pool);
+		/// Creates a ParallelDeflatingIOS for compressing data passed
+		/// through and forwarding it to the given output stream.
+
+	~ParallelDeflatingIOS();
+		/// Destroys the ParallelDeflatingIOS.
+
+	ParallelDeflatingStreamBuf* rdbuf();
+		/// Returns a pointer to the underlying stream buffer.
+
+protected:
+	ParallelDeflatingStreamBuf _buf;
+};
+
+
+class Foundation_API ParallelDeflatingOutputStream: public std::ostream, public ParallelDeflatingIOS
+	/// This stream compresses all data passing through it
+	/// using zlib's deflate algorithm, using multiple threads.
+	///
+	/// The compressed data is a regular zlib or gzip stream, but
+	/// typically slightly (less than one percent) larger than the
+	/// output of DeflatingOutputStream.
+	///
+	/// After all data has been written to the stream, close()
+	/// must be called to ensure completion of compression.
+	/// Example:
+	///     std::ofstream ostr("data.gz", std::ios::binary);
+	///     ParallelDeflatingOutputStream deflater(ostr, DeflatingStreamBuf::STREAM_GZIP);
+	///     StreamCopier::copyStream(istr, deflater);
+	///     deflater.close();
+	///     ostr.close();
+{
+public:
+	ParallelDeflatingOutputStream(std::ostream& ostr, DeflatingStreamBuf::StreamType type = DeflatingStreamBuf::STREAM_ZLIB, int level = Z_DEFAULT_COMPRESSION, std::size_t blockSize = ParallelDeflatingStreamBuf::DEFAULT_BLOCK_SIZE);
+		/// Creates a ParallelDeflatingOutputStream for compressing data passed
+		/// through and forwarding it to the given output stream.
+		///
+		/// Blocks are compressed using the default ThreadPool.
+
+	ParallelDeflatingOutputStream(std::ostream& ostr, ThreadPool& pool, DeflatingStreamBuf::StreamType type = DeflatingStreamBuf::STREAM_ZLIB, int level = Z_DEFAULT_COMPRESSION, std::size_t blockSize = ParallelDeflatingStreamBuf::DEFAULT_BLOCK_SIZE);
+		/// Creates a ParallelDeflatingOutputStream for compressing data passed
+		/// through and forwarding it to the given output stream.
+		///
+		/// Blocks are compressed using the given ThreadPool.
+
+	~ParallelDeflatingOutputStream();
+		/// Destroys the ParallelDeflatingOutputStream.
+
+	int close();
+		/// Finishes up the stream.
+		///
+		/// Must be called when deflating to an output stream.
+
+protected:
+	virtual int sync();
+};
+
+
+} // namespace Poco
+
+
+#endif // Foundation_ParallelDeflatingStream_INCLUDED
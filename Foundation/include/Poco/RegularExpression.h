@@ -71,7 +71,8 @@ public:
 		RE_NEWLINE_ANY     = 0x00400000, /// assume newline is any valid Unicode newline character [ctor]
 		RE_NEWLINE_ANYCRLF = 0x00500000, /// assume newline is any of CR, LF, CRLF [ctor]
 		RE_GLOBAL          = 0x10000000, /// replace all occurrences (/g) [subst]
-		RE_NO_VARS         = 0x20000000  /// treat dollar in replacement string as ordinary character [subst]
+		RE_NO_VARS         = 0x20000000, /// treat dollar in replacement string as ordinary character [subst]
+		RE_JIT             = 0x40000000  /// compile the pattern to machine code, if supported by PCRE (see isJITSupported()) [ctor]
 	};
 	
 	struct Match
@@ -82,11 +83,56 @@ public:
 	};
 	typedef std::vector<Match> MatchVec;
 	typedef std::map<int, std::string> GroupMap;
+
+	class Foundation_API MatchContext
+		/// A MatchContext holds the working memory used for matching
+		/// a subject string against a RegularExpression: the vector
+		/// receiving the offsets of captured substrings and, for patterns
+		/// compiled with RE_JIT, the stack used by the compiled code.
+		///
+		/// Passing a MatchContext to match() avoids setting up this memory
+		/// for every call, and gives JIT-compiled patterns a stack that can
+		/// grow beyond the 32 KB the JIT uses by default. For JIT-compiled
+		/// patterns, matching with a MatchContext also skips some
+		/// argument checks, making it the fastest way to match in a loop.
+		///
+		/// A MatchContext can be used with any number of RegularExpression
+		/// objects, but only by one thread at a time.
+	{
+	public:
+		enum
+		{
+			DEFAULT_MAX_JIT_STACK_SIZE = 512*1024
+		};
+
+		explicit MatchContext(int maxJITStackSize = DEFAULT_MAX_JIT_STACK_SIZE);
+			/// Creates the MatchContext. The JIT stack starts at 32 KB
+			/// and can grow up to maxJITStackSize bytes. It is only allocated
+			/// when first used with a JIT-compiled pattern.
+
+		~MatchContext();
+			/// Destroys the MatchContext.
+
+	private:
+		MatchContext(const MatchContext&);
+		MatchContext& operator = (const MatchContext&);
+
+		void* jitStack();
+
+		int   _maxJITStackSize;
+		void* _pJITStack; // Actual type is pcre_jit_stack*
+		int*  _ovec;
+
+		friend class RegularExpression;
+	};
 	
 	RegularExpression(const std::string& pattern, int options = 0, bool study = true);
 		/// Creates a regular expression and parses the given pattern.
 		/// If study is true, the pattern is analyzed and optimized. This
 		/// is mainly useful if the pattern is used more than once.
+		/// If RE_JIT is given in options, the pattern is always studied and,
+		/// if the PCRE library supports it, compiled to machine code. Otherwise,
+		/// RE_JIT is ignored.
 		/// For a description of the options, please see the PCRE documentation.
 		/// Throws a RegularExpressionException if the patter cannot be compiled.
 		
@@ -118,6 +164,16 @@ public:
 		/// Throws a RegularExpressionException in case of an error.
 		/// Returns the number of matches.
 
+	int match(const std::string& subject, std::string::size_type offset, Match& mtch, MatchContext& context, int options = 0) const;
+		/// Matches the given subject string, starting at offset, against the pattern,
+		/// using the given MatchContext.
+		/// Otherwise the same as match(subject, offset, mtch, options).
+
+	int match(const std::string& subject, std::string::size_type offset, MatchVec& matches, MatchContext& context, int options = 0) const;
+		/// Matches the given subject string, starting at offset, against the pattern,
+		/// using the given MatchContext.
+		/// Otherwise the same as match(subject, offset, matches, options).
+
 	bool match(const std::string& subject, std::string::size_type offset = 0) const;
 		/// Returns true if and only if the subject matches the regular expression.
 		///
@@ -194,14 +250,27 @@ public:
 		/// Matches the given subject string against the regular expression given in pattern,
 		/// using the given options.
 
+	bool isJIT() const;
+		/// Returns true if the pattern has been compiled to machine code.
+
+	static bool isJITSupported();
+		/// Returns true if the PCRE library supports compiling
+		/// patterns to machine code (see RE_JIT).
+
 protected:
 	std::string::size_type substOne(std::string& subject, std::string::size_type offset, const std::string& replacement, int options) const;
+	int exec(const std::string& subject, std::string::size_type offset, int* ovec, int options, MatchContext* pContext) const;
+		/// Matches the subject against the pattern and stores the offsets of
+		/// the captured substrings in ovec, which must have OVEC_SIZE elements.
+		/// Returns the number of captured substrings, or 0 if the subject
+		/// does not match.
 
 private:
 	// Note: to avoid a dependency on the pcre.h header the following are
 	// declared as void* and casted to the correct type in the implementation file.
 	void* _pcre;  // Actual type is pcre*
 	void* _extra; // Actual type is struct pcre_extra*
+	bool  _jit;
 	
 	GroupMap _groups;
 
@@ -234,6 +303,12 @@ inline int RegularExpression::subst(std::string& subject, const std::string& rep
 }
 
 
+inline bool RegularExpression::isJIT() const
+{
+	return _jit;
+}
+
+
 inline bool RegularExpression::operator == (const std::string& subject) const
 {
 	return match(subject);
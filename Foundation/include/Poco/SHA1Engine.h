@@ -34,6 +34,9 @@ namespace Poco {
 class Foundation_API SHA1Engine: public DigestEngine
 	/// This class implements the SHA-1 message digest algorithm.
 	/// (FIPS 180-1, see http://www.itl.nist.gov/fipspubs/fip180-1.htm)
+	///
+	/// On x86 CPUs supporting the SHA extensions (SHA-NI), which are
+	/// detected at runtime, blocks are processed using these instructions.
 {
 public:
 	enum
@@ -53,11 +56,12 @@ protected:
 	void updateImpl(const void* data, std::size_t length);
 
 private:
+	typedef UInt8 BYTE;
+
 	void transform();
+	void processBlocks(const BYTE* data, std::size_t blocks);
 	static void byteReverse(UInt32* buffer, int byteCount);
 
-	typedef UInt8 BYTE;
-
 	struct Context
 	{
 		UInt32 digest[5]; // Message digest
@@ -30,8 +30,23 @@ namespace Poco {
 class Foundation_API StreamCopier
 	/// This class provides static methods to copy the contents from one stream
 	/// into another.
+	///
+	/// If both streams are file streams (FileInputStream, FileOutputStream
+	/// or FileStream), copyStream() and copyStream64() let the kernel copy
+	/// the data (using copy_file_range() or sendfile() on Linux), so that
+	/// it never passes through user space. If the source is a file stream,
+	/// the buffer used by the buffered copy functions is enlarged up to
+	/// MAX_BUFFER_SIZE, depending on the remaining size of the file.
+	/// The buffer size used for other streams is not changed, since
+	/// reading from them blocks until the buffer is full.
 {
 public:
+	enum
+	{
+		MAX_BUFFER_SIZE = 1024*1024
+			/// Maximum size of the buffer used when copying from a file stream.
+	};
+
 	static std::streamsize copyStream(std::istream& istr, std::ostream& ostr, std::size_t bufferSize = 8192);
 		/// Writes all bytes readable from istr to ostr, using an internal buffer.
 		///
@@ -76,6 +91,27 @@ public:
 		/// Note: the only difference to copyToString() is that a 64-bit unsigned
 		/// integer is used to count the number of bytes copied.
 #endif
+
+private:
+	template <typename T>
+	static T copyStreamImpl(std::istream& istr, std::ostream& ostr, std::size_t bufferSize);
+
+	template <typename T>
+	static T copyToStringImpl(std::istream& istr, std::string& str, std::size_t bufferSize);
+
+	static bool copyFile(std::istream& istr, std::ostream& ostr, Poco::UInt64& count);
+		/// Copies the contents of a file stream to another file stream
+		/// without copying data to user space, if supported by the platform.
+		/// Adds the number of bytes copied to count.
+		///
+		/// Returns true if the end of istr has been reached, or false if
+		/// the remaining bytes must be copied with the buffered copy.
+		/// This is also the case for files reporting a size of 0, or
+		/// if the kernel does not copy anything, as with procfs or sysfs.
+
+	static std::size_t fileBufferSize(std::istream& istr, std::size_t bufferSize, Poco::UInt64& remaining);
+		/// Returns the buffer size to be used for copying from istr,
+		/// and the remaining size if istr is a file stream.
 };
 
 
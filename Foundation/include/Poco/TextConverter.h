@@ -30,6 +30,13 @@ class TextEncoding;
 class Foundation_API TextConverter
 	/// A TextConverter converts strings from one encoding
 	/// into another.
+	///
+	/// If no transform function is given, and both encodings
+	/// represent 7-bit ASCII characters as themselves (e.g., UTF-8,
+	/// ISO-8859-1 or Windows-1252), runs of ASCII characters
+	/// are copied without decoding and encoding every single character.
+	/// Valid UTF-8 input is copied as a whole if the output encoding
+	/// is UTF-8 as well.
 {
 public:
 	typedef int (*Transform)(int);
@@ -77,13 +84,27 @@ public:
 		/// in source).
 
 private:
+	enum InputMode
+	{
+		INPUT_GENERIC,
+		INPUT_SINGLE_BYTE,
+		INPUT_UTF8
+	};
+
 	TextConverter();
 	TextConverter(const TextConverter&);
 	TextConverter& operator = (const TextConverter&);
 
+	bool convertFast(const char* source, std::size_t length, std::string& destination, int& errors);
+		/// Converts the source if the encodings allow copying
+		/// ASCII characters directly. Returns false otherwise.
+
 	const TextEncoding& _inEncoding;
 	const TextEncoding& _outEncoding;
 	int                 _defaultChar;
+	InputMode           _inputMode;
+	bool                _asciiOutput;
+	bool                _utf8Output;
 };
 
 
@@ -0,0 +1,308 @@
+//
+// ThreadCachedMemoryPool.h
+//
+// Library: Foundation
+// Package: Core
+// Module:  ThreadCachedMemoryPool
+//
+// Definition of the AbstractThreadCachedPool, ThreadCachedMemoryPool
+// and ThreadCachedFastMemoryPool classes.
+//
+// Copyright (c) 2005-2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Foundation_ThreadCachedMemoryPool_INCLUDED
+#define Foundation_ThreadCachedMemoryPool_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include "Poco/MemoryPool.h"
+#include "Poco/SharedPtr.h"
+#include <cstddef>
+
+
+namespace Poco {
+
+
+class Foundation_API AbstractThreadCachedPool
+	/// AbstractThreadCachedPool is the base class for memory pools
+	/// that keep a small per-thread cache ("magazine") of free blocks
+	/// in front of a shared, lock-protected backing pool.
+	///
+	/// Blocks are handed out from and returned to the calling thread's
+	/// magazine without any locking. Only when a magazine runs empty
+	/// is it refilled from the backing pool, and only when it runs full
+	/// is half of it returned to the backing pool - in both cases as a
+	/// batch, with a single lock acquisition on the backing pool.
+	///
+	/// When a thread terminates, the blocks held in its magazines
+	/// are returned to their backing pools.
+	///
+	/// Every block carries a small header recording the thread that
+	/// obtained it. This is used to count blocks that are released by
+	/// a different thread (cross-thread frees). Such blocks are simply
+	/// cached by the releasing thread.
+	///
+	/// Subclasses implement refill() and drain() for the backing pool
+	/// and must call shutdown() from their destructor.
+	///
+	/// A pool must not be destroyed while other threads are still
+	/// using it. After destruction, any memory taken from, but not
+	/// returned to, the pool becomes invalid.
+{
+public:
+	struct Statistics
+		/// Usage statistics of a thread-cached pool, accumulated
+		/// over all threads.
+	{
+		Statistics();
+
+		UInt64 hits;             /// get() served from the calling thread's magazine
+		UInt64 misses;           /// get() requiring a refill from the backing pool
+		UInt64 refills;          /// batch transfers from the backing pool
+		UInt64 flushes;          /// batch transfers to the backing pool
+		UInt64 crossThreadFrees; /// blocks released by a thread other than the one that obtained them
+	};
+
+	enum
+	{
+		DEFAULT_MAGAZINE_SIZE = 32
+	};
+
+	std::size_t magazineSize() const;
+		/// Returns the maximum number of blocks cached per thread.
+
+	Statistics statistics() const;
+		/// Returns the usage statistics, accumulated over all
+		/// threads that have used the pool.
+
+	void flush();
+		/// Returns all blocks cached by the calling thread to the
+		/// backing pool.
+
+protected:
+	explicit AbstractThreadCachedPool(std::size_t magazineSize);
+		/// Creates the AbstractThreadCachedPool.
+		///
+		/// The magazineSize specifies the maximum number of
+		/// free blocks each thread keeps cached. Batches of
+		/// magazineSize/2 blocks are moved between the per-thread
+		/// magazine and the backing pool.
+
+	virtual ~AbstractThreadCachedPool();
+		/// Destroys the AbstractThreadCachedPool.
+
+	void* getBlock();
+		/// Returns a memory block from the calling thread's magazine,
+		/// refilling the magazine from the backing pool if necessary.
+
+	void releaseBlock(void* ptr);
+		/// Returns a memory block, obtained with getBlock(),
+		/// to the calling thread's magazine. If the magazine is full,
+		/// half of it is first returned to the backing pool.
+
+	void shutdown();
+		/// Returns all blocks cached by any thread to the backing pool
+		/// and detaches the pool from all thread caches.
+		///
+		/// Must be called by subclass destructors.
+
+	virtual std::size_t refill(void** blocks, std::size_t n) = 0;
+		/// Obtains up to n raw blocks of (at least) blockSize() + HEADER_SIZE
+		/// bytes from the backing pool and returns the number
+		/// of blocks obtained. Must obtain at least one block
+		/// or throw an exception.
+
+	virtual void drain(void** blocks, std::size_t n) = 0;
+		/// Returns n raw blocks to the backing pool.
+
+	enum
+	{
+		HEADER_SIZE = alignof(std::max_align_t)
+			/// Size of the block header that precedes the memory
+			/// handed out to the user.
+	};
+
+private:
+	class Control;
+	class Magazine;
+	class ThreadCaches;
+
+	AbstractThreadCachedPool();
+	AbstractThreadCachedPool(const AbstractThreadCachedPool&);
+	AbstractThreadCachedPool& operator = (const AbstractThreadCachedPool&);
+
+	Magazine* magazine();
+	static ThreadCaches& threadCaches();
+
+	std::size_t         _magazineSize;
+	UInt64              _id;
+	SharedPtr<Control>  _pControl;
+};
+
+
+class Foundation_API ThreadCachedMemoryPool: public AbstractThreadCachedPool
+	/// A thread-cached pool for fixed-size memory blocks,
+	/// backed by a MemoryPool.
+	///
+	/// ThreadCachedMemoryPool has the same interface as MemoryPool,
+	/// but get() and release() only acquire the MemoryPool's mutex
+	/// once every magazineSize/2 calls, which greatly reduces lock
+	/// contention when many threads allocate blocks concurrently.
+{
+public:
+	ThreadCachedMemoryPool(std::size_t blockSize, int preAlloc = 0, int maxAlloc = 0, std::size_t magazineSize = DEFAULT_MAGAZINE_SIZE);
+		/// Creates a ThreadCachedMemoryPool for blocks with the given blockSize.
+		/// The number of blocks given in preAlloc are preallocated.
+		/// At most maxAlloc blocks (if not zero) are allocated.
+
+	~ThreadCachedMemoryPool();
+		/// Destroys the ThreadCachedMemoryPool.
+
+	void* get();
+		/// Returns a memory block. If there are no more blocks
+		/// in the calling thread's cache or the backing pool, a
+		/// new block will be allocated.
+		///
+		/// If maxAlloc blocks are already allocated, an
+		/// OutOfMemoryException is thrown.
+
+	void release(void* ptr);
+		/// Releases a memory block and returns it to the pool.
+
+	std::size_t blockSize() const;
+		/// Returns the block size.
+
+	int allocated() const;
+		/// Returns the number of allocated blocks.
+
+protected:
+	std::size_t refill(void** blocks, std::size_t n);
+	void drain(void** blocks, std::size_t n);
+
+private:
+	ThreadCachedMemoryPool();
+	ThreadCachedMemoryPool(const ThreadCachedMemoryPool&);
+	ThreadCachedMemoryPool& operator = (const ThreadCachedMemoryPool&);
+
+	std::size_t _blockSize;
+	MemoryPool  _pool;
+};
+
+
+template <typename T, typename M = SpinlockMutex>
+class ThreadCachedFastMemoryPool: public AbstractThreadCachedPool
+	/// A thread-cached pool for blocks holding objects of type T,
+	/// backed by a FastMemoryPool.
+	///
+	/// ThreadCachedFastMemoryPool has the same interface and usage
+	/// rules as FastMemoryPool; objects are created with in-place
+	/// new in memory obtained with get(), and release() calls the
+	/// destructor before returning the memory to the pool.
+{
+public:
+	ThreadCachedFastMemoryPool(std::size_t blocksPerBucket = POCO_FAST_MEMORY_POOL_PREALLOC,
+		std::size_t bucketPreAlloc = 10,
+		std::size_t maxAlloc = 0,
+		std::size_t magazineSize = DEFAULT_MAGAZINE_SIZE):
+			AbstractThreadCachedPool(magazineSize),
+			_pool(blocksPerBucket, bucketPreAlloc, maxAlloc)
+		/// Creates the ThreadCachedFastMemoryPool. See FastMemoryPool
+		/// for the meaning of blocksPerBucket, bucketPreAlloc and maxAlloc.
+	{
+	}
+
+	~ThreadCachedFastMemoryPool()
+		/// Destroys the ThreadCachedFastMemoryPool and releases all memory.
+	{
+		shutdown();
+	}
+
+	void* get()
+		/// Returns pointer to the next available memory block.
+	{
+		return getBlock();
+	}
+
+	template <typename P>
+	void release(P* ptr)
+		/// Calls the destructor for the given pointer and returns
+		/// its memory to the pool. Releasing of null pointers is
+		/// silently ignored.
+	{
+		if (!ptr) return;
+		ptr->~P();
+		releaseBlock(ptr);
+	}
+
+	std::size_t blockSize() const
+		/// Returns the block size in bytes.
+	{
+		return sizeof(T);
+	}
+
+protected:
+	std::size_t refill(void** blocks, std::size_t n)
+	{
+		return _pool.getBlocks(blocks, n);
+	}
+
+	void drain(void** blocks, std::size_t n)
+	{
+		_pool.releaseBlocks(blocks, n);
+	}
+
+private:
+	struct Slot
+	{
+		char data[HEADER_SIZE + sizeof(T)];
+	};
+
+	ThreadCachedFastMemoryPool(const ThreadCachedFastMemoryPool&) = delete;
+	ThreadCachedFastMemoryPool& operator = (const ThreadCachedFastMemoryPool&) = delete;
+
+	FastMemoryPool<Slot, M> _pool;
+};
+
+
+//
+// inlines
+//
+inline std::size_t AbstractThreadCachedPool::magazineSize() const
+{
+	return _magazineSize;
+}
+
+
+inline void* ThreadCachedMemoryPool::get()
+{
+	return getBlock();
+}
+
+
+inline void ThreadCachedMemoryPool::release(void* ptr)
+{
+	releaseBlock(ptr);
+}
+
+
+inline std::size_t ThreadCachedMemoryPool::blockSize() const
+{
+	return _blockSize;
+}
+
+
+inline int ThreadCachedMemoryPool::allocated() const
+{
+	return _pool.allocated();
+}
+
+
+} // namespace Poco
+
+
+#endif // Foundation_ThreadCachedMemoryPool_INCLUDED
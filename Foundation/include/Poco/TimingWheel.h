@@ -0,0 +1,244 @@
+//
+// TimingWheel.h
+//
+// Library: Foundation
+// Package: Threading
+// Module:  TimingWheel
+//
+// Definition of the TimingWheel class.
+//
+// Copyright (c) 2009, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Foundation_TimingWheel_INCLUDED
+#define Foundation_TimingWheel_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include "Poco/RefCountedObject.h"
+#include "Poco/AutoPtr.h"
+#include "Poco/Clock.h"
+#include <vector>
+
+
+namespace Poco {
+
+
+class Foundation_API TimingWheel
+	/// A hierarchical timing wheel, as described by Varghese and Lauck
+	/// in "Hashed and Hierarchical Timing Wheels", for managing large
+	/// numbers of timeouts.
+	///
+	/// Time is divided into ticks of a configurable resolution. Timeouts
+	/// are kept in intrusive lists in one of several wheels of 256 slots
+	/// each, covering 256, 256^2, 256^3 and 256^4 ticks, respectively.
+	/// Scheduling, rescheduling and cancelling a timeout take constant
+	/// time and do not allocate memory. Timeouts in the outer wheels are
+	/// moved to the inner wheels as time advances, so each timeout is
+	/// touched at most once per wheel. Timeouts further in the future
+	/// than the outermost wheel covers are parked in its last slot.
+	///
+	/// Expired timeouts are collected in batches by advance(). Deadlines
+	/// are rounded up to the next tick, so a timeout never expires early,
+	/// but may expire up to one tick late. Timeouts expiring within the
+	/// same tick are returned in the order of their deadlines, and
+	/// timeouts with equal deadlines in the order they have been
+	/// scheduled.
+	///
+	/// The TimingWheel does not own a thread and is not thread-safe.
+	/// It is meant to be driven by a thread that calls advance()
+	/// periodically, or sleeps until nextDeadline(), like the one
+	/// of Poco::Util::Timer, or by an event loop that enforces
+	/// idle timeouts for many connections. Callers must serialize
+	/// all access to a TimingWheel and its scheduled Timeout objects.
+{
+public:
+	class Foundation_API Timeout: public RefCountedObject
+		/// The base class for timeouts managed by a TimingWheel.
+		///
+		/// Subclasses carry whatever is needed to handle the
+		/// timeout once advance() has returned it.
+		///
+		/// A Timeout can be scheduled with at most one TimingWheel
+		/// at a time. While it is scheduled, the TimingWheel
+		/// holds a reference to it.
+	{
+	public:
+		typedef AutoPtr<Timeout> Ptr;
+
+		Timeout();
+			/// Creates the Timeout.
+
+		bool isScheduled() const;
+			/// Returns true if the Timeout is currently scheduled
+			/// with a TimingWheel.
+
+		const Clock& deadline() const;
+			/// Returns the deadline the Timeout has last been
+			/// scheduled for.
+
+	protected:
+		virtual ~Timeout();
+			/// Destroys the Timeout.
+
+	private:
+		Timeout(const Timeout&);
+		Timeout& operator = (const Timeout&);
+
+		TimingWheel* _pWheel;
+		Timeout*     _pPrev;
+		Timeout*     _pNext;
+		int          _slot;
+		UInt64       _tick;
+		UInt64       _sequence;
+		Clock        _deadline;
+
+		friend class TimingWheel;
+	};
+
+	typedef std::vector<Timeout::Ptr> TimeoutVec;
+
+	explicit TimingWheel(Clock::ClockDiff resolution = 1000);
+		/// Creates the TimingWheel, using ticks of the given
+		/// resolution in microseconds, starting at the current time.
+
+	TimingWheel(Clock::ClockDiff resolution, const Clock& start);
+		/// Creates the TimingWheel, using ticks of the given
+		/// resolution in microseconds, starting at the given time.
+
+	~TimingWheel();
+		/// Destroys the TimingWheel and releases all
+		/// scheduled timeouts.
+
+	void schedule(Timeout::Ptr pTimeout, const Clock& deadline);
+		/// Schedules the given timeout for the given deadline.
+		///
+		/// If the timeout is already scheduled with this TimingWheel,
+		/// it is moved to the new deadline, which makes re-arming an
+		/// idle timeout after every bit of activity cheap. Deadlines
+		/// that have already passed expire with the next tick.
+		///
+		/// Throws an InvalidAccessException if the timeout is
+		/// scheduled with another TimingWheel.
+
+	bool cancel(Timeout::Ptr pTimeout);
+		/// Removes the given timeout from the TimingWheel.
+		///
+		/// Returns true if the timeout has been cancelled,
+		/// or false if it was not scheduled with this TimingWheel.
+
+	std::size_t advance(const Clock& now, TimeoutVec& expired);
+		/// Advances the TimingWheel to the given time and appends
+		/// all timeouts whose deadlines have been reached, in the
+		/// order of their deadlines, to expired.
+		///
+		/// Returns the number of expired timeouts.
+
+	bool nextDeadline(Clock& deadline) const;
+		/// Stores the time at which advance() must be called next
+		/// into deadline. This is never later than the earliest
+		/// deadline of all scheduled timeouts, but may be earlier
+		/// if the outer wheels must be processed first.
+		///
+		/// Returns false, leaving deadline unchanged, if no
+		/// timeouts are scheduled.
+
+	void clear();
+		/// Releases all scheduled timeouts.
+
+	std::size_t size() const;
+		/// Returns the number of scheduled timeouts.
+
+	bool empty() const;
+		/// Returns true if no timeouts are scheduled.
+
+	Clock::ClockDiff resolution() const;
+		/// Returns the tick resolution in microseconds.
+
+	Clock now() const;
+		/// Returns the time the TimingWheel has been advanced to,
+		/// rounded down to a tick.
+
+private:
+	enum
+	{
+		WHEEL_BITS   = 8,
+		WHEEL_SIZE   = 1 << WHEEL_BITS,
+		WHEEL_MASK   = WHEEL_SIZE - 1,
+		WHEEL_LEVELS = 4
+	};
+
+	struct Slot
+	{
+		Timeout* pHead;
+		Timeout* pTail;
+	};
+
+	TimingWheel(const TimingWheel&);
+	TimingWheel& operator = (const TimingWheel&);
+
+	void init(Clock::ClockDiff resolution, const Clock& start);
+	void insert(Timeout* pTimeout, UInt64 minTick);
+	void unlink(Timeout* pTimeout);
+	Timeout* detach(int slot);
+	void cascade();
+	void expire(TimeoutVec& expired);
+	static bool expiresBefore(const Timeout::Ptr& pTimeout1, const Timeout::Ptr& pTimeout2);
+
+	Clock::ClockDiff _resolution;
+	Clock::ClockVal  _origin;
+	UInt64           _currentTick;
+	UInt64           _sequence;
+	std::size_t      _size;
+	std::size_t      _levelSize[WHEEL_LEVELS];
+	Slot             _slots[WHEEL_LEVELS*WHEEL_SIZE];
+};
+
+
+//
+// inlines
+//
+inline bool TimingWheel::Timeout::isScheduled() const
+{
+	return _pWheel != 0;
+}
+
+
+inline const Clock& TimingWheel::Timeout::deadline() const
+{
+	return _deadline;
+}
+
+
+inline std::size_t TimingWheel::size() const
+{
+	return _size;
+}
+
+
+inline bool TimingWheel::empty() const
+{
+	return _size == 0;
+}
+
+
+inline Clock::ClockDiff TimingWheel::resolution() const
+{
+	return _resolution;
+}
+
+
+inline Clock TimingWheel::now() const
+{
+	return Clock(_origin + static_cast<Clock::ClockVal>(_currentTick)*_resolution);
+}
+
+
+} // namespace Poco
+
+
+#endif // Foundation_TimingWheel_INCLUDED
@@ -0,0 +1,355 @@
+//
+// TinyLFUStrategy.h
+//
+// Library: Foundation
+// Package: Cache
+// Module:  TinyLFUStrategy
+//
+// Definition of the TinyLFUStrategy class.
+//
+// Copyright (c) 2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Foundation_TinyLFUStrategy_INCLUDED
+#define Foundation_TinyLFUStrategy_INCLUDED
+
+
+#include "Poco/KeyValueArgs.h"
+#include "Poco/ValidArgs.h"
+#include "Poco/AbstractStrategy.h"
+#include "Poco/EventArgs.h"
+#include "Poco/Exception.h"
+#include <functional>
+#include <algorithm>
+#include <vector>
+#include <list>
+#include <map>
+#include <set>
+#include <cstddef>
+
+
+namespace Poco {
+
+
+template <class TKey, class THash = std::hash<TKey> >
+class FrequencySketch
+	/// A count-min sketch estimating the access frequency of keys,
+	/// as used by TinyLFUStrategy.
+	///
+	/// The sketch uses four rows of 4-bit saturating counters,
+	/// each row having (at least) four counters per cache entry.
+	/// To keep the estimates fresh, all counters are halved
+	/// (aged) once the number of recorded accesses reaches
+	/// ten times the size of the cache.
+{
+public:
+	FrequencySketch(std::size_t size):
+		_sampleSize(10*size),
+		_additions(0),
+		_mask(0)
+	{
+		std::size_t width = 64;
+		while (width < 4*size) width *= 2;
+		_table.resize(width*DEPTH/COUNTERS_PER_WORD + 1);
+		_mask = width - 1;
+	}
+
+	void increment(const TKey& key)
+		/// Records an access to the given key.
+	{
+		std::size_t h1;
+		std::size_t h2;
+		hashes(key, h1, h2);
+		bool added = false;
+		for (unsigned i = 0; i < DEPTH; ++i)
+		{
+			added |= incrementAt(i, (h1 + i*h2) & _mask);
+		}
+		if (added && ++_additions >= _sampleSize)
+		{
+			age();
+		}
+	}
+
+	unsigned frequency(const TKey& key) const
+		/// Returns the estimated access frequency (0 - 15) of the given key.
+	{
+		std::size_t h1;
+		std::size_t h2;
+		hashes(key, h1, h2);
+		unsigned freq = 15;
+		for (unsigned i = 0; i < DEPTH; ++i)
+		{
+			unsigned c = counterAt(i, (h1 + i*h2) & _mask);
+			if (c < freq) freq = c;
+		}
+		return freq;
+	}
+
+	void clear()
+		/// Resets all counters.
+	{
+		std::fill(_table.begin(), _table.end(), 0);
+		_additions = 0;
+	}
+
+private:
+	enum
+	{
+		DEPTH = 4,
+		COUNTERS_PER_WORD = 16
+	};
+
+	void hashes(const TKey& key, std::size_t& h1, std::size_t& h2) const
+	{
+		UInt64 h = static_cast<UInt64>(_hash(key));
+		h *= 0x9E3779B97F4A7C15ULL;
+		h1 = static_cast<std::size_t>(h >> 32);
+		h2 = static_cast<std::size_t>(h) | 1;
+	}
+
+	bool incrementAt(unsigned row, std::size_t col)
+	{
+		std::size_t pos = row*(_mask + 1) + col;
+		UInt64& word = _table[pos/COUNTERS_PER_WORD];
+		unsigned shift = static_cast<unsigned>(pos % COUNTERS_PER_WORD)*4;
+		if (((word >> shift) & 0xF) == 0xF) return false;
+		word += UInt64(1) << shift;
+		return true;
+	}
+
+	unsigned counterAt(unsigned row, std::size_t col) const
+	{
+		std::size_t pos = row*(_mask + 1) + col;
+		unsigned shift = static_cast<unsigned>(pos % COUNTERS_PER_WORD)*4;
+		return static_cast<unsigned>((_table[pos/COUNTERS_PER_WORD] >> shift) & 0xF);
+	}
+
+	void age()
+	{
+		for (std::vector<UInt64>::iterator it = _table.begin(); it != _table.end(); ++it)
+		{
+			*it = (*it >> 1) & 0x7777777777777777ULL;
+		}
+		_additions /= 2;
+	}
+
+	std::vector<UInt64> _table;
+	std::size_t         _sampleSize;
+	std::size_t         _additions;
+	std::size_t         _mask;
+	THash               _hash;
+};
+
+
+template <class TKey, class TValue, class THash = std::hash<TKey> >
+class TinyLFUStrategy: public AbstractStrategy<TKey, TValue>
+	/// A TinyLFUStrategy implements the W-TinyLFU cache replacement
+	/// and admission policy, which combines recency and frequency.
+	///
+	/// New entries are added to a small LRU admission window (1% of
+	/// the cache size). Entries leaving the window compete for a place
+	/// in the main area with the main area's least recently used entry;
+	/// the entry with the lower estimated access frequency (tracked in a
+	/// FrequencySketch, which also remembers recently evicted keys) is
+	/// removed from the cache.
+	///
+	/// The main area is a segmented LRU: entries accessed again while
+	/// in the probation segment are promoted to the protected segment
+	/// (80% of the main area).
+	///
+	/// Unlike LRUStrategy, a scan over many keys that are used only once
+	/// cannot flush frequently used entries out of the cache.
+{
+public:
+	typedef std::list<TKey>               Keys;
+	typedef typename Keys::iterator       Iterator;
+
+	enum Segment
+	{
+		SEG_WINDOW,
+		SEG_PROBATION,
+		SEG_PROTECTED
+	};
+
+	struct Position
+	{
+		Segment  segment;
+		Iterator it;
+	};
+
+	typedef std::map<TKey, Position>          KeyIndex;
+	typedef typename KeyIndex::iterator       IndexIterator;
+
+	TinyLFUStrategy(std::size_t size):
+		_size(size),
+		_windowSize(size/100 > 0 ? size/100 : 1),
+		_protectedSize((size - _windowSize)*8/10),
+		_sketch(size)
+	{
+		if (_size < 1) throw InvalidArgumentException("size must be > 0");
+	}
+
+	~TinyLFUStrategy()
+	{
+	}
+
+	void onAdd(const void*, const KeyValueArgs <TKey, TValue>& args)
+	{
+		_sketch.increment(args.key());
+
+		IndexIterator it = _keyIndex.find(args.key());
+		if (it != _keyIndex.end()) unlink(it);
+
+		_window.push_front(args.key());
+		Position pos = { SEG_WINDOW, _window.begin() };
+		_keyIndex[args.key()] = pos;
+
+		while (_window.size() > _windowSize)
+		{
+			admit(_window.back());
+		}
+	}
+
+	void onRemove(const void*, const TKey& key)
+	{
+		IndexIterator it = _keyIndex.find(key);
+		if (it != _keyIndex.end())
+		{
+			unlink(it);
+			_keyIndex.erase(it);
+		}
+	}
+
+	void onGet(const void*, const TKey& key)
+	{
+		_sketch.increment(key);
+
+		IndexIterator it = _keyIndex.find(key);
+		if (it == _keyIndex.end()) return;
+
+		Position& pos = it->second;
+		switch (pos.segment)
+		{
+		case SEG_WINDOW:
+			_window.splice(_window.begin(), _window, pos.it);
+			break;
+		case SEG_PROTECTED:
+			_protected.splice(_protected.begin(), _protected, pos.it);
+			break;
+		case SEG_PROBATION:
+			_protected.splice(_protected.begin(), _probation, pos.it);
+			pos.segment = SEG_PROTECTED;
+			if (_protected.size() > _protectedSize)
+			{
+				// demote the least recently used protected entry
+				IndexIterator itDemoted = _keyIndex.find(_protected.back());
+				_probation.splice(_probation.begin(), _protected, itDemoted->second.it);
+				itDemoted->second.segment = SEG_PROBATION;
+			}
+			break;
+		}
+	}
+
+	void onClear(const void*, const EventArgs&)
+	{
+		_window.clear();
+		_probation.clear();
+		_protected.clear();
+		_keyIndex.clear();
+		_evicted.clear();
+	}
+
+	void onIsValid(const void*, ValidArgs<TKey>& args)
+	{
+		if (_keyIndex.find(args.key()) == _keyIndex.end())
+		{
+			args.invalidate();
+		}
+	}
+
+	void onReplace(const void*, std::set<TKey>& elemsToRemove)
+	{
+		// Note: replace only informs the cache which elements
+		// it would like to remove!
+		// it does not remove them on its own!
+		elemsToRemove.insert(_evicted.begin(), _evicted.end());
+		_evicted.clear();
+	}
+
+	unsigned frequency(const TKey& key) const
+		/// Returns the estimated access frequency of the given key.
+	{
+		return _sketch.frequency(key);
+	}
+
+protected:
+	void admit(const TKey& candidate)
+		/// Moves the least recently used entry out of the admission
+		/// window, either into the probation segment or, if it loses
+		/// against the main area's victim, out of the cache.
+	{
+		IndexIterator itCandidate = _keyIndex.find(candidate);
+		if (_probation.size() + _protected.size() < _size - _windowSize)
+		{
+			_probation.splice(_probation.begin(), _window, itCandidate->second.it);
+			itCandidate->second.segment = SEG_PROBATION;
+			return;
+		}
+
+		Keys& victims = _probation.empty() ? _protected : _probation;
+		if (victims.empty() || _sketch.frequency(candidate) <= _sketch.frequency(victims.back()))
+		{
+			evict(itCandidate);
+		}
+		else
+		{
+			evict(_keyIndex.find(victims.back()));
+			_probation.splice(_probation.begin(), _window, itCandidate->second.it);
+			itCandidate->second.segment = SEG_PROBATION;
+		}
+	}
+
+	void evict(IndexIterator it)
+	{
+		_evicted.insert(it->first);
+		unlink(it);
+		_keyIndex.erase(it);
+	}
+
+	void unlink(IndexIterator it)
+	{
+		switch (it->second.segment)
+		{
+		case SEG_WINDOW:
+			_window.erase(it->second.it);
+			break;
+		case SEG_PROBATION:
+			_probation.erase(it->second.it);
+			break;
+		case SEG_PROTECTED:
+			_protected.erase(it->second.it);
+			break;
+		}
+	}
+
+	std::size_t                  _size;          /// Number of keys the cache can store.
+	std::size_t                  _windowSize;    /// Size of the admission window.
+	std::size_t                  _protectedSize; /// Size of the protected segment.
+	Keys                         _window;
+	Keys                         _probation;
+	Keys                         _protected;
+	KeyIndex                     _keyIndex;
+	std::set<TKey>               _evicted;
+	FrequencySketch<TKey, THash> _sketch;
+};
+
+
+} // namespace Poco
+
+
+#endif // Foundation_TinyLFUStrategy_INCLUDED
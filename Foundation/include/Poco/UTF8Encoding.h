@@ -49,6 +49,20 @@ public:
 		/// Adapted from ftp://ftp.unicode.org/Public/PROGRAMS/CVTUTF/ConvertUTF.c
 		/// Copyright 2001-2004 Unicode, Inc.
 
+	static bool isValid(const char* bytes, std::size_t length);
+		/// Returns true if the given bytes are a sequence of complete
+		/// and legal UTF-8 characters, as accepted by isLegal().
+		///
+		/// On CPUs supporting SSE 4.2, 16 bytes are validated at once,
+		/// using the lookup algorithm described in "Validating UTF-8 In
+		/// Less Than One Instruction Per Byte" by John Keiser and Daniel
+		/// Lemire. Otherwise, runs of ASCII characters are skipped
+		/// eight bytes at a time.
+
+	static std::size_t countASCII(const char* bytes, std::size_t length);
+		/// Returns the number of leading 7-bit ASCII characters
+		/// in the given bytes.
+
 private:
 	static const char* _names[];
 	static const CharacterMap _charMap;
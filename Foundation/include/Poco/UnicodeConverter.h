@@ -35,6 +35,11 @@ class Foundation_API UnicodeConverter
 	///
 	/// This class is mainly used for working with the Unicode Windows APIs
 	/// and probably won't be of much use anywhere else ???
+	///
+	/// Valid input (as checked with UTF8Encoding::isValid() for UTF-8)
+	/// is converted directly, without going through TextEncoding objects.
+	/// Invalid input is converted character by character, with the same
+	/// results as in earlier releases.
 {
 public:
 	static void convert(const std::string& utf8String, UTF32String& utf32String);
@@ -17,12 +17,14 @@
 #include "Poco/File.h"
 #include "Poco/Path.h"
 #include "Poco/DeflatingStream.h"
+#include "Poco/LZ4Stream.h"
 #include "Poco/StreamCopier.h"
 #include "Poco/Exception.h"
 #include "Poco/ActiveDispatcher.h"
 #include "Poco/ActiveMethod.h"
 #include "Poco/Void.h"
 #include "Poco/FileStream.h"
+#include <utility>
 
 
 namespace Poco {
@@ -36,6 +38,8 @@ namespace Poco {
 class ArchiveCompressor: public ActiveDispatcher
 {
 public:
+	typedef std::pair<std::string, ArchiveStrategy::CompressionMethod> Args;
+
 	ArchiveCompressor():
 		compress(this, &ArchiveCompressor::compressImpl)
 	{
@@ -45,29 +49,45 @@ public:
 	{
 	}
 	
-	ActiveMethod<void, std::string, ArchiveCompressor, ActiveStarter<ActiveDispatcher> > compress;
+	ActiveMethod<void, Args, ArchiveCompressor, ActiveStarter<ActiveDispatcher> > compress;
+
+	static const char* extension(ArchiveStrategy::CompressionMethod method)
+	{
+		return method == ArchiveStrategy::COMPRESS_LZ4 ? ".lz4" : ".gz";
+	}
 
 protected:
-	void compressImpl(const std::string& path)
+	void compressImpl(const Args& args)
 	{
-		std::string gzPath(path);
-		gzPath.append(".gz");
+		const std::string& path = args.first;
+		std::string compressedPath(path);
+		compressedPath.append(extension(args.second));
 		FileInputStream istr(path);
-		FileOutputStream ostr(gzPath);
+		FileOutputStream ostr(compressedPath);
 		try
 		{
-			DeflatingOutputStream deflater(ostr, DeflatingStreamBuf::STREAM_GZIP);
-			StreamCopier::copyStream(istr, deflater);
-			if (!deflater.good() || !ostr.good()) throw WriteFileException(gzPath);
-			deflater.close();
+			if (args.second == ArchiveStrategy::COMPRESS_LZ4)
+			{
+				LZ4OutputStream compressor(ostr);
+				StreamCopier::copyStream(istr, compressor);
+				if (!compressor.good() || !ostr.good()) throw WriteFileException(compressedPath);
+				compressor.close();
+			}
+			else
+			{
+				DeflatingOutputStream deflater(ostr, DeflatingStreamBuf::STREAM_GZIP);
+				StreamCopier::copyStream(istr, deflater);
+				if (!deflater.good() || !ostr.good()) throw WriteFileException(compressedPath);
+				deflater.close();
+			}
 			ostr.close();
 			istr.close();
 		}
 		catch (Poco::Exception&)
 		{
-			// deflating failed - remove gz file and leave uncompressed log file
+			// compressing failed - remove compressed file and leave uncompressed log file
 			ostr.close();
-			Poco::File gzf(gzPath);
+			Poco::File gzf(compressedPath);
 			gzf.remove();
 			return;
 		}
@@ -85,6 +105,7 @@ protected:
 
 ArchiveStrategy::ArchiveStrategy():
 	_compress(false),
+	_compressionMethod(COMPRESS_GZIP),
 	_pCompressor(0)
 {
 }
@@ -102,19 +123,38 @@ void ArchiveStrategy::compress(bool flag)
 }
 
 
+void ArchiveStrategy::setCompressionMethod(CompressionMethod method)
+{
+	_compressionMethod = method;
+}
+
+
+ArchiveStrategy::CompressionMethod ArchiveStrategy::getCompressionMethod() const
+{
+	return _compressionMethod;
+}
+
+
 void ArchiveStrategy::moveFile(const std::string& oldPath, const std::string& newPath)
 {
 	bool compressed = false;
+	std::string ext(ArchiveCompressor::extension(_compressionMethod));
 	Path p(oldPath);
 	File f(oldPath);
 	if (!f.exists())
 	{
-		f = oldPath + ".gz";
+		// the file may have been compressed using another method
+		if (!File(oldPath + ext).exists())
+		{
+			std::string otherExt(ArchiveCompressor::extension(_compressionMethod == COMPRESS_LZ4 ? COMPRESS_GZIP : COMPRESS_LZ4));
+			if (File(oldPath + otherExt).exists()) ext = otherExt;
+		}
+		f = oldPath + ext;
 		compressed = true;
 	}
 	std::string mvPath(newPath);
 	if (_compress || compressed)
-		mvPath.append(".gz");
+		mvPath.append(ext);
 	if (!_compress || compressed)
 	{
 		f.renameTo(mvPath);
@@ -123,7 +163,7 @@ void ArchiveStrategy::moveFile(const std::string& oldPath, const std::string& ne
 	{
 		f.renameTo(newPath);
 		if (!_pCompressor) _pCompressor = new ArchiveCompressor;
-		_pCompressor->compress(newPath);
+		_pCompressor->compress(ArchiveCompressor::Args(newPath, _compressionMethod));
 	}
 }
 
@@ -137,10 +177,9 @@ bool ArchiveStrategy::exists(const std::string& name)
 	}
 	else if (_compress)
 	{
-		std::string gzName(name);
-		gzName.append(".gz");
-		File gzf(gzName);
-		return gzf.exists();
+		File gzf(name + ArchiveCompressor::extension(COMPRESS_GZIP));
+		File lz4f(name + ArchiveCompressor::extension(COMPRESS_LZ4));
+		return gzf.exists() || lz4f.exists();
 	}
 	else return false;
 }
@@ -0,0 +1,174 @@
+//
+// Arena.cpp
+//
+// Library: Foundation
+// Package: Core
+// Module:  Arena
+//
+// Copyright (c) 2005-2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Arena.h"
+#include "Poco/Bugcheck.h"
+#include <cstring>
+
+
+namespace Poco {
+
+
+Arena::Arena(std::size_t chunkSize):
+	_chunkSize(chunkSize < 64 ? 64 : chunkSize),
+	_pChunks(0),
+	_pBuffer(0),
+	_bufferSize(0),
+	_pCurrent(0),
+	_pEnd(0),
+	_pLast(0),
+	_allocated(0),
+	_capacity(0),
+	_pFinalizers(0)
+{
+}
+
+
+Arena::Arena(void* pBuffer, std::size_t size, std::size_t chunkSize):
+	_chunkSize(chunkSize < 64 ? 64 : chunkSize),
+	_pChunks(0),
+	_pBuffer(static_cast<char*>(pBuffer)),
+	_bufferSize(size),
+	_pCurrent(static_cast<char*>(pBuffer)),
+	_pEnd(static_cast<char*>(pBuffer) + size),
+	_pLast(0),
+	_allocated(0),
+	_capacity(0),
+	_pFinalizers(0)
+{
+	poco_check_ptr (pBuffer);
+}
+
+
+Arena::~Arena()
+{
+	release();
+}
+
+
+void* Arena::allocateSlow(std::size_t size, std::size_t alignment)
+{
+	poco_assert ((alignment & (alignment - 1)) == 0);
+
+	std::size_t header = sizeof(Chunk) + (alignof(std::max_align_t) - sizeof(Chunk) % alignof(std::max_align_t)) % alignof(std::max_align_t);
+	std::size_t needed = size + alignment;
+	bool dedicated = needed > _chunkSize - header;
+	std::size_t chunkSize = dedicated ? header + needed : _chunkSize;
+
+	Chunk* pChunk = reinterpret_cast<Chunk*>(new char[chunkSize]);
+	pChunk->size  = chunkSize;
+	_capacity += chunkSize;
+
+	char* pData = reinterpret_cast<char*>(pChunk) + header;
+	char* pBlock = pData + ((alignment - (reinterpret_cast<std::size_t>(pData) & (alignment - 1))) & (alignment - 1));
+	_allocated += size + (pBlock - pData);
+
+	if (dedicated && _pChunks && _pCurrent != _pEnd)
+	{
+		// keep allocating from the current chunk, which still has room
+		pChunk->pNext = _pChunks->pNext;
+		_pChunks->pNext = pChunk;
+		return pBlock;
+	}
+
+	pChunk->pNext = _pChunks;
+	_pChunks = pChunk;
+	_pLast    = pBlock;
+	_pCurrent = pBlock + size;
+	_pEnd     = reinterpret_cast<char*>(pChunk) + chunkSize;
+	if (!dedicated && _chunkSize < MAX_CHUNK_SIZE)
+	{
+		_chunkSize *= 2;
+	}
+	return pBlock;
+}
+
+
+char* Arena::copy(const char* str, std::size_t length)
+{
+	char* pCopy = static_cast<char*>(allocate(length + 1, 1));
+	std::memcpy(pCopy, str, length);
+	pCopy[length] = 0;
+	return pCopy;
+}
+
+
+void Arena::finalize()
+{
+	while (_pFinalizers)
+	{
+		Finalizer* pFinalizer = _pFinalizers;
+		_pFinalizers = pFinalizer->pNext;
+		pFinalizer->destroy(pFinalizer->pObj);
+	}
+}
+
+
+void Arena::freeChunks(Chunk* pKeep)
+{
+	Chunk* pChunk = _pChunks;
+	while (pChunk)
+	{
+		Chunk* pNext = pChunk->pNext;
+		if (pChunk != pKeep)
+		{
+			_capacity -= pChunk->size;
+			delete [] reinterpret_cast<char*>(pChunk);
+		}
+		pChunk = pNext;
+	}
+	_pChunks = pKeep;
+	if (pKeep) pKeep->pNext = 0;
+}
+
+
+void Arena::reset()
+{
+	finalize();
+
+	Chunk* pLargest = 0;
+	for (Chunk* pChunk = _pChunks; pChunk; pChunk = pChunk->pNext)
+	{
+		if (!pLargest || pChunk->size > pLargest->size) pLargest = pChunk;
+	}
+	freeChunks(pLargest);
+
+	if (pLargest)
+	{
+		_pCurrent = reinterpret_cast<char*>(pLargest) + sizeof(Chunk);
+		_pEnd     = reinterpret_cast<char*>(pLargest) + pLargest->size;
+	}
+	else
+	{
+		_pCurrent = _pBuffer;
+		_pEnd     = _pBuffer + _bufferSize;
+	}
+	_pLast = 0;
+	_allocated = 0;
+}
+
+
+void Arena::release()
+{
+	finalize();
+	freeChunks(0);
+
+	_pCurrent  = _pBuffer;
+	_pEnd      = _pBuffer + _bufferSize;
+	_pLast     = 0;
+	_allocated = 0;
+}
+
+
+} // namespace Poco
@@ -29,6 +29,25 @@ bool Base32DecoderBuf::IN_ENCODING_INIT = false;
 namespace
 {
 	static FastMutex mutex;
+
+	class DecodingTable
+		/// Maps characters to their 5-bit values, or to 0xFF.
+	{
+	public:
+		explicit DecodingTable(const unsigned char* encoding)
+		{
+			for (int i = 0; i < 256; i++) _table[i] = 0xFF;
+			for (int i = 0; i < 32; i++) _table[encoding[i]] = static_cast<unsigned char>(i);
+		}
+
+		unsigned char operator [] (unsigned char c) const
+		{
+			return _table[c];
+		}
+
+	private:
+		unsigned char _table[256];
+	};
 }
 
 
@@ -157,4 +176,61 @@ Base32Decoder::~Base32Decoder()
 }
 
 
+std::size_t Base32Decoder::decode(const char* encoded, std::size_t length, char* data)
+{
+	static const DecodingTable table(Base32EncoderBuf::OUT_ENCODING);
+	// number of bytes for a final group of n characters; 0 if invalid
+	static const int DECODED_BYTES[9] = { 0, 0, 1, 0, 2, 3, 0, 4, 5 };
+
+	const unsigned char* in = reinterpret_cast<const unsigned char*>(encoded);
+	const unsigned char* end = in + length;
+	unsigned char* out = reinterpret_cast<unsigned char*>(data);
+	while (in < end)
+	{
+		std::size_t avail = end - in;
+		std::size_t n = avail < 8 ? avail : 8;
+		UInt64 v = 0;
+		std::size_t chars = 0;
+		while (chars < n)
+		{
+			unsigned char c = table[in[chars]];
+			if (c == 0xFF) break;
+			v = (v << 5) | c;
+			++chars;
+		}
+		if (chars == 8)
+		{
+			out[0] = static_cast<unsigned char>(v >> 32);
+			out[1] = static_cast<unsigned char>(v >> 24);
+			out[2] = static_cast<unsigned char>(v >> 16);
+			out[3] = static_cast<unsigned char>(v >> 8);
+			out[4] = static_cast<unsigned char>(v);
+			out += 5;
+			in  += 8;
+			continue;
+		}
+
+		// final group, either padded to 8 characters or unpadded
+		int bytes = DECODED_BYTES[chars];
+		if (bytes == 0) throw DataFormatException();
+		std::size_t padding = chars;
+		while (padding < n && in[padding] == '=') ++padding;
+		if (padding != n || (padding > chars && padding != 8) || n != avail) throw DataFormatException();
+		v <<= 5*(8 - chars);
+		for (int i = 0; i < bytes; i++)
+		{
+			*out++ = static_cast<unsigned char>(v >> (32 - 8*i));
+		}
+		break;
+	}
+	return out - reinterpret_cast<unsigned char*>(data);
+}
+
+
+std::size_t Base32Decoder::decodedLength(std::size_t length)
+{
+	return 5*((length + 7)/8);
+}
+
+
 } // namespace Poco
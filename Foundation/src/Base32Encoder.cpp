@@ -27,6 +27,33 @@ const unsigned char Base32EncoderBuf::OUT_ENCODING[32] =
 };
 
 
+namespace
+{
+	const std::size_t ENCODED_CHARS[5] = { 0, 2, 4, 5, 7 };
+		/// Number of characters for an incomplete group of n bytes.
+
+	inline char* encodeGroups(const unsigned char* in, std::size_t groups, const unsigned char* encoding, char* out)
+		/// Encodes groups complete 5-byte groups.
+	{
+		while (groups-- > 0)
+		{
+			UInt64 v = (UInt64(in[0]) << 32) | (UInt64(in[1]) << 24) | (UInt64(in[2]) << 16) | (UInt64(in[3]) << 8) | in[4];
+			out[0] = encoding[(v >> 35) & 0x1F];
+			out[1] = encoding[(v >> 30) & 0x1F];
+			out[2] = encoding[(v >> 25) & 0x1F];
+			out[3] = encoding[(v >> 20) & 0x1F];
+			out[4] = encoding[(v >> 15) & 0x1F];
+			out[5] = encoding[(v >> 10) & 0x1F];
+			out[6] = encoding[(v >> 5) & 0x1F];
+			out[7] = encoding[v & 0x1F];
+			in  += 5;
+			out += 8;
+		}
+		return out;
+	}
+}
+
+
 Base32EncoderBuf::Base32EncoderBuf(std::ostream& ostr, bool padding):
 	_groupLength(0),
 	_buf(*ostr.rdbuf()),
@@ -78,6 +105,37 @@ int Base32EncoderBuf::writeToDevice(char c)
 }
 
 
+std::streamsize Base32EncoderBuf::xsputn(const char* s, std::streamsize n)
+{
+	static const int eof = std::char_traits<char>::eof();
+
+	const char* p = s;
+	const char* end = s + n;
+	while (p < end && _groupLength > 0)
+	{
+		if (writeToDevice(*p) == eof) return p - s;
+		++p;
+	}
+
+	char buffer[4096];
+	while (end - p >= 5)
+	{
+		std::size_t groups = (end - p)/5;
+		if (groups > sizeof(buffer)/8) groups = sizeof(buffer)/8;
+		char* pEnd = encodeGroups(reinterpret_cast<const unsigned char*>(p), groups, OUT_ENCODING, buffer);
+		if (_buf.sputn(buffer, pEnd - buffer) != pEnd - buffer) return p - s;
+		p += 5*groups;
+	}
+
+	while (p < end)
+	{
+		if (writeToDevice(*p) == eof) return p - s;
+		++p;
+	}
+	return n;
+}
+
+
 int Base32EncoderBuf::close()
 {
 	static const int eof = std::char_traits<char>::eof();
@@ -199,4 +257,34 @@ Base32Encoder::~Base32Encoder()
 }
 
 
+std::size_t Base32Encoder::encode(const char* data, std::size_t length, char* encoded, bool padding)
+{
+	const unsigned char* in = reinterpret_cast<const unsigned char*>(data);
+	char* out = encodeGroups(in, length/5, Base32EncoderBuf::OUT_ENCODING, encoded);
+	std::size_t rem = length % 5;
+	if (rem > 0)
+	{
+		unsigned char group[5] = { 0, 0, 0, 0, 0 };
+		for (std::size_t i = 0; i < rem; i++) group[i] = in[5*(length/5) + i];
+		char chars[8];
+		encodeGroups(group, 1, Base32EncoderBuf::OUT_ENCODING, chars);
+		std::size_t n = ENCODED_CHARS[rem];
+		for (std::size_t i = 0; i < n; i++) *out++ = chars[i];
+		if (padding)
+		{
+			for (std::size_t i = n; i < 8; i++) *out++ = '=';
+		}
+	}
+	return out - encoded;
+}
+
+
+std::size_t Base32Encoder::encodedLength(std::size_t length, bool padding)
+{
+	std::size_t rem = length % 5;
+	if (rem > 0) rem = padding ? 8 : ENCODED_CHARS[rem];
+	return 8*(length/5) + rem;
+}
+
+
 } // namespace Poco
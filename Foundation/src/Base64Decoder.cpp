@@ -16,6 +16,11 @@
 #include "Poco/Base64Encoder.h"
 #include "Poco/Exception.h"
 #include "Poco/Mutex.h"
+#include "Poco/CPUFeatures.h"
+#include <cstring>
+#if defined(POCO_HAVE_X86_INTRINSICS)
+#include <tmmintrin.h>
+#endif
 
 
 namespace Poco {
@@ -30,6 +35,93 @@ bool Base64DecoderBuf::IN_ENCODING_URL_INIT = false;
 namespace
 {
 	static FastMutex mutex;
+
+	enum
+	{
+		DEC_SPACE   = 0xFD,
+		DEC_PADDING = 0xFE,
+		DEC_INVALID = 0xFF
+	};
+
+	class DecodingTable
+		/// Maps characters to their 6-bit values, or to
+		/// one of DEC_SPACE, DEC_PADDING or DEC_INVALID.
+	{
+	public:
+		explicit DecodingTable(const unsigned char* encoding)
+		{
+			for (int i = 0; i < 256; i++) _table[i] = DEC_INVALID;
+			for (int i = 0; i < 64; i++) _table[encoding[i]] = static_cast<unsigned char>(i);
+			_table[static_cast<unsigned char>('=')]  = DEC_PADDING;
+			_table[static_cast<unsigned char>(' ')]  = DEC_SPACE;
+			_table[static_cast<unsigned char>('\t')] = DEC_SPACE;
+			_table[static_cast<unsigned char>('\r')] = DEC_SPACE;
+			_table[static_cast<unsigned char>('\n')] = DEC_SPACE;
+		}
+
+		unsigned char operator [] (unsigned char c) const
+		{
+			return _table[c];
+		}
+
+	private:
+		unsigned char _table[256];
+	};
+
+
+#if defined(POCO_HAVE_X86_INTRINSICS)
+
+
+	POCO_TARGET("sse4.2")
+	inline __m128i inRange(__m128i v, char first, char last)
+	{
+		return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(first - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8(last + 1)));
+	}
+
+
+	POCO_TARGET("sse4.2")
+	std::size_t decodeBlocksSSE(const unsigned char* in, std::size_t length, const unsigned char* encoding, unsigned char* out)
+		/// Decodes blocks of 16 characters into 12 bytes each, up to the
+		/// first block containing anything but characters of the encoding.
+		/// Returns the number of characters decoded.
+	{
+		const __m128i char62 = _mm_set1_epi8(char(encoding[62]));
+		const __m128i char63 = _mm_set1_epi8(char(encoding[63]));
+		const __m128i pack = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+		std::size_t done = 0;
+		while (length - done >= 16)
+		{
+			__m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + done));
+			__m128i upper = inRange(c, 'A', 'Z');
+			__m128i lower = inRange(c, 'a', 'z');
+			__m128i digit = inRange(c, '0', '9');
+			__m128i is62  = _mm_cmpeq_epi8(c, char62);
+			__m128i is63  = _mm_cmpeq_epi8(c, char63);
+			__m128i valid = _mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(digit, _mm_or_si128(is62, is63)));
+			if (_mm_movemask_epi8(valid) != 0xFFFF) break;
+
+			__m128i offset = _mm_and_si128(upper, _mm_set1_epi8(-'A'));
+			offset = _mm_or_si128(offset, _mm_and_si128(lower, _mm_set1_epi8(26 - 'a')));
+			offset = _mm_or_si128(offset, _mm_and_si128(digit, _mm_set1_epi8(52 - '0')));
+			offset = _mm_or_si128(offset, _mm_and_si128(is62, _mm_set1_epi8(char(62 - encoding[62]))));
+			offset = _mm_or_si128(offset, _mm_and_si128(is63, _mm_set1_epi8(char(63 - encoding[63]))));
+			__m128i v = _mm_add_epi8(c, offset);
+
+			// merge four 6-bit values into 24 bits, then drop the top bytes
+			v = _mm_maddubs_epi16(v, _mm_set1_epi32(0x01400140));
+			v = _mm_madd_epi16(v, _mm_set1_epi32(0x00011000));
+			v = _mm_shuffle_epi8(v, pack);
+			_mm_storel_epi64(reinterpret_cast<__m128i*>(out), v);
+			UInt32 last = static_cast<UInt32>(_mm_cvtsi128_si32(_mm_srli_si128(v, 8)));
+			std::memcpy(out + 8, &last, 4);
+			out  += 12;
+			done += 16;
+		}
+		return done;
+	}
+
+
+#endif // POCO_HAVE_X86_INTRINSICS
 }
 
 
@@ -175,4 +267,100 @@ Base64Decoder::~Base64Decoder()
 }
 
 
+std::size_t Base64Decoder::decode(const char* encoded, std::size_t length, char* data, int options)
+{
+	static const DecodingTable table(Base64EncoderBuf::OUT_ENCODING);
+	static const DecodingTable tableURL(Base64EncoderBuf::OUT_ENCODING_URL);
+
+	const DecodingTable& t = (options & BASE64_URL_ENCODING) ? tableURL : table;
+#if defined(POCO_HAVE_X86_INTRINSICS)
+	const unsigned char* encoding = (options & BASE64_URL_ENCODING) ? Base64EncoderBuf::OUT_ENCODING_URL : Base64EncoderBuf::OUT_ENCODING;
+	const bool useSSE = CPUFeatures::hasSSE42();
+#endif
+	const bool skipSpace = !(options & BASE64_URL_ENCODING);
+	const unsigned char* in = reinterpret_cast<const unsigned char*>(encoded);
+	const unsigned char* end = in + length;
+	unsigned char* out = reinterpret_cast<unsigned char*>(data);
+
+	unsigned char group[4];
+	int n = 0;
+	bool padded = false;
+	while (in < end)
+	{
+		if (n == 0 && !padded)
+		{
+#if defined(POCO_HAVE_X86_INTRINSICS)
+			if (useSSE && end - in >= 16)
+			{
+				std::size_t done = decodeBlocksSSE(in, end - in, encoding, out);
+				in  += done;
+				out += 3*(done/4);
+			}
+#endif
+			// fast path for groups of four regular characters
+			while (end - in >= 4)
+			{
+				UInt32 a = t[in[0]];
+				UInt32 b = t[in[1]];
+				UInt32 c = t[in[2]];
+				UInt32 d = t[in[3]];
+				if ((a | b | c | d) >= 64) break;
+				UInt32 v = (a << 18) | (b << 12) | (c << 6) | d;
+				out[0] = static_cast<unsigned char>(v >> 16);
+				out[1] = static_cast<unsigned char>(v >> 8);
+				out[2] = static_cast<unsigned char>(v);
+				out += 3;
+				in  += 4;
+			}
+			if (in == end) break;
+		}
+
+		unsigned char v = t[*in++];
+		if (v == DEC_SPACE && skipSpace) continue;
+		if (padded || v == DEC_INVALID || v == DEC_SPACE) throw DataFormatException();
+		if (v == DEC_PADDING)
+		{
+			if (n < 2) throw DataFormatException();
+		}
+		else if (n == 3 && group[2] == DEC_PADDING)
+		{
+			throw DataFormatException();
+		}
+		group[n++] = v;
+		if (n == 4)
+		{
+			int bytes = group[2] == DEC_PADDING ? 1 : (group[3] == DEC_PADDING ? 2 : 3);
+			if (bytes < 3)
+			{
+				padded = true;
+				if (group[3] == DEC_PADDING) group[3] = 0;
+				if (group[2] == DEC_PADDING) group[2] = 0;
+			}
+			out[0] = static_cast<unsigned char>((group[0] << 2) | (group[1] >> 4));
+			if (bytes > 1) out[1] = static_cast<unsigned char>(((group[1] & 0x0F) << 4) | (group[2] >> 2));
+			if (bytes > 2) out[2] = static_cast<unsigned char>((group[2] << 6) | group[3]);
+			out += bytes;
+			n = 0;
+		}
+	}
+	if (n > 0)
+	{
+		// incomplete final group
+		if (!(options & BASE64_NO_PADDING) || n < 2) throw DataFormatException();
+		if (group[n - 1] == DEC_PADDING) --n;
+		if (n < 2) throw DataFormatException();
+		if (n < 3) group[2] = 0;
+		*out++ = static_cast<unsigned char>((group[0] << 2) | (group[1] >> 4));
+		if (n > 2) *out++ = static_cast<unsigned char>(((group[1] & 0x0F) << 4) | (group[2] >> 2));
+	}
+	return out - reinterpret_cast<unsigned char*>(data);
+}
+
+
+std::size_t Base64Decoder::decodedLength(std::size_t length)
+{
+	return 3*((length + 3)/4);
+}
+
+
 } // namespace Poco
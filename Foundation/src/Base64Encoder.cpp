@@ -13,6 +13,10 @@
 
 
 #include "Poco/Base64Encoder.h"
+#include "Poco/CPUFeatures.h"
+#if defined(POCO_HAVE_X86_INTRINSICS)
+#include <tmmintrin.h>
+#endif
 
 
 namespace Poco {
@@ -44,6 +48,74 @@ const unsigned char Base64EncoderBuf::OUT_ENCODING_URL[64] =
 };
 
 
+namespace
+{
+#if defined(POCO_HAVE_X86_INTRINSICS)
+
+
+	POCO_TARGET("sse4.2")
+	std::size_t encodeBlocksSSE(const unsigned char* in, std::size_t groups, const unsigned char* encoding, char* out)
+		/// Encodes blocks of four 3-byte groups, as long as 16 bytes
+		/// can be loaded from in. Returns the number of groups encoded.
+	{
+		// offsets from the 6-bit values to the characters, selected by
+		// the range a value falls into (see below)
+		const __m128i offsets = _mm_setr_epi8(
+			'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+			'0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+			char(encoding[62] - 62), char(encoding[63] - 63), 'A', 0, 0);
+		const __m128i spread = _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+		std::size_t done = 0;
+		while (groups - done >= 6)
+		{
+			__m128i v = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in)), spread);
+			__m128i hi = _mm_mulhi_epu16(_mm_and_si128(v, _mm_set1_epi32(0x0FC0FC00)), _mm_set1_epi32(0x04000040));
+			__m128i lo = _mm_mullo_epi16(_mm_and_si128(v, _mm_set1_epi32(0x003F03F0)), _mm_set1_epi32(0x01000010));
+			__m128i idx = _mm_or_si128(hi, lo);
+
+			// 0..25 -> 13, 26..51 -> 0, 52..61 -> 1..10, 62 -> 11, 63 -> 12
+			__m128i range = _mm_subs_epu8(idx, _mm_set1_epi8(51));
+			range = _mm_or_si128(range, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), idx), _mm_set1_epi8(13)));
+			__m128i chars = _mm_add_epi8(idx, _mm_shuffle_epi8(offsets, range));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out), chars);
+			in   += 12;
+			out  += 16;
+			done += 4;
+		}
+		return done;
+	}
+
+
+#endif // POCO_HAVE_X86_INTRINSICS
+
+
+	inline char* encodeGroups(const unsigned char* in, std::size_t groups, const unsigned char* encoding, char* out)
+		/// Encodes groups complete 3-byte groups.
+	{
+#if defined(POCO_HAVE_X86_INTRINSICS)
+		if (groups >= 6 && CPUFeatures::hasSSE42())
+		{
+			std::size_t done = encodeBlocksSSE(in, groups, encoding, out);
+			in     += 3*done;
+			out    += 4*done;
+			groups -= done;
+		}
+#endif
+		while (groups-- > 0)
+		{
+			UInt32 v = (UInt32(in[0]) << 16) | (UInt32(in[1]) << 8) | in[2];
+			out[0] = encoding[v >> 18];
+			out[1] = encoding[(v >> 12) & 0x3F];
+			out[2] = encoding[(v >> 6) & 0x3F];
+			out[3] = encoding[v & 0x3F];
+			in  += 3;
+			out += 4;
+		}
+		return out;
+	}
+}
+
+
 Base64EncoderBuf::Base64EncoderBuf(std::ostream& ostr, int options):
 	_options(options),
 	_groupLength(0),
@@ -108,6 +180,55 @@ int Base64EncoderBuf::writeToDevice(char c)
 }
 
 
+std::streamsize Base64EncoderBuf::xsputn(const char* s, std::streamsize n)
+{
+	static const int eof = std::char_traits<char>::eof();
+
+	const char* p = s;
+	const char* end = s + n;
+	while (p < end && _groupLength > 0)
+	{
+		if (writeToDevice(*p) == eof) return p - s;
+		++p;
+	}
+
+	char buffer[4096 + 2];
+	while (end - p >= 3)
+	{
+		std::size_t groups = (end - p)/3;
+		if (groups > 4096/4) groups = 4096/4;
+		bool lineBreak = false;
+		if (_lineLength > 0)
+		{
+			int groupsLeft = (_lineLength - _pos + 3)/4;
+			if (groupsLeft < 1) groupsLeft = 1;
+			if (groups >= static_cast<std::size_t>(groupsLeft))
+			{
+				groups = groupsLeft;
+				lineBreak = true;
+			}
+		}
+		char* pEnd = encodeGroups(reinterpret_cast<const unsigned char*>(p), groups, _pOutEncoding, buffer);
+		if (lineBreak)
+		{
+			*pEnd++ = '\r';
+			*pEnd++ = '\n';
+			_pos = 0;
+		}
+		else _pos += static_cast<int>(4*groups);
+		if (_buf.sputn(buffer, pEnd - buffer) != pEnd - buffer) return p - s;
+		p += 3*groups;
+	}
+
+	while (p < end)
+	{
+		if (writeToDevice(*p) == eof) return p - s;
+		++p;
+	}
+	return n;
+}
+
+
 int Base64EncoderBuf::close()
 {
 	static const int eof = std::char_traits<char>::eof();
@@ -180,4 +301,43 @@ Base64Encoder::~Base64Encoder()
 }
 
 
+std::size_t Base64Encoder::encode(const char* data, std::size_t length, char* encoded, int options)
+{
+	const unsigned char* encoding = (options & BASE64_URL_ENCODING) ? Base64EncoderBuf::OUT_ENCODING_URL : Base64EncoderBuf::OUT_ENCODING;
+	const unsigned char* in = reinterpret_cast<const unsigned char*>(data);
+	char* out = encodeGroups(in, length/3, encoding, encoded);
+	in += 3*(length/3);
+	switch (length % 3)
+	{
+	case 1:
+		*out++ = encoding[in[0] >> 2];
+		*out++ = encoding[(in[0] & 0x03) << 4];
+		if (!(options & BASE64_NO_PADDING))
+		{
+			*out++ = '=';
+			*out++ = '=';
+		}
+		break;
+	case 2:
+		*out++ = encoding[in[0] >> 2];
+		*out++ = encoding[((in[0] & 0x03) << 4) | (in[1] >> 4)];
+		*out++ = encoding[(in[1] & 0x0F) << 2];
+		if (!(options & BASE64_NO_PADDING))
+		{
+			*out++ = '=';
+		}
+		break;
+	}
+	return out - encoded;
+}
+
+
+std::size_t Base64Encoder::encodedLength(std::size_t length, int options)
+{
+	std::size_t rem = length % 3;
+	if (rem > 0) rem = (options & BASE64_NO_PADDING) ? rem + 1 : 4;
+	return 4*(length/3) + rem;
+}
+
+
 } // namespace Poco
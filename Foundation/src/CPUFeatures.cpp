@@ -0,0 +1,127 @@
+//
+// CPUFeatures.cpp
+//
+// Library: Foundation
+// Package: Core
+// Module:  CPUFeatures
+//
+// Copyright (c) 2004-2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/CPUFeatures.h"
+#if defined(POCO_HAVE_X86_INTRINSICS)
+	#if defined(_MSC_VER) && !defined(__clang__)
+		#include <intrin.h>
+	#else
+		#include <cpuid.h>
+	#endif
+#endif
+
+
+namespace Poco {
+
+
+namespace
+{
+	class Features
+	{
+	public:
+		Features():
+			sse42(false),
+			pclmul(false),
+			avx2(false),
+			sha(false)
+		{
+#if defined(POCO_HAVE_X86_INTRINSICS)
+			unsigned regs[4];
+			cpuid(0, regs);
+			unsigned maxLeaf = regs[0];
+			if (maxLeaf < 1) return;
+
+			cpuid(1, regs);
+			bool ssse3  = (regs[2] & (1u << 9)) != 0;
+			bool sse41  = (regs[2] & (1u << 19)) != 0;
+			bool osxsave = (regs[2] & (1u << 27)) != 0;
+			bool avx    = (regs[2] & (1u << 28)) != 0;
+			sse42  = ssse3 && sse41 && (regs[2] & (1u << 20)) != 0;
+			pclmul = sse41 && (regs[2] & (1u << 1)) != 0;
+
+			if (maxLeaf < 7) return;
+			cpuid(7, regs);
+			sha  = ssse3 && sse41 && (regs[1] & (1u << 29)) != 0;
+			avx2 = avx && osxsave && (regs[1] & (1u << 5)) != 0 && (xgetbv() & 6) == 6;
+#endif
+		}
+
+		bool sse42;
+		bool pclmul;
+		bool avx2;
+		bool sha;
+
+	private:
+#if defined(POCO_HAVE_X86_INTRINSICS)
+		static void cpuid(unsigned leaf, unsigned regs[4])
+		{
+#if defined(_MSC_VER) && !defined(__clang__)
+			int r[4];
+			__cpuidex(r, static_cast<int>(leaf), 0);
+			for (int i = 0; i < 4; i++) regs[i] = static_cast<unsigned>(r[i]);
+#else
+			__cpuid_count(leaf, 0, regs[0], regs[1], regs[2], regs[3]);
+#endif
+		}
+
+		static UInt64 xgetbv()
+			/// Returns the XCR0 register, which tells which register
+			/// sets the operating system saves on context switches.
+		{
+#if defined(_MSC_VER) && !defined(__clang__)
+			return _xgetbv(0);
+#else
+			unsigned eax;
+			unsigned edx;
+			__asm__ __volatile__ ("xgetbv" : "=a" (eax), "=d" (edx) : "c" (0));
+			return (static_cast<UInt64>(edx) << 32) | eax;
+#endif
+		}
+#endif
+	};
+
+
+	const Features& features()
+	{
+		static const Features f;
+		return f;
+	}
+}
+
+
+bool CPUFeatures::hasSSE42()
+{
+	return features().sse42;
+}
+
+
+bool CPUFeatures::hasPCLMUL()
+{
+	return features().pclmul;
+}
+
+
+bool CPUFeatures::hasAVX2()
+{
+	return features().avx2;
+}
+
+
+bool CPUFeatures::hasSHA()
+{
+	return features().sha;
+}
+
+
+} // namespace Poco
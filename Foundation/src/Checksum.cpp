@@ -26,8 +26,8 @@ Checksum::Checksum(): _pImpl(new Checksum32)
 
 
 Checksum::Checksum(Type t) :
-	_pImpl(t == TYPE_CRC64 ?
-		(ChecksumImpl*)new Checksum64() :
+	_pImpl((t == TYPE_CRC64 || t == TYPE_XXH64) ?
+		(ChecksumImpl*)new Checksum64(static_cast<ChecksumImpl::Type>(t)) :
 		(ChecksumImpl*)new Checksum32(static_cast<ChecksumImpl::Type>(t)))
 {
 }
@@ -13,19 +13,276 @@
 
 
 #include "Poco/Checksum32.h"
+#include "Poco/ByteOrder.h"
+#include "Poco/CPUFeatures.h"
 #if defined(POCO_UNBUNDLED)
 #include <zlib.h>
 #else
 #include "Poco/zlib.h"
 #endif
+#include <cstring>
+
+
+#if defined(POCO_HAVE_X86_INTRINSICS)
+	#include <nmmintrin.h>
+	#include <wmmintrin.h>
+	#include <smmintrin.h>
+#endif
 
 
 namespace Poco {
 
 
+namespace
+{
+	class CRC32CTable
+		/// Slicing-by-8 lookup tables for the reflected
+		/// Castagnoli polynomial 0x82F63B78.
+	{
+	public:
+		CRC32CTable()
+		{
+			for (UInt32 i = 0; i < 256; i++)
+			{
+				UInt32 crc = i;
+				for (int j = 0; j < 8; j++)
+				{
+					crc = (crc >> 1) ^ (0x82F63B78 & (0 - (crc & 1)));
+				}
+				table[0][i] = crc;
+			}
+			for (UInt32 i = 0; i < 256; i++)
+			{
+				for (int k = 1; k < 8; k++)
+				{
+					table[k][i] = (table[k - 1][i] >> 8) ^ table[0][table[k - 1][i] & 0xFF];
+				}
+			}
+		}
+
+		UInt32 table[8][256];
+	};
+
+
+	UInt32 crc32cSoftware(UInt32 crc, const unsigned char* p, std::size_t length)
+	{
+		static const CRC32CTable tables;
+		const UInt32 (&t)[8][256] = tables.table;
+
+		crc = ~crc;
+		while (length > 0 && (reinterpret_cast<std::size_t>(p) & 7) != 0)
+		{
+			crc = t[0][(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+			--length;
+		}
+		while (length >= 8)
+		{
+			UInt32 lo;
+			UInt32 hi;
+			std::memcpy(&lo, p, 4);
+			std::memcpy(&hi, p + 4, 4);
+			lo = ByteOrder::toLittleEndian(lo) ^ crc;
+			hi = ByteOrder::toLittleEndian(hi);
+			crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24] ^
+			      t[3][hi & 0xFF] ^ t[2][(hi >> 8) & 0xFF] ^ t[1][(hi >> 16) & 0xFF] ^ t[0][hi >> 24];
+			p += 8;
+			length -= 8;
+		}
+		while (length-- > 0)
+		{
+			crc = t[0][(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+		}
+		return ~crc;
+	}
+
+
+	UInt32 crc32Software(UInt32 crc, const unsigned char* p, std::size_t length)
+	{
+		while (length > 0)
+		{
+			uInt n = length > 0x40000000 ? 0x40000000 : static_cast<uInt>(length);
+			crc = static_cast<UInt32>(::crc32(crc, p, n));
+			p += n;
+			length -= n;
+		}
+		return crc;
+	}
+
+
+#if defined(POCO_HAVE_X86_INTRINSICS)
+
+
+	POCO_TARGET("sse4.2")
+	UInt32 crc32cHardware(UInt32 crc, const unsigned char* p, std::size_t length)
+	{
+		crc = ~crc;
+		while (length > 0 && (reinterpret_cast<std::size_t>(p) & 7) != 0)
+		{
+			crc = _mm_crc32_u8(crc, *p++);
+			--length;
+		}
+#if POCO_ARCH == POCO_ARCH_AMD64
+		UInt64 crc64 = crc;
+		while (length >= 8)
+		{
+			UInt64 v;
+			std::memcpy(&v, p, 8);
+			crc64 = _mm_crc32_u64(crc64, v);
+			p += 8;
+			length -= 8;
+		}
+		crc = static_cast<UInt32>(crc64);
+#endif
+		while (length >= 4)
+		{
+			UInt32 v;
+			std::memcpy(&v, p, 4);
+			crc = _mm_crc32_u32(crc, v);
+			p += 4;
+			length -= 4;
+		}
+		while (length-- > 0)
+		{
+			crc = _mm_crc32_u8(crc, *p++);
+		}
+		return ~crc;
+	}
+
+
+	POCO_TARGET("sse4.1,pclmul")
+	UInt32 crc32Fold(UInt32 crc, const unsigned char* p, std::size_t length)
+		/// Computes the CRC-32 of length bytes (a multiple of 16, at
+		/// least 64) by folding four 128-bit lanes with carry-less
+		/// multiplication, followed by a Barrett reduction.
+		/// See "Fast CRC Computation for Generic Polynomials Using
+		/// PCLMULQDQ Instruction", Intel, 2009.
+	{
+		const __m128i k1k2 = _mm_set_epi64x(0x01c6e41596LL, 0x0154442bd4LL);
+		const __m128i k3k4 = _mm_set_epi64x(0x00ccaa009eLL, 0x01751997d0LL);
+		const __m128i k5k0 = _mm_set_epi64x(0, 0x0163cd6124LL);
+		const __m128i poly = _mm_set_epi64x(0x01f7011641LL, 0x01db710641LL);
+		const __m128i mask = _mm_setr_epi32(~0, 0, ~0, 0);
+
+		__m128i x1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+		__m128i x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16));
+		__m128i x3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 32));
+		__m128i x4 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 48));
+		x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(static_cast<int>(~crc)));
+		p += 64;
+		length -= 64;
+
+		while (length >= 64)
+		{
+			__m128i x5 = _mm_clmulepi64_si128(x1, k1k2, 0x00);
+			__m128i x6 = _mm_clmulepi64_si128(x2, k1k2, 0x00);
+			__m128i x7 = _mm_clmulepi64_si128(x3, k1k2, 0x00);
+			__m128i x8 = _mm_clmulepi64_si128(x4, k1k2, 0x00);
+			x1 = _mm_clmulepi64_si128(x1, k1k2, 0x11);
+			x2 = _mm_clmulepi64_si128(x2, k1k2, 0x11);
+			x3 = _mm_clmulepi64_si128(x3, k1k2, 0x11);
+			x4 = _mm_clmulepi64_si128(x4, k1k2, 0x11);
+			x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+			x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16)));
+			x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 32)));
+			x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 48)));
+			p += 64;
+			length -= 64;
+		}
+
+		// fold the four lanes into one
+		__m128i x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+		x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+		x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+		x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+		x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+		x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+		while (length >= 16)
+		{
+			x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+			x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+			x1 = _mm_xor_si128(_mm_xor_si128(x1, _mm_loadu_si128(reinterpret_cast<const __m128i*>(p))), x5);
+			p += 16;
+			length -= 16;
+		}
+
+		// fold 128 bits to 64 bits
+		x2 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+		x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+		x2 = _mm_srli_si128(x1, 4);
+		x1 = _mm_and_si128(x1, mask);
+		x1 = _mm_clmulepi64_si128(x1, k5k0, 0x00);
+		x1 = _mm_xor_si128(x1, x2);
+
+		// Barrett reduction to 32 bits
+		x2 = _mm_and_si128(x1, mask);
+		x2 = _mm_clmulepi64_si128(x2, poly, 0x10);
+		x2 = _mm_and_si128(x2, mask);
+		x2 = _mm_clmulepi64_si128(x2, poly, 0x00);
+		x1 = _mm_xor_si128(x1, x2);
+
+		return ~static_cast<UInt32>(_mm_extract_epi32(x1, 1));
+	}
+
+
+	UInt32 crc32Hardware(UInt32 crc, const unsigned char* p, std::size_t length)
+	{
+		if (length >= 64)
+		{
+			std::size_t n = length & ~std::size_t(15);
+			crc = crc32Fold(crc, p, n);
+			p += n;
+			length -= n;
+		}
+		return crc32Software(crc, p, length);
+	}
+
+
+#endif // POCO_HAVE_X86_INTRINSICS
+
+
+	typedef UInt32 (*CRCFunc)(UInt32 crc, const unsigned char* p, std::size_t length);
+
+
+	CRCFunc selectCRC32()
+	{
+#if defined(POCO_HAVE_X86_INTRINSICS)
+		if (CPUFeatures::hasPCLMUL()) return &crc32Hardware;
+#endif
+		return &crc32Software;
+	}
+
+
+	CRCFunc selectCRC32C()
+	{
+#if defined(POCO_HAVE_X86_INTRINSICS)
+		if (CPUFeatures::hasSSE42()) return &crc32cHardware;
+#endif
+		return &crc32cSoftware;
+	}
+
+
+	CRCFunc crc32Impl()
+	{
+		static const CRCFunc func = selectCRC32();
+		return func;
+	}
+
+
+	CRCFunc crc32cImpl()
+	{
+		static const CRCFunc func = selectCRC32C();
+		return func;
+	}
+}
+
+
 Checksum32::Checksum32():
 	_type(TYPE_CRC32_IMPL),
-	_value(crc32(0L, Z_NULL, 0))
+	_value(0)
 {
 }
 
@@ -34,9 +291,7 @@ Checksum32::Checksum32(ChecksumImpl::Type t):
 	_type(t),
 	_value(0)
 {
-	if (t == TYPE_CRC32_IMPL)
-		_value = crc32(0L, Z_NULL, 0);
-	else
+	if (t == TYPE_ADLER32_IMPL)
 		_value = adler32(0L, Z_NULL, 0);
 }
 
@@ -48,10 +303,44 @@ Checksum32::~Checksum32()
 
 void Checksum32::update(const char* data, unsigned length)
 {
-	if (_type == TYPE_ADLER32_IMPL)
+	switch (_type)
+	{
+	case TYPE_ADLER32_IMPL:
 		_value = adler32(_value, reinterpret_cast<const Bytef*>(data), length);
-	else
-		_value = crc32(_value, reinterpret_cast<const Bytef*>(data), length);
+		break;
+	case TYPE_CRC32C_IMPL:
+		_value = updateCRC32C(_value, data, length);
+		break;
+	default:
+		_value = updateCRC32(_value, data, length);
+		break;
+	}
+}
+
+
+Poco::UInt32 Checksum32::updateCRC32(Poco::UInt32 crc, const char* data, std::size_t length)
+{
+	return crc32Impl()(crc, reinterpret_cast<const unsigned char*>(data), length);
+}
+
+
+Poco::UInt32 Checksum32::updateCRC32C(Poco::UInt32 crc, const char* data, std::size_t length)
+{
+	return crc32cImpl()(crc, reinterpret_cast<const unsigned char*>(data), length);
+}
+
+
+bool Checksum32::isHardwareAccelerated(ChecksumImpl::Type t)
+{
+	switch (t)
+	{
+	case TYPE_CRC32_IMPL:
+		return crc32Impl() != &crc32Software;
+	case TYPE_CRC32C_IMPL:
+		return crc32cImpl() != &crc32cSoftware;
+	default:
+		return false;
+	}
 }
 
 
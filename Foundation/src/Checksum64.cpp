@@ -13,6 +13,9 @@
 
 
 #include "Poco/Checksum64.h"
+#include "Poco/ByteOrder.h"
+#include "Poco/Exception.h"
+#include <cstring>
 
 
 namespace Poco {
@@ -88,11 +91,165 @@ namespace Poco {
 	};
 
 
-Checksum64::Checksum64(): _value(0)
+namespace
+{
+	const UInt64 PRIME64_1 = 0x9E3779B185EBCA87ULL;
+	const UInt64 PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+	const UInt64 PRIME64_3 = 0x165667B19E3779F9ULL;
+	const UInt64 PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+	const UInt64 PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+	inline UInt64 rotl(UInt64 v, int r)
+	{
+		return (v << r) | (v >> (64 - r));
+	}
+
+	inline UInt64 read64(const unsigned char* p)
+	{
+		UInt64 v;
+		std::memcpy(&v, p, 8);
+		return ByteOrder::fromLittleEndian(v);
+	}
+
+	inline UInt32 read32(const unsigned char* p)
+	{
+		UInt32 v;
+		std::memcpy(&v, p, 4);
+		return ByteOrder::fromLittleEndian(v);
+	}
+
+	inline UInt64 xxhRound(UInt64 acc, UInt64 input)
+	{
+		acc += input*PRIME64_2;
+		acc  = rotl(acc, 31);
+		return acc*PRIME64_1;
+	}
+
+	inline UInt64 xxhMerge(UInt64 acc, UInt64 val)
+	{
+		acc ^= xxhRound(0, val);
+		return acc*PRIME64_1 + PRIME64_4;
+	}
+
+	void xxhInit(UInt64 acc[4], UInt64 seed)
+	{
+		acc[0] = seed + PRIME64_1 + PRIME64_2;
+		acc[1] = seed + PRIME64_2;
+		acc[2] = seed;
+		acc[3] = seed - PRIME64_1;
+	}
+
+	const unsigned char* xxhStripes(UInt64 acc[4], const unsigned char* p, std::size_t length)
+		/// Consumes all complete 32-byte stripes.
+	{
+		UInt64 v1 = acc[0];
+		UInt64 v2 = acc[1];
+		UInt64 v3 = acc[2];
+		UInt64 v4 = acc[3];
+		while (length >= 32)
+		{
+			v1 = xxhRound(v1, read64(p));
+			v2 = xxhRound(v2, read64(p + 8));
+			v3 = xxhRound(v3, read64(p + 16));
+			v4 = xxhRound(v4, read64(p + 24));
+			p += 32;
+			length -= 32;
+		}
+		acc[0] = v1;
+		acc[1] = v2;
+		acc[2] = v3;
+		acc[3] = v4;
+		return p;
+	}
+
+	UInt64 xxhDigest(const UInt64 acc[4], UInt64 seed, UInt64 totalLength, const unsigned char* p, std::size_t length)
+		/// Computes the hash from the accumulators and the
+		/// remaining (less than 32) bytes.
+	{
+		UInt64 h;
+		if (totalLength >= 32)
+		{
+			h = rotl(acc[0], 1) + rotl(acc[1], 7) + rotl(acc[2], 12) + rotl(acc[3], 18);
+			h = xxhMerge(h, acc[0]);
+			h = xxhMerge(h, acc[1]);
+			h = xxhMerge(h, acc[2]);
+			h = xxhMerge(h, acc[3]);
+		}
+		else h = seed + PRIME64_5;
+		h += totalLength;
+
+		while (length >= 8)
+		{
+			h ^= xxhRound(0, read64(p));
+			h  = rotl(h, 27)*PRIME64_1 + PRIME64_4;
+			p += 8;
+			length -= 8;
+		}
+		if (length >= 4)
+		{
+			h ^= UInt64(read32(p))*PRIME64_1;
+			h  = rotl(h, 23)*PRIME64_2 + PRIME64_3;
+			p += 4;
+			length -= 4;
+		}
+		while (length-- > 0)
+		{
+			h ^= (*p++)*PRIME64_5;
+			h  = rotl(h, 11)*PRIME64_1;
+		}
+
+		h ^= h >> 33;
+		h *= PRIME64_2;
+		h ^= h >> 29;
+		h *= PRIME64_3;
+		h ^= h >> 32;
+		return h;
+	}
+}
+
+
+Checksum64::Checksum64():
+	_type(TYPE_CRC64_IMPL),
+	_value(0),
+	_seed(0),
+	_totalLength(0),
+	_bufferLength(0)
 {
 }
 
 
+Checksum64::Checksum64(Type t):
+	_type(t),
+	_value(0),
+	_seed(0),
+	_totalLength(0),
+	_bufferLength(0)
+{
+	if (t == TYPE_XXH64_IMPL)
+	{
+		xxhInit(_acc, _seed);
+		finalizeXXH64();
+	}
+	else if (t != TYPE_CRC64_IMPL)
+	{
+		throw InvalidArgumentException("Checksum64 supports CRC-64 and XXH64 only");
+	}
+}
+
+
+Checksum64::Checksum64(Type t, Poco::UInt64 seed):
+	_type(t),
+	_value(0),
+	_seed(seed),
+	_totalLength(0),
+	_bufferLength(0)
+{
+	if (t != TYPE_XXH64_IMPL) throw InvalidArgumentException("a seed is only supported for XXH64");
+	xxhInit(_acc, _seed);
+	finalizeXXH64();
+}
+
+
 Checksum64::~Checksum64()
 {
 
@@ -101,6 +258,12 @@ Checksum64::~Checksum64()
 
 void Checksum64::update(const char* data, unsigned length)
 {
+	if (_type == TYPE_XXH64_IMPL)
+	{
+		updateXXH64(reinterpret_cast<const unsigned char*>(data), length);
+		return;
+	}
+
 	_value = _initCRC64Val;
 	Poco::UInt64 crc0 = _value;
 	unsigned char* pData = (unsigned char *)(data);
@@ -113,4 +276,47 @@ void Checksum64::update(const char* data, unsigned length)
 }
 
 
+void Checksum64::updateXXH64(const unsigned char* data, std::size_t length)
+{
+	_totalLength += length;
+	if (_bufferLength > 0)
+	{
+		std::size_t n = 32 - _bufferLength;
+		if (n > length) n = length;
+		std::memcpy(_buffer + _bufferLength, data, n);
+		_bufferLength += static_cast<unsigned>(n);
+		data   += n;
+		length -= n;
+		if (_bufferLength < 32)
+		{
+			finalizeXXH64();
+			return;
+		}
+		xxhStripes(_acc, _buffer, 32);
+		_bufferLength = 0;
+	}
+	const unsigned char* end = data + length;
+	data = xxhStripes(_acc, data, length);
+	_bufferLength = static_cast<unsigned>(end - data);
+	std::memcpy(_buffer, data, _bufferLength);
+	finalizeXXH64();
+}
+
+
+void Checksum64::finalizeXXH64()
+{
+	_value = xxhDigest(_acc, _seed, _totalLength, _buffer, _bufferLength);
+}
+
+
+Poco::UInt64 Checksum64::xxHash64(const char* data, std::size_t length, Poco::UInt64 seed)
+{
+	const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+	UInt64 acc[4];
+	xxhInit(acc, seed);
+	const unsigned char* tail = xxhStripes(acc, p, length);
+	return xxhDigest(acc, seed, length, tail, length - (tail - p));
+}
+
+
 } // namespace Poco
@@ -42,6 +42,7 @@ const std::string FileChannel::PROP_ROTATEONOPEN = "rotateOnOpen";
 FileChannel::FileChannel():
 	_times("utc"),
 	_compress(false),
+	_compressionMethod(ArchiveStrategy::COMPRESS_GZIP),
 	_flush(true),
 	_rotateOnOpen(false),
 	_pFile(0),
@@ -56,6 +57,7 @@ FileChannel::FileChannel(const std::string& rPath):
 	_path(rPath),
 	_times("utc"),
 	_compress(false),
+	_compressionMethod(ArchiveStrategy::COMPRESS_GZIP),
 	_flush(true),
 	_rotateOnOpen(false),
 	_pFile(0),
@@ -186,7 +188,10 @@ std::string FileChannel::getProperty(const std::string& name) const
 	else if (name == PROP_ARCHIVE)
 		return _archive;
 	else if (name == PROP_COMPRESS)
-		return std::string(_compress ? "true" : "false");
+	{
+		if (!_compress) return std::string("false");
+		return std::string(_compressionMethod == ArchiveStrategy::COMPRESS_LZ4 ? "lz4" : "true");
+	}
 	else if (name == PROP_PURGEAGE)
 		return _purgeAge;
 	else if (name == PROP_PURGECOUNT)
@@ -296,6 +301,7 @@ void FileChannel::setArchive(const std::string& archive)
 	else throw InvalidArgumentException("archive", archive);
 	delete _pArchiveStrategy;
 	pStrategy->compress(_compress);
+	pStrategy->setCompressionMethod(_compressionMethod);
 	_pArchiveStrategy = pStrategy;
 	_archive = archive;
 }
@@ -303,9 +309,21 @@ void FileChannel::setArchive(const std::string& archive)
 
 void FileChannel::setCompress(const std::string& compress)
 {
-	_compress = icompare(compress, "true") == 0;
+	if (icompare(compress, "lz4") == 0)
+	{
+		_compress = true;
+		_compressionMethod = ArchiveStrategy::COMPRESS_LZ4;
+	}
+	else
+	{
+		_compress = icompare(compress, "true") == 0 || icompare(compress, "gzip") == 0;
+		_compressionMethod = ArchiveStrategy::COMPRESS_GZIP;
+	}
 	if (_pArchiveStrategy)
+	{
 		_pArchiveStrategy->compress(_compress);
+		_pArchiveStrategy->setCompressionMethod(_compressionMethod);
+	}
 }
 
 
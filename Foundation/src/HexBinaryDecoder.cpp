@@ -14,11 +14,87 @@
 
 #include "Poco/HexBinaryDecoder.h"
 #include "Poco/Exception.h"
+#include "Poco/CPUFeatures.h"
+#if defined(POCO_HAVE_X86_INTRINSICS)
+#include <tmmintrin.h>
+#endif
 
 
 namespace Poco {
 
 
+namespace
+{
+	enum
+	{
+		HEX_SPACE   = 0xFE,
+		HEX_INVALID = 0xFF
+	};
+
+	class HexTable
+		/// Maps characters to their hex digit values.
+	{
+	public:
+		HexTable()
+		{
+			for (int i = 0; i < 256; i++) _table[i] = HEX_INVALID;
+			for (int i = 0; i < 10; i++) _table['0' + i] = static_cast<unsigned char>(i);
+			for (int i = 0; i < 6; i++)
+			{
+				_table['a' + i] = static_cast<unsigned char>(10 + i);
+				_table['A' + i] = static_cast<unsigned char>(10 + i);
+			}
+			_table[static_cast<unsigned char>(' ')]  = HEX_SPACE;
+			_table[static_cast<unsigned char>('\t')] = HEX_SPACE;
+			_table[static_cast<unsigned char>('\r')] = HEX_SPACE;
+			_table[static_cast<unsigned char>('\n')] = HEX_SPACE;
+		}
+
+		unsigned char operator [] (unsigned char c) const
+		{
+			return _table[c];
+		}
+
+	private:
+		unsigned char _table[256];
+	};
+
+
+#if defined(POCO_HAVE_X86_INTRINSICS)
+
+
+	POCO_TARGET("sse4.2")
+	std::size_t decodeBlocksSSE(const unsigned char* in, std::size_t length, unsigned char* out)
+		/// Decodes blocks of 16 hex digits into 8 bytes each, up to the
+		/// first block containing anything but hex digits.
+		/// Returns the number of characters decoded.
+	{
+		std::size_t done = 0;
+		while (length - done >= 16)
+		{
+			__m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + done));
+			__m128i letter = _mm_or_si128(c, _mm_set1_epi8(0x20));
+			__m128i digit = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(c, _mm_set1_epi8('9' + 1)));
+			__m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(letter, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(letter, _mm_set1_epi8('f' + 1)));
+			if (_mm_movemask_epi8(_mm_or_si128(digit, alpha)) != 0xFFFF) break;
+
+			__m128i v = _mm_or_si128(
+				_mm_and_si128(digit, _mm_sub_epi8(c, _mm_set1_epi8('0'))),
+				_mm_and_si128(alpha, _mm_sub_epi8(letter, _mm_set1_epi8('a' - 10))));
+			// combine pairs of digits into bytes
+			v = _mm_maddubs_epi16(v, _mm_set1_epi16(0x0110));
+			_mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(v, v));
+			out  += 8;
+			done += 16;
+		}
+		return done;
+	}
+
+
+#endif // POCO_HAVE_X86_INTRINSICS
+}
+
+
 HexBinaryDecoderBuf::HexBinaryDecoderBuf(std::istream& istr):
 	_buf(*istr.rdbuf())
 {
@@ -91,4 +167,53 @@ HexBinaryDecoder::~HexBinaryDecoder()
 }
 
 
+std::size_t HexBinaryDecoder::decode(const char* encoded, std::size_t length, char* data)
+{
+	static const HexTable table;
+
+	const unsigned char* in = reinterpret_cast<const unsigned char*>(encoded);
+	const unsigned char* end = in + length;
+	unsigned char* out = reinterpret_cast<unsigned char*>(data);
+#if defined(POCO_HAVE_X86_INTRINSICS)
+	const bool useSSE = CPUFeatures::hasSSE42();
+#endif
+	while (in < end)
+	{
+#if defined(POCO_HAVE_X86_INTRINSICS)
+		if (useSSE && end - in >= 16)
+		{
+			std::size_t done = decodeBlocksSSE(in, end - in, out);
+			in  += done;
+			out += done/2;
+		}
+#endif
+		// fast path for pairs of hex digits
+		while (end - in >= 2)
+		{
+			unsigned hi = table[in[0]];
+			unsigned lo = table[in[1]];
+			if ((hi | lo) >= 16) break;
+			*out++ = static_cast<unsigned char>((hi << 4) | lo);
+			in += 2;
+		}
+		if (in == end) break;
+
+		unsigned char hi = table[*in++];
+		if (hi == HEX_SPACE) continue;
+		if (hi == HEX_INVALID) throw DataFormatException();
+		unsigned char lo = HEX_SPACE;
+		while (in < end && (lo = table[*in++]) == HEX_SPACE) ;
+		if (lo >= 16) throw DataFormatException();
+		*out++ = static_cast<unsigned char>((hi << 4) | lo);
+	}
+	return out - reinterpret_cast<unsigned char*>(data);
+}
+
+
+std::size_t HexBinaryDecoder::decodedLength(std::size_t length)
+{
+	return length/2;
+}
+
+
 } // namespace Poco
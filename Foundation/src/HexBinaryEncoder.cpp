@@ -13,11 +13,69 @@
 
 
 #include "Poco/HexBinaryEncoder.h"
+#include "Poco/CPUFeatures.h"
+#if defined(POCO_HAVE_X86_INTRINSICS)
+#include <tmmintrin.h>
+#endif
 
 
 namespace Poco {
 
 
+namespace
+{
+	static const char DIGITS[] = "0123456789abcdef0123456789ABCDEF";
+
+#if defined(POCO_HAVE_X86_INTRINSICS)
+
+
+	POCO_TARGET("sse4.2")
+	std::size_t encodeBlocksSSE(const unsigned char* in, std::size_t length, const char* digits, char* out)
+		/// Encodes blocks of 16 bytes. Returns the number of bytes encoded.
+	{
+		const __m128i table = _mm_loadu_si128(reinterpret_cast<const __m128i*>(digits));
+		const __m128i nibbleMask = _mm_set1_epi8(0x0F);
+		std::size_t done = 0;
+		while (length - done >= 16)
+		{
+			__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + done));
+			__m128i hi = _mm_shuffle_epi8(table, _mm_and_si128(_mm_srli_epi16(v, 4), nibbleMask));
+			__m128i lo = _mm_shuffle_epi8(table, _mm_and_si128(v, nibbleMask));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi8(hi, lo));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16), _mm_unpackhi_epi8(hi, lo));
+			out  += 32;
+			done += 16;
+		}
+		return done;
+	}
+
+
+#endif // POCO_HAVE_X86_INTRINSICS
+
+
+	inline char* encodeBytes(const unsigned char* in, std::size_t length, const char* digits, char* out)
+	{
+#if defined(POCO_HAVE_X86_INTRINSICS)
+		if (length >= 16 && CPUFeatures::hasSSE42())
+		{
+			std::size_t done = encodeBlocksSSE(in, length, digits, out);
+			in     += done;
+			out    += 2*done;
+			length -= done;
+		}
+#endif
+		while (length-- > 0)
+		{
+			out[0] = digits[*in >> 4];
+			out[1] = digits[*in & 0xF];
+			++in;
+			out += 2;
+		}
+		return out;
+	}
+}
+
+
 HexBinaryEncoderBuf::HexBinaryEncoderBuf(std::ostream& ostr):
 	_pos(0),
 	_lineLength(72),
@@ -60,11 +118,10 @@ void HexBinaryEncoderBuf::setUppercase(bool flag)
 int HexBinaryEncoderBuf::writeToDevice(char c)
 {
 	static const int eof = std::char_traits<char>::eof();
-	static const char digits[] = "0123456789abcdef0123456789ABCDEF";
-	
-	if (_buf.sputc(digits[_uppercase + ((c >> 4) & 0xF)]) == eof) return eof;
+
+	if (_buf.sputc(DIGITS[_uppercase + ((c >> 4) & 0xF)]) == eof) return eof;
 	++_pos;
-	if (_buf.sputc(digits[_uppercase + (c & 0xF)]) == eof) return eof;
+	if (_buf.sputc(DIGITS[_uppercase + (c & 0xF)]) == eof) return eof;
 	if (++_pos >= _lineLength && _lineLength > 0)
 	{
 		if (_buf.sputc('\n') == eof) return eof;
@@ -74,6 +131,40 @@ int HexBinaryEncoderBuf::writeToDevice(char c)
 }
 
 
+std::streamsize HexBinaryEncoderBuf::xsputn(const char* s, std::streamsize n)
+{
+	char buffer[4096 + 1];
+	const char* p = s;
+	const char* end = s + n;
+	while (p < end)
+	{
+		std::size_t length = end - p;
+		if (length > 4096/2) length = 4096/2;
+		bool lineBreak = false;
+		if (_lineLength > 0)
+		{
+			int bytesLeft = (_lineLength - _pos + 1)/2;
+			if (bytesLeft < 1) bytesLeft = 1;
+			if (length >= static_cast<std::size_t>(bytesLeft))
+			{
+				length = bytesLeft;
+				lineBreak = true;
+			}
+		}
+		char* pEnd = encodeBytes(reinterpret_cast<const unsigned char*>(p), length, DIGITS + _uppercase, buffer);
+		if (lineBreak)
+		{
+			*pEnd++ = '\n';
+			_pos = 0;
+		}
+		else _pos += static_cast<int>(2*length);
+		if (_buf.sputn(buffer, pEnd - buffer) != pEnd - buffer) return p - s;
+		p += length;
+	}
+	return n;
+}
+
+
 int HexBinaryEncoderBuf::close()
 {
 	sync();
@@ -114,4 +205,16 @@ HexBinaryEncoder::~HexBinaryEncoder()
 }
 
 
+std::size_t HexBinaryEncoder::encode(const char* data, std::size_t length, char* encoded, bool uppercase)
+{
+	return encodeBytes(reinterpret_cast<const unsigned char*>(data), length, DIGITS + (uppercase ? 16 : 0), encoded) - encoded;
+}
+
+
+std::size_t HexBinaryEncoder::encodedLength(std::size_t length)
+{
+	return 2*length;
+}
+
+
 } // namespace Poco
@@ -0,0 +1,731 @@
+//
+// LZ4Stream.cpp
+//
+// Library: Foundation
+// Package: Streams
+// Module:  LZ4Stream
+//
+// Copyright (c) 2004-2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/LZ4Stream.h"
+#include "Poco/Exception.h"
+#include <cstring>
+
+
+namespace Poco {
+
+
+namespace
+{
+	const UInt32 FRAME_MAGIC          = 0x184D2204;
+	const UInt32 SKIPPABLE_MAGIC      = 0x184D2A50;
+	const UInt32 SKIPPABLE_MASK       = 0xFFFFFFF0;
+	const UInt32 UNCOMPRESSED_BIT     = 0x80000000;
+
+	const unsigned char FLG_VERSION          = 0x40;
+	const unsigned char FLG_BLOCK_INDEPENDENT = 0x20;
+	const unsigned char FLG_BLOCK_CHECKSUM    = 0x10;
+	const unsigned char FLG_CONTENT_SIZE      = 0x08;
+	const unsigned char FLG_CONTENT_CHECKSUM  = 0x04;
+	const unsigned char FLG_DICT_ID           = 0x01;
+
+	const std::size_t MIN_MATCH     = 4;
+	const std::size_t LAST_LITERALS = 5;
+	const std::size_t MF_LIMIT      = 12;
+	const std::size_t MAX_DISTANCE  = 65535;
+	const int         HASH_LOG      = 12;
+	const int         SKIP_TRIGGER  = 6;
+
+
+	inline UInt32 read32(const UInt8* p)
+	{
+		UInt32 v;
+		std::memcpy(&v, p, sizeof(v));
+		return v;
+	}
+
+
+	inline UInt64 read64(const UInt8* p)
+	{
+		UInt64 v;
+		std::memcpy(&v, p, sizeof(v));
+		return v;
+	}
+
+
+	inline UInt32 readLE32(const UInt8* p)
+	{
+		return UInt32(p[0]) | (UInt32(p[1]) << 8) | (UInt32(p[2]) << 16) | (UInt32(p[3]) << 24);
+	}
+
+
+	inline UInt32 hashSequence(UInt32 sequence)
+	{
+		return (sequence*2654435761U) >> (32 - HASH_LOG);
+	}
+
+
+	inline std::size_t matchLength(const UInt8* p, const UInt8* ref, const UInt8* limit)
+		/// Returns the number of equal bytes at p and ref, not
+		/// going beyond limit.
+	{
+		const UInt8* start = p;
+#if defined(POCO_ARCH_LITTLE_ENDIAN)
+		while (p + 8 <= limit)
+		{
+			UInt64 diff = read64(p) ^ read64(ref);
+			if (diff)
+			{
+#if defined(__GNUC__)
+				return static_cast<std::size_t>(p - start) + __builtin_ctzll(diff)/8;
+#else
+				while ((diff & 0xFF) == 0)
+				{
+					diff >>= 8;
+					++p;
+				}
+				return static_cast<std::size_t>(p - start);
+#endif
+			}
+			p += 8;
+			ref += 8;
+		}
+#endif
+		while (p < limit && *p == *ref)
+		{
+			++p;
+			++ref;
+		}
+		return static_cast<std::size_t>(p - start);
+	}
+
+
+	inline UInt8* writeLength(UInt8* op, std::size_t length)
+	{
+		while (length >= 255)
+		{
+			*op++ = 255;
+			length -= 255;
+		}
+		*op++ = static_cast<UInt8>(length);
+		return op;
+	}
+
+
+	inline UInt8* writeLiterals(UInt8* op, const UInt8* literals, std::size_t length, unsigned matchToken)
+	{
+		UInt8* pToken = op++;
+		if (length >= 15)
+		{
+			*pToken = static_cast<UInt8>((15 << 4) | matchToken);
+			op = writeLength(op, length - 15);
+		}
+		else *pToken = static_cast<UInt8>((length << 4) | matchToken);
+		std::memcpy(op, literals, length);
+		return op + length;
+	}
+
+
+	UInt8* writeSequence(UInt8* op, const UInt8* literals, std::size_t literalLength, std::size_t offset, std::size_t matchLength)
+	{
+		matchLength -= MIN_MATCH;
+		op = writeLiterals(op, literals, literalLength, matchLength >= 15 ? 15 : static_cast<unsigned>(matchLength));
+		*op++ = static_cast<UInt8>(offset & 0xFF);
+		*op++ = static_cast<UInt8>(offset >> 8);
+		if (matchLength >= 15) op = writeLength(op, matchLength - 15);
+		return op;
+	}
+
+
+	std::size_t readLength(const UInt8*& ip, const UInt8* iend)
+	{
+		std::size_t length = 0;
+		unsigned b;
+		do
+		{
+			if (ip >= iend) throw DataFormatException("Truncated LZ4 block");
+			b = *ip++;
+			length += b;
+		}
+		while (b == 255);
+		return length;
+	}
+
+
+	std::size_t decompress(const UInt8* ip, std::size_t length, UInt8* dest, std::size_t capacity, std::size_t history)
+		/// Decompresses a raw LZ4 block. Matches may refer to up to
+		/// history bytes of already decompressed data preceding dest.
+	{
+		const UInt8* iend = ip + length;
+		UInt8* op = dest;
+		UInt8* oend = dest + capacity;
+		const UInt8* lowest = dest - history;
+		for (;;)
+		{
+			if (ip >= iend) throw DataFormatException("Truncated LZ4 block");
+			unsigned token = *ip++;
+
+			std::size_t literalLength = token >> 4;
+			if (literalLength == 15) literalLength += readLength(ip, iend);
+			if (literalLength > static_cast<std::size_t>(iend - ip) || literalLength > static_cast<std::size_t>(oend - op))
+				throw DataFormatException("Corrupt LZ4 block");
+			std::memcpy(op, ip, literalLength);
+			ip += literalLength;
+			op += literalLength;
+			if (ip == iend) break;
+
+			if (iend - ip < 2) throw DataFormatException("Truncated LZ4 block");
+			std::size_t offset = ip[0] | (std::size_t(ip[1]) << 8);
+			ip += 2;
+			if (offset == 0 || offset > static_cast<std::size_t>(op - lowest))
+				throw DataFormatException("Invalid LZ4 match offset");
+
+			std::size_t matchLength = token & 15;
+			if (matchLength == 15) matchLength += readLength(ip, iend);
+			matchLength += MIN_MATCH;
+			if (matchLength > static_cast<std::size_t>(oend - op))
+				throw DataFormatException("Corrupt LZ4 block");
+
+			const UInt8* match = op - offset;
+			if (offset >= matchLength)
+			{
+				std::memcpy(op, match, matchLength);
+				op += matchLength;
+			}
+			else if (offset >= 8)
+			{
+				// overlapping match; copy in chunks not overlapping themselves
+				UInt8* mend = op + matchLength;
+				while (mend - op >= 8)
+				{
+					std::memcpy(op, match, 8);
+					op += 8;
+					match += 8;
+				}
+				while (op < mend) *op++ = *match++;
+			}
+			else
+			{
+				UInt8* mend = op + matchLength;
+				while (op < mend) *op++ = *match++;
+			}
+		}
+		return static_cast<std::size_t>(op - dest);
+	}
+}
+
+
+class LZ4StreamBuf::Hash
+	/// Incremental XXH32 with seed 0, as used by the LZ4 frame
+	/// format for header, block and content checksums.
+{
+public:
+	Hash()
+	{
+		reset();
+	}
+
+	void reset()
+	{
+		_acc[0] = PRIME1 + PRIME2;
+		_acc[1] = PRIME2;
+		_acc[2] = 0;
+		_acc[3] = 0 - PRIME1;
+		_totalLength = 0;
+		_bufferLength = 0;
+	}
+
+	void update(const char* data, std::size_t length)
+	{
+		const UInt8* p = reinterpret_cast<const UInt8*>(data);
+		_totalLength += length;
+		if (_bufferLength + length < 16)
+		{
+			std::memcpy(_buffer + _bufferLength, p, length);
+			_bufferLength += length;
+			return;
+		}
+		if (_bufferLength > 0)
+		{
+			std::size_t n = 16 - _bufferLength;
+			std::memcpy(_buffer + _bufferLength, p, n);
+			processStripe(_buffer);
+			p += n;
+			length -= n;
+			_bufferLength = 0;
+		}
+		while (length >= 16)
+		{
+			processStripe(p);
+			p += 16;
+			length -= 16;
+		}
+		std::memcpy(_buffer, p, length);
+		_bufferLength = length;
+	}
+
+	UInt32 digest() const
+	{
+		UInt32 h;
+		if (_totalLength >= 16)
+			h = rotl(_acc[0], 1) + rotl(_acc[1], 7) + rotl(_acc[2], 12) + rotl(_acc[3], 18);
+		else
+			h = PRIME5;
+		h += static_cast<UInt32>(_totalLength);
+
+		const UInt8* p = _buffer;
+		std::size_t length = _bufferLength;
+		while (length >= 4)
+		{
+			h += readLE32(p)*PRIME3;
+			h = rotl(h, 17)*PRIME4;
+			p += 4;
+			length -= 4;
+		}
+		while (length-- > 0)
+		{
+			h += (*p++)*PRIME5;
+			h = rotl(h, 11)*PRIME1;
+		}
+		h ^= h >> 15;
+		h *= PRIME2;
+		h ^= h >> 13;
+		h *= PRIME3;
+		h ^= h >> 16;
+		return h;
+	}
+
+	static UInt32 hash(const char* data, std::size_t length)
+	{
+		Hash h;
+		h.update(data, length);
+		return h.digest();
+	}
+
+private:
+	static const UInt32 PRIME1 = 2654435761U;
+	static const UInt32 PRIME2 = 2246822519U;
+	static const UInt32 PRIME3 = 3266489917U;
+	static const UInt32 PRIME4 = 668265263U;
+	static const UInt32 PRIME5 = 374761393U;
+
+	static UInt32 rotl(UInt32 x, int r)
+	{
+		return (x << r) | (x >> (32 - r));
+	}
+
+	static UInt32 round(UInt32 acc, UInt32 input)
+	{
+		acc += input*PRIME2;
+		return rotl(acc, 13)*PRIME1;
+	}
+
+	void processStripe(const UInt8* p)
+	{
+		_acc[0] = round(_acc[0], readLE32(p));
+		_acc[1] = round(_acc[1], readLE32(p + 4));
+		_acc[2] = round(_acc[2], readLE32(p + 8));
+		_acc[3] = round(_acc[3], readLE32(p + 12));
+	}
+
+	UInt32      _acc[4];
+	UInt64      _totalLength;
+	UInt8       _buffer[16];
+	std::size_t _bufferLength;
+};
+
+
+const std::size_t LZ4StreamBuf::WINDOW_SIZE;
+
+
+LZ4StreamBuf::LZ4StreamBuf(std::istream& istr):
+	BufferedStreamBuf(STREAM_BUFFER_SIZE, std::ios::in),
+	_pIstr(&istr),
+	_pOstr(0),
+	_pHash(new Hash),
+	_blockSize(BLOCK_64K),
+	_blockMax(0),
+	_input(0),
+	_window(0),
+	_outPos(0),
+	_outEnd(0),
+	_inFrame(false),
+	_linked(false),
+	_blockChecksum(false),
+	_contentChecksum(false)
+{
+}
+
+
+LZ4StreamBuf::LZ4StreamBuf(std::ostream& ostr, BlockSize blockSize):
+	BufferedStreamBuf(std::streamsize(1) << (8 + 2*blockSize), std::ios::out),
+	_pIstr(0),
+	_pOstr(&ostr),
+	_pHash(new Hash),
+	_blockSize(blockSize),
+	_blockMax(std::size_t(1) << (8 + 2*blockSize)),
+	_input(0),
+	_window(0),
+	_outPos(0),
+	_outEnd(0),
+	_inFrame(false),
+	_linked(false),
+	_blockChecksum(false),
+	_contentChecksum(true)
+{
+}
+
+
+LZ4StreamBuf::~LZ4StreamBuf()
+{
+	try
+	{
+		close();
+	}
+	catch (...)
+	{
+	}
+	delete _pHash;
+}
+
+
+int LZ4StreamBuf::close()
+{
+	BufferedStreamBuf::sync();
+	_pIstr = 0;
+	if (_pOstr)
+	{
+		if (!_inFrame) writeFrameHeader();
+		writeUInt32(0);
+		writeUInt32(_pHash->digest());
+		_pOstr->flush();
+		_pOstr = 0;
+	}
+	return 0;
+}
+
+
+std::size_t LZ4StreamBuf::compressBound(std::size_t length)
+{
+	return length + length/255 + 16;
+}
+
+
+std::size_t LZ4StreamBuf::compressBlock(const char* source, std::size_t length, char* dest)
+{
+	const UInt8* src = reinterpret_cast<const UInt8*>(source);
+	UInt8* op = reinterpret_cast<UInt8*>(dest);
+	std::size_t anchor = 0;
+
+	if (length > MF_LIMIT)
+	{
+		// The table may refer to position 0 for sequences not
+		// seen yet; every candidate is verified before use.
+		UInt32 table[1 << HASH_LOG];
+		std::memset(table, 0, sizeof(table));
+
+		// The last match must start at least MF_LIMIT bytes before
+		// the end of the block, and the last LAST_LITERALS bytes
+		// are always literals.
+		const std::size_t mflimit = length - MF_LIMIT;
+		const UInt8* matchlimit = src + length - LAST_LITERALS;
+		std::size_t ip = 1;
+		while (ip <= mflimit)
+		{
+			UInt32 sequence = read32(src + ip);
+			UInt32 h = hashSequence(sequence);
+			std::size_t ref = table[h];
+			table[h] = static_cast<UInt32>(ip);
+			if (ref >= ip || ip - ref > MAX_DISTANCE || read32(src + ref) != sequence)
+			{
+				// skip faster over incompressible data
+				ip += 1 + ((ip - anchor) >> SKIP_TRIGGER);
+				continue;
+			}
+
+			while (ip > anchor && ref > 0 && src[ip - 1] == src[ref - 1])
+			{
+				--ip;
+				--ref;
+			}
+			std::size_t len = MIN_MATCH + matchLength(src + ip + MIN_MATCH, src + ref + MIN_MATCH, matchlimit);
+			op = writeSequence(op, src + anchor, ip - anchor, ip - ref, len);
+			ip += len;
+			anchor = ip;
+			if (ip <= mflimit)
+			{
+				table[hashSequence(read32(src + ip - 2))] = static_cast<UInt32>(ip - 2);
+			}
+		}
+	}
+	op = writeLiterals(op, src + anchor, length - anchor, 0);
+	return static_cast<std::size_t>(op - reinterpret_cast<UInt8*>(dest));
+}
+
+
+std::size_t LZ4StreamBuf::decompressBlock(const char* source, std::size_t length, char* dest, std::size_t capacity)
+{
+	return decompress(reinterpret_cast<const UInt8*>(source), length, reinterpret_cast<UInt8*>(dest), capacity, 0);
+}
+
+
+int LZ4StreamBuf::readFromDevice(char* buffer, std::streamsize length)
+{
+	if (!_pIstr) return 0;
+
+	while (_outPos == _outEnd)
+	{
+		if (!readBlock())
+		{
+			_pIstr = 0;
+			return 0;
+		}
+	}
+	std::size_t n = _outEnd - _outPos;
+	if (n > static_cast<std::size_t>(length)) n = static_cast<std::size_t>(length);
+	std::memcpy(buffer, _window.begin() + _outPos, n);
+	_outPos += n;
+	return static_cast<int>(n);
+}
+
+
+int LZ4StreamBuf::writeToDevice(const char* buffer, std::streamsize length)
+{
+	if (length == 0 || !_pOstr) return 0;
+
+	if (!_inFrame) writeFrameHeader();
+
+	std::size_t n = static_cast<std::size_t>(length);
+	_input.resize(compressBound(n), false);
+	std::size_t compressed = compressBlock(buffer, n, _input.begin());
+	if (compressed < n)
+	{
+		writeUInt32(static_cast<UInt32>(compressed));
+		_pOstr->write(_input.begin(), static_cast<std::streamsize>(compressed));
+	}
+	else
+	{
+		writeUInt32(static_cast<UInt32>(n) | UNCOMPRESSED_BIT);
+		_pOstr->write(buffer, length);
+	}
+	if (!_pOstr->good()) throw IOException("Failed to write LZ4 block");
+	_pHash->update(buffer, n);
+	return static_cast<int>(length);
+}
+
+
+void LZ4StreamBuf::writeFrameHeader()
+{
+	char header[7];
+	header[0] = static_cast<char>(FRAME_MAGIC & 0xFF);
+	header[1] = static_cast<char>((FRAME_MAGIC >> 8) & 0xFF);
+	header[2] = static_cast<char>((FRAME_MAGIC >> 16) & 0xFF);
+	header[3] = static_cast<char>((FRAME_MAGIC >> 24) & 0xFF);
+	header[4] = static_cast<char>(FLG_VERSION | FLG_BLOCK_INDEPENDENT | FLG_CONTENT_CHECKSUM);
+	header[5] = static_cast<char>(_blockSize << 4);
+	header[6] = static_cast<char>((Hash::hash(header + 4, 2) >> 8) & 0xFF);
+	_pOstr->write(header, sizeof(header));
+	if (!_pOstr->good()) throw IOException("Failed to write LZ4 frame header");
+	_inFrame = true;
+}
+
+
+bool LZ4StreamBuf::readFrameHeader()
+{
+	for (;;)
+	{
+		char magic[4];
+		std::size_t n = readBytes(magic, sizeof(magic));
+		if (n == 0) return false;
+		if (n < sizeof(magic)) throw DataFormatException("Truncated LZ4 frame");
+
+		UInt32 value = readLE32(reinterpret_cast<const UInt8*>(magic));
+		if ((value & SKIPPABLE_MASK) == SKIPPABLE_MAGIC)
+		{
+			UInt32 size = readUInt32();
+			_pIstr->ignore(size);
+			if (static_cast<UInt32>(_pIstr->gcount()) != size) throw DataFormatException("Truncated LZ4 skippable frame");
+			continue;
+		}
+		if (value != FRAME_MAGIC) throw DataFormatException("Not a LZ4 frame");
+		break;
+	}
+
+	char descriptor[15];
+	readFully(descriptor, 2);
+	unsigned char flags = static_cast<unsigned char>(descriptor[0]);
+	unsigned blockSizeId = (static_cast<unsigned char>(descriptor[1]) >> 4) & 7;
+	if ((flags & 0xC0) != FLG_VERSION) throw DataFormatException("Unsupported LZ4 frame version");
+	if (flags & FLG_DICT_ID) throw DataFormatException("LZ4 frames with preset dictionary are not supported");
+	if (blockSizeId < BLOCK_64K) throw DataFormatException("Invalid LZ4 block size");
+
+	std::size_t descriptorLength = 2;
+	if (flags & FLG_CONTENT_SIZE)
+	{
+		readFully(descriptor + descriptorLength, 8);
+		descriptorLength += 8;
+	}
+	char checksum;
+	readFully(&checksum, 1);
+	if (static_cast<unsigned char>(checksum) != ((Hash::hash(descriptor, descriptorLength) >> 8) & 0xFF))
+		throw DataFormatException("LZ4 frame header checksum mismatch");
+
+	_linked          = (flags & FLG_BLOCK_INDEPENDENT) == 0;
+	_blockChecksum   = (flags & FLG_BLOCK_CHECKSUM) != 0;
+	_contentChecksum = (flags & FLG_CONTENT_CHECKSUM) != 0;
+	_blockMax        = std::size_t(1) << (8 + 2*blockSizeId);
+	_window.resize(WINDOW_SIZE + _blockMax, false);
+	_outPos = _outEnd = 0;
+	_pHash->reset();
+	_inFrame = true;
+	return true;
+}
+
+
+bool LZ4StreamBuf::readBlock()
+{
+	if (!_inFrame && !readFrameHeader()) return false;
+
+	UInt32 blockSize = readUInt32();
+	if (blockSize == 0)
+	{
+		// end mark
+		if (_contentChecksum && readUInt32() != _pHash->digest())
+			throw DataFormatException("LZ4 content checksum mismatch");
+		_inFrame = false;
+		return true;
+	}
+
+	bool uncompressed = (blockSize & UNCOMPRESSED_BIT) != 0;
+	std::size_t size = blockSize & ~UNCOMPRESSED_BIT;
+	if (size > _blockMax) throw DataFormatException("LZ4 block too large");
+	_input.resize(size, false);
+	readFully(_input.begin(), size);
+	if (_blockChecksum && readUInt32() != Hash::hash(_input.begin(), size))
+		throw DataFormatException("LZ4 block checksum mismatch");
+
+	std::size_t start = 0;
+	if (_linked)
+	{
+		// keep the last 64 Kbytes of output for matches in the next block
+		start = _outEnd;
+		if (start + _blockMax > _window.size())
+		{
+			std::size_t keep = start < WINDOW_SIZE ? start : WINDOW_SIZE;
+			std::memmove(_window.begin(), _window.begin() + start - keep, keep);
+			start = keep;
+		}
+	}
+
+	std::size_t n;
+	char* dest = _window.begin() + start;
+	if (uncompressed)
+	{
+		std::memcpy(dest, _input.begin(), size);
+		n = size;
+	}
+	else
+	{
+		n = decompress(reinterpret_cast<const UInt8*>(_input.begin()), size, reinterpret_cast<UInt8*>(dest), _blockMax, start);
+	}
+	if (_contentChecksum) _pHash->update(dest, n);
+	_outPos = start;
+	_outEnd = start + n;
+	return true;
+}
+
+
+std::size_t LZ4StreamBuf::readBytes(char* buffer, std::size_t length)
+{
+	_pIstr->read(buffer, static_cast<std::streamsize>(length));
+	return static_cast<std::size_t>(_pIstr->gcount());
+}
+
+
+void LZ4StreamBuf::readFully(char* buffer, std::size_t length)
+{
+	if (readBytes(buffer, length) != length) throw DataFormatException("Truncated LZ4 frame");
+}
+
+
+UInt32 LZ4StreamBuf::readUInt32()
+{
+	char bytes[4];
+	readFully(bytes, sizeof(bytes));
+	return readLE32(reinterpret_cast<const UInt8*>(bytes));
+}
+
+
+void LZ4StreamBuf::writeUInt32(UInt32 value)
+{
+	char bytes[4];
+	bytes[0] = static_cast<char>(value & 0xFF);
+	bytes[1] = static_cast<char>((value >> 8) & 0xFF);
+	bytes[2] = static_cast<char>((value >> 16) & 0xFF);
+	bytes[3] = static_cast<char>((value >> 24) & 0xFF);
+	_pOstr->write(bytes, sizeof(bytes));
+	if (!_pOstr->good()) throw IOException("Failed to write LZ4 frame");
+}
+
+
+LZ4IOS::LZ4IOS(std::ostream& ostr, LZ4StreamBuf::BlockSize blockSize):
+	_buf(ostr, blockSize)
+{
+	poco_ios_init(&_buf);
+}
+
+
+LZ4IOS::LZ4IOS(std::istream& istr):
+	_buf(istr)
+{
+	poco_ios_init(&_buf);
+}
+
+
+LZ4IOS::~LZ4IOS()
+{
+}
+
+
+LZ4StreamBuf* LZ4IOS::rdbuf()
+{
+	return &_buf;
+}
+
+
+LZ4OutputStream::LZ4OutputStream(std::ostream& ostr, LZ4StreamBuf::BlockSize blockSize):
+	std::ostream(&_buf),
+	LZ4IOS(ostr, blockSize)
+{
+}
+
+
+LZ4OutputStream::~LZ4OutputStream()
+{
+}
+
+
+int LZ4OutputStream::close()
+{
+	return _buf.close();
+}
+
+
+LZ4InputStream::LZ4InputStream(std::istream& istr):
+	std::istream(&_buf),
+	LZ4IOS(istr)
+{
+}
+
+
+LZ4InputStream::~LZ4InputStream()
+{
+}
+
+
+} // namespace Poco
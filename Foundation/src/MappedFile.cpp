@@ -0,0 +1,166 @@
+//
+// MappedFile.cpp
+//
+// Library: Foundation
+// Package: Filesystem
+// Module:  MappedFile
+//
+// Copyright (c) 2007, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/MappedFile.h"
+#include "Poco/Exception.h"
+#if defined(POCO_OS_FAMILY_WINDOWS)
+#include "MappedFile_WIN32.cpp"
+#else
+#include "MappedFile_POSIX.cpp"
+#endif
+
+
+namespace Poco {
+
+
+MappedFile::MappedFile():
+	_pImpl(0)
+{
+}
+
+
+MappedFile::MappedFile(const std::string& path, Advice advice):
+	_pImpl(new MappedFileImpl(path, 0, 0, true))
+{
+	if (advice != ADVICE_NORMAL) advise(advice);
+}
+
+
+MappedFile::MappedFile(const std::string& path, UInt64 offset, std::size_t length, Advice advice):
+	_pImpl(new MappedFileImpl(path, offset, length, false))
+{
+	if (advice != ADVICE_NORMAL) advise(advice);
+}
+
+
+MappedFile::MappedFile(const MappedFile& other):
+	_pImpl(other._pImpl)
+{
+	if (_pImpl)
+		_pImpl->duplicate();
+}
+
+
+MappedFile::~MappedFile()
+{
+	if (_pImpl)
+		_pImpl->release();
+}
+
+
+MappedFile& MappedFile::operator = (const MappedFile& other)
+{
+	MappedFile tmp(other);
+	swap(tmp);
+	return *this;
+}
+
+
+const char* MappedFile::begin() const
+{
+	return _pImpl ? _pImpl->begin() : 0;
+}
+
+
+const char* MappedFile::end() const
+{
+	return _pImpl ? _pImpl->end() : 0;
+}
+
+
+std::size_t MappedFile::size() const
+{
+	return _pImpl ? _pImpl->size() : 0;
+}
+
+
+UInt64 MappedFile::offset() const
+{
+	return _pImpl ? _pImpl->offset() : 0;
+}
+
+
+UInt64 MappedFile::fileSize() const
+{
+	return _pImpl ? _pImpl->fileSize() : 0;
+}
+
+
+bool MappedFile::advise(Advice advice) const
+{
+	return advise(advice, 0, size());
+}
+
+
+bool MappedFile::advise(Advice advice, std::size_t offset, std::size_t length) const
+{
+	return _pImpl ? _pImpl->advise(advice, offset, length) : false;
+}
+
+
+std::size_t MappedFile::pageSize()
+{
+	return MappedFileImpl::pageSize();
+}
+
+
+std::size_t MappedFile::allocationGranularity()
+{
+	return MappedFileImpl::allocationGranularity();
+}
+
+
+//
+// MappedIOS
+//
+
+
+MappedIOS::MappedIOS(const MappedFile& file):
+	_file(file),
+	_buf(const_cast<char*>(_file.begin()), static_cast<std::streamsize>(_file.size()))
+{
+	poco_ios_init(&_buf);
+}
+
+
+MappedIOS::~MappedIOS()
+{
+}
+
+
+//
+// MappedInputStream
+//
+
+
+MappedInputStream::MappedInputStream(const std::string& path):
+	MappedIOS(MappedFile(path, MappedFile::ADVICE_SEQUENTIAL)),
+	std::istream(&_buf)
+{
+}
+
+
+MappedInputStream::MappedInputStream(const MappedFile& file):
+	MappedIOS(file),
+	std::istream(&_buf)
+{
+}
+
+
+MappedInputStream::~MappedInputStream()
+{
+}
+
+
+} // namespace Poco
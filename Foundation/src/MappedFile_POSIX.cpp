@@ -0,0 +1,152 @@
+//
+// MappedFile_POSIX.cpp
+//
+// Library: Foundation
+// Package: Filesystem
+// Module:  MappedFile
+//
+// Copyright (c) 2007, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/MappedFile_POSIX.h"
+#include "Poco/Exception.h"
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+
+
+namespace Poco {
+
+
+MappedFileImpl::MappedFileImpl(const std::string& path, UInt64 offset, std::size_t length, bool toEnd):
+	_path(path),
+	_mapAddress(0),
+	_mapSize(0),
+	_address(0),
+	_size(0),
+	_offset(offset),
+	_fileSize(0)
+{
+	int fd = ::open(_path.c_str(), O_RDONLY);
+	if (fd == -1)
+	{
+		if (errno == ENOENT || errno == ENOTDIR)
+			throw FileNotFoundException(_path);
+		else
+			throw OpenFileException("Cannot open file for mapping", _path);
+	}
+
+	struct stat st;
+	if (::fstat(fd, &st) == -1 || !S_ISREG(st.st_mode))
+	{
+		::close(fd);
+		throw OpenFileException("Cannot map file", _path);
+	}
+	_fileSize = static_cast<UInt64>(st.st_size);
+
+	if (_offset > _fileSize) _offset = _fileSize;
+	UInt64 available = _fileSize - _offset;
+	if (toEnd || length > available)
+	{
+		if (available > static_cast<UInt64>(~std::size_t(0)))
+		{
+			::close(fd);
+			throw OutOfMemoryException("File too large to be mapped", _path);
+		}
+		length = static_cast<std::size_t>(available);
+	}
+	_size = length;
+
+	if (_size > 0)
+	{
+		// the file offset of a mapping must be a multiple of the page size
+		UInt64 mapOffset = _offset - _offset % allocationGranularity();
+		std::size_t delta = static_cast<std::size_t>(_offset - mapOffset);
+		_mapSize = _size + delta;
+		void* addr = ::mmap(0, _mapSize, PROT_READ, MAP_SHARED, fd, static_cast<off_t>(mapOffset));
+		if (addr == MAP_FAILED)
+		{
+			::close(fd);
+			throw SystemException("Cannot map file into memory", _path);
+		}
+		_mapAddress = static_cast<char*>(addr);
+		_address = _mapAddress + delta;
+	}
+	// the mapping stays valid after the descriptor has been closed
+	::close(fd);
+}
+
+
+MappedFileImpl::~MappedFileImpl()
+{
+	if (_mapAddress)
+	{
+		::munmap(_mapAddress, _mapSize);
+	}
+}
+
+
+bool MappedFileImpl::advise(MappedFile::Advice advice, std::size_t offset, std::size_t length) const
+{
+	if (offset >= _size) return false;
+	if (length > _size - offset) length = _size - offset;
+
+	int adv;
+	switch (advice)
+	{
+	case MappedFile::ADVICE_NORMAL:
+		adv = MADV_NORMAL;
+		break;
+	case MappedFile::ADVICE_SEQUENTIAL:
+		adv = MADV_SEQUENTIAL;
+		break;
+	case MappedFile::ADVICE_RANDOM:
+		adv = MADV_RANDOM;
+		break;
+	case MappedFile::ADVICE_WILLNEED:
+		adv = MADV_WILLNEED;
+		break;
+	case MappedFile::ADVICE_DONTNEED:
+		adv = MADV_DONTNEED;
+		break;
+	case MappedFile::ADVICE_HUGEPAGE:
+#if defined(MADV_HUGEPAGE)
+		adv = MADV_HUGEPAGE;
+		break;
+#else
+		return false;
+#endif
+	default:
+		return false;
+	}
+
+	// madvise() requires a page aligned start address
+	const char* begin = _address + offset;
+	std::size_t delta = static_cast<std::size_t>(begin - _mapAddress) % pageSize();
+	begin -= delta;
+	length += delta;
+	return ::madvise(const_cast<char*>(begin), length, adv) == 0;
+}
+
+
+std::size_t MappedFileImpl::pageSize()
+{
+	static const std::size_t size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+	return size;
+}
+
+
+std::size_t MappedFileImpl::allocationGranularity()
+{
+	return pageSize();
+}
+
+
+} // namespace Poco
@@ -0,0 +1,148 @@
+//
+// MappedFile_WIN32.cpp
+//
+// Library: Foundation
+// Package: Filesystem
+// Module:  MappedFile
+//
+// Copyright (c) 2007, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/MappedFile_WIN32.h"
+#include "Poco/Exception.h"
+#include "Poco/UnicodeConverter.h"
+
+
+namespace Poco {
+
+
+MappedFileImpl::MappedFileImpl(const std::string& path, UInt64 offset, std::size_t length, bool toEnd):
+	_path(path),
+	_mapAddress(0),
+	_mapSize(0),
+	_address(0),
+	_size(0),
+	_offset(offset),
+	_fileSize(0)
+{
+	std::wstring upath;
+	UnicodeConverter::toUTF16(_path, upath);
+	HANDLE hFile = CreateFileW(upath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (hFile == INVALID_HANDLE_VALUE)
+	{
+		DWORD err = GetLastError();
+		if (err == ERROR_FILE_NOT_FOUND || err == ERROR_PATH_NOT_FOUND)
+			throw FileNotFoundException(_path);
+		else
+			throw OpenFileException("Cannot open file for mapping", _path);
+	}
+
+	LARGE_INTEGER li;
+	if (!GetFileSizeEx(hFile, &li))
+	{
+		CloseHandle(hFile);
+		throw OpenFileException("Cannot map file", _path);
+	}
+	_fileSize = static_cast<UInt64>(li.QuadPart);
+
+	if (_offset > _fileSize) _offset = _fileSize;
+	UInt64 available = _fileSize - _offset;
+	if (toEnd || length > available)
+	{
+		if (available > static_cast<UInt64>(~std::size_t(0)))
+		{
+			CloseHandle(hFile);
+			throw OutOfMemoryException("File too large to be mapped", _path);
+		}
+		length = static_cast<std::size_t>(available);
+	}
+	_size = length;
+
+	if (_size > 0)
+	{
+		HANDLE hMapping = CreateFileMappingW(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (!hMapping)
+		{
+			CloseHandle(hFile);
+			throw SystemException("Cannot create file mapping", _path);
+		}
+		// the file offset of a view must be a multiple of the allocation granularity
+		UInt64 mapOffset = _offset - _offset % allocationGranularity();
+		std::size_t delta = static_cast<std::size_t>(_offset - mapOffset);
+		_mapSize = _size + delta;
+		void* addr = MapViewOfFile(hMapping, FILE_MAP_READ, static_cast<DWORD>(mapOffset >> 32), static_cast<DWORD>(mapOffset & 0xFFFFFFFF), _mapSize);
+		// the view keeps the mapping object and the file open
+		CloseHandle(hMapping);
+		if (!addr)
+		{
+			CloseHandle(hFile);
+			throw SystemException("Cannot map file into memory", _path);
+		}
+		_mapAddress = static_cast<char*>(addr);
+		_address = _mapAddress + delta;
+	}
+	CloseHandle(hFile);
+}
+
+
+MappedFileImpl::~MappedFileImpl()
+{
+	if (_mapAddress)
+	{
+		UnmapViewOfFile(_mapAddress);
+	}
+}
+
+
+bool MappedFileImpl::advise(MappedFile::Advice advice, std::size_t offset, std::size_t length) const
+{
+	if (offset >= _size) return false;
+	if (length > _size - offset) length = _size - offset;
+
+	switch (advice)
+	{
+	case MappedFile::ADVICE_NORMAL:
+	case MappedFile::ADVICE_SEQUENTIAL:
+	case MappedFile::ADVICE_RANDOM:
+		// access pattern hints are not supported for views
+		return false;
+	case MappedFile::ADVICE_WILLNEED:
+#if defined(_WIN32_WINNT) && _WIN32_WINNT >= 0x0602
+		{
+			WIN32_MEMORY_RANGE_ENTRY range;
+			range.VirtualAddress = const_cast<char*>(_address + offset);
+			range.NumberOfBytes = length;
+			return PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0) != 0;
+		}
+#else
+		return false;
+#endif
+	case MappedFile::ADVICE_DONTNEED:
+		return VirtualUnlock(const_cast<char*>(_address + offset), length) != 0 || GetLastError() == ERROR_NOT_LOCKED;
+	default:
+		return false;
+	}
+}
+
+
+std::size_t MappedFileImpl::pageSize()
+{
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return info.dwPageSize;
+}
+
+
+std::size_t MappedFileImpl::allocationGranularity()
+{
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return info.dwAllocationGranularity;
+}
+
+
+} // namespace Poco
@@ -102,4 +102,50 @@ void MemoryPool::release(void* ptr)
 }
 
 
+std::size_t MemoryPool::getBlocks(void** blocks, std::size_t n)
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	std::size_t i = 0;
+	while (i < n && !_blocks.empty())
+	{
+		blocks[i++] = _blocks.back();
+		_blocks.pop_back();
+	}
+	try
+	{
+		while (i < n && (_maxAlloc == 0 || _allocated < _maxAlloc))
+		{
+			blocks[i] = new char[_blockSize];
+			++_allocated;
+			++i;
+		}
+	}
+	catch (...)
+	{
+		if (i == 0) throw;
+	}
+	if (i == 0 && n > 0) throw OutOfMemoryException("MemoryPool exhausted");
+	return i;
+}
+
+
+void MemoryPool::releaseBlocks(void** blocks, std::size_t n)
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		try
+		{
+			_blocks.push_back(reinterpret_cast<char*>(blocks[i]));
+		}
+		catch (...)
+		{
+			delete [] reinterpret_cast<char*>(blocks[i]);
+		}
+	}
+}
+
+
 } // namespace Poco
@@ -386,6 +386,18 @@ double strToDouble(const char* str, const char* inf, const char* nan)
 }
 
 
+bool strToDouble(const char* str, std::size_t length, double& result)
+{
+	using namespace double_conversion;
+	int processed = 0;
+	StringToDoubleConverter converter(StringToDoubleConverter::NO_FLAGS, 0.0, Double::NaN(), POCO_FLT_INF, POCO_FLT_NAN);
+	result = converter.StringToDouble(str, static_cast<int>(length), &processed);
+	return processed == static_cast<int>(length) &&
+		!FPEnvironment::isInfinite(result) &&
+		!FPEnvironment::isNaN(result);
+}
+
+
 bool strToFloat(const std::string& str, float& result, char decSep, char thSep, const char* inf, const char* nan)
 {
 	if (str.empty()) return false;
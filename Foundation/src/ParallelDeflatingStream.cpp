@@ -0,0 +1,441 @@
+//
+// ParallelDeflatingStream.cpp
+//
+// Library: Foundation
+// Package: Streams
+// Module:  ZLibStream
+//
+// Copyright (c) 2004-2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/ParallelDeflatingStream.h"
+#include "Poco/ThreadPool.h"
+#include "Poco/Runnable.h"
+#include "Poco/Event.h"
+#include "Poco/Buffer.h"
+#include "Poco/Checksum32.h"
+#include "Poco/Environment.h"
+#include "Poco/Exception.h"
+#include <cstring>
+
+
+namespace Poco {
+
+
+class ParallelDeflatingStreamBuf::Block: public Runnable
+	/// A block of uncompressed data, together with its
+	/// preset dictionary, compressed as a raw deflate stream
+	/// ending on a byte boundary.
+	///
+	/// The z_stream is kept across blocks to avoid
+	/// the cost of deflateInit2() for every block.
+{
+public:
+	Block(int level):
+		_input(0),
+		_output(0),
+		_checksum(0),
+		_gzip(false),
+		_last(false),
+		_pException(0)
+	{
+		_zstr.zalloc    = Z_NULL;
+		_zstr.zfree     = Z_NULL;
+		_zstr.opaque    = Z_NULL;
+		_zstr.next_in   = 0;
+		_zstr.avail_in  = 0;
+		_zstr.next_out  = 0;
+		_zstr.avail_out = 0;
+
+		int rc = deflateInit2(&_zstr, level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY);
+		if (rc != Z_OK) throw IOException(zError(rc));
+	}
+
+	~Block()
+	{
+		delete _pException;
+		deflateEnd(&_zstr);
+	}
+
+	void assign(const char* buffer, std::size_t length, const std::string& dictionary, bool gzip, bool last)
+	{
+		_input.resize(length, false);
+		if (length > 0) std::memcpy(_input.begin(), buffer, length);
+		_dictionary = dictionary;
+		_gzip = gzip;
+		_last = last;
+		delete _pException;
+		_pException = 0;
+	}
+
+	void run()
+	{
+		try
+		{
+			compress();
+		}
+		catch (Exception& exc)
+		{
+			_pException = exc.clone();
+		}
+		catch (std::exception& exc)
+		{
+			_pException = new IOException(exc.what());
+		}
+		catch (...)
+		{
+			_pException = new IOException("Unknown exception while compressing block");
+		}
+		_done.set();
+	}
+
+	void wait()
+	{
+		_done.wait();
+	}
+
+	void rethrow() const
+	{
+		if (_pException) _pException->rethrow();
+	}
+
+	const char* output() const
+	{
+		return _output.begin();
+	}
+
+	std::size_t outputLength() const
+	{
+		return _output.size();
+	}
+
+	std::size_t inputLength() const
+	{
+		return _input.size();
+	}
+
+	UInt32 checksum() const
+	{
+		return _checksum;
+	}
+
+private:
+	void compress()
+	{
+		int rc = deflateReset(&_zstr);
+		if (rc != Z_OK) throw IOException(zError(rc));
+		if (!_dictionary.empty())
+		{
+			rc = deflateSetDictionary(&_zstr, reinterpret_cast<const Bytef*>(_dictionary.data()), static_cast<uInt>(_dictionary.size()));
+			if (rc != Z_OK) throw IOException(zError(rc));
+		}
+
+		if (_gzip)
+			_checksum = Checksum32::updateCRC32(0, _input.begin(), _input.size());
+		else
+			_checksum = static_cast<UInt32>(adler32(adler32(0, Z_NULL, 0), reinterpret_cast<const Bytef*>(_input.begin()), static_cast<uInt>(_input.size())));
+
+		// leave room for the sync flush marker or the final empty block
+		_output.resize(deflateBound(&_zstr, static_cast<uLong>(_input.size())) + 16, false);
+		_zstr.next_in   = reinterpret_cast<Bytef*>(_input.begin());
+		_zstr.avail_in  = static_cast<uInt>(_input.size());
+		_zstr.next_out  = reinterpret_cast<Bytef*>(_output.begin());
+		_zstr.avail_out = static_cast<uInt>(_output.size());
+		int flush = _last ? Z_FINISH : Z_SYNC_FLUSH;
+		for (;;)
+		{
+			rc = deflate(&_zstr, flush);
+			if (rc != Z_OK && rc != Z_STREAM_END && rc != Z_BUF_ERROR) throw IOException(zError(rc));
+			if (rc == Z_STREAM_END || (!_last && _zstr.avail_in == 0 && _zstr.avail_out != 0)) break;
+
+			std::size_t used = _output.size() - _zstr.avail_out;
+			_output.resize(2*_output.size());
+			_zstr.next_out  = reinterpret_cast<Bytef*>(_output.begin() + used);
+			_zstr.avail_out = static_cast<uInt>(_output.size() - used);
+		}
+		_output.resize(_output.size() - _zstr.avail_out);
+	}
+
+	z_stream     _zstr;
+	Buffer<char> _input;
+	Buffer<char> _output;
+	std::string  _dictionary;
+	UInt32       _checksum;
+	bool         _gzip;
+	bool         _last;
+	Exception*   _pException;
+	Event        _done;
+};
+
+
+ParallelDeflatingStreamBuf::ParallelDeflatingStreamBuf(std::ostream& ostr, DeflatingStreamBuf::StreamType type, int level, std::size_t blockSize, ThreadPool& pool):
+	BufferedStreamBuf(static_cast<std::streamsize>(blockSize), std::ios::out),
+	_pOstr(&ostr),
+	_type(type),
+	_level(level),
+	_pool(pool),
+	_maxPending(2*Environment::processorCount()),
+	_checksum(type == DeflatingStreamBuf::STREAM_GZIP ? 0 : 1),
+	_totalIn(0),
+	_headerWritten(false)
+{
+	if (level < Z_DEFAULT_COMPRESSION || level > Z_BEST_COMPRESSION)
+		throw InvalidArgumentException("Invalid compression level");
+	if (blockSize == 0 || blockSize > 0x40000000)
+		throw InvalidArgumentException("Invalid block size");
+	if (_maxPending < 2) _maxPending = 2;
+}
+
+
+ParallelDeflatingStreamBuf::~ParallelDeflatingStreamBuf()
+{
+	try
+	{
+		close();
+	}
+	catch (...)
+	{
+	}
+	for (std::deque<Block*>::iterator it = _pending.begin(); it != _pending.end(); ++it)
+	{
+		(*it)->wait();
+		delete *it;
+	}
+	for (std::vector<Block*>::iterator it = _idle.begin(); it != _idle.end(); ++it)
+	{
+		delete *it;
+	}
+}
+
+
+int ParallelDeflatingStreamBuf::close()
+{
+	BufferedStreamBuf::sync();
+	if (_pOstr)
+	{
+		submit(0, 0, true);
+		drain();
+		writeTrailer();
+		_pOstr->flush();
+		_pOstr = 0;
+	}
+	return 0;
+}
+
+
+int ParallelDeflatingStreamBuf::sync()
+{
+	if (BufferedStreamBuf::sync())
+		return -1;
+
+	if (_pOstr)
+	{
+		drain();
+	}
+	return 0;
+}
+
+
+int ParallelDeflatingStreamBuf::writeToDevice(const char* buffer, std::streamsize length)
+{
+	if (length == 0 || !_pOstr) return 0;
+
+	submit(buffer, static_cast<std::size_t>(length), false);
+	return static_cast<int>(length);
+}
+
+
+void ParallelDeflatingStreamBuf::submit(const char* buffer, std::size_t length, bool last)
+{
+	if (!_headerWritten) writeHeader();
+
+	Block* pBlock;
+	if (_idle.empty())
+	{
+		pBlock = new Block(_level);
+	}
+	else
+	{
+		pBlock = _idle.back();
+		_idle.pop_back();
+	}
+	try
+	{
+		pBlock->assign(buffer, length, _dictionary, _type == DeflatingStreamBuf::STREAM_GZIP, last);
+		_pending.push_back(pBlock);
+	}
+	catch (...)
+	{
+		delete pBlock;
+		throw;
+	}
+
+	if (length >= DICTIONARY_SIZE)
+	{
+		_dictionary.assign(buffer + length - DICTIONARY_SIZE, DICTIONARY_SIZE);
+	}
+	else if (length > 0)
+	{
+		_dictionary.append(buffer, length);
+		if (_dictionary.size() > DICTIONARY_SIZE)
+			_dictionary.erase(0, _dictionary.size() - DICTIONARY_SIZE);
+	}
+
+	try
+	{
+		_pool.start(*pBlock);
+	}
+	catch (NoThreadAvailableException&)
+	{
+		pBlock->run();
+	}
+	catch (...)
+	{
+		_pending.pop_back();
+		_idle.push_back(pBlock);
+		throw;
+	}
+
+	while (_pending.size() > _maxPending)
+	{
+		writeFront();
+	}
+}
+
+
+void ParallelDeflatingStreamBuf::writeFront()
+{
+	Block* pBlock = _pending.front();
+	pBlock->wait();
+	_pending.pop_front();
+	_idle.push_back(pBlock);
+	pBlock->rethrow();
+
+	_pOstr->write(pBlock->output(), static_cast<std::streamsize>(pBlock->outputLength()));
+	if (!_pOstr->good()) throw IOException("Failed to write compressed data");
+
+	z_off_t length = static_cast<z_off_t>(pBlock->inputLength());
+	if (_type == DeflatingStreamBuf::STREAM_GZIP)
+		_checksum = static_cast<UInt32>(crc32_combine(_checksum, pBlock->checksum(), length));
+	else
+		_checksum = static_cast<UInt32>(adler32_combine(_checksum, pBlock->checksum(), length));
+	_totalIn += pBlock->inputLength();
+}
+
+
+void ParallelDeflatingStreamBuf::drain()
+{
+	while (!_pending.empty())
+	{
+		writeFront();
+	}
+}
+
+
+void ParallelDeflatingStreamBuf::writeHeader()
+{
+	if (_type == DeflatingStreamBuf::STREAM_GZIP)
+	{
+		char header[10] = { '\x1f', '\x8b', 8, 0, 0, 0, 0, 0, 0, '\xff' };
+		if (_level == Z_BEST_COMPRESSION) header[8] = 2;
+		else if (_level == Z_BEST_SPEED) header[8] = 4;
+		_pOstr->write(header, sizeof(header));
+	}
+	else
+	{
+		int levelFlags;
+		if (_level == Z_DEFAULT_COMPRESSION || _level == 6) levelFlags = 2;
+		else if (_level < 2) levelFlags = 0;
+		else if (_level < 6) levelFlags = 1;
+		else levelFlags = 3;
+		unsigned header = (0x78 << 8) | (levelFlags << 6);
+		header += 31 - header % 31;
+		char bytes[2] = { static_cast<char>(header >> 8), static_cast<char>(header & 0xFF) };
+		_pOstr->write(bytes, sizeof(bytes));
+	}
+	if (!_pOstr->good()) throw IOException("Failed to write stream header");
+	_headerWritten = true;
+}
+
+
+void ParallelDeflatingStreamBuf::writeTrailer()
+{
+	char trailer[8];
+	std::streamsize length;
+	if (_type == DeflatingStreamBuf::STREAM_GZIP)
+	{
+		UInt32 size = static_cast<UInt32>(_totalIn);
+		for (int i = 0; i < 4; i++)
+		{
+			trailer[i]     = static_cast<char>((_checksum >> (8*i)) & 0xFF);
+			trailer[i + 4] = static_cast<char>((size >> (8*i)) & 0xFF);
+		}
+		length = 8;
+	}
+	else
+	{
+		for (int i = 0; i < 4; i++)
+		{
+			trailer[i] = static_cast<char>((_checksum >> (24 - 8*i)) & 0xFF);
+		}
+		length = 4;
+	}
+	_pOstr->write(trailer, length);
+	if (!_pOstr->good()) throw IOException("Failed to write stream trailer");
+}
+
+
+ParallelDeflatingIOS::ParallelDeflatingIOS(std::ostream& ostr, DeflatingStreamBuf::StreamType type, int level, std::size_t blockSize, ThreadPool& pool):
+	_buf(ostr, type, level, blockSize, pool)
+{
+	poco_ios_init(&_buf);
+}
+
+
+ParallelDeflatingIOS::~ParallelDeflatingIOS()
+{
+}
+
+
+ParallelDeflatingStreamBuf* ParallelDeflatingIOS::rdbuf()
+{
+	return &_buf;
+}
+
+
+ParallelDeflatingOutputStream::ParallelDeflatingOutputStream(std::ostream& ostr, DeflatingStreamBuf::StreamType type, int level, std::size_t blockSize):
+	std::ostream(&_buf),
+	ParallelDeflatingIOS(ostr, type, level, blockSize, ThreadPool::defaultPool())
+{
+}
+
+
+ParallelDeflatingOutputStream::ParallelDeflatingOutputStream(std::ostream& ostr, ThreadPool& pool, DeflatingStreamBuf::StreamType type, int level, std::size_t blockSize):
+	std::ostream(&_buf),
+	ParallelDeflatingIOS(ostr, type, level, blockSize, pool)
+{
+}
+
+
+ParallelDeflatingOutputStream::~ParallelDeflatingOutputStream()
+{
+}
+
+
+int ParallelDeflatingOutputStream::close()
+{
+	return _buf.close();
+}
+
+
+int ParallelDeflatingOutputStream::sync()
+{
+	return _buf.pubsync();
+}
+
+
+} // namespace Poco
@@ -29,7 +29,51 @@ namespace Poco {
 const int RegularExpression::OVEC_SIZE = 126; // must be multiple of 3
 
 
-RegularExpression::RegularExpression(const std::string& pattern, int options, bool study): _pcre(0), _extra(0)
+// pcre_jit_exec() is available since PCRE 8.32; the bundled
+// PCRE only provides it if built with JIT support.
+#if (defined(POCO_UNBUNDLED) || defined(SUPPORT_JIT)) && (PCRE_MAJOR > 8 || (PCRE_MAJOR == 8 && PCRE_MINOR >= 32))
+#define POCO_PCRE_HAVE_JIT_EXEC
+#endif
+
+
+//
+// RegularExpression::MatchContext
+//
+RegularExpression::MatchContext::MatchContext(int maxJITStackSize):
+	_maxJITStackSize(maxJITStackSize),
+	_pJITStack(0),
+	_ovec(new int[OVEC_SIZE])
+{
+}
+
+
+RegularExpression::MatchContext::~MatchContext()
+{
+#if defined(POCO_PCRE_HAVE_JIT_EXEC)
+	if (_pJITStack) pcre_jit_stack_free(reinterpret_cast<pcre_jit_stack*>(_pJITStack));
+#endif
+	delete [] _ovec;
+}
+
+
+void* RegularExpression::MatchContext::jitStack()
+{
+#if defined(POCO_PCRE_HAVE_JIT_EXEC)
+	if (!_pJITStack)
+	{
+		const int startSize = 32*1024;
+		_pJITStack = pcre_jit_stack_alloc(startSize, _maxJITStackSize < startSize ? startSize : _maxJITStackSize);
+		if (!_pJITStack) throw OutOfMemoryException("cannot allocate JIT stack");
+	}
+#endif
+	return _pJITStack;
+}
+
+
+//
+// RegularExpression
+//
+RegularExpression::RegularExpression(const std::string& pattern, int options, bool study): _pcre(0), _extra(0), _jit(false)
 {
 	const char* error;
 	int offs;
@@ -37,15 +81,24 @@ RegularExpression::RegularExpression(const std::string& pattern, int options, bo
 	unsigned nmentrysz;
 	unsigned char* nmtbl;
 
-	_pcre = pcre_compile(pattern.c_str(), options, &error, &offs, 0);
+	_pcre = pcre_compile(pattern.c_str(), options & ~RE_JIT, &error, &offs, 0);
 	if (!_pcre)
 	{
 		std::ostringstream msg;
 		msg << error << " (at offset " << offs << ")";
 		throw RegularExpressionException(msg.str());
 	}
-	if (study)
+	if (options & RE_JIT)
+	{
+		_extra = pcre_study(reinterpret_cast<pcre*>(_pcre), isJITSupported() ? PCRE_STUDY_JIT_COMPILE : 0, &error);
+		int jit = 0;
+		pcre_fullinfo(reinterpret_cast<const pcre*>(_pcre), reinterpret_cast<const pcre_extra*>(_extra), PCRE_INFO_JIT, &jit);
+		_jit = jit != 0;
+	}
+	else if (study)
+	{
 		_extra = pcre_study(reinterpret_cast<pcre*>(_pcre), 0, &error);
+	}
 
 	pcre_fullinfo(reinterpret_cast<const pcre*>(_pcre), reinterpret_cast<const pcre_extra*>(_extra), PCRE_INFO_NAMECOUNT, &nmcount);
 	pcre_fullinfo(reinterpret_cast<const pcre*>(_pcre), reinterpret_cast<const pcre_extra*>(_extra), PCRE_INFO_NAMEENTRYSIZE, &nmentrysz);
@@ -63,20 +116,23 @@ RegularExpression::RegularExpression(const std::string& pattern, int options, bo
 RegularExpression::~RegularExpression()
 {
 	if (_pcre)  pcre_free(reinterpret_cast<pcre*>(_pcre));
-	if (_extra) pcre_free(reinterpret_cast<struct pcre_extra*>(_extra));
+	if (_extra) pcre_free_study(reinterpret_cast<struct pcre_extra*>(_extra));
 }
 
 
-int RegularExpression::match(const std::string& subject, std::string::size_type offset, Match& mtch, int options) const
+int RegularExpression::exec(const std::string& subject, std::string::size_type offset, int* ovec, int options, MatchContext* pContext) const
 {
-	poco_assert (offset <= subject.length());
-
-	int ovec[OVEC_SIZE];
-	int rc = pcre_exec(reinterpret_cast<pcre*>(_pcre), reinterpret_cast<struct pcre_extra*>(_extra), subject.c_str(), int(subject.size()), int(offset), options & 0xFFFF, ovec, OVEC_SIZE);
+	int rc;
+#if defined(POCO_PCRE_HAVE_JIT_EXEC)
+	if (_jit && pContext)
+		rc = pcre_jit_exec(reinterpret_cast<pcre*>(_pcre), reinterpret_cast<struct pcre_extra*>(_extra), subject.c_str(), int(subject.size()), int(offset), options & 0xFFFF, ovec, OVEC_SIZE, reinterpret_cast<pcre_jit_stack*>(pContext->jitStack()));
+	else
+#else
+	(void) pContext;
+#endif
+		rc = pcre_exec(reinterpret_cast<pcre*>(_pcre), reinterpret_cast<struct pcre_extra*>(_extra), subject.c_str(), int(subject.size()), int(offset), options & 0xFFFF, ovec, OVEC_SIZE);
 	if (rc == PCRE_ERROR_NOMATCH)
 	{
-		mtch.offset = std::string::npos;
-		mtch.length = 0;
 		return 0;
 	}
 	else if (rc == PCRE_ERROR_BADOPTION)
@@ -93,6 +149,40 @@ int RegularExpression::match(const std::string& subject, std::string::size_type
 		msg << "PCRE error " << rc;
 		throw RegularExpressionException(msg.str());
 	}
+	return rc;
+}
+
+
+int RegularExpression::match(const std::string& subject, std::string::size_type offset, Match& mtch, int options) const
+{
+	poco_assert (offset <= subject.length());
+
+	int ovec[OVEC_SIZE];
+	int rc = exec(subject, offset, ovec, options, 0);
+	if (rc == 0)
+	{
+		mtch.offset = std::string::npos;
+		mtch.length = 0;
+		return 0;
+	}
+	mtch.offset = ovec[0] < 0 ? std::string::npos : ovec[0];
+	mtch.length = ovec[1] - mtch.offset;
+	return rc;
+}
+
+
+int RegularExpression::match(const std::string& subject, std::string::size_type offset, Match& mtch, MatchContext& context, int options) const
+{
+	poco_assert (offset <= subject.length());
+
+	int* ovec = context._ovec;
+	int rc = exec(subject, offset, ovec, options, &context);
+	if (rc == 0)
+	{
+		mtch.offset = std::string::npos;
+		mtch.length = 0;
+		return 0;
+	}
 	mtch.offset = ovec[0] < 0 ? std::string::npos : ovec[0];
 	mtch.length = ovec[1] - mtch.offset;
 	return rc;
@@ -106,25 +196,11 @@ int RegularExpression::match(const std::string& subject, std::string::size_type
 	matches.clear();
 
 	int ovec[OVEC_SIZE];
-	int rc = pcre_exec(reinterpret_cast<pcre*>(_pcre), reinterpret_cast<struct pcre_extra*>(_extra), subject.c_str(), int(subject.size()), int(offset), options & 0xFFFF, ovec, OVEC_SIZE);
-	if (rc == PCRE_ERROR_NOMATCH)
+	int rc = exec(subject, offset, ovec, options, 0);
+	if (rc == 0)
 	{
 		return 0;
 	}
-	else if (rc == PCRE_ERROR_BADOPTION)
-	{
-		throw RegularExpressionException("bad option");
-	}
-	else if (rc == 0)
-	{
-		throw RegularExpressionException("too many captured substrings");
-	}
-	else if (rc < 0)
-	{
-		std::ostringstream msg;
-		msg << "PCRE error " << rc;
-		throw RegularExpressionException(msg.str());
-	}
 	matches.reserve(rc);
 	for (int i = 0; i < rc; ++i)
 	{
@@ -146,6 +222,31 @@ int RegularExpression::match(const std::string& subject, std::string::size_type
 }
 
 
+int RegularExpression::match(const std::string& subject, std::string::size_type offset, MatchVec& matches, MatchContext& context, int options) const
+{
+	poco_assert (offset <= subject.length());
+
+	int* ovec = context._ovec;
+	int rc = exec(subject, offset, ovec, options, &context);
+
+	// reuse the existing Match objects, including their name strings
+	matches.resize(rc);
+	for (int i = 0; i < rc; ++i)
+	{
+		Match& m = matches[i];
+		m.offset = ovec[i*2] < 0 ? std::string::npos : ovec[i*2];
+		m.length = ovec[i*2 + 1] - m.offset;
+
+		GroupMap::const_iterator it = _groups.find(i);
+		if (it != _groups.end())
+			m.name = it->second;
+		else
+			m.name.clear();
+	}
+	return rc;
+}
+
+
 bool RegularExpression::match(const std::string& subject, std::string::size_type offset) const
 {
 	Match mtch;
@@ -228,25 +329,11 @@ std::string::size_type RegularExpression::substOne(std::string& subject, std::st
 	if (offset >= subject.length()) return std::string::npos;
 
 	int ovec[OVEC_SIZE];
-	int rc = pcre_exec(reinterpret_cast<pcre*>(_pcre), reinterpret_cast<struct pcre_extra*>(_extra), subject.c_str(), int(subject.size()), int(offset), options & 0xFFFF, ovec, OVEC_SIZE);
-	if (rc == PCRE_ERROR_NOMATCH)
+	int rc = exec(subject, offset, ovec, options, 0);
+	if (rc == 0)
 	{
 		return std::string::npos;
 	}
-	else if (rc == PCRE_ERROR_BADOPTION)
-	{
-		throw RegularExpressionException("bad option");
-	}
-	else if (rc == 0)
-	{
-		throw RegularExpressionException("too many captured substrings");
-	}
-	else if (rc < 0)
-	{
-		std::ostringstream msg;
-		msg << "PCRE error " << rc;
-		throw RegularExpressionException(msg.str());
-	}
 	std::string result;
 	std::string::size_type len = subject.length();
 	std::string::size_type pos = 0;
@@ -305,4 +392,12 @@ bool RegularExpression::match(const std::string& subject, const std::string& pat
 }
 
 
+bool RegularExpression::isJITSupported()
+{
+	int jit = 0;
+	pcre_config(PCRE_CONFIG_JIT, &jit);
+	return jit != 0;
+}
+
+
 } // namespace Poco
@@ -17,7 +17,11 @@
 
 #include "Poco/SHA1Engine.h"
 #include "Poco/ByteOrder.h"
+#include "Poco/CPUFeatures.h"
 #include <cstring>
+#if defined(POCO_HAVE_X86_INTRINSICS)
+#include <immintrin.h>
+#endif
 
 
 #ifdef POCO_ARCH_LITTLE_ENDIAN
@@ -30,6 +34,86 @@
 namespace Poco {
 
 
+#if defined(POCO_HAVE_X86_INTRINSICS)
+
+
+namespace
+{
+	//
+	// SHA-1 using the SHA extensions, processing four rounds per
+	// SHA1RNDS4 instruction. Each SHA1_ROUNDS4 step consumes message
+	// words cur, and advances the message schedule for the words
+	// needed in later steps.
+	//
+	#define SHA1_ROUNDS4(i, f, ecur, eoth, cur, next, nnext, prev) \
+	{ \
+		if (i == 0) ecur = _mm_add_epi32(ecur, cur); \
+		else ecur = _mm_sha1nexte_epu32(ecur, cur); \
+		eoth = abcd; \
+		if (i >= 3 && i <= 18) next = _mm_sha1msg2_epu32(next, cur); \
+		abcd = _mm_sha1rnds4_epu32(abcd, ecur, f); \
+		if (i >= 1 && i <= 16) prev = _mm_sha1msg1_epu32(prev, cur); \
+		if (i >= 2 && i <= 17) nnext = _mm_xor_si128(nnext, cur); \
+	}
+
+
+	POCO_TARGET("sha,sse4.1,ssse3")
+	void sha1BlocksNI(UInt32 state[5], const UInt8* data, std::size_t blocks)
+	{
+		const __m128i mask = _mm_set_epi64x(0x0001020304050607LL, 0x08090a0b0c0d0e0fLL);
+
+		__m128i abcd = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state)), 0x1B);
+		__m128i e0 = _mm_set_epi32(static_cast<int>(state[4]), 0, 0, 0);
+		__m128i e1;
+
+		while (blocks-- > 0)
+		{
+			__m128i abcdSave = abcd;
+			__m128i e0Save = e0;
+
+			__m128i m0 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)), mask);
+			__m128i m1 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16)), mask);
+			__m128i m2 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 32)), mask);
+			__m128i m3 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 48)), mask);
+
+			SHA1_ROUNDS4( 0, 0, e0, e1, m0, m1, m2, m3);
+			SHA1_ROUNDS4( 1, 0, e1, e0, m1, m2, m3, m0);
+			SHA1_ROUNDS4( 2, 0, e0, e1, m2, m3, m0, m1);
+			SHA1_ROUNDS4( 3, 0, e1, e0, m3, m0, m1, m2);
+			SHA1_ROUNDS4( 4, 0, e0, e1, m0, m1, m2, m3);
+			SHA1_ROUNDS4( 5, 1, e1, e0, m1, m2, m3, m0);
+			SHA1_ROUNDS4( 6, 1, e0, e1, m2, m3, m0, m1);
+			SHA1_ROUNDS4( 7, 1, e1, e0, m3, m0, m1, m2);
+			SHA1_ROUNDS4( 8, 1, e0, e1, m0, m1, m2, m3);
+			SHA1_ROUNDS4( 9, 1, e1, e0, m1, m2, m3, m0);
+			SHA1_ROUNDS4(10, 2, e0, e1, m2, m3, m0, m1);
+			SHA1_ROUNDS4(11, 2, e1, e0, m3, m0, m1, m2);
+			SHA1_ROUNDS4(12, 2, e0, e1, m0, m1, m2, m3);
+			SHA1_ROUNDS4(13, 2, e1, e0, m1, m2, m3, m0);
+			SHA1_ROUNDS4(14, 2, e0, e1, m2, m3, m0, m1);
+			SHA1_ROUNDS4(15, 3, e1, e0, m3, m0, m1, m2);
+			SHA1_ROUNDS4(16, 3, e0, e1, m0, m1, m2, m3);
+			SHA1_ROUNDS4(17, 3, e1, e0, m1, m2, m3, m0);
+			SHA1_ROUNDS4(18, 3, e0, e1, m2, m3, m0, m1);
+			SHA1_ROUNDS4(19, 3, e1, e0, m3, m0, m1, m2);
+
+			e0 = _mm_sha1nexte_epu32(e0, e0Save);
+			abcd = _mm_add_epi32(abcd, abcdSave);
+			data += 64;
+		}
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(state), _mm_shuffle_epi32(abcd, 0x1B));
+		state[4] = static_cast<UInt32>(_mm_extract_epi32(e0, 3));
+	}
+
+
+	#undef SHA1_ROUNDS4
+}
+
+
+#endif // POCO_HAVE_X86_INTRINSICS
+
+
 SHA1Engine::SHA1Engine()
 {
 	_digest.reserve(16);
@@ -66,17 +150,48 @@ void SHA1Engine::updateImpl(const void* buffer_, std::size_t count)
 	_context.countLo += ((UInt32) count << 3);
 	_context.countHi += ((UInt32 ) count >> 29);
 
-	/* Process data in BLOCK_SIZE chunks */
-	while (count-- > 0)
+	/* Complete a partially filled block */
+	if (_context.slop > 0)
 	{
-		db[_context.slop++] = *(buffer++);
-		if (_context.slop == BLOCK_SIZE)
-		{
-			/* transform this one block */
-			SHA1_BYTE_REVERSE(_context.data, BLOCK_SIZE);
-			transform();
-			_context.slop = 0 ;	/* no slop left */
-		}
+		std::size_t n = BLOCK_SIZE - _context.slop;
+		if (n > count) n = count;
+		std::memcpy(db + _context.slop, buffer, n);
+		_context.slop += static_cast<UInt32>(n);
+		buffer += n;
+		count  -= n;
+		if (_context.slop < BLOCK_SIZE) return;
+		processBlocks(db, 1);
+		_context.slop = 0;
+	}
+
+	/* Process complete blocks directly from the input */
+	std::size_t blocks = count/BLOCK_SIZE;
+	processBlocks(buffer, blocks);
+	buffer += blocks*BLOCK_SIZE;
+	count  -= blocks*BLOCK_SIZE;
+
+	/* Save the remaining bytes */
+	std::memcpy(db, buffer, count);
+	_context.slop = static_cast<UInt32>(count);
+}
+
+
+void SHA1Engine::processBlocks(const BYTE* data, std::size_t blocks)
+{
+#if defined(POCO_HAVE_X86_INTRINSICS)
+	if (blocks > 0 && CPUFeatures::hasSHA())
+	{
+		sha1BlocksNI(_context.digest, data, blocks);
+		return;
+	}
+#endif
+	while (blocks-- > 0)
+	{
+		if (data != reinterpret_cast<const BYTE*>(_context.data))
+			std::memcpy(_context.data, data, BLOCK_SIZE);
+		SHA1_BYTE_REVERSE(_context.data, BLOCK_SIZE);
+		transform();
+		data += BLOCK_SIZE;
 	}
 }
 
@@ -20,7 +20,17 @@
 //
 
 #include "Poco/SHA2Engine.h"
+#include "Poco/CPUFeatures.h"
 #include <string.h>
+#include <vector>
+#include <algorithm>
+#if defined(POCO_HAVE_X86_INTRINSICS)
+#include <immintrin.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define POCO_SHA2_SSE2
+#endif
 
 namespace Poco {
 
@@ -58,6 +68,16 @@ static const Poco::UInt32 K32[] =
 	0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208,
 	0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2,
 };
+static const Poco::UInt32 H224[8] =
+{
+	0xC1059ED8, 0x367CD507, 0x3070DD17, 0xF70E5939,
+	0xFFC00B31, 0x68581511, 0x64F98FA7, 0xBEFA4FA4
+};
+static const Poco::UInt32 H256[8] =
+{
+	0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A,
+	0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19
+};
 #if defined(_MSC_VER) || defined(__WATCOMC__)
 #define UL64(x) x##ui64
 #else
@@ -238,7 +258,6 @@ SHA2Engine::SHA2Engine(ALGORITHM algorithm)
 
 SHA2Engine::~SHA2Engine()
 {
-	reset();
 	free(_context);
 }
 
@@ -273,6 +292,98 @@ void _sha256_process(HASHCONTEXT* pContext, const unsigned char data[64])
 	for (i = 0; i < 8; i++) pContext->state.state32[i] += temp3[i];
 }
 
+#if defined(POCO_HAVE_X86_INTRINSICS)
+
+//
+// SHA-256 using the SHA extensions. Each SHA256_ROUNDS4 step performs
+// four rounds (two SHA256RNDS2 instructions) using message words cur,
+// and advances the message schedule for the words needed later.
+//
+#define SHA256_ROUNDS4(i, cur, next, prev)                                                 \
+{                                                                                          \
+	msg = _mm_add_epi32(cur, _mm_loadu_si128(reinterpret_cast<const __m128i*>(K32 + 4*i))); \
+	state1 = _mm_sha256rnds2_epu32(state1, state0, msg);                                   \
+	if (i >= 3 && i <= 14)                                                                 \
+	{                                                                                      \
+		next = _mm_add_epi32(next, _mm_alignr_epi8(cur, prev, 4));                         \
+		next = _mm_sha256msg2_epu32(next, cur);                                            \
+	}                                                                                      \
+	msg = _mm_shuffle_epi32(msg, 0x0E);                                                    \
+	state0 = _mm_sha256rnds2_epu32(state0, state1, msg);                                   \
+	if (i >= 1 && i <= 12) prev = _mm_sha256msg1_epu32(prev, cur);                         \
+}
+
+POCO_TARGET("sha,sse4.1,ssse3")
+static void _sha256_process_ni(Poco::UInt32 state[8], const unsigned char* data, size_t blocks)
+{
+	const __m128i mask = _mm_set_epi64x(0x0c0d0e0f08090a0bLL, 0x0405060700010203LL);
+
+	__m128i tmp    = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state)), 0xB1);     // CDAB
+	__m128i state1 = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state + 4)), 0x1B); // EFGH
+	__m128i state0 = _mm_alignr_epi8(tmp, state1, 8);    // ABEF
+	state1 = _mm_blend_epi16(state1, tmp, 0xF0);         // CDGH
+	__m128i msg;
+
+	while (blocks-- > 0)
+	{
+		__m128i abefSave = state0;
+		__m128i cdghSave = state1;
+
+		__m128i m0 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)), mask);
+		__m128i m1 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16)), mask);
+		__m128i m2 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 32)), mask);
+		__m128i m3 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 48)), mask);
+
+		SHA256_ROUNDS4( 0, m0, m1, m3);
+		SHA256_ROUNDS4( 1, m1, m2, m0);
+		SHA256_ROUNDS4( 2, m2, m3, m1);
+		SHA256_ROUNDS4( 3, m3, m0, m2);
+		SHA256_ROUNDS4( 4, m0, m1, m3);
+		SHA256_ROUNDS4( 5, m1, m2, m0);
+		SHA256_ROUNDS4( 6, m2, m3, m1);
+		SHA256_ROUNDS4( 7, m3, m0, m2);
+		SHA256_ROUNDS4( 8, m0, m1, m3);
+		SHA256_ROUNDS4( 9, m1, m2, m0);
+		SHA256_ROUNDS4(10, m2, m3, m1);
+		SHA256_ROUNDS4(11, m3, m0, m2);
+		SHA256_ROUNDS4(12, m0, m1, m3);
+		SHA256_ROUNDS4(13, m1, m2, m0);
+		SHA256_ROUNDS4(14, m2, m3, m1);
+		SHA256_ROUNDS4(15, m3, m0, m2);
+
+		state0 = _mm_add_epi32(state0, abefSave);
+		state1 = _mm_add_epi32(state1, cdghSave);
+		data += 64;
+	}
+
+	tmp    = _mm_shuffle_epi32(state0, 0x1B);    // FEBA
+	state1 = _mm_shuffle_epi32(state1, 0xB1);    // DCHG
+	state0 = _mm_blend_epi16(tmp, state1, 0xF0); // DCBA
+	state1 = _mm_alignr_epi8(state1, tmp, 8);    // ABEF
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(state), state0);
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(state + 4), state1);
+}
+
+#undef SHA256_ROUNDS4
+
+#endif // POCO_HAVE_X86_INTRINSICS
+
+static void _sha256_process_blocks(HASHCONTEXT* pContext, const unsigned char* data, size_t blocks)
+{
+#if defined(POCO_HAVE_X86_INTRINSICS)
+	if (blocks > 0 && CPUFeatures::hasSHA())
+	{
+		_sha256_process_ni(pContext->state.state32, data, blocks);
+		return;
+	}
+#endif
+	while (blocks-- > 0)
+	{
+		_sha256_process(pContext, data);
+		data += 64;
+	}
+}
+
 void _sha512_process(HASHCONTEXT* pContext, const unsigned char data[128])
 {
 	int i;
@@ -332,17 +443,14 @@ void SHA2Engine::updateImpl(const void* buffer_, std::size_t count)
 		if (left && count >= fill)
 		{
 			memcpy((void *)(pContext->buffer + left), data, fill);
-			_sha256_process(pContext, pContext->buffer);
+			_sha256_process_blocks(pContext, pContext->buffer, 1);
 			data += fill;
 			count -= fill;
 			left = 0;
 		}
-		while (count >= 64)
-		{
-			_sha256_process(pContext, data);
-			data += 64;
-			count -= 64;
-		}
+		_sha256_process_blocks(pContext, data, count/64);
+		data += count & ~size_t(63);
+		count &= 63;
 	}
 	if (count > 0) memcpy((void *)(pContext->buffer + left), data, count);
 }
@@ -354,31 +462,18 @@ std::size_t SHA2Engine::digestLength() const
 
 void SHA2Engine::reset()
 {
-	if (_context != NULL) free(_context);
-	_context = calloc(1, sizeof(HASHCONTEXT));
+	// the context is reused, as reset() is called after every digest()
+	if (_context == NULL) _context = malloc(sizeof(HASHCONTEXT));
+	memset(_context, 0, sizeof(HASHCONTEXT));
 	HASHCONTEXT* pContext = (HASHCONTEXT*)_context;
 	pContext->size = _algorithm;
 	if (_algorithm == SHA_224)
 	{
-		pContext->state.state32[0] = 0xC1059ED8;
-		pContext->state.state32[1] = 0x367CD507;
-		pContext->state.state32[2] = 0x3070DD17;
-		pContext->state.state32[3] = 0xF70E5939;
-		pContext->state.state32[4] = 0xFFC00B31;
-		pContext->state.state32[5] = 0x68581511;
-		pContext->state.state32[6] = 0x64F98FA7;
-		pContext->state.state32[7] = 0xBEFA4FA4;
+		memcpy(pContext->state.state32, H224, sizeof(H224));
 	}
 	else if (_algorithm == SHA_256)
 	{
-		pContext->state.state32[0] = 0x6A09E667;
-		pContext->state.state32[1] = 0xBB67AE85;
-		pContext->state.state32[2] = 0x3C6EF372;
-		pContext->state.state32[3] = 0xA54FF53A;
-		pContext->state.state32[4] = 0x510E527F;
-		pContext->state.state32[5] = 0x9B05688C;
-		pContext->state.state32[6] = 0x1F83D9AB;
-		pContext->state.state32[7] = 0x5BE0CD19;
+		memcpy(pContext->state.state32, H256, sizeof(H256));
 	}
 	else if (_algorithm == SHA_384)
 	{
@@ -460,4 +555,162 @@ const DigestEngine::Digest& SHA2Engine::digest()
 	return _digest;
 }
 
+#if defined(POCO_SHA2_SSE2)
+
+static inline __m128i _sha256x4_rotr(__m128i x, int n)
+{
+	return _mm_or_si128(_mm_srli_epi32(x, n), _mm_slli_epi32(x, 32 - n));
+}
+
+struct SHA256Lane
+{
+	const unsigned char* data;
+	size_t length;
+	size_t blocks;
+};
+
+static const unsigned char* _sha256x4_block(const SHA256Lane& lane, size_t block, unsigned char tmp[64])
+	/// Returns the given block of the padded message.
+{
+	size_t start = block*64;
+	if (start + 64 <= lane.length) return lane.data + start;
+	memset(tmp, 0, 64);
+	if (start <= lane.length)
+	{
+		memcpy(tmp, lane.data + start, lane.length - start);
+		tmp[lane.length - start] = 0x80;
+	}
+	if (block == lane.blocks - 1)
+	{
+		Poco::UInt64 bits = (Poco::UInt64)lane.length << 3;
+		PUT_UINT32((Poco::UInt32)(bits >> 32), tmp, 56);
+		PUT_UINT32((Poco::UInt32)bits, tmp, 60);
+	}
+	return tmp;
+}
+
+static void _sha256x4_process(const SHA256Lane lanes[4], const Poco::UInt32 init[8], Poco::UInt32 result[4][8])
+	/// Computes the SHA-224/256 state for four messages in parallel.
+	/// Each 32-bit lane of the SSE2 registers holds one message.
+	/// Lanes with fewer blocks than others are masked out once done.
+{
+	static const unsigned char zero[64] = { 0 };
+	unsigned char tmp[4][64];
+	__m128i state[8];
+	for (int i = 0; i < 8; i++) state[i] = _mm_set1_epi32((int)init[i]);
+
+	size_t maxBlocks = std::max(std::max(lanes[0].blocks, lanes[1].blocks), std::max(lanes[2].blocks, lanes[3].blocks));
+	for (size_t block = 0; block < maxBlocks; block++)
+	{
+		const unsigned char* p[4];
+		Poco::UInt32 active[4];
+		for (int l = 0; l < 4; l++)
+		{
+			bool isActive = block < lanes[l].blocks;
+			p[l] = isActive ? _sha256x4_block(lanes[l], block, tmp[l]) : zero;
+			active[l] = isActive ? 0xFFFFFFFF : 0;
+		}
+
+		__m128i W[16];
+		for (int t = 0; t < 16; t++)
+		{
+			Poco::UInt32 w[4];
+			for (int l = 0; l < 4; l++) GET_UINT32(w[l], p[l], 4*t);
+			W[t] = _mm_set_epi32((int)w[3], (int)w[2], (int)w[1], (int)w[0]);
+		}
+
+		__m128i a = state[0], b = state[1], c = state[2], d = state[3];
+		__m128i e = state[4], f = state[5], g = state[6], h = state[7];
+		for (int t = 0; t < 64; t++)
+		{
+			if (t >= 16)
+			{
+				__m128i w2  = W[(t - 2) & 15];
+				__m128i w15 = W[(t - 15) & 15];
+				__m128i s1 = _mm_xor_si128(_mm_xor_si128(_sha256x4_rotr(w2, 17), _sha256x4_rotr(w2, 19)), _mm_srli_epi32(w2, 10));
+				__m128i s0 = _mm_xor_si128(_mm_xor_si128(_sha256x4_rotr(w15, 7), _sha256x4_rotr(w15, 18)), _mm_srli_epi32(w15, 3));
+				W[t & 15] = _mm_add_epi32(_mm_add_epi32(W[t & 15], s0), _mm_add_epi32(W[(t - 7) & 15], s1));
+			}
+			__m128i S1 = _mm_xor_si128(_mm_xor_si128(_sha256x4_rotr(e, 6), _sha256x4_rotr(e, 11)), _sha256x4_rotr(e, 25));
+			__m128i ch = _mm_xor_si128(_mm_and_si128(e, f), _mm_andnot_si128(e, g));
+			__m128i temp1 = _mm_add_epi32(_mm_add_epi32(h, S1), _mm_add_epi32(ch, _mm_add_epi32(_mm_set1_epi32((int)K32[t]), W[t & 15])));
+			__m128i S0 = _mm_xor_si128(_mm_xor_si128(_sha256x4_rotr(a, 2), _sha256x4_rotr(a, 13)), _sha256x4_rotr(a, 22));
+			__m128i maj = _mm_or_si128(_mm_and_si128(a, b), _mm_and_si128(c, _mm_or_si128(a, b)));
+			__m128i temp2 = _mm_add_epi32(S0, maj);
+			h = g; g = f; f = e;
+			e = _mm_add_epi32(d, temp1);
+			d = c; c = b; b = a;
+			a = _mm_add_epi32(temp1, temp2);
+		}
+
+		__m128i mask = _mm_set_epi32((int)active[3], (int)active[2], (int)active[1], (int)active[0]);
+		__m128i vars[8] = { a, b, c, d, e, f, g, h };
+		for (int i = 0; i < 8; i++)
+		{
+			state[i] = _mm_add_epi32(state[i], _mm_and_si128(vars[i], mask));
+		}
+	}
+
+	for (int i = 0; i < 8; i++)
+	{
+		Poco::UInt32 v[4];
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(v), state[i]);
+		for (int l = 0; l < 4; l++) result[l][i] = v[l];
+	}
+}
+
+#endif // POCO_SHA2_SSE2
+
+void SHA2Engine::digestMultiple(ALGORITHM algorithm, std::size_t count, const void* const* data, const std::size_t* lengths, DigestEngine::Digest* digests)
+{
+#if defined(POCO_SHA2_SSE2)
+	if ((algorithm == SHA_224 || algorithm == SHA_256) && !CPUFeatures::hasSHA())
+	{
+		// group messages of similar length, so that lanes are busy equally long
+		std::vector<std::size_t> order(count);
+		for (std::size_t i = 0; i < count; i++) order[i] = i;
+		std::sort(order.begin(), order.end(), [lengths](std::size_t i1, std::size_t i2) { return lengths[i1] < lengths[i2]; });
+
+		const Poco::UInt32* init = algorithm == SHA_224 ? H224 : H256;
+		std::size_t digestLength = algorithm/8;
+		for (std::size_t i = 0; i < count; i += 4)
+		{
+			SHA256Lane lanes[4];
+			for (std::size_t l = 0; l < 4; l++)
+			{
+				if (i + l < count)
+				{
+					lanes[l].data   = static_cast<const unsigned char*>(data[order[i + l]]);
+					lanes[l].length = lengths[order[i + l]];
+					lanes[l].blocks = (lanes[l].length + 8)/64 + 1;
+				}
+				else
+				{
+					lanes[l].data   = 0;
+					lanes[l].length = 0;
+					lanes[l].blocks = 0;
+				}
+			}
+			Poco::UInt32 result[4][8];
+			_sha256x4_process(lanes, init, result);
+			for (std::size_t l = 0; l < 4 && i + l < count; l++)
+			{
+				unsigned char hash[32];
+				for (int w = 0; w < 8; w++) PUT_UINT32(result[l][w], hash, 4*w);
+				DigestEngine::Digest& digest = digests[order[i + l]];
+				digest.assign(hash, hash + digestLength);
+			}
+		}
+		return;
+	}
+#endif
+
+	SHA2Engine engine(algorithm);
+	for (std::size_t i = 0; i < count; i++)
+	{
+		engine.update(data[i], lengths[i]);
+		digests[i] = engine.digest();
+	}
+}
+
 } // namespace Poco
@@ -13,18 +13,53 @@
 
 
 #include "Poco/StreamCopier.h"
+#include "Poco/FileStream.h"
 #include "Poco/Buffer.h"
+#if defined(POCO_OS_FAMILY_WINDOWS)
+#include "Poco/UnWindows.h"
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#endif
+#if POCO_OS == POCO_OS_LINUX || POCO_OS == POCO_OS_ANDROID
+#include <sys/sendfile.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+
+namespace
+{
+	bool isRegularFile(Poco::FileStreamBuf* pBuf)
+		/// Returns true if the stream buffer reads from a regular file.
+		/// Seeking in other files (like pipes) would discard buffered data.
+	{
+#if defined(POCO_OS_FAMILY_WINDOWS)
+		return pBuf->nativeHandle() != INVALID_HANDLE_VALUE && GetFileType(pBuf->nativeHandle()) == FILE_TYPE_DISK;
+#else
+		struct stat st;
+		return pBuf->nativeHandle() != -1 && ::fstat(pBuf->nativeHandle(), &st) == 0 && S_ISREG(st.st_mode);
+#endif
+	}
+}
 
 
 namespace Poco {
 
 
-std::streamsize StreamCopier::copyStream(std::istream& istr, std::ostream& ostr, std::size_t bufferSize)
+template <typename T>
+T StreamCopier::copyStreamImpl(std::istream& istr, std::ostream& ostr, std::size_t bufferSize)
 {
 	poco_assert (bufferSize > 0);
 
+	Poco::UInt64 copied = 0;
+	if (copyFile(istr, ostr, copied)) return static_cast<T>(copied);
+
+	Poco::UInt64 remaining;
+	bufferSize = fileBufferSize(istr, bufferSize, remaining);
 	Buffer<char> buffer(bufferSize);
-	std::streamsize len = 0;
+	T len = static_cast<T>(copied);
 	istr.read(buffer.begin(), bufferSize);
 	std::streamsize n = istr.gcount();
 	while (n > 0)
@@ -42,20 +77,25 @@ std::streamsize StreamCopier::copyStream(std::istream& istr, std::ostream& ostr,
 }
 
 
-#if defined(POCO_HAVE_INT64)
-Poco::UInt64 StreamCopier::copyStream64(std::istream& istr, std::ostream& ostr, std::size_t bufferSize)
+template <typename T>
+T StreamCopier::copyToStringImpl(std::istream& istr, std::string& str, std::size_t bufferSize)
 {
 	poco_assert (bufferSize > 0);
 
+	Poco::UInt64 remaining = 0;
+	bufferSize = fileBufferSize(istr, bufferSize, remaining);
+	if (remaining > 0 && remaining < str.max_size() - str.size())
+		str.reserve(str.size() + static_cast<std::string::size_type>(remaining));
+
 	Buffer<char> buffer(bufferSize);
-	Poco::UInt64 len = 0;
+	T len = 0;
 	istr.read(buffer.begin(), bufferSize);
 	std::streamsize n = istr.gcount();
 	while (n > 0)
 	{
 		len += n;
-		ostr.write(buffer.begin(), n);
-		if (istr && ostr)
+		str.append(buffer.begin(), static_cast<std::string::size_type>(n));
+		if (istr)
 		{
 			istr.read(buffer.begin(), bufferSize);
 			n = istr.gcount();
@@ -64,53 +104,32 @@ Poco::UInt64 StreamCopier::copyStream64(std::istream& istr, std::ostream& ostr,
 	}
 	return len;
 }
+
+
+std::streamsize StreamCopier::copyStream(std::istream& istr, std::ostream& ostr, std::size_t bufferSize)
+{
+	return copyStreamImpl<std::streamsize>(istr, ostr, bufferSize);
+}
+
+
+#if defined(POCO_HAVE_INT64)
+Poco::UInt64 StreamCopier::copyStream64(std::istream& istr, std::ostream& ostr, std::size_t bufferSize)
+{
+	return copyStreamImpl<Poco::UInt64>(istr, ostr, bufferSize);
+}
 #endif
 
 
 std::streamsize StreamCopier::copyToString(std::istream& istr, std::string& str, std::size_t bufferSize)
 {
-	poco_assert (bufferSize > 0);
-
-	Buffer<char> buffer(bufferSize);
-	std::streamsize len = 0;
-	istr.read(buffer.begin(), bufferSize);
-	std::streamsize n = istr.gcount();
-	while (n > 0)
-	{
-		len += n;
-		str.append(buffer.begin(), static_cast<std::string::size_type>(n));
-		if (istr)
-		{
-			istr.read(buffer.begin(), bufferSize);
-			n = istr.gcount();
-		}
-		else n = 0;
-	}
-	return len;
+	return copyToStringImpl<std::streamsize>(istr, str, bufferSize);
 }
 
 
 #if defined(POCO_HAVE_INT64)
 Poco::UInt64 StreamCopier::copyToString64(std::istream& istr, std::string& str, std::size_t bufferSize)
 {
-	poco_assert (bufferSize > 0);
-
-	Buffer<char> buffer(bufferSize);
-	Poco::UInt64 len = 0;
-	istr.read(buffer.begin(), bufferSize);
-	std::streamsize n = istr.gcount();
-	while (n > 0)
-	{
-		len += n;
-		str.append(buffer.begin(), static_cast<std::string::size_type>(n));
-		if (istr)
-		{
-			istr.read(buffer.begin(), bufferSize);
-			n = istr.gcount();
-		}
-		else n = 0;
-	}
-	return len;
+	return copyToStringImpl<Poco::UInt64>(istr, str, bufferSize);
 }
 #endif
 
@@ -146,5 +165,97 @@ Poco::UInt64 StreamCopier::copyStreamUnbuffered64(std::istream& istr, std::ostre
 }
 #endif
 
+bool StreamCopier::copyFile(std::istream& istr, std::ostream& ostr, Poco::UInt64& count)
+{
+#if POCO_OS == POCO_OS_LINUX || POCO_OS == POCO_OS_ANDROID
+	FileStreamBuf* pIn = dynamic_cast<FileStreamBuf*>(istr.rdbuf());
+	FileStreamBuf* pOut = dynamic_cast<FileStreamBuf*>(ostr.rdbuf());
+	if (!pIn || !pOut || pIn == pOut || !istr.good() || !ostr.good()) return false;
+	if (!isRegularFile(pIn) || pOut->nativeHandle() == -1) return false;
+
+	// Files in procfs or sysfs report a size of 0 but still have content,
+	// which only read() delivers. Leave those to the buffered copy.
+	struct stat st;
+	if (::fstat(pIn->nativeHandle(), &st) != 0 || st.st_size == 0) return false;
+
+	// Write out pending output and discard buffered input, so that
+	// the file positions match the logical stream positions.
+	ostr.flush();
+	if (!ostr) return false;
+	if (pIn->pubseekoff(0, std::ios::cur, std::ios::in) == std::streampos(-1)) return false;
+	if (pOut->pubseekoff(0, std::ios::cur, std::ios::out) == std::streampos(-1)) return false;
+
+	const std::size_t CHUNK_SIZE = 0x40000000;
+	int fdIn = pIn->nativeHandle();
+	int fdOut = pOut->nativeHandle();
+	Poco::UInt64 copied = 0;
+	bool eof = false;
+#if defined(SYS_copy_file_range)
+	bool useCopyFileRange = true;
+#else
+	bool useCopyFileRange = false;
+#endif
+	for (;;)
+	{
+		ssize_t n;
+#if defined(SYS_copy_file_range)
+		if (useCopyFileRange)
+			n = ::syscall(SYS_copy_file_range, fdIn, static_cast<void*>(0), fdOut, static_cast<void*>(0), CHUNK_SIZE, 0U);
+		else
+#endif
+		n = ::sendfile(fdOut, fdIn, 0, CHUNK_SIZE);
+		if (n > 0)
+		{
+			copied += n;
+		}
+		else if (n == 0)
+		{
+			// Some kernels return 0 for files they cannot copy in-kernel,
+			// so end of file is only trusted once data has been copied.
+			// Otherwise, the buffered copy takes over.
+			eof = copied > 0;
+			break;
+		}
+		else if (errno == EINTR)
+		{
+			continue;
+		}
+		else if (useCopyFileRange)
+		{
+			// not supported by the kernel or for these files
+			useCopyFileRange = false;
+		}
+		else break;
+	}
+
+	// update the stream buffers' idea of the file positions
+	pIn->pubseekoff(0, std::ios::cur, std::ios::in);
+	pOut->pubseekoff(0, std::ios::cur, std::ios::out);
+	count += copied;
+	if (eof) istr.setstate(std::ios::eofbit | std::ios::failbit);
+	return eof;
+#else
+	return false;
+#endif
+}
+
+
+std::size_t StreamCopier::fileBufferSize(std::istream& istr, std::size_t bufferSize, Poco::UInt64& remaining)
+{
+	remaining = 0;
+	FileStreamBuf* pIn = dynamic_cast<FileStreamBuf*>(istr.rdbuf());
+	if (!pIn || !istr.good() || !isRegularFile(pIn)) return bufferSize;
+
+	std::streampos pos = pIn->pubseekoff(0, std::ios::cur, std::ios::in);
+	if (pos == std::streampos(-1)) return bufferSize;
+	std::streampos end = pIn->pubseekoff(0, std::ios::end, std::ios::in);
+	pIn->pubseekpos(pos, std::ios::in);
+	if (end == std::streampos(-1) || end <= pos) return bufferSize;
+
+	remaining = static_cast<Poco::UInt64>(end - pos);
+	if (remaining <= bufferSize) return bufferSize;
+	return remaining < MAX_BUFFER_SIZE ? static_cast<std::size_t>(remaining) : static_cast<std::size_t>(MAX_BUFFER_SIZE);
+}
+
 
 } // namespace Poco
@@ -15,6 +15,7 @@
 #include "Poco/TextConverter.h"
 #include "Poco/TextIterator.h"
 #include "Poco/TextEncoding.h"
+#include "Poco/UTF8Encoding.h"
 
 
 namespace {
@@ -31,8 +32,28 @@ namespace Poco {
 TextConverter::TextConverter(const TextEncoding& inEncoding, const TextEncoding& outEncoding, int defaultChar):
 	_inEncoding(inEncoding),
 	_outEncoding(outEncoding),
-	_defaultChar(defaultChar)
+	_defaultChar(defaultChar),
+	_inputMode(INPUT_GENERIC),
+	_asciiOutput(true),
+	_utf8Output(dynamic_cast<const UTF8Encoding*>(&outEncoding) != 0)
 {
+	const TextEncoding::CharacterMap& inMap = _inEncoding.characterMap();
+	const TextEncoding::CharacterMap& outMap = _outEncoding.characterMap();
+	bool asciiInput = true;
+	bool singleByteInput = true;
+	for (int i = 0; i < 256; ++i)
+	{
+		if (i < 0x80 && inMap[i] != i) asciiInput = false;
+		if (i < 0x80 && outMap[i] != i) _asciiOutput = false;
+		if (inMap[i] < -1) singleByteInput = false;
+	}
+	if (asciiInput)
+	{
+		if (singleByteInput)
+			_inputMode = INPUT_SINGLE_BYTE;
+		else if (dynamic_cast<const UTF8Encoding*>(&inEncoding))
+			_inputMode = INPUT_UTF8;
+	}
 }
 
 
@@ -44,6 +65,9 @@ TextConverter::~TextConverter()
 int TextConverter::convert(const std::string& source, std::string& destination, Transform trans)
 {
 	int errors = 0;
+	if (trans == nullTransform && convertFast(source.data(), source.size(), destination, errors))
+		return errors;
+
 	TextIterator it(source, _inEncoding);
 	TextIterator end(source);
 	unsigned char buffer[TextEncoding::MAX_SEQUENCE_LENGTH];
@@ -68,6 +92,9 @@ int TextConverter::convert(const void* source, int length, std::string& destinat
 	poco_check_ptr (source);
 
 	int errors = 0;
+	if (trans == nullTransform && convertFast(static_cast<const char*>(source), length, destination, errors))
+		return errors;
+
 	const unsigned char* it  = (const unsigned char*) source;
 	const unsigned char* end = (const unsigned char*) source + length;
 	unsigned char buffer[TextEncoding::MAX_SEQUENCE_LENGTH];
@@ -125,4 +152,48 @@ int TextConverter::convert(const void* source, int length, std::string& destinat
 }
 
 
+bool TextConverter::convertFast(const char* source, std::size_t length, std::string& destination, int& errors)
+{
+	if (_inputMode == INPUT_GENERIC || !_asciiOutput) return false;
+
+	if (_inputMode == INPUT_UTF8)
+	{
+		// invalid input is handled by the generic conversion
+		if (!UTF8Encoding::isValid(source, length)) return false;
+		if (_utf8Output)
+		{
+			destination.append(source, length);
+			return true;
+		}
+	}
+
+	const char* it  = source;
+	const char* end = source + length;
+	unsigned char buffer[TextEncoding::MAX_SEQUENCE_LENGTH];
+	while (it < end)
+	{
+		std::size_t ascii = UTF8Encoding::countASCII(it, end - it);
+		destination.append(it, ascii);
+		it += ascii;
+		while (it < end && static_cast<unsigned char>(*it) >= 0x80)
+		{
+			const unsigned char* p = reinterpret_cast<const unsigned char*>(it);
+			int uc = _inEncoding.queryConvert(p, static_cast<int>(end - it));
+			int read = _inputMode == INPUT_UTF8 ? _inEncoding.sequenceLength(p, static_cast<int>(end - it)) : 1;
+			if (uc < 0)
+			{
+				uc = _defaultChar;
+				++errors;
+			}
+			int n = _outEncoding.convert(uc, buffer, sizeof(buffer));
+			if (n == 0) n = _outEncoding.convert(_defaultChar, buffer, sizeof(buffer));
+			poco_assert (n >= 0 && static_cast<std::size_t>(n) <= sizeof(buffer));
+			destination.append(reinterpret_cast<const char*>(buffer), n);
+			it += read;
+		}
+	}
+	return true;
+}
+
+
 } // namespace Poco
@@ -0,0 +1,404 @@
+//
+// ThreadCachedMemoryPool.cpp
+//
+// Library: Foundation
+// Package: Core
+// Module:  ThreadCachedMemoryPool
+//
+// Copyright (c) 2005-2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/ThreadCachedMemoryPool.h"
+#include "Poco/Exception.h"
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+
+namespace Poco {
+
+
+namespace
+{
+	std::atomic<UInt64> poolSerial(0);
+	std::atomic<UInt32> threadSerial(0);
+
+	struct BlockHeader
+	{
+		UInt32 owner;
+	};
+
+	inline BlockHeader* header(void* pBlock)
+	{
+		return reinterpret_cast<BlockHeader*>(pBlock);
+	}
+}
+
+
+//
+// AbstractThreadCachedPool::Control
+//
+class AbstractThreadCachedPool::Control
+	/// State shared between a pool and the thread caches
+	/// referring to it. Outlives the pool as long as any
+	/// thread still holds a magazine for it.
+{
+public:
+	explicit Control(AbstractThreadCachedPool* pOwner):
+		pPool(pOwner)
+	{
+	}
+
+	mutable FastMutex         mutex;
+	AbstractThreadCachedPool* pPool;
+	std::vector<Magazine*>    magazines;
+	Statistics                retired;
+};
+
+
+//
+// AbstractThreadCachedPool::Magazine
+//
+class AbstractThreadCachedPool::Magazine
+	/// The cache of free blocks of one pool in one thread.
+	///
+	/// The blocks are only accessed by the owning thread.
+	/// The counters are only written by the owning thread,
+	/// but may be read concurrently by statistics().
+{
+public:
+	typedef std::atomic<UInt64> Counter;
+
+	Magazine(const SharedPtr<Control>& pCtrl, UInt64 pool, UInt32 thread, std::size_t capacity):
+		pControl(pCtrl),
+		poolId(pool),
+		threadId(thread),
+		hits(0),
+		misses(0),
+		refills(0),
+		flushes(0),
+		crossThreadFrees(0)
+	{
+		blocks.reserve(capacity);
+	}
+
+	void count(Counter& counter)
+	{
+		counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	}
+
+	void addTo(Statistics& stats) const
+	{
+		stats.hits             += hits.load(std::memory_order_relaxed);
+		stats.misses           += misses.load(std::memory_order_relaxed);
+		stats.refills          += refills.load(std::memory_order_relaxed);
+		stats.flushes          += flushes.load(std::memory_order_relaxed);
+		stats.crossThreadFrees += crossThreadFrees.load(std::memory_order_relaxed);
+	}
+
+	SharedPtr<Control> pControl;
+	UInt64             poolId;
+	UInt32             threadId;
+	std::vector<void*> blocks;
+	Counter            hits;
+	Counter            misses;
+	Counter            refills;
+	Counter            flushes;
+	Counter            crossThreadFrees;
+};
+
+
+//
+// AbstractThreadCachedPool::ThreadCaches
+//
+class AbstractThreadCachedPool::ThreadCaches
+	/// The magazines of all pools used by one thread.
+{
+public:
+	ThreadCaches():
+		_threadId(++threadSerial),
+		_pLast(0)
+	{
+	}
+
+	~ThreadCaches()
+	{
+		for (std::vector<Magazine*>::iterator it = _magazines.begin(); it != _magazines.end(); ++it)
+		{
+			retire(*it);
+		}
+	}
+
+	UInt32 threadId() const
+	{
+		return _threadId;
+	}
+
+	Magazine* find(UInt64 poolId)
+	{
+		if (_pLast && _pLast->poolId == poolId) return _pLast;
+
+		for (std::vector<Magazine*>::iterator it = _magazines.begin(); it != _magazines.end(); ++it)
+		{
+			if ((*it)->poolId == poolId)
+			{
+				_pLast = *it;
+				return _pLast;
+			}
+		}
+		return 0;
+	}
+
+	void add(Magazine* pMagazine)
+	{
+		purge();
+		_magazines.push_back(pMagazine);
+		_pLast = pMagazine;
+	}
+
+private:
+	void purge()
+		/// Removes the magazines of pools that have been destroyed.
+	{
+		std::vector<Magazine*>::iterator it = _magazines.begin();
+		while (it != _magazines.end())
+		{
+			bool detached;
+			{
+				FastMutex::ScopedLock lock((*it)->pControl->mutex);
+				detached = (*it)->pControl->pPool == 0;
+			}
+			if (detached)
+			{
+				if (*it == _pLast) _pLast = 0;
+				delete *it;
+				it = _magazines.erase(it);
+			}
+			else ++it;
+		}
+	}
+
+	static void retire(Magazine* pMagazine)
+		/// Returns the blocks of a terminating thread's magazine
+		/// to the backing pool and preserves its statistics.
+	{
+		{
+			Control& control = *pMagazine->pControl;
+			FastMutex::ScopedLock lock(control.mutex);
+			if (control.pPool)
+			{
+				if (!pMagazine->blocks.empty())
+				{
+					control.pPool->drain(&pMagazine->blocks[0], pMagazine->blocks.size());
+				}
+				pMagazine->addTo(control.retired);
+				control.magazines.erase(std::remove(control.magazines.begin(), control.magazines.end(), pMagazine), control.magazines.end());
+			}
+		}
+		delete pMagazine;
+	}
+
+	UInt32                 _threadId;
+	Magazine*              _pLast;
+	std::vector<Magazine*> _magazines;
+};
+
+
+//
+// AbstractThreadCachedPool
+//
+AbstractThreadCachedPool::Statistics::Statistics():
+	hits(0),
+	misses(0),
+	refills(0),
+	flushes(0),
+	crossThreadFrees(0)
+{
+}
+
+
+AbstractThreadCachedPool::AbstractThreadCachedPool(std::size_t magazineSize):
+	_magazineSize(magazineSize < 2 ? 2 : magazineSize),
+	_id(++poolSerial),
+	_pControl(new Control(this))
+{
+}
+
+
+AbstractThreadCachedPool::~AbstractThreadCachedPool()
+{
+	try
+	{
+		FastMutex::ScopedLock lock(_pControl->mutex);
+		poco_assert_dbg (_pControl->pPool == 0);
+		_pControl->pPool = 0;
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
+}
+
+
+AbstractThreadCachedPool::ThreadCaches& AbstractThreadCachedPool::threadCaches()
+{
+	static thread_local ThreadCaches caches;
+	return caches;
+}
+
+
+AbstractThreadCachedPool::Magazine* AbstractThreadCachedPool::magazine()
+{
+	ThreadCaches& caches = threadCaches();
+	Magazine* pMagazine = caches.find(_id);
+	if (!pMagazine)
+	{
+		pMagazine = new Magazine(_pControl, _id, caches.threadId(), _magazineSize);
+		{
+			FastMutex::ScopedLock lock(_pControl->mutex);
+			_pControl->magazines.push_back(pMagazine);
+		}
+		caches.add(pMagazine);
+	}
+	return pMagazine;
+}
+
+
+void* AbstractThreadCachedPool::getBlock()
+{
+	Magazine* pMagazine = magazine();
+	std::vector<void*>& blocks = pMagazine->blocks;
+	if (blocks.empty())
+	{
+		pMagazine->count(pMagazine->misses);
+		std::size_t n = _magazineSize/2;
+		blocks.resize(n);
+		try
+		{
+			n = refill(&blocks[0], n);
+		}
+		catch (...)
+		{
+			blocks.clear();
+			throw;
+		}
+		blocks.resize(n);
+		pMagazine->count(pMagazine->refills);
+	}
+	else pMagazine->count(pMagazine->hits);
+
+	void* pBlock = blocks.back();
+	blocks.pop_back();
+	header(pBlock)->owner = pMagazine->threadId;
+	return reinterpret_cast<char*>(pBlock) + HEADER_SIZE;
+}
+
+
+void AbstractThreadCachedPool::releaseBlock(void* ptr)
+{
+	if (!ptr) return;
+
+	void* pBlock = reinterpret_cast<char*>(ptr) - HEADER_SIZE;
+	Magazine* pMagazine = magazine();
+	if (header(pBlock)->owner != pMagazine->threadId)
+	{
+		pMagazine->count(pMagazine->crossThreadFrees);
+	}
+	std::vector<void*>& blocks = pMagazine->blocks;
+	if (blocks.size() == _magazineSize)
+	{
+		std::size_t keep = _magazineSize/2;
+		drain(&blocks[keep], blocks.size() - keep);
+		blocks.resize(keep);
+		pMagazine->count(pMagazine->flushes);
+	}
+	blocks.push_back(pBlock);
+}
+
+
+void AbstractThreadCachedPool::flush()
+{
+	Magazine* pMagazine = magazine();
+	std::vector<void*>& blocks = pMagazine->blocks;
+	if (!blocks.empty())
+	{
+		drain(&blocks[0], blocks.size());
+		blocks.clear();
+		pMagazine->count(pMagazine->flushes);
+	}
+}
+
+
+void AbstractThreadCachedPool::shutdown()
+{
+	FastMutex::ScopedLock lock(_pControl->mutex);
+	if (!_pControl->pPool) return;
+
+	for (std::vector<Magazine*>::iterator it = _pControl->magazines.begin(); it != _pControl->magazines.end(); ++it)
+	{
+		std::vector<void*>& blocks = (*it)->blocks;
+		if (!blocks.empty())
+		{
+			drain(&blocks[0], blocks.size());
+			blocks.clear();
+		}
+	}
+	_pControl->magazines.clear();
+	_pControl->pPool = 0;
+}
+
+
+AbstractThreadCachedPool::Statistics AbstractThreadCachedPool::statistics() const
+{
+	FastMutex::ScopedLock lock(_pControl->mutex);
+
+	Statistics stats = _pControl->retired;
+	for (std::vector<Magazine*>::const_iterator it = _pControl->magazines.begin(); it != _pControl->magazines.end(); ++it)
+	{
+		(*it)->addTo(stats);
+	}
+	return stats;
+}
+
+
+//
+// ThreadCachedMemoryPool
+//
+ThreadCachedMemoryPool::ThreadCachedMemoryPool(std::size_t blockSize, int preAlloc, int maxAlloc, std::size_t magazineSize):
+	AbstractThreadCachedPool(magazineSize),
+	_blockSize(blockSize),
+	_pool(blockSize + HEADER_SIZE, preAlloc, maxAlloc)
+{
+}
+
+
+ThreadCachedMemoryPool::~ThreadCachedMemoryPool()
+{
+	try
+	{
+		shutdown();
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
+}
+
+
+std::size_t ThreadCachedMemoryPool::refill(void** blocks, std::size_t n)
+{
+	return _pool.getBlocks(blocks, n);
+}
+
+
+void ThreadCachedMemoryPool::drain(void** blocks, std::size_t n)
+{
+	_pool.releaseBlocks(blocks, n);
+}
+
+
+} // namespace Poco
@@ -0,0 +1,351 @@
+//
+// TimingWheel.cpp
+//
+// Library: Foundation
+// Package: Threading
+// Module:  TimingWheel
+//
+// Copyright (c) 2009, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/TimingWheel.h"
+#include "Poco/Exception.h"
+#include <algorithm>
+
+
+namespace Poco {
+
+
+//
+// TimingWheel::Timeout
+//
+
+
+TimingWheel::Timeout::Timeout():
+	_pWheel(0),
+	_pPrev(0),
+	_pNext(0),
+	_slot(-1),
+	_tick(0),
+	_sequence(0)
+{
+}
+
+
+TimingWheel::Timeout::~Timeout()
+{
+}
+
+
+//
+// TimingWheel
+//
+
+
+TimingWheel::TimingWheel(Clock::ClockDiff resolution)
+{
+	init(resolution, Clock());
+}
+
+
+TimingWheel::TimingWheel(Clock::ClockDiff resolution, const Clock& start)
+{
+	init(resolution, start);
+}
+
+
+TimingWheel::~TimingWheel()
+{
+	try
+	{
+		clear();
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
+}
+
+
+void TimingWheel::init(Clock::ClockDiff resolution, const Clock& start)
+{
+	poco_assert (resolution > 0);
+
+	_resolution  = resolution;
+	_origin      = start.raw();
+	_currentTick = 0;
+	_sequence    = 0;
+	_size        = 0;
+	for (int i = 0; i < WHEEL_LEVELS; ++i)
+	{
+		_levelSize[i] = 0;
+	}
+	for (int i = 0; i < WHEEL_LEVELS*WHEEL_SIZE; ++i)
+	{
+		_slots[i].pHead = 0;
+		_slots[i].pTail = 0;
+	}
+}
+
+
+void TimingWheel::schedule(Timeout::Ptr pTimeout, const Clock& deadline)
+{
+	poco_check_ptr (pTimeout.get());
+
+	if (pTimeout->_pWheel == this)
+	{
+		unlink(pTimeout.get());
+	}
+	else if (pTimeout->_pWheel)
+	{
+		throw InvalidAccessException("Timeout is already scheduled with another TimingWheel");
+	}
+	else
+	{
+		pTimeout->duplicate();
+		pTimeout->_pWheel = this;
+		++_size;
+	}
+
+	// Round up, so that a timeout never expires before its deadline.
+	Clock::ClockDiff diff = deadline.raw() - _origin;
+	pTimeout->_deadline = deadline;
+	pTimeout->_sequence = _sequence++;
+	pTimeout->_tick = diff > 0 ? static_cast<UInt64>(diff/_resolution + (diff % _resolution != 0 ? 1 : 0)) : 0;
+	insert(pTimeout.get(), _currentTick + 1);
+}
+
+
+bool TimingWheel::cancel(Timeout::Ptr pTimeout)
+{
+	if (!pTimeout || pTimeout->_pWheel != this) return false;
+
+	unlink(pTimeout.get());
+	pTimeout->_pWheel = 0;
+	--_size;
+	pTimeout->release();
+	return true;
+}
+
+
+std::size_t TimingWheel::advance(const Clock& now, TimeoutVec& expired)
+{
+	std::size_t count = expired.size();
+	Clock::ClockDiff diff = now.raw() - _origin;
+	UInt64 target = diff > 0 ? static_cast<UInt64>(diff/_resolution) : 0;
+	while (_currentTick < target)
+	{
+		if (_size == 0)
+		{
+			_currentTick = target;
+			break;
+		}
+
+		// Skip ticks that have nothing to expire or cascade.
+		UInt64 tick;
+		if (_levelSize[0] > 0)
+		{
+			UInt64 end = (_currentTick | WHEEL_MASK) + 1;
+			if (end > target) end = target;
+			tick = _currentTick + 1;
+			while (tick < end && !_slots[tick & WHEEL_MASK].pHead) ++tick;
+		}
+		else
+		{
+			int level = 1;
+			while (level < WHEEL_LEVELS - 1 && _levelSize[level] == 0) ++level;
+			int shift = WHEEL_BITS*level;
+			tick = ((_currentTick >> shift) + 1) << shift;
+			if (tick > target) tick = target;
+		}
+		_currentTick = tick;
+		cascade();
+		expire(expired);
+	}
+	return expired.size() - count;
+}
+
+
+bool TimingWheel::nextDeadline(Clock& deadline) const
+{
+	if (_size == 0) return false;
+
+	UInt64 next = 0;
+	bool found = false;
+	if (_levelSize[0] > 0)
+	{
+		for (UInt64 tick = _currentTick + 1; tick <= _currentTick + WHEEL_SIZE; ++tick)
+		{
+			if (_slots[tick & WHEEL_MASK].pHead)
+			{
+				next = tick;
+				found = true;
+				break;
+			}
+		}
+	}
+	for (int level = 1; level < WHEEL_LEVELS; ++level)
+	{
+		if (_levelSize[level] == 0) continue;
+
+		// Timeouts in the outer wheels must be cascaded
+		// at the start of the block their slot covers.
+		int shift = WHEEL_BITS*level;
+		UInt64 block = _currentTick >> shift;
+		for (UInt64 b = block + 1; b <= block + WHEEL_SIZE; ++b)
+		{
+			UInt64 tick = b << shift;
+			if (found && tick >= next) break;
+			if (_slots[level*WHEEL_SIZE + (b & WHEEL_MASK)].pHead)
+			{
+				next = tick;
+				found = true;
+				break;
+			}
+		}
+	}
+	poco_assert_dbg (found);
+	deadline = Clock(_origin + static_cast<Clock::ClockVal>(next)*_resolution);
+	return true;
+}
+
+
+void TimingWheel::clear()
+{
+	for (int slot = 0; slot < WHEEL_LEVELS*WHEEL_SIZE; ++slot)
+	{
+		Timeout* pTimeout = detach(slot);
+		while (pTimeout)
+		{
+			Timeout* pNext = pTimeout->_pNext;
+			pTimeout->_pWheel = 0;
+			pTimeout->_pNext = 0;
+			pTimeout->release();
+			pTimeout = pNext;
+		}
+	}
+	for (int i = 0; i < WHEEL_LEVELS; ++i)
+	{
+		_levelSize[i] = 0;
+	}
+	_size = 0;
+}
+
+
+void TimingWheel::insert(Timeout* pTimeout, UInt64 minTick)
+{
+	UInt64 tick = pTimeout->_tick < minTick ? minTick : pTimeout->_tick;
+	UInt64 delta = tick - _currentTick;
+	const UInt64 maxDelta = (static_cast<UInt64>(1) << (WHEEL_BITS*WHEEL_LEVELS)) - 1;
+	if (delta > maxDelta)
+	{
+		// Park it in the outermost wheel; it will be
+		// cascaded again until it is close enough.
+		tick  = _currentTick + maxDelta;
+		delta = maxDelta;
+	}
+	int level = 0;
+	while (level < WHEEL_LEVELS - 1 && delta >= (static_cast<UInt64>(1) << (WHEEL_BITS*(level + 1)))) ++level;
+	int slot = level*WHEEL_SIZE + static_cast<int>((tick >> (WHEEL_BITS*level)) & WHEEL_MASK);
+
+	Slot& s = _slots[slot];
+	pTimeout->_slot  = slot;
+	pTimeout->_pNext = 0;
+	pTimeout->_pPrev = s.pTail;
+	if (s.pTail)
+		s.pTail->_pNext = pTimeout;
+	else
+		s.pHead = pTimeout;
+	s.pTail = pTimeout;
+	++_levelSize[level];
+}
+
+
+void TimingWheel::unlink(Timeout* pTimeout)
+{
+	Slot& s = _slots[pTimeout->_slot];
+	if (pTimeout->_pPrev)
+		pTimeout->_pPrev->_pNext = pTimeout->_pNext;
+	else
+		s.pHead = pTimeout->_pNext;
+	if (pTimeout->_pNext)
+		pTimeout->_pNext->_pPrev = pTimeout->_pPrev;
+	else
+		s.pTail = pTimeout->_pPrev;
+	--_levelSize[pTimeout->_slot/WHEEL_SIZE];
+	pTimeout->_pPrev = 0;
+	pTimeout->_pNext = 0;
+	pTimeout->_slot  = -1;
+}
+
+
+TimingWheel::Timeout* TimingWheel::detach(int slot)
+{
+	Timeout* pHead = _slots[slot].pHead;
+	_slots[slot].pHead = 0;
+	_slots[slot].pTail = 0;
+	for (Timeout* pTimeout = pHead; pTimeout; pTimeout = pTimeout->_pNext)
+	{
+		pTimeout->_pPrev = 0;
+		pTimeout->_slot  = -1;
+		--_levelSize[slot/WHEEL_SIZE];
+	}
+	return pHead;
+}
+
+
+void TimingWheel::cascade()
+{
+	for (int level = 1; level < WHEEL_LEVELS; ++level)
+	{
+		int shift = WHEEL_BITS*level;
+		if (_currentTick & ((static_cast<UInt64>(1) << shift) - 1)) break;
+
+		Timeout* pTimeout = detach(level*WHEEL_SIZE + static_cast<int>((_currentTick >> shift) & WHEEL_MASK));
+		while (pTimeout)
+		{
+			Timeout* pNext = pTimeout->_pNext;
+			insert(pTimeout, _currentTick);
+			pTimeout = pNext;
+		}
+	}
+}
+
+
+void TimingWheel::expire(TimeoutVec& expired)
+{
+	std::size_t first = expired.size();
+	Timeout* pTimeout = detach(static_cast<int>(_currentTick & WHEEL_MASK));
+	while (pTimeout)
+	{
+		Timeout* pNext = pTimeout->_pNext;
+		pTimeout->_pWheel = 0;
+		pTimeout->_pNext = 0;
+		--_size;
+		expired.push_back(Timeout::Ptr(pTimeout, false));
+		pTimeout = pNext;
+	}
+
+	// The slot holds the timeouts of the tick in the order they have
+	// been inserted, which includes those cascaded from outer wheels.
+	if (expired.size() - first > 1)
+	{
+		std::sort(expired.begin() + first, expired.end(), &expiresBefore);
+	}
+}
+
+
+bool TimingWheel::expiresBefore(const Timeout::Ptr& pTimeout1, const Timeout::Ptr& pTimeout2)
+{
+	if (pTimeout1->_deadline != pTimeout2->_deadline)
+		return pTimeout1->_deadline < pTimeout2->_deadline;
+	else
+		return pTimeout1->_sequence < pTimeout2->_sequence;
+}
+
+
+} // namespace Poco
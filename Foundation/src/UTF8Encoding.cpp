@@ -13,7 +13,219 @@
 
 
 #include "Poco/UTF8Encoding.h"
+#include "Poco/CPUFeatures.h"
 #include "Poco/String.h"
+#include <cstring>
+#if defined(POCO_HAVE_X86_INTRINSICS)
+#include <smmintrin.h>
+#endif
+
+
+namespace
+{
+	using Poco::UInt64;
+
+	std::size_t countASCIIPortable(const unsigned char* bytes, std::size_t length)
+	{
+		std::size_t i = 0;
+		for (; i + 8 <= length; i += 8)
+		{
+			UInt64 word;
+			std::memcpy(&word, bytes + i, 8);
+			if (word & 0x8080808080808080ULL) break;
+		}
+		while (i < length && bytes[i] < 0x80) ++i;
+		return i;
+	}
+
+
+	bool isValidPortable(const unsigned char* bytes, std::size_t length)
+	{
+		std::size_t i = 0;
+		while (i < length)
+		{
+			if (bytes[i] < 0x80)
+			{
+				i += countASCIIPortable(bytes + i, length - i);
+				continue;
+			}
+			unsigned char lead = bytes[i];
+			std::size_t n;
+			if (lead < 0xC2) return false;
+			else if (lead < 0xE0) n = 2;
+			else if (lead < 0xF0) n = 3;
+			else if (lead <= 0xF4) n = 4;
+			else return false;
+			if (length - i < n) return false;
+
+			unsigned char a = bytes[i + 1];
+			switch (lead)
+			{
+			case 0xE0:
+				if (a < 0xA0 || a > 0xBF) return false;
+				break;
+			case 0xED:
+				if (a < 0x80 || a > 0x9F) return false;
+				break;
+			case 0xF0:
+				if (a < 0x90 || a > 0xBF) return false;
+				break;
+			case 0xF4:
+				if (a < 0x80 || a > 0x8F) return false;
+				break;
+			default:
+				if (a < 0x80 || a > 0xBF) return false;
+			}
+			for (std::size_t k = 2; k < n; ++k)
+			{
+				if ((bytes[i + k] & 0xC0) != 0x80) return false;
+			}
+			i += n;
+		}
+		return true;
+	}
+
+
+#if defined(POCO_HAVE_X86_INTRINSICS)
+
+
+	// Error classes of the lookup algorithm. Each table entry has the bits
+	// of all errors possible for the high or low nibble of the first byte,
+	// or the high nibble of the second byte of a pair of adjacent bytes.
+	// A pair is in error if all three lookups share a bit.
+	enum
+	{
+		TOO_SHORT      = 0x01, // 11______ 0_______ or 11______ 11______
+		TOO_LONG       = 0x02, // 0_______ 10______
+		OVERLONG_3     = 0x04, // 11100000 100_____
+		TOO_LARGE      = 0x08, // 11110100 1001____ or 11110100 101_____ or 11110101+ 10______
+		SURROGATE      = 0x10, // 11101101 101_____
+		OVERLONG_2     = 0x20, // 1100000_ 10______
+		TOO_LARGE_1000 = 0x40, // 11110101+ 1000____
+		OVERLONG_4     = 0x40, // 11110000 1000____
+		TWO_CONTS      = 0x80, // 10______ 10______
+		CARRY          = TOO_SHORT | TOO_LONG | TWO_CONTS
+	};
+
+
+	POCO_TARGET("sse4.2")
+	inline void checkBlockSSE(__m128i input, __m128i& prev, __m128i& prevIncomplete, __m128i& error)
+	{
+		if (_mm_movemask_epi8(input) == 0)
+		{
+			// an ASCII block is valid, unless the previous block ended in the middle of a sequence
+			error = _mm_or_si128(error, prevIncomplete);
+			prevIncomplete = _mm_setzero_si128();
+			prev = input;
+			return;
+		}
+
+		const __m128i byte1HighTable = _mm_setr_epi8(
+			TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+			TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+			char(TWO_CONTS), char(TWO_CONTS), char(TWO_CONTS), char(TWO_CONTS),
+			TOO_SHORT | OVERLONG_2,
+			TOO_SHORT,
+			TOO_SHORT | OVERLONG_3 | SURROGATE,
+			TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4);
+		const __m128i byte1LowTable = _mm_setr_epi8(
+			char(CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4),
+			char(CARRY | OVERLONG_2),
+			char(CARRY),
+			char(CARRY),
+			char(CARRY | TOO_LARGE),
+			char(CARRY | TOO_LARGE | TOO_LARGE_1000),
+			char(CARRY | TOO_LARGE | TOO_LARGE_1000),
+			char(CARRY | TOO_LARGE | TOO_LARGE_1000),
+			char(CARRY | TOO_LARGE | TOO_LARGE_1000),
+			char(CARRY | TOO_LARGE | TOO_LARGE_1000),
+			char(CARRY | TOO_LARGE | TOO_LARGE_1000),
+			char(CARRY | TOO_LARGE | TOO_LARGE_1000),
+			char(CARRY | TOO_LARGE | TOO_LARGE_1000),
+			char(CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE),
+			char(CARRY | TOO_LARGE | TOO_LARGE_1000),
+			char(CARRY | TOO_LARGE | TOO_LARGE_1000));
+		const __m128i byte2HighTable = _mm_setr_epi8(
+			TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+			TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+			char(TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4),
+			char(TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE),
+			char(TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE),
+			char(TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE),
+			TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT);
+		const __m128i nibbleMask = _mm_set1_epi8(0x0F);
+
+		__m128i prev1 = _mm_alignr_epi8(input, prev, 15);
+		__m128i byte1High = _mm_shuffle_epi8(byte1HighTable, _mm_and_si128(_mm_srli_epi16(prev1, 4), nibbleMask));
+		__m128i byte1Low  = _mm_shuffle_epi8(byte1LowTable, _mm_and_si128(prev1, nibbleMask));
+		__m128i byte2High = _mm_shuffle_epi8(byte2HighTable, _mm_and_si128(_mm_srli_epi16(input, 4), nibbleMask));
+		__m128i special   = _mm_and_si128(_mm_and_si128(byte1High, byte1Low), byte2High);
+
+		// the third and fourth byte of a sequence must be continuation bytes,
+		// which the pairwise lookup reports as TWO_CONTS
+		__m128i prev2  = _mm_alignr_epi8(input, prev, 14);
+		__m128i prev3  = _mm_alignr_epi8(input, prev, 13);
+		__m128i third  = _mm_subs_epu8(prev2, _mm_set1_epi8(char(0xE0 - 0x80)));
+		__m128i fourth = _mm_subs_epu8(prev3, _mm_set1_epi8(char(0xF0 - 0x80)));
+		__m128i must23 = _mm_and_si128(_mm_or_si128(third, fourth), _mm_set1_epi8(char(0x80)));
+		error = _mm_or_si128(error, _mm_xor_si128(must23, special));
+
+		// a lead byte too close to the end of the block needs bytes from the next block
+		const __m128i maxComplete = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, char(0xF0 - 1), char(0xE0 - 1), char(0xC0 - 1));
+		prevIncomplete = _mm_subs_epu8(input, maxComplete);
+		prev = input;
+	}
+
+
+	POCO_TARGET("sse4.2")
+	bool isValidSSE(const unsigned char* bytes, std::size_t length)
+	{
+		__m128i prev = _mm_setzero_si128();
+		__m128i prevIncomplete = _mm_setzero_si128();
+		__m128i error = _mm_setzero_si128();
+		std::size_t i = 0;
+		for (; i + 16 <= length; i += 16)
+		{
+			checkBlockSSE(_mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i)), prev, prevIncomplete, error);
+		}
+		if (i < length)
+		{
+			// pad the last block with NUL characters, which
+			// reveals truncated sequences at the end of the input
+			unsigned char block[16] = {0};
+			std::memcpy(block, bytes + i, length - i);
+			checkBlockSSE(_mm_loadu_si128(reinterpret_cast<const __m128i*>(block)), prev, prevIncomplete, error);
+		}
+		error = _mm_or_si128(error, prevIncomplete);
+		return _mm_testz_si128(error, error) != 0;
+	}
+
+
+	POCO_TARGET("sse4.2")
+	std::size_t countASCIISSE(const unsigned char* bytes, std::size_t length)
+	{
+		std::size_t i = 0;
+		for (; i + 16 <= length; i += 16)
+		{
+			int mask = _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i)));
+			if (mask)
+			{
+				int n = 0;
+				while (!(mask & 1))
+				{
+					mask >>= 1;
+					++n;
+				}
+				return i + n;
+			}
+		}
+		while (i < length && bytes[i] < 0x80) ++i;
+		return i;
+	}
+
+
+#endif // POCO_HAVE_X86_INTRINSICS
+}
 
 
 namespace Poco {
@@ -239,4 +451,30 @@ bool UTF8Encoding::isLegal(const unsigned char *bytes, int length)
 }
 
 
+bool UTF8Encoding::isValid(const char* bytes, std::size_t length)
+{
+	poco_assert (bytes || length == 0);
+
+	const unsigned char* p = reinterpret_cast<const unsigned char*>(bytes);
+#if defined(POCO_HAVE_X86_INTRINSICS)
+	if (CPUFeatures::hasSSE42())
+		return isValidSSE(p, length);
+#endif
+	return isValidPortable(p, length);
+}
+
+
+std::size_t UTF8Encoding::countASCII(const char* bytes, std::size_t length)
+{
+	poco_assert (bytes || length == 0);
+
+	const unsigned char* p = reinterpret_cast<const unsigned char*>(bytes);
+#if defined(POCO_HAVE_X86_INTRINSICS)
+	if (CPUFeatures::hasSSE42())
+		return countASCIISSE(p, length);
+#endif
+	return countASCIIPortable(p, length);
+}
+
+
 } // namespace Poco
@@ -24,12 +24,148 @@
 #if !defined(POCO_NO_WSTRING)
 
 
+namespace
+{
+	using Poco::UTF16Char;
+	using Poco::UTF32Char;
+	using Poco::UTF16String;
+	using Poco::UTF32String;
+
+
+	template <typename S>
+	void decodeUTF8(const char* utf8String, std::size_t length, S& result)
+		/// Decodes valid UTF-8 into UTF-16 or UTF-32.
+	{
+		typedef typename S::value_type Char;
+
+		result.resize(length);
+		Char* out = &result[0];
+		const unsigned char* it  = reinterpret_cast<const unsigned char*>(utf8String);
+		const unsigned char* end = it + length;
+		while (it < end)
+		{
+			std::size_t ascii = Poco::UTF8Encoding::countASCII(reinterpret_cast<const char*>(it), end - it);
+			for (std::size_t i = 0; i < ascii; ++i) out[i] = it[i];
+			out += ascii;
+			it  += ascii;
+			while (it < end && *it >= 0x80)
+			{
+				UTF32Char cc;
+				if (*it < 0xE0)
+				{
+					cc = ((it[0] & 0x1F) << 6) | (it[1] & 0x3F);
+					it += 2;
+				}
+				else if (*it < 0xF0)
+				{
+					cc = ((it[0] & 0x0F) << 12) | ((it[1] & 0x3F) << 6) | (it[2] & 0x3F);
+					it += 3;
+				}
+				else
+				{
+					cc = ((it[0] & 0x07) << 18) | ((it[1] & 0x3F) << 12) | ((it[2] & 0x3F) << 6) | (it[3] & 0x3F);
+					it += 4;
+				}
+				if (sizeof(Char) == 2 && cc > 0xFFFF)
+				{
+					cc -= 0x10000;
+					*out++ = static_cast<Char>(((cc >> 10) & 0x3FF) | 0xD800);
+					*out++ = static_cast<Char>((cc & 0x3FF) | 0xDC00);
+				}
+				else *out++ = static_cast<Char>(cc);
+			}
+		}
+		result.resize(out - result.data());
+	}
+
+
+	inline char* encodeUTF8(UTF32Char cc, char* out)
+	{
+		if (cc < 0x80)
+		{
+			*out++ = static_cast<char>(cc);
+		}
+		else if (cc < 0x800)
+		{
+			*out++ = static_cast<char>(0xC0 | (cc >> 6));
+			*out++ = static_cast<char>(0x80 | (cc & 0x3F));
+		}
+		else if (cc < 0x10000)
+		{
+			*out++ = static_cast<char>(0xE0 | (cc >> 12));
+			*out++ = static_cast<char>(0x80 | ((cc >> 6) & 0x3F));
+			*out++ = static_cast<char>(0x80 | (cc & 0x3F));
+		}
+		else
+		{
+			*out++ = static_cast<char>(0xF0 | (cc >> 18));
+			*out++ = static_cast<char>(0x80 | ((cc >> 12) & 0x3F));
+			*out++ = static_cast<char>(0x80 | ((cc >> 6) & 0x3F));
+			*out++ = static_cast<char>(0x80 | (cc & 0x3F));
+		}
+		return out;
+	}
+
+
+	bool encodeUTF16(const UTF16Char* utf16String, std::size_t length, std::string& utf8String)
+		/// Encodes UTF-16 as UTF-8. Returns false if
+		/// an unpaired surrogate is found.
+	{
+		utf8String.resize(3*length);
+		char* out = &utf8String[0];
+		const UTF16Char* end = utf16String + length;
+		for (const UTF16Char* it = utf16String; it < end; ++it)
+		{
+			UTF32Char cc = *it;
+			if (cc < 0x80)
+			{
+				*out++ = static_cast<char>(cc);
+				continue;
+			}
+			if (cc >= 0xD800 && cc <= 0xDFFF)
+			{
+				if (cc >= 0xDC00 || it + 1 == end || it[1] < 0xDC00 || it[1] > 0xDFFF)
+					return false;
+				cc = 0x10000 + (((cc & 0x3FF) << 10) | (it[1] & 0x3FF));
+				++it;
+			}
+			out = encodeUTF8(cc, out);
+		}
+		utf8String.resize(out - utf8String.data());
+		return true;
+	}
+
+
+	bool encodeUTF32(const UTF32Char* utf32String, std::size_t length, std::string& utf8String)
+		/// Encodes UTF-32 as UTF-8. Returns false if
+		/// a character beyond U+10FFFF is found.
+	{
+		utf8String.resize(4*length);
+		char* out = &utf8String[0];
+		const UTF32Char* end = utf32String + length;
+		for (const UTF32Char* it = utf32String; it < end; ++it)
+		{
+			if (*it > 0x10FFFF) return false;
+			out = encodeUTF8(*it, out);
+		}
+		utf8String.resize(out - utf8String.data());
+		return true;
+	}
+}
+
+
 namespace Poco {
 
 
 void UnicodeConverter::convert(const std::string& utf8String, UTF32String& utf32String)
 {
 	utf32String.clear();
+	if (UTF8Encoding::isValid(utf8String.data(), utf8String.size()))
+	{
+		decodeUTF8(utf8String.data(), utf8String.size(), utf32String);
+		return;
+	}
+
 	UTF8Encoding utf8Encoding;
 	TextIterator it(utf8String, utf8Encoding);
 	TextIterator end(utf8String);
@@ -50,7 +186,10 @@ void UnicodeConverter::convert(const char* utf8String, std::size_t length, UTF32
 		return;
 	}
 
-	convert(std::string(utf8String, utf8String + length), utf32String);
+	if (UTF8Encoding::isValid(utf8String, length))
+		decodeUTF8(utf8String, length, utf32String);
+	else
+		convert(std::string(utf8String, utf8String + length), utf32String);
 }
 
 
@@ -69,6 +208,12 @@ void UnicodeConverter::convert(const char* utf8String, UTF32String& utf32String)
 void UnicodeConverter::convert(const std::string& utf8String, UTF16String& utf16String)
 {
 	utf16String.clear();
+	if (UTF8Encoding::isValid(utf8String.data(), utf8String.size()))
+	{
+		decodeUTF8(utf8String.data(), utf8String.size(), utf16String);
+		return;
+	}
+
 	UTF8Encoding utf8Encoding;
 	TextIterator it(utf8String, utf8Encoding);
 	TextIterator end(utf8String);
@@ -97,7 +242,10 @@ void UnicodeConverter::convert(const char* utf8String,  std::size_t length, UTF1
 		return;
 	}
 
-	convert(std::string(utf8String, utf8String + length), utf16String);
+	if (UTF8Encoding::isValid(utf8String, length))
+		decodeUTF8(utf8String, length, utf16String);
+	else
+		convert(std::string(utf8String, utf8String + length), utf16String);
 }
 
 
@@ -109,12 +257,15 @@ void UnicodeConverter::convert(const char* utf8String, UTF16String& utf16String)
 		return;
 	}
 
-	convert(std::string(utf8String), utf16String);
+	convert(utf8String, std::strlen(utf8String), utf16String);
 }
 
 
 void UnicodeConverter::convert(const UTF16String& utf16String, std::string& utf8String)
 {
+	utf8String.clear();
+	if (encodeUTF16(utf16String.data(), utf16String.length(), utf8String)) return;
+
 	utf8String.clear();
 	UTF8Encoding utf8Encoding;
 	UTF16Encoding utf16Encoding;
@@ -125,6 +276,9 @@ void UnicodeConverter::convert(const UTF16String& utf16String, std::string& utf8
 
 void UnicodeConverter::convert(const UTF32String& utf32String, std::string& utf8String)
 {
+	utf8String.clear();
+	if (encodeUTF32(utf32String.data(), utf32String.length(), utf8String)) return;
+
 	utf8String.clear();
 	UTF8Encoding utf8Encoding;
 	UTF32Encoding utf32Encoding;
@@ -135,6 +289,9 @@ void UnicodeConverter::convert(const UTF32String& utf32String, std::string& utf8
 
 void UnicodeConverter::convert(const UTF16Char* utf16String,  std::size_t length, std::string& utf8String)
 {
+	utf8String.clear();
+	if (encodeUTF16(utf16String, length, utf8String)) return;
+
 	utf8String.clear();
 	UTF8Encoding utf8Encoding;
 	UTF16Encoding utf16Encoding;
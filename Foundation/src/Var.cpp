@@ -46,6 +46,18 @@ Var::Var(const char* pVal)
 #endif
 
 
+Var::Var(std::string&& val)
+#ifdef POCO_NO_SOO
+	: _pHolder(new VarHolderImpl<std::string>(std::move(val)))
+{
+}
+#else
+{
+	construct(std::move(val));
+}
+#endif
+
+
 Var::Var(const Var& other)
 #ifdef POCO_NO_SOO
 	: _pHolder(other._pHolder ? other._pHolder->clone() : 0)
@@ -59,6 +71,20 @@ Var::Var(const Var& other)
 #endif
 
 
+#ifdef POCO_NO_SOO
+Var::Var(Var&& other) noexcept
+	: _pHolder(other._pHolder)
+{
+	other._pHolder = 0;
+}
+#else
+Var::Var(Var&& other)
+{
+	construct(std::move(other));
+}
+#endif
+
+
 Var::~Var()
 {
 	destruct();
@@ -80,6 +106,28 @@ Var& Var::operator = (const Var& rhs)
 }
 
 
+#ifdef POCO_NO_SOO
+Var& Var::operator = (Var&& rhs) noexcept
+#else
+Var& Var::operator = (Var&& rhs)
+#endif
+{
+	// rhs may be owned by this Var, e.g. an element of a held vector,
+	// so it must be taken over before the current value is destroyed.
+	Var tmp(std::move(rhs));
+	swap(tmp);
+	return *this;
+}
+
+
+Var& Var::operator = (std::string&& rhs)
+{
+	Var tmp(std::move(rhs));
+	swap(tmp);
+	return *this;
+}
+
+
 const Var Var::operator + (const Var& other) const
 {
 	if (isInteger())
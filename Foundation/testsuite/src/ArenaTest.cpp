@@ -0,0 +1,300 @@
+//
+// ArenaTest.cpp
+//
+// Copyright (c) 2005-2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "ArenaTest.h"
+#include "Poco/CppUnit/TestCaller.h"
+#include "Poco/CppUnit/TestSuite.h"
+#include "Poco/Arena.h"
+#include "Poco/Stopwatch.h"
+#include <vector>
+#include <map>
+#include <string>
+#include <cstring>
+#include <iostream>
+
+
+using Poco::Arena;
+using Poco::ArenaAllocator;
+
+
+namespace
+{
+	struct Tracked
+	{
+		Tracked(int& counter, std::vector<int>& order, int id):
+			_counter(counter),
+			_order(order),
+			_id(id)
+		{
+			++_counter;
+		}
+
+		~Tracked()
+		{
+			--_counter;
+			_order.push_back(_id);
+		}
+
+		int& _counter;
+		std::vector<int>& _order;
+		int _id;
+	};
+
+	typedef std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>> ArenaString;
+}
+
+
+ArenaTest::ArenaTest(const std::string& rName): CppUnit::TestCase(rName)
+{
+}
+
+
+ArenaTest::~ArenaTest()
+{
+}
+
+
+void ArenaTest::testAllocate()
+{
+	Arena arena(256);
+	assertTrue (arena.allocated() == 0);
+	assertTrue (arena.capacity() == 0);
+
+	char* p1 = static_cast<char*>(arena.allocate(10, 1));
+	char* p2 = static_cast<char*>(arena.allocate(10, 1));
+	assertTrue (p2 == p1 + 10);
+	assertTrue (arena.allocated() == 20);
+	assertTrue (arena.capacity() == 256);
+
+	std::memset(p1, 'a', 10);
+	std::memset(p2, 'b', 10);
+	assertTrue (p1[9] == 'a');
+
+	// deallocating the last block makes it available again
+	arena.deallocate(p2, 10);
+	assertTrue (arena.allocated() == 10);
+	char* p3 = static_cast<char*>(arena.allocate(10, 1));
+	assertTrue (p3 == p2);
+
+	// deallocating any other block has no effect
+	arena.deallocate(p1, 10);
+	assertTrue (arena.allocated() == 20);
+
+	for (int i = 0; i < 100; ++i) arena.allocate(10, 1);
+	assertTrue (arena.allocated() == 1020);
+	assertTrue (arena.capacity() > 1020);
+
+	const char* s = arena.copy("hello", 5);
+	assertTrue (std::strcmp(s, "hello") == 0);
+}
+
+
+void ArenaTest::testAlignment()
+{
+	Arena arena;
+	arena.allocate(1, 1);
+	void* p = arena.allocate(sizeof(double), alignof(double));
+	assertTrue (reinterpret_cast<std::size_t>(p) % alignof(double) == 0);
+	arena.allocate(3, 1);
+	p = arena.allocate(16);
+	assertTrue (reinterpret_cast<std::size_t>(p) % alignof(std::max_align_t) == 0);
+	arena.allocate(1, 1);
+	p = arena.allocate(64, 64);
+	assertTrue (reinterpret_cast<std::size_t>(p) % 64 == 0);
+}
+
+
+void ArenaTest::testLargeAllocation()
+{
+	Arena arena(128);
+	char* p1 = static_cast<char*>(arena.allocate(8, 1));
+	char* pLarge = static_cast<char*>(arena.allocate(10000, 1));
+	std::memset(pLarge, 'x', 10000);
+	assertTrue (arena.capacity() > 10000);
+
+	// the large block gets its own chunk; the current chunk is still used
+	char* p2 = static_cast<char*>(arena.allocate(8, 1));
+	assertTrue (p2 == p1 + 8);
+}
+
+
+void ArenaTest::testBuffer()
+{
+	char buffer[128];
+	Arena arena(buffer, sizeof(buffer));
+	void* p = arena.allocate(64, 1);
+	assertTrue (p == buffer);
+	assertTrue (arena.capacity() == 0);
+	arena.allocate(64, 1);
+	assertTrue (arena.capacity() == 0);
+	arena.allocate(1, 1);
+	assertTrue (arena.capacity() > 0);
+
+	arena.release();
+	assertTrue (arena.capacity() == 0);
+	p = arena.allocate(1, 1);
+	assertTrue (p == buffer);
+}
+
+
+void ArenaTest::testReset()
+{
+	Arena arena(64);
+	for (int i = 0; i < 1000; ++i) arena.allocate(16);
+	std::size_t capacity = arena.capacity();
+	assertTrue (capacity >= 16000);
+
+	arena.reset();
+	assertTrue (arena.allocated() == 0);
+	assertTrue (arena.capacity() > 0);
+	assertTrue (arena.capacity() < capacity);
+
+	std::size_t retained = arena.capacity();
+	arena.allocate(16);
+	assertTrue (arena.capacity() == retained);
+
+	arena.release();
+	assertTrue (arena.capacity() == 0);
+	assertTrue (arena.allocated() == 0);
+}
+
+
+void ArenaTest::testCreate()
+{
+	int counter = 0;
+	std::vector<int> order;
+	{
+		Arena arena;
+		Tracked* p1 = arena.create<Tracked>(counter, order, 1);
+		arena.create<Tracked>(counter, order, 2);
+		assertTrue (counter == 2);
+		assertTrue (p1->_id == 1);
+
+		int* pInt = arena.create<int>(42);
+		assertTrue (*pInt == 42);
+
+		std::string* pStr = arena.create<std::string>("a string that is long enough to require heap memory");
+		assertTrue (pStr->size() > 20);
+
+		arena.reset();
+		assertTrue (counter == 0);
+		assertTrue (order.size() == 2);
+		assertTrue (order[0] == 2 && order[1] == 1);
+
+		arena.create<Tracked>(counter, order, 3);
+		assertTrue (counter == 1);
+	}
+	assertTrue (counter == 0);
+	assertTrue (order.size() == 3);
+}
+
+
+void ArenaTest::testAllocator()
+{
+	Arena arena;
+	std::size_t before = arena.allocated();
+
+	std::vector<int, ArenaAllocator<int>> vec((ArenaAllocator<int>(arena)));
+	for (int i = 0; i < 1000; ++i) vec.push_back(i);
+	assertTrue (vec[999] == 999);
+	assertTrue (arena.allocated() > before + 1000*sizeof(int));
+
+	typedef std::map<int, ArenaString, std::less<int>, ArenaAllocator<std::pair<const int, ArenaString>>> ArenaMap;
+	ArenaMap map((std::less<int>()), ArenaAllocator<std::pair<const int, ArenaString>>(arena));
+	for (int i = 0; i < 100; ++i)
+	{
+		map.insert(ArenaMap::value_type(i, ArenaString(std::string(50, 'a' + i % 26).c_str(), ArenaAllocator<char>(arena))));
+	}
+	assertTrue (map.size() == 100);
+	assertTrue (map.find(27)->second[0] == 'b');
+
+	ArenaAllocator<int> a1(arena);
+	ArenaAllocator<double> a2(a1);
+	assertTrue (a1 == a2);
+	Arena other;
+	assertTrue (a1 != ArenaAllocator<int>(other));
+	assertTrue (a1.arena() == &arena);
+
+	// a default constructed allocator uses the heap
+	ArenaAllocator<int> heap;
+	assertTrue (heap.arena() == 0);
+	assertTrue (heap != a1);
+	assertTrue (heap == ArenaAllocator<char>());
+	before = arena.allocated();
+	std::vector<int, ArenaAllocator<int>> heapVec;
+	for (int i = 0; i < 1000; ++i) heapVec.push_back(i);
+	assertTrue (heapVec[999] == 999);
+	assertTrue (arena.allocated() == before);
+}
+
+
+void ArenaTest::arenaBenchmark()
+{
+	const int reps = 10000;
+	const int objects = 100;
+	Poco::Stopwatch sw;
+
+	sw.start();
+	for (int r = 0; r < reps; ++r)
+	{
+		std::map<int, std::string> map;
+		for (int i = 0; i < objects; ++i)
+		{
+			map[i] = "a value that does not fit into the small string buffer";
+		}
+	}
+	sw.stop();
+	std::cout << '\n' << reps << "x " << objects << " map entries\n";
+	std::cout << "std::allocator=" << sw.elapsed() / 1000 << std::endl;
+
+	Arena arena;
+	sw.restart();
+	for (int r = 0; r < reps; ++r)
+	{
+		{
+			typedef std::map<int, ArenaString, std::less<int>, ArenaAllocator<std::pair<const int, ArenaString>>> ArenaMap;
+			ArenaMap map((std::less<int>()), ArenaAllocator<std::pair<const int, ArenaString>>(arena));
+			for (int i = 0; i < objects; ++i)
+			{
+				map.insert(ArenaMap::value_type(i, ArenaString("a value that does not fit into the small string buffer", ArenaAllocator<char>(arena))));
+			}
+		}
+		arena.reset();
+	}
+	sw.stop();
+	std::cout << "ArenaAllocator=" << sw.elapsed() / 1000 << std::endl;
+}
+
+
+void ArenaTest::setUp()
+{
+}
+
+
+void ArenaTest::tearDown()
+{
+}
+
+
+CppUnit::Test* ArenaTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("ArenaTest");
+
+	CppUnit_addTest(pSuite, ArenaTest, testAllocate);
+	CppUnit_addTest(pSuite, ArenaTest, testAlignment);
+	CppUnit_addTest(pSuite, ArenaTest, testLargeAllocation);
+	CppUnit_addTest(pSuite, ArenaTest, testBuffer);
+	CppUnit_addTest(pSuite, ArenaTest, testReset);
+	CppUnit_addTest(pSuite, ArenaTest, testCreate);
+	CppUnit_addTest(pSuite, ArenaTest, testAllocator);
+	//CppUnit_addTest(pSuite, ArenaTest, arenaBenchmark);
+
+	return pSuite;
+}
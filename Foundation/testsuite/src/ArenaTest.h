@@ -0,0 +1,45 @@
+//
+// ArenaTest.h
+//
+// Definition of the ArenaTest class.
+//
+// Copyright (c) 2005-2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef ArenaTest_INCLUDED
+#define ArenaTest_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include "Poco/CppUnit/TestCase.h"
+
+
+class ArenaTest: public CppUnit::TestCase
+{
+public:
+	ArenaTest(const std::string& name);
+	~ArenaTest();
+
+	void testAllocate();
+	void testAlignment();
+	void testLargeAllocation();
+	void testBuffer();
+	void testReset();
+	void testCreate();
+	void testAllocator();
+	void arenaBenchmark();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+
+private:
+};
+
+
+#endif // ArenaTest_INCLUDED
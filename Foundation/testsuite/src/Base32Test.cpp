@@ -15,6 +15,7 @@
 #include "Poco/Base32Decoder.h"
 #include "Poco/Exception.h"
 #include <sstream>
+#include <cstring>
 
 
 using Poco::Base32Encoder;
@@ -160,6 +161,71 @@ void Base32Test::testEncodeDecode()
 }
 
 
+void Base32Test::testBulkEncodeDecode()
+{
+	for (int padding = 0; padding < 2; ++padding)
+	{
+		for (std::size_t n = 0; n < 100; ++n)
+		{
+			std::string src;
+			for (std::size_t i = 0; i < n; ++i) src += char(i*7 + n);
+
+			std::ostringstream str;
+			Base32Encoder encoder(str, padding != 0);
+			for (std::size_t i = 0; i < n; ++i) encoder.put(src[i]);
+			encoder.close();
+
+			std::string encoded(Base32Encoder::encodedLength(n, padding != 0), '\0');
+			std::size_t len = Base32Encoder::encode(src.data(), n, &encoded[0], padding != 0);
+			assertTrue (len == encoded.size());
+			assertTrue (encoded == str.str());
+
+			std::string decoded(Base32Decoder::decodedLength(len), '\0');
+			len = Base32Decoder::decode(encoded.data(), encoded.size(), &decoded[0]);
+			decoded.resize(len);
+			assertTrue (decoded == src);
+		}
+	}
+
+	static const char* invalid[] = { "A", "AAA", "AAAAAA", "AA=AAAAA", "AA======AAAAAAAA", "AA=====", "AAAAAAA1" };
+	char buffer[16];
+	for (std::size_t i = 0; i < sizeof(invalid)/sizeof(invalid[0]); ++i)
+	{
+		try
+		{
+			Base32Decoder::decode(invalid[i], std::strlen(invalid[i]), buffer);
+			failmsg (std::string("must throw for ") + invalid[i]);
+		}
+		catch (DataFormatException&)
+		{
+		}
+	}
+}
+
+
+void Base32Test::testBulkWrite()
+{
+	std::string src;
+	for (int i = 0; i < 5000; ++i) src += char(i*13);
+
+	for (std::size_t prefix = 0; prefix < 5; ++prefix)
+	{
+		std::ostringstream str1;
+		Base32Encoder encoder1(str1);
+		for (std::size_t i = 0; i < src.size(); ++i) encoder1.put(src[i]);
+		encoder1.close();
+
+		std::ostringstream str2;
+		Base32Encoder encoder2(str2);
+		encoder2.write(src.data(), static_cast<std::streamsize>(prefix));
+		encoder2.write(src.data() + prefix, static_cast<std::streamsize>(src.size() - prefix));
+		encoder2.close();
+
+		assertTrue (str1.str() == str2.str());
+	}
+}
+
+
 void Base32Test::setUp()
 {
 }
@@ -177,6 +243,8 @@ CppUnit::Test* Base32Test::suite()
 	CppUnit_addTest(pSuite, Base32Test, testEncoder);
 	CppUnit_addTest(pSuite, Base32Test, testDecoder);
 	CppUnit_addTest(pSuite, Base32Test, testEncodeDecode);
+	CppUnit_addTest(pSuite, Base32Test, testBulkEncodeDecode);
+	CppUnit_addTest(pSuite, Base32Test, testBulkWrite);
 
 	return pSuite;
 }
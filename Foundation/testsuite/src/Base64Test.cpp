@@ -14,7 +14,10 @@
 #include "Poco/Base64Encoder.h"
 #include "Poco/Base64Decoder.h"
 #include "Poco/Exception.h"
+#include "Poco/Stopwatch.h"
 #include <sstream>
+#include <iostream>
+#include <cstring>
 
 
 using Poco::Base64Encoder;
@@ -343,6 +346,184 @@ void Base64Test::testEncodeDecode()
 }
 
 
+void Base64Test::testBulkEncodeDecode()
+{
+	static const int options[] = { 0, Poco::BASE64_URL_ENCODING, Poco::BASE64_NO_PADDING, Poco::BASE64_URL_ENCODING | Poco::BASE64_NO_PADDING };
+
+	for (int o = 0; o < 4; ++o)
+	{
+		for (std::size_t n = 0; n < 300; ++n)
+		{
+			std::string src;
+			for (std::size_t i = 0; i < n; ++i) src += char(i*7 + n);
+
+			std::ostringstream str;
+			Base64Encoder encoder(str, options[o]);
+			encoder.rdbuf()->setLineLength(0);
+			for (std::size_t i = 0; i < n; ++i) encoder.put(src[i]);
+			encoder.close();
+
+			std::string encoded(Base64Encoder::encodedLength(n, options[o]), '\0');
+			std::size_t len = Base64Encoder::encode(src.data(), n, &encoded[0], options[o]);
+			assertTrue (len == encoded.size());
+			assertTrue (encoded == str.str());
+
+			std::string decoded(Base64Decoder::decodedLength(len), '\0');
+			len = Base64Decoder::decode(encoded.data(), encoded.size(), &decoded[0], options[o]);
+			decoded.resize(len);
+			assertTrue (decoded == src);
+		}
+	}
+
+	std::string data("\r\nAAEC\r\nAwQF BgcICQ==\r\n");
+	char buffer[16];
+	std::size_t n = Base64Decoder::decode(data.data(), data.size(), buffer);
+	assertTrue (n == 10);
+	for (int i = 0; i < 10; ++i) assertTrue (buffer[i] == i);
+
+	data = "AAECAw";
+	n = Base64Decoder::decode(data.data(), data.size(), buffer, Poco::BASE64_NO_PADDING);
+	assertTrue (n == 4);
+	assertTrue (buffer[3] == 3);
+
+	// line breaks between long runs of regular characters
+	std::string src;
+	for (int i = 0; i < 1000; ++i) src += char(i*13);
+	std::ostringstream str;
+	Base64Encoder encoder(str);
+	encoder.write(src.data(), static_cast<std::streamsize>(src.size()));
+	encoder.close();
+	data = str.str();
+	std::string decoded(Base64Decoder::decodedLength(data.size()), '\0');
+	decoded.resize(Base64Decoder::decode(data.data(), data.size(), &decoded[0]));
+	assertTrue (decoded == src);
+}
+
+
+void Base64Test::testBulkDecodeInvalid()
+{
+	static const char* invalid[] =
+	{
+		"AAE", "A", "AA=A", "A===", "AA==AAAA", "AAE$", "AAECAw==AA",
+		"AAECAwQFBgcICQoLDA0ODxAREhMUFRYXGBkaGxwd$h8gISIjJCUmJygpKissLS4v",
+		"AAECAwQFBgcICQoLDA0ODxAREhMUFRYXGBkaGxwdHh8g=SIjJCUmJygpKissLS4v",
+		"AAECAwQFBgcICQoLDA0ODxAREhMUFRYXGBkaGxwdHh8gISIjJCUmJygpKissLS4\xC0"
+	};
+
+	char buffer[64];
+	for (std::size_t i = 0; i < sizeof(invalid)/sizeof(invalid[0]); ++i)
+	{
+		try
+		{
+			Base64Decoder::decode(invalid[i], std::strlen(invalid[i]), buffer);
+			failmsg (std::string("must throw for ") + invalid[i]);
+		}
+		catch (DataFormatException&)
+		{
+		}
+	}
+
+	try
+	{
+		Base64Decoder::decode("AA E=", 5, buffer, Poco::BASE64_URL_ENCODING);
+		fail ("whitespace is not allowed in URL encoding - must throw");
+	}
+	catch (DataFormatException&)
+	{
+	}
+}
+
+
+void Base64Test::testBulkWrite()
+{
+	std::string src;
+	for (int i = 0; i < 10000; ++i) src += char(i*13);
+
+	static const int lineLengths[] = { 72, 76, 0, 1, 5 };
+	for (int l = 0; l < 5; ++l)
+	{
+		for (std::size_t prefix = 0; prefix < 4; ++prefix)
+		{
+			std::ostringstream str1;
+			Base64Encoder encoder1(str1);
+			encoder1.rdbuf()->setLineLength(lineLengths[l]);
+			for (std::size_t i = 0; i < src.size(); ++i) encoder1.put(src[i]);
+			encoder1.close();
+
+			std::ostringstream str2;
+			Base64Encoder encoder2(str2);
+			encoder2.rdbuf()->setLineLength(lineLengths[l]);
+			encoder2.write(src.data(), static_cast<std::streamsize>(prefix));
+			encoder2.write(src.data() + prefix, static_cast<std::streamsize>(src.size() - prefix));
+			encoder2.close();
+
+			assertTrue (str1.str() == str2.str());
+		}
+	}
+}
+
+
+void Base64Test::testPerformance()
+{
+	std::string src;
+	for (int i = 0; i < 1024*1024; ++i) src += char(i*13);
+	const int iterations = 100;
+
+	Poco::Stopwatch sw;
+	sw.start();
+	for (int i = 0; i < iterations; ++i)
+	{
+		std::ostringstream str;
+		Base64Encoder encoder(str);
+		for (std::size_t j = 0; j < src.size(); ++j) encoder.put(src[j]);
+		encoder.close();
+	}
+	sw.stop();
+	std::cout << "Base64Encoder (put):   " << sw.elapsed()/1000 << " ms" << std::endl;
+
+	sw.restart();
+	for (int i = 0; i < iterations; ++i)
+	{
+		std::ostringstream str;
+		Base64Encoder encoder(str);
+		encoder.write(src.data(), static_cast<std::streamsize>(src.size()));
+		encoder.close();
+	}
+	sw.stop();
+	std::cout << "Base64Encoder (write): " << sw.elapsed()/1000 << " ms" << std::endl;
+
+	std::string encoded(Base64Encoder::encodedLength(src.size()), '\0');
+	sw.restart();
+	for (int i = 0; i < iterations; ++i)
+	{
+		Base64Encoder::encode(src.data(), src.size(), &encoded[0]);
+	}
+	sw.stop();
+	std::cout << "Base64Encoder::encode: " << sw.elapsed()/1000 << " ms" << std::endl;
+
+	sw.restart();
+	for (int i = 0; i < iterations; ++i)
+	{
+		std::istringstream istr(encoded);
+		Base64Decoder decoder(istr);
+		std::string decoded;
+		int c = decoder.get();
+		while (c != -1) { decoded += char(c); c = decoder.get(); }
+	}
+	sw.stop();
+	std::cout << "Base64Decoder (get):   " << sw.elapsed()/1000 << " ms" << std::endl;
+
+	std::string decoded(Base64Decoder::decodedLength(encoded.size()), '\0');
+	sw.restart();
+	for (int i = 0; i < iterations; ++i)
+	{
+		Base64Decoder::decode(encoded.data(), encoded.size(), &decoded[0]);
+	}
+	sw.stop();
+	std::cout << "Base64Decoder::decode: " << sw.elapsed()/1000 << " ms" << std::endl;
+}
+
+
 void Base64Test::setUp()
 {
 }
@@ -364,6 +545,10 @@ CppUnit::Test* Base64Test::suite()
 	CppUnit_addTest(pSuite, Base64Test, testDecoderURL);
 	CppUnit_addTest(pSuite, Base64Test, testDecoderNoPadding);
 	CppUnit_addTest(pSuite, Base64Test, testEncodeDecode);
+	CppUnit_addTest(pSuite, Base64Test, testBulkEncodeDecode);
+	CppUnit_addTest(pSuite, Base64Test, testBulkDecodeInvalid);
+	CppUnit_addTest(pSuite, Base64Test, testBulkWrite);
+	// CppUnit_addTest(pSuite, Base64Test, testPerformance);
 
 	return pSuite;
 }
@@ -31,6 +31,10 @@ public:
 	void testDecoderURL();
 	void testDecoderNoPadding();
 	void testEncodeDecode();
+	void testBulkEncodeDecode();
+	void testBulkDecodeInvalid();
+	void testBulkWrite();
+	void testPerformance();
 
 	void setUp();
 	void tearDown();
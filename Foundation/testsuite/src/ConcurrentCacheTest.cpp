@@ -0,0 +1,402 @@
+//
+// ConcurrentCacheTest.cpp
+//
+// Copyright (c) 2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "ConcurrentCacheTest.h"
+#include "Poco/CppUnit/TestCaller.h"
+#include "Poco/CppUnit/TestSuite.h"
+#include "Poco/Exception.h"
+#include "Poco/ConcurrentLRUCache.h"
+#include "Poco/ConcurrentExpireLRUCache.h"
+#include "Poco/ConcurrentAccessExpireLRUCache.h"
+#include "Poco/LRUCache.h"
+#include "Poco/Delegate.h"
+#include "Poco/Thread.h"
+#include "Poco/Runnable.h"
+#include "Poco/Stopwatch.h"
+#include <iostream>
+
+
+using namespace Poco;
+
+
+#define DURSLEEP 250
+#define DURHALFSLEEP DURSLEEP / 2
+#define DURWAIT  300
+
+
+namespace
+{
+	template <class C>
+	class CacheUser: public Runnable
+	{
+	public:
+		CacheUser(C& cache, int offset, int reps):
+			_cache(cache),
+			_offset(offset),
+			_reps(reps),
+			_ok(true)
+		{
+		}
+
+		void run()
+		{
+			for (int r = 0; r < _reps; ++r)
+			{
+				int key = _offset + r % 200;
+				_cache.add(key, key*2);
+				SharedPtr<int> pVal = _cache.get(key);
+				if (pVal && *pVal != key*2) _ok = false;
+				pVal = _cache.get(r % 200);
+				if (pVal && *pVal != (r % 200)*2) _ok = false;
+			}
+		}
+
+		bool ok() const
+		{
+			return _ok;
+		}
+
+	private:
+		C& _cache;
+		int _offset;
+		int _reps;
+		bool _ok;
+	};
+}
+
+
+ConcurrentCacheTest::ConcurrentCacheTest(const std::string& rName):
+	CppUnit::TestCase(rName),
+	_addCnt(0),
+	_updateCnt(0),
+	_removeCnt(0)
+{
+}
+
+
+ConcurrentCacheTest::~ConcurrentCacheTest()
+{
+}
+
+
+void ConcurrentCacheTest::testClear()
+{
+	ConcurrentLRUCache<int, int> aCache(3);
+	assertTrue (aCache.size() == 0);
+	assertTrue (aCache.getAllKeys().size() == 0);
+	aCache.add(1, 2);
+	aCache.add(3, 4);
+	aCache.add(5, 6);
+	assertTrue (aCache.size() == 3);
+	assertTrue (aCache.getAllKeys().size() == 3);
+	assertTrue (aCache.has(1));
+	assertTrue (aCache.has(3));
+	assertTrue (aCache.has(5));
+	assertTrue (*aCache.get(1) == 2);
+	assertTrue (*aCache.get(3) == 4);
+	assertTrue (*aCache.get(5) == 6);
+	aCache.clear();
+	assertTrue (!aCache.has(1));
+	assertTrue (!aCache.has(3));
+	assertTrue (!aCache.has(5));
+	assertTrue (aCache.size() == 0);
+}
+
+
+void ConcurrentCacheTest::testCacheSize0()
+{
+	// cache size 0 is illegal
+	try
+	{
+		ConcurrentLRUCache<int, int> aCache(0);
+		failmsg ("cache size of 0 is illegal, test should fail");
+	}
+	catch (Poco::InvalidArgumentException&)
+	{
+	}
+}
+
+
+void ConcurrentCacheTest::testCacheSize1()
+{
+	ConcurrentLRUCache<int, int> aCache(1);
+	assertTrue (aCache.capacity() == 1);
+	aCache.add(1, 2);
+	assertTrue (aCache.has(1));
+	assertTrue (*aCache.get(1) == 2);
+
+	aCache.add(3, 4); // replaces 1
+	assertTrue (!aCache.has(1));
+	assertTrue (aCache.has(3));
+	assertTrue (*aCache.get(3) == 4);
+
+	aCache.add(5, 6);
+	assertTrue (!aCache.has(1));
+	assertTrue (!aCache.has(3));
+	assertTrue (aCache.has(5));
+	assertTrue (*aCache.get(5) == 6);
+
+	aCache.remove(5);
+	assertTrue (!aCache.has(5));
+
+	// removing illegal entries should work too
+	aCache.remove(666);
+}
+
+
+void ConcurrentCacheTest::testCacheSizeN()
+{
+	// a single shard behaves like a CLOCK cache
+	ConcurrentLRUCache<int, int> aCache(3, 1);
+	aCache.add(1, 2);
+	aCache.add(3, 4);
+	aCache.add(5, 6);
+	assertTrue (aCache.size() == 3);
+
+	// 1 and 5 have been accessed recently, so 3 is replaced
+	assertTrue (*aCache.get(1) == 2);
+	assertTrue (*aCache.get(5) == 6);
+	aCache.add(7, 8);
+	assertTrue (aCache.has(1));
+	assertTrue (!aCache.has(3));
+	assertTrue (aCache.has(5));
+	assertTrue (aCache.has(7));
+	assertTrue (aCache.size() == 3);
+
+	// with no further accesses, entries are replaced in order
+	aCache.add(9, 10);
+	aCache.add(11, 12);
+	aCache.add(13, 14);
+	assertTrue (aCache.size() == 3);
+	assertTrue (aCache.has(9));
+	assertTrue (aCache.has(11));
+	assertTrue (aCache.has(13));
+
+	// a sharded cache never holds more than its capacity
+	ConcurrentLRUCache<int, int> shardedCache(64, 8);
+	assertTrue (shardedCache.capacity() == 64);
+	for (int i = 0; i < 1000; ++i)
+	{
+		shardedCache.add(i, i);
+		assertTrue (*shardedCache.get(i) == i);
+	}
+	assertTrue (shardedCache.size() <= 64);
+	assertTrue (shardedCache.size() > 32);
+}
+
+
+void ConcurrentCacheTest::testUpdate()
+{
+	_addCnt = 0;
+	_updateCnt = 0;
+	_removeCnt = 0;
+	ConcurrentLRUCache<int, int> aCache(3, 1);
+	aCache.Add += delegate(this, &ConcurrentCacheTest::onAdd);
+	aCache.Update += delegate(this, &ConcurrentCacheTest::onUpdate);
+	aCache.Remove += delegate(this, &ConcurrentCacheTest::onRemove);
+	aCache.update(1, 2);
+	assertTrue (aCache.has(1));
+	assertTrue (*aCache.get(1) == 2);
+	aCache.update(1, 3);
+	assertTrue (*aCache.get(1) == 3);
+	assertTrue (_addCnt == 1);
+	assertTrue (_updateCnt == 1);
+	assertTrue (_removeCnt == 0);
+
+	aCache.add(1, 4);
+	assertTrue (*aCache.get(1) == 4);
+	assertTrue (_addCnt == 2);
+	assertTrue (_removeCnt == 1);
+
+	aCache.add(2, 4);
+	aCache.add(3, 4);
+	aCache.add(4, 4);
+	assertTrue (_addCnt == 5);
+	assertTrue (_removeCnt == 2);
+	assertTrue (aCache.has(1)); // recently accessed
+	assertTrue (!aCache.has(2));
+
+	aCache.Add -= delegate(this, &ConcurrentCacheTest::onAdd);
+	aCache.Update -= delegate(this, &ConcurrentCacheTest::onUpdate);
+	aCache.Remove -= delegate(this, &ConcurrentCacheTest::onRemove);
+	aCache.add(5, 5);
+	assertTrue (_addCnt == 5);
+	assertTrue (_removeCnt == 2);
+}
+
+
+void ConcurrentCacheTest::testExpire()
+{
+	ConcurrentExpireLRUCache<int, int> aCache(10, DURSLEEP);
+	aCache.add(1, 2);
+	assertTrue (aCache.has(1));
+	SharedPtr<int> tmp = aCache.get(1);
+	assertTrue (!tmp.isNull());
+	assertTrue (*tmp == 2);
+	assertTrue (aCache.size() == 1);
+	Thread::sleep(DURWAIT);
+	assertTrue (aCache.size() == 0);
+	assertTrue (!aCache.has(1));
+
+	// tmp must still be valid, access it
+	assertTrue (*tmp == 2);
+	tmp = aCache.get(1);
+	assertTrue (tmp.isNull());
+
+	aCache.add(1, 2);
+	Thread::sleep(DURHALFSLEEP);
+	aCache.add(3, 4);
+	assertTrue (aCache.has(1));
+	assertTrue (aCache.has(3));
+	Thread::sleep(DURHALFSLEEP + 50); //3|1
+	assertTrue (!aCache.has(1));
+	assertTrue (*aCache.get(3) == 4);
+	Thread::sleep(DURHALFSLEEP + 25); //3|1
+	assertTrue (!aCache.has(3));
+	assertTrue (aCache.get(3).isNull());
+}
+
+
+void ConcurrentCacheTest::testAccessExpire()
+{
+	ConcurrentAccessExpireLRUCache<int, int> aCache(10, DURSLEEP);
+	aCache.add(1, 2);
+	aCache.add(3, 4);
+	for (int i = 0; i < 4; ++i)
+	{
+		Thread::sleep(DURHALFSLEEP);
+		assertTrue (*aCache.get(1) == 2);
+	}
+	assertTrue (aCache.has(1));
+	assertTrue (!aCache.has(3));
+	Thread::sleep(DURWAIT);
+	assertTrue (!aCache.has(1));
+	assertTrue (aCache.get(1).isNull());
+	assertTrue (aCache.size() == 0);
+}
+
+
+void ConcurrentCacheTest::testConcurrentAccess()
+{
+	ConcurrentLRUCache<int, int> aCache(256);
+	CacheUser<ConcurrentLRUCache<int, int> > user1(aCache, 0, 20000);
+	CacheUser<ConcurrentLRUCache<int, int> > user2(aCache, 100, 20000);
+	CacheUser<ConcurrentLRUCache<int, int> > user3(aCache, 1000, 20000);
+	Thread t1;
+	Thread t2;
+	Thread t3;
+	t1.start(user1);
+	t2.start(user2);
+	t3.start(user3);
+	t1.join();
+	t2.join();
+	t3.join();
+	assertTrue (user1.ok());
+	assertTrue (user2.ok());
+	assertTrue (user3.ok());
+	assertTrue (aCache.size() <= 256);
+}
+
+
+void ConcurrentCacheTest::cacheBenchmark()
+{
+	const int threads = 8;
+	const int reps = 200000;
+	Stopwatch sw;
+
+	{
+		LRUCache<int, int> aCache(1024);
+		std::vector<CacheUser<LRUCache<int, int> >*> users;
+		std::vector<Thread*> workers;
+		for (int i = 0; i < threads; ++i)
+		{
+			users.push_back(new CacheUser<LRUCache<int, int> >(aCache, i*100, reps));
+			workers.push_back(new Thread);
+		}
+		sw.restart();
+		for (int i = 0; i < threads; ++i) workers[i]->start(*users[i]);
+		for (int i = 0; i < threads; ++i) workers[i]->join();
+		sw.stop();
+		std::cout << '\n' << threads << " threads, " << reps << "x add()/get()\n";
+		std::cout << "LRUCache=" << sw.elapsed() / 1000 << std::endl;
+		for (int i = 0; i < threads; ++i)
+		{
+			delete workers[i];
+			delete users[i];
+		}
+	}
+
+	{
+		ConcurrentLRUCache<int, int> aCache(1024);
+		std::vector<CacheUser<ConcurrentLRUCache<int, int> >*> users;
+		std::vector<Thread*> workers;
+		for (int i = 0; i < threads; ++i)
+		{
+			users.push_back(new CacheUser<ConcurrentLRUCache<int, int> >(aCache, i*100, reps));
+			workers.push_back(new Thread);
+		}
+		sw.restart();
+		for (int i = 0; i < threads; ++i) workers[i]->start(*users[i]);
+		for (int i = 0; i < threads; ++i) workers[i]->join();
+		sw.stop();
+		std::cout << "ConcurrentLRUCache=" << sw.elapsed() / 1000 << std::endl;
+		for (int i = 0; i < threads; ++i)
+		{
+			delete workers[i];
+			delete users[i];
+		}
+	}
+}
+
+
+void ConcurrentCacheTest::onAdd(const void* pSender, const Poco::KeyValueArgs<int, int>& args)
+{
+	++_addCnt;
+}
+
+
+void ConcurrentCacheTest::onUpdate(const void* pSender, const Poco::KeyValueArgs<int, int>& args)
+{
+	++_updateCnt;
+}
+
+
+void ConcurrentCacheTest::onRemove(const void* pSender, const int& args)
+{
+	++_removeCnt;
+}
+
+
+void ConcurrentCacheTest::setUp()
+{
+}
+
+
+void ConcurrentCacheTest::tearDown()
+{
+}
+
+
+CppUnit::Test* ConcurrentCacheTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("ConcurrentCacheTest");
+
+	CppUnit_addTest(pSuite, ConcurrentCacheTest, testClear);
+	CppUnit_addTest(pSuite, ConcurrentCacheTest, testCacheSize0);
+	CppUnit_addTest(pSuite, ConcurrentCacheTest, testCacheSize1);
+	CppUnit_addTest(pSuite, ConcurrentCacheTest, testCacheSizeN);
+	CppUnit_addTest(pSuite, ConcurrentCacheTest, testUpdate);
+	CppUnit_addTest(pSuite, ConcurrentCacheTest, testExpire);
+	CppUnit_addTest(pSuite, ConcurrentCacheTest, testAccessExpire);
+	CppUnit_addTest(pSuite, ConcurrentCacheTest, testConcurrentAccess);
+	//CppUnit_addTest(pSuite, ConcurrentCacheTest, cacheBenchmark);
+
+	return pSuite;
+}
@@ -0,0 +1,53 @@
+//
+// ConcurrentCacheTest.h
+//
+// Tests for ConcurrentLRUCache, ConcurrentExpireLRUCache and ConcurrentAccessExpireLRUCache
+//
+// Copyright (c) 2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef ConcurrentCacheTest_INCLUDED
+#define ConcurrentCacheTest_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include "Poco/KeyValueArgs.h"
+#include "Poco/CppUnit/TestCase.h"
+
+
+class ConcurrentCacheTest: public CppUnit::TestCase
+{
+public:
+	ConcurrentCacheTest(const std::string& name);
+	~ConcurrentCacheTest();
+
+	void testClear();
+	void testCacheSize0();
+	void testCacheSize1();
+	void testCacheSizeN();
+	void testUpdate();
+	void testExpire();
+	void testAccessExpire();
+	void testConcurrentAccess();
+	void cacheBenchmark();
+
+	void setUp();
+	void tearDown();
+	static CppUnit::Test* suite();
+
+private:
+	void onAdd(const void* pSender, const Poco::KeyValueArgs<int, int>& args);
+	void onUpdate(const void* pSender, const Poco::KeyValueArgs<int, int>& args);
+	void onRemove(const void* pSender, const int& args);
+
+	int _addCnt;
+	int _updateCnt;
+	int _removeCnt;
+};
+
+
+#endif // ConcurrentCacheTest_INCLUDED
@@ -25,6 +25,9 @@
 #include "Poco/BasicEvent.h"
 #include "Poco/Delegate.h"
 #include "Poco/Checksum.h"
+#include "Poco/Checksum32.h"
+#include "Poco/Checksum64.h"
+#include "Poco/Stopwatch.h"
 #include "Poco/MakeUnique.h"
 #include "Poco/Exception.h"
 #include <iostream>
@@ -48,6 +51,8 @@ using Poco::delegate;
 using Poco::NullType;
 using Poco::InvalidAccessException;
 using Poco::Checksum;
+using Poco::Checksum32;
+using Poco::Checksum64;
 using Poco::makeUnique;
 
 
@@ -652,6 +657,132 @@ void CoreTest::testChecksum64()
 }
 
 
+namespace
+{
+	Poco::UInt32 bitwiseCRC(Poco::UInt32 poly, const char* data, std::size_t length)
+	{
+		Poco::UInt32 crc = 0xFFFFFFFF;
+		for (std::size_t i = 0; i < length; ++i)
+		{
+			crc ^= static_cast<unsigned char>(data[i]);
+			for (int k = 0; k < 8; ++k) crc = (crc >> 1) ^ ((crc & 1) ? poly : 0);
+		}
+		return ~crc;
+	}
+}
+
+
+void CoreTest::testChecksumCRC32()
+{
+	const std::string check("123456789");
+	Checksum crc32(Checksum::TYPE_CRC32);
+	crc32.update(check);
+	assertTrue (crc32.checksum() == 0xCBF43926);
+
+	Checksum crc32c(Checksum::TYPE_CRC32C);
+	assertTrue (crc32c.type() == Checksum::TYPE_CRC32C);
+	assertTrue (crc32c.checksum() == 0);
+	crc32c.update(check);
+	assertTrue (crc32c.checksum() == 0xE3069283);
+
+	std::vector<char> data(1200);
+	for (std::size_t i = 0; i < data.size(); ++i) data[i] = static_cast<char>(i*31 + (i >> 3));
+
+	for (std::size_t offset = 0; offset < 8; ++offset)
+	{
+		for (std::size_t length = 0; length + offset <= data.size(); length += (length < 300 ? 1 : 97))
+		{
+			const char* p = &data[offset];
+			assertTrue (Checksum32::updateCRC32(0, p, length) == bitwiseCRC(0xEDB88320, p, length));
+			assertTrue (Checksum32::updateCRC32C(0, p, length) == bitwiseCRC(0x82F63B78, p, length));
+		}
+	}
+
+	for (std::size_t split = 0; split < 300; split += 7)
+	{
+		Checksum cs(Checksum::TYPE_CRC32C);
+		cs.update(&data[0], static_cast<unsigned>(split));
+		cs.update(&data[split], static_cast<unsigned>(data.size() - split));
+		assertTrue (cs.checksum() == bitwiseCRC(0x82F63B78, &data[0], data.size()));
+
+		Poco::UInt32 crc = Checksum32::updateCRC32(0, &data[0], split);
+		crc = Checksum32::updateCRC32(crc, &data[split], data.size() - split);
+		assertTrue (crc == bitwiseCRC(0xEDB88320, &data[0], data.size()));
+	}
+}
+
+
+void CoreTest::testChecksumXXH64()
+{
+	assertTrue (Checksum64::xxHash64("", 0) == 0xEF46DB3751D8E999ULL);
+	assertTrue (Checksum64::xxHash64("a", 1) == 0xD24EC4F1A98C6E5BULL);
+	assertTrue (Checksum64::xxHash64("abc", 3) == 0x44BC2CF5AD770999ULL);
+	const std::string text("Nobody inspects the spammish repetition");
+	assertTrue (Checksum64::xxHash64(text.data(), text.size()) == 0xFBCEA83C8A378BF1ULL);
+	assertTrue (Checksum64::xxHash64("xxhash", 6, 20141025) == 0xB559B98D844E0635ULL);
+
+	Checksum empty(Checksum::TYPE_XXH64);
+	assertTrue (empty.type() == Checksum::TYPE_XXH64);
+	assertTrue (empty.checksum() == 0xEF46DB3751D8E999ULL);
+
+	Checksum64 seeded(Checksum64::TYPE_XXH64_IMPL, 20141025);
+	seeded.update("xxh");
+	seeded.update("ash");
+	assertTrue (seeded.checksum() == 0xB559B98D844E0635ULL);
+
+	std::vector<char> data(300);
+	for (std::size_t i = 0; i < data.size(); ++i) data[i] = static_cast<char>(i*31 + (i >> 3));
+	for (std::size_t length = 0; length < data.size(); length += 13)
+	{
+		Poco::UInt64 expected = Checksum64::xxHash64(&data[0], length);
+		for (std::size_t chunk = 1; chunk < 70; chunk += 6)
+		{
+			Checksum cs(Checksum::TYPE_XXH64);
+			for (std::size_t pos = 0; pos < length; pos += chunk)
+			{
+				cs.update(&data[pos], static_cast<unsigned>(pos + chunk > length ? length - pos : chunk));
+			}
+			assertTrue (cs.checksum() == expected);
+		}
+	}
+
+	try
+	{
+		Checksum64 cs(Checksum64::TYPE_CRC32_IMPL);
+		fail ("unsupported type - must throw");
+	}
+	catch (Poco::InvalidArgumentException&)
+	{
+	}
+}
+
+
+void CoreTest::testChecksumPerformance()
+{
+	std::vector<char> data(16*1024*1024);
+	for (std::size_t i = 0; i < data.size(); ++i) data[i] = static_cast<char>(i*31 + (i >> 3));
+	const int iterations = 20;
+	const double megabytes = double(iterations)*data.size()/(1024*1024);
+
+	static const Checksum::Type types[] = { Checksum::TYPE_ADLER32, Checksum::TYPE_CRC32, Checksum::TYPE_CRC32C, Checksum::TYPE_XXH64 };
+	static const char* names[] = { "Adler-32", "CRC-32", "CRC-32C", "XXH64" };
+	for (int t = 0; t < 4; ++t)
+	{
+		Checksum cs(types[t]);
+		Poco::Stopwatch sw;
+		sw.start();
+		for (int i = 0; i < iterations; ++i)
+		{
+			cs.update(&data[0], static_cast<unsigned>(data.size()));
+		}
+		sw.stop();
+		std::cout << names[t] << ": " << megabytes*1000000/sw.elapsed() << " MB/s";
+		if (Checksum32::isHardwareAccelerated(static_cast<Poco::ChecksumImpl::Type>(types[t]))) std::cout << " (hardware)";
+		std::cout << std::endl;
+	}
+}
+
+
 void CoreTest::testMakeUnique()
 {
 	assertTrue (*makeUnique<int>() == 0);
@@ -695,6 +826,9 @@ CppUnit::Test* CoreTest::suite()
 	CppUnit_addTest(pSuite, CoreTest, testNullable);
 	CppUnit_addTest(pSuite, CoreTest, testAscii);
 	CppUnit_addTest(pSuite, CoreTest, testChecksum64);
+	CppUnit_addTest(pSuite, CoreTest, testChecksumCRC32);
+	CppUnit_addTest(pSuite, CoreTest, testChecksumXXH64);
+	// CppUnit_addTest(pSuite, CoreTest, testChecksumPerformance);
 	CppUnit_addTest(pSuite, CoreTest, testMakeUnique);
 
 	return pSuite;
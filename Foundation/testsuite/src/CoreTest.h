@@ -35,6 +35,9 @@ public:
 	void testNullable();
 	void testAscii();
 	void testChecksum64();
+	void testChecksumCRC32();
+	void testChecksumXXH64();
+	void testChecksumPerformance();
 	void testMakeUnique();
 
 	void setUp();
@@ -26,6 +26,8 @@
 #include "Poco/NumberFormatter.h"
 #include "Poco/DirectoryIterator.h"
 #include "Poco/Exception.h"
+#include "Poco/FileStream.h"
+#include "Poco/LZ4Stream.h"
 #include <vector>
 
 
@@ -44,6 +46,8 @@ using Poco::DateTimeFormatter;
 using Poco::DateTimeFormat;
 using Poco::DirectoryIterator;
 using Poco::InvalidArgumentException;
+using Poco::FileInputStream;
+using Poco::LZ4InputStream;
 
 
 FileChannelTest::FileChannelTest(const std::string& rName): CppUnit::TestCase(rName)
@@ -343,6 +347,43 @@ void FileChannelTest::testCompress()
 }
 
 
+void FileChannelTest::testCompressLZ4()
+{
+	std::string name = filename();
+	try
+	{
+		AutoPtr<FileChannel> pChannel = new FileChannel(name);
+		pChannel->setProperty(FileChannel::PROP_ROTATION, "1 K");
+		pChannel->setProperty(FileChannel::PROP_ARCHIVE, "number");
+		pChannel->setProperty(FileChannel::PROP_COMPRESS, "lz4");
+		assertTrue (pChannel->getProperty(FileChannel::PROP_COMPRESS) == "lz4");
+		pChannel->open();
+		Message msg("source", "This is a log file entry", Message::PRIO_INFORMATION);
+		for (int i = 0; i < 200; ++i)
+		{
+			pChannel->log(msg);
+		}
+		Thread::sleep(3000); // allow time for background compression
+		File f0(name + ".0.lz4");
+		assertTrue (f0.exists());
+		File f1(name + ".1.lz4");
+		assertTrue (f1.exists());
+
+		FileInputStream istr(name + ".0.lz4");
+		LZ4InputStream decompressor(istr);
+		std::string line;
+		std::getline(decompressor, line);
+		assertTrue (line == "This is a log file entry");
+	}
+	catch (...)
+	{
+		remove(name);
+		throw;
+	}
+	remove(name);
+}
+
+
 void FileChannelTest::purgeAge(const std::string& pa)
 {
 	std::string name = filename();
@@ -644,6 +685,7 @@ CppUnit::Test* FileChannelTest::suite()
 	CppUnit_addTest(pSuite, FileChannelTest, testRotateAtTimeMinLocal);
 	CppUnit_addTest(pSuite, FileChannelTest, testArchive);
 	CppUnit_addTest(pSuite, FileChannelTest, testCompress);
+	CppUnit_addTest(pSuite, FileChannelTest, testCompressLZ4);
 	CppUnit_addTest(pSuite, FileChannelTest, testPurgeAge);
 	CppUnit_addTest(pSuite, FileChannelTest, testPurgeCount);
 	CppUnit_addTest(pSuite, FileChannelTest, testWrongPurgeOption);
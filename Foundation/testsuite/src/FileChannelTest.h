@@ -41,6 +41,7 @@ public:
 	void testRotateAtTimeMinLocal();
 	void testArchive();
 	void testCompress();
+	void testCompressLZ4();
 	void testPurgeAge();
 	void testPurgeCount();
 	void testWrongPurgeOption();
@@ -12,6 +12,7 @@
 #include "PathTest.h"
 #include "FileTest.h"
 #include "GlobTest.h"
+#include "MappedFileTest.h"
 #include "DirectoryWatcherTest.h"
 #include "DirectoryIteratorsTest.h"
 
@@ -23,6 +24,7 @@ CppUnit::Test* FilesystemTestSuite::suite()
 	pSuite->addTest(PathTest::suite());
 	pSuite->addTest(FileTest::suite());
 	pSuite->addTest(GlobTest::suite());
+	pSuite->addTest(MappedFileTest::suite());
 #ifndef POCO_NO_INOTIFY
 	pSuite->addTest(DirectoryWatcherTest::suite());
 #endif // POCO_NO_INOTIFY
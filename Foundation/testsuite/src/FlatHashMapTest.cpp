@@ -0,0 +1,396 @@
+//
+// FlatHashMapTest.cpp
+//
+// Copyright (c) 2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "FlatHashMapTest.h"
+#include "Poco/CppUnit/TestCaller.h"
+#include "Poco/CppUnit/TestSuite.h"
+#include "Poco/FlatHashMap.h"
+#include "Poco/HashMap.h"
+#include "Poco/Stopwatch.h"
+#include "Poco/NumberFormatter.h"
+#include "Poco/Exception.h"
+#include <unordered_map>
+#include <vector>
+#include <string>
+#include <map>
+#include <iostream>
+
+
+using Poco::FlatHashMap;
+using Poco::HashMap;
+using Poco::Hash;
+using Poco::Stopwatch;
+using Poco::NumberFormatter;
+
+
+FlatHashMapTest::FlatHashMapTest(const std::string& rName): CppUnit::TestCase(rName)
+{
+}
+
+
+FlatHashMapTest::~FlatHashMapTest()
+{
+}
+
+
+void FlatHashMapTest::testInsert()
+{
+	const int N = 1000;
+
+	typedef FlatHashMap<int, int> IntMap;
+	IntMap hm;
+	
+	assertTrue (hm.empty());
+	
+	for (int i = 0; i < N; ++i)
+	{
+		std::pair<IntMap::Iterator, bool> res = hm.insert(IntMap::ValueType(i, i*2));
+		assertTrue (res.first->first == i);
+		assertTrue (res.first->second == i*2);
+		assertTrue (res.second);
+		IntMap::Iterator it = hm.find(i);
+		assertTrue (it != hm.end());
+		assertTrue (it->first == i);
+		assertTrue (it->second == i*2);
+		assertTrue (hm.count(i) == 1);
+		assertTrue (hm.size() == static_cast<std::size_t>(i + 1));
+	}		
+	
+	assertTrue (!hm.empty());
+	
+	for (int i = 0; i < N; ++i)
+	{
+		IntMap::Iterator it = hm.find(i);
+		assertTrue (it != hm.end());
+		assertTrue (it->first == i);
+		assertTrue (it->second == i*2);
+	}
+	
+	for (int i = 0; i < N; ++i)
+	{
+		std::pair<IntMap::Iterator, bool> res = hm.insert(IntMap::ValueType(i, 0));
+		assertTrue (res.first->first == i);
+		assertTrue (res.first->second == i*2);
+		assertTrue (!res.second);
+	}		
+}
+
+
+void FlatHashMapTest::testErase()
+{
+	const int N = 1000;
+
+	typedef FlatHashMap<int, int> IntMap;
+	IntMap hm;
+
+	for (int i = 0; i < N; ++i)
+	{
+		hm.insert(IntMap::ValueType(i, i*2));
+	}
+	assertTrue (hm.size() == N);
+	
+	for (int i = 0; i < N; i += 2)
+	{
+		hm.erase(i);
+		IntMap::Iterator it = hm.find(i);
+		assertTrue (it == hm.end());
+	}
+	assertTrue (hm.size() == N/2);
+	
+	for (int i = 0; i < N; i += 2)
+	{
+		IntMap::Iterator it = hm.find(i);
+		assertTrue (it == hm.end());
+	}
+	
+	for (int i = 1; i < N; i += 2)
+	{
+		IntMap::Iterator it = hm.find(i);
+		assertTrue (it != hm.end());
+		assertTrue (*it == i);
+	}
+
+	for (int i = 0; i < N; i += 2)
+	{
+		hm.insert(IntMap::ValueType(i, i*2));
+	}
+	
+	for (int i = 0; i < N; ++i)
+	{
+		IntMap::Iterator it = hm.find(i);
+		assertTrue (it != hm.end());
+		assertTrue (it->first == i);
+		assertTrue (it->second == i*2);		
+	}
+}
+
+
+void FlatHashMapTest::testIterator()
+{
+	const int N = 1000;
+
+	typedef FlatHashMap<int, int> IntMap;
+	IntMap hm;
+
+	for (int i = 0; i < N; ++i)
+	{
+		hm.insert(IntMap::ValueType(i, i*2));
+	}
+	
+	std::map<int, int> values;
+	IntMap::Iterator it; // do not initialize here to test proper behavior of uninitialized iterators
+	it = hm.begin();
+	while (it != hm.end())
+	{
+		assertTrue (values.find(it->first) == values.end());
+		values[it->first] = it->second;
+		++it;
+	}
+	
+	assertTrue (values.size() == N);
+}
+
+
+void FlatHashMapTest::testConstIterator()
+{
+	const int N = 1000;
+
+	typedef FlatHashMap<int, int> IntMap;
+	IntMap hm;
+
+	for (int i = 0; i < N; ++i)
+	{
+		hm.insert(IntMap::ValueType(i, i*2));
+	}
+	
+	std::map<int, int> values;
+	IntMap::ConstIterator it = hm.begin();
+	while (it != hm.end())
+	{
+		assertTrue (values.find(it->first) == values.end());
+		values[it->first] = it->second;
+		++it;
+	}
+	
+	assertTrue (values.size() == N);
+}
+
+
+void FlatHashMapTest::testIndex()
+{
+	typedef FlatHashMap<int, int> IntMap;
+	IntMap hm;
+
+	hm[1] = 2;
+	hm[2] = 4;
+	hm[3] = 6;
+	
+	assertTrue (hm.size() == 3);
+	assertTrue (hm[1] == 2);
+	assertTrue (hm[2] == 4);
+	assertTrue (hm[3] == 6);
+	
+	try
+	{
+		const IntMap& im = hm;
+		(void) im[4];
+		fail("no such key - must throw");
+	}
+	catch (Poco::NotFoundException&)
+	{
+	}
+}
+
+
+void FlatHashMapTest::testStringKeys()
+{
+	const int N = 10000;
+
+	typedef FlatHashMap<std::string, int> StrMap;
+	StrMap hm;
+
+	for (int i = 0; i < N; ++i)
+	{
+		hm[NumberFormatter::format(i)] = i;
+	}
+	assertTrue (hm.size() == N);
+
+	// interleave erasure and insertion to exercise deleted slots
+	for (int r = 0; r < 4; ++r)
+	{
+		for (int i = r; i < N; i += 4)
+		{
+			hm.erase(NumberFormatter::format(i));
+		}
+		assertTrue (hm.size() == N - N/4);
+		for (int i = r; i < N; i += 4)
+		{
+			hm.insert(StrMap::PairType(NumberFormatter::format(i), i));
+		}
+		assertTrue (hm.size() == N);
+	}
+
+	for (int i = 0; i < N; ++i)
+	{
+		StrMap::ConstIterator it = hm.find(NumberFormatter::format(i));
+		assertTrue (it != hm.end());
+		assertTrue (it->second == i);
+	}
+	assertTrue (hm.find("x") == hm.end());
+
+	hm.clear();
+	assertTrue (hm.empty());
+	assertTrue (hm.begin() == hm.end());
+	assertTrue (hm.find("1") == hm.end());
+	hm["1"] = 1;
+	assertTrue (hm.size() == 1);
+	assertTrue (hm["1"] == 1);
+}
+
+
+void FlatHashMapTest::testCopy()
+{
+	typedef FlatHashMap<int, std::string> Map;
+	Map hm1;
+	for (int i = 0; i < 100; ++i)
+	{
+		hm1[i] = NumberFormatter::format(i);
+	}
+
+	Map hm2(hm1);
+	Map hm3;
+	assertTrue (hm3.begin() == hm3.end());
+	hm3 = hm1;
+	hm1.clear();
+	assertTrue (hm1.empty());
+	assertTrue (hm2.size() == 100);
+	assertTrue (hm3.size() == 100);
+	for (int i = 0; i < 100; ++i)
+	{
+		assertTrue (hm2[i] == NumberFormatter::format(i));
+		assertTrue (hm3[i] == NumberFormatter::format(i));
+	}
+
+	hm1.swap(hm2);
+	assertTrue (hm1.size() == 100);
+	assertTrue (hm2.empty());
+}
+
+
+namespace
+{
+	template <class Map>
+	void benchmarkInsertFind(const char* name, const std::vector<int>& keys)
+	{
+		Stopwatch sw;
+		Map map;
+		sw.start();
+		for (std::vector<int>::const_iterator it = keys.begin(); it != keys.end(); ++it)
+		{
+			map[*it] = *it;
+		}
+		sw.stop();
+		std::cout << "Insert " << name << ": " << sw.elapsed()/1000 << " ms" << std::endl;
+		sw.restart();
+		int found = 0;
+		for (std::vector<int>::const_iterator it = keys.begin(); it != keys.end(); ++it)
+		{
+			found += map.find(*it) != map.end();
+			found += map.find(-*it - 1) != map.end();
+		}
+		sw.stop();
+		std::cout << "Find " << name << ": " << sw.elapsed()/1000 << " ms (" << found << ")" << std::endl;
+	}
+
+	template <class Map>
+	void benchmarkInsertFind(const char* name, const std::vector<std::string>& keys)
+	{
+		Stopwatch sw;
+		Map map;
+		sw.start();
+		for (std::vector<std::string>::const_iterator it = keys.begin(); it != keys.end(); ++it)
+		{
+			map[*it] = 0;
+		}
+		sw.stop();
+		std::cout << "Insert " << name << ": " << sw.elapsed()/1000 << " ms" << std::endl;
+		sw.restart();
+		int found = 0;
+		for (std::vector<std::string>::const_iterator it = keys.begin(); it != keys.end(); ++it)
+		{
+			found += map.find(*it) != map.end();
+		}
+		sw.stop();
+		std::cout << "Find " << name << ": " << sw.elapsed()/1000 << " ms (" << found << ")" << std::endl;
+	}
+}
+
+
+void FlatHashMapTest::testPerformanceInt()
+{
+	const int N = 5000000;
+	std::vector<int> keys;
+	keys.reserve(N);
+	for (int i = 0; i < N; ++i)
+	{
+		// scatter the keys
+		keys.push_back(static_cast<int>((i*2654435761u) & 0x7FFFFFFF));
+	}
+
+	std::cout << std::endl;
+	benchmarkInsertFind<FlatHashMap<int, int> >("FlatHashMap", keys);
+	benchmarkInsertFind<HashMap<int, int> >("HashMap", keys);
+	benchmarkInsertFind<std::unordered_map<int, int> >("unordered_map", keys);
+}
+
+
+void FlatHashMapTest::testPerformanceStr()
+{
+	const int N = 1000000;
+	std::vector<std::string> keys;
+	keys.reserve(N);
+	for (int i = 0; i < N; ++i)
+	{
+		keys.push_back("/route/" + NumberFormatter::format(i*2654435761u));
+	}
+
+	std::cout << std::endl;
+	benchmarkInsertFind<FlatHashMap<std::string, int> >("FlatHashMap", keys);
+	benchmarkInsertFind<HashMap<std::string, int> >("HashMap", keys);
+	benchmarkInsertFind<std::unordered_map<std::string, int> >("unordered_map", keys);
+}
+
+
+void FlatHashMapTest::setUp()
+{
+}
+
+
+void FlatHashMapTest::tearDown()
+{
+}
+
+
+CppUnit::Test* FlatHashMapTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("FlatHashMapTest");
+
+	CppUnit_addTest(pSuite, FlatHashMapTest, testInsert);
+	CppUnit_addTest(pSuite, FlatHashMapTest, testErase);
+	CppUnit_addTest(pSuite, FlatHashMapTest, testIterator);
+	CppUnit_addTest(pSuite, FlatHashMapTest, testConstIterator);
+	CppUnit_addTest(pSuite, FlatHashMapTest, testIndex);
+	CppUnit_addTest(pSuite, FlatHashMapTest, testStringKeys);
+	CppUnit_addTest(pSuite, FlatHashMapTest, testCopy);
+	//CppUnit_addTest(pSuite, FlatHashMapTest, testPerformanceInt);
+	//CppUnit_addTest(pSuite, FlatHashMapTest, testPerformanceStr);
+
+	return pSuite;
+}
@@ -0,0 +1,214 @@
+//
+// FlatHashSetTest.cpp
+//
+// Copyright (c) 2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "FlatHashSetTest.h"
+#include "Poco/CppUnit/TestCaller.h"
+#include "Poco/CppUnit/TestSuite.h"
+#include "Poco/FlatHashSet.h"
+#include <set>
+
+
+using Poco::Hash;
+using Poco::FlatHashSet;
+
+
+FlatHashSetTest::FlatHashSetTest(const std::string& rName): CppUnit::TestCase(rName)
+{
+}
+
+
+FlatHashSetTest::~FlatHashSetTest()
+{
+}
+
+
+void FlatHashSetTest::testInsert()
+{
+	const int N = 1000;
+
+	FlatHashSet<int, Hash<int> > hs;
+	
+	assertTrue (hs.empty());
+	
+	for (int i = 0; i < N; ++i)
+	{
+		std::pair<FlatHashSet<int, Hash<int> >::Iterator, bool> res = hs.insert(i);
+		assertTrue (*res.first == i);
+		assertTrue (res.second);
+		FlatHashSet<int, Hash<int> >::Iterator it = hs.find(i);
+		assertTrue (it != hs.end());
+		assertTrue (*it == i);
+		assertTrue (hs.size() == static_cast<std::size_t>(i + 1));
+	}		
+	
+	assertTrue (!hs.empty());
+	
+	for (int i = 0; i < N; ++i)
+	{
+		FlatHashSet<int, Hash<int> >::Iterator it = hs.find(i);
+		assertTrue (it != hs.end());
+		assertTrue (*it == i);
+	}
+	
+	for (int i = 0; i < N; ++i)
+	{
+		std::pair<FlatHashSet<int, Hash<int> >::Iterator, bool> res = hs.insert(i);
+		assertTrue (*res.first == i);
+		assertTrue (!res.second);
+	}		
+}
+
+
+void FlatHashSetTest::testErase()
+{
+	const int N = 1000;
+
+	FlatHashSet<int, Hash<int> > hs;
+
+	for (int i = 0; i < N; ++i)
+	{
+		hs.insert(i);
+	}
+	assertTrue (hs.size() == N);
+	
+	for (int i = 0; i < N; i += 2)
+	{
+		hs.erase(i);
+		FlatHashSet<int, Hash<int> >::Iterator it = hs.find(i);
+		assertTrue (it == hs.end());
+	}
+	assertTrue (hs.size() == N/2);
+	
+	for (int i = 0; i < N; i += 2)
+	{
+		FlatHashSet<int, Hash<int> >::Iterator it = hs.find(i);
+		assertTrue (it == hs.end());
+	}
+
+	for (int i = 1; i < N; i += 2)
+	{
+		FlatHashSet<int, Hash<int> >::Iterator it = hs.find(i);
+		assertTrue (it != hs.end());
+		assertTrue (*it == i);
+	}
+
+	for (int i = 0; i < N; i += 2)
+	{
+		hs.insert(i);
+	}
+	
+	for (int i = 0; i < N; ++i)
+	{
+		FlatHashSet<int, Hash<int> >::Iterator it = hs.find(i);
+		assertTrue (it != hs.end());
+		assertTrue (*it == i);
+	}
+}
+
+
+void FlatHashSetTest::testIterator()
+{
+	const int N = 1000;
+
+	FlatHashSet<int, Hash<int> > hs;
+
+	for (int i = 0; i < N; ++i)
+	{
+		hs.insert(i);
+	}
+	
+	std::set<int> values;
+	FlatHashSet<int, Hash<int> >::Iterator it = hs.begin();
+	while (it != hs.end())
+	{
+		assertTrue (values.find(*it) == values.end());
+		values.insert(*it);
+		++it;
+	}
+
+	assertTrue (values.size() == N);
+}
+
+
+void FlatHashSetTest::testConstIterator()
+{
+	const int N = 1000;
+
+	FlatHashSet<int, Hash<int> > hs;
+
+	for (int i = 0; i < N; ++i)
+	{
+		hs.insert(i);
+	}
+	
+	std::set<int> values;
+	FlatHashSet<int, Hash<int> >::ConstIterator it = hs.begin();
+	while (it != hs.end())
+	{
+		assertTrue (values.find(*it) == values.end());
+		values.insert(*it);
+		++it;
+	}
+	
+	assertTrue (values.size() == N);
+}
+
+
+void FlatHashSetTest::testChurn()
+{
+	// keeps the number of elements constant while inserting
+	// and erasing many keys, leaving many deleted slots
+	const int N = 1000;
+
+	FlatHashSet<int, Hash<int> > hs(N);
+	for (int i = 0; i < N; ++i)
+	{
+		hs.insert(i);
+	}
+	for (int i = N; i < 100*N; ++i)
+	{
+		hs.erase(i - N);
+		hs.insert(i);
+		assertTrue (hs.size() == N);
+	}
+	for (int i = 99*N; i < 100*N; ++i)
+	{
+		assertTrue (hs.count(i) == 1);
+	}
+	for (int i = 0; i < 99*N; i += 97)
+	{
+		assertTrue (hs.count(i) == 0);
+	}
+	assertTrue (hs.size() == N);
+}
+
+
+void FlatHashSetTest::setUp()
+{
+}
+
+
+void FlatHashSetTest::tearDown()
+{
+}
+
+
+CppUnit::Test* FlatHashSetTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("FlatHashSetTest");
+
+	CppUnit_addTest(pSuite, FlatHashSetTest, testInsert);
+	CppUnit_addTest(pSuite, FlatHashSetTest, testErase);
+	CppUnit_addTest(pSuite, FlatHashSetTest, testIterator);
+	CppUnit_addTest(pSuite, FlatHashSetTest, testConstIterator);
+	CppUnit_addTest(pSuite, FlatHashSetTest, testChurn);
+
+	return pSuite;
+}
@@ -0,0 +1,42 @@
+//
+// FlatHashSetTest.h
+//
+// Definition of the FlatHashSetTest class.
+//
+// Copyright (c) 2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef FlatHashSetTest_INCLUDED
+#define FlatHashSetTest_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include "Poco/CppUnit/TestCase.h"
+
+
+class FlatHashSetTest: public CppUnit::TestCase
+{
+public:
+	FlatHashSetTest(const std::string& name);
+	~FlatHashSetTest();
+
+	void testInsert();
+	void testErase();
+	void testIterator();
+	void testConstIterator();
+	void testChurn();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+
+private:
+};
+
+
+#endif // FlatHashSetTest_INCLUDED
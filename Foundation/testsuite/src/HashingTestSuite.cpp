@@ -14,6 +14,8 @@
 #include "LinearHashTableTest.h"
 #include "HashSetTest.h"
 #include "HashMapTest.h"
+#include "FlatHashSetTest.h"
+#include "FlatHashMapTest.h"
 
 
 CppUnit::Test* HashingTestSuite::suite()
@@ -25,6 +27,8 @@ CppUnit::Test* HashingTestSuite::suite()
 	pSuite->addTest(LinearHashTableTest::suite());
 	pSuite->addTest(HashSetTest::suite());
 	pSuite->addTest(HashMapTest::suite());
+	pSuite->addTest(FlatHashSetTest::suite());
+	pSuite->addTest(FlatHashMapTest::suite());
 
 	return pSuite;
 }
@@ -183,6 +183,103 @@ void HexBinaryTest::testEncodeDecode()
 }
 
 
+void HexBinaryTest::testBulkEncodeDecode()
+{
+	for (int upper = 0; upper < 2; ++upper)
+	{
+		for (std::size_t n = 0; n < 100; ++n)
+		{
+			std::string src;
+			for (std::size_t i = 0; i < n; ++i) src += char(i*7 + n);
+
+			std::ostringstream str;
+			HexBinaryEncoder encoder(str);
+			encoder.rdbuf()->setLineLength(0);
+			encoder.rdbuf()->setUppercase(upper != 0);
+			for (std::size_t i = 0; i < n; ++i) encoder.put(src[i]);
+			encoder.close();
+
+			std::string encoded(HexBinaryEncoder::encodedLength(n), '\0');
+			std::size_t len = HexBinaryEncoder::encode(src.data(), n, &encoded[0], upper != 0);
+			assertTrue (len == encoded.size());
+			assertTrue (encoded == str.str());
+
+			std::string decoded(HexBinaryDecoder::decodedLength(len), '\0');
+			len = HexBinaryDecoder::decode(encoded.data(), encoded.size(), &decoded[0]);
+			assertTrue (len == n);
+			assertTrue (decoded == src);
+		}
+	}
+
+	std::string data("00 01\r\n0203 0\n4aB");
+	char buffer[8];
+	std::size_t n = HexBinaryDecoder::decode(data.data(), data.size(), buffer);
+	assertTrue (n == 6);
+	assertTrue (buffer[4] == 4);
+	assertTrue (static_cast<unsigned char>(buffer[5]) == 0xAB);
+
+	try
+	{
+		HexBinaryDecoder::decode("001", 3, buffer);
+		fail ("odd number of digits - must throw");
+	}
+	catch (DataFormatException&)
+	{
+	}
+	try
+	{
+		HexBinaryDecoder::decode("0g", 2, buffer);
+		fail ("invalid digit - must throw");
+	}
+	catch (DataFormatException&)
+	{
+	}
+	char longBuffer[32];
+	try
+	{
+		HexBinaryDecoder::decode("000102030405060708090a0b0c0d0e0G", 32, longBuffer);
+		fail ("invalid digit - must throw");
+	}
+	catch (DataFormatException&)
+	{
+	}
+
+	data = "00010203040506070809aAbBcCdDeEfF\n0f1E2d3C4b5A69788796a5B4c3D2e1F0";
+	n = HexBinaryDecoder::decode(data.data(), data.size(), longBuffer);
+	assertTrue (n == 32);
+	assertTrue (static_cast<unsigned char>(longBuffer[10]) == 0xAA);
+	assertTrue (static_cast<unsigned char>(longBuffer[15]) == 0xFF);
+	assertTrue (static_cast<unsigned char>(longBuffer[16]) == 0x0F);
+	assertTrue (static_cast<unsigned char>(longBuffer[31]) == 0xF0);
+}
+
+
+void HexBinaryTest::testBulkWrite()
+{
+	std::string src;
+	for (int i = 0; i < 5000; ++i) src += char(i*13);
+
+	static const int lineLengths[] = { 72, 0, 1, 7 };
+	for (int l = 0; l < 4; ++l)
+	{
+		std::ostringstream str1;
+		HexBinaryEncoder encoder1(str1);
+		encoder1.rdbuf()->setLineLength(lineLengths[l]);
+		for (std::size_t i = 0; i < src.size(); ++i) encoder1.put(src[i]);
+		encoder1.close();
+
+		std::ostringstream str2;
+		HexBinaryEncoder encoder2(str2);
+		encoder2.rdbuf()->setLineLength(lineLengths[l]);
+		encoder2.write(src.data(), 3);
+		encoder2.write(src.data() + 3, static_cast<std::streamsize>(src.size() - 3));
+		encoder2.close();
+
+		assertTrue (str1.str() == str2.str());
+	}
+}
+
+
 void HexBinaryTest::setUp()
 {
 }
@@ -200,6 +297,8 @@ CppUnit::Test* HexBinaryTest::suite()
 	CppUnit_addTest(pSuite, HexBinaryTest, testEncoder);
 	CppUnit_addTest(pSuite, HexBinaryTest, testDecoder);
 	CppUnit_addTest(pSuite, HexBinaryTest, testEncodeDecode);
+	CppUnit_addTest(pSuite, HexBinaryTest, testBulkEncodeDecode);
+	CppUnit_addTest(pSuite, HexBinaryTest, testBulkWrite);
 
 	return pSuite;
 }
@@ -27,6 +27,8 @@ public:
 	void testEncoder();
 	void testDecoder();
 	void testEncodeDecode();
+	void testBulkEncodeDecode();
+	void testBulkWrite();
 
 	void setUp();
 	void tearDown();
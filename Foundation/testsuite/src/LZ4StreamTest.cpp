@@ -0,0 +1,352 @@
+//
+// LZ4StreamTest.cpp
+//
+// Copyright (c) 2004-2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "LZ4StreamTest.h"
+#include "Poco/CppUnit/TestCaller.h"
+#include "Poco/CppUnit/TestSuite.h"
+#include "Poco/LZ4Stream.h"
+#include "Poco/DeflatingStream.h"
+#include "Poco/StreamCopier.h"
+#include "Poco/Exception.h"
+#include "Poco/Random.h"
+#include "Poco/Stopwatch.h"
+#include <sstream>
+#include <iostream>
+#include <vector>
+
+
+using Poco::LZ4StreamBuf;
+using Poco::LZ4InputStream;
+using Poco::LZ4OutputStream;
+using Poco::StreamCopier;
+using Poco::DataFormatException;
+
+
+namespace
+{
+	std::string makeText(std::size_t size)
+	{
+		Poco::Random rnd;
+		rnd.seed(7);
+		static const char* words[] = { "lorem", "ipsum", "dolor", "sit", "amet", "consectetur", "adipiscing", "elit", "sed", "do" };
+		std::string text;
+		while (text.size() < size)
+		{
+			text += words[rnd.next(10)];
+			text += rnd.next(8) == 0 ? '\n' : ' ';
+		}
+		text.resize(size);
+		return text;
+	}
+
+
+	std::string makeRandom(std::size_t size)
+	{
+		Poco::Random rnd;
+		rnd.seed(11);
+		std::string data(size, 0);
+		for (std::size_t i = 0; i < size; i++) data[i] = rnd.nextChar();
+		return data;
+	}
+
+
+	std::string compress(const std::string& data, LZ4StreamBuf::BlockSize blockSize = LZ4StreamBuf::BLOCK_64K)
+	{
+		std::ostringstream ostr;
+		LZ4OutputStream compressor(ostr, blockSize);
+		compressor.write(data.data(), static_cast<std::streamsize>(data.size()));
+		compressor.close();
+		return ostr.str();
+	}
+
+
+	std::string decompress(const std::string& data)
+	{
+		std::istringstream istr(data);
+		LZ4InputStream decompressor(istr);
+		decompressor.exceptions(std::ios::badbit);
+		std::string result;
+		StreamCopier::copyToString(decompressor, result);
+		return result;
+	}
+
+
+	std::string blockRoundTrip(const std::string& data, std::size_t& compressedSize)
+	{
+		std::vector<char> compressed(LZ4StreamBuf::compressBound(data.size()));
+		compressedSize = LZ4StreamBuf::compressBlock(data.data(), data.size(), &compressed[0]);
+		std::string result(data.size(), 0);
+		std::size_t n = LZ4StreamBuf::decompressBlock(&compressed[0], compressedSize, data.empty() ? 0 : &result[0], result.size());
+		result.resize(n);
+		return result;
+	}
+}
+
+
+LZ4StreamTest::LZ4StreamTest(const std::string& rName): CppUnit::TestCase(rName)
+{
+}
+
+
+LZ4StreamTest::~LZ4StreamTest()
+{
+}
+
+
+void LZ4StreamTest::testBlock()
+{
+	std::size_t compressedSize;
+	std::string text = makeText(60000);
+	assertTrue (blockRoundTrip(text, compressedSize) == text);
+	assertTrue (compressedSize < text.size()/2);
+
+	for (std::size_t size = 0; size < 40; size++)
+	{
+		std::string data = text.substr(0, size);
+		assertTrue (blockRoundTrip(data, compressedSize) == data);
+		assertTrue (compressedSize <= LZ4StreamBuf::compressBound(size));
+	}
+
+	std::string random = makeRandom(10000);
+	assertTrue (blockRoundTrip(random, compressedSize) == random);
+	assertTrue (compressedSize <= LZ4StreamBuf::compressBound(random.size()));
+}
+
+
+void LZ4StreamTest::testBlockOverlap()
+{
+	std::size_t compressedSize;
+	std::string run(100000, 'x');
+	assertTrue (blockRoundTrip(run, compressedSize) == run);
+	assertTrue (compressedSize < 500);
+
+	std::string pattern;
+	for (int i = 0; i < 5000; i++) pattern += "abcdefghij";
+	assertTrue (blockRoundTrip(pattern, compressedSize) == pattern);
+	assertTrue (compressedSize < 500);
+
+	std::string shortPattern;
+	for (int i = 0; i < 5000; i++) shortPattern += "abc";
+	assertTrue (blockRoundTrip(shortPattern, compressedSize) == shortPattern);
+}
+
+
+void LZ4StreamTest::testBlockCorrupt()
+{
+	std::string text = makeText(10000);
+	std::vector<char> compressed(LZ4StreamBuf::compressBound(text.size()));
+	std::size_t compressedSize = LZ4StreamBuf::compressBlock(text.data(), text.size(), &compressed[0]);
+	std::string result(text.size(), 0);
+
+	try
+	{
+		LZ4StreamBuf::decompressBlock(&compressed[0], compressedSize, &result[0], result.size() - 1);
+		fail("output too small - must throw");
+	}
+	catch (DataFormatException&)
+	{
+	}
+
+	try
+	{
+		LZ4StreamBuf::decompressBlock(&compressed[0], compressedSize/2, &result[0], result.size());
+		fail("truncated block - must throw");
+	}
+	catch (DataFormatException&)
+	{
+	}
+
+	// match offset pointing before the start of the block
+	const char invalid[] = { 0x10, 'a', 0x05, 0x00, 0x50, 'b', 'c', 'd', 'e', 'f' };
+	try
+	{
+		LZ4StreamBuf::decompressBlock(invalid, sizeof(invalid), &result[0], result.size());
+		fail("invalid offset - must throw");
+	}
+	catch (DataFormatException&)
+	{
+	}
+}
+
+
+void LZ4StreamTest::testStream()
+{
+	// identical to the output of "echo -n hello | lz4 -c"
+	const unsigned char expected[] =
+	{
+		0x04, 0x22, 0x4d, 0x18, 0x64, 0x40, 0xa7, 0x05, 0x00, 0x00, 0x80, 'h', 'e', 'l', 'l', 'o',
+		0x00, 0x00, 0x00, 0x00, 0xf9, 0x77, 0x00, 0xfb
+	};
+	std::string hello = compress("hello");
+	assertTrue (hello == std::string(reinterpret_cast<const char*>(expected), sizeof(expected)));
+	assertTrue (decompress(hello) == "hello");
+
+	std::stringstream buffer;
+	LZ4OutputStream compressor(buffer);
+	compressor << "abcdefabcdefabcdefabcdefabcdefabcdef" << std::endl;
+	compressor << "abcdefabcdefabcdefabcdefabcdefabcdef" << std::endl;
+	compressor.close();
+	LZ4InputStream decompressor(buffer);
+	std::string data;
+	decompressor >> data;
+	assertTrue (data == "abcdefabcdefabcdefabcdefabcdefabcdef");
+	decompressor >> data;
+	assertTrue (data == "abcdefabcdefabcdefabcdefabcdefabcdef");
+}
+
+
+void LZ4StreamTest::testStreamSizes()
+{
+	std::string text = makeText(1000000);
+	std::string compressed = compress(text);
+	assertTrue (compressed.size() < text.size()/2);
+	assertTrue (decompress(compressed) == text);
+
+	assertTrue (decompress(compress(text, LZ4StreamBuf::BLOCK_4M)) == text);
+	assertTrue (decompress(compress(std::string())).empty());
+
+	std::string sizes[] = { text.substr(0, 65535), text.substr(0, 65536), text.substr(0, 65537), text.substr(0, 131072) };
+	for (int i = 0; i < 4; i++)
+	{
+		assertTrue (decompress(compress(sizes[i])) == sizes[i]);
+	}
+}
+
+
+void LZ4StreamTest::testIncompressible()
+{
+	std::string random = makeRandom(200000);
+	std::string compressed = compress(random);
+	assertTrue (compressed.size() < random.size() + 64);
+	assertTrue (decompress(compressed) == random);
+}
+
+
+void LZ4StreamTest::testLinkedBlocks()
+{
+	// Two linked blocks; the second block consists of a match
+	// referring into the first block, followed by literals.
+	const unsigned char frame[] =
+	{
+		0x04, 0x22, 0x4d, 0x18, 0x40, 0x40, 0xc0,
+		0x1a, 0x00, 0x00, 0x80,
+		'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k', 'l', 'm',
+		'n', 'o', 'p', 'q', 'r', 's', 't', 'u', 'v', 'w', 'x', 'y', 'z',
+		0x0a, 0x00, 0x00, 0x00,
+		0x0f, 0x1a, 0x00, 0x51, 0x50, 'A', 'B', 'C', 'D', 'E',
+		0x00, 0x00, 0x00, 0x00
+	};
+	std::string alphabet("abcdefghijklmnopqrstuvwxyz");
+	std::string expected(alphabet);
+	while (expected.size() < 126) expected += alphabet;
+	expected.resize(126);
+	expected += "ABCDE";
+	assertTrue (decompress(std::string(reinterpret_cast<const char*>(frame), sizeof(frame))) == expected);
+}
+
+
+void LZ4StreamTest::testConcatenatedFrames()
+{
+	const unsigned char skippable[] = { 0x52, 0x2a, 0x4d, 0x18, 0x03, 0x00, 0x00, 0x00, 'x', 'y', 'z' };
+	std::string data = compress("Hello, ");
+	data.append(reinterpret_cast<const char*>(skippable), sizeof(skippable));
+	data += compress("world!");
+	assertTrue (decompress(data) == "Hello, world!");
+}
+
+
+void LZ4StreamTest::testCorruptStream()
+{
+	std::string compressed = compress(makeText(100000));
+
+	try
+	{
+		decompress(compressed.substr(0, compressed.size() - 10));
+		fail("truncated stream - must throw");
+	}
+	catch (DataFormatException&)
+	{
+	}
+
+	std::string damaged(compressed);
+	damaged[damaged.size()/2] ^= 0x01;
+	try
+	{
+		decompress(damaged);
+		fail("damaged stream - must throw");
+	}
+	catch (DataFormatException&)
+	{
+	}
+
+	try
+	{
+		decompress("not an LZ4 frame");
+		fail("not a frame - must throw");
+	}
+	catch (DataFormatException&)
+	{
+	}
+}
+
+
+void LZ4StreamTest::testPerformance()
+{
+	std::string text = makeText(64*1024*1024);
+	Poco::Stopwatch sw;
+
+	sw.start();
+	std::string lz4 = compress(text);
+	sw.stop();
+	std::cout << "LZ4OutputStream:       " << sw.elapsed()/1000 << " ms, " << lz4.size() << " bytes" << std::endl;
+
+	sw.restart();
+	std::string result = decompress(lz4);
+	sw.stop();
+	std::cout << "LZ4InputStream:        " << sw.elapsed()/1000 << " ms" << std::endl;
+	assertTrue (result == text);
+
+	std::ostringstream ostr;
+	sw.restart();
+	Poco::DeflatingOutputStream deflater(ostr, Poco::DeflatingStreamBuf::STREAM_GZIP, 6);
+	deflater.write(text.data(), static_cast<std::streamsize>(text.size()));
+	deflater.close();
+	sw.stop();
+	std::cout << "DeflatingOutputStream: " << sw.elapsed()/1000 << " ms, " << ostr.str().size() << " bytes" << std::endl;
+}
+
+
+void LZ4StreamTest::setUp()
+{
+}
+
+
+void LZ4StreamTest::tearDown()
+{
+}
+
+
+CppUnit::Test* LZ4StreamTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("LZ4StreamTest");
+
+	CppUnit_addTest(pSuite, LZ4StreamTest, testBlock);
+	CppUnit_addTest(pSuite, LZ4StreamTest, testBlockOverlap);
+	CppUnit_addTest(pSuite, LZ4StreamTest, testBlockCorrupt);
+	CppUnit_addTest(pSuite, LZ4StreamTest, testStream);
+	CppUnit_addTest(pSuite, LZ4StreamTest, testStreamSizes);
+	CppUnit_addTest(pSuite, LZ4StreamTest, testIncompressible);
+	CppUnit_addTest(pSuite, LZ4StreamTest, testLinkedBlocks);
+	CppUnit_addTest(pSuite, LZ4StreamTest, testConcatenatedFrames);
+	CppUnit_addTest(pSuite, LZ4StreamTest, testCorruptStream);
+	// CppUnit_addTest(pSuite, LZ4StreamTest, testPerformance);
+
+	return pSuite;
+}
@@ -0,0 +1,47 @@
+//
+// LZ4StreamTest.h
+//
+// Definition of the LZ4StreamTest class.
+//
+// Copyright (c) 2004-2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef LZ4StreamTest_INCLUDED
+#define LZ4StreamTest_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include "Poco/CppUnit/TestCase.h"
+
+
+class LZ4StreamTest: public CppUnit::TestCase
+{
+public:
+	LZ4StreamTest(const std::string& name);
+	~LZ4StreamTest();
+
+	void testBlock();
+	void testBlockOverlap();
+	void testBlockCorrupt();
+	void testStream();
+	void testStreamSizes();
+	void testIncompressible();
+	void testLinkedBlocks();
+	void testConcatenatedFrames();
+	void testCorruptStream();
+	void testPerformance();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+
+private:
+};
+
+
+#endif // LZ4StreamTest_INCLUDED
@@ -0,0 +1,285 @@
+//
+// MappedFileTest.cpp
+//
+// Copyright (c) 2007, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "MappedFileTest.h"
+#include "Poco/CppUnit/TestCaller.h"
+#include "Poco/CppUnit/TestSuite.h"
+#include "Poco/MappedFile.h"
+#include "Poco/FileStream.h"
+#include "Poco/TemporaryFile.h"
+#include "Poco/StreamCopier.h"
+#include "Poco/Stopwatch.h"
+#include "Poco/Exception.h"
+#include <iostream>
+#include <sstream>
+
+
+using Poco::MappedFile;
+using Poco::MappedInputStream;
+using Poco::UInt64;
+
+
+MappedFileTest::MappedFileTest(const std::string& name): CppUnit::TestCase(name)
+{
+}
+
+
+MappedFileTest::~MappedFileTest()
+{
+}
+
+
+void MappedFileTest::testWholeFile()
+{
+	std::string data = makeData(100000);
+	std::string path = writeFile(data);
+
+	MappedFile file(path);
+	assertTrue (file.size() == data.size());
+	assertTrue (file.fileSize() == data.size());
+	assertTrue (file.offset() == 0);
+	assertTrue (file.end() - file.begin() == static_cast<std::ptrdiff_t>(data.size()));
+	assertTrue (std::string(file.begin(), file.end()) == data);
+}
+
+
+void MappedFileTest::testWindow()
+{
+	std::string data = makeData(8*MappedFile::allocationGranularity() + 1000);
+	std::string path = writeFile(data);
+
+	// unaligned offset
+	MappedFile window(path, 12345, 5000);
+	assertTrue (window.offset() == 12345);
+	assertTrue (window.size() == 5000);
+	assertTrue (window.fileSize() == data.size());
+	assertTrue (std::string(window.begin(), window.end()) == data.substr(12345, 5000));
+
+	// aligned offset
+	std::size_t granularity = MappedFile::allocationGranularity();
+	MappedFile aligned(path, granularity, 100);
+	assertTrue (std::string(aligned.begin(), aligned.end()) == data.substr(granularity, 100));
+
+	// truncated at end of file
+	MappedFile tail(path, data.size() - 10, 1000);
+	assertTrue (tail.size() == 10);
+	assertTrue (std::string(tail.begin(), tail.end()) == data.substr(data.size() - 10));
+
+	// beyond end of file
+	MappedFile beyond(path, data.size() + 100, 1000);
+	assertTrue (beyond.size() == 0);
+	assertTrue (beyond.offset() == data.size());
+}
+
+
+void MappedFileTest::testEmpty()
+{
+	std::string path = writeFile(std::string());
+
+	MappedFile file(path);
+	assertTrue (file.size() == 0);
+	assertTrue (file.fileSize() == 0);
+	assertTrue (file.begin() == file.end());
+	assertTrue (!file.advise(MappedFile::ADVICE_SEQUENTIAL));
+
+	MappedFile unmapped;
+	assertTrue (unmapped.size() == 0);
+	assertTrue (unmapped.begin() == 0);
+	assertTrue (unmapped.end() == 0);
+
+	MappedInputStream istr(path);
+	std::string result;
+	Poco::StreamCopier::copyToString(istr, result);
+	assertTrue (result.empty());
+}
+
+
+void MappedFileTest::testNotFound()
+{
+	try
+	{
+		MappedFile file("no_such_file.dat");
+		fail("file does not exist - must throw");
+	}
+	catch (Poco::FileNotFoundException&)
+	{
+	}
+
+	try
+	{
+		MappedInputStream istr("no_such_file.dat");
+		fail("file does not exist - must throw");
+	}
+	catch (Poco::FileNotFoundException&)
+	{
+	}
+}
+
+
+void MappedFileTest::testCopy()
+{
+	std::string data = makeData(1000);
+	std::string path = writeFile(data);
+
+	MappedFile copy;
+	{
+		MappedFile file(path);
+		copy = file;
+		assertTrue (copy.begin() == file.begin());
+	}
+	assertTrue (std::string(copy.begin(), copy.end()) == data);
+
+	MappedFile other;
+	other.swap(copy);
+	assertTrue (copy.begin() == 0);
+	assertTrue (std::string(other.begin(), other.end()) == data);
+}
+
+
+void MappedFileTest::testAdvise()
+{
+	std::string data = makeData(10*MappedFile::pageSize());
+	std::string path = writeFile(data);
+
+	MappedFile file(path, MappedFile::ADVICE_SEQUENTIAL);
+#if defined(POCO_OS_FAMILY_UNIX)
+	assertTrue (file.advise(MappedFile::ADVICE_RANDOM));
+	assertTrue (file.advise(MappedFile::ADVICE_WILLNEED, 100, 3*MappedFile::pageSize()));
+	assertTrue (file.advise(MappedFile::ADVICE_NORMAL));
+#endif
+	assertTrue (!file.advise(MappedFile::ADVICE_WILLNEED, data.size(), 100));
+	// huge pages may or may not be supported for file mappings
+	file.advise(MappedFile::ADVICE_HUGEPAGE);
+	assertTrue (std::string(file.begin(), file.end()) == data);
+
+	MappedFile window(path, 1000, 5000, MappedFile::ADVICE_WILLNEED);
+	assertTrue (std::string(window.begin(), window.end()) == data.substr(1000, 5000));
+}
+
+
+void MappedFileTest::testStream()
+{
+	std::string data = makeData(50000);
+	std::string path = writeFile(data);
+
+	MappedInputStream istr(path);
+	assertTrue (istr.good());
+	std::string result;
+	Poco::StreamCopier::copyToString(istr, result);
+	assertTrue (result == data);
+
+	istr.clear();
+	istr.seekg(1000);
+	assertTrue (istr.tellg() == std::streampos(1000));
+	char buffer[100];
+	istr.read(buffer, sizeof(buffer));
+	assertTrue (istr.gcount() == 100);
+	assertTrue (std::string(buffer, 100) == data.substr(1000, 100));
+
+	istr.seekg(-10, std::ios::end);
+	istr.read(buffer, sizeof(buffer));
+	assertTrue (istr.gcount() == 10);
+	assertTrue (istr.eof());
+
+	MappedFile window(path, 40000, 100);
+	MappedInputStream wistr(window);
+	assertTrue (wistr.file().begin() == window.begin());
+	result.clear();
+	Poco::StreamCopier::copyToString(wistr, result);
+	assertTrue (result == data.substr(40000, 100));
+}
+
+
+void MappedFileTest::testPerformance()
+{
+	std::string data = makeData(256*1024*1024);
+	std::string path = writeFile(data);
+	data.clear();
+	Poco::Stopwatch sw;
+	char buffer[8192];
+
+	sw.start();
+	Poco::FileInputStream fistr(path, std::ios::binary);
+	std::streamsize total = 0;
+	while (fistr.read(buffer, sizeof(buffer)) || fistr.gcount() > 0)
+		total += fistr.gcount();
+	sw.stop();
+	std::cout << "FileInputStream:   " << sw.elapsed()/1000 << " ms, " << total << " bytes" << std::endl;
+
+	sw.restart();
+	MappedInputStream mistr(path);
+	total = 0;
+	while (mistr.read(buffer, sizeof(buffer)) || mistr.gcount() > 0)
+		total += mistr.gcount();
+	sw.stop();
+	std::cout << "MappedInputStream: " << sw.elapsed()/1000 << " ms, " << total << " bytes" << std::endl;
+
+	sw.restart();
+	MappedFile file(path, MappedFile::ADVICE_SEQUENTIAL);
+	UInt64 sum = 0;
+	for (const char* p = file.begin(); p != file.end(); p += 4096)
+		sum += static_cast<unsigned char>(*p);
+	sw.stop();
+	std::cout << "MappedFile:        " << sw.elapsed()/1000 << " ms, " << sum << std::endl;
+}
+
+
+std::string MappedFileTest::makeData(std::size_t size)
+{
+	std::string data;
+	data.reserve(size);
+	Poco::UInt32 x = 2463534242U;
+	for (std::size_t i = 0; i < size; ++i)
+	{
+		x ^= x << 13;
+		x ^= x >> 17;
+		x ^= x << 5;
+		data += static_cast<char>(x);
+	}
+	return data;
+}
+
+
+std::string MappedFileTest::writeFile(const std::string& data)
+{
+	std::string path = Poco::TemporaryFile::tempName();
+	Poco::TemporaryFile::registerForDeletion(path);
+	Poco::FileOutputStream ostr(path, std::ios::binary);
+	ostr.write(data.data(), static_cast<std::streamsize>(data.size()));
+	ostr.close();
+	return path;
+}
+
+
+void MappedFileTest::setUp()
+{
+}
+
+
+void MappedFileTest::tearDown()
+{
+}
+
+
+CppUnit::Test* MappedFileTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("MappedFileTest");
+
+	CppUnit_addTest(pSuite, MappedFileTest, testWholeFile);
+	CppUnit_addTest(pSuite, MappedFileTest, testWindow);
+	CppUnit_addTest(pSuite, MappedFileTest, testEmpty);
+	CppUnit_addTest(pSuite, MappedFileTest, testNotFound);
+	CppUnit_addTest(pSuite, MappedFileTest, testCopy);
+	CppUnit_addTest(pSuite, MappedFileTest, testAdvise);
+	CppUnit_addTest(pSuite, MappedFileTest, testStream);
+	// CppUnit_addTest(pSuite, MappedFileTest, testPerformance);
+
+	return pSuite;
+}
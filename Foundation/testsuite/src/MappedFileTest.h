@@ -0,0 +1,47 @@
+//
+// MappedFileTest.h
+//
+// Definition of the MappedFileTest class.
+//
+// Copyright (c) 2007, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef MappedFileTest_INCLUDED
+#define MappedFileTest_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include "Poco/CppUnit/TestCase.h"
+
+
+class MappedFileTest: public CppUnit::TestCase
+{
+public:
+	MappedFileTest(const std::string& name);
+	~MappedFileTest();
+
+	void testWholeFile();
+	void testWindow();
+	void testEmpty();
+	void testNotFound();
+	void testCopy();
+	void testAdvise();
+	void testStream();
+	void testPerformance();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+
+private:
+	static std::string makeData(std::size_t size);
+	static std::string writeFile(const std::string& data);
+};
+
+
+#endif // MappedFileTest_INCLUDED
@@ -12,6 +12,9 @@
 #include "Poco/CppUnit/TestCaller.h"
 #include "Poco/CppUnit/TestSuite.h"
 #include "Poco/MemoryPool.h"
+#include "Poco/ThreadCachedMemoryPool.h"
+#include "Poco/Thread.h"
+#include "Poco/Runnable.h"
 #include "Poco/Stopwatch.h"
 #include <vector>
 #include <cstring>
@@ -19,6 +22,8 @@
 
 
 using Poco::MemoryPool;
+using Poco::ThreadCachedMemoryPool;
+using Poco::ThreadCachedFastMemoryPool;
 
 
 MemoryPoolTest::MemoryPoolTest(const std::string& rName): CppUnit::TestCase(rName)
@@ -161,6 +166,60 @@ struct CustomGrandChild: public CustomChild1, CustomChild2
 	int l = 0;
 };
 
+
+template <class Pool>
+class PoolUser: public Poco::Runnable
+{
+public:
+	PoolUser(Pool& pool, int reps, std::vector<void*>* pForeign = 0):
+		_pool(pool),
+		_reps(reps),
+		_pForeign(pForeign),
+		_ok(true)
+	{
+	}
+
+	void run()
+	{
+		std::vector<void*> blocks;
+		for (int r = 0; r < _reps; ++r)
+		{
+			for (int i = 0; i < 100; ++i)
+			{
+				void* p = _pool.get();
+				std::memset(p, i, _pool.blockSize());
+				blocks.push_back(p);
+			}
+			for (int i = 0; i < 100; ++i)
+			{
+				const unsigned char* p = reinterpret_cast<const unsigned char*>(blocks[i]);
+				_ok = _ok && p[0] == i && p[_pool.blockSize() - 1] == i;
+				_pool.release(blocks[i]);
+			}
+			blocks.clear();
+		}
+		if (_pForeign)
+		{
+			for (std::vector<void*>::iterator it = _pForeign->begin(); it != _pForeign->end(); ++it)
+			{
+				_pool.release(*it);
+			}
+			_pForeign->clear();
+		}
+	}
+
+	bool ok() const
+	{
+		return _ok;
+	}
+
+private:
+	Pool& _pool;
+	int _reps;
+	std::vector<void*>* _pForeign;
+	bool _ok;
+};
+
 }
 
 
@@ -216,6 +275,160 @@ void MemoryPoolTest::testFastMemoryPool()
 
 	CustomGrandChild gc;
 	assertTrue (fastMemPoolTestCustom(sz, gc));
+
+	// a pool limited to a single bucket of four blocks
+	Poco::FastMemoryPool<int> limitedPool(4, 1, 1);
+	void* ptrs[6];
+	assertTrue (limitedPool.getBlocks(ptrs, 6) == 4);
+	assertTrue (limitedPool.available() == 0);
+	try
+	{
+		limitedPool.getBlocks(ptrs + 4, 2);
+		fail("pool exhausted - must throw exception");
+	}
+	catch (std::bad_alloc&)
+	{
+	}
+	limitedPool.releaseBlocks(ptrs, 4);
+	assertTrue (limitedPool.available() == 4);
+	assertTrue (limitedPool.getBlocks(ptrs, 3) == 3);
+	assertTrue (limitedPool.available() == 1);
+	limitedPool.releaseBlocks(ptrs, 3);
+}
+
+
+void MemoryPoolTest::testThreadCachedMemoryPool()
+{
+	ThreadCachedMemoryPool pool(100, 0, 20, 8);
+
+	assertTrue (pool.blockSize() == 100);
+	assertTrue (pool.magazineSize() == 8);
+	assertTrue (pool.allocated() == 0);
+
+	std::vector<void*> ptrs;
+	for (int i = 0; i < 20; ++i)
+	{
+		ptrs.push_back(pool.get());
+		std::memset(ptrs.back(), i, 100);
+	}
+	assertTrue (pool.allocated() == 20);
+
+	try
+	{
+		pool.get();
+		fail("pool exhausted - must throw exception");
+	}
+	catch (Poco::OutOfMemoryException&)
+	{
+	}
+
+	for (int i = 0; i < 20; ++i)
+	{
+		assertTrue (reinterpret_cast<unsigned char*>(ptrs[i])[99] == i);
+		pool.release(ptrs[i]);
+	}
+	ptrs.clear();
+
+	ThreadCachedMemoryPool::Statistics stats = pool.statistics();
+	assertTrue (stats.misses == 6);
+	assertTrue (stats.refills == 5);
+	assertTrue (stats.hits == 15);
+	assertTrue (stats.flushes == 3);
+	assertTrue (stats.crossThreadFrees == 0);
+
+	// blocks are now served from the thread cache and backing pool
+	for (int i = 0; i < 20; ++i)
+	{
+		ptrs.push_back(pool.get());
+	}
+	assertTrue (pool.allocated() == 20);
+	for (int i = 0; i < 20; ++i)
+	{
+		pool.release(ptrs[i]);
+	}
+
+	pool.flush();
+	stats = pool.statistics();
+	assertTrue (stats.misses + stats.hits == 41);
+
+	pool.release(0);
+}
+
+
+void MemoryPoolTest::testThreadCachedMemoryPoolThreads()
+{
+	ThreadCachedMemoryPool pool(64, 0, 0, 16);
+
+	std::vector<void*> foreign;
+	for (int i = 0; i < 50; ++i)
+	{
+		foreign.push_back(pool.get());
+	}
+
+	PoolUser<ThreadCachedMemoryPool> user1(pool, 100, &foreign);
+	PoolUser<ThreadCachedMemoryPool> user2(pool, 100);
+	Poco::Thread t1;
+	Poco::Thread t2;
+	t1.start(user1);
+	t2.start(user2);
+	t1.join();
+	t2.join();
+
+	assertTrue (user1.ok());
+	assertTrue (user2.ok());
+	assertTrue (foreign.empty());
+
+	ThreadCachedMemoryPool::Statistics stats = pool.statistics();
+	assertTrue (stats.crossThreadFrees == 50);
+	assertTrue (stats.hits + stats.misses == 50 + 2*100*100);
+
+	// the terminated threads' caches have been returned to the backing pool
+	std::vector<void*> ptrs;
+	int allocated = pool.allocated();
+	for (int i = 0; i < 100; ++i)
+	{
+		ptrs.push_back(pool.get());
+	}
+	assertTrue (pool.allocated() == allocated);
+	for (int i = 0; i < 100; ++i)
+	{
+		pool.release(ptrs[i]);
+	}
+}
+
+
+void MemoryPoolTest::testThreadCachedFastMemoryPool()
+{
+	int blocks = 10;
+	ThreadCachedFastMemoryPool<std::string> pool(blocks);
+
+	std::vector<std::string*> strVec(blocks);
+	for (int i = 0; i < blocks; ++i)
+	{
+		strVec[i] = new (pool.get()) std::string(std::to_string(i));
+	}
+
+	for (int i = 0; i < blocks; ++i)
+	{
+		assertTrue (strVec[i] && *strVec[i] == std::to_string(i));
+	}
+
+	for (int i = 0; i < blocks; ++i)
+	{
+		pool.release(strVec[i]);
+	}
+
+	ThreadCachedFastMemoryPool<Custom>* pCustomPool = new ThreadCachedFastMemoryPool<Custom>(blocks);
+	Custom* pCustom = new (pCustomPool->get()) Custom;
+	assertTrue (pCustom->i == 42 && pCustom->s == "abc");
+	pCustomPool->release(pCustom);
+	delete pCustomPool;
+
+	// a new pool must not pick up the cache of the destroyed one
+	ThreadCachedFastMemoryPool<Custom> customPool(blocks);
+	pCustom = new (customPool.get()) Custom;
+	customPool.release(pCustom);
+	assertTrue (customPool.statistics().misses == 1);
 }
 
 
@@ -272,6 +485,59 @@ void MemoryPoolTest::memoryPoolBenchmark()
 }
 
 
+void MemoryPoolTest::threadCachedMemoryPoolBenchmark()
+{
+	const int threads = 8;
+	const int reps = 10000;
+	Poco::Stopwatch sw;
+
+	{
+		MemoryPool pool(4096);
+		std::vector<PoolUser<MemoryPool>*> users;
+		std::vector<Poco::Thread*> workers;
+		for (int i = 0; i < threads; ++i)
+		{
+			users.push_back(new PoolUser<MemoryPool>(pool, reps));
+			workers.push_back(new Poco::Thread);
+		}
+		sw.restart();
+		for (int i = 0; i < threads; ++i) workers[i]->start(*users[i]);
+		for (int i = 0; i < threads; ++i) workers[i]->join();
+		sw.stop();
+		std::cout << '\n' << threads << " threads, " << reps*100 << "x get()/release()\n";
+		std::cout << "MemoryPool=" << sw.elapsed() / 1000 << std::endl;
+		for (int i = 0; i < threads; ++i)
+		{
+			delete workers[i];
+			delete users[i];
+		}
+	}
+
+	{
+		ThreadCachedMemoryPool pool(4096);
+		std::vector<PoolUser<ThreadCachedMemoryPool>*> users;
+		std::vector<Poco::Thread*> workers;
+		for (int i = 0; i < threads; ++i)
+		{
+			users.push_back(new PoolUser<ThreadCachedMemoryPool>(pool, reps));
+			workers.push_back(new Poco::Thread);
+		}
+		sw.restart();
+		for (int i = 0; i < threads; ++i) workers[i]->start(*users[i]);
+		for (int i = 0; i < threads; ++i) workers[i]->join();
+		sw.stop();
+		std::cout << "ThreadCachedMemoryPool=" << sw.elapsed() / 1000 << std::endl;
+		for (int i = 0; i < threads; ++i)
+		{
+			delete workers[i];
+			delete users[i];
+		}
+		ThreadCachedMemoryPool::Statistics stats = pool.statistics();
+		std::cout << "hits=" << stats.hits << " misses=" << stats.misses << std::endl;
+	}
+}
+
+
 void MemoryPoolTest::setUp()
 {
 }
@@ -288,7 +554,11 @@ CppUnit::Test* MemoryPoolTest::suite()
 
 	CppUnit_addTest(pSuite, MemoryPoolTest, testMemoryPool);
 	CppUnit_addTest(pSuite, MemoryPoolTest, testFastMemoryPool);
+	CppUnit_addTest(pSuite, MemoryPoolTest, testThreadCachedMemoryPool);
+	CppUnit_addTest(pSuite, MemoryPoolTest, testThreadCachedMemoryPoolThreads);
+	CppUnit_addTest(pSuite, MemoryPoolTest, testThreadCachedFastMemoryPool);
 	//CppUnit_addTest(pSuite, MemoryPoolTest, memoryPoolBenchmark);
+	//CppUnit_addTest(pSuite, MemoryPoolTest, threadCachedMemoryPoolBenchmark);
 
 	return pSuite;
 }
@@ -26,7 +26,11 @@ public:
 
 	void testMemoryPool();
 	void testFastMemoryPool();
+	void testThreadCachedMemoryPool();
+	void testThreadCachedMemoryPoolThreads();
+	void testThreadCachedFastMemoryPool();
 	void memoryPoolBenchmark();
+	void threadCachedMemoryPoolBenchmark();
 
 	void setUp();
 	void tearDown();
@@ -13,10 +13,13 @@
 #include "Poco/CppUnit/TestSuite.h"
 #include "Poco/RegularExpression.h"
 #include "Poco/Exception.h"
+#include "Poco/Stopwatch.h"
+#include <iostream>
 
 
 using Poco::RegularExpression;
 using Poco::RegularExpressionException;
+using Poco::Stopwatch;
 
 
 RegularExpressionTest::RegularExpressionTest(const std::string& rName): CppUnit::TestCase(rName)
@@ -274,6 +277,110 @@ void RegularExpressionTest::testGroup()
 }
 
 
+void RegularExpressionTest::testJIT()
+{
+	RegularExpression re("([a-z]+)-([0-9]+)", RegularExpression::RE_JIT);
+	assertTrue (re.isJIT() == RegularExpression::isJITSupported());
+
+	RegularExpression::MatchVec matches;
+	assertTrue (re.match("123 abc-456 def", 0, matches) == 3);
+	assertTrue (matches[0].offset == 4);
+	assertTrue (matches[0].length == 7);
+	assertTrue (matches[1].offset == 4);
+	assertTrue (matches[1].length == 3);
+	assertTrue (matches[2].offset == 8);
+	assertTrue (matches[2].length == 3);
+
+	assertTrue (re.match("abc-456"));
+	assertTrue (!re.match("abc-"));
+
+	std::string s("xyz-1 abc-22");
+	assertTrue (re.subst(s, "$2:$1", RegularExpression::RE_GLOBAL) == 2);
+	assertTrue (s == "1:xyz 22:abc");
+}
+
+
+void RegularExpressionTest::testMatchContext()
+{
+	RegularExpression re1("(?P<name>[a-z]+)-([0-9]+)", RegularExpression::RE_JIT);
+	RegularExpression re2("^/api/v([0-9])/users/([0-9]+)$");
+	RegularExpression::MatchContext context;
+	RegularExpression::MatchVec matches;
+
+	for (int i = 0; i < 3; ++i)
+	{
+		assertTrue (re1.match("123 abc-456 def", 0, matches, context) == 3);
+		assertTrue (matches.size() == 3);
+		assertTrue (matches[0].offset == 4);
+		assertTrue (matches[0].length == 7);
+		assertTrue (matches[1].name == "name");
+		assertTrue (matches[2].offset == 8);
+		assertTrue (matches[2].name.empty());
+
+		assertTrue (re2.match("/api/v2/users/1234", 0, matches, context) == 3);
+		assertTrue (matches.size() == 3);
+		assertTrue (matches[1].offset == 6);
+		assertTrue (matches[1].length == 1);
+		assertTrue (matches[1].name.empty());
+		assertTrue (matches[2].offset == 14);
+		assertTrue (matches[2].length == 4);
+
+		assertTrue (re2.match("/api/v2/groups/1234", 0, matches, context) == 0);
+		assertTrue (matches.empty());
+	}
+
+	RegularExpression::Match mtch;
+	assertTrue (re1.match("abc-1 def-2", 5, mtch, context) == 3);
+	assertTrue (mtch.offset == 6);
+	assertTrue (mtch.length == 5);
+	assertTrue (re1.match("ABC", 0, mtch, context) == 0);
+	assertTrue (mtch.offset == std::string::npos);
+	assertTrue (mtch.length == 0);
+}
+
+
+void RegularExpressionTest::testPerformance()
+{
+	const int N = 200000;
+	const char* patterns[] =
+	{
+		"^/api/v[0-9]+/users/([0-9]+)/orders/([0-9a-f-]+)$",
+		"^(\\S+) (\\S+) (\\S+) \\[([^]]+)\\] \"(\\w+) ([^ ]*) HTTP/[0-9.]+\" ([0-9]{3}) ([0-9]+|-)"
+	};
+	const char* subjects[] =
+	{
+		"/api/v2/users/123456/orders/3f2a9c10-7b4e-4d2a-9a8c-1e2f3a4b5c6d",
+		"127.0.0.1 - frank [10/Oct/2000:13:55:36 -0700] \"GET /apache_pb.gif HTTP/1.0\" 200 2326"
+	};
+
+	std::cout << std::endl << "JIT supported: " << RegularExpression::isJITSupported() << std::endl;
+	for (int p = 0; p < 2; ++p)
+	{
+		std::string subject(subjects[p]);
+		RegularExpression::MatchVec matches;
+		RegularExpression::MatchContext context;
+
+		RegularExpression re(patterns[p]);
+		Stopwatch sw;
+		sw.start();
+		for (int i = 0; i < N; ++i) re.match(subject, 0, matches);
+		sw.stop();
+		std::cout << "Pattern " << p << " interpreter: " << sw.elapsed()/1000 << " ms" << std::endl;
+
+		RegularExpression jitRe(patterns[p], RegularExpression::RE_JIT);
+		sw.restart();
+		for (int i = 0; i < N; ++i) jitRe.match(subject, 0, matches);
+		sw.stop();
+		std::cout << "Pattern " << p << " JIT: " << sw.elapsed()/1000 << " ms" << std::endl;
+
+		sw.restart();
+		for (int i = 0; i < N; ++i) jitRe.match(subject, 0, matches, context);
+		sw.stop();
+		std::cout << "Pattern " << p << " JIT with MatchContext: " << sw.elapsed()/1000 << " ms" << std::endl;
+	}
+}
+
+
 void RegularExpressionTest::setUp()
 {
 }
@@ -304,6 +411,9 @@ CppUnit::Test* RegularExpressionTest::suite()
 	CppUnit_addTest(pSuite, RegularExpressionTest, testSubst4);
 	CppUnit_addTest(pSuite, RegularExpressionTest, testError);
 	CppUnit_addTest(pSuite, RegularExpressionTest, testGroup);
+	CppUnit_addTest(pSuite, RegularExpressionTest, testJIT);
+	CppUnit_addTest(pSuite, RegularExpressionTest, testMatchContext);
+	//CppUnit_addTest(pSuite, RegularExpressionTest, testPerformance);
 
 	return pSuite;
 }
@@ -40,6 +40,9 @@ public:
 	void testSubst4();
 	void testError();
 	void testGroup();
+	void testJIT();
+	void testMatchContext();
+	void testPerformance();
 
 	void setUp();
 	void tearDown();
@@ -12,6 +12,8 @@
 #include "Poco/CppUnit/TestCaller.h"
 #include "Poco/CppUnit/TestSuite.h"
 #include "Poco/SHA1Engine.h"
+#include "Poco/Stopwatch.h"
+#include <iostream>
 
 
 using Poco::SHA1Engine;
@@ -46,6 +48,43 @@ void SHA1EngineTest::testSHA1()
 }
 
 
+void SHA1EngineTest::testSHA1Bulk()
+{
+	SHA1Engine engine;
+
+	std::string million(1000000, 'a');
+	engine.update(million);
+	assertTrue (DigestEngine::digestToHex(engine.digest()) == "34aa973cd4c4daa4f61eeb2bdbad27316534016f");
+
+	std::string data;
+	for (int i = 0; i < 1000; ++i) data += char(i*7 + (i >> 4));
+	engine.update(data);
+	std::string expected = DigestEngine::digestToHex(engine.digest());
+	for (std::size_t chunk = 1; chunk < 200; chunk += 13)
+	{
+		for (std::size_t pos = 0; pos < data.size(); pos += chunk)
+		{
+			engine.update(data.data() + pos, std::min(chunk, data.size() - pos));
+		}
+		assertTrue (DigestEngine::digestToHex(engine.digest()) == expected);
+	}
+}
+
+
+void SHA1EngineTest::testPerformance()
+{
+	SHA1Engine engine;
+	std::string data(64*1024*1024, 'x');
+
+	Poco::Stopwatch sw;
+	sw.start();
+	engine.update(data);
+	engine.digest();
+	sw.stop();
+	std::cout << "SHA-1: " << 64*1000000.0/sw.elapsed() << " MB/s" << std::endl;
+}
+
+
 void SHA1EngineTest::setUp()
 {
 }
@@ -61,6 +100,8 @@ CppUnit::Test* SHA1EngineTest::suite()
 	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("SHA1EngineTest");
 
 	CppUnit_addTest(pSuite, SHA1EngineTest, testSHA1);
+	CppUnit_addTest(pSuite, SHA1EngineTest, testSHA1Bulk);
+	// CppUnit_addTest(pSuite, SHA1EngineTest, testPerformance);
 
 	return pSuite;
 }
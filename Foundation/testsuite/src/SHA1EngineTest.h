@@ -25,6 +25,8 @@ public:
 	~SHA1EngineTest();
 
 	void testSHA1();
+	void testSHA1Bulk();
+	void testPerformance();
 
 	void setUp();
 	void tearDown();
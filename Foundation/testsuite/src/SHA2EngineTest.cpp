@@ -15,6 +15,9 @@
 #include "Poco/CppUnit/TestCaller.h"
 #include "Poco/CppUnit/TestSuite.h"
 #include "Poco/SHA2Engine.h"
+#include "Poco/Stopwatch.h"
+#include <iostream>
+#include <vector>
 
 using Poco::SHA2Engine;
 using Poco::DigestEngine;
@@ -99,6 +102,99 @@ void SHA2EngineTest::testSHA512()
 	assertTrue (DigestEngine::digestToHex(engine.digest()) == "e718483d0ce769644e2e42c7bc15b4638e1f98b13b2044285632a803afa973ebde0ff244877ea60a4cb0432ce577c31beb009c5c2c49aa2e4eadb217ad8cc09b");
 }
 
+void SHA2EngineTest::testSHA256Bulk()
+{
+	SHA2Engine engine(SHA2Engine::SHA_256);
+
+	std::string million(1000000, 'a');
+	engine.update(million);
+	assertTrue (DigestEngine::digestToHex(engine.digest()) == "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+
+	std::string data;
+	for (int i = 0; i < 1000; ++i) data += char(i*7 + (i >> 4));
+	engine.update(data);
+	std::string expected = DigestEngine::digestToHex(engine.digest());
+	for (std::size_t chunk = 1; chunk < 200; chunk += 13)
+	{
+		for (std::size_t pos = 0; pos < data.size(); pos += chunk)
+		{
+			engine.update(data.data() + pos, std::min(chunk, data.size() - pos));
+		}
+		assertTrue (DigestEngine::digestToHex(engine.digest()) == expected);
+	}
+}
+
+void SHA2EngineTest::testDigestMultiple()
+{
+	static const SHA2Engine::ALGORITHM algorithms[] = { SHA2Engine::SHA_224, SHA2Engine::SHA_256, SHA2Engine::SHA_512 };
+
+	std::vector<std::string> messages;
+	for (int n = 0; n < 150; ++n)
+	{
+		int length = (n*37) % 150;
+		std::string message;
+		for (int i = 0; i < length; ++i) message += char(i + n);
+		messages.push_back(message);
+	}
+	messages.push_back("abc");
+
+	std::vector<const void*> data;
+	std::vector<std::size_t> lengths;
+	for (std::size_t i = 0; i < messages.size(); ++i)
+	{
+		data.push_back(messages[i].data());
+		lengths.push_back(messages[i].size());
+	}
+
+	for (int a = 0; a < 3; ++a)
+	{
+		std::vector<DigestEngine::Digest> digests(messages.size());
+		SHA2Engine::digestMultiple(algorithms[a], messages.size(), &data[0], &lengths[0], &digests[0]);
+
+		SHA2Engine engine(algorithms[a]);
+		for (std::size_t i = 0; i < messages.size(); ++i)
+		{
+			engine.update(messages[i]);
+			assertTrue (digests[i] == engine.digest());
+		}
+	}
+
+	std::vector<DigestEngine::Digest> digests(1);
+	SHA2Engine::digestMultiple(SHA2Engine::SHA_256, 1, &data[messages.size() - 1], &lengths[messages.size() - 1], &digests[0]);
+	assertTrue (DigestEngine::digestToHex(digests[0]) == "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+}
+
+void SHA2EngineTest::testPerformance()
+{
+	std::string data(64*1024*1024, 'x');
+	Poco::Stopwatch sw;
+
+	SHA2Engine engine(SHA2Engine::SHA_256);
+	sw.start();
+	engine.update(data);
+	engine.digest();
+	sw.stop();
+	std::cout << "SHA-256: " << 64*1000000.0/sw.elapsed() << " MB/s" << std::endl;
+
+	const std::size_t count = 100000;
+	std::vector<const void*> messages(count, data.data());
+	std::vector<std::size_t> lengths(count, 200);
+	std::vector<DigestEngine::Digest> digests(count);
+	sw.restart();
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		engine.update(messages[i], lengths[i]);
+		digests[i] = engine.digest();
+	}
+	sw.stop();
+	std::cout << "SHA-256 (200 byte messages, sequential): " << count*1000000.0/sw.elapsed() << " messages/s" << std::endl;
+
+	sw.restart();
+	SHA2Engine::digestMultiple(SHA2Engine::SHA_256, count, &messages[0], &lengths[0], &digests[0]);
+	sw.stop();
+	std::cout << "SHA-256 (200 byte messages, digestMultiple): " << count*1000000.0/sw.elapsed() << " messages/s" << std::endl;
+}
+
 void SHA2EngineTest::setUp()
 {
 }
@@ -115,6 +211,9 @@ CppUnit::Test* SHA2EngineTest::suite()
 	CppUnit_addTest(pSuite, SHA2EngineTest, testSHA256);
 	CppUnit_addTest(pSuite, SHA2EngineTest, testSHA384);
 	CppUnit_addTest(pSuite, SHA2EngineTest, testSHA512);
+	CppUnit_addTest(pSuite, SHA2EngineTest, testSHA256Bulk);
+	CppUnit_addTest(pSuite, SHA2EngineTest, testDigestMultiple);
+	// CppUnit_addTest(pSuite, SHA2EngineTest, testPerformance);
 
 	return pSuite;
 }
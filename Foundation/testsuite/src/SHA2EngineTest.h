@@ -25,6 +25,9 @@ public:
 	void testSHA256();
 	void testSHA384();
 	void testSHA512();
+	void testSHA256Bulk();
+	void testDigestMultiple();
+	void testPerformance();
 
 	void setUp();
 	void tearDown();
@@ -12,10 +12,17 @@
 #include "Poco/CppUnit/TestCaller.h"
 #include "Poco/CppUnit/TestSuite.h"
 #include "Poco/StreamCopier.h"
+#include "Poco/Buffer.h"
+#include "Poco/FileStream.h"
+#include "Poco/TemporaryFile.h"
+#include "Poco/Stopwatch.h"
+#include <iostream>
 #include <sstream>
 
 
 using Poco::StreamCopier;
+using Poco::FileInputStream;
+using Poco::FileOutputStream;
 
 
 StreamCopierTest::StreamCopierTest(const std::string& rName): CppUnit::TestCase(rName)
@@ -160,6 +167,208 @@ void StreamCopierTest::testCopyToString64()
 #endif
 
 
+void StreamCopierTest::testFileCopy()
+{
+	std::string data = makeData(3*StreamCopier::MAX_BUFFER_SIZE + 123);
+	std::string src = writeFile(data);
+	std::string dst = Poco::TemporaryFile::tempName();
+	Poco::TemporaryFile::registerForDeletion(dst);
+
+	FileInputStream istr(src);
+	FileOutputStream ostr(dst);
+	// buffered data on both sides must be taken into account
+	char header[10];
+	istr.read(header, sizeof(header));
+	ostr << "header";
+	std::streamsize n = StreamCopier::copyStream(istr, ostr);
+	assertTrue (n == static_cast<std::streamsize>(data.size() - 10));
+	assertTrue (istr.eof());
+	ostr << "trailer";
+	ostr.close();
+	assertTrue (readFile(dst) == "header" + data.substr(10) + "trailer");
+
+	FileInputStream istr2(src);
+	FileOutputStream ostr2(dst);
+#if defined(POCO_HAVE_INT64)
+	Poco::UInt64 n64 = StreamCopier::copyStream64(istr2, ostr2);
+	assertTrue (n64 == data.size());
+#else
+	n = StreamCopier::copyStream(istr2, ostr2);
+	assertTrue (n == data.size());
+#endif
+	ostr2.close();
+	assertTrue (readFile(dst) == data);
+}
+
+
+void StreamCopierTest::testFileCopyAppend()
+{
+	std::string data = makeData(100000);
+	std::string src = writeFile(data);
+	std::string dst = writeFile("start");
+
+	FileInputStream istr(src);
+	FileOutputStream ostr(dst, std::ios::out | std::ios::app);
+	std::streamsize n = StreamCopier::copyStream(istr, ostr);
+	assertTrue (n == static_cast<std::streamsize>(data.size()));
+	ostr.close();
+	assertTrue (readFile(dst) == "start" + data);
+}
+
+
+void StreamCopierTest::testFileCopyToStream()
+{
+	std::string data = makeData(StreamCopier::MAX_BUFFER_SIZE + 4567);
+	std::string src = writeFile(data);
+
+	FileInputStream istr(src);
+	istr.seekg(1000);
+	std::ostringstream ostr;
+	std::streamsize n = StreamCopier::copyStream(istr, ostr, 100);
+	assertTrue (n == static_cast<std::streamsize>(data.size() - 1000));
+	assertTrue (ostr.str() == data.substr(1000));
+
+	std::istringstream sistr(data);
+	FileOutputStream fostr(src);
+	n = StreamCopier::copyStream(sistr, fostr);
+	assertTrue (n == static_cast<std::streamsize>(data.size()));
+	fostr.close();
+	assertTrue (readFile(src) == data);
+}
+
+
+void StreamCopierTest::testFileCopyToString()
+{
+	std::string data = makeData(200000);
+	std::string src = writeFile(data);
+
+	FileInputStream istr(src);
+	char header[5];
+	istr.read(header, sizeof(header));
+	std::string str("xy");
+	std::streamsize n = StreamCopier::copyToString(istr, str);
+	assertTrue (n == static_cast<std::streamsize>(data.size() - 5));
+	assertTrue (str == "xy" + data.substr(5));
+
+	std::string empty = writeFile(std::string());
+	FileInputStream istr2(empty);
+	str.clear();
+	n = StreamCopier::copyToString(istr2, str);
+	assertTrue (n == 0);
+	assertTrue (str.empty());
+}
+
+
+void StreamCopierTest::testFileCopyPseudoFile()
+{
+#if POCO_OS == POCO_OS_LINUX
+	// procfs files report a size of 0, but have content
+	FileInputStream istr;
+	try
+	{
+		istr.open("/proc/self/status", std::ios::in);
+	}
+	catch (Poco::Exception&)
+	{
+		return;
+	}
+	std::string dst = Poco::TemporaryFile::tempName();
+	Poco::TemporaryFile::registerForDeletion(dst);
+	FileOutputStream ostr(dst);
+	std::streamsize n = StreamCopier::copyStream(istr, ostr);
+	ostr.close();
+	assertTrue (n > 0);
+	std::string status = readFile(dst);
+	assertTrue (status.size() == static_cast<std::size_t>(n));
+	assertTrue (status.find("Name:") != std::string::npos);
+#endif
+}
+
+
+void StreamCopierTest::testFilePerformance()
+{
+	std::string data = makeData(256*1024*1024);
+	std::string src = writeFile(data);
+	data.clear();
+	std::string dst = Poco::TemporaryFile::tempName();
+	Poco::TemporaryFile::registerForDeletion(dst);
+	Poco::Stopwatch sw;
+
+	{
+		FileInputStream istr(src);
+		FileOutputStream ostr(dst);
+		sw.start();
+		StreamCopier::copyStream(istr, ostr);
+		ostr.close();
+		sw.stop();
+		std::cout << "file to file:              " << sw.elapsed()/1000 << " ms" << std::endl;
+	}
+	{
+		FileInputStream istr(src);
+		std::ostringstream ostr;
+		sw.restart();
+		StreamCopier::copyStream(istr, ostr);
+		sw.stop();
+		std::cout << "file to stringstream:      " << sw.elapsed()/1000 << " ms" << std::endl;
+	}
+	{
+		FileInputStream istr(src);
+		std::string str;
+		sw.restart();
+		StreamCopier::copyToString(istr, str);
+		sw.stop();
+		std::cout << "file to string:            " << sw.elapsed()/1000 << " ms" << std::endl;
+	}
+	{
+		FileInputStream istr(src);
+		FileOutputStream ostr(dst);
+		Poco::Buffer<char> buffer(8192);
+		sw.restart();
+		while (istr.read(buffer.begin(), 8192) || istr.gcount() > 0)
+			ostr.write(buffer.begin(), istr.gcount());
+		ostr.close();
+		sw.stop();
+		std::cout << "file to file (8K buffer):  " << sw.elapsed()/1000 << " ms" << std::endl;
+	}
+}
+
+
+std::string StreamCopierTest::makeData(std::size_t size)
+{
+	std::string data;
+	data.reserve(size);
+	Poco::UInt32 x = 2463534242U;
+	for (std::size_t i = 0; i < size; ++i)
+	{
+		x ^= x << 13;
+		x ^= x >> 17;
+		x ^= x << 5;
+		data += static_cast<char>(x);
+	}
+	return data;
+}
+
+
+std::string StreamCopierTest::writeFile(const std::string& data)
+{
+	std::string path = Poco::TemporaryFile::tempName();
+	Poco::TemporaryFile::registerForDeletion(path);
+	FileOutputStream ostr(path);
+	ostr.write(data.data(), static_cast<std::streamsize>(data.size()));
+	ostr.close();
+	return path;
+}
+
+
+std::string StreamCopierTest::readFile(const std::string& path)
+{
+	FileInputStream istr(path);
+	std::ostringstream ostr;
+	ostr << istr.rdbuf();
+	return ostr.str();
+}
+
+
 void StreamCopierTest::setUp()
 {
 }
@@ -183,6 +392,12 @@ CppUnit::Test* StreamCopierTest::suite()
 	CppUnit_addTest(pSuite, StreamCopierTest, testUnbufferedCopy64);
 	CppUnit_addTest(pSuite, StreamCopierTest, testCopyToString64);
 #endif
+	CppUnit_addTest(pSuite, StreamCopierTest, testFileCopy);
+	CppUnit_addTest(pSuite, StreamCopierTest, testFileCopyAppend);
+	CppUnit_addTest(pSuite, StreamCopierTest, testFileCopyToStream);
+	CppUnit_addTest(pSuite, StreamCopierTest, testFileCopyToString);
+	CppUnit_addTest(pSuite, StreamCopierTest, testFileCopyPseudoFile);
+	// CppUnit_addTest(pSuite, StreamCopierTest, testFilePerformance);
 
 	return pSuite;
 }
@@ -32,6 +32,12 @@ public:
 	void testUnbufferedCopy64();
 	void testCopyToString64();
 #endif
+	void testFileCopy();
+	void testFileCopyAppend();
+	void testFileCopyToStream();
+	void testFileCopyToString();
+	void testFileCopyPseudoFile();
+	void testFilePerformance();
 
 	void setUp();
 	void tearDown();
@@ -39,6 +45,9 @@ public:
 	static CppUnit::Test* suite();
 
 private:
+	static std::string makeData(std::size_t size);
+	static std::string writeFile(const std::string& data);
+	static std::string readFile(const std::string& path);
 };
 
 
@@ -16,6 +16,7 @@
 #include "CountingStreamTest.h"
 #include "NullStreamTest.h"
 #include "ZLibTest.h"
+#include "LZ4StreamTest.h"
 #include "StreamTokenizerTest.h"
 #include "BinaryReaderWriterTest.h"
 #include "LineEndingConverterTest.h"
@@ -36,6 +37,7 @@ CppUnit::Test* StreamsTestSuite::suite()
 	pSuite->addTest(CountingStreamTest::suite());
 	pSuite->addTest(NullStreamTest::suite());
 	pSuite->addTest(ZLibTest::suite());
+	pSuite->addTest(LZ4StreamTest::suite());
 	pSuite->addTest(StreamTokenizerTest::suite());
 	pSuite->addTest(BinaryReaderWriterTest::suite());
 	pSuite->addTest(LineEndingConverterTest::suite());
@@ -20,6 +20,9 @@
 #include "Poco/Windows1251Encoding.h"
 #include "Poco/Windows1252Encoding.h"
 #include "Poco/UTF8Encoding.h"
+#include "Poco/Random.h"
+#include "Poco/Stopwatch.h"
+#include <iostream>
 
 #ifdef POCO_COMPILER_MSVC
 #pragma warning(push)
@@ -330,6 +333,206 @@ void TextConverterTest::testErrors()
 }
 
 
+namespace
+{
+	bool isValidReference(const std::string& str)
+	{
+		UTF8Encoding utf8Encoding;
+		const unsigned char* it  = reinterpret_cast<const unsigned char*>(str.data());
+		const unsigned char* end = it + str.size();
+		while (it < end)
+		{
+			int n = utf8Encoding.sequenceLength(it, static_cast<int>(end - it));
+			if (*it < 0x80)
+			{
+				++it;
+				continue;
+			}
+			if (n < 2 || n > end - it || !UTF8Encoding::isLegal(it, n)) return false;
+			it += n;
+		}
+		return true;
+	}
+
+
+	int identity(int ch)
+	{
+		return ch;
+	}
+
+
+	std::string randomText(Poco::Random& rnd, std::size_t length, int nonASCIIPercent)
+	{
+		static const char* samples[] = {"\xc3\xa4", "\xc3\xbc", "\xe2\x82\xac", "\xf0\x9f\x98\x80", "\xd0\x96", "\xc2\xa0"};
+		std::string text;
+		while (text.size() < length)
+		{
+			if (static_cast<int>(rnd.next(100)) < nonASCIIPercent)
+				text += samples[rnd.next(6)];
+			else
+				text += static_cast<char>(' ' + rnd.next(95));
+		}
+		return text;
+	}
+}
+
+
+void TextConverterTest::testUTF8Validation()
+{
+	assertTrue (UTF8Encoding::isValid("", 0));
+	assertTrue (UTF8Encoding::isValid("hello", 5));
+	assertTrue (UTF8Encoding::isValid("\xc3\xa4\xe2\x82\xac\xf0\x9f\x98\x80", 9));
+	assertTrue (UTF8Encoding::isValid("\xed\x9f\xbf\xf4\x8f\xbf\xbf\xee\x80\x80", 10));
+	assertTrue (!UTF8Encoding::isValid("\x80", 1));
+	assertTrue (!UTF8Encoding::isValid("\xc3", 1));
+	assertTrue (!UTF8Encoding::isValid("\xc0\x80", 2));
+	assertTrue (!UTF8Encoding::isValid("\xc1\xbf", 2));
+	assertTrue (!UTF8Encoding::isValid("\xe0\x9f\xbf", 3));
+	assertTrue (!UTF8Encoding::isValid("\xed\xa0\x80", 3));
+	assertTrue (!UTF8Encoding::isValid("\xf0\x8f\xbf\xbf", 4));
+	assertTrue (!UTF8Encoding::isValid("\xf4\x90\x80\x80", 4));
+	assertTrue (!UTF8Encoding::isValid("\xf5\x80\x80\x80", 4));
+	assertTrue (!UTF8Encoding::isValid("\xff", 1));
+	assertTrue (!UTF8Encoding::isValid("\xe2\x82", 2));
+	assertTrue (!UTF8Encoding::isValid("\xe2\x82\xac\xac", 4));
+
+	// errors and truncated sequences at all positions relative to block boundaries
+	std::string text(100, 'a');
+	const char* bad[] = {"\x80", "\xc3", "\xe2\x82", "\xf0\x9f\x98", "\xc0\xaf", "\xed\xb0\x80"};
+	for (std::size_t pos = 0; pos < 40; ++pos)
+	{
+		for (std::size_t i = 0; i < sizeof(bad)/sizeof(bad[0]); ++i)
+		{
+			std::string s(text);
+			s.insert(pos, bad[i]);
+			assertTrue (!UTF8Encoding::isValid(s.data(), s.size()));
+			std::string t(text, 0, pos);
+			t += bad[i];
+			assertTrue (!UTF8Encoding::isValid(t.data(), t.size()));
+			t = std::string(text, 0, pos) + "\xf0\x9f\x98\x80";
+			assertTrue (UTF8Encoding::isValid(t.data(), t.size()));
+		}
+	}
+
+	// random bytes, compared to a validator based on isLegal()
+	Poco::Random rnd;
+	rnd.seed(42);
+	for (int i = 0; i < 20000; ++i)
+	{
+		std::string s = randomText(rnd, rnd.next(80), 30);
+		if (i % 2)
+		{
+			int flips = 1 + rnd.next(3);
+			for (int k = 0; k < flips && !s.empty(); ++k)
+				s[rnd.next(static_cast<Poco::UInt32>(s.size()))] = static_cast<char>(rnd.next(256));
+		}
+		assertTrue (UTF8Encoding::isValid(s.data(), s.size()) == isValidReference(s));
+	}
+}
+
+
+void TextConverterTest::testCountASCII()
+{
+	assertTrue (UTF8Encoding::countASCII("", 0) == 0);
+	assertTrue (UTF8Encoding::countASCII("abc", 3) == 3);
+	for (std::size_t pos = 0; pos < 40; ++pos)
+	{
+		std::string s(50, 'x');
+		s[pos] = '\xe4';
+		assertTrue (UTF8Encoding::countASCII(s.data(), s.size()) == pos);
+	}
+}
+
+
+void TextConverterTest::testFastConversion()
+{
+	UTF8Encoding utf8Encoding;
+	Latin1Encoding latin1Encoding;
+	Windows1252Encoding cp1252Encoding;
+	Poco::Random rnd;
+	rnd.seed(7);
+
+	for (int i = 0; i < 2000; ++i)
+	{
+		std::string utf8 = randomText(rnd, rnd.next(300), i % 50);
+		if (i % 3 == 0 && !utf8.empty())
+			utf8[rnd.next(static_cast<Poco::UInt32>(utf8.size()))] = static_cast<char>(0x80 + rnd.next(128));
+
+		// the identity transform disables the fast path
+		TextConverter toLatin1(utf8Encoding, latin1Encoding);
+		std::string fast, slow;
+		int fastErrors = toLatin1.convert(utf8, fast);
+		int slowErrors = toLatin1.convert(utf8, slow, identity);
+		assertTrue (fast == slow);
+		assertTrue (fastErrors == slowErrors);
+		fast.clear();
+		slow.clear();
+		fastErrors = toLatin1.convert(utf8.data(), static_cast<int>(utf8.size()), fast);
+		slowErrors = toLatin1.convert(utf8.data(), static_cast<int>(utf8.size()), slow, identity);
+		assertTrue (fast == slow);
+		assertTrue (fastErrors == slowErrors);
+
+		TextConverter toUTF8(utf8Encoding, utf8Encoding);
+		fast.clear();
+		slow.clear();
+		fastErrors = toUTF8.convert(utf8, fast);
+		slowErrors = toUTF8.convert(utf8, slow, identity);
+		assertTrue (fast == slow);
+		assertTrue (fastErrors == slowErrors);
+
+		TextConverter fromCP1252(cp1252Encoding, utf8Encoding);
+		fast.clear();
+		slow.clear();
+		fastErrors = fromCP1252.convert(utf8, fast);
+		slowErrors = fromCP1252.convert(utf8, slow, identity);
+		assertTrue (fast == slow);
+		assertTrue (fastErrors == slowErrors);
+	}
+}
+
+
+void TextConverterTest::testPerformance()
+{
+	UTF8Encoding utf8Encoding;
+	Latin1Encoding latin1Encoding;
+	Poco::Random rnd;
+	std::string ascii = randomText(rnd, 64*1024*1024, 0);
+	std::string mixed = randomText(rnd, 64*1024*1024, 5);
+	Poco::Stopwatch sw;
+
+	sw.start();
+	bool valid = UTF8Encoding::isValid(ascii.data(), ascii.size());
+	sw.stop();
+	std::cout << "isValid (ASCII):          " << sw.elapsed()/1000 << " ms" << std::endl;
+	assertTrue (valid);
+
+	sw.restart();
+	valid = UTF8Encoding::isValid(mixed.data(), mixed.size());
+	sw.stop();
+	std::cout << "isValid (mixed):          " << sw.elapsed()/1000 << " ms" << std::endl;
+	assertTrue (valid);
+
+	sw.restart();
+	valid = isValidReference(mixed);
+	sw.stop();
+	std::cout << "isLegal loop (mixed):     " << sw.elapsed()/1000 << " ms" << std::endl;
+	assertTrue (valid);
+
+	TextConverter converter(utf8Encoding, latin1Encoding);
+	std::string result;
+	sw.restart();
+	converter.convert(mixed, result);
+	sw.stop();
+	std::cout << "UTF-8 to Latin-1:         " << sw.elapsed()/1000 << " ms" << std::endl;
+
+	result.clear();
+	sw.restart();
+	converter.convert(mixed, result, identity);
+	sw.stop();
+	std::cout << "UTF-8 to Latin-1 (slow):  " << sw.elapsed()/1000 << " ms" << std::endl;
+}
+
+
 void TextConverterTest::setUp()
 {
 }
@@ -354,6 +557,10 @@ CppUnit::Test* TextConverterTest::suite()
 	CppUnit_addTest(pSuite, TextConverterTest, testCP1251toUTF8);
 	CppUnit_addTest(pSuite, TextConverterTest, testCP1252toUTF8);
 	CppUnit_addTest(pSuite, TextConverterTest, testErrors);
+	CppUnit_addTest(pSuite, TextConverterTest, testUTF8Validation);
+	CppUnit_addTest(pSuite, TextConverterTest, testCountASCII);
+	CppUnit_addTest(pSuite, TextConverterTest, testFastConversion);
+	// CppUnit_addTest(pSuite, TextConverterTest, testPerformance);
 
 	return pSuite;
 }
@@ -34,6 +34,10 @@ public:
 	void testCP1251toUTF8();
 	void testCP1252toUTF8();
 	void testErrors();
+	void testUTF8Validation();
+	void testCountASCII();
+	void testFastConversion();
+	void testPerformance();
 
 	void setUp();
 	void tearDown();
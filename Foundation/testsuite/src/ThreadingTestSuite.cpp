@@ -15,6 +15,7 @@
 #include "RWLockTest.h"
 #include "ThreadPoolTest.h"
 #include "TimerTest.h"
+#include "TimingWheelTest.h"
 #include "ThreadLocalTest.h"
 #include "ActivityTest.h"
 #include "ActiveMethodTest.h"
@@ -32,6 +33,7 @@ CppUnit::Test* ThreadingTestSuite::suite()
 	pSuite->addTest(RWLockTest::suite());
 	pSuite->addTest(ThreadPoolTest::suite());
 	pSuite->addTest(TimerTest::suite());
+	pSuite->addTest(TimingWheelTest::suite());
 	pSuite->addTest(ThreadLocalTest::suite());
 	pSuite->addTest(ActivityTest::suite());
 	pSuite->addTest(ActiveMethodTest::suite());
@@ -0,0 +1,452 @@
+//
+// TimingWheelTest.cpp
+//
+// Copyright (c) 2009, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "TimingWheelTest.h"
+#include "Poco/CppUnit/TestCaller.h"
+#include "Poco/CppUnit/TestSuite.h"
+#include "Poco/TimingWheel.h"
+#include "Poco/TimedNotificationQueue.h"
+#include "Poco/Notification.h"
+#include "Poco/Random.h"
+#include "Poco/Stopwatch.h"
+#include "Poco/Exception.h"
+#include <iostream>
+
+
+using Poco::TimingWheel;
+using Poco::Clock;
+using Poco::UInt64;
+
+
+namespace
+{
+	class TestTimeout: public TimingWheel::Timeout
+	{
+	public:
+		typedef Poco::AutoPtr<TestTimeout> Ptr;
+
+		TestTimeout(int id):
+			_id(id)
+		{
+		}
+
+		int id() const
+		{
+			return _id;
+		}
+
+	private:
+		int _id;
+	};
+
+	int expiredId(const TimingWheel::TimeoutVec& expired, std::size_t index)
+	{
+		return static_cast<const TestTimeout*>(expired[index].get())->id();
+	}
+
+	Clock::ClockVal ceilTick(const Clock& deadline, Clock::ClockDiff resolution)
+	{
+		return (deadline.raw() + resolution - 1)/resolution;
+	}
+}
+
+
+TimingWheelTest::TimingWheelTest(const std::string& name): CppUnit::TestCase(name)
+{
+}
+
+
+TimingWheelTest::~TimingWheelTest()
+{
+}
+
+
+void TimingWheelTest::testSchedule()
+{
+	TimingWheel wheel(1000, Clock(0));
+	assertTrue (wheel.empty());
+	assertTrue (wheel.resolution() == 1000);
+
+	const Clock::ClockVal deadlines[] = {500, 5000, 300000, 70000000, Clock::ClockVal(5)*3600*1000000};
+	const std::size_t count = sizeof(deadlines)/sizeof(deadlines[0]);
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		TestTimeout::Ptr pTimeout = new TestTimeout(static_cast<int>(i));
+		wheel.schedule(pTimeout, Clock(deadlines[i]));
+		assertTrue (pTimeout->isScheduled());
+		assertTrue (pTimeout->deadline() == Clock(deadlines[i]));
+		assertTrue (pTimeout->referenceCount() == 2);
+	}
+	assertTrue (wheel.size() == count);
+
+	TimingWheel::TimeoutVec expired;
+	Clock::ClockVal expiry = 1000;
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		assertTrue (wheel.advance(Clock(expiry - 1), expired) == 0);
+		assertTrue (wheel.advance(Clock(expiry), expired) == 1);
+		assertTrue (expiredId(expired, 0) == static_cast<int>(i));
+		assertTrue (!expired[0]->isScheduled());
+		assertTrue (expired[0]->referenceCount() == 1);
+		assertTrue (wheel.size() == count - i - 1);
+		expired.clear();
+		if (i + 1 < count) expiry = deadlines[i + 1];
+	}
+	assertTrue (wheel.empty());
+	assertTrue (wheel.now() == Clock(expiry));
+}
+
+
+void TimingWheelTest::testOrder()
+{
+	TimingWheel wheel(1000, Clock(0));
+	wheel.schedule(new TestTimeout(1), Clock(10000));
+	wheel.schedule(new TestTimeout(2), Clock(9500));
+	wheel.schedule(new TestTimeout(3), Clock(5000));
+	wheel.schedule(new TestTimeout(4), Clock(900000));
+	wheel.schedule(new TestTimeout(5), Clock(800000));
+
+	TimingWheel::TimeoutVec expired;
+	assertTrue (wheel.advance(Clock(1000000), expired) == 5);
+	assertTrue (expiredId(expired, 0) == 3);
+	assertTrue (expiredId(expired, 1) == 2);
+	assertTrue (expiredId(expired, 2) == 1);
+	assertTrue (expiredId(expired, 3) == 5);
+	assertTrue (expiredId(expired, 4) == 4);
+
+	// Within a tick, timeouts cascaded from an outer wheel must be
+	// ordered with those scheduled directly, and equal deadlines
+	// expire in the order they have been scheduled.
+	expired.clear();
+	wheel.schedule(new TestTimeout(6), Clock(1300900));
+	wheel.schedule(new TestTimeout(7), Clock(1300500));
+	wheel.advance(Clock(1100000), expired);
+	assertTrue (expired.empty());
+	wheel.schedule(new TestTimeout(8), Clock(1300800));
+	wheel.schedule(new TestTimeout(9), Clock(1300200));
+	wheel.schedule(new TestTimeout(10), Clock(1300500));
+	assertTrue (wheel.advance(Clock(1301000), expired) == 5);
+	assertTrue (expiredId(expired, 0) == 9);
+	assertTrue (expiredId(expired, 1) == 7);
+	assertTrue (expiredId(expired, 2) == 10);
+	assertTrue (expiredId(expired, 3) == 8);
+	assertTrue (expiredId(expired, 4) == 6);
+}
+
+
+void TimingWheelTest::testCancel()
+{
+	TimingWheel wheel(1000, Clock(0));
+	TestTimeout::Ptr pTimeout1 = new TestTimeout(1);
+	TestTimeout::Ptr pTimeout2 = new TestTimeout(2);
+	TestTimeout::Ptr pTimeout3 = new TestTimeout(3);
+	wheel.schedule(pTimeout1, Clock(10000));
+	wheel.schedule(pTimeout2, Clock(10000));
+	wheel.schedule(pTimeout3, Clock(10000000));
+	assertTrue (wheel.size() == 3);
+
+	assertTrue (wheel.cancel(pTimeout2));
+	assertTrue (!pTimeout2->isScheduled());
+	assertTrue (pTimeout2->referenceCount() == 1);
+	assertTrue (!wheel.cancel(pTimeout2));
+	assertTrue (wheel.cancel(pTimeout3));
+	assertTrue (wheel.size() == 1);
+
+	TimingWheel::TimeoutVec expired;
+	assertTrue (wheel.advance(Clock(20000000), expired) == 1);
+	assertTrue (expiredId(expired, 0) == 1);
+	assertTrue (!wheel.cancel(pTimeout1));
+	assertTrue (wheel.empty());
+	expired.clear();
+
+	wheel.schedule(pTimeout1, Clock(30000000));
+	wheel.schedule(pTimeout2, Clock(40000000));
+	wheel.clear();
+	assertTrue (wheel.empty());
+	assertTrue (!pTimeout1->isScheduled());
+	assertTrue (pTimeout1->referenceCount() == 1);
+	assertTrue (wheel.advance(Clock(50000000), expired) == 0);
+}
+
+
+void TimingWheelTest::testReschedule()
+{
+	TimingWheel wheel(1000, Clock(0));
+	TestTimeout::Ptr pTimeout = new TestTimeout(1);
+	wheel.schedule(pTimeout, Clock(10000));
+	wheel.schedule(pTimeout, Clock(100000));
+	assertTrue (wheel.size() == 1);
+	assertTrue (pTimeout->referenceCount() == 2);
+
+	TimingWheel::TimeoutVec expired;
+	assertTrue (wheel.advance(Clock(99999), expired) == 0);
+	wheel.schedule(pTimeout, Clock(50000000));
+	assertTrue (wheel.advance(Clock(49999999), expired) == 0);
+	wheel.schedule(pTimeout, Clock(50000001));
+	assertTrue (wheel.advance(Clock(50000000), expired) == 0);
+	assertTrue (wheel.advance(Clock(50001000), expired) == 1);
+
+	TimingWheel other(1000, Clock(0));
+	other.schedule(pTimeout, Clock(100000000));
+	try
+	{
+		wheel.schedule(pTimeout, Clock(100000000));
+		fail("must not schedule with two wheels");
+	}
+	catch (Poco::InvalidAccessException&)
+	{
+	}
+	assertTrue (!wheel.cancel(pTimeout));
+	assertTrue (other.cancel(pTimeout));
+}
+
+
+void TimingWheelTest::testPastDeadline()
+{
+	TimingWheel wheel(1000, Clock(0));
+	TimingWheel::TimeoutVec expired;
+	wheel.advance(Clock(10000), expired);
+	assertTrue (wheel.now() == Clock(10000));
+
+	wheel.schedule(new TestTimeout(1), Clock(5000));
+	wheel.schedule(new TestTimeout(2), Clock(10000));
+	assertTrue (wheel.advance(Clock(10999), expired) == 0);
+	assertTrue (wheel.advance(Clock(11000), expired) == 2);
+	assertTrue (expiredId(expired, 0) == 1);
+	assertTrue (expiredId(expired, 1) == 2);
+}
+
+
+void TimingWheelTest::testNextDeadline()
+{
+	TimingWheel wheel(1000, Clock(0));
+	Clock deadline(0);
+	assertTrue (!wheel.nextDeadline(deadline));
+
+	const Clock::ClockVal deadlines[] = {70000000, 70000000, 3000, 123456789};
+	for (int i = 0; i < 4; ++i)
+	{
+		wheel.schedule(new TestTimeout(i), Clock(deadlines[i]));
+	}
+	assertTrue (wheel.nextDeadline(deadline));
+	assertTrue (deadline == Clock(3000));
+
+	TimingWheel::TimeoutVec expired;
+	int steps = 0;
+	while (wheel.nextDeadline(deadline))
+	{
+		std::size_t n = expired.size();
+		wheel.advance(deadline, expired);
+		for (std::size_t i = n; i < expired.size(); ++i)
+		{
+			assertTrue (ceilTick(expired[i]->deadline(), 1000)*1000 == deadline.raw());
+		}
+		++steps;
+	}
+	assertTrue (expired.size() == 4);
+	assertTrue (expiredId(expired, 0) == 2);
+	assertTrue (expiredId(expired, 1) == 0);
+	assertTrue (expiredId(expired, 2) == 1);
+	assertTrue (expiredId(expired, 3) == 3);
+	assertTrue (steps <= 10);
+}
+
+
+void TimingWheelTest::testFarFuture()
+{
+	// 256^4 ticks of one microsecond cover only about 71 minutes.
+	TimingWheel wheel(1, Clock(0));
+	const Clock::ClockVal hour = Clock::ClockVal(3600)*1000000;
+	wheel.schedule(new TestTimeout(1), Clock(3*hour));
+	wheel.schedule(new TestTimeout(2), Clock(30*hour + 1));
+	wheel.schedule(new TestTimeout(3), Clock(Clock::CLOCKVAL_MAX));
+
+	TimingWheel::TimeoutVec expired;
+	assertTrue (wheel.advance(Clock(3*hour - 1), expired) == 0);
+	assertTrue (wheel.advance(Clock(3*hour), expired) == 1);
+	assertTrue (expiredId(expired, 0) == 1);
+
+	Clock deadline(0);
+	while (expired.size() < 2 && wheel.nextDeadline(deadline))
+	{
+		assertTrue (deadline <= Clock(30*hour + 1));
+		wheel.advance(deadline, expired);
+	}
+	assertTrue (expired.size() == 2);
+	assertTrue (expiredId(expired, 1) == 2);
+	assertTrue (wheel.now() == Clock(30*hour + 1));
+	assertTrue (wheel.size() == 1);
+}
+
+
+void TimingWheelTest::testRandom()
+{
+	const Clock::ClockDiff resolution = 1000;
+	const int count = 20000;
+	Poco::Random rnd;
+	rnd.seed(42);
+
+	TimingWheel wheel(resolution, Clock(0));
+	std::vector<TestTimeout::Ptr> timeouts;
+	for (int i = 0; i < count; ++i)
+	{
+		timeouts.push_back(new TestTimeout(i));
+	}
+
+	TimingWheel::TimeoutVec expired;
+	std::vector<int> expiredCount(count, 0);
+	Clock::ClockVal now = 0;
+	std::size_t scheduled = 0;
+	for (int round = 0; round < 200; ++round)
+	{
+		for (int j = 0; j < 500; ++j)
+		{
+			TestTimeout::Ptr pTimeout = timeouts[rnd.next(count)];
+			switch (rnd.next(4))
+			{
+			case 0:
+				if (wheel.cancel(pTimeout)) --scheduled;
+				break;
+			default:
+				if (!pTimeout->isScheduled()) ++scheduled;
+				Clock::ClockVal range = Clock::ClockVal(1) << (4 + rnd.next(28));
+				wheel.schedule(pTimeout, Clock(now + 1 + static_cast<Clock::ClockVal>(rnd.next()) % range));
+				break;
+			}
+		}
+		assertTrue (wheel.size() == scheduled);
+
+		Clock::ClockVal prevTick = now/resolution;
+		now += 1 + static_cast<Clock::ClockVal>(rnd.next()) % (Clock::ClockVal(1) << (4 + rnd.next(24)));
+		Clock::ClockVal nowTick = now/resolution;
+		expired.clear();
+		wheel.advance(Clock(now), expired);
+		Clock lastDeadline(0);
+		for (TimingWheel::TimeoutVec::const_iterator it = expired.begin(); it != expired.end(); ++it)
+		{
+			Clock::ClockVal tick = ceilTick((*it)->deadline(), resolution);
+			assertTrue (tick > prevTick);
+			assertTrue (tick <= nowTick);
+			assertTrue ((*it)->deadline() >= lastDeadline);
+			lastDeadline = (*it)->deadline();
+			++expiredCount[static_cast<const TestTimeout*>(it->get())->id()];
+		}
+		scheduled -= expired.size();
+		assertTrue (wheel.size() == scheduled);
+
+		// Nothing that is still scheduled may be overdue.
+		for (std::vector<TestTimeout::Ptr>::const_iterator it = timeouts.begin(); it != timeouts.end(); ++it)
+		{
+			if ((*it)->isScheduled())
+			{
+				assertTrue (ceilTick((*it)->deadline(), resolution) > nowTick);
+			}
+		}
+	}
+
+	Clock deadline(0);
+	Clock::ClockVal lastTick = 0;
+	while (wheel.nextDeadline(deadline))
+	{
+		assertTrue (deadline.raw()/resolution > lastTick);
+		lastTick = deadline.raw()/resolution;
+		expired.clear();
+		wheel.advance(deadline, expired);
+		for (TimingWheel::TimeoutVec::const_iterator it = expired.begin(); it != expired.end(); ++it)
+		{
+			assertTrue (ceilTick((*it)->deadline(), resolution) == lastTick);
+		}
+	}
+	assertTrue (wheel.empty());
+}
+
+
+void TimingWheelTest::testPerformance()
+{
+	const int count = 1000000;
+	Poco::Random rnd;
+	std::vector<TimingWheel::Timeout::Ptr> timeouts;
+	std::vector<Poco::Notification::Ptr> notifications;
+	std::vector<Clock::ClockVal> delays;
+	for (int i = 0; i < count; ++i)
+	{
+		timeouts.push_back(new TestTimeout(i));
+		notifications.push_back(new Poco::Notification);
+		delays.push_back(1000 + rnd.next(60000000));
+	}
+
+	Poco::Stopwatch sw;
+	{
+		TimingWheel wheel;
+		Clock now;
+		sw.start();
+		for (int i = 0; i < count; ++i)
+		{
+			wheel.schedule(timeouts[i], now + delays[i]);
+		}
+		for (int i = 0; i < count; ++i)
+		{
+			wheel.schedule(timeouts[i], now + delays[count - i - 1]);
+		}
+		for (int i = 0; i < count; ++i)
+		{
+			wheel.cancel(timeouts[i]);
+		}
+		sw.stop();
+	}
+	std::cout << "TimingWheel:            " << sw.elapsed()/1000 << " ms" << std::endl;
+
+	sw.restart();
+	{
+		Poco::TimedNotificationQueue queue;
+		Clock now;
+		sw.start();
+		for (int i = 0; i < count; ++i)
+		{
+			queue.enqueueNotification(notifications[i], now + delays[i]);
+		}
+		queue.clear();
+		for (int i = 0; i < count; ++i)
+		{
+			queue.enqueueNotification(notifications[i], now + delays[count - i - 1]);
+		}
+		queue.clear();
+		sw.stop();
+	}
+	std::cout << "TimedNotificationQueue: " << sw.elapsed()/1000 << " ms" << std::endl;
+}
+
+
+void TimingWheelTest::setUp()
+{
+}
+
+
+void TimingWheelTest::tearDown()
+{
+}
+
+
+CppUnit::Test* TimingWheelTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("TimingWheelTest");
+
+	CppUnit_addTest(pSuite, TimingWheelTest, testSchedule);
+	CppUnit_addTest(pSuite, TimingWheelTest, testOrder);
+	CppUnit_addTest(pSuite, TimingWheelTest, testCancel);
+	CppUnit_addTest(pSuite, TimingWheelTest, testReschedule);
+	CppUnit_addTest(pSuite, TimingWheelTest, testPastDeadline);
+	CppUnit_addTest(pSuite, TimingWheelTest, testNextDeadline);
+	CppUnit_addTest(pSuite, TimingWheelTest, testFarFuture);
+	CppUnit_addTest(pSuite, TimingWheelTest, testRandom);
+	// CppUnit_addTest(pSuite, TimingWheelTest, testPerformance);
+
+	return pSuite;
+}
@@ -0,0 +1,44 @@
+//
+// TimingWheelTest.h
+//
+// Definition of the TimingWheelTest class.
+//
+// Copyright (c) 2009, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef TimingWheelTest_INCLUDED
+#define TimingWheelTest_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include "Poco/CppUnit/TestCase.h"
+
+
+class TimingWheelTest: public CppUnit::TestCase
+{
+public:
+	TimingWheelTest(const std::string& name);
+	~TimingWheelTest();
+
+	void testSchedule();
+	void testOrder();
+	void testCancel();
+	void testReschedule();
+	void testPastDeadline();
+	void testNextDeadline();
+	void testFarFuture();
+	void testRandom();
+	void testPerformance();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+};
+
+
+#endif // TimingWheelTest_INCLUDED
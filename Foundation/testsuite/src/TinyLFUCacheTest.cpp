@@ -0,0 +1,258 @@
+//
+// TinyLFUCacheTest.cpp
+//
+// Copyright (c) 2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "TinyLFUCacheTest.h"
+#include "Poco/CppUnit/TestCaller.h"
+#include "Poco/CppUnit/TestSuite.h"
+#include "Poco/Exception.h"
+#include "Poco/TinyLFUCache.h"
+#include "Poco/LRUCache.h"
+#include "Poco/Random.h"
+#include <vector>
+#include <cmath>
+#include <iostream>
+
+
+using namespace Poco;
+
+
+namespace
+{
+	std::vector<int> zipfTrace(int keys, int length, double skew, UInt32 seed)
+		/// Generates a trace of keys in [0, keys) following
+		/// a Zipf distribution.
+	{
+		std::vector<double> cdf(keys);
+		double sum = 0;
+		for (int i = 0; i < keys; ++i)
+		{
+			sum += 1.0/std::pow(i + 1.0, skew);
+			cdf[i] = sum;
+		}
+
+		Random rnd;
+		rnd.seed(seed);
+		std::vector<int> trace;
+		trace.reserve(length);
+		for (int i = 0; i < length; ++i)
+		{
+			double u = rnd.nextDouble()*sum;
+			trace.push_back(static_cast<int>(std::lower_bound(cdf.begin(), cdf.end(), u) - cdf.begin()));
+		}
+		return trace;
+	}
+
+	std::vector<int> scanTrace(const std::vector<int>& base, int scanLength, std::size_t scanEvery)
+		/// Interleaves the base trace with scans over keys
+		/// that are never used again.
+	{
+		std::vector<int> trace;
+		int scanKey = 1000000;
+		for (std::size_t i = 0; i < base.size(); ++i)
+		{
+			trace.push_back(base[i]);
+			if (i % scanEvery == scanEvery - 1)
+			{
+				for (int j = 0; j < scanLength; ++j) trace.push_back(scanKey++);
+			}
+		}
+		return trace;
+	}
+
+	template <class C>
+	double hitRatio(C& cache, const std::vector<int>& trace)
+	{
+		int hits = 0;
+		for (std::vector<int>::const_iterator it = trace.begin(); it != trace.end(); ++it)
+		{
+			if (cache.get(*it)) ++hits;
+			else cache.add(*it, *it);
+		}
+		return double(hits)/trace.size();
+	}
+}
+
+
+TinyLFUCacheTest::TinyLFUCacheTest(const std::string& rName): CppUnit::TestCase(rName)
+{
+}
+
+
+TinyLFUCacheTest::~TinyLFUCacheTest()
+{
+}
+
+
+void TinyLFUCacheTest::testClear()
+{
+	TinyLFUCache<int, int> aCache(3);
+	assertTrue (aCache.size() == 0);
+	assertTrue (aCache.getAllKeys().size() == 0);
+	aCache.add(1, 2);
+	aCache.add(3, 4);
+	aCache.add(5, 6);
+	assertTrue (aCache.size() == 3);
+	assertTrue (aCache.getAllKeys().size() == 3);
+	assertTrue (aCache.has(1));
+	assertTrue (aCache.has(3));
+	assertTrue (aCache.has(5));
+	assertTrue (*aCache.get(1) == 2);
+	assertTrue (*aCache.get(3) == 4);
+	assertTrue (*aCache.get(5) == 6);
+	aCache.clear();
+	assertTrue (!aCache.has(1));
+	assertTrue (!aCache.has(3));
+	assertTrue (!aCache.has(5));
+}
+
+
+void TinyLFUCacheTest::testCacheSize0()
+{
+	// cache size 0 is illegal
+	try
+	{
+		TinyLFUCache<int, int> aCache(0);
+		failmsg ("cache size of 0 is illegal, test should fail");
+	}
+	catch (Poco::InvalidArgumentException&)
+	{
+	}
+}
+
+
+void TinyLFUCacheTest::testCacheSize1()
+{
+	TinyLFUCache<int, int> aCache(1);
+	aCache.add(1, 2);
+	assertTrue (aCache.has(1));
+	assertTrue (*aCache.get(1) == 2);
+
+	aCache.add(3, 4); // replaces 1
+	assertTrue (!aCache.has(1));
+	assertTrue (aCache.has(3));
+	assertTrue (*aCache.get(3) == 4);
+	assertTrue (aCache.size() == 1);
+
+	aCache.remove(3);
+	assertTrue (!aCache.has(3));
+	assertTrue (aCache.size() == 0);
+}
+
+
+void TinyLFUCacheTest::testFrequencySketch()
+{
+	FrequencySketch<int> sketch(100);
+	assertTrue (sketch.frequency(1) == 0);
+	sketch.increment(1);
+	sketch.increment(1);
+	sketch.increment(2);
+	assertTrue (sketch.frequency(1) >= 2);
+	assertTrue (sketch.frequency(2) >= 1);
+	for (int i = 0; i < 100; ++i) sketch.increment(1);
+	assertTrue (sketch.frequency(1) == 15);
+
+	// aging halves all counters
+	for (int i = 0; i < 1000; ++i) sketch.increment(1000 + i);
+	assertTrue (sketch.frequency(1) < 15);
+
+	sketch.clear();
+	assertTrue (sketch.frequency(1) == 0);
+}
+
+
+void TinyLFUCacheTest::testAdmission()
+{
+	TinyLFUCache<int, int> aCache(10);
+	for (int i = 0; i < 10; ++i)
+	{
+		aCache.add(i, i);
+	}
+	assertTrue (aCache.size() == 10);
+
+	// make 0 - 8 popular
+	for (int r = 0; r < 5; ++r)
+	{
+		for (int i = 0; i < 9; ++i)
+		{
+			assertTrue (*aCache.get(i) == i);
+		}
+	}
+
+	// new, unpopular keys do not displace the popular ones
+	for (int i = 100; i < 150; ++i)
+	{
+		aCache.add(i, i);
+		assertTrue (aCache.size() <= 10);
+	}
+	for (int i = 0; i < 9; ++i)
+	{
+		assertTrue (aCache.has(i));
+	}
+	assertTrue (aCache.has(149)); // still in the admission window
+}
+
+
+void TinyLFUCacheTest::testScanResistance()
+{
+	std::vector<int> trace = scanTrace(zipfTrace(2000, 20000, 0.9, 42), 200, 500);
+
+	LRUCache<int, int> lruCache(200);
+	TinyLFUCache<int, int> lfuCache(200);
+	double lruRatio = hitRatio(lruCache, trace);
+	double lfuRatio = hitRatio(lfuCache, trace);
+	assertTrue (lfuRatio > lruRatio);
+}
+
+
+void TinyLFUCacheTest::hitRatioBenchmark()
+{
+	const int cacheSize = 1000;
+	std::cout << std::endl;
+	double skews[] = { 0.6, 0.8, 1.0 };
+	for (int s = 0; s < 3; ++s)
+	{
+		std::vector<int> zipf = zipfTrace(100000, 500000, skews[s], 4711);
+		std::vector<int> scan = scanTrace(zipf, 5000, 20000);
+
+		LRUCache<int, int> lruCache(cacheSize);
+		TinyLFUCache<int, int> lfuCache(cacheSize);
+		std::cout << "Zipf " << skews[s] << ": LRUStrategy=" << hitRatio(lruCache, zipf) << " TinyLFUStrategy=" << hitRatio(lfuCache, zipf) << std::endl;
+
+		LRUCache<int, int> lruScanCache(cacheSize);
+		TinyLFUCache<int, int> lfuScanCache(cacheSize);
+		std::cout << "Zipf " << skews[s] << " with scans: LRUStrategy=" << hitRatio(lruScanCache, scan) << " TinyLFUStrategy=" << hitRatio(lfuScanCache, scan) << std::endl;
+	}
+}
+
+
+void TinyLFUCacheTest::setUp()
+{
+}
+
+
+void TinyLFUCacheTest::tearDown()
+{
+}
+
+
+CppUnit::Test* TinyLFUCacheTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("TinyLFUCacheTest");
+
+	CppUnit_addTest(pSuite, TinyLFUCacheTest, testClear);
+	CppUnit_addTest(pSuite, TinyLFUCacheTest, testCacheSize0);
+	CppUnit_addTest(pSuite, TinyLFUCacheTest, testCacheSize1);
+	CppUnit_addTest(pSuite, TinyLFUCacheTest, testFrequencySketch);
+	CppUnit_addTest(pSuite, TinyLFUCacheTest, testAdmission);
+	CppUnit_addTest(pSuite, TinyLFUCacheTest, testScanResistance);
+	//CppUnit_addTest(pSuite, TinyLFUCacheTest, hitRatioBenchmark);
+
+	return pSuite;
+}
@@ -0,0 +1,41 @@
+//
+// TinyLFUCacheTest.h
+//
+// Tests for TinyLFUCache
+//
+// Copyright (c) 2006, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef TinyLFUCacheTest_INCLUDED
+#define TinyLFUCacheTest_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include "Poco/CppUnit/TestCase.h"
+
+
+class TinyLFUCacheTest: public CppUnit::TestCase
+{
+public:
+	TinyLFUCacheTest(const std::string& name);
+	~TinyLFUCacheTest();
+
+	void testClear();
+	void testCacheSize0();
+	void testCacheSize1();
+	void testFrequencySketch();
+	void testAdmission();
+	void testScanResistance();
+	void hitRatioBenchmark();
+
+	void setUp();
+	void tearDown();
+	static CppUnit::Test* suite();
+};
+
+
+#endif // TinyLFUCacheTest_INCLUDED
@@ -16,6 +16,7 @@
 #include "Poco/CppUnit/TestCaller.h"
 #include "Poco/CppUnit/TestSuite.h"
 #include "Poco/UTFString.h"
+#include "Poco/Random.h"
 
 
 UnicodeConverterTest::UnicodeConverterTest(const std::string& rName): CppUnit::TestCase(rName)
@@ -40,6 +41,63 @@ void UnicodeConverterTest::testUTF32()
 }
 
 
+void UnicodeConverterTest::testRoundTrip()
+{
+	Poco::Random rnd;
+	rnd.seed(1);
+	for (int i = 0; i < 500; ++i)
+	{
+		Poco::UTF32String utf32;
+		int length = rnd.next(200);
+		for (int k = 0; k < length; ++k)
+		{
+			Poco::UInt32 r = rnd.next(4);
+			Poco::UTF32Char c;
+			if (r == 0) c = 0x20 + rnd.next(0x5F);
+			else if (r == 1) c = 0x80 + rnd.next(0x780);
+			else if (r == 2) c = 0xE000 + rnd.next(0x2000);
+			else c = 0x10000 + rnd.next(0x100000);
+			utf32 += c;
+		}
+		std::string utf8;
+		Poco::UnicodeConverter::convert(utf32, utf8);
+		Poco::UTF32String utf32b;
+		Poco::UnicodeConverter::convert(utf8, utf32b);
+		assertTrue (utf32 == utf32b);
+
+		Poco::UTF16String utf16;
+		Poco::UnicodeConverter::convert(utf8, utf16);
+		std::string utf8b;
+		Poco::UnicodeConverter::convert(utf16, utf8b);
+		assertTrue (utf8 == utf8b);
+		utf8b.clear();
+		Poco::UnicodeConverter::convert(utf16.data(), utf16.size(), utf8b);
+		assertTrue (utf8 == utf8b);
+	}
+}
+
+
+void UnicodeConverterTest::testInvalid()
+{
+	// invalid input is converted character by character
+	const unsigned char bad[] = {'a', 0xC3, 'b', 0x80, 0xE2, 0x82, 0xAC, 0x00};
+	Poco::UTF16String utf16;
+	Poco::UnicodeConverter::convert(std::string(reinterpret_cast<const char*>(bad)), utf16);
+	assertTrue (utf16.size() >= 3);
+	assertTrue (utf16[0] == 'a');
+	assertTrue (utf16[utf16.size() - 1] == 0x20AC);
+
+	Poco::UTF16String unpaired;
+	unpaired += 'x';
+	unpaired += 0xD800;
+	unpaired += 'y';
+	std::string utf8;
+	Poco::UnicodeConverter::convert(unpaired, utf8);
+	assertTrue (!utf8.empty());
+	assertTrue (utf8[0] == 'x');
+}
+
+
 void UnicodeConverterTest::setUp()
 {
 }
@@ -56,6 +114,8 @@ CppUnit::Test* UnicodeConverterTest::suite()
 
 	CppUnit_addTest(pSuite, UnicodeConverterTest, testUTF16);
 	CppUnit_addTest(pSuite, UnicodeConverterTest, testUTF32);
+	CppUnit_addTest(pSuite, UnicodeConverterTest, testRoundTrip);
+	CppUnit_addTest(pSuite, UnicodeConverterTest, testInvalid);
 
 	return pSuite;
 }
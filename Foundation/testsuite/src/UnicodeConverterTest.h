@@ -29,6 +29,8 @@ public:
 
 	void testUTF16();
 	void testUTF32();
+	void testRoundTrip();
+	void testInvalid();
 
 	void setUp();
 	void tearDown();
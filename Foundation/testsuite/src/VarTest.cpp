@@ -2761,6 +2761,79 @@ void VarTest::testIterator()
 }
 
 
+void VarTest::testMove()
+{
+	Var v1(std::string("a string too long to be stored in place"));
+	const std::string* pStr = v1.tryGet<std::string>();
+	assertTrue (pStr != 0);
+
+	Var v2(std::move(v1));
+	assertTrue (v1.isEmpty());
+	assertTrue (v2.tryGet<std::string>() == pStr);
+	assertTrue (v2 == "a string too long to be stored in place");
+
+	Var v3 = 42;
+	v3 = std::move(v2);
+	assertTrue (v2.isEmpty());
+	assertTrue (v3.tryGet<std::string>() == pStr);
+
+	Var v4;
+	v4 = std::move(v2);
+	assertTrue (v4.isEmpty());
+
+	std::string s("moved");
+	v4 = std::move(s);
+	assertTrue (v4.type() == typeid(std::string));
+	assertTrue (v4 == "moved");
+
+	std::vector<Var> elements;
+	elements.push_back(1);
+	elements.push_back(std::string("a string too long to be stored in place"));
+	Var v5(elements);
+	v5 = std::move(v5[0]);
+	assertTrue (v5 == 1);
+	Var v6(elements);
+	v6 = std::move(v6[1]);
+	assertTrue (v6 == "a string too long to be stored in place");
+
+	std::vector<Var> vec;
+	vec.push_back(Var(std::string("first")));
+	pStr = vec[0].tryGet<std::string>();
+	for (int i = 0; i < 100; ++i) vec.push_back(i);
+#ifdef POCO_NO_SOO
+	// Growing the vector moves the elements instead of cloning them.
+	assertTrue (vec[0].tryGet<std::string>() == pStr);
+#endif
+	assertTrue (vec[0] == "first");
+	assertTrue (vec[100] == 99);
+}
+
+
+void VarTest::testTryGet()
+{
+	Var v;
+	assertTrue (v.tryGet<int>() == 0);
+
+	v = 42;
+	assertTrue (v.tryGet<int>() != 0);
+	assertTrue (*v.tryGet<int>() == 42);
+	assertTrue (v.tryGet<Poco::Int64>() == 0);
+	assertTrue (v.tryGet<std::string>() == 0);
+
+	v = "42";
+	assertTrue (v.tryGet<int>() == 0);
+	assertTrue (v.tryGet<std::string>() != 0);
+	assertTrue (*v.tryGet<std::string>() == "42");
+	assertTrue (v.tryGet<std::string>() == &v.extract<std::string>());
+
+	std::vector<Var> vec;
+	vec.push_back(1);
+	v = vec;
+	assertTrue (v.tryGet<std::vector<Var> >() != 0);
+	assertTrue (v.tryGet<std::vector<Var> >()->size() == 1);
+}
+
+
 void VarTest::setUp()
 {
 }
@@ -2823,6 +2896,8 @@ CppUnit::Test* VarTest::suite()
 	CppUnit_addTest(pSuite, VarTest, testDate);
 	CppUnit_addTest(pSuite, VarTest, testEmpty);
 	CppUnit_addTest(pSuite, VarTest, testIterator);
+	CppUnit_addTest(pSuite, VarTest, testMove);
+	CppUnit_addTest(pSuite, VarTest, testTryGet);
 
 	return pSuite;
 }
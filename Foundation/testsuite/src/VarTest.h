@@ -74,6 +74,8 @@ public:
 	void testDate();
 	void testEmpty();
 	void testIterator();
+	void testMove();
+	void testTryGet();
 
 
 	void setUp();
@@ -13,9 +13,14 @@
 #include "Poco/CppUnit/TestSuite.h"
 #include "Poco/InflatingStream.h"
 #include "Poco/DeflatingStream.h"
+#include "Poco/ParallelDeflatingStream.h"
 #include "Poco/MemoryStream.h"
 #include "Poco/StreamCopier.h"
 #include "Poco/Buffer.h"
+#include "Poco/ThreadPool.h"
+#include "Poco/Stopwatch.h"
+#include "Poco/Random.h"
+#include <iostream>
 #include <sstream>
 
 
@@ -25,6 +30,7 @@ using Poco::DeflatingOutputStream;
 using Poco::DeflatingInputStream;
 using Poco::InflatingStreamBuf;
 using Poco::DeflatingStreamBuf;
+using Poco::ParallelDeflatingOutputStream;
 using Poco::StreamCopier;
 
 
@@ -175,6 +181,141 @@ void ZLibTest::testGzip3()
 }
 
 
+namespace
+{
+	std::string makeTestData(std::size_t size)
+	{
+		// compressible, but not trivially so
+		Poco::Random rnd;
+		rnd.seed(42);
+		std::string data;
+		data.reserve(size);
+		while (data.size() < size)
+		{
+			data += "line ";
+			data += std::to_string(rnd.next(1000));
+			data += ": abcdefghij";
+			data.append(rnd.next(16), static_cast<char>('a' + rnd.next(26)));
+			data += '\n';
+		}
+		data.resize(size);
+		return data;
+	}
+
+
+	std::string inflate(const std::string& compressed, InflatingStreamBuf::StreamType type)
+	{
+		std::istringstream istr(compressed);
+		InflatingInputStream inflater(istr, type);
+		std::string data;
+		StreamCopier::copyToString(inflater, data);
+		return data;
+	}
+}
+
+
+void ZLibTest::testParallelDeflate()
+{
+	std::string data = makeTestData(1000000);
+	std::ostringstream ostr;
+	ParallelDeflatingOutputStream deflater(ostr, DeflatingStreamBuf::STREAM_ZLIB, 6, 65536);
+	deflater.write(data.data(), static_cast<std::streamsize>(data.size()));
+	deflater.close();
+	std::string compressed = ostr.str();
+	assertTrue (compressed.size() < data.size()/2);
+	assertTrue (inflate(compressed, InflatingStreamBuf::STREAM_ZLIB) == data);
+
+	// ratio must be close to the one of the single-threaded stream
+	std::ostringstream ostr2;
+	DeflatingOutputStream deflater2(ostr2, DeflatingStreamBuf::STREAM_ZLIB, 6);
+	deflater2.write(data.data(), static_cast<std::streamsize>(data.size()));
+	deflater2.close();
+	assertTrue (compressed.size() < ostr2.str().size()*102/100);
+}
+
+
+void ZLibTest::testParallelGzip()
+{
+	Poco::ThreadPool pool(1, 4);
+	std::string data = makeTestData(300000);
+	for (int level = 0; level <= 9; level += 3)
+	{
+		std::ostringstream ostr;
+		ParallelDeflatingOutputStream deflater(ostr, pool, DeflatingStreamBuf::STREAM_GZIP, level, 4096);
+		for (std::size_t pos = 0; pos < data.size(); pos += 1000)
+		{
+			deflater.write(data.data() + pos, static_cast<std::streamsize>(std::min<std::size_t>(1000, data.size() - pos)));
+		}
+		deflater.close();
+		assertTrue (inflate(ostr.str(), InflatingStreamBuf::STREAM_GZIP) == data);
+	}
+	pool.joinAll();
+}
+
+
+void ZLibTest::testParallelSync()
+{
+	std::ostringstream ostr;
+	ParallelDeflatingOutputStream deflater(ostr, DeflatingStreamBuf::STREAM_GZIP);
+	deflater << "abcdefabcdefabcdefabcdefabcdefabcdef" << std::endl;
+	std::string::size_type size1 = ostr.str().size();
+	assertTrue (size1 > 10);
+	deflater << "abcdefabcdefabcdefabcdefabcdefabcdef" << std::flush;
+	assertTrue (ostr.str().size() > size1);
+	deflater.close();
+	assertTrue (inflate(ostr.str(), InflatingStreamBuf::STREAM_GZIP) == "abcdefabcdefabcdefabcdefabcdefabcdef\nabcdefabcdefabcdefabcdefabcdefabcdef");
+
+	try
+	{
+		ParallelDeflatingOutputStream invalid(ostr, DeflatingStreamBuf::STREAM_GZIP, 10);
+		fail("invalid level - must throw");
+	}
+	catch (Poco::InvalidArgumentException&)
+	{
+	}
+}
+
+
+void ZLibTest::testParallelEmpty()
+{
+	std::ostringstream ostr1;
+	ParallelDeflatingOutputStream deflater1(ostr1, DeflatingStreamBuf::STREAM_ZLIB);
+	deflater1.close();
+	assertTrue (ostr1.str().size() > 0);
+	assertTrue (inflate(ostr1.str(), InflatingStreamBuf::STREAM_ZLIB).empty());
+
+	std::ostringstream ostr2;
+	ParallelDeflatingOutputStream deflater2(ostr2, DeflatingStreamBuf::STREAM_GZIP);
+	deflater2.close();
+	assertTrue (inflate(ostr2.str(), InflatingStreamBuf::STREAM_GZIP).empty());
+}
+
+
+void ZLibTest::testParallelPerformance()
+{
+	std::string data = makeTestData(64*1024*1024);
+	Poco::Stopwatch sw;
+
+	std::ostringstream ostr1;
+	sw.start();
+	DeflatingOutputStream deflater1(ostr1, DeflatingStreamBuf::STREAM_GZIP, 6);
+	deflater1.write(data.data(), static_cast<std::streamsize>(data.size()));
+	deflater1.close();
+	sw.stop();
+	std::cout << "DeflatingOutputStream:         " << sw.elapsed()/1000 << " ms, " << ostr1.str().size() << " bytes" << std::endl;
+
+	std::ostringstream ostr2;
+	sw.restart();
+	ParallelDeflatingOutputStream deflater2(ostr2, DeflatingStreamBuf::STREAM_GZIP, 6);
+	deflater2.write(data.data(), static_cast<std::streamsize>(data.size()));
+	deflater2.close();
+	sw.stop();
+	std::cout << "ParallelDeflatingOutputStream: " << sw.elapsed()/1000 << " ms, " << ostr2.str().size() << " bytes" << std::endl;
+
+	assertTrue (inflate(ostr2.str(), InflatingStreamBuf::STREAM_GZIP) == data);
+}
+
+
 void ZLibTest::setUp()
 {
 }
@@ -196,6 +337,11 @@ CppUnit::Test* ZLibTest::suite()
 	CppUnit_addTest(pSuite, ZLibTest, testGzip1);
 	CppUnit_addTest(pSuite, ZLibTest, testGzip2);
 	CppUnit_addTest(pSuite, ZLibTest, testGzip3);
+	CppUnit_addTest(pSuite, ZLibTest, testParallelDeflate);
+	CppUnit_addTest(pSuite, ZLibTest, testParallelGzip);
+	CppUnit_addTest(pSuite, ZLibTest, testParallelSync);
+	CppUnit_addTest(pSuite, ZLibTest, testParallelEmpty);
+	// CppUnit_addTest(pSuite, ZLibTest, testParallelPerformance);
 
 	return pSuite;
 }
@@ -31,6 +31,11 @@ public:
 	void testGzip1();
 	void testGzip2();
 	void testGzip3();
+	void testParallelDeflate();
+	void testParallelGzip();
+	void testParallelSync();
+	void testParallelEmpty();
+	void testParallelPerformance();
 
 	void setUp();
 	void tearDown();
@@ -171,6 +171,9 @@ public:
 	Array& add(const Dynamic::Var& value);
 		/// Add the given value to the array
 
+	Array& add(Dynamic::Var&& value);
+		/// Moves the given value to the end of the array.
+
 	Array& set(unsigned int index, const Dynamic::Var& value);
 		/// Update the element on the given index to specified value
 
@@ -268,6 +271,14 @@ inline Array& Array::add(const Dynamic::Var& value)
 }
 
 
+inline Array& Array::add(Dynamic::Var&& value)
+{
+	_values.push_back(std::move(value));
+	_modified = true;
+	return *this;
+}
+
+
 inline Array& Array::set(unsigned int index, const Dynamic::Var& value)
 {
 	if (index >= _values.size()) _values.resize(index + 1);
@@ -0,0 +1,215 @@
+//
+// CBORWriter.h
+//
+// Library: JSON
+// Package: JSON
+// Module:  CBORWriter
+//
+// Definition of the CBORWriter class.
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef JSON_CBORWriter_INCLUDED
+#define JSON_CBORWriter_INCLUDED
+
+
+#include "Poco/JSON/JSON.h"
+#include "Poco/JSON/Handler.h"
+#include "Poco/Dynamic/Var.h"
+#include <ostream>
+#include <string>
+#include <vector>
+
+
+namespace Poco {
+namespace JSON {
+
+
+class Object;
+class Array;
+
+
+class JSON_API CBORWriter: public Handler
+	/// A streaming writer for CBOR (RFC 8949), the Concise Binary
+	/// Object Representation, with the same interface as Writer.
+	///
+	///     CBORWriter writer(response.send());
+	///     writer.startObject(2);
+	///     writer.key("name");
+	///     writer.value("Homer");
+	///     writer.key("children");
+	///     writer.startArray();
+	///     writer.value("Bart");
+	///     writer.value("Lisa");
+	///     writer.endArray();
+	///     writer.endObject();
+	///     writer.flush();
+	///
+	/// Objects and arrays started with a size are written with
+	/// a definite length, otherwise with an indefinite length.
+	/// Integers are written in the shortest encoding, and a double
+	/// is written in single precision when this does not change
+	/// its value. Several values written at the top level form
+	/// a CBOR sequence (RFC 8742).
+	///
+	/// Since CBORWriter is a Handler, it can be passed to a Parser,
+	/// PushParser, CBORParser or MessagePackParser to convert other
+	/// formats to CBOR without building the values in between.
+	///
+	/// Calls must be properly nested, and objects and arrays started
+	/// with a size must get exactly that number of members or elements,
+	/// otherwise a JSONException is thrown.
+	///
+	/// A CBORWriter is not thread-safe.
+{
+public:
+	typedef SharedPtr<CBORWriter> Ptr;
+
+	static const std::string MEDIA_TYPE;
+		/// The media type of CBOR, "application/cbor".
+
+	enum
+	{
+		DEFAULT_BUFFER_SIZE = 8192
+	};
+
+	explicit CBORWriter(std::ostream& out);
+		/// Creates a CBORWriter that writes to the given stream.
+
+	explicit CBORWriter(std::string& str);
+		/// Creates a CBORWriter that appends to the given string.
+
+	~CBORWriter();
+		/// Flushes the buffer and destroys the CBORWriter.
+
+	void reset();
+		/// Forgets all objects and arrays that have been started,
+		/// but not ended. Output already written is not affected.
+
+	void startObject();
+		/// Writes the start of an object with an indefinite length.
+
+	void startObject(std::size_t size);
+		/// Writes the start of an object with the given number of members.
+
+	void endObject();
+		/// Writes the end of the current object.
+
+	void startArray();
+		/// Writes the start of an array with an indefinite length.
+
+	void startArray(std::size_t size);
+		/// Writes the start of an array with the given number of elements.
+
+	void endArray();
+		/// Writes the end of the current array.
+
+	void key(const std::string& name);
+		/// Writes the name of the next member of the current object.
+
+	void key(const char* name, std::size_t length);
+		/// Writes the name of the next member of the current object.
+
+	void null();
+		/// Writes null.
+
+	void value(int v);
+		/// Writes an integer.
+
+	void value(unsigned v);
+		/// Writes an unsigned integer.
+
+#if defined(POCO_HAVE_INT64)
+	void value(Int64 v);
+		/// Writes a 64-bit integer.
+
+	void value(UInt64 v);
+		/// Writes an unsigned 64-bit integer.
+#endif
+
+	void value(const std::string& value);
+		/// Writes a text string.
+
+	void value(const char* value);
+		/// Writes a text string.
+
+	void value(const char* value, std::size_t length);
+		/// Writes a text string.
+
+	void value(double d);
+		/// Writes a floating-point number.
+
+	void value(float f);
+		/// Writes a single precision floating-point number.
+
+	void value(bool b);
+		/// Writes true or false.
+
+	void value(const Object& object);
+		/// Writes the given object with all its members.
+
+	void value(const Array& array);
+		/// Writes the given array with all its elements.
+
+	void value(const Dynamic::Var& value);
+		/// Writes the given value, which can hold an Object, an Array
+		/// (or pointers to them), a number, a string, or any other
+		/// type convertible to a string. An empty Var is written as null.
+
+	void binary(const void* data, std::size_t length);
+		/// Writes a byte string.
+
+	void flush();
+		/// Passes the buffered output to the stream.
+		/// For streams, the stream itself is not flushed.
+
+	int depth() const;
+		/// Returns the number of objects and arrays
+		/// that have been started, but not ended.
+
+private:
+	static const std::size_t UNKNOWN_SIZE = static_cast<std::size_t>(-1);
+
+	struct Frame
+	{
+		std::size_t size;
+		std::size_t count;
+		bool        object;
+		bool        afterKey;
+	};
+
+	CBORWriter(const CBORWriter&);
+	CBORWriter& operator = (const CBORWriter&);
+
+	void beforeValue();
+	void afterValue();
+	void start(bool object, std::size_t size);
+	void end(bool object);
+	void writeHead(unsigned char major, UInt64 argument);
+	void writeInteger(Int64 v);
+
+	std::ostream*      _pStream;
+	std::string        _buffer;
+	std::string*       _pOut;
+	std::vector<Frame> _stack;
+};
+
+
+//
+// inlines
+//
+inline int CBORWriter::depth() const
+{
+	return static_cast<int>(_stack.size());
+}
+
+
+} } // namespace Poco::JSON
+
+
+#endif // JSON_CBORWriter_INCLUDED
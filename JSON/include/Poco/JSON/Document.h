@@ -0,0 +1,595 @@
+//
+// Document.h
+//
+// Library: JSON
+// Package: JSON
+// Module:  Document
+//
+// Definition of the Document class.
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef JSON_Document_INCLUDED
+#define JSON_Document_INCLUDED
+
+
+#include "Poco/JSON/JSON.h"
+#include "Poco/JSON/Tape.h"
+#include "Poco/JSON/StringRef.h"
+#include "Poco/JSON/Object.h"
+#include "Poco/JSON/Array.h"
+#include "Poco/Dynamic/Var.h"
+#include <istream>
+#include <string>
+
+
+namespace Poco {
+namespace JSON {
+
+
+class JSON_API Document
+	/// A read-only view of a parsed JSON document.
+	///
+	/// Unlike Parser with a ParseHandler, which builds a tree of
+	/// Object and Array instances for the whole document, a Document
+	/// only keeps the JSON text and a compact Tape (see Tape) of it.
+	/// Values are accessed through lightweight Value handles, which
+	/// support lookup by name, index or path, iteration, and typed
+	/// getters that return strings as StringRef without copying them.
+	/// Object and Array instances are only created for the values
+	/// for which they are explicitly requested.
+	///
+	/// This makes a Document well suited for reading a few values
+	/// from a large document:
+	///
+	///     Document doc(json);
+	///     std::string name = doc.get("person.name").getString().toString();
+	///     Poco::Int64 age = doc.root()["person"]["age"].getInt64();
+	///
+	/// A Document can also be searched with a Query.
+	///
+	/// Values, iterators and StringRefs obtained from a Document are
+	/// invalidated when the Document is destroyed or another document
+	/// is parsed into it.
+	///
+	/// When many small documents are parsed, their tapes can be
+	/// allocated from an Arena that is reset once the documents
+	/// are no longer needed:
+	///
+	///     Poco::Arena arena;
+	///     for (const auto& json: messages)
+	///     {
+	///         Document doc(arena);
+	///         doc.parse(json.data(), json.size());
+	///         ...
+	///     }
+	///     arena.reset();
+{
+public:
+	class Iterator;
+
+	class JSON_API Value
+		/// A handle to a value in a Document.
+		///
+		/// A default-constructed Value, as well as the result of
+		/// looking up a member or element that does not exist,
+		/// is not valid. Looking up members or elements of an
+		/// invalid Value yields another invalid Value, so that
+		/// lookups can be chained and checked once at the end.
+	{
+	public:
+		Value();
+			/// Creates an invalid Value.
+
+		bool isValid() const;
+			/// Returns true if the Value refers to a value in a Document.
+
+		Tape::Type type() const;
+			/// Returns the type of the value. The Value must be valid.
+
+		bool isNull() const;
+			/// Returns true if the value is null.
+
+		bool isBoolean() const;
+			/// Returns true if the value is true or false.
+
+		bool isNumber() const;
+			/// Returns true if the value is a number.
+
+		bool isInteger() const;
+			/// Returns true if the value is a number without
+			/// fraction or exponent.
+
+		bool isString() const;
+			/// Returns true if the value is a string.
+
+		bool isObject() const;
+			/// Returns true if the value is an object.
+
+		bool isArray() const;
+			/// Returns true if the value is an array.
+
+		bool getBool() const;
+			/// Returns the value of a boolean.
+			///
+			/// Throws a BadCastException if the value is not a boolean.
+
+		Int64 getInt64() const;
+			/// Returns the value of an integer.
+			///
+			/// Throws a BadCastException if the value is not an integer,
+			/// or a RangeException if it does not fit into an Int64.
+
+		UInt64 getUInt64() const;
+			/// Returns the value of a non-negative integer.
+			///
+			/// Throws a BadCastException if the value is not an integer,
+			/// or a RangeException if it is negative.
+
+		double getDouble() const;
+			/// Returns the value of a number, converted to double.
+			///
+			/// Throws a BadCastException if the value is not a number.
+
+		StringRef getString() const;
+			/// Returns the characters of a string, without copying them.
+			///
+			/// Throws a BadCastException if the value is not a string.
+
+		std::size_t size() const;
+			/// Returns the number of members of an object or the number
+			/// of elements of an array, or 0 for all other values.
+			///
+			/// Objects and arrays do not store their sizes, so this takes
+			/// time proportional to the number of members or elements.
+
+		bool has(const StringRef& name) const;
+			/// Returns true if the value is an object with
+			/// a member of the given name.
+
+		Value get(const StringRef& name) const;
+			/// Returns the member of an object with the given name.
+			///
+			/// Returns an invalid Value if the value is not an object,
+			/// or has no such member. If the object has several members
+			/// of the same name, the first one is returned.
+
+		Value get(std::size_t index) const;
+			/// Returns the element of an array with the given index.
+			///
+			/// Returns an invalid Value if the value is not an array,
+			/// or the index is out of range.
+
+		Value find(const std::string& path) const;
+			/// Searches for a value, using the same path syntax
+			/// as Query, for example "person.children[0].name".
+			///
+			/// Returns an invalid Value if no value can be found.
+
+		Value operator [] (const StringRef& name) const;
+			/// Same as get(name).
+
+		Value operator [] (const char* name) const;
+			/// Same as get(name).
+
+		Value operator [] (const std::string& name) const;
+			/// Same as get(name).
+
+		Value operator [] (std::size_t index) const;
+			/// Same as get(index).
+
+		Value operator [] (int index) const;
+			/// Same as get(index).
+
+		Iterator begin() const;
+			/// Returns an iterator to the first member of an object
+			/// or the first element of an array.
+			///
+			/// For all other values, begin() == end().
+
+		Iterator end() const;
+			/// Returns the end iterator of an object or array.
+
+		Dynamic::Var asVar() const;
+			/// Converts the value into a Dynamic::Var, creating Object and
+			/// Array instances for objects and arrays, as a Parser with
+			/// a ParseHandler would. Null and invalid values are returned
+			/// as empty Var.
+
+		Object::Ptr asObject() const;
+			/// Creates an Object from the value.
+			///
+			/// Throws a BadCastException if the value is not an object.
+
+		Array::Ptr asArray() const;
+			/// Creates an Array from the value.
+			///
+			/// Throws a BadCastException if the value is not an array.
+
+		const Document* document() const;
+			/// Returns the Document the value belongs to,
+			/// or null if the Value is not valid.
+
+	private:
+		Value(const Document* pDoc, std::size_t pos);
+
+		void checkType(bool ok, const char* type) const;
+
+		const Document* _pDoc;
+		std::size_t     _pos;
+
+		friend class Document;
+		friend class Iterator;
+	};
+
+	class JSON_API Iterator
+		/// An iterator over the members of an object or
+		/// the elements of an array in a Document.
+	{
+	public:
+		Iterator();
+			/// Creates a singular Iterator.
+
+		Value operator * () const;
+			/// Returns the current member value or element.
+
+		Value value() const;
+			/// Returns the current member value or element.
+
+		StringRef key() const;
+			/// Returns the name of the current member.
+			/// Must only be called when iterating over an object.
+
+		Iterator& operator ++ ();
+			/// Moves to the next member or element.
+
+		Iterator operator ++ (int);
+			/// Moves to the next member or element.
+
+		bool operator == (const Iterator& other) const;
+		bool operator != (const Iterator& other) const;
+
+	private:
+		Iterator(const Document* pDoc, std::size_t pos, bool object);
+
+		const Document* _pDoc;
+		std::size_t     _pos;
+		bool            _object;
+
+		friend class Value;
+	};
+
+	Document();
+		/// Creates an empty Document.
+
+	explicit Document(const std::string& json);
+		/// Creates a Document and parses the given JSON text into it.
+
+	explicit Document(Arena& arena);
+		/// Creates an empty Document whose Tape is allocated from
+		/// the given Arena, which must outlive the Document.
+		/// JSON text copied by parse() is still kept on the heap.
+
+	~Document();
+		/// Destroys the Document.
+
+	void parse(const std::string& json);
+		/// Parses the given JSON text. The Document keeps a copy of it.
+		///
+		/// Throws a JSONException if the text is not valid JSON.
+
+	void parse(std::string&& json);
+		/// Parses the given JSON text. The Document takes over the
+		/// string, so that the text is not copied.
+		///
+		/// Throws a JSONException if the text is not valid JSON.
+
+	void parse(std::istream& in);
+		/// Reads JSON text from the given stream and parses it.
+
+	void parse(const char* json, std::size_t length);
+		/// Parses the given JSON text, without copying it. The text must
+		/// remain valid and unchanged as long as the Document, or any
+		/// Value, Iterator or StringRef obtained from it, is used.
+		///
+		/// Throws a JSONException if the text is not valid JSON.
+
+	void clear();
+		/// Clears the Document.
+
+	bool empty() const;
+		/// Returns true if the Document is empty.
+
+	Value root() const;
+		/// Returns the root value of the Document, or an
+		/// invalid Value if the Document is empty.
+
+	Value find(const std::string& path) const;
+		/// Searches for a value, starting at the root value.
+		/// See Value::find().
+
+	Value operator [] (const std::string& name) const;
+		/// Returns the given member of the root object.
+
+	Value operator [] (std::size_t index) const;
+		/// Returns the given element of the root array.
+
+	Dynamic::Var asVar() const;
+		/// Converts the whole Document into a Dynamic::Var.
+		/// See Value::asVar().
+
+	void setAllowNullByte(bool nullByte);
+		/// Allow or disallow null byte in strings.
+		///
+		/// By default, null byte is allowed.
+
+	bool getAllowNullByte() const;
+		/// Returns true if null byte is allowed, false otherwise.
+
+	void setDepth(int depth);
+		/// Sets the maximum nesting depth of objects and arrays,
+		/// or -1 for unlimited depth, which is the default.
+
+	int getDepth() const;
+		/// Returns the maximum nesting depth.
+
+	void setPreserveObjectOrder(bool preserve);
+		/// Determines whether objects created by asVar() and asObject()
+		/// preserve the order of their members. The default is false.
+
+	bool getPreserveObjectOrder() const;
+		/// Returns true if created objects preserve the order of
+		/// their members, false otherwise.
+
+	const Tape& tape() const;
+		/// Returns the Tape of the Document.
+
+private:
+	Document(const Document&);
+	Document& operator = (const Document&);
+
+	void parseImpl();
+
+	std::string _json;
+	Tape        _tape;
+	bool        _preserveObjectOrder;
+};
+
+
+//
+// inlines
+//
+inline bool Document::Value::isValid() const
+{
+	return _pDoc != 0;
+}
+
+
+inline Tape::Type Document::Value::type() const
+{
+	poco_assert_dbg (_pDoc);
+
+	return _pDoc->_tape.type(_pos);
+}
+
+
+inline bool Document::Value::isNull() const
+{
+	return _pDoc && type() == Tape::TYPE_NULL;
+}
+
+
+inline bool Document::Value::isBoolean() const
+{
+	return _pDoc && (type() == Tape::TYPE_TRUE || type() == Tape::TYPE_FALSE);
+}
+
+
+inline bool Document::Value::isNumber() const
+{
+	return _pDoc && (type() == Tape::TYPE_INT64 || type() == Tape::TYPE_UINT64 || type() == Tape::TYPE_DOUBLE);
+}
+
+
+inline bool Document::Value::isInteger() const
+{
+	return _pDoc && (type() == Tape::TYPE_INT64 || type() == Tape::TYPE_UINT64);
+}
+
+
+inline bool Document::Value::isString() const
+{
+	return _pDoc && type() == Tape::TYPE_STRING;
+}
+
+
+inline bool Document::Value::isObject() const
+{
+	return _pDoc && type() == Tape::TYPE_OBJECT;
+}
+
+
+inline bool Document::Value::isArray() const
+{
+	return _pDoc && type() == Tape::TYPE_ARRAY;
+}
+
+
+inline bool Document::Value::has(const StringRef& name) const
+{
+	return get(name).isValid();
+}
+
+
+inline Document::Value Document::Value::operator [] (const StringRef& name) const
+{
+	return get(name);
+}
+
+
+inline Document::Value Document::Value::operator [] (const char* name) const
+{
+	return get(StringRef(name));
+}
+
+
+inline Document::Value Document::Value::operator [] (const std::string& name) const
+{
+	return get(StringRef(name));
+}
+
+
+inline Document::Value Document::Value::operator [] (std::size_t index) const
+{
+	return get(index);
+}
+
+
+inline Document::Value Document::Value::operator [] (int index) const
+{
+	return index < 0 ? Value() : get(static_cast<std::size_t>(index));
+}
+
+
+inline const Document* Document::Value::document() const
+{
+	return _pDoc;
+}
+
+
+inline Document::Value Document::Iterator::operator * () const
+{
+	return value();
+}
+
+
+inline Document::Value Document::Iterator::value() const
+{
+	return Value(_pDoc, _object ? _pos + 2 : _pos);
+}
+
+
+inline StringRef Document::Iterator::key() const
+{
+	poco_assert_dbg (_object);
+
+	std::size_t length;
+	const char* p = _pDoc->_tape.getString(_pos, length);
+	return StringRef(p, length);
+}
+
+
+inline Document::Iterator& Document::Iterator::operator ++ ()
+{
+	_pos = _pDoc->_tape.next(_object ? _pos + 2 : _pos);
+	return *this;
+}
+
+
+inline Document::Iterator Document::Iterator::operator ++ (int)
+{
+	Iterator it(*this);
+	++*this;
+	return it;
+}
+
+
+inline bool Document::Iterator::operator == (const Iterator& other) const
+{
+	return _pDoc == other._pDoc && _pos == other._pos;
+}
+
+
+inline bool Document::Iterator::operator != (const Iterator& other) const
+{
+	return !(*this == other);
+}
+
+
+inline bool Document::empty() const
+{
+	return _tape.empty();
+}
+
+
+inline Document::Value Document::root() const
+{
+	return _tape.empty() ? Value() : Value(this, 0);
+}
+
+
+inline Document::Value Document::find(const std::string& path) const
+{
+	return root().find(path);
+}
+
+
+inline Document::Value Document::operator [] (const std::string& name) const
+{
+	return root().get(StringRef(name));
+}
+
+
+inline Document::Value Document::operator [] (std::size_t index) const
+{
+	return root().get(index);
+}
+
+
+inline Dynamic::Var Document::asVar() const
+{
+	return root().asVar();
+}
+
+
+inline void Document::setAllowNullByte(bool nullByte)
+{
+	_tape.setAllowNullByte(nullByte);
+}
+
+
+inline bool Document::getAllowNullByte() const
+{
+	return _tape.getAllowNullByte();
+}
+
+
+inline void Document::setDepth(int depth)
+{
+	_tape.setDepth(depth);
+}
+
+
+inline int Document::getDepth() const
+{
+	return _tape.getDepth();
+}
+
+
+inline void Document::setPreserveObjectOrder(bool preserve)
+{
+	_preserveObjectOrder = preserve;
+}
+
+
+inline bool Document::getPreserveObjectOrder() const
+{
+	return _preserveObjectOrder;
+}
+
+
+inline const Tape& Document::tape() const
+{
+	return _tape;
+}
+
+
+} } // namespace Poco::JSON
+
+
+#endif // JSON_Document_INCLUDED
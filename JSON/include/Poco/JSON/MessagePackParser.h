@@ -0,0 +1,203 @@
+//
+// MessagePackParser.h
+//
+// Library: JSON
+// Package: JSON
+// Module:  MessagePackParser
+//
+// Definition of the MessagePackParser class.
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef JSON_MessagePackParser_INCLUDED
+#define JSON_MessagePackParser_INCLUDED
+
+
+#include "Poco/JSON/JSON.h"
+#include "Poco/JSON/Handler.h"
+#include "Poco/JSON/ParseHandler.h"
+#include "Poco/Dynamic/Var.h"
+#include <istream>
+#include <string>
+#include <vector>
+
+
+namespace Poco {
+namespace JSON {
+
+
+class JSON_API MessagePackParser
+	/// A parser for MessagePack that reports the decoded values
+	/// to a Handler, like Parser does for JSON text.
+	///
+	///     MessagePackParser parser;
+	///     Var result = parser.parse(request.stream());
+	///     Object::Ptr object = result.extract<Object::Ptr>();
+	///
+	/// Maps become objects, with integer keys converted to strings,
+	/// and arrays become arrays. Strings and binary data both become
+	/// strings, integers are reported with the smallest of int,
+	/// unsigned, Int64 and UInt64 that holds them, and floating-point
+	/// numbers as double. Extension types are not supported.
+	///
+	/// The values are decoded without recursion, so the depth of
+	/// the input is only limited by setDepth().
+	///
+	/// A value that is not inside an object or array is returned
+	/// by parse() and asVar(), but not reported to the Handler,
+	/// since ParseHandler only accepts objects and arrays at the
+	/// top level.
+	///
+	/// When parsing from a stream, exactly one value is read, so that
+	/// a stream of values can be parsed by calling parse() repeatedly.
+	/// When parsing from memory, the value must span the whole input.
+{
+public:
+	static const int JSON_UNLIMITED_DEPTH = -1;
+
+	MessagePackParser(const Handler::Ptr& pHandler = new ParseHandler);
+		/// Creates a MessagePackParser that reports values to the given Handler.
+
+	~MessagePackParser();
+		/// Destroys the MessagePackParser.
+
+	void reset();
+		/// Resets the parser and the Handler.
+
+	void setDepth(int depth);
+		/// Sets the maximum nesting depth of objects and arrays,
+		/// or JSON_UNLIMITED_DEPTH, which is the default.
+
+	int getDepth() const;
+		/// Returns the maximum nesting depth.
+
+	void setHandler(const Handler::Ptr& pHandler);
+		/// Sets the Handler.
+
+	const Handler::Ptr& getHandler();
+		/// Returns the Handler.
+
+	Dynamic::Var parse(const std::string& data);
+		/// Parses a single value from data, and returns the result
+		/// of the Handler, or the value if it is not an object or array.
+		///
+		/// Throws a JSONException if the data is not valid MessagePack,
+		/// or if there is data after the value.
+
+	Dynamic::Var parse(const char* data, std::size_t length);
+		/// Parses a single value from the given buffer, and returns
+		/// the result of the Handler, or the value if it is not an
+		/// object or array.
+
+	Dynamic::Var parse(std::istream& in);
+		/// Reads a single value from the stream, and returns the result
+		/// of the Handler, or the value if it is not an object or array.
+		/// No data after the value is read.
+
+	Dynamic::Var asVar() const;
+		/// Returns the result of the Handler, or the value
+		/// if it is not an object or array.
+
+	Dynamic::Var result() const;
+		/// Returns the result of the Handler, or the value
+		/// if it is not an object or array.
+
+private:
+	struct Frame
+	{
+		UInt32 remaining;
+		bool   object;
+		bool   expectKey;
+	};
+
+	MessagePackParser(const MessagePackParser&);
+	MessagePackParser& operator = (const MessagePackParser&);
+
+	void parseValue();
+	void parseItem(unsigned char type);
+	void parseKey(unsigned char type);
+	void startContainer(bool object, UInt32 size);
+	void endContainer();
+	template <typename T>
+	void report(const T& value);
+	void reportNull();
+	void reportUnsigned(UInt64 v);
+	void reportSigned(Int64 v);
+	UInt64 readUnsigned(std::size_t bytes);
+	Int64 readSigned(std::size_t bytes);
+	unsigned char readByte();
+	void read(char* buffer, std::size_t length);
+	void read(std::string& str, UInt64 length);
+	unsigned char underflow();
+
+	Handler::Ptr        _pHandler;
+	int                 _depth;
+	std::vector<Frame>  _stack;
+	std::string         _string;
+	Dynamic::Var        _value;
+	bool                _scalar;
+	const char*         _pPos;
+	const char*         _pEnd;
+	std::streambuf*     _pStreamBuf;
+};
+
+
+//
+// inlines
+//
+inline void MessagePackParser::setDepth(int depth)
+{
+	_depth = depth;
+}
+
+
+inline int MessagePackParser::getDepth() const
+{
+	return _depth;
+}
+
+
+inline void MessagePackParser::setHandler(const Handler::Ptr& pHandler)
+{
+	_pHandler = pHandler;
+}
+
+
+inline const Handler::Ptr& MessagePackParser::getHandler()
+{
+	return _pHandler;
+}
+
+
+inline Dynamic::Var MessagePackParser::asVar() const
+{
+	if (_scalar) return _value;
+	if (_pHandler) return _pHandler->asVar();
+
+	return Dynamic::Var();
+}
+
+
+inline Dynamic::Var MessagePackParser::result() const
+{
+	return asVar();
+}
+
+
+inline unsigned char MessagePackParser::readByte()
+{
+	if (_pPos < _pEnd) return static_cast<unsigned char>(*_pPos++);
+
+	return underflow();
+}
+
+
+} } // namespace Poco::JSON
+
+
+#endif // JSON_MessagePackParser_INCLUDED
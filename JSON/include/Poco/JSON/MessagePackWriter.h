@@ -0,0 +1,229 @@
+//
+// MessagePackWriter.h
+//
+// Library: JSON
+// Package: JSON
+// Module:  MessagePackWriter
+//
+// Definition of the MessagePackWriter class.
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef JSON_MessagePackWriter_INCLUDED
+#define JSON_MessagePackWriter_INCLUDED
+
+
+#include "Poco/JSON/JSON.h"
+#include "Poco/JSON/Handler.h"
+#include "Poco/Dynamic/Var.h"
+#include <ostream>
+#include <string>
+#include <vector>
+
+
+namespace Poco {
+namespace JSON {
+
+
+class Object;
+class Array;
+
+
+class JSON_API MessagePackWriter: public Handler
+	/// A streaming writer for MessagePack, with the same
+	/// interface as Writer.
+	///
+	///     MessagePackWriter writer(response.send());
+	///     writer.startObject(2);
+	///     writer.key("name");
+	///     writer.value("Homer");
+	///     writer.key("children");
+	///     writer.startArray(2);
+	///     writer.value("Bart");
+	///     writer.value("Lisa");
+	///     writer.endArray();
+	///     writer.endObject();
+	///     writer.flush();
+	///
+	/// Integers, strings and the headers of objects and arrays are
+	/// written in the shortest encoding, and a double is written in
+	/// single precision when this does not change its value.
+	///
+	/// MessagePack has no encoding for objects and arrays of unknown
+	/// length. If they are started without a size, a 32-bit size is
+	/// written, which is filled in when they are ended. The output is
+	/// kept in the buffer until then, so give the size whenever it is
+	/// known in advance.
+	///
+	/// Since MessagePackWriter is a Handler, it can be passed to a Parser,
+	/// PushParser, CBORParser or MessagePackParser to convert other
+	/// formats to MessagePack without building the values in between.
+	///
+	/// Calls must be properly nested, and objects and arrays started
+	/// with a size must get exactly that number of members or elements,
+	/// otherwise a JSONException is thrown.
+	///
+	/// A MessagePackWriter is not thread-safe.
+{
+public:
+	typedef SharedPtr<MessagePackWriter> Ptr;
+
+	static const std::string MEDIA_TYPE;
+		/// The media type of MessagePack, "application/msgpack".
+
+	enum
+	{
+		DEFAULT_BUFFER_SIZE = 8192
+	};
+
+	explicit MessagePackWriter(std::ostream& out);
+		/// Creates a MessagePackWriter that writes to the given stream.
+
+	explicit MessagePackWriter(std::string& str);
+		/// Creates a MessagePackWriter that appends to the given string.
+
+	~MessagePackWriter();
+		/// Flushes the buffer and destroys the MessagePackWriter.
+
+	void reset();
+		/// Forgets all objects and arrays that have been started,
+		/// but not ended. Output already written is not affected.
+
+	void startObject();
+		/// Writes the start of an object with a size that is
+		/// filled in when the object is ended.
+
+	void startObject(std::size_t size);
+		/// Writes the start of an object with the given number of members.
+
+	void endObject();
+		/// Writes the end of the current object.
+
+	void startArray();
+		/// Writes the start of an array with a size that is
+		/// filled in when the array is ended.
+
+	void startArray(std::size_t size);
+		/// Writes the start of an array with the given number of elements.
+
+	void endArray();
+		/// Writes the end of the current array.
+
+	void key(const std::string& name);
+		/// Writes the name of the next member of the current object.
+
+	void key(const char* name, std::size_t length);
+		/// Writes the name of the next member of the current object.
+
+	void null();
+		/// Writes null.
+
+	void value(int v);
+		/// Writes an integer.
+
+	void value(unsigned v);
+		/// Writes an unsigned integer.
+
+#if defined(POCO_HAVE_INT64)
+	void value(Int64 v);
+		/// Writes a 64-bit integer.
+
+	void value(UInt64 v);
+		/// Writes an unsigned 64-bit integer.
+#endif
+
+	void value(const std::string& value);
+		/// Writes a string.
+
+	void value(const char* value);
+		/// Writes a string.
+
+	void value(const char* value, std::size_t length);
+		/// Writes a string.
+
+	void value(double d);
+		/// Writes a floating-point number.
+
+	void value(float f);
+		/// Writes a single precision floating-point number.
+
+	void value(bool b);
+		/// Writes true or false.
+
+	void value(const Object& object);
+		/// Writes the given object with all its members.
+
+	void value(const Array& array);
+		/// Writes the given array with all its elements.
+
+	void value(const Dynamic::Var& value);
+		/// Writes the given value, which can hold an Object, an Array
+		/// (or pointers to them), a number, a string, or any other
+		/// type convertible to a string. An empty Var is written as null.
+
+	void binary(const void* data, std::size_t length);
+		/// Writes binary data.
+
+	void flush();
+		/// Passes the buffered output to the stream.
+		/// For streams, the stream itself is not flushed.
+		///
+		/// Throws a JSONException if an object or array started
+		/// without a size has not been ended.
+
+	int depth() const;
+		/// Returns the number of objects and arrays
+		/// that have been started, but not ended.
+
+private:
+	static const std::size_t UNKNOWN_SIZE = static_cast<std::size_t>(-1);
+
+	struct Frame
+	{
+		std::size_t size;
+		std::size_t count;
+		std::size_t header;
+		bool        object;
+		bool        afterKey;
+	};
+
+	MessagePackWriter(const MessagePackWriter&);
+	MessagePackWriter& operator = (const MessagePackWriter&);
+
+	void beforeValue();
+	void afterValue();
+	void start(bool object, std::size_t size);
+	void end(bool object);
+	void writeUnsigned(UInt64 v);
+	void writeInteger(Int64 v);
+	void writeSize(char type8, char type16, char type32, std::size_t size);
+	void writeFixed(char type, UInt16 v);
+	void writeFixed(char type, UInt32 v);
+	void writeFixed(char type, UInt64 v);
+
+	std::ostream*      _pStream;
+	std::string        _buffer;
+	std::string*       _pOut;
+	std::vector<Frame> _stack;
+	int                _unsized;
+};
+
+
+//
+// inlines
+//
+inline int MessagePackWriter::depth() const
+{
+	return static_cast<int>(_stack.size());
+}
+
+
+} } // namespace Poco::JSON
+
+
+#endif // JSON_MessagePackWriter_INCLUDED
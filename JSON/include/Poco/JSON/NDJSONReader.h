@@ -0,0 +1,167 @@
+//
+// NDJSONReader.h
+//
+// Library: JSON
+// Package: JSON
+// Module:  NDJSONReader
+//
+// Definition of the NDJSONReader class.
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef JSON_NDJSONReader_INCLUDED
+#define JSON_NDJSONReader_INCLUDED
+
+
+#include "Poco/JSON/JSON.h"
+#include "Poco/Dynamic/Var.h"
+#include "Poco/ThreadPool.h"
+#include <istream>
+#include <vector>
+#include <string>
+
+
+namespace Poco {
+namespace JSON {
+
+
+class JSON_API NDJSONReader
+	/// A reader for newline-delimited JSON (JSON Lines, NDJSON)
+	/// streams, which contain one JSON value per line.
+	///
+	/// Lines are read in batches. The records of a batch are parsed
+	/// in parallel on the threads of a ThreadPool, and then returned
+	/// one by one, in input order, by read():
+	///
+	///     std::ifstream istr("import.ndjson");
+	///     NDJSONReader reader(istr);
+	///     Var record;
+	///     while (reader.read(record))
+	///     {
+	///         Object::Ptr pObject = record.extract<Object::Ptr>();
+	///         ...
+	///     }
+	///
+	/// Empty lines are skipped, and a carriage return before the
+	/// newline is ignored. A record may be any JSON value.
+	///
+	/// If there are not enough threads available in the pool,
+	/// the remaining records are parsed by the calling thread.
+{
+public:
+	enum
+	{
+		DEFAULT_BATCH_SIZE = 512
+			/// Default number of records per batch.
+	};
+
+	explicit NDJSONReader(std::istream& in);
+		/// Creates a NDJSONReader for the given stream, using
+		/// the default ThreadPool.
+
+	NDJSONReader(std::istream& in, ThreadPool& pool);
+		/// Creates a NDJSONReader for the given stream, using
+		/// the given ThreadPool.
+
+	~NDJSONReader();
+		/// Destroys the NDJSONReader.
+
+	bool read(Dynamic::Var& record);
+		/// Reads the next record. Returns false if there are no
+		/// more records.
+		///
+		/// Throws a JSONException, giving the line number, if the
+		/// record is not valid JSON. The invalid record is skipped,
+		/// so reading can continue with the next one.
+
+	std::size_t lineNumber() const;
+		/// Returns the line number of the record
+		/// last returned by read().
+
+	void setBatchSize(std::size_t batchSize);
+		/// Sets the number of records read and parsed at a time.
+
+	std::size_t getBatchSize() const;
+		/// Returns the number of records read and parsed at a time.
+
+	void setPreserveObjectOrder(bool preserve);
+		/// Enables or disables preserving the order of object members.
+
+	bool getPreserveObjectOrder() const;
+		/// Returns true if the order of object members is preserved.
+
+private:
+	NDJSONReader(const NDJSONReader&);
+	NDJSONReader& operator = (const NDJSONReader&);
+
+	struct Record
+	{
+		std::string  text;
+		Dynamic::Var value;
+		std::string  error;
+		std::size_t  line;
+	};
+
+	typedef std::vector<Record> RecordVec;
+
+	class ParseTask;
+
+	bool readBatch();
+	void parseBatch();
+
+	std::istream& _istr;
+	ThreadPool&   _pool;
+	RecordVec     _records;
+	std::size_t   _count;
+	std::size_t   _pos;
+	std::size_t   _line;
+	std::size_t   _currentLine;
+	std::size_t   _batchSize;
+	bool          _preserveObjectOrder;
+};
+
+
+//
+// inlines
+//
+inline std::size_t NDJSONReader::lineNumber() const
+{
+	return _currentLine;
+}
+
+
+inline void NDJSONReader::setBatchSize(std::size_t batchSize)
+{
+	poco_assert (batchSize > 0);
+
+	_batchSize = batchSize;
+}
+
+
+inline std::size_t NDJSONReader::getBatchSize() const
+{
+	return _batchSize;
+}
+
+
+inline void NDJSONReader::setPreserveObjectOrder(bool preserve)
+{
+	_preserveObjectOrder = preserve;
+}
+
+
+inline bool NDJSONReader::getPreserveObjectOrder() const
+{
+	return _preserveObjectOrder;
+}
+
+
+} } // namespace Poco::JSON
+
+
+#endif // JSON_NDJSONReader_INCLUDED
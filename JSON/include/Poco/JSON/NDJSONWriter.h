@@ -0,0 +1,118 @@
+//
+// NDJSONWriter.h
+//
+// Library: JSON
+// Package: JSON
+// Module:  NDJSONWriter
+//
+// Definition of the NDJSONWriter class.
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef JSON_NDJSONWriter_INCLUDED
+#define JSON_NDJSONWriter_INCLUDED
+
+
+#include "Poco/JSON/JSON.h"
+#include "Poco/JSON/Writer.h"
+#include "Poco/Dynamic/Var.h"
+#include <ostream>
+#include <string>
+
+
+namespace Poco {
+namespace JSON {
+
+
+class JSON_API NDJSONWriter
+	/// A writer for newline-delimited JSON (JSON Lines, NDJSON)
+	/// streams, which contain one JSON value per line.
+	///
+	/// Records are collected in batches, and each batch is written
+	/// to the stream at once. The stream therefore only ever receives
+	/// complete records, which is important if the stream is shared
+	/// with other writers, or read concurrently, as with log files.
+	///
+	/// Records can either be given as Dynamic::Var, or be written with
+	/// the Writer returned by writer(), followed by a call to endRecord():
+	///
+	///     NDJSONWriter ndjson(ostr);
+	///     ndjson.writer().startObject();
+	///     ndjson.writer().key("level");
+	///     ndjson.writer().value("info");
+	///     ndjson.writer().endObject();
+	///     ndjson.endRecord();
+	///     ndjson.write(pObject);
+	///     ndjson.flush();
+{
+public:
+	enum
+	{
+		DEFAULT_BATCH_SIZE = 256
+			/// Default number of records per batch.
+	};
+
+	NDJSONWriter(std::ostream& out, int options = 0, std::size_t batchSize = DEFAULT_BATCH_SIZE);
+		/// Creates a NDJSONWriter for the given stream.
+		///
+		/// If options contains JSON_ESCAPE_UNICODE, all non-ASCII
+		/// characters are escaped.
+
+	~NDJSONWriter();
+		/// Writes any pending records and destroys the NDJSONWriter.
+
+	void write(const Dynamic::Var& record);
+		/// Writes a record.
+
+	Writer& writer();
+		/// Returns the Writer for writing the next record.
+
+	void endRecord();
+		/// Ends a record written with writer().
+
+	void flush();
+		/// Writes all pending records to the stream,
+		/// and flushes the stream.
+
+	std::size_t count() const;
+		/// Returns the number of records written so far.
+
+private:
+	NDJSONWriter(const NDJSONWriter&);
+	NDJSONWriter& operator = (const NDJSONWriter&);
+
+	void writeBatch();
+
+	std::ostream& _ostr;
+	std::string   _batch;
+	Writer        _writer;
+	std::size_t   _batchSize;
+	std::size_t   _pending;
+	std::size_t   _count;
+};
+
+
+//
+// inlines
+//
+inline Writer& NDJSONWriter::writer()
+{
+	return _writer;
+}
+
+
+inline std::size_t NDJSONWriter::count() const
+{
+	return _count;
+}
+
+
+} } // namespace Poco::JSON
+
+
+#endif // JSON_NDJSONWriter_INCLUDED
@@ -29,6 +29,8 @@
 #include <map>
 #include <vector>
 #include <deque>
+#include <iterator>
+#include <cstddef>
 #include <iostream>
 #include <sstream>
 
@@ -58,15 +60,179 @@ class JSON_API Object
 	///    Poco::DynamicStruct ds = *object;
 	///    val = ds["test"]["property"]; // val holds "value"
 	///
+	/// By default, properties are stored in a std::map, which allocates
+	/// a node for every property. If JSON_FLAT_STORAGE is specified,
+	/// properties are stored in insertion order in a single array instead,
+	/// and small objects are searched linearly. Objects with more than
+	/// a few properties additionally get a compact hash index. This saves
+	/// memory and allocations for the many small objects typically found
+	/// in JSON documents. See ParseHandler for how to have the Parser
+	/// create such objects.
 {
 public:
 	typedef SharedPtr<Object>                   Ptr;
 	typedef std::map<std::string, Dynamic::Var> ValueMap;
 	typedef ValueMap::value_type                ValueType;
-	typedef ValueMap::iterator                  Iterator;
-	typedef ValueMap::const_iterator            ConstIterator;
 	typedef std::vector<std::string>            NameList;
 
+	class ConstIterator;
+
+	class Iterator
+		/// Iterates over the properties of an Object,
+		/// regardless of its storage.
+	{
+	public:
+		typedef std::bidirectional_iterator_tag iterator_category;
+		typedef ValueType                       value_type;
+		typedef std::ptrdiff_t                  difference_type;
+		typedef ValueType*                      pointer;
+		typedef ValueType&                      reference;
+
+		Iterator(): _pFlat(0), _flat(false)
+		{
+		}
+
+		Iterator(ValueMap::iterator it): _it(it), _pFlat(0), _flat(false)
+		{
+		}
+
+		Iterator(ValueType* pFlat): _pFlat(pFlat), _flat(true)
+		{
+		}
+
+		ValueType& operator * () const
+		{
+			return _flat ? *_pFlat : *_it;
+		}
+
+		ValueType* operator -> () const
+		{
+			return _flat ? _pFlat : &*_it;
+		}
+
+		Iterator& operator ++ ()
+		{
+			if (_flat) ++_pFlat; else ++_it;
+			return *this;
+		}
+
+		Iterator operator ++ (int)
+		{
+			Iterator tmp(*this);
+			++*this;
+			return tmp;
+		}
+
+		Iterator& operator -- ()
+		{
+			if (_flat) --_pFlat; else --_it;
+			return *this;
+		}
+
+		Iterator operator -- (int)
+		{
+			Iterator tmp(*this);
+			--*this;
+			return tmp;
+		}
+
+		bool operator == (const Iterator& other) const
+		{
+			return _flat ? _pFlat == other._pFlat : _it == other._it;
+		}
+
+		bool operator != (const Iterator& other) const
+		{
+			return !(*this == other);
+		}
+
+	private:
+		ValueMap::iterator _it;
+		ValueType*         _pFlat;
+		bool               _flat;
+
+		friend class ConstIterator;
+	};
+
+	class ConstIterator
+		/// Iterates over the properties of a const Object,
+		/// regardless of its storage.
+	{
+	public:
+		typedef std::bidirectional_iterator_tag iterator_category;
+		typedef ValueType                       value_type;
+		typedef std::ptrdiff_t                  difference_type;
+		typedef const ValueType*                pointer;
+		typedef const ValueType&                reference;
+
+		ConstIterator(): _pFlat(0), _flat(false)
+		{
+		}
+
+		ConstIterator(ValueMap::const_iterator it): _it(it), _pFlat(0), _flat(false)
+		{
+		}
+
+		ConstIterator(const ValueType* pFlat): _pFlat(pFlat), _flat(true)
+		{
+		}
+
+		ConstIterator(const Iterator& it): _it(it._it), _pFlat(it._pFlat), _flat(it._flat)
+		{
+		}
+
+		const ValueType& operator * () const
+		{
+			return _flat ? *_pFlat : *_it;
+		}
+
+		const ValueType* operator -> () const
+		{
+			return _flat ? _pFlat : &*_it;
+		}
+
+		ConstIterator& operator ++ ()
+		{
+			if (_flat) ++_pFlat; else ++_it;
+			return *this;
+		}
+
+		ConstIterator operator ++ (int)
+		{
+			ConstIterator tmp(*this);
+			++*this;
+			return tmp;
+		}
+
+		ConstIterator& operator -- ()
+		{
+			if (_flat) --_pFlat; else --_it;
+			return *this;
+		}
+
+		ConstIterator operator -- (int)
+		{
+			ConstIterator tmp(*this);
+			--*this;
+			return tmp;
+		}
+
+		bool operator == (const ConstIterator& other) const
+		{
+			return _flat ? _pFlat == other._pFlat : _it == other._it;
+		}
+
+		bool operator != (const ConstIterator& other) const
+		{
+			return !(*this == other);
+		}
+
+	private:
+		ValueMap::const_iterator _it;
+		const ValueType*         _pFlat;
+		bool                     _flat;
+	};
+
 	explicit Object(int options = 0);
 		/// Creates an empty Object.
 		///
@@ -77,6 +243,11 @@ public:
 		/// If JSON_ESCAPE_UNICODE is specified, when the object is
 		/// stringified, all unicode characters will be escaped in the
 		/// resulting string.
+		///
+		/// If JSON_FLAT_STORAGE is specified, the object stores its
+		/// items in a single array. Such an object always preserves
+		/// the insertion order, and inserting an item invalidates
+		/// all iterators.
 
 	Object(const Object& copy);
 		/// Creates an Object by copying another one.
@@ -102,6 +273,10 @@ public:
 	bool getEscapeUnicode() const;
 		/// Returns the flag for escaping unicode.
 
+	bool isFlat() const;
+		/// Returns true if the object has been created with
+		/// JSON_FLAT_STORAGE.
+
 	Iterator begin();
 		/// Returns begin iterator for values.
 
@@ -114,6 +289,31 @@ public:
 	ConstIterator end() const;
 		/// Returns const end iterator for values.
 
+	template <typename F>
+	void forEach(F&& func) const
+		/// Calls func(name, value) for each property, in insertion
+		/// order if the object preserves it.
+	{
+		if (useKeyList())
+		{
+			for (KeyList::const_iterator it = _keys.begin(); it != _keys.end(); ++it)
+				func((*it)->first, (*it)->second);
+		}
+		else
+		{
+			for (ConstIterator it = begin(); it != end(); ++it)
+				func(it->first, it->second);
+		}
+	}
+
+	Iterator find(const std::string& key);
+		/// Returns an iterator to the property with the given
+		/// name, or end() if the property doesn't exist.
+
+	ConstIterator find(const std::string& key) const;
+		/// Returns an iterator to the property with the given
+		/// name, or end() if the property doesn't exist.
+
 	Dynamic::Var get(const std::string& key) const;
 		/// Retrieves a property. An empty value is
 		/// returned when the property doesn't exist.
@@ -187,8 +387,8 @@ public:
 		/// def will be returned.
 	{
 		T value = def;
-		ValueMap::const_iterator it = _values.find(key);
-		if (it != _values.end() && ! it->second.isEmpty())
+		ConstIterator it = find(key);
+		if (it != end() && ! it->second.isEmpty())
 		{
 			try
 			{
@@ -208,6 +408,13 @@ public:
 	Object& set(const std::string& key, const Dynamic::Var& value);
 		/// Sets a new value.
 
+	Object& set(const std::string& key, Dynamic::Var&& value);
+		/// Sets a new value, which is moved into the object.
+
+	void reserve(std::size_t size);
+		/// Reserves space for the given number of properties.
+		/// Has no effect unless the object uses JSON_FLAT_STORAGE.
+
 	void stringify(std::ostream& out, unsigned int indent = 0, int step = -1) const;
 		/// Prints the object to out stream.
 		///
@@ -239,6 +446,12 @@ public:
 		/// Insertion order preservation property is left intact.
 
 private:
+	enum
+	{
+		FLAT_LINEAR_LIMIT = 8
+			/// Flat objects with more properties get a hash index.
+	};
+
 	typedef std::deque<ValueMap::const_iterator>  KeyList;
 	typedef Poco::DynamicStruct::Ptr              StructPtr;
 #ifdef POCO_ENABLE_CPP11
@@ -246,6 +459,17 @@ private:
 #endif // POCO_ENABLE_CPP11
 
 	void syncKeys(const KeyList& keys);
+	bool useKeyList() const;
+
+	std::size_t flatFind(const std::string& key) const;
+	void flatAppend(const std::string& key, Dynamic::Var&& value);
+	void flatErase(std::size_t index);
+	void flatReserve(std::size_t capacity);
+	void flatClear();
+	void flatCopy(const Object& other);
+	void flatMove(Object& other);
+	void flatIndex(std::size_t index);
+	void flatRebuildIndex();
 
 	template <typename T>
 	void resetDynStruct(T& pStruct) const
@@ -256,8 +480,8 @@ private:
 			pStruct->clear();
 	}
 
-	template <typename C>
-	void doStringify(const C& container, std::ostream& out, unsigned int indent, unsigned int step) const
+	template <typename I>
+	void doStringify(I it, I end, std::ostream& out, unsigned int indent, unsigned int step) const
 	{
 		int options = Poco::JSON_WRAP_STRINGS;
 		options |= _escapeUnicode ? Poco::JSON_ESCAPE_UNICODE : 0;
@@ -266,8 +490,6 @@ private:
 
 		if (indent > 0) out << std::endl;
 
-		typename C::const_iterator it = container.begin();
-		typename C::const_iterator end = container.end();
 		for (; it != end;)
 		{
 			for (unsigned int i = 0; i < indent; i++) out << ' ';
@@ -277,7 +499,7 @@ private:
 
 			Stringifier::stringify(getValue(it), out, indent + step, step, options);
 
-			if (++it != container.end()) out << ',';
+			if (++it != end) out << ',';
 
 			if (step > 0) out << std::endl;
 		}
@@ -294,7 +516,7 @@ private:
 	{
 		S ds;
 
-		if (obj->_preserveInsOrder)
+		if (obj->useKeyList())
 		{
 			KeyList::const_iterator it = obj->_keys.begin();
 			KeyList::const_iterator end = obj->_keys.end();
@@ -342,13 +564,18 @@ private:
 		return ds;
 	}
 
-	const std::string& getKey(ValueMap::const_iterator& it) const;
-	const Dynamic::Var& getValue(ValueMap::const_iterator& it) const;
+	const std::string& getKey(ConstIterator& it) const;
+	const Dynamic::Var& getValue(ConstIterator& it) const;
 	const std::string& getKey(KeyList::const_iterator& it) const;
 	const Dynamic::Var& getValue(KeyList::const_iterator& it) const;
 
 	ValueMap          _values;
 	KeyList           _keys;
+	ValueType*        _pFlat;
+	std::size_t       _flatSize;
+	std::size_t       _flatCapacity;
+	std::vector<UInt32> _flatIndex;
+	bool              _flat;
 	bool              _preserveInsOrder;
 	// Note:
 	//  The reason for this flag (rather than as argument to stringify()) is
@@ -379,103 +606,129 @@ inline bool Object::getEscapeUnicode() const
 }
 
 
+inline bool Object::isFlat() const
+{
+	return _flat;
+}
+
+
+inline bool Object::useKeyList() const
+{
+	return _preserveInsOrder && !_flat;
+}
+
+
 inline Object::Iterator Object::begin()
 {
-	return _values.begin();
+	if (_flat)
+		return Iterator(_pFlat);
+	else
+		return Iterator(_values.begin());
 }
 
 
 inline Object::ConstIterator Object::begin() const
 {
-	return _values.begin();
+	if (_flat)
+		return ConstIterator(static_cast<const ValueType*>(_pFlat));
+	else
+		return ConstIterator(_values.begin());
 }
 
 
 inline Object::Iterator Object::end()
 {
-	return _values.end();
+	if (_flat)
+		return Iterator(_pFlat + _flatSize);
+	else
+		return Iterator(_values.end());
 }
 
 
 inline Object::ConstIterator Object::end() const
 {
-	return _values.end();
+	if (_flat)
+		return ConstIterator(static_cast<const ValueType*>(_pFlat + _flatSize));
+	else
+		return ConstIterator(_values.end());
+}
+
+
+inline Object::Iterator Object::find(const std::string& key)
+{
+	if (_flat)
+	{
+		std::size_t index = flatFind(key);
+		return Iterator(_pFlat + (index < _flatSize ? index : _flatSize));
+	}
+	else return Iterator(_values.find(key));
+}
+
+
+inline Object::ConstIterator Object::find(const std::string& key) const
+{
+	if (_flat)
+	{
+		std::size_t index = flatFind(key);
+		return ConstIterator(static_cast<const ValueType*>(_pFlat + (index < _flatSize ? index : _flatSize)));
+	}
+	else return ConstIterator(_values.find(key));
 }
 
 
 inline bool Object::has(const std::string& key) const
 {
-	ValueMap::const_iterator it = _values.find(key);
-	return it != _values.end();
+	ConstIterator it = find(key);
+	return it != end();
 }
 
 
 inline bool Object::isArray(const std::string& key) const
 {
-	ValueMap::const_iterator it = _values.find(key);
+	ConstIterator it = find(key);
 	return isArray(it);
 }
 
 
 inline bool Object::isArray(ConstIterator& it) const
 {
-	return it != _values.end() && (it->second.type() == typeid(Array::Ptr) || it->second.type() == typeid(Array));
+	return it != end() && (it->second.type() == typeid(Array::Ptr) || it->second.type() == typeid(Array));
 }
 
 
 inline bool Object::isNull(const std::string& key) const
 {
-	ValueMap::const_iterator it = _values.find(key);
-	return it == _values.end() || it->second.isEmpty();
+	ConstIterator it = find(key);
+	return it == end() || it->second.isEmpty();
 }
 
 
 inline bool Object::isObject(const std::string& key) const
 {
-	ValueMap::const_iterator it = _values.find(key);
+	ConstIterator it = find(key);
 	return isObject(it);
 }
 
 
 inline bool Object::isObject(ConstIterator& it) const
 {
-	return it != _values.end() && (it->second.type() == typeid(Object::Ptr) || it->second.type() == typeid(Object));
+	return it != end() && (it->second.type() == typeid(Object::Ptr) || it->second.type() == typeid(Object));
 }
 
 
 inline std::size_t Object::size() const
 {
-	return static_cast<std::size_t>(_values.size());
-}
-
-
-inline void Object::remove(const std::string& key)
-{
-	_values.erase(key);
-	if (_preserveInsOrder)
-	{
-		KeyList::iterator it = _keys.begin();
-		KeyList::iterator end = _keys.end();
-		for (; it != end; ++it)
-		{
-			if (key == (*it)->first)
-			{
-				_keys.erase(it);
-				break;
-			}
-		}
-	}
-	_modified = true;
+	return _flat ? _flatSize : static_cast<std::size_t>(_values.size());
 }
 
 
-inline const std::string& Object::getKey(ValueMap::const_iterator& it) const
+inline const std::string& Object::getKey(ConstIterator& it) const
 {
 	return it->first;
 }
 
 
-inline const Dynamic::Var& Object::getValue(ValueMap::const_iterator& it) const
+inline const Dynamic::Var& Object::getValue(ConstIterator& it) const
 {
 	return it->second;
 }
@@ -33,12 +33,19 @@ class JSON_API ParseHandler: public Handler
 	/// on the handlers called by the Parser.
 {
 public:
-	ParseHandler(bool preserveObjectOrder = false);
+	ParseHandler(bool preserveObjectOrder = false, bool flatObjects = false);
 		/// Creates the ParseHandler.
 		///
 		/// If preserveObjectOrder is true, the order of properties
 		/// inside objects is preserved. Otherwise, items
 		/// will be sorted by keys.
+		///
+		/// If flatObjects is true, objects are created with
+		/// JSON_FLAT_STORAGE, which also preserves the order of
+		/// properties. Pass such a handler to the Parser to have
+		/// it build flat objects:
+		///
+		///     Parser parser(new ParseHandler(false, true));
 
 	virtual ~ParseHandler();
 		/// Destroys the ParseHandler.
@@ -93,13 +100,14 @@ public:
 		/// A null value is read.
 
 private:
-	void setValue(const Poco::Dynamic::Var& value);
+	void setValue(Poco::Dynamic::Var&& value);
+	void addToParent(Poco::Dynamic::Var&& value);
 	typedef std::stack<Dynamic::Var> Stack;
 
 	Stack        _stack;
 	std::string  _key;
 	Dynamic::Var _result;
-	bool         _preserveObjectOrder;
+	int          _objectOptions;
 };
 
 
@@ -158,8 +166,7 @@ inline void ParseHandler::value(bool b)
 
 inline void ParseHandler::null()
 {
-	Poco::Dynamic::Var empty;
-	setValue(empty);
+	setValue(Poco::Dynamic::Var());
 }
 
 
@@ -92,6 +92,23 @@ public:
 		///
 		/// By default, null bytes are allowed.
 
+	void setIndexed(bool indexed);
+		/// Enables or disables the two-stage indexed parser.
+		///
+		/// The indexed parser first builds a structural index of the
+		/// document, using SIMD instructions where available, and then
+		/// builds a Tape from it, parsing numbers and strings directly
+		/// from the input. It is considerably faster than the default
+		/// streaming parser, at the cost of keeping the complete document
+		/// in memory while it is parsed. It produces the same Handler
+		/// callbacks, but its error messages differ, and it enforces
+		/// the depth set with setDepth().
+		///
+		/// By default, the streaming parser is used.
+
+	bool getIndexed() const;
+		/// Returns true if the two-stage indexed parser is enabled.
+
 	void setDepth(std::size_t depth);
 		/// Sets the allowed JSON depth.
 
@@ -149,6 +166,18 @@ inline bool Parser::getAllowNullByte() const
 }
 
 
+inline void Parser::setIndexed(bool indexed)
+{
+	setIndexedImpl(indexed);
+}
+
+
+inline bool Parser::getIndexed() const
+{
+	return getIndexedImpl();
+}
+
+
 inline void Parser::setDepth(std::size_t depth)
 {
 	setDepthImpl(depth);
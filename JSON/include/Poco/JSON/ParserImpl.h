@@ -23,6 +23,7 @@
 #include "Poco/JSON/Array.h"
 #include "Poco/JSON/ParseHandler.h"
 #include "Poco/JSON/JSONException.h"
+#include "Poco/JSON/Tape.h"
 #include "Poco/UTF8Encoding.h"
 #include "Poco/Dynamic/Var.h"
 #include <string>
@@ -69,6 +70,12 @@ protected:
 		///
 		/// By default, null bytes are allowed.
 
+	void setIndexedImpl(bool indexed);
+		/// Enables or disables the two-stage indexed parser.
+
+	bool getIndexedImpl() const;
+		/// Returns true if the two-stage indexed parser is enabled.
+
 	void setDepthImpl(std::size_t depth);
 		/// Sets the allowed JSON depth.
 
@@ -101,6 +108,7 @@ private:
 	void handleObject();
 	void handle();
 	void handle(const std::string& json);
+	void handleIndexed(const std::string& json);
 	void stripComments(std::string& json);
 	bool checkError();
 
@@ -110,6 +118,8 @@ private:
 	char         _decimalPoint;
 	bool         _allowNullByte;
 	bool         _allowComments;
+	bool         _indexed;
+	Tape         _tape;
 };
 
 
@@ -150,6 +160,18 @@ inline bool ParserImpl::getAllowNullByteImpl() const
 }
 
 
+inline void ParserImpl::setIndexedImpl(bool indexed)
+{
+	_indexed = indexed;
+}
+
+
+inline bool ParserImpl::getIndexedImpl() const
+{
+	return _indexed;
+}
+
+
 inline void ParserImpl::setDepthImpl(std::size_t depth)
 {
 	_depth = static_cast<int>(depth);
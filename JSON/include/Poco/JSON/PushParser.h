@@ -0,0 +1,266 @@
+//
+// PushParser.h
+//
+// Library: JSON
+// Package: JSON
+// Module:  PushParser
+//
+// Definition of the PushParser class.
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef JSON_PushParser_INCLUDED
+#define JSON_PushParser_INCLUDED
+
+
+#include "Poco/JSON/JSON.h"
+#include "Poco/JSON/Handler.h"
+#include "Poco/JSON/ParseHandler.h"
+#include "Poco/Dynamic/Var.h"
+#include <vector>
+#include <string>
+
+
+namespace Poco {
+namespace JSON {
+
+
+class JSON_API PushParser
+	/// An incremental JSON parser that is fed with chunks of input
+	/// as they become available, e.g. from a non-blocking socket or
+	/// the parts of a chunked HTTP request body.
+	///
+	/// The input may be split at any byte, including within strings,
+	/// numbers, escape sequences and multi-byte UTF-8 characters.
+	/// The parser keeps its state between calls to feed() and reports
+	/// parsing events to a Handler as soon as they are recognized, so
+	/// the complete document never has to be buffered.
+	///
+	/// Usage example (in a SocketReactor event handler):
+	///
+	///     void onReadable(ReadableNotification* pNf)
+	///     {
+	///         int n = _socket.receiveBytes(_buffer, sizeof(_buffer));
+	///         if (n > 0)
+	///         {
+	///             _parser.feed(_buffer, n);
+	///         }
+	///         else
+	///         {
+	///             _parser.finish();
+	///             Var result = _parser.result();
+	///             ...
+	///         }
+	///     }
+	///
+	/// Accepts the same documents as Parser. After an exception has
+	/// been thrown, reset() must be called before the PushParser
+	/// can be used again.
+{
+public:
+	static const int JSON_UNLIMITED_DEPTH = -1;
+
+	PushParser(const Handler::Ptr& pHandler = new ParseHandler);
+		/// Creates a PushParser that reports events to the given Handler.
+
+	~PushParser();
+		/// Destroys the PushParser.
+
+	void feed(const char* data, std::size_t length);
+		/// Parses the next chunk of input.
+		///
+		/// Throws a JSONException if the input is not valid JSON
+		/// or contains non-whitespace characters after the end
+		/// of the document.
+
+	void feed(const std::string& data);
+		/// Parses the next chunk of input.
+
+	void finish();
+		/// Signals the end of the input.
+		///
+		/// Throws a JSONException if the document is incomplete.
+
+	bool done() const;
+		/// Returns true if a complete document has been parsed.
+		/// This may be the case before finish() is called.
+
+	void reset();
+		/// Resets the parser and the Handler, so that a new
+		/// document can be parsed.
+
+	void setHandler(const Handler::Ptr& pHandler);
+		/// Sets the Handler.
+
+	const Handler::Ptr& getHandler();
+		/// Returns the Handler.
+
+	void setAllowComments(bool comments);
+		/// Allow or disallow C-style block comments outside of strings.
+		/// By default, comments are not allowed.
+
+	bool getAllowComments() const;
+		/// Returns true if comments are allowed, false otherwise.
+
+	void setAllowNullByte(bool nullByte);
+		/// Allow or disallow \u0000 escapes in strings.
+		/// By default, null bytes are allowed.
+
+	bool getAllowNullByte() const;
+		/// Returns true if null bytes are allowed, false otherwise.
+
+	void setDepth(int depth);
+		/// Sets the maximum nesting depth of objects and arrays,
+		/// or JSON_UNLIMITED_DEPTH, which is the default.
+
+	int getDepth() const;
+		/// Returns the maximum nesting depth.
+
+	std::size_t offset() const;
+		/// Returns the number of bytes parsed so far.
+
+	Dynamic::Var result() const;
+		/// Returns the result of the Handler.
+
+private:
+	PushParser(const PushParser&);
+	PushParser& operator = (const PushParser&);
+
+	enum State
+	{
+		STATE_VALUE,
+		STATE_ARRAY_FIRST,
+		STATE_OBJECT_FIRST,
+		STATE_KEY,
+		STATE_COLON,
+		STATE_COMMA,
+		STATE_END,
+		STATE_STRING,
+		STATE_ESCAPE,
+		STATE_UNICODE,
+		STATE_NUMBER,
+		STATE_LITERAL,
+		STATE_COMMENT_START,
+		STATE_COMMENT,
+		STATE_COMMENT_STAR,
+		STATE_ERROR
+	};
+
+	const char* parseStructure(const char* p, const char* end);
+	const char* parseString(const char* p, const char* end);
+	const char* parseNumber(const char* p, const char* end);
+	void startValue(char c);
+	void startContainer(char type);
+	void endContainer(char type);
+	void endString();
+	void endNumber();
+	void endLiteral();
+	void endValue();
+	void escape(char c);
+	void unicode(char c);
+	void fail(const std::string& message);
+
+	Handler::Ptr       _pHandler;
+	State              _state;
+	State              _commentState;
+	std::vector<char>  _stack;
+	std::string        _token;
+	const char*        _pLiteral;
+	std::size_t        _literalPos;
+	UInt32             _codePoint;
+	UInt32             _highSurrogate;
+	int                _hexDigits;
+	int                _depth;
+	std::size_t        _offset;
+	bool               _key;
+	bool               _allowComments;
+	bool               _allowNullByte;
+};
+
+
+//
+// inlines
+//
+inline void PushParser::feed(const std::string& data)
+{
+	feed(data.data(), data.size());
+}
+
+
+inline bool PushParser::done() const
+{
+	return _state == STATE_END;
+}
+
+
+inline void PushParser::setHandler(const Handler::Ptr& pHandler)
+{
+	_pHandler = pHandler;
+}
+
+
+inline const Handler::Ptr& PushParser::getHandler()
+{
+	return _pHandler;
+}
+
+
+inline void PushParser::setAllowComments(bool comments)
+{
+	_allowComments = comments;
+}
+
+
+inline bool PushParser::getAllowComments() const
+{
+	return _allowComments;
+}
+
+
+inline void PushParser::setAllowNullByte(bool nullByte)
+{
+	_allowNullByte = nullByte;
+}
+
+
+inline bool PushParser::getAllowNullByte() const
+{
+	return _allowNullByte;
+}
+
+
+inline void PushParser::setDepth(int depth)
+{
+	_depth = depth;
+}
+
+
+inline int PushParser::getDepth() const
+{
+	return _depth;
+}
+
+
+inline std::size_t PushParser::offset() const
+{
+	return _offset;
+}
+
+
+inline Dynamic::Var PushParser::result() const
+{
+	if (_pHandler) return _pHandler->asVar();
+
+	return Dynamic::Var();
+}
+
+
+} } // namespace Poco::JSON
+
+
+#endif // JSON_PushParser_INCLUDED
@@ -21,6 +21,8 @@
 #include "Poco/JSON/JSON.h"
 #include "Poco/JSON/Object.h"
 #include "Poco/JSON/Array.h"
+#include "Poco/JSON/Document.h"
+#include "Poco/JSON/QueryPath.h"
 
 
 namespace Poco {
@@ -41,6 +43,17 @@ public:
 		/// Creating Query holding Ptr will typically result in faster
 		/// performance.
 
+	Query(const Document& source);
+		/// Creates a Query for the root value of the given Document,
+		/// which must outlive the Query.
+		///
+		/// Values are searched for in the Document, and only the
+		/// values found are converted to Var, Object or Array.
+
+	Query(const Document::Value& source);
+		/// Creates a Query for the given Document value, whose
+		/// Document must outlive the Query.
+
 	virtual ~Query();
 		/// Destroys the Query.
 
@@ -85,6 +98,13 @@ public:
 		/// the name of the first child. When the value can't be found
 		/// an empty value is returned.
 
+	Dynamic::Var find(const QueryPath& path) const;
+		/// Searches a value, using a path that has been parsed before.
+		/// This is faster if the same path is searched for repeatedly.
+		///
+		/// Unlike find(const std::string&), an index applied to a
+		/// value that is not an array yields an empty value.
+
 	template<typename T>
 	T findValue(const std::string& path, const T& def) const
 		/// Searches for a value will convert it to the given type.
@@ -115,7 +135,8 @@ public:
 	}
 
 private:
-	Dynamic::Var _source;
+	Dynamic::Var    _source;
+	Document::Value _value;
 };
 
 
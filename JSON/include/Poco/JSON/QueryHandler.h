@@ -0,0 +1,125 @@
+//
+// QueryHandler.h
+//
+// Library: JSON
+// Package: JSON
+// Module:  QueryHandler
+//
+// Definition of the QueryHandler class.
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef JSON_QueryHandler_INCLUDED
+#define JSON_QueryHandler_INCLUDED
+
+
+#include "Poco/JSON/JSON.h"
+#include "Poco/JSON/Handler.h"
+#include "Poco/JSON/ParseHandler.h"
+#include "Poco/JSON/QuerySet.h"
+#include <vector>
+
+
+namespace Poco {
+namespace JSON {
+
+
+class JSON_API QueryHandler: public Handler
+	/// A Handler that extracts the values at the paths of a QuerySet
+	/// while a document is being parsed, in a single pass.
+	///
+	/// Only the values found at the paths are stored; objects and
+	/// arrays that are not on a path are skipped without building them.
+	///
+	///     QuerySet querySet;
+	///     std::size_t name = querySet.add("user.name");
+	///     QueryHandler::Ptr pHandler = new QueryHandler(querySet);
+	///     Parser parser(pHandler);
+	///     parser.parse(json);
+	///     Var value = pHandler->result(name);
+	///
+	/// The handler can be used with Parser and PushParser, and the
+	/// QuerySet must outlive it.
+{
+public:
+	typedef SharedPtr<QueryHandler> Ptr;
+
+	explicit QueryHandler(const QuerySet& querySet);
+		/// Creates a QueryHandler for the given QuerySet.
+
+	~QueryHandler();
+		/// Destroys the QueryHandler.
+
+	const Dynamic::Var& result(std::size_t index) const;
+		/// Returns the value found for the path with the given index,
+		/// or an empty Var if the path does not exist.
+
+	const QuerySet::VarVec& results() const;
+		/// Returns the values found for all paths.
+
+	void reset();
+	void startObject();
+	void endObject();
+	void startArray();
+	void endArray();
+	void key(const std::string& k);
+	void null();
+	void value(int v);
+	void value(unsigned v);
+#if defined(POCO_HAVE_INT64)
+	void value(Int64 v);
+	void value(UInt64 v);
+#endif
+	void value(const std::string& s);
+	void value(double d);
+	void value(bool b);
+
+private:
+	struct Frame
+	{
+		std::size_t node;
+		std::size_t member;
+		std::size_t index;
+		bool        object;
+	};
+
+	std::size_t target();
+	void setValue(const Dynamic::Var& value);
+	void startContainer(bool object);
+	void endContainer();
+
+	const QuerySet&       _querySet;
+	QuerySet::VarVec      _values;
+	std::vector<Frame>    _stack;
+	ParseHandler          _capture;
+	std::size_t           _captureNode;
+	int                   _captureDepth;
+};
+
+
+//
+// inlines
+//
+inline const Dynamic::Var& QueryHandler::result(std::size_t index) const
+{
+	poco_assert (index < _values.size());
+
+	return _values[index];
+}
+
+
+inline const QuerySet::VarVec& QueryHandler::results() const
+{
+	return _values;
+}
+
+
+} } // namespace Poco::JSON
+
+
+#endif // JSON_QueryHandler_INCLUDED
@@ -0,0 +1,146 @@
+//
+// QueryPath.h
+//
+// Library: JSON
+// Package: JSON
+// Module:  QueryPath
+//
+// Definition of the QueryPath class.
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef JSON_QueryPath_INCLUDED
+#define JSON_QueryPath_INCLUDED
+
+
+#include "Poco/JSON/JSON.h"
+#include "Poco/JSON/Document.h"
+#include "Poco/Dynamic/Var.h"
+#include <vector>
+#include <string>
+
+
+namespace Poco {
+namespace JSON {
+
+
+class JSON_API QueryPath
+	/// A path into a JSON value, like "person.children[0].name",
+	/// in the syntax used by Query.
+	///
+	/// The path is parsed once, when the QueryPath is created,
+	/// and can then be evaluated any number of times, for any
+	/// number of values, without parsing it again:
+	///
+	///     static const QueryPath name("person.children[0].name");
+	///     Var value = name.find(pObject);
+	///
+	/// Evaluation does not copy the objects and arrays along the path,
+	/// and does not allocate memory, except for the copy of the
+	/// result returned by find(const Dynamic::Var&).
+{
+public:
+	struct Step
+		/// A single step of a path, either the name
+		/// of an object member or an array index.
+	{
+		std::string name;
+		std::size_t index;
+		bool        isIndex;
+	};
+
+	typedef std::vector<Step> StepVec;
+
+	QueryPath();
+		/// Creates an empty QueryPath, which refers to the value itself.
+
+	explicit QueryPath(const std::string& path);
+		/// Creates a QueryPath from the given path.
+
+	explicit QueryPath(const char* path);
+		/// Creates a QueryPath from the given path.
+
+	~QueryPath();
+		/// Destroys the QueryPath.
+
+	void assign(const std::string& path);
+		/// Parses the given path.
+		///
+		/// Throws a SyntaxException if an index is larger
+		/// than the largest int, like Query does.
+
+	Dynamic::Var find(const Dynamic::Var& source) const;
+		/// Returns the value at the path in source, which must be
+		/// an Object, an Array or a pointer to one of them, or an
+		/// empty Var if there is no such value.
+
+	const Dynamic::Var* findPtr(const Dynamic::Var& source) const;
+		/// Returns a pointer to the value at the path in source,
+		/// or null if there is no such value. The pointer is valid
+		/// as long as source is not modified.
+
+	Document::Value find(const Document::Value& source) const;
+		/// Returns the value at the path in the given Document value,
+		/// or an invalid Value if there is no such value.
+
+	Document::Value find(const Document& source) const;
+		/// Returns the value at the path in the given Document,
+		/// or an invalid Value if there is no such value.
+
+	const StepVec& steps() const;
+		/// Returns the steps of the path.
+
+	const std::string& toString() const;
+		/// Returns the path.
+
+	static const Dynamic::Var* step(const Dynamic::Var& value, const Step& step);
+		/// Returns a pointer to the object member or array element
+		/// of value given by step, or null if there is none.
+
+	static Document::Value step(const Document::Value& value, const Step& step);
+		/// Returns the object member or array element of value
+		/// given by step, or an invalid Value if there is none.
+
+	static void parse(const std::string& path, StepVec& steps);
+		/// Parses path into steps.
+		///
+		/// The path consists of member names, separated by periods.
+		/// Each name may be followed by one or more array indexes
+		/// in square brackets.
+
+private:
+	std::string _path;
+	StepVec     _steps;
+};
+
+
+//
+// inlines
+//
+inline const QueryPath::StepVec& QueryPath::steps() const
+{
+	return _steps;
+}
+
+
+inline const std::string& QueryPath::toString() const
+{
+	return _path;
+}
+
+
+inline Document::Value QueryPath::find(const Document& source) const
+{
+	return find(source.root());
+}
+
+
+} } // namespace Poco::JSON
+
+
+#endif // JSON_QueryPath_INCLUDED
@@ -0,0 +1,137 @@
+//
+// QuerySet.h
+//
+// Library: JSON
+// Package: JSON
+// Module:  QuerySet
+//
+// Definition of the QuerySet class.
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef JSON_QuerySet_INCLUDED
+#define JSON_QuerySet_INCLUDED
+
+
+#include "Poco/JSON/JSON.h"
+#include "Poco/JSON/QueryPath.h"
+#include "Poco/JSON/Document.h"
+#include "Poco/Dynamic/Var.h"
+#include <vector>
+#include <string>
+
+
+namespace Poco {
+namespace JSON {
+
+
+class JSON_API QuerySet
+	/// A set of paths that are extracted from a JSON value together,
+	/// in a single pass.
+	///
+	/// The paths are merged into a tree, so that common prefixes
+	/// are only evaluated once, and the members of every object
+	/// along the way are only looked at once:
+	///
+	///     QuerySet querySet;
+	///     std::size_t id   = querySet.add("id");
+	///     std::size_t name = querySet.add("user.name");
+	///     std::size_t tag  = querySet.add("user.tags[0]");
+	///
+	///     std::vector<Document::Value> values;
+	///     querySet.find(document, values);
+	///     if (values[name].isString()) ...
+	///
+	/// To extract the values while parsing, without building
+	/// the complete document, use a QueryHandler.
+{
+public:
+	typedef std::vector<Dynamic::Var>    VarVec;
+	typedef std::vector<Document::Value> ValueVec;
+
+	QuerySet();
+		/// Creates an empty QuerySet.
+
+	~QuerySet();
+		/// Destroys the QuerySet.
+
+	std::size_t add(const std::string& path);
+		/// Adds the given path, and returns the index
+		/// of its value in the results.
+
+	std::size_t size() const;
+		/// Returns the number of paths.
+
+	const QueryPath& path(std::size_t index) const;
+		/// Returns the path with the given index.
+
+	void find(const Dynamic::Var& source, VarVec& results) const;
+		/// Stores the values at all paths in source in results,
+		/// or an empty Var for paths that do not exist.
+
+	void find(const Document::Value& source, ValueVec& results) const;
+		/// Stores the values at all paths in source in results,
+		/// or an invalid Value for paths that do not exist.
+
+	void find(const Document& source, ValueVec& results) const;
+		/// Stores the values at all paths in the Document in results,
+		/// or an invalid Value for paths that do not exist.
+
+private:
+	static const std::size_t NO_NODE = static_cast<std::size_t>(-1);
+
+	struct Node
+	{
+		QueryPath::Step          step;
+		std::vector<std::size_t> children;
+		std::vector<std::size_t> paths;
+		std::size_t              nameChildren;
+		std::size_t              indexChildren;
+	};
+
+	typedef std::vector<Node> NodeVec;
+
+	std::size_t child(std::size_t node, const std::string& name) const;
+	std::size_t child(std::size_t node, std::size_t index) const;
+	void findNode(std::size_t node, const Dynamic::Var& value, VarVec& results) const;
+	void findNode(std::size_t node, const Document::Value& value, ValueVec& results) const;
+
+	std::vector<QueryPath> _paths;
+	NodeVec                _nodes;
+
+	friend class QueryHandler;
+};
+
+
+//
+// inlines
+//
+inline std::size_t QuerySet::size() const
+{
+	return _paths.size();
+}
+
+
+inline const QueryPath& QuerySet::path(std::size_t index) const
+{
+	poco_assert (index < _paths.size());
+
+	return _paths[index];
+}
+
+
+inline void QuerySet::find(const Document& source, ValueVec& results) const
+{
+	find(source.root(), results);
+}
+
+
+} } // namespace Poco::JSON
+
+
+#endif // JSON_QuerySet_INCLUDED
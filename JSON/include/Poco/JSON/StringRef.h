@@ -0,0 +1,166 @@
+//
+// StringRef.h
+//
+// Library: JSON
+// Package: JSON
+// Module:  StringRef
+//
+// Definition of the StringRef class.
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef JSON_StringRef_INCLUDED
+#define JSON_StringRef_INCLUDED
+
+
+#include "Poco/JSON/JSON.h"
+#include <string>
+#include <cstring>
+#include <ostream>
+
+
+namespace Poco {
+namespace JSON {
+
+
+class StringRef
+	/// A non-owning reference to a sequence of characters,
+	/// used to return strings from a Document without copying them.
+	///
+	/// The characters are not zero terminated. A StringRef is only
+	/// valid as long as the object it has been obtained from.
+{
+public:
+	typedef const char* ConstIterator;
+
+	StringRef():
+		_pData(""),
+		_length(0)
+		/// Creates an empty StringRef.
+	{
+	}
+
+	StringRef(const char* data, std::size_t length):
+		_pData(data),
+		_length(length)
+		/// Creates a StringRef for the given characters.
+	{
+	}
+
+	StringRef(const char* str):
+		_pData(str),
+		_length(std::strlen(str))
+		/// Creates a StringRef for the given zero-terminated string.
+	{
+	}
+
+	StringRef(const std::string& str):
+		_pData(str.data()),
+		_length(str.size())
+		/// Creates a StringRef for the characters of the given string.
+	{
+	}
+
+	const char* data() const
+		/// Returns a pointer to the first character.
+	{
+		return _pData;
+	}
+
+	std::size_t size() const
+		/// Returns the number of characters.
+	{
+		return _length;
+	}
+
+	std::size_t length() const
+		/// Returns the number of characters.
+	{
+		return _length;
+	}
+
+	bool empty() const
+		/// Returns true if the StringRef has no characters.
+	{
+		return _length == 0;
+	}
+
+	ConstIterator begin() const
+	{
+		return _pData;
+	}
+
+	ConstIterator end() const
+	{
+		return _pData + _length;
+	}
+
+	char operator [] (std::size_t index) const
+	{
+		return _pData[index];
+	}
+
+	int compare(const StringRef& other) const
+		/// Compares the characters lexicographically, like
+		/// std::string::compare().
+	{
+		std::size_t n = _length < other._length ? _length : other._length;
+		int rc = n > 0 ? std::memcmp(_pData, other._pData, n) : 0;
+		if (rc != 0) return rc;
+		return _length < other._length ? -1 : (_length > other._length ? 1 : 0);
+	}
+
+	std::string toString() const
+		/// Returns a copy of the characters.
+	{
+		return std::string(_pData, _length);
+	}
+
+	void assignTo(std::string& str) const
+		/// Assigns the characters to str, reusing its buffer.
+	{
+		str.assign(_pData, _length);
+	}
+
+private:
+	const char* _pData;
+	std::size_t _length;
+};
+
+
+//
+// inlines
+//
+inline bool operator == (const StringRef& s1, const StringRef& s2)
+{
+	return s1.size() == s2.size() && (s1.size() == 0 || std::memcmp(s1.data(), s2.data(), s1.size()) == 0);
+}
+
+
+inline bool operator != (const StringRef& s1, const StringRef& s2)
+{
+	return !(s1 == s2);
+}
+
+
+inline bool operator < (const StringRef& s1, const StringRef& s2)
+{
+	return s1.compare(s2) < 0;
+}
+
+
+inline std::ostream& operator << (std::ostream& ostr, const StringRef& str)
+{
+	return ostr.write(str.data(), static_cast<std::streamsize>(str.size()));
+}
+
+
+} } // namespace Poco::JSON
+
+
+#endif // JSON_StringRef_INCLUDED
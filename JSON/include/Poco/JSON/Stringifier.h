@@ -52,6 +52,10 @@ public:
 		///
 		/// If JSON_ESCAPE_UNICODE is in options, all unicode characters will be escaped, otherwise
 		/// only the compulsory ones.
+		///
+		/// Since JSON cannot represent infinity and NaN, floating-point
+		/// values that are not finite are written as null, with or
+		/// without indentation.
 
 	static void formatString(const std::string& value, std::ostream& out, int options = Poco::JSON_WRAP_STRINGS);
 		/// Formats the JSON string and streams it into ostream.
@@ -0,0 +1,311 @@
+//
+// Tape.h
+//
+// Library: JSON
+// Package: JSON
+// Module:  Tape
+//
+// Definition of the Tape class.
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef JSON_Tape_INCLUDED
+#define JSON_Tape_INCLUDED
+
+
+#include "Poco/JSON/JSON.h"
+#include "Poco/Arena.h"
+#include <vector>
+#include <string>
+#include <cstring>
+
+
+namespace Poco {
+namespace JSON {
+
+
+class Handler;
+
+
+class JSON_API Tape
+	/// A compact, flat representation of a parsed JSON document.
+	///
+	/// The document is parsed in two stages. The first stage builds a
+	/// structural index, the positions of all structural characters
+	/// and of the first characters of all scalar values outside of
+	/// strings, processing the input in blocks of 64 bytes with SIMD
+	/// instructions where available. The second stage walks the index,
+	/// checks the grammar and writes the tape.
+	///
+	/// The tape is a sequence of 64-bit words. Each value starts with a
+	/// word holding its Type in the upper 8 bits. Objects and arrays
+	/// are delimited by start and end words; the start word holds
+	/// the position following the end word, so that containers can be
+	/// skipped in constant time. Numbers and strings occupy two words.
+	/// Object members are stored as a string (the key), followed by
+	/// the value.
+	///
+	/// Strings without escape sequences refer to the input, which
+	/// therefore must remain valid and unchanged as long as the tape
+	/// is used. Strings with escape sequences are decoded into a buffer
+	/// owned by the Tape. Numbers are parsed directly from the input.
+	///
+	/// A Tape can be reused for parsing several documents, which
+	/// avoids reallocating its buffers. Alternatively, the buffers of
+	/// Tapes for many short-lived documents can be allocated from an
+	/// Arena, which releases them in one step.
+{
+public:
+	enum Type
+	{
+		TYPE_OBJECT     = '{',
+		TYPE_OBJECT_END = '}',
+		TYPE_ARRAY      = '[',
+		TYPE_ARRAY_END  = ']',
+		TYPE_STRING     = '"',
+		TYPE_INT64      = 'l',
+		TYPE_UINT64     = 'u',
+		TYPE_DOUBLE     = 'd',
+		TYPE_TRUE       = 't',
+		TYPE_FALSE      = 'f',
+		TYPE_NULL       = 'n'
+	};
+
+	Tape();
+		/// Creates an empty Tape.
+
+	explicit Tape(Arena& arena);
+		/// Creates an empty Tape that allocates its buffers
+		/// from the given Arena, which must outlive the Tape.
+
+	~Tape();
+		/// Destroys the Tape.
+
+	void parse(const char* json, std::size_t length);
+		/// Parses the JSON document of the given length starting at json.
+		///
+		/// Throws a JSONException if the document is not valid JSON,
+		/// or contains invalid UTF-8 sequences.
+
+	void clear();
+		/// Clears the Tape.
+
+	void setAllowNullByte(bool nullByte);
+		/// Allow or disallow null byte in strings.
+		///
+		/// By default, null byte is allowed.
+
+	bool getAllowNullByte() const;
+		/// Returns true if null byte is allowed, false otherwise.
+
+	void setDepth(int depth);
+		/// Sets the maximum nesting depth of objects and arrays,
+		/// or -1 for unlimited depth, which is the default.
+
+	int getDepth() const;
+		/// Returns the maximum nesting depth.
+
+	bool empty() const;
+		/// Returns true if the Tape is empty.
+
+	std::size_t size() const;
+		/// Returns the number of words on the Tape.
+
+	Type type(std::size_t pos) const;
+		/// Returns the type of the value at the given position.
+
+	std::size_t next(std::size_t pos) const;
+		/// Returns the position following the value at pos.
+		/// For objects and arrays, this is the position
+		/// following their end.
+
+	Int64 getInt64(std::size_t pos) const;
+		/// Returns the value of the TYPE_INT64 value at pos.
+
+	UInt64 getUInt64(std::size_t pos) const;
+		/// Returns the value of the TYPE_UINT64 value at pos.
+
+	double getDouble(std::size_t pos) const;
+		/// Returns the value of the TYPE_DOUBLE value at pos.
+
+	const char* getString(std::size_t pos, std::size_t& length) const;
+		/// Returns a pointer to the decoded characters of the
+		/// TYPE_STRING value at pos and stores its length in length.
+		/// The characters are not zero terminated.
+
+	void getString(std::size_t pos, std::string& str) const;
+		/// Assigns the TYPE_STRING value at pos to str.
+
+	bool stringEquals(std::size_t pos, const char* str, std::size_t length) const;
+		/// Returns true if the TYPE_STRING value at pos equals
+		/// the given characters.
+
+	void emit(std::size_t pos, Handler& handler) const;
+		/// Passes the value at pos, including all values
+		/// nested in it, to the given Handler.
+
+private:
+	enum
+	{
+		TYPE_SHIFT   = 56,
+		BLOCK_SIZE   = 64
+	};
+
+	static const UInt64 PAYLOAD_MASK = (static_cast<UInt64>(1) << TYPE_SHIFT) - 1;
+	static const UInt64 DECODED_FLAG = static_cast<UInt64>(1) << (TYPE_SHIFT - 1);
+
+	Tape(const Tape&);
+	Tape& operator = (const Tape&);
+
+	std::size_t index();
+	void build(std::size_t count);
+	const char* parseString(const char* p);
+	const char* decodeString(const char* p, const char* start);
+	const char* parseNumber(const char* p);
+	const char* parseLiteral(const char* p, const char* literal, std::size_t length, Type type);
+	void closeContainer(Type type);
+	void append(Type type, UInt64 payload);
+	void appendValue(Type type, UInt64 value);
+	UInt64 payload(std::size_t pos) const;
+
+	typedef std::vector<UInt32, ArenaAllocator<UInt32>> Index;
+	typedef std::vector<UInt64, ArenaAllocator<UInt64>> Words;
+	typedef std::vector<std::size_t, ArenaAllocator<std::size_t>> Stack;
+	typedef std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>> Buffer;
+
+	const char* _pJSON;
+	std::size_t _length;
+	Index       _index;
+	Words       _words;
+	Stack       _stack;
+	Buffer      _decoded;
+	int         _depth;
+	bool        _allowNullByte;
+};
+
+
+//
+// inlines
+//
+inline void Tape::setAllowNullByte(bool nullByte)
+{
+	_allowNullByte = nullByte;
+}
+
+
+inline bool Tape::getAllowNullByte() const
+{
+	return _allowNullByte;
+}
+
+
+inline void Tape::setDepth(int depth)
+{
+	_depth = depth;
+}
+
+
+inline int Tape::getDepth() const
+{
+	return _depth;
+}
+
+
+inline bool Tape::empty() const
+{
+	return _words.empty();
+}
+
+
+inline std::size_t Tape::size() const
+{
+	return _words.size();
+}
+
+
+inline Tape::Type Tape::type(std::size_t pos) const
+{
+	return static_cast<Type>(_words[pos] >> TYPE_SHIFT);
+}
+
+
+inline UInt64 Tape::payload(std::size_t pos) const
+{
+	return _words[pos] & PAYLOAD_MASK;
+}
+
+
+inline std::size_t Tape::next(std::size_t pos) const
+{
+	switch (type(pos))
+	{
+	case TYPE_OBJECT:
+	case TYPE_ARRAY:
+		return static_cast<std::size_t>(payload(pos));
+	case TYPE_STRING:
+	case TYPE_INT64:
+	case TYPE_UINT64:
+	case TYPE_DOUBLE:
+		return pos + 2;
+	default:
+		return pos + 1;
+	}
+}
+
+
+inline Int64 Tape::getInt64(std::size_t pos) const
+{
+	return static_cast<Int64>(_words[pos + 1]);
+}
+
+
+inline UInt64 Tape::getUInt64(std::size_t pos) const
+{
+	return _words[pos + 1];
+}
+
+
+inline double Tape::getDouble(std::size_t pos) const
+{
+	double d;
+	std::memcpy(&d, &_words[pos + 1], sizeof(d));
+	return d;
+}
+
+
+inline const char* Tape::getString(std::size_t pos, std::size_t& length) const
+{
+	UInt64 offset = payload(pos);
+	length = static_cast<std::size_t>(_words[pos + 1]);
+	if (offset & DECODED_FLAG)
+		return _decoded.data() + (offset & ~DECODED_FLAG);
+	else
+		return _pJSON + offset;
+}
+
+
+inline void Tape::getString(std::size_t pos, std::string& str) const
+{
+	std::size_t length;
+	const char* p = getString(pos, length);
+	str.assign(p, length);
+}
+
+
+inline bool Tape::stringEquals(std::size_t pos, const char* str, std::size_t length) const
+{
+	std::size_t len;
+	const char* p = getString(pos, len);
+	return len == length && std::memcmp(p, str, length) == 0;
+}
+
+
+} } // namespace Poco::JSON
+
+
+#endif // JSON_Tape_INCLUDED
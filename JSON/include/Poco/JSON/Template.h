@@ -19,21 +19,19 @@
 
 
 #include "Poco/JSON/JSON.h"
+#include "Poco/JSON/QueryPath.h"
 #include "Poco/Dynamic/Var.h"
 #include "Poco/SharedPtr.h"
 #include "Poco/Path.h"
 #include "Poco/Timestamp.h"
 #include <sstream>
-#include <stack>
+#include <vector>
 
 
 namespace Poco {
 namespace JSON {
 
 
-class MultiPart;
-
-
 POCO_DECLARE_EXCEPTION(JSON_API, JSONTemplateException, Poco::Exception)
 
 
@@ -85,6 +83,20 @@ class JSON_API Template
 	/// is used.
 	///
 	///  A query is passed to Poco::JSON::Query to get the value.
+	///
+	/// When a template is parsed, it is compiled into a flat list
+	/// of instructions, with the queries already parsed into
+	/// QueryPath objects. Rendering only walks this list, and
+	/// can append the output to a string that is reused for
+	/// many renderings:
+	///
+	///     std::string out;
+	///     for (...)
+	///     {
+	///         out.clear();
+	///         tpl.render(data, out);
+	///         ...
+	///     }
 {
 public:
 	typedef SharedPtr<Template> Ptr;
@@ -113,7 +125,51 @@ public:
 	void render(const Dynamic::Var& data, std::ostream& out) const;
 		/// Renders the template and send the output to the stream.
 
+	void render(const Dynamic::Var& data, std::string& out) const;
+		/// Renders the template and appends the output to out.
+		///
+		/// The string is not cleared first, so the same buffer
+		/// can be reused, without allocating memory again.
+
 private:
+	struct Instruction
+	{
+		enum Opcode
+		{
+			OP_TEXT,    /// Append text [offset, offset + length) of _text.
+			OP_ECHO,    /// Append the value of query.
+			OP_IF,      /// Jump to target when query is false.
+			OP_IFEXIST, /// Jump to target when query does not exist.
+			OP_JUMP,    /// Jump to target.
+			OP_FOR,     /// Start a loop over query, jump to target when empty.
+			OP_ENDFOR,  /// Continue the loop started at target.
+			OP_INCLUDE  /// Render the template _includes[offset].
+		};
+
+		Opcode      opcode;
+		std::size_t offset;
+		std::size_t length;
+		std::size_t target;
+		QueryPath   query;
+		std::string name;
+	};
+
+	typedef std::vector<Instruction> InstructionVec;
+
+	struct Block
+		/// An <? if ?> or <? for ?> block that is open while parsing.
+	{
+		bool                     loop;
+		std::size_t              start;
+		std::size_t              pending;
+		std::vector<std::size_t> exits;
+	};
+
+	std::size_t emit(Instruction::Opcode opcode);
+	std::size_t emit(Instruction::Opcode opcode, const std::string& query);
+	void endBlock(const Block& block);
+	void renderInclude(const Path& path, const Dynamic::Var& data, std::string& out) const;
+
 	std::string readText(std::istream& in);
 	std::string readWord(std::istream& in);
 	std::string readQuery(std::istream& in);
@@ -121,9 +177,9 @@ private:
 	std::string readString(std::istream& in);
 	void readWhiteSpace(std::istream& in);
 
-	MultiPart* _parts;
-	std::stack<MultiPart*> _partStack;
-	MultiPart* _currentPart;
+	InstructionVec _instructions;
+	std::string _text;
+	std::vector<Path> _includes;
 	Path _templatePath;
 	Timestamp _parseTime;
 };
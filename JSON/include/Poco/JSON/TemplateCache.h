@@ -23,6 +23,8 @@
 #include "Poco/Path.h"
 #include "Poco/SharedPtr.h"
 #include "Poco/Logger.h"
+#include "Poco/Timespan.h"
+#include "Poco/Timestamp.h"
 #include <vector>
 #include <map>
 
@@ -37,6 +39,11 @@ class JSON_API TemplateCache
 	/// When a template file has changed, the cache
 	/// will remove the old template from the cache
 	/// and load a new one.
+	///
+	/// The cache holds the compiled templates. To keep
+	/// lookups cheap, a template file is only checked
+	/// for changes when the check interval has elapsed
+	/// since the last check.
 {
 public:
 	TemplateCache();
@@ -61,6 +68,19 @@ public:
 		/// even when the template isn't stored anymore in
 		/// the cache.
 
+	void setCheckInterval(const Timespan& interval);
+		/// Sets the interval after which a cached template
+		/// file is checked again for changes. Until the interval
+		/// has elapsed, the cached template is returned without
+		/// accessing the file system.
+		///
+		/// With an interval of zero, the file is checked on
+		/// every call to getTemplate(). The default is one second.
+
+	const Timespan& getCheckInterval() const;
+		/// Returns the interval after which a cached template
+		/// file is checked again for changes.
+
 	static TemplateCache* instance();
 		/// Returns the only instance of this cache.
 
@@ -68,13 +88,24 @@ public:
 		/// Sets the logger for the cache.
 
 private:
+	struct Entry
+	{
+		Template::Ptr pTemplate;
+		Timestamp     lastCheck;
+	};
+
+	typedef std::map<std::string, Entry> EntryMap;
+
 	void setup();
 	Path resolvePath(const Path& path) const;
-
-	static TemplateCache*                _pInstance;
-	std::vector<Path>                    _includePaths;
-	std::map<std::string, Template::Ptr> _cache;
-	mutable Logger::Ptr                  _pLogger;
+	Template::Ptr loadTemplate(const Path& templatePath, const std::string& templatePathname);
+
+	static TemplateCache*              _pInstance;
+	std::vector<Path>                  _includePaths;
+	EntryMap                           _cache;
+	std::map<std::string, std::string> _resolved;
+	Timespan                           _checkInterval;
+	mutable Logger::Ptr                _pLogger;
 };
 
 
@@ -84,6 +115,19 @@ private:
 inline void TemplateCache::addPath(const Path& path)
 {
 	_includePaths.push_back(path);
+	_resolved.clear();
+}
+
+
+inline void TemplateCache::setCheckInterval(const Timespan& interval)
+{
+	_checkInterval = interval;
+}
+
+
+inline const Timespan& TemplateCache::getCheckInterval() const
+{
+	return _checkInterval;
 }
 
 
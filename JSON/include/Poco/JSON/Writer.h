@@ -0,0 +1,233 @@
+//
+// Writer.h
+//
+// Library: JSON
+// Package: JSON
+// Module:  Writer
+//
+// Definition of the Writer class.
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef JSON_Writer_INCLUDED
+#define JSON_Writer_INCLUDED
+
+
+#include "Poco/JSON/JSON.h"
+#include "Poco/Dynamic/Var.h"
+#include "Poco/Buffer.h"
+#include <ostream>
+#include <string>
+#include <vector>
+
+
+namespace Poco {
+namespace JSON {
+
+
+class Object;
+class Array;
+
+
+class JSON_API Writer
+	/// A low-level, streaming writer for JSON text.
+	///
+	/// The document is written through a sequence of calls, without
+	/// building Object or Array instances first:
+	///
+	///     Writer writer(response.send());
+	///     writer.startObject();
+	///     writer.key("name");
+	///     writer.value("Homer");
+	///     writer.key("children");
+	///     writer.startArray();
+	///     writer.value("Bart");
+	///     writer.value("Lisa");
+	///     writer.endArray();
+	///     writer.endObject();
+	///     writer.flush();
+	///
+	/// Output is formatted directly into an internal buffer, which is
+	/// passed on to the target stream or string when it is full, and
+	/// when flush() is called. Strings are escaped in runs of 16 bytes
+	/// with SSE2 instructions where available, integers are formatted
+	/// without temporary strings, and floating-point numbers are
+	/// formatted with the shortest representation that round-trips.
+	/// Escaping matches that of Stringifier.
+	///
+	/// The Writer checks that calls are properly nested, and throws
+	/// a JSONException otherwise. Several values written at the top
+	/// level are separated by newlines, as in JSON Lines (NDJSON).
+	/// Use endLine() to terminate each of them with a newline instead.
+	///
+	/// A Writer is not thread-safe.
+{
+public:
+	enum
+	{
+		DEFAULT_BUFFER_SIZE = 8192
+	};
+
+	Writer(std::ostream& out, int options = 0, unsigned int indent = 0);
+		/// Creates a Writer that writes to the given stream.
+		///
+		/// If options contains JSON_ESCAPE_UNICODE, all non-ASCII
+		/// characters are escaped. If indent is greater than 0, every
+		/// member and element is written on a separate line, indented
+		/// by the given number of spaces per nesting level. Otherwise,
+		/// no whitespace is written.
+
+	Writer(std::string& str, int options = 0, unsigned int indent = 0);
+		/// Creates a Writer that appends to the given string.
+
+	~Writer();
+		/// Flushes the buffer and destroys the Writer.
+
+	void startObject();
+		/// Writes the start of an object.
+
+	void endObject();
+		/// Writes the end of the current object.
+
+	void startArray();
+		/// Writes the start of an array.
+
+	void endArray();
+		/// Writes the end of the current array.
+
+	void key(const std::string& name);
+		/// Writes the name of the next member of the current object.
+
+	void key(const char* name);
+		/// Writes the name of the next member of the current object.
+
+	void key(const char* name, std::size_t length);
+		/// Writes the name of the next member of the current object.
+
+	void value(const std::string& value);
+		/// Writes a string.
+
+	void value(const char* value);
+		/// Writes a string.
+
+	void value(const char* value, std::size_t length);
+		/// Writes a string.
+
+	void value(int v);
+		/// Writes an integer.
+
+	void value(unsigned v);
+		/// Writes an unsigned integer.
+
+#if defined(POCO_HAVE_INT64)
+	void value(Int64 v);
+		/// Writes a 64-bit integer.
+
+	void value(UInt64 v);
+		/// Writes an unsigned 64-bit integer.
+#endif
+
+	void value(double d);
+		/// Writes a floating-point number.
+		///
+		/// Since JSON cannot represent infinity and NaN,
+		/// these are written as null.
+
+	void value(float f);
+		/// Writes a floating-point number, using the shortest
+		/// representation for single precision.
+		/// Infinity and NaN are written as null.
+
+	void value(bool b);
+		/// Writes true or false.
+
+	void value(const Object& object);
+		/// Writes the given object with all its members.
+
+	void value(const Array& array);
+		/// Writes the given array with all its elements.
+
+	void value(const Dynamic::Var& value);
+		/// Writes the given value, which can hold an Object, an Array
+		/// (or pointers to them), a number, a string, or any other
+		/// type convertible to a string. An empty Var is written as null.
+		///
+		/// Produces the same output as Stringifier::condense().
+
+	void null();
+		/// Writes null.
+
+	void endLine();
+		/// Writes a newline after a complete top-level value.
+		/// The next top-level value will not be preceded by
+		/// another newline.
+
+	void flush();
+		/// Passes the buffered output to the stream or string.
+		/// For streams, the stream itself is not flushed.
+
+	int depth() const;
+		/// Returns the number of objects and arrays
+		/// that have been started, but not ended.
+
+private:
+	Writer(const Writer&);
+	Writer& operator = (const Writer&);
+
+	void init(int options, unsigned int indent);
+	void beforeValue();
+	void afterValue();
+	void beforeEnd(char type);
+	void newLine(std::size_t level);
+	void writeString(const char* str, std::size_t length);
+	void writeEscaped(const char* p, const char* end);
+	void writeInteger(UInt64 v, bool negative);
+	void writeRaw(const char* str, std::size_t length);
+	void writeChar(char c);
+	void reserve(std::size_t length);
+	void flushBuffer();
+
+	std::ostream*     _pStream;
+	std::string*      _pString;
+	Buffer<char>      _buffer;
+	char*             _pPos;
+	char*             _pEnd;
+	std::vector<char> _stack;
+	unsigned int      _indent;
+	bool              _escapeUnicode;
+	bool              _first;
+	bool              _afterKey;
+};
+
+
+//
+// inlines
+//
+inline int Writer::depth() const
+{
+	return static_cast<int>(_stack.size());
+}
+
+
+inline void Writer::reserve(std::size_t length)
+{
+	if (static_cast<std::size_t>(_pEnd - _pPos) < length) flushBuffer();
+}
+
+
+inline void Writer::writeChar(char c)
+{
+	if (_pPos == _pEnd) flushBuffer();
+	*_pPos++ = c;
+}
+
+
+} } // namespace Poco::JSON
+
+
+#endif // JSON_Writer_INCLUDED
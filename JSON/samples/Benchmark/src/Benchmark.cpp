@@ -12,6 +12,7 @@
 
 #include "Poco/JSON/Parser.h"
 #include "Poco/JSON/ParseHandler.h"
+#include "Poco/JSON/Document.h"
 #include "Poco/JSON/JSONException.h"
 #include "Poco/Environment.h"
 #include "Poco/Path.h"
@@ -21,6 +22,34 @@
 #include "Poco/Stopwatch.h"
 #include <iostream>
 #include <iomanip>
+#include <cstdlib>
+#include <new>
+
+
+static std::size_t allocations = 0;
+
+
+void* operator new(std::size_t size)
+	/// Counts all allocations, to compare Object storage policies.
+{
+	++allocations;
+	void* p = std::malloc(size ? size : 1);
+	if (!p) throw std::bad_alloc();
+	return p;
+}
+
+
+void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+
+
+double throughput(std::size_t bytes, Poco::Timestamp::TimeDiff elapsed)
+	/// Returns the throughput in GB/s.
+{
+	return elapsed > 0 ? static_cast<double>(bytes)/(elapsed*1000.0) : 0.0;
+}
 
 
 int main(int argc, char** argv)
@@ -61,7 +90,24 @@ int main(int argc, char** argv)
 	sparser.parse(jsonStr);
 	sw.stop();
 	std::cout << "---------------------------------" << std::endl;
-	std::cout << "[std::string] parsed in " << sw.elapsed() << " [us]" << std::endl;
+	std::cout << "[std::string] parsed in " << sw.elapsed() << " [us], " << throughput(jsonStr.size(), sw.elapsed()) << " [GB/s]" << std::endl;
+	std::cout << "---------------------------------" << std::endl;
+
+	Poco::JSON::Parser xparser(0);
+	xparser.setIndexed(true);
+	sw.restart();
+	xparser.parse(jsonStr);
+	sw.stop();
+	std::cout << "---------------------------------" << std::endl;
+	std::cout << "[indexed] parsed in " << sw.elapsed() << " [us], " << throughput(jsonStr.size(), sw.elapsed()) << " [GB/s]" << std::endl;
+	std::cout << "---------------------------------" << std::endl;
+
+	Poco::JSON::Document doc;
+	sw.restart();
+	doc.parse(jsonStr.data(), jsonStr.size());
+	sw.stop();
+	std::cout << "---------------------------------" << std::endl;
+	std::cout << "[Document] parsed in " << sw.elapsed() << " [us], " << throughput(jsonStr.size(), sw.elapsed()) << " [GB/s]" << std::endl;
 	std::cout << "---------------------------------" << std::endl;
 
 	Poco::JSON::Parser iparser(0);
@@ -82,7 +128,17 @@ int main(int argc, char** argv)
 		Poco::DynamicAny result = sparser.result();
 		sw.stop();
 		std::cout << "-----------------------------------------" << std::endl;
-		std::cout << "[std::string] parsed/handled in " << sw.elapsed() << " [us]" << std::endl;
+		std::cout << "[std::string] parsed/handled in " << sw.elapsed() << " [us], " << throughput(jsonStr.size(), sw.elapsed()) << " [GB/s]" << std::endl;
+		std::cout << "-----------------------------------------" << std::endl;
+
+		Poco::JSON::Parser xsparser;
+		xsparser.setIndexed(true);
+		sw.restart();
+		xsparser.parse(jsonStr);
+		result = xsparser.result();
+		sw.stop();
+		std::cout << "-----------------------------------------" << std::endl;
+		std::cout << "[indexed] parsed/handled in " << sw.elapsed() << " [us], " << throughput(jsonStr.size(), sw.elapsed()) << " [GB/s]" << std::endl;
 		std::cout << "-----------------------------------------" << std::endl;
 
 		Poco::JSON::Parser isparser;
@@ -114,5 +170,26 @@ int main(int argc, char** argv)
 		std::cout << jsone.message() << std::endl;
 	}
 
+	std::cout << std::endl << "POCO JSON Object storage" << std::endl;
+	try
+	{
+		for (int flat = 0; flat < 2; ++flat)
+		{
+			Poco::JSON::Parser parser(new Poco::JSON::ParseHandler(false, flat != 0));
+			std::size_t count = allocations;
+			sw.restart();
+			parser.parse(jsonStr);
+			Poco::DynamicAny result = parser.result();
+			sw.stop();
+			std::cout << "-----------------------------------------" << std::endl;
+			std::cout << (flat ? "[flat] " : "[map] ") << "parsed/handled in " << sw.elapsed() << " [us], " << (allocations - count) << " allocations" << std::endl;
+			std::cout << "-----------------------------------------" << std::endl;
+		}
+	}
+	catch(Poco::JSON::JSONException jsone)
+	{
+		std::cout << jsone.message() << std::endl;
+	}
+
 	return 0;
 }
@@ -15,6 +15,7 @@
 #include "Poco/JSON/Array.h"
 #include "Poco/JSON/Object.h"
 #include "Poco/JSON/Stringifier.h"
+#include "Poco/JSON/Writer.h"
 #include "Poco/JSONString.h"
 
 
@@ -155,6 +156,14 @@ void Array::stringify(std::ostream& out, unsigned int indent, int step) const
 
 	if (step == -1) step = indent;
 
+	if (indent == 0 && step == 0)
+	{
+		Writer writer(out, options);
+		writer.value(*this);
+		writer.flush();
+		return;
+	}
+
 	out << "[";
 
 	if (indent > 0) out << std::endl;
@@ -0,0 +1,471 @@
+//
+// CBORParser.cpp
+//
+// Library: JSON
+// Package: JSON
+// Module:  CBORParser
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/JSON/CBORParser.h"
+#include "Poco/JSON/JSONException.h"
+#include "Poco/NumberFormatter.h"
+#include "Poco/ByteOrder.h"
+#include <limits>
+#include <cstring>
+#include <cmath>
+
+
+namespace
+{
+	enum
+	{
+		MAJOR_UNSIGNED = 0,
+		MAJOR_NEGATIVE = 1,
+		MAJOR_BYTES    = 2,
+		MAJOR_TEXT     = 3,
+		MAJOR_ARRAY    = 4,
+		MAJOR_MAP      = 5,
+		MAJOR_TAG      = 6,
+		MAJOR_SIMPLE   = 7
+	};
+
+	const unsigned char INFO_INDEFINITE = 31;
+	const unsigned char CBOR_BREAK      = 0xFF;
+	const std::size_t   READ_CHUNK_SIZE = 65536;
+
+
+	double halfToDouble(Poco::UInt16 half)
+	{
+		int exponent = (half >> 10) & 0x1F;
+		int mantissa = half & 0x3FF;
+		double value;
+		if (exponent == 0)
+			value = std::ldexp(static_cast<double>(mantissa), -24);
+		else if (exponent != 31)
+			value = std::ldexp(static_cast<double>(mantissa + 1024), exponent - 25);
+		else if (mantissa == 0)
+			value = std::numeric_limits<double>::infinity();
+		else
+			value = std::numeric_limits<double>::quiet_NaN();
+		return (half & 0x8000) ? -value : value;
+	}
+}
+
+
+namespace Poco {
+namespace JSON {
+
+
+CBORParser::CBORParser(const Handler::Ptr& pHandler):
+	_pHandler(pHandler),
+	_depth(JSON_UNLIMITED_DEPTH),
+	_scalar(false),
+	_pPos(0),
+	_pEnd(0),
+	_pStreamBuf(0)
+{
+}
+
+
+CBORParser::~CBORParser()
+{
+}
+
+
+void CBORParser::reset()
+{
+	_stack.clear();
+	_value.empty();
+	_scalar = false;
+	if (_pHandler) _pHandler->reset();
+}
+
+
+Dynamic::Var CBORParser::parse(const std::string& data)
+{
+	return parse(data.data(), data.size());
+}
+
+
+Dynamic::Var CBORParser::parse(const char* data, std::size_t length)
+{
+	_pPos = data;
+	_pEnd = data + length;
+	_pStreamBuf = 0;
+	parseValue();
+	if (_pPos != _pEnd)
+		throw JSONException("CBOR: data after the end of the value");
+
+	return asVar();
+}
+
+
+Dynamic::Var CBORParser::parse(std::istream& in)
+{
+	_pPos = 0;
+	_pEnd = 0;
+	_pStreamBuf = in.rdbuf();
+	parseValue();
+	_pStreamBuf = 0;
+
+	return asVar();
+}
+
+
+void CBORParser::parseValue()
+{
+	poco_check_ptr (_pHandler);
+
+	_stack.clear();
+	_value.empty();
+	_scalar = false;
+	do
+	{
+		if (!_stack.empty() && !_stack.back().indefinite && _stack.back().remaining == 0)
+		{
+			endContainer();
+			continue;
+		}
+
+		unsigned char initial = readByte();
+		if (initial == CBOR_BREAK)
+		{
+			if (_stack.empty() || !_stack.back().indefinite)
+				throw JSONException("CBOR: unexpected break");
+			if (_stack.back().object && !_stack.back().expectKey)
+				throw JSONException("CBOR: map key without value");
+			endContainer();
+		}
+		else if (!_stack.empty() && _stack.back().object && _stack.back().expectKey)
+		{
+			parseKey(initial);
+			_stack.back().expectKey = false;
+		}
+		else
+		{
+			parseItem(initial);
+		}
+	}
+	while (!_stack.empty());
+}
+
+
+void CBORParser::parseItem(unsigned char initial)
+{
+	while ((initial >> 5) == MAJOR_TAG)
+	{
+		readArgument(initial & 0x1F);
+		initial = readByte();
+	}
+
+	if (!_stack.empty())
+	{
+		Frame& parent = _stack.back();
+		if (parent.object) parent.expectKey = true;
+		if (!parent.indefinite) --parent.remaining;
+	}
+
+	unsigned char info = initial & 0x1F;
+	switch (initial >> 5)
+	{
+	case MAJOR_UNSIGNED:
+		reportUnsigned(readArgument(info));
+		break;
+	case MAJOR_NEGATIVE:
+		reportNegative(readArgument(info));
+		break;
+	case MAJOR_BYTES:
+	case MAJOR_TEXT:
+		parseString(initial, _string);
+		report(_string);
+		break;
+	case MAJOR_ARRAY:
+		startContainer(false, info);
+		break;
+	case MAJOR_MAP:
+		startContainer(true, info);
+		break;
+	default:
+		parseFloat(info);
+		break;
+	}
+}
+
+
+void CBORParser::parseKey(unsigned char initial)
+{
+	while ((initial >> 5) == MAJOR_TAG)
+	{
+		readArgument(initial & 0x1F);
+		initial = readByte();
+	}
+
+	switch (initial >> 5)
+	{
+	case MAJOR_UNSIGNED:
+		_string.clear();
+		NumberFormatter::append(_string, readArgument(initial & 0x1F));
+		break;
+	case MAJOR_NEGATIVE:
+		{
+			UInt64 n = readArgument(initial & 0x1F);
+			if (n > static_cast<UInt64>(std::numeric_limits<Int64>::max()))
+				throw JSONException("CBOR: negative integer out of range");
+			_string.clear();
+			NumberFormatter::append(_string, -1 - static_cast<Int64>(n));
+		}
+		break;
+	case MAJOR_BYTES:
+	case MAJOR_TEXT:
+		parseString(initial, _string);
+		break;
+	default:
+		throw JSONException("CBOR: unsupported map key type");
+	}
+	_pHandler->key(_string);
+}
+
+
+void CBORParser::parseFloat(unsigned char info)
+{
+	switch (info)
+	{
+	case 20:
+		report(false);
+		break;
+	case 21:
+		report(true);
+		break;
+	case 22:
+	case 23:
+		reportNull();
+		break;
+	case 25:
+		report(halfToDouble(static_cast<UInt16>(readArgument(info))));
+		break;
+	case 26:
+		{
+			UInt32 bits = static_cast<UInt32>(readArgument(info));
+			float f;
+			std::memcpy(&f, &bits, sizeof(f));
+			report(static_cast<double>(f));
+		}
+		break;
+	case 27:
+		{
+			UInt64 bits = readArgument(info);
+			double d;
+			std::memcpy(&d, &bits, sizeof(d));
+			report(d);
+		}
+		break;
+	default:
+		throw JSONException("CBOR: unsupported simple value");
+	}
+}
+
+
+void CBORParser::parseString(unsigned char initial, std::string& str)
+{
+	str.clear();
+	unsigned char info = initial & 0x1F;
+	if (info == INFO_INDEFINITE)
+	{
+		// A sequence of definite-length chunks of the same type.
+		for (;;)
+		{
+			unsigned char chunk = readByte();
+			if (chunk == CBOR_BREAK) break;
+			if ((chunk >> 5) != (initial >> 5) || (chunk & 0x1F) == INFO_INDEFINITE)
+				throw JSONException("CBOR: invalid string chunk");
+			read(str, readArgument(chunk & 0x1F));
+		}
+	}
+	else
+	{
+		read(str, readArgument(info));
+	}
+}
+
+
+void CBORParser::startContainer(bool object, unsigned char info)
+{
+	if (_depth >= 0 && _stack.size() >= static_cast<std::size_t>(_depth))
+		throw JSONException("Maximum depth exceeded");
+
+	Frame frame;
+	frame.object = object;
+	frame.expectKey = object;
+	if (info == INFO_INDEFINITE)
+	{
+		frame.indefinite = true;
+		frame.remaining = 0;
+	}
+	else
+	{
+		frame.indefinite = false;
+		frame.remaining = readArgument(info);
+	}
+
+	if (object)
+		_pHandler->startObject();
+	else
+		_pHandler->startArray();
+	_stack.push_back(frame);
+}
+
+
+void CBORParser::endContainer()
+{
+	if (_stack.back().object)
+		_pHandler->endObject();
+	else
+		_pHandler->endArray();
+	_stack.pop_back();
+}
+
+
+template <typename T>
+void CBORParser::report(const T& value)
+{
+	if (_stack.empty())
+	{
+		_value = value;
+		_scalar = true;
+	}
+	else _pHandler->value(value);
+}
+
+
+void CBORParser::reportNull()
+{
+	if (_stack.empty())
+	{
+		_value.empty();
+		_scalar = true;
+	}
+	else _pHandler->null();
+}
+
+
+void CBORParser::reportUnsigned(UInt64 v)
+{
+	if (v <= static_cast<UInt64>(std::numeric_limits<int>::max()))
+		report(static_cast<int>(v));
+	else if (v <= std::numeric_limits<unsigned>::max())
+		report(static_cast<unsigned>(v));
+	else if (v <= static_cast<UInt64>(std::numeric_limits<Int64>::max()))
+		report(static_cast<Int64>(v));
+	else
+		report(v);
+}
+
+
+void CBORParser::reportNegative(UInt64 n)
+{
+	// The value is -1 - n.
+	if (n > static_cast<UInt64>(std::numeric_limits<Int64>::max()))
+		throw JSONException("CBOR: negative integer out of range");
+
+	Int64 v = -1 - static_cast<Int64>(n);
+	if (v >= std::numeric_limits<int>::min())
+		report(static_cast<int>(v));
+	else
+		report(v);
+}
+
+
+UInt64 CBORParser::readArgument(unsigned char info)
+{
+	if (info < 24) return info;
+
+	switch (info)
+	{
+	case 24:
+		return readByte();
+	case 25:
+		{
+			UInt16 v;
+			read(reinterpret_cast<char*>(&v), sizeof(v));
+			return ByteOrder::fromBigEndian(v);
+		}
+	case 26:
+		{
+			UInt32 v;
+			read(reinterpret_cast<char*>(&v), sizeof(v));
+			return ByteOrder::fromBigEndian(v);
+		}
+	case 27:
+		{
+			UInt64 v;
+			read(reinterpret_cast<char*>(&v), sizeof(v));
+			return ByteOrder::fromBigEndian(v);
+		}
+	default:
+		throw JSONException("CBOR: invalid additional information");
+	}
+}
+
+
+void CBORParser::read(char* buffer, std::size_t length)
+{
+	if (_pStreamBuf)
+	{
+		if (_pStreamBuf->sgetn(buffer, static_cast<std::streamsize>(length)) != static_cast<std::streamsize>(length))
+			throw JSONException("CBOR: unexpected end of input");
+	}
+	else
+	{
+		if (static_cast<std::size_t>(_pEnd - _pPos) < length)
+			throw JSONException("CBOR: unexpected end of input");
+		std::memcpy(buffer, _pPos, length);
+		_pPos += length;
+	}
+}
+
+
+void CBORParser::read(std::string& str, UInt64 length)
+{
+	if (_pStreamBuf)
+	{
+		// Read large strings in chunks, so that a bogus length
+		// does not allocate more memory than the input provides.
+		while (length > 0)
+		{
+			std::size_t n = length < READ_CHUNK_SIZE ? static_cast<std::size_t>(length) : READ_CHUNK_SIZE;
+			std::size_t size = str.size();
+			str.resize(size + n);
+			if (_pStreamBuf->sgetn(&str[size], static_cast<std::streamsize>(n)) != static_cast<std::streamsize>(n))
+				throw JSONException("CBOR: unexpected end of input");
+			length -= n;
+		}
+	}
+	else
+	{
+		if (static_cast<UInt64>(_pEnd - _pPos) < length)
+			throw JSONException("CBOR: unexpected end of input");
+		str.append(_pPos, static_cast<std::size_t>(length));
+		_pPos += length;
+	}
+}
+
+
+unsigned char CBORParser::underflow()
+{
+	if (_pStreamBuf)
+	{
+		std::streambuf::int_type c = _pStreamBuf->sbumpc();
+		if (c != std::streambuf::traits_type::eof())
+			return static_cast<unsigned char>(c);
+	}
+	throw JSONException("CBOR: unexpected end of input");
+}
+
+
+} } // namespace Poco::JSON
@@ -0,0 +1,482 @@
+//
+// CBORWriter.cpp
+//
+// Library: JSON
+// Package: JSON
+// Module:  CBORWriter
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/JSON/CBORWriter.h"
+#include "Poco/JSON/Object.h"
+#include "Poco/JSON/Array.h"
+#include "Poco/JSON/JSONException.h"
+#include "Poco/ByteOrder.h"
+#include <cstring>
+#include <cfloat>
+
+
+namespace
+{
+	enum
+	{
+		MAJOR_UNSIGNED = 0,
+		MAJOR_NEGATIVE = 1,
+		MAJOR_BYTES    = 2,
+		MAJOR_TEXT     = 3,
+		MAJOR_ARRAY    = 4,
+		MAJOR_MAP      = 5
+	};
+
+	const char CBOR_FALSE           = '\xF4';
+	const char CBOR_TRUE            = '\xF5';
+	const char CBOR_NULL            = '\xF6';
+	const char CBOR_FLOAT           = '\xFA';
+	const char CBOR_DOUBLE          = '\xFB';
+	const char CBOR_ARRAY_UNKNOWN   = '\x9F';
+	const char CBOR_MAP_UNKNOWN     = '\xBF';
+	const char CBOR_BREAK           = '\xFF';
+
+
+	bool isSingle(double d)
+		/// Returns true if d can be written in single precision
+		/// without changing its value.
+	{
+		if (d != d) return true;
+		if (d < -DBL_MAX || d > DBL_MAX) return true;
+		return d >= -FLT_MAX && d <= FLT_MAX && static_cast<double>(static_cast<float>(d)) == d;
+	}
+}
+
+
+namespace Poco {
+namespace JSON {
+
+
+const std::string CBORWriter::MEDIA_TYPE("application/cbor");
+const std::size_t CBORWriter::UNKNOWN_SIZE;
+
+
+CBORWriter::CBORWriter(std::ostream& out):
+	_pStream(&out),
+	_pOut(&_buffer)
+{
+	_buffer.reserve(DEFAULT_BUFFER_SIZE);
+}
+
+
+CBORWriter::CBORWriter(std::string& str):
+	_pStream(0),
+	_pOut(&str)
+{
+}
+
+
+CBORWriter::~CBORWriter()
+{
+	try
+	{
+		flush();
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
+}
+
+
+void CBORWriter::reset()
+{
+	_stack.clear();
+}
+
+
+void CBORWriter::startObject()
+{
+	start(true, UNKNOWN_SIZE);
+}
+
+
+void CBORWriter::startObject(std::size_t size)
+{
+	start(true, size);
+}
+
+
+void CBORWriter::endObject()
+{
+	end(true);
+}
+
+
+void CBORWriter::startArray()
+{
+	start(false, UNKNOWN_SIZE);
+}
+
+
+void CBORWriter::startArray(std::size_t size)
+{
+	start(false, size);
+}
+
+
+void CBORWriter::endArray()
+{
+	end(false);
+}
+
+
+void CBORWriter::key(const std::string& name)
+{
+	key(name.data(), name.size());
+}
+
+
+void CBORWriter::key(const char* name, std::size_t length)
+{
+	if (_stack.empty() || !_stack.back().object)
+		throw JSONException("CBORWriter: key outside of an object");
+
+	Frame& frame = _stack.back();
+	if (frame.afterKey)
+		throw JSONException("CBORWriter: key without value");
+	if (frame.count == frame.size)
+		throw JSONException("CBORWriter: more members than the size of the object");
+
+	writeHead(MAJOR_TEXT, length);
+	_pOut->append(name, length);
+	frame.afterKey = true;
+}
+
+
+void CBORWriter::null()
+{
+	beforeValue();
+	_pOut->push_back(CBOR_NULL);
+	afterValue();
+}
+
+
+void CBORWriter::value(int v)
+{
+	writeInteger(v);
+}
+
+
+void CBORWriter::value(unsigned v)
+{
+	beforeValue();
+	writeHead(MAJOR_UNSIGNED, v);
+	afterValue();
+}
+
+
+#if defined(POCO_HAVE_INT64)
+
+
+void CBORWriter::value(Int64 v)
+{
+	writeInteger(v);
+}
+
+
+void CBORWriter::value(UInt64 v)
+{
+	beforeValue();
+	writeHead(MAJOR_UNSIGNED, v);
+	afterValue();
+}
+
+
+#endif
+
+
+void CBORWriter::value(const std::string& value)
+{
+	this->value(value.data(), value.size());
+}
+
+
+void CBORWriter::value(const char* value)
+{
+	this->value(value, std::strlen(value));
+}
+
+
+void CBORWriter::value(const char* value, std::size_t length)
+{
+	beforeValue();
+	writeHead(MAJOR_TEXT, length);
+	_pOut->append(value, length);
+	afterValue();
+}
+
+
+void CBORWriter::value(double d)
+{
+	if (isSingle(d))
+	{
+		value(static_cast<float>(d));
+	}
+	else
+	{
+		beforeValue();
+		UInt64 bits;
+		std::memcpy(&bits, &d, sizeof(bits));
+		bits = ByteOrder::toBigEndian(bits);
+		_pOut->push_back(CBOR_DOUBLE);
+		_pOut->append(reinterpret_cast<const char*>(&bits), sizeof(bits));
+		afterValue();
+	}
+}
+
+
+void CBORWriter::value(float f)
+{
+	beforeValue();
+	UInt32 bits;
+	std::memcpy(&bits, &f, sizeof(bits));
+	bits = ByteOrder::toBigEndian(bits);
+	_pOut->push_back(CBOR_FLOAT);
+	_pOut->append(reinterpret_cast<const char*>(&bits), sizeof(bits));
+	afterValue();
+}
+
+
+void CBORWriter::value(bool b)
+{
+	beforeValue();
+	_pOut->push_back(b ? CBOR_TRUE : CBOR_FALSE);
+	afterValue();
+}
+
+
+void CBORWriter::value(const Object& object)
+{
+	startObject(object.size());
+	object.forEach([this](const std::string& name, const Dynamic::Var& v)
+	{
+		key(name);
+		value(v);
+	});
+	endObject();
+}
+
+
+void CBORWriter::value(const Array& array)
+{
+	startArray(array.size());
+	for (Array::ConstIterator it = array.begin(); it != array.end(); ++it)
+	{
+		value(*it);
+	}
+	endArray();
+}
+
+
+void CBORWriter::value(const Dynamic::Var& any)
+{
+	const std::type_info& type = any.type();
+	if (type == typeid(Object::Ptr))
+	{
+		value(*any.extract<Object::Ptr>());
+	}
+	else if (type == typeid(Array::Ptr))
+	{
+		value(*any.extract<Array::Ptr>());
+	}
+	else if (type == typeid(Object))
+	{
+		value(any.extract<Object>());
+	}
+	else if (type == typeid(Array))
+	{
+		value(any.extract<Array>());
+	}
+	else if (any.isEmpty())
+	{
+		null();
+	}
+	else if (type == typeid(std::string))
+	{
+		value(any.extract<std::string>());
+	}
+	else if (type == typeid(double))
+	{
+		value(any.extract<double>());
+	}
+	else if (type == typeid(float))
+	{
+		value(any.extract<float>());
+	}
+	else if (type == typeid(bool))
+	{
+		value(any.extract<bool>());
+	}
+	else if (type == typeid(char))
+	{
+		char c = any.extract<char>();
+		value(&c, 1);
+	}
+	else if (any.isInteger())
+	{
+		if (any.isSigned())
+		{
+			writeInteger(any.convert<Int64>());
+		}
+		else
+		{
+			beforeValue();
+			writeHead(MAJOR_UNSIGNED, any.convert<UInt64>());
+			afterValue();
+		}
+	}
+	else if (any.isNumeric())
+	{
+		value(any.convert<double>());
+	}
+	else
+	{
+		value(any.convert<std::string>());
+	}
+}
+
+
+void CBORWriter::binary(const void* data, std::size_t length)
+{
+	beforeValue();
+	writeHead(MAJOR_BYTES, length);
+	_pOut->append(static_cast<const char*>(data), length);
+	afterValue();
+}
+
+
+void CBORWriter::flush()
+{
+	if (_pStream && !_buffer.empty())
+	{
+		_pStream->write(_buffer.data(), static_cast<std::streamsize>(_buffer.size()));
+		_buffer.clear();
+	}
+}
+
+
+void CBORWriter::beforeValue()
+{
+	if (_stack.empty()) return;
+
+	Frame& frame = _stack.back();
+	if (frame.object)
+	{
+		if (!frame.afterKey) throw JSONException("CBORWriter: object member without key");
+		frame.afterKey = false;
+	}
+	else if (frame.count == frame.size)
+	{
+		throw JSONException("CBORWriter: more elements than the size of the array");
+	}
+	++frame.count;
+}
+
+
+void CBORWriter::afterValue()
+{
+	if (_pStream && _buffer.size() >= DEFAULT_BUFFER_SIZE) flush();
+}
+
+
+void CBORWriter::start(bool object, std::size_t size)
+{
+	beforeValue();
+	if (size == UNKNOWN_SIZE)
+		_pOut->push_back(object ? CBOR_MAP_UNKNOWN : CBOR_ARRAY_UNKNOWN);
+	else
+		writeHead(object ? MAJOR_MAP : MAJOR_ARRAY, size);
+
+	Frame frame;
+	frame.size = size;
+	frame.count = 0;
+	frame.object = object;
+	frame.afterKey = false;
+	_stack.push_back(frame);
+}
+
+
+void CBORWriter::end(bool object)
+{
+	if (_stack.empty() || _stack.back().object != object)
+		throw JSONException(object ? "CBORWriter: end of object without start" : "CBORWriter: end of array without start");
+
+	const Frame& frame = _stack.back();
+	if (frame.afterKey)
+		throw JSONException("CBORWriter: key without value");
+
+	if (frame.size == UNKNOWN_SIZE)
+		_pOut->push_back(CBOR_BREAK);
+	else if (frame.count != frame.size)
+		throw JSONException(object ? "CBORWriter: fewer members than the size of the object" : "CBORWriter: fewer elements than the size of the array");
+
+	_stack.pop_back();
+	afterValue();
+}
+
+
+void CBORWriter::writeHead(unsigned char major, UInt64 argument)
+{
+	char head[9];
+	std::size_t length;
+	major <<= 5;
+	if (argument < 24)
+	{
+		head[0] = static_cast<char>(major | argument);
+		length = 1;
+	}
+	else if (argument <= 0xFF)
+	{
+		head[0] = static_cast<char>(major | 24);
+		head[1] = static_cast<char>(argument);
+		length = 2;
+	}
+	else if (argument <= 0xFFFF)
+	{
+		head[0] = static_cast<char>(major | 25);
+		UInt16 v = ByteOrder::toBigEndian(static_cast<UInt16>(argument));
+		std::memcpy(head + 1, &v, sizeof(v));
+		length = 3;
+	}
+	else if (argument <= 0xFFFFFFFF)
+	{
+		head[0] = static_cast<char>(major | 26);
+		UInt32 v = ByteOrder::toBigEndian(static_cast<UInt32>(argument));
+		std::memcpy(head + 1, &v, sizeof(v));
+		length = 5;
+	}
+	else
+	{
+		head[0] = static_cast<char>(major | 27);
+		UInt64 v = ByteOrder::toBigEndian(argument);
+		std::memcpy(head + 1, &v, sizeof(v));
+		length = 9;
+	}
+	_pOut->append(head, length);
+}
+
+
+void CBORWriter::writeInteger(Int64 v)
+{
+	beforeValue();
+	if (v >= 0)
+		writeHead(MAJOR_UNSIGNED, static_cast<UInt64>(v));
+	else
+		writeHead(MAJOR_NEGATIVE, static_cast<UInt64>(-1 - v));
+	afterValue();
+}
+
+
+} } // namespace Poco::JSON
@@ -0,0 +1,375 @@
+//
+// Document.cpp
+//
+// Library: JSON
+// Package: JSON
+// Module:  Document
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/JSON/Document.h"
+#include "Poco/JSON/ParseHandler.h"
+#include "Poco/JSON/JSONException.h"
+#include "Poco/StreamCopier.h"
+#include "Poco/Ascii.h"
+#include <limits>
+
+
+namespace Poco {
+namespace JSON {
+
+
+//
+// Document::Value
+//
+
+
+Document::Value::Value():
+	_pDoc(0),
+	_pos(0)
+{
+}
+
+
+Document::Value::Value(const Document* pDoc, std::size_t pos):
+	_pDoc(pDoc),
+	_pos(pos)
+{
+}
+
+
+void Document::Value::checkType(bool ok, const char* type) const
+{
+	if (!ok)
+	{
+		if (_pDoc)
+			throw BadCastException(std::string("JSON value is not ") + type);
+		else
+			throw BadCastException("Invalid JSON value");
+	}
+}
+
+
+bool Document::Value::getBool() const
+{
+	checkType(isBoolean(), "a boolean");
+
+	return type() == Tape::TYPE_TRUE;
+}
+
+
+Int64 Document::Value::getInt64() const
+{
+	checkType(isInteger(), "an integer");
+
+	if (type() == Tape::TYPE_INT64)
+		return _pDoc->_tape.getInt64(_pos);
+
+	UInt64 value = _pDoc->_tape.getUInt64(_pos);
+	if (value > static_cast<UInt64>(std::numeric_limits<Int64>::max()))
+		throw RangeException("JSON value out of range for Int64");
+	return static_cast<Int64>(value);
+}
+
+
+UInt64 Document::Value::getUInt64() const
+{
+	checkType(isInteger(), "an integer");
+
+	if (type() == Tape::TYPE_UINT64)
+		return _pDoc->_tape.getUInt64(_pos);
+
+	Int64 value = _pDoc->_tape.getInt64(_pos);
+	if (value < 0)
+		throw RangeException("JSON value out of range for UInt64");
+	return static_cast<UInt64>(value);
+}
+
+
+double Document::Value::getDouble() const
+{
+	checkType(isNumber(), "a number");
+
+	switch (type())
+	{
+	case Tape::TYPE_INT64:
+		return static_cast<double>(_pDoc->_tape.getInt64(_pos));
+	case Tape::TYPE_UINT64:
+		return static_cast<double>(_pDoc->_tape.getUInt64(_pos));
+	default:
+		return _pDoc->_tape.getDouble(_pos);
+	}
+}
+
+
+StringRef Document::Value::getString() const
+{
+	checkType(isString(), "a string");
+
+	std::size_t length;
+	const char* p = _pDoc->_tape.getString(_pos, length);
+	return StringRef(p, length);
+}
+
+
+std::size_t Document::Value::size() const
+{
+	std::size_t n = 0;
+	for (Iterator it = begin(), itEnd = end(); it != itEnd; ++it) ++n;
+	return n;
+}
+
+
+Document::Value Document::Value::get(const StringRef& name) const
+{
+	if (!isObject()) return Value();
+
+	const Tape& tape = _pDoc->_tape;
+	std::size_t pos = _pos + 1;
+	while (tape.type(pos) != Tape::TYPE_OBJECT_END)
+	{
+		if (tape.stringEquals(pos, name.data(), name.size()))
+			return Value(_pDoc, pos + 2);
+		pos = tape.next(pos + 2);
+	}
+	return Value();
+}
+
+
+Document::Value Document::Value::get(std::size_t index) const
+{
+	if (!isArray()) return Value();
+
+	const Tape& tape = _pDoc->_tape;
+	std::size_t pos = _pos + 1;
+	while (tape.type(pos) != Tape::TYPE_ARRAY_END)
+	{
+		if (index-- == 0) return Value(_pDoc, pos);
+		pos = tape.next(pos);
+	}
+	return Value();
+}
+
+
+Document::Value Document::Value::find(const std::string& path) const
+{
+	Value result = *this;
+	std::string::const_iterator it  = path.begin();
+	std::string::const_iterator end = path.end();
+	while (it != end && result.isValid())
+	{
+		std::string::const_iterator nameEnd = it;
+		while (nameEnd != end && *nameEnd != '.' && *nameEnd != '[') ++nameEnd;
+		if (nameEnd != it)
+		{
+			result = result.get(StringRef(&*it, nameEnd - it));
+		}
+		it = nameEnd;
+		while (it != end && *it == '[' && result.isValid())
+		{
+			++it;
+			std::size_t index = 0;
+			std::string::const_iterator digits = it;
+			while (it != end && Ascii::isDigit(*it))
+			{
+				index = index*10 + (*it - '0');
+				++it;
+			}
+			if (it == digits || it == end || *it != ']') return Value();
+			++it;
+			result = result.get(index);
+		}
+		if (it != end)
+		{
+			if (*it != '.') return Value();
+			++it;
+		}
+	}
+	return result;
+}
+
+
+Document::Iterator Document::Value::begin() const
+{
+	if (isObject())
+		return Iterator(_pDoc, _pos + 1, true);
+	else if (isArray())
+		return Iterator(_pDoc, _pos + 1, false);
+	else
+		return end();
+}
+
+
+Document::Iterator Document::Value::end() const
+{
+	if (isObject() || isArray())
+		return Iterator(_pDoc, _pDoc->_tape.next(_pos) - 1, isObject());
+	else
+		return Iterator(_pDoc, _pos, false);
+}
+
+
+Dynamic::Var Document::Value::asVar() const
+{
+	if (!_pDoc) return Dynamic::Var();
+
+	const Tape& tape = _pDoc->_tape;
+	switch (type())
+	{
+	case Tape::TYPE_OBJECT:
+	case Tape::TYPE_ARRAY:
+		{
+			ParseHandler handler(_pDoc->_preserveObjectOrder);
+			tape.emit(_pos, handler);
+			return handler.asVar();
+		}
+	case Tape::TYPE_STRING:
+		return getString().toString();
+	case Tape::TYPE_INT64:
+		return tape.getInt64(_pos);
+	case Tape::TYPE_UINT64:
+		return tape.getUInt64(_pos);
+	case Tape::TYPE_DOUBLE:
+		return tape.getDouble(_pos);
+	case Tape::TYPE_TRUE:
+		return true;
+	case Tape::TYPE_FALSE:
+		return false;
+	default:
+		return Dynamic::Var();
+	}
+}
+
+
+Object::Ptr Document::Value::asObject() const
+{
+	checkType(isObject(), "an object");
+
+	return asVar().extract<Object::Ptr>();
+}
+
+
+Array::Ptr Document::Value::asArray() const
+{
+	checkType(isArray(), "an array");
+
+	return asVar().extract<Array::Ptr>();
+}
+
+
+//
+// Document::Iterator
+//
+
+
+Document::Iterator::Iterator():
+	_pDoc(0),
+	_pos(0),
+	_object(false)
+{
+}
+
+
+Document::Iterator::Iterator(const Document* pDoc, std::size_t pos, bool object):
+	_pDoc(pDoc),
+	_pos(pos),
+	_object(object)
+{
+}
+
+
+//
+// Document
+//
+
+
+Document::Document():
+	_preserveObjectOrder(false)
+{
+}
+
+
+Document::Document(const std::string& json):
+	_json(json),
+	_preserveObjectOrder(false)
+{
+	parseImpl();
+}
+
+
+Document::Document(Arena& arena):
+	_tape(arena),
+	_preserveObjectOrder(false)
+{
+}
+
+
+Document::~Document()
+{
+}
+
+
+void Document::parse(const std::string& json)
+{
+	_json = json;
+	parseImpl();
+}
+
+
+void Document::parse(std::string&& json)
+{
+	_json = std::move(json);
+	parseImpl();
+}
+
+
+void Document::parse(std::istream& in)
+{
+	_json.clear();
+	StreamCopier::copyToString(in, _json);
+	parseImpl();
+}
+
+
+void Document::parse(const char* json, std::size_t length)
+{
+	_json.clear();
+	try
+	{
+		_tape.parse(json, length);
+	}
+	catch (...)
+	{
+		clear();
+		throw;
+	}
+}
+
+
+void Document::clear()
+{
+	_tape.clear();
+	_json.clear();
+}
+
+
+void Document::parseImpl()
+{
+	try
+	{
+		_tape.parse(_json.data(), _json.size());
+	}
+	catch (...)
+	{
+		clear();
+		throw;
+	}
+}
+
+
+} } // namespace Poco::JSON
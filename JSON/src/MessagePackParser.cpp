@@ -0,0 +1,452 @@
+//
+// MessagePackParser.cpp
+//
+// Library: JSON
+// Package: JSON
+// Module:  MessagePackParser
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/JSON/MessagePackParser.h"
+#include "Poco/JSON/JSONException.h"
+#include "Poco/NumberFormatter.h"
+#include <limits>
+#include <cstring>
+
+
+namespace
+{
+	const std::size_t READ_CHUNK_SIZE = 65536;
+}
+
+
+namespace Poco {
+namespace JSON {
+
+
+MessagePackParser::MessagePackParser(const Handler::Ptr& pHandler):
+	_pHandler(pHandler),
+	_depth(JSON_UNLIMITED_DEPTH),
+	_scalar(false),
+	_pPos(0),
+	_pEnd(0),
+	_pStreamBuf(0)
+{
+}
+
+
+MessagePackParser::~MessagePackParser()
+{
+}
+
+
+void MessagePackParser::reset()
+{
+	_stack.clear();
+	_value.empty();
+	_scalar = false;
+	if (_pHandler) _pHandler->reset();
+}
+
+
+Dynamic::Var MessagePackParser::parse(const std::string& data)
+{
+	return parse(data.data(), data.size());
+}
+
+
+Dynamic::Var MessagePackParser::parse(const char* data, std::size_t length)
+{
+	_pPos = data;
+	_pEnd = data + length;
+	_pStreamBuf = 0;
+	parseValue();
+	if (_pPos != _pEnd)
+		throw JSONException("MessagePack: data after the end of the value");
+
+	return asVar();
+}
+
+
+Dynamic::Var MessagePackParser::parse(std::istream& in)
+{
+	_pPos = 0;
+	_pEnd = 0;
+	_pStreamBuf = in.rdbuf();
+	parseValue();
+	_pStreamBuf = 0;
+
+	return asVar();
+}
+
+
+void MessagePackParser::parseValue()
+{
+	poco_check_ptr (_pHandler);
+
+	_stack.clear();
+	_value.empty();
+	_scalar = false;
+	do
+	{
+		if (!_stack.empty() && _stack.back().remaining == 0)
+		{
+			endContainer();
+			continue;
+		}
+
+		unsigned char type = readByte();
+		if (!_stack.empty() && _stack.back().object && _stack.back().expectKey)
+		{
+			parseKey(type);
+			_stack.back().expectKey = false;
+		}
+		else
+		{
+			parseItem(type);
+		}
+	}
+	while (!_stack.empty());
+}
+
+
+void MessagePackParser::parseItem(unsigned char type)
+{
+	if (!_stack.empty())
+	{
+		Frame& parent = _stack.back();
+		if (parent.object) parent.expectKey = true;
+		--parent.remaining;
+	}
+
+	if (type <= 0x7F)
+	{
+		report(static_cast<int>(type));
+	}
+	else if (type <= 0x8F)
+	{
+		startContainer(true, type & 0x0F);
+	}
+	else if (type <= 0x9F)
+	{
+		startContainer(false, type & 0x0F);
+	}
+	else if (type <= 0xBF)
+	{
+		_string.clear();
+		read(_string, type & 0x1F);
+		report(_string);
+	}
+	else if (type >= 0xE0)
+	{
+		report(static_cast<int>(static_cast<signed char>(type)));
+	}
+	else switch (type)
+	{
+	case 0xC0:
+		reportNull();
+		break;
+	case 0xC2:
+		report(false);
+		break;
+	case 0xC3:
+		report(true);
+		break;
+	case 0xC4: // bin 8
+	case 0xD9: // str 8
+		_string.clear();
+		read(_string, readUnsigned(1));
+		report(_string);
+		break;
+	case 0xC5: // bin 16
+	case 0xDA: // str 16
+		_string.clear();
+		read(_string, readUnsigned(2));
+		report(_string);
+		break;
+	case 0xC6: // bin 32
+	case 0xDB: // str 32
+		_string.clear();
+		read(_string, readUnsigned(4));
+		report(_string);
+		break;
+	case 0xCA:
+		{
+			UInt32 bits = static_cast<UInt32>(readUnsigned(4));
+			float f;
+			std::memcpy(&f, &bits, sizeof(f));
+			report(static_cast<double>(f));
+		}
+		break;
+	case 0xCB:
+		{
+			UInt64 bits = readUnsigned(8);
+			double d;
+			std::memcpy(&d, &bits, sizeof(d));
+			report(d);
+		}
+		break;
+	case 0xCC:
+		reportUnsigned(readUnsigned(1));
+		break;
+	case 0xCD:
+		reportUnsigned(readUnsigned(2));
+		break;
+	case 0xCE:
+		reportUnsigned(readUnsigned(4));
+		break;
+	case 0xCF:
+		reportUnsigned(readUnsigned(8));
+		break;
+	case 0xD0:
+		reportSigned(readSigned(1));
+		break;
+	case 0xD1:
+		reportSigned(readSigned(2));
+		break;
+	case 0xD2:
+		reportSigned(readSigned(4));
+		break;
+	case 0xD3:
+		reportSigned(readSigned(8));
+		break;
+	case 0xDC:
+		startContainer(false, static_cast<UInt32>(readUnsigned(2)));
+		break;
+	case 0xDD:
+		startContainer(false, static_cast<UInt32>(readUnsigned(4)));
+		break;
+	case 0xDE:
+		startContainer(true, static_cast<UInt32>(readUnsigned(2)));
+		break;
+	case 0xDF:
+		startContainer(true, static_cast<UInt32>(readUnsigned(4)));
+		break;
+	case 0xC1:
+		throw JSONException("MessagePack: invalid type");
+	default:
+		throw JSONException("MessagePack: extension types are not supported");
+	}
+}
+
+
+void MessagePackParser::parseKey(unsigned char type)
+{
+	_string.clear();
+	if (type <= 0x7F)
+		NumberFormatter::append(_string, static_cast<int>(type));
+	else if (type >= 0xA0 && type <= 0xBF)
+		read(_string, type & 0x1F);
+	else if (type >= 0xE0)
+		NumberFormatter::append(_string, static_cast<int>(static_cast<signed char>(type)));
+	else switch (type)
+	{
+	case 0xC4:
+	case 0xD9:
+		read(_string, readUnsigned(1));
+		break;
+	case 0xC5:
+	case 0xDA:
+		read(_string, readUnsigned(2));
+		break;
+	case 0xC6:
+	case 0xDB:
+		read(_string, readUnsigned(4));
+		break;
+	case 0xCC:
+		NumberFormatter::append(_string, readUnsigned(1));
+		break;
+	case 0xCD:
+		NumberFormatter::append(_string, readUnsigned(2));
+		break;
+	case 0xCE:
+		NumberFormatter::append(_string, readUnsigned(4));
+		break;
+	case 0xCF:
+		NumberFormatter::append(_string, readUnsigned(8));
+		break;
+	case 0xD0:
+		NumberFormatter::append(_string, readSigned(1));
+		break;
+	case 0xD1:
+		NumberFormatter::append(_string, readSigned(2));
+		break;
+	case 0xD2:
+		NumberFormatter::append(_string, readSigned(4));
+		break;
+	case 0xD3:
+		NumberFormatter::append(_string, readSigned(8));
+		break;
+	default:
+		throw JSONException("MessagePack: unsupported map key type");
+	}
+	_pHandler->key(_string);
+}
+
+
+void MessagePackParser::startContainer(bool object, UInt32 size)
+{
+	if (_depth >= 0 && _stack.size() >= static_cast<std::size_t>(_depth))
+		throw JSONException("Maximum depth exceeded");
+
+	Frame frame;
+	frame.remaining = size;
+	frame.object = object;
+	frame.expectKey = object;
+
+	if (object)
+		_pHandler->startObject();
+	else
+		_pHandler->startArray();
+	_stack.push_back(frame);
+}
+
+
+void MessagePackParser::endContainer()
+{
+	if (_stack.back().object)
+		_pHandler->endObject();
+	else
+		_pHandler->endArray();
+	_stack.pop_back();
+}
+
+
+template <typename T>
+void MessagePackParser::report(const T& value)
+{
+	if (_stack.empty())
+	{
+		_value = value;
+		_scalar = true;
+	}
+	else _pHandler->value(value);
+}
+
+
+void MessagePackParser::reportNull()
+{
+	if (_stack.empty())
+	{
+		_value.empty();
+		_scalar = true;
+	}
+	else _pHandler->null();
+}
+
+
+void MessagePackParser::reportUnsigned(UInt64 v)
+{
+	if (v <= static_cast<UInt64>(std::numeric_limits<int>::max()))
+		report(static_cast<int>(v));
+	else if (v <= std::numeric_limits<unsigned>::max())
+		report(static_cast<unsigned>(v));
+	else if (v <= static_cast<UInt64>(std::numeric_limits<Int64>::max()))
+		report(static_cast<Int64>(v));
+	else
+		report(v);
+}
+
+
+void MessagePackParser::reportSigned(Int64 v)
+{
+	if (v >= 0)
+		reportUnsigned(static_cast<UInt64>(v));
+	else if (v >= std::numeric_limits<int>::min())
+		report(static_cast<int>(v));
+	else
+		report(v);
+}
+
+
+UInt64 MessagePackParser::readUnsigned(std::size_t bytes)
+{
+	unsigned char buffer[8];
+	read(reinterpret_cast<char*>(buffer), bytes);
+	UInt64 v = 0;
+	for (std::size_t i = 0; i < bytes; ++i)
+	{
+		v = (v << 8) | buffer[i];
+	}
+	return v;
+}
+
+
+Int64 MessagePackParser::readSigned(std::size_t bytes)
+{
+	UInt64 v = readUnsigned(bytes);
+	switch (bytes)
+	{
+	case 1:
+		return static_cast<Int8>(v);
+	case 2:
+		return static_cast<Int16>(v);
+	case 4:
+		return static_cast<Int32>(v);
+	default:
+		return static_cast<Int64>(v);
+	}
+}
+
+
+void MessagePackParser::read(char* buffer, std::size_t length)
+{
+	if (_pStreamBuf)
+	{
+		if (_pStreamBuf->sgetn(buffer, static_cast<std::streamsize>(length)) != static_cast<std::streamsize>(length))
+			throw JSONException("MessagePack: unexpected end of input");
+	}
+	else
+	{
+		if (static_cast<std::size_t>(_pEnd - _pPos) < length)
+			throw JSONException("MessagePack: unexpected end of input");
+		std::memcpy(buffer, _pPos, length);
+		_pPos += length;
+	}
+}
+
+
+void MessagePackParser::read(std::string& str, UInt64 length)
+{
+	if (_pStreamBuf)
+	{
+		// Read large strings in chunks, so that a bogus length
+		// does not allocate more memory than the input provides.
+		while (length > 0)
+		{
+			std::size_t n = length < READ_CHUNK_SIZE ? static_cast<std::size_t>(length) : READ_CHUNK_SIZE;
+			std::size_t size = str.size();
+			str.resize(size + n);
+			if (_pStreamBuf->sgetn(&str[size], static_cast<std::streamsize>(n)) != static_cast<std::streamsize>(n))
+				throw JSONException("MessagePack: unexpected end of input");
+			length -= n;
+		}
+	}
+	else
+	{
+		if (static_cast<UInt64>(_pEnd - _pPos) < length)
+			throw JSONException("MessagePack: unexpected end of input");
+		str.append(_pPos, static_cast<std::size_t>(length));
+		_pPos += length;
+	}
+}
+
+
+unsigned char MessagePackParser::underflow()
+{
+	if (_pStreamBuf)
+	{
+		std::streambuf::int_type c = _pStreamBuf->sbumpc();
+		if (c != std::streambuf::traits_type::eof())
+			return static_cast<unsigned char>(c);
+	}
+	throw JSONException("MessagePack: unexpected end of input");
+}
+
+
+} } // namespace Poco::JSON
@@ -0,0 +1,553 @@
+//
+// MessagePackWriter.cpp
+//
+// Library: JSON
+// Package: JSON
+// Module:  MessagePackWriter
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/JSON/MessagePackWriter.h"
+#include "Poco/JSON/Object.h"
+#include "Poco/JSON/Array.h"
+#include "Poco/JSON/JSONException.h"
+#include "Poco/ByteOrder.h"
+#include <cstring>
+#include <cfloat>
+
+
+namespace
+{
+	const char MP_NIL      = '\xC0';
+	const char MP_FALSE    = '\xC2';
+	const char MP_TRUE     = '\xC3';
+	const char MP_BIN8     = '\xC4';
+	const char MP_BIN16    = '\xC5';
+	const char MP_BIN32    = '\xC6';
+	const char MP_FLOAT32  = '\xCA';
+	const char MP_FLOAT64  = '\xCB';
+	const char MP_UINT8    = '\xCC';
+	const char MP_UINT16   = '\xCD';
+	const char MP_UINT32   = '\xCE';
+	const char MP_UINT64   = '\xCF';
+	const char MP_INT8     = '\xD0';
+	const char MP_INT16    = '\xD1';
+	const char MP_INT32    = '\xD2';
+	const char MP_INT64    = '\xD3';
+	const char MP_STR8     = '\xD9';
+	const char MP_STR16    = '\xDA';
+	const char MP_STR32    = '\xDB';
+	const char MP_ARRAY16  = '\xDC';
+	const char MP_ARRAY32  = '\xDD';
+	const char MP_MAP16    = '\xDE';
+	const char MP_MAP32    = '\xDF';
+	const char MP_FIXMAP   = '\x80';
+	const char MP_FIXARRAY = '\x90';
+	const char MP_FIXSTR   = '\xA0';
+
+
+	bool isSingle(double d)
+		/// Returns true if d can be written in single precision
+		/// without changing its value.
+	{
+		if (d != d) return true;
+		if (d < -DBL_MAX || d > DBL_MAX) return true;
+		return d >= -FLT_MAX && d <= FLT_MAX && static_cast<double>(static_cast<float>(d)) == d;
+	}
+}
+
+
+namespace Poco {
+namespace JSON {
+
+
+const std::string MessagePackWriter::MEDIA_TYPE("application/msgpack");
+const std::size_t MessagePackWriter::UNKNOWN_SIZE;
+
+
+MessagePackWriter::MessagePackWriter(std::ostream& out):
+	_pStream(&out),
+	_pOut(&_buffer),
+	_unsized(0)
+{
+	_buffer.reserve(DEFAULT_BUFFER_SIZE);
+}
+
+
+MessagePackWriter::MessagePackWriter(std::string& str):
+	_pStream(0),
+	_pOut(&str),
+	_unsized(0)
+{
+}
+
+
+MessagePackWriter::~MessagePackWriter()
+{
+	try
+	{
+		if (_unsized == 0) flush();
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
+}
+
+
+void MessagePackWriter::reset()
+{
+	_stack.clear();
+	_unsized = 0;
+}
+
+
+void MessagePackWriter::startObject()
+{
+	start(true, UNKNOWN_SIZE);
+}
+
+
+void MessagePackWriter::startObject(std::size_t size)
+{
+	start(true, size);
+}
+
+
+void MessagePackWriter::endObject()
+{
+	end(true);
+}
+
+
+void MessagePackWriter::startArray()
+{
+	start(false, UNKNOWN_SIZE);
+}
+
+
+void MessagePackWriter::startArray(std::size_t size)
+{
+	start(false, size);
+}
+
+
+void MessagePackWriter::endArray()
+{
+	end(false);
+}
+
+
+void MessagePackWriter::key(const std::string& name)
+{
+	key(name.data(), name.size());
+}
+
+
+void MessagePackWriter::key(const char* name, std::size_t length)
+{
+	if (_stack.empty() || !_stack.back().object)
+		throw JSONException("MessagePackWriter: key outside of an object");
+
+	Frame& frame = _stack.back();
+	if (frame.afterKey)
+		throw JSONException("MessagePackWriter: key without value");
+	if (frame.count == frame.size)
+		throw JSONException("MessagePackWriter: more members than the size of the object");
+
+	if (length <= 31)
+		_pOut->push_back(static_cast<char>(MP_FIXSTR | length));
+	else
+		writeSize(MP_STR8, MP_STR16, MP_STR32, length);
+	_pOut->append(name, length);
+	frame.afterKey = true;
+}
+
+
+void MessagePackWriter::null()
+{
+	beforeValue();
+	_pOut->push_back(MP_NIL);
+	afterValue();
+}
+
+
+void MessagePackWriter::value(int v)
+{
+	writeInteger(v);
+}
+
+
+void MessagePackWriter::value(unsigned v)
+{
+	beforeValue();
+	writeUnsigned(v);
+	afterValue();
+}
+
+
+#if defined(POCO_HAVE_INT64)
+
+
+void MessagePackWriter::value(Int64 v)
+{
+	writeInteger(v);
+}
+
+
+void MessagePackWriter::value(UInt64 v)
+{
+	beforeValue();
+	writeUnsigned(v);
+	afterValue();
+}
+
+
+#endif
+
+
+void MessagePackWriter::value(const std::string& value)
+{
+	this->value(value.data(), value.size());
+}
+
+
+void MessagePackWriter::value(const char* value)
+{
+	this->value(value, std::strlen(value));
+}
+
+
+void MessagePackWriter::value(const char* value, std::size_t length)
+{
+	beforeValue();
+	if (length <= 31)
+		_pOut->push_back(static_cast<char>(MP_FIXSTR | length));
+	else
+		writeSize(MP_STR8, MP_STR16, MP_STR32, length);
+	_pOut->append(value, length);
+	afterValue();
+}
+
+
+void MessagePackWriter::value(double d)
+{
+	if (isSingle(d))
+	{
+		value(static_cast<float>(d));
+	}
+	else
+	{
+		beforeValue();
+		UInt64 bits;
+		std::memcpy(&bits, &d, sizeof(bits));
+		writeFixed(MP_FLOAT64, bits);
+		afterValue();
+	}
+}
+
+
+void MessagePackWriter::value(float f)
+{
+	beforeValue();
+	UInt32 bits;
+	std::memcpy(&bits, &f, sizeof(bits));
+	writeFixed(MP_FLOAT32, bits);
+	afterValue();
+}
+
+
+void MessagePackWriter::value(bool b)
+{
+	beforeValue();
+	_pOut->push_back(b ? MP_TRUE : MP_FALSE);
+	afterValue();
+}
+
+
+void MessagePackWriter::value(const Object& object)
+{
+	startObject(object.size());
+	object.forEach([this](const std::string& name, const Dynamic::Var& v)
+	{
+		key(name);
+		value(v);
+	});
+	endObject();
+}
+
+
+void MessagePackWriter::value(const Array& array)
+{
+	startArray(array.size());
+	for (Array::ConstIterator it = array.begin(); it != array.end(); ++it)
+	{
+		value(*it);
+	}
+	endArray();
+}
+
+
+void MessagePackWriter::value(const Dynamic::Var& any)
+{
+	const std::type_info& type = any.type();
+	if (type == typeid(Object::Ptr))
+	{
+		value(*any.extract<Object::Ptr>());
+	}
+	else if (type == typeid(Array::Ptr))
+	{
+		value(*any.extract<Array::Ptr>());
+	}
+	else if (type == typeid(Object))
+	{
+		value(any.extract<Object>());
+	}
+	else if (type == typeid(Array))
+	{
+		value(any.extract<Array>());
+	}
+	else if (any.isEmpty())
+	{
+		null();
+	}
+	else if (type == typeid(std::string))
+	{
+		value(any.extract<std::string>());
+	}
+	else if (type == typeid(double))
+	{
+		value(any.extract<double>());
+	}
+	else if (type == typeid(float))
+	{
+		value(any.extract<float>());
+	}
+	else if (type == typeid(bool))
+	{
+		value(any.extract<bool>());
+	}
+	else if (type == typeid(char))
+	{
+		char c = any.extract<char>();
+		value(&c, 1);
+	}
+	else if (any.isInteger())
+	{
+		if (any.isSigned())
+		{
+			writeInteger(any.convert<Int64>());
+		}
+		else
+		{
+			beforeValue();
+			writeUnsigned(any.convert<UInt64>());
+			afterValue();
+		}
+	}
+	else if (any.isNumeric())
+	{
+		value(any.convert<double>());
+	}
+	else
+	{
+		value(any.convert<std::string>());
+	}
+}
+
+
+void MessagePackWriter::binary(const void* data, std::size_t length)
+{
+	beforeValue();
+	writeSize(MP_BIN8, MP_BIN16, MP_BIN32, length);
+	_pOut->append(static_cast<const char*>(data), length);
+	afterValue();
+}
+
+
+void MessagePackWriter::flush()
+{
+	if (_unsized > 0)
+		throw JSONException("MessagePackWriter: object or array of unknown size not ended");
+
+	if (_pStream && !_buffer.empty())
+	{
+		_pStream->write(_buffer.data(), static_cast<std::streamsize>(_buffer.size()));
+		_buffer.clear();
+	}
+}
+
+
+void MessagePackWriter::beforeValue()
+{
+	if (_stack.empty()) return;
+
+	Frame& frame = _stack.back();
+	if (frame.object)
+	{
+		if (!frame.afterKey) throw JSONException("MessagePackWriter: object member without key");
+		frame.afterKey = false;
+	}
+	else if (frame.count == frame.size)
+	{
+		throw JSONException("MessagePackWriter: more elements than the size of the array");
+	}
+	++frame.count;
+}
+
+
+void MessagePackWriter::afterValue()
+{
+	if (_pStream && _unsized == 0 && _buffer.size() >= DEFAULT_BUFFER_SIZE) flush();
+}
+
+
+void MessagePackWriter::start(bool object, std::size_t size)
+{
+	beforeValue();
+
+	Frame frame;
+	frame.size = size;
+	frame.count = 0;
+	frame.header = _pOut->size();
+	frame.object = object;
+	frame.afterKey = false;
+
+	if (size == UNKNOWN_SIZE)
+	{
+		// The size is filled in by end().
+		writeFixed(object ? MP_MAP32 : MP_ARRAY32, UInt32(0));
+		++_unsized;
+	}
+	else if (size <= 15)
+	{
+		_pOut->push_back(static_cast<char>((object ? MP_FIXMAP : MP_FIXARRAY) | size));
+	}
+	else
+	{
+		writeSize(0, object ? MP_MAP16 : MP_ARRAY16, object ? MP_MAP32 : MP_ARRAY32, size);
+	}
+	_stack.push_back(frame);
+}
+
+
+void MessagePackWriter::end(bool object)
+{
+	if (_stack.empty() || _stack.back().object != object)
+		throw JSONException(object ? "MessagePackWriter: end of object without start" : "MessagePackWriter: end of array without start");
+
+	const Frame& frame = _stack.back();
+	if (frame.afterKey)
+		throw JSONException("MessagePackWriter: key without value");
+
+	if (frame.size == UNKNOWN_SIZE)
+	{
+		if (frame.count > 0xFFFFFFFF)
+			throw JSONException("MessagePackWriter: too many members or elements");
+
+		UInt32 count = ByteOrder::toBigEndian(static_cast<UInt32>(frame.count));
+		std::memcpy(&(*_pOut)[frame.header + 1], &count, sizeof(count));
+		--_unsized;
+	}
+	else if (frame.count != frame.size)
+	{
+		throw JSONException(object ? "MessagePackWriter: fewer members than the size of the object" : "MessagePackWriter: fewer elements than the size of the array");
+	}
+
+	_stack.pop_back();
+	afterValue();
+}
+
+
+void MessagePackWriter::writeUnsigned(UInt64 v)
+{
+	if (v <= 0x7F)
+		_pOut->push_back(static_cast<char>(v));
+	else if (v <= 0xFF)
+	{
+		_pOut->push_back(MP_UINT8);
+		_pOut->push_back(static_cast<char>(v));
+	}
+	else if (v <= 0xFFFF)
+		writeFixed(MP_UINT16, static_cast<UInt16>(v));
+	else if (v <= 0xFFFFFFFF)
+		writeFixed(MP_UINT32, static_cast<UInt32>(v));
+	else
+		writeFixed(MP_UINT64, v);
+}
+
+
+void MessagePackWriter::writeInteger(Int64 v)
+{
+	beforeValue();
+	if (v >= 0)
+		writeUnsigned(static_cast<UInt64>(v));
+	else if (v >= -32)
+		_pOut->push_back(static_cast<char>(v));
+	else if (v >= -128)
+	{
+		_pOut->push_back(MP_INT8);
+		_pOut->push_back(static_cast<char>(v));
+	}
+	else if (v >= -32768)
+		writeFixed(MP_INT16, static_cast<UInt16>(v));
+	else if (v >= -2147483647 - 1)
+		writeFixed(MP_INT32, static_cast<UInt32>(v));
+	else
+		writeFixed(MP_INT64, static_cast<UInt64>(v));
+	afterValue();
+}
+
+
+void MessagePackWriter::writeSize(char type8, char type16, char type32, std::size_t size)
+{
+	if (type8 != 0 && size <= 0xFF)
+	{
+		_pOut->push_back(type8);
+		_pOut->push_back(static_cast<char>(size));
+	}
+	else if (size <= 0xFFFF)
+		writeFixed(type16, static_cast<UInt16>(size));
+	else if (size <= 0xFFFFFFFF)
+		writeFixed(type32, static_cast<UInt32>(size));
+	else
+		throw JSONException("MessagePackWriter: size exceeds 32 bits");
+}
+
+
+void MessagePackWriter::writeFixed(char type, UInt16 v)
+{
+	char data[1 + sizeof(v)];
+	data[0] = type;
+	v = ByteOrder::toBigEndian(v);
+	std::memcpy(data + 1, &v, sizeof(v));
+	_pOut->append(data, sizeof(data));
+}
+
+
+void MessagePackWriter::writeFixed(char type, UInt32 v)
+{
+	char data[1 + sizeof(v)];
+	data[0] = type;
+	v = ByteOrder::toBigEndian(v);
+	std::memcpy(data + 1, &v, sizeof(v));
+	_pOut->append(data, sizeof(data));
+}
+
+
+void MessagePackWriter::writeFixed(char type, UInt64 v)
+{
+	char data[1 + sizeof(v)];
+	data[0] = type;
+	v = ByteOrder::toBigEndian(v);
+	std::memcpy(data + 1, &v, sizeof(v));
+	_pOut->append(data, sizeof(data));
+}
+
+
+} } // namespace Poco::JSON
@@ -0,0 +1,209 @@
+//
+// NDJSONReader.cpp
+//
+// Library: JSON
+// Package: JSON
+// Module:  NDJSONReader
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/JSON/NDJSONReader.h"
+#include "Poco/JSON/Document.h"
+#include "Poco/JSON/JSONException.h"
+#include "Poco/Runnable.h"
+#include "Poco/Event.h"
+#include "Poco/Environment.h"
+#include "Poco/NumberFormatter.h"
+#include "Poco/Exception.h"
+
+
+namespace Poco {
+namespace JSON {
+
+
+class NDJSONReader::ParseTask: public Runnable
+	/// Parses a range of records.
+{
+public:
+	enum
+	{
+		MIN_RECORDS = 64
+			/// Smaller batches are not worth distributing.
+	};
+
+	ParseTask():
+		_pBegin(0),
+		_pEnd(0),
+		_preserveObjectOrder(false)
+	{
+	}
+
+	void assign(Record* pBegin, Record* pEnd, bool preserveObjectOrder)
+	{
+		_pBegin = pBegin;
+		_pEnd = pEnd;
+		_preserveObjectOrder = preserveObjectOrder;
+	}
+
+	void run()
+	{
+		parse();
+		_done.set();
+	}
+
+	void parse()
+	{
+		_document.setPreserveObjectOrder(_preserveObjectOrder);
+		for (Record* pRecord = _pBegin; pRecord != _pEnd; ++pRecord)
+		{
+			try
+			{
+				_document.parse(pRecord->text.data(), pRecord->text.size());
+				pRecord->value = _document.root().asVar();
+			}
+			catch (Poco::Exception& exc)
+			{
+				pRecord->error = exc.message().empty() ? exc.displayText() : exc.message();
+			}
+			catch (std::exception& exc)
+			{
+				pRecord->error = exc.what();
+			}
+		}
+		_document.clear();
+	}
+
+	void wait()
+	{
+		_done.wait();
+	}
+
+private:
+	Record*  _pBegin;
+	Record*  _pEnd;
+	bool     _preserveObjectOrder;
+	Document _document;
+	Event    _done;
+};
+
+
+NDJSONReader::NDJSONReader(std::istream& in):
+	_istr(in),
+	_pool(ThreadPool::defaultPool()),
+	_count(0),
+	_pos(0),
+	_line(0),
+	_currentLine(0),
+	_batchSize(DEFAULT_BATCH_SIZE),
+	_preserveObjectOrder(false)
+{
+}
+
+
+NDJSONReader::NDJSONReader(std::istream& in, ThreadPool& pool):
+	_istr(in),
+	_pool(pool),
+	_count(0),
+	_pos(0),
+	_line(0),
+	_currentLine(0),
+	_batchSize(DEFAULT_BATCH_SIZE),
+	_preserveObjectOrder(false)
+{
+}
+
+
+NDJSONReader::~NDJSONReader()
+{
+}
+
+
+bool NDJSONReader::read(Dynamic::Var& record)
+{
+	if (_pos == _count && !readBatch()) return false;
+
+	Record& current = _records[_pos++];
+	_currentLine = current.line;
+	if (!current.error.empty())
+		throw JSONException("line " + NumberFormatter::format(current.line) + ": " + current.error);
+
+	record.swap(current.value);
+	current.value.empty();
+	return true;
+}
+
+
+bool NDJSONReader::readBatch()
+{
+	if (_records.size() < _batchSize) _records.resize(_batchSize);
+
+	_count = 0;
+	_pos = 0;
+	while (_count < _batchSize)
+	{
+		Record& record = _records[_count];
+		if (!std::getline(_istr, record.text)) break;
+		++_line;
+
+		std::string::size_type n = record.text.size();
+		if (n > 0 && record.text[n - 1] == '\r') record.text.resize(--n);
+		if (record.text.find_first_not_of(" \t") == std::string::npos) continue;
+
+		record.value.empty();
+		record.error.clear();
+		record.line = _line;
+		++_count;
+	}
+	if (_count == 0) return false;
+
+	parseBatch();
+	return true;
+}
+
+
+void NDJSONReader::parseBatch()
+{
+	std::size_t slices = Environment::processorCount();
+	std::size_t maxSlices = (_count + ParseTask::MIN_RECORDS - 1)/ParseTask::MIN_RECORDS;
+	if (slices > maxSlices) slices = maxSlices;
+	if (slices == 0) slices = 1;
+
+	std::vector<ParseTask> tasks(slices);
+	std::size_t started = 0;
+	for (std::size_t i = 0; i < slices; ++i)
+	{
+		std::size_t begin = i*_count/slices;
+		std::size_t end = (i + 1)*_count/slices;
+		tasks[i].assign(&_records[0] + begin, &_records[0] + end, _preserveObjectOrder);
+	}
+
+	// The last slice is always parsed by the calling thread,
+	// as are those for which no pool thread is available.
+	for (; started + 1 < slices; ++started)
+	{
+		try
+		{
+			_pool.start(tasks[started]);
+		}
+		catch (NoThreadAvailableException&)
+		{
+			break;
+		}
+	}
+	for (std::size_t i = started; i < slices; ++i)
+	{
+		tasks[i].parse();
+	}
+	for (std::size_t i = 0; i < started; ++i)
+	{
+		tasks[i].wait();
+	}
+}
+
+
+} } // namespace Poco::JSON
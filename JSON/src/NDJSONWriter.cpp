@@ -0,0 +1,84 @@
+//
+// NDJSONWriter.cpp
+//
+// Library: JSON
+// Package: JSON
+// Module:  NDJSONWriter
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/JSON/NDJSONWriter.h"
+#include "Poco/JSON/JSONException.h"
+
+
+namespace Poco {
+namespace JSON {
+
+
+NDJSONWriter::NDJSONWriter(std::ostream& out, int options, std::size_t batchSize):
+	_ostr(out),
+	_writer(_batch, options),
+	_batchSize(batchSize),
+	_pending(0),
+	_count(0)
+{
+	poco_assert (batchSize > 0);
+}
+
+
+NDJSONWriter::~NDJSONWriter()
+{
+	try
+	{
+		writeBatch();
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
+}
+
+
+void NDJSONWriter::write(const Dynamic::Var& record)
+{
+	_writer.value(record);
+	endRecord();
+}
+
+
+void NDJSONWriter::endRecord()
+{
+	_writer.endLine();
+	++_count;
+	if (++_pending >= _batchSize) writeBatch();
+}
+
+
+void NDJSONWriter::flush()
+{
+	if (_writer.depth() > 0)
+		throw JSONException("NDJSONWriter: cannot flush within a record");
+
+	writeBatch();
+	_ostr.flush();
+}
+
+
+void NDJSONWriter::writeBatch()
+{
+	_writer.flush();
+	if (_batch.empty()) return;
+
+	_ostr.write(_batch.data(), static_cast<std::streamsize>(_batch.size()));
+	if (!_ostr) throw JSONException("NDJSONWriter: cannot write to stream");
+	_batch.clear();
+	_pending = 0;
+}
+
+
+} } // namespace Poco::JSON
@@ -13,8 +13,11 @@
 
 
 #include "Poco/JSON/Object.h"
+#include "Poco/JSON/Writer.h"
+#include "Poco/Hash.h"
 #include <iostream>
 #include <sstream>
+#include <new>
 
 
 using Poco::Dynamic::Var;
@@ -26,6 +29,10 @@ namespace JSON {
 
 
 Object::Object(int options):
+	_pFlat(0),
+	_flatSize(0),
+	_flatCapacity(0),
+	_flat((options & Poco::JSON_FLAT_STORAGE) != 0),
 	_preserveInsOrder(options & Poco::JSON_PRESERVE_KEY_ORDER),
 	_escapeUnicode(options & Poco::JSON_ESCAPE_UNICODE),
 	_modified(false)
@@ -34,29 +41,40 @@ Object::Object(int options):
 
 
 Object::Object(const Object& other) : _values(other._values),
+	_pFlat(0),
+	_flatSize(0),
+	_flatCapacity(0),
+	_flat(other._flat),
 	_preserveInsOrder(other._preserveInsOrder),
 	_escapeUnicode(other._escapeUnicode),
 	_pStruct(!other._modified ? other._pStruct : 0),
 	_modified(other._modified)
 {
 	syncKeys(other._keys);
+	if (_flat) flatCopy(other);
 }
 
 
 Object::Object(Object&& other) :
 	_values(std::move(other._values)),
 	_keys(std::move(other._keys)),
+	_pFlat(0),
+	_flatSize(0),
+	_flatCapacity(0),
+	_flat(other._flat),
 	_preserveInsOrder(other._preserveInsOrder),
 	_escapeUnicode(other._escapeUnicode),
 	_pStruct(!other._modified ? other._pStruct : 0),
 	_modified(other._modified)
 {
+	flatMove(other);
 	other.clear();
 }
 
 
 Object::~Object()
 {
+	flatClear();
 }
 
 
@@ -64,9 +82,13 @@ Object &Object::operator= (const Object &other)
 {
 	if (&other != this)
 	{
+		flatClear();
 		_values = other._values;
+		_flat = other._flat;
 		_preserveInsOrder = other._preserveInsOrder;
+		_keys.clear();
 		syncKeys(other._keys);
+		if (_flat) flatCopy(other);
 		_escapeUnicode = other._escapeUnicode;
 		_pStruct = !other._modified ? other._pStruct : 0;
 		_modified = other._modified;
@@ -79,8 +101,11 @@ Object &Object::operator= (Object &&other)
 {
 	if (&other != this)
 	{
+		flatClear();
 		_values = std::move(other._values);
 		_keys = std::move(other._keys);
+		flatMove(other);
+		_flat = other._flat;
 		_preserveInsOrder = other._preserveInsOrder;
 		_escapeUnicode = other._escapeUnicode;
 		_pStruct = !other._modified ? other._pStruct : 0;
@@ -108,8 +133,8 @@ void Object::syncKeys(const KeyList& keys)
 
 Var Object::get(const std::string& key) const
 {
-	ValueMap::const_iterator it = _values.find(key);
-	if (it != _values.end())
+	ConstIterator it = find(key);
+	if (it != end())
 	{
 		return it->second;
 	}
@@ -120,8 +145,8 @@ Var Object::get(const std::string& key) const
 
 Array::Ptr Object::getArray(const std::string& key) const
 {
-	ValueMap::const_iterator it = _values.find(key);
-	if ((it != _values.end()) && (it->second.type() == typeid(Array::Ptr)))
+	ConstIterator it = find(key);
+	if ((it != end()) && (it->second.type() == typeid(Array::Ptr)))
 	{
 		return it->second.extract<Array::Ptr>();
 	}
@@ -132,8 +157,8 @@ Array::Ptr Object::getArray(const std::string& key) const
 
 Object::Ptr Object::getObject(const std::string& key) const
 {
-	ValueMap::const_iterator it = _values.find(key);
-	if ((it != _values.end()) && (it->second.type() == typeid(Object::Ptr)))
+	ConstIterator it = find(key);
+	if ((it != end()) && (it->second.type() == typeid(Object::Ptr)))
 	{
 		return it->second.extract<Object::Ptr>();
 	}
@@ -145,7 +170,7 @@ Object::Ptr Object::getObject(const std::string& key) const
 void Object::getNames(NameList& names) const
 {
 	names.clear();
-	if (_preserveInsOrder)
+	if (useKeyList())
 	{
 		for(KeyList::const_iterator it = _keys.begin(); it != _keys.end(); ++it)
 		{
@@ -154,7 +179,8 @@ void Object::getNames(NameList& names) const
 	}
 	else
 	{
-		for(ValueMap::const_iterator it = _values.begin(); it != _values.end(); ++it)
+		names.reserve(size());
+		for(ConstIterator it = begin(); it != end(); ++it)
 		{
 			names.push_back(it->first);
 		}
@@ -174,10 +200,18 @@ void Object::stringify(std::ostream& out, unsigned int indent, int step) const
 {
 	if (step < 0) step = indent;
 
-	if (!_preserveInsOrder)
-		doStringify(_values, out, indent, step);
+	if (indent == 0 && step == 0)
+	{
+		Writer writer(out, _escapeUnicode ? Poco::JSON_ESCAPE_UNICODE : 0);
+		writer.value(*this);
+		writer.flush();
+		return;
+	}
+
+	if (!useKeyList())
+		doStringify(begin(), end(), out, indent, step);
 	else
-		doStringify(_keys, out, indent, step);
+		doStringify(_keys.begin(), _keys.end(), out, indent, step);
 }
 
 
@@ -196,20 +230,219 @@ const std::string& Object::getKey(KeyList::const_iterator& iter) const
 
 Object& Object::set(const std::string& key, const Dynamic::Var& value)
 {
-	std::pair<ValueMap::iterator, bool> ret = _values.insert(ValueMap::value_type(key, value));
-	if (!ret.second) ret.first->second = value;
-	if (_preserveInsOrder)
+	return set(key, Dynamic::Var(value));
+}
+
+
+Object& Object::set(const std::string& key, Dynamic::Var&& value)
+{
+	if (_flat)
 	{
-		KeyList::iterator it = _keys.begin();
-		KeyList::iterator end = _keys.end();
-		for (; it != end; ++it)
+		std::size_t index = flatFind(key);
+		if (index < _flatSize)
+			_pFlat[index].second = std::move(value);
+		else
+			flatAppend(key, std::move(value));
+		_modified = true;
+		return *this;
+	}
+
+	ValueMap::iterator it = _values.lower_bound(key);
+	if (it != _values.end() && it->first == key)
+	{
+		it->second = std::move(value);
+	}
+	else
+	{
+		it = _values.insert(it, ValueMap::value_type(key, std::move(value)));
+		if (_preserveInsOrder) _keys.push_back(it);
+	}
+	_modified = true;
+	return *this;
+}
+
+
+void Object::reserve(std::size_t size)
+{
+	if (_flat) flatReserve(size);
+}
+
+
+void Object::remove(const std::string& key)
+{
+	if (_flat)
+	{
+		std::size_t index = flatFind(key);
+		if (index < _flatSize) flatErase(index);
+	}
+	else
+	{
+		if (_preserveInsOrder)
 		{
-			if (key == (*it)->first) return *this;
+			KeyList::iterator it = _keys.begin();
+			KeyList::iterator end = _keys.end();
+			for (; it != end; ++it)
+			{
+				if (key == (*it)->first)
+				{
+					_keys.erase(it);
+					break;
+				}
+			}
 		}
-		_keys.push_back(ret.first);
+		_values.erase(key);
 	}
 	_modified = true;
-	return *this;
+}
+
+
+std::size_t Object::flatFind(const std::string& key) const
+{
+	if (_flatIndex.empty())
+	{
+		for (std::size_t i = 0; i < _flatSize; ++i)
+		{
+			if (_pFlat[i].first == key) return i;
+		}
+		return _flatSize;
+	}
+
+	std::size_t mask = _flatIndex.size() - 1;
+	std::size_t slot = Poco::hash(key) & mask;
+	while (UInt32 entry = _flatIndex[slot])
+	{
+		if (_pFlat[entry - 1].first == key) return entry - 1;
+		slot = (slot + 1) & mask;
+	}
+	return _flatSize;
+}
+
+
+void Object::flatAppend(const std::string& key, Dynamic::Var&& value)
+{
+	if (_flatSize == _flatCapacity)
+	{
+		flatReserve(_flatCapacity ? 2*_flatCapacity : 4);
+	}
+	new (_pFlat + _flatSize) ValueType(key, std::move(value));
+	++_flatSize;
+
+	if (_flatSize > FLAT_LINEAR_LIMIT)
+	{
+		// Keep the load factor of the index at or below 1/2.
+		if (2*_flatSize > _flatIndex.size())
+			flatRebuildIndex();
+		else
+			flatIndex(_flatSize - 1);
+	}
+}
+
+
+void Object::flatErase(std::size_t index)
+{
+	poco_assert_dbg (index < _flatSize);
+
+	_pFlat[index].~ValueType();
+	for (std::size_t i = index + 1; i < _flatSize; ++i)
+	{
+		new (_pFlat + i - 1) ValueType(std::move(_pFlat[i]));
+		_pFlat[i].~ValueType();
+	}
+	--_flatSize;
+
+	if (_flatSize > FLAT_LINEAR_LIMIT)
+		flatRebuildIndex();
+	else
+		_flatIndex.clear();
+}
+
+
+void Object::flatReserve(std::size_t capacity)
+{
+	if (capacity <= _flatCapacity) return;
+
+	ValueType* pFlat = static_cast<ValueType*>(::operator new(capacity*sizeof(ValueType)));
+	std::size_t i = 0;
+	try
+	{
+		for (; i < _flatSize; ++i)
+		{
+			new (pFlat + i) ValueType(std::move(_pFlat[i]));
+		}
+	}
+	catch (...)
+	{
+		while (i > 0) pFlat[--i].~ValueType();
+		::operator delete(pFlat);
+		throw;
+	}
+	for (i = 0; i < _flatSize; ++i)
+	{
+		_pFlat[i].~ValueType();
+	}
+	::operator delete(_pFlat);
+	_pFlat = pFlat;
+	_flatCapacity = capacity;
+}
+
+
+void Object::flatClear()
+{
+	for (std::size_t i = 0; i < _flatSize; ++i)
+	{
+		_pFlat[i].~ValueType();
+	}
+	::operator delete(_pFlat);
+	_pFlat = 0;
+	_flatSize = 0;
+	_flatCapacity = 0;
+	_flatIndex.clear();
+}
+
+
+void Object::flatCopy(const Object& other)
+{
+	flatReserve(other._flatSize);
+	for (std::size_t i = 0; i < other._flatSize; ++i)
+	{
+		new (_pFlat + i) ValueType(other._pFlat[i]);
+		++_flatSize;
+	}
+	_flatIndex = other._flatIndex;
+}
+
+
+void Object::flatMove(Object& other)
+{
+	_pFlat = other._pFlat;
+	_flatSize = other._flatSize;
+	_flatCapacity = other._flatCapacity;
+	_flatIndex.swap(other._flatIndex);
+	other._pFlat = 0;
+	other._flatSize = 0;
+	other._flatCapacity = 0;
+	other._flatIndex.clear();
+}
+
+
+void Object::flatIndex(std::size_t index)
+{
+	std::size_t mask = _flatIndex.size() - 1;
+	std::size_t slot = Poco::hash(_pFlat[index].first) & mask;
+	while (_flatIndex[slot]) slot = (slot + 1) & mask;
+	_flatIndex[slot] = static_cast<UInt32>(index + 1);
+}
+
+
+void Object::flatRebuildIndex()
+{
+	std::size_t slots = 16;
+	while (slots < 4*_flatSize) slots *= 2;
+	_flatIndex.assign(slots, 0);
+	for (std::size_t i = 0; i < _flatSize; ++i)
+	{
+		flatIndex(i);
+	}
 }
 
 
@@ -251,14 +484,14 @@ void Object::resetDynStruct() const
 
 Object::operator const Poco::DynamicStruct& () const
 {
-	if (!_values.size())
+	if (!size())
 	{
 		resetDynStruct(_pStruct);
 	}
 	else if (_modified)
 	{
-		ValueMap::const_iterator it = _values.begin();
-		ValueMap::const_iterator end = _values.end();
+		ConstIterator it = begin();
+		ConstIterator end = this->end();
 		resetDynStruct(_pStruct);
 		for (; it != end; ++it)
 		{
@@ -286,13 +519,13 @@ Object::operator const Poco::DynamicStruct& () const
 
 Object::operator const Poco::OrderedDynamicStruct& () const
 {
-	if (!_values.size())
+	if (!size())
 	{
 		resetDynStruct(_pOrdStruct);
 	}
 	else if (_modified)
 	{
-		if (_preserveInsOrder)
+		if (useKeyList())
 		{
 			KeyList::const_iterator it = _keys.begin();
 			KeyList::const_iterator end = _keys.end();
@@ -315,8 +548,8 @@ Object::operator const Poco::OrderedDynamicStruct& () const
 		}
 		else
 		{
-			ValueMap::const_iterator it = _values.begin();
-			ValueMap::const_iterator end = _values.end();
+			ConstIterator it = begin();
+			ConstIterator end = this->end();
 			resetDynStruct(_pOrdStruct);
 			for (; it != end; ++it)
 			{
@@ -347,6 +580,7 @@ void Object::clear()
 {
 	_values.clear();
 	_keys.clear();
+	flatClear();
 	_pStruct = 0;
 	_modified = true;
 }
@@ -24,8 +24,8 @@ namespace Poco {
 namespace JSON {
 
 
-ParseHandler::ParseHandler(bool preserveObjectOrder) : Handler(),
-	_preserveObjectOrder(preserveObjectOrder)
+ParseHandler::ParseHandler(bool preserveObjectOrder, bool flatObjects) : Handler(),
+	_objectOptions((preserveObjectOrder ? Poco::JSON_PRESERVE_KEY_ORDER : 0) | (flatObjects ? Poco::JSON_FLAT_STORAGE : 0))
 {
 }
 
@@ -45,27 +45,14 @@ void ParseHandler::reset()
 
 void ParseHandler::startObject()
 {
-	Object::Ptr newObj = new Object(_preserveObjectOrder);
+	Object::Ptr newObj = new Object(_objectOptions);
 	if (_stack.empty()) // The first object
 	{
 		_result = newObj;
 	}
 	else
 	{
-		Var parent = _stack.top();
-
-		if (parent.type() == typeid(Array::Ptr))
-		{
-			Array::Ptr arr = parent.extract<Array::Ptr>();
-			arr->add(newObj);
-		}
-		else if (parent.type() == typeid(Object::Ptr))
-		{
-			poco_assert_dbg(!_key.empty());
-			Object::Ptr obj = parent.extract<Object::Ptr>();
-			obj->set(_key, newObj);
-			_key.clear();
-		}
+		addToParent(newObj);
 	}
 
 	_stack.push(newObj);
@@ -88,20 +75,7 @@ void ParseHandler::startArray()
 	}
 	else
 	{
-		Var parent = _stack.top();
-
-		if (parent.type() == typeid(Array::Ptr))
-		{
-			Array::Ptr arr = parent.extract<Array::Ptr>();
-			arr->add(newArr);
-		}
-		else if (parent.type() == typeid(Object::Ptr))
-		{
-			poco_assert_dbg(!_key.empty());
-			Object::Ptr obj = parent.extract<Object::Ptr>();
-			obj->set(_key, newArr);
-			_key.clear();
-		}
+		addToParent(newArr);
 	}
 
 	_stack.push(newArr);
@@ -120,27 +94,30 @@ void ParseHandler::key(const std::string& k)
 }
 
 
-void ParseHandler::setValue(const Var& value)
+void ParseHandler::setValue(Var&& value)
 {
-	if (_stack.size())
+	if (_stack.empty())
+		throw JSONException("Attempt to set value on an empty stack");
+
+	addToParent(std::move(value));
+}
+
+
+void ParseHandler::addToParent(Var&& value)
+{
+	// The parent is only looked at, copying it would clone its holder.
+	const Var& parent = _stack.top();
+
+	if (const Array::Ptr* pArr = parent.tryGet<Array::Ptr>())
 	{
-		Var parent = _stack.top();
-
-		if (parent.type() == typeid(Array::Ptr))
-		{
-			Array::Ptr arr = parent.extract<Array::Ptr>();
-			arr->add(value);
-		}
-		else if (parent.type() == typeid(Object::Ptr))
-		{
-			Object::Ptr obj = parent.extract<Object::Ptr>();
-			obj->set(_key, value);
-			_key.clear();
-		}
+		Array::Ptr arr = *pArr;
+		arr->add(std::move(value));
 	}
-	else
+	else if (const Object::Ptr* pObj = parent.tryGet<Object::Ptr>())
 	{
-		throw JSONException("Attempt to set value on an empty stack");
+		Object::Ptr obj = *pObj;
+		obj->set(_key, std::move(value));
+		_key.clear();
 	}
 }
 
@@ -37,7 +37,8 @@ ParserImpl::ParserImpl(const Handler::Ptr& pHandler, std::size_t /*bufSize*/):
 	_depth(JSON_UNLIMITED_DEPTH),
 	_decimalPoint('.'),
 	_allowNullByte(true),
-	_allowComments(false)
+	_allowComments(false),
+	_indexed(false)
 {
 }
 
@@ -53,6 +54,12 @@ void ParserImpl::handle(const std::string& json)
 	if (!_allowNullByte && json.find("\\u0000") != json.npos)
 		throw JSONException("Null bytes in strings not allowed.");
 
+	if (_indexed)
+	{
+		handleIndexed(json);
+		return;
+	}
+
 	try
 	{
 		json_open_buffer(_pJSON, json.data(), json.size());
@@ -78,6 +85,24 @@ void ParserImpl::handle(const std::string& json)
 }
 
 
+void ParserImpl::handleIndexed(const std::string& json)
+{
+	_tape.setAllowNullByte(_allowNullByte);
+	_tape.setDepth(_depth);
+	try
+	{
+		_tape.parse(json.data(), json.size());
+		if (_pHandler) _tape.emit(0, *_pHandler);
+		_tape.clear();
+	}
+	catch (...)
+	{
+		_tape.clear();
+		throw;
+	}
+}
+
+
 Dynamic::Var ParserImpl::parseImpl(const std::string& json)
 {
 	if (_allowComments)
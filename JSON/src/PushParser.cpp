@@ -0,0 +1,558 @@
+//
+// PushParser.cpp
+//
+// Library: JSON
+// Package: JSON
+// Module:  PushParser
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/JSON/PushParser.h"
+#include "Poco/JSON/JSONException.h"
+#include "Poco/UTF8Encoding.h"
+#include "Poco/NumberParser.h"
+#include "Poco/NumericString.h"
+#include <cstring>
+
+
+namespace
+{
+	inline bool isDigit(char c)
+	{
+		return c >= '0' && c <= '9';
+	}
+
+	inline bool isNumberChar(char c)
+	{
+		return isDigit(c) || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+	}
+
+	inline unsigned hexValue(char c)
+	{
+		if (c >= '0' && c <= '9') return c - '0';
+		if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+		if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+		return 16;
+	}
+
+	inline void appendUTF8(std::string& str, Poco::UInt32 cp)
+	{
+		if (cp < 0x80)
+		{
+			str += static_cast<char>(cp);
+		}
+		else if (cp < 0x800)
+		{
+			str += static_cast<char>(0xC0 | (cp >> 6));
+			str += static_cast<char>(0x80 | (cp & 0x3F));
+		}
+		else if (cp < 0x10000)
+		{
+			str += static_cast<char>(0xE0 | (cp >> 12));
+			str += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+			str += static_cast<char>(0x80 | (cp & 0x3F));
+		}
+		else
+		{
+			str += static_cast<char>(0xF0 | (cp >> 18));
+			str += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+			str += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+			str += static_cast<char>(0x80 | (cp & 0x3F));
+		}
+	}
+
+	bool isValidNumber(const std::string& str, bool& isFloat)
+		/// Checks str against the JSON number grammar.
+	{
+		std::string::const_iterator it = str.begin();
+		std::string::const_iterator end = str.end();
+		isFloat = false;
+		if (it != end && *it == '-') ++it;
+		if (it == end || !isDigit(*it)) return false;
+		if (*it == '0')
+		{
+			++it;
+		}
+		else
+		{
+			while (it != end && isDigit(*it)) ++it;
+		}
+		if (it != end && *it == '.')
+		{
+			isFloat = true;
+			++it;
+			if (it == end || !isDigit(*it)) return false;
+			while (it != end && isDigit(*it)) ++it;
+		}
+		if (it != end && (*it == 'e' || *it == 'E'))
+		{
+			isFloat = true;
+			++it;
+			if (it != end && (*it == '+' || *it == '-')) ++it;
+			if (it == end || !isDigit(*it)) return false;
+			while (it != end && isDigit(*it)) ++it;
+		}
+		return it == end;
+	}
+}
+
+
+namespace Poco {
+namespace JSON {
+
+
+PushParser::PushParser(const Handler::Ptr& pHandler):
+	_pHandler(pHandler),
+	_state(STATE_VALUE),
+	_commentState(STATE_VALUE),
+	_pLiteral(0),
+	_literalPos(0),
+	_codePoint(0),
+	_highSurrogate(0),
+	_hexDigits(0),
+	_depth(JSON_UNLIMITED_DEPTH),
+	_offset(0),
+	_key(false),
+	_allowComments(false),
+	_allowNullByte(true)
+{
+}
+
+
+PushParser::~PushParser()
+{
+}
+
+
+void PushParser::reset()
+{
+	_state = STATE_VALUE;
+	_commentState = STATE_VALUE;
+	_stack.clear();
+	_token.clear();
+	_highSurrogate = 0;
+	_offset = 0;
+	if (_pHandler) _pHandler->reset();
+}
+
+
+void PushParser::feed(const char* data, std::size_t length)
+{
+	if (_state == STATE_ERROR)
+		throw JSONException("PushParser must be reset after an error");
+
+	const char* p = data;
+	const char* end = data + length;
+	try
+	{
+		while (p < end)
+		{
+			switch (_state)
+			{
+			case STATE_STRING:
+				p = parseString(p, end);
+				break;
+			case STATE_ESCAPE:
+				escape(*p++);
+				break;
+			case STATE_UNICODE:
+				unicode(*p++);
+				break;
+			case STATE_NUMBER:
+				p = parseNumber(p, end);
+				break;
+			case STATE_LITERAL:
+				if (*p++ != _pLiteral[_literalPos])
+					fail(std::string("Invalid literal, expected '") + _pLiteral + "'");
+				if (_pLiteral[++_literalPos] == 0) endLiteral();
+				break;
+			case STATE_COMMENT_START:
+				if (*p++ != '*') fail("Invalid comment");
+				_state = STATE_COMMENT;
+				break;
+			case STATE_COMMENT:
+				{
+					const char* pStar = static_cast<const char*>(std::memchr(p, '*', end - p));
+					if (pStar)
+					{
+						p = pStar + 1;
+						_state = STATE_COMMENT_STAR;
+					}
+					else p = end;
+				}
+				break;
+			case STATE_COMMENT_STAR:
+				{
+					char c = *p++;
+					if (c == '/')
+						_state = _commentState;
+					else if (c != '*')
+						_state = STATE_COMMENT;
+				}
+				break;
+			default:
+				p = parseStructure(p, end);
+				break;
+			}
+		}
+	}
+	catch (...)
+	{
+		_offset += p - data;
+		_state = STATE_ERROR;
+		throw;
+	}
+	_offset += length;
+}
+
+
+void PushParser::finish()
+{
+	if (_state == STATE_ERROR)
+		throw JSONException("PushParser must be reset after an error");
+
+	try
+	{
+		// A number at the top level is only terminated by the end of input.
+		if (_state == STATE_NUMBER && _stack.empty()) endNumber();
+	}
+	catch (...)
+	{
+		_state = STATE_ERROR;
+		throw;
+	}
+
+	if (_state != STATE_END)
+	{
+		if (_state == STATE_VALUE && _stack.empty())
+			fail("No JSON document found");
+		else if (_state == STATE_COMMENT || _state == STATE_COMMENT_STAR)
+			fail("Unterminated comment");
+		else
+			fail("Incomplete JSON document");
+	}
+}
+
+
+const char* PushParser::parseStructure(const char* p, const char* end)
+{
+	while (p < end)
+	{
+		char c = *p++;
+		if (c == ' ' || c == '\t' || c == '\n' || c == '\r') continue;
+
+		if (c == '/' && _allowComments)
+		{
+			_commentState = _state;
+			_state = STATE_COMMENT_START;
+			return p;
+		}
+
+		switch (_state)
+		{
+		case STATE_VALUE:
+			startValue(c);
+			break;
+		case STATE_ARRAY_FIRST:
+			if (c == ']')
+				endContainer('[');
+			else
+				startValue(c);
+			break;
+		case STATE_OBJECT_FIRST:
+		case STATE_KEY:
+			if (c == '}' && _state == STATE_OBJECT_FIRST)
+			{
+				endContainer('{');
+			}
+			else if (c == '"')
+			{
+				_key = true;
+				_token.clear();
+				_state = STATE_STRING;
+			}
+			else fail("Expected object key");
+			break;
+		case STATE_COLON:
+			if (c != ':') fail("Expected ':' after object key");
+			_state = STATE_VALUE;
+			break;
+		case STATE_COMMA:
+			if (c == ',')
+				_state = _stack.back() == '{' ? STATE_KEY : STATE_VALUE;
+			else if (c == '}')
+				endContainer('{');
+			else if (c == ']')
+				endContainer('[');
+			else
+				fail("Expected ',' or end of object or array");
+			break;
+		case STATE_END:
+			fail("Excess characters found after JSON end.");
+			break;
+		default:
+			poco_bugcheck();
+		}
+		return p;
+	}
+	return p;
+}
+
+
+const char* PushParser::parseString(const char* p, const char* end)
+{
+	if (_highSurrogate && *p != '\\')
+		fail("Invalid surrogate pair in string");
+
+	const char* start = p;
+	while (p < end)
+	{
+		unsigned char c = static_cast<unsigned char>(*p);
+		if (c == '"' || c == '\\' || c < 0x20) break;
+		++p;
+	}
+	_token.append(start, p);
+	if (p == end) return p;
+
+	char c = *p++;
+	if (c == '"')
+		endString();
+	else if (c == '\\')
+		_state = STATE_ESCAPE;
+	else
+		fail("unescaped control character in string");
+	return p;
+}
+
+
+const char* PushParser::parseNumber(const char* p, const char* end)
+{
+	const char* start = p;
+	while (p < end && isNumberChar(*p)) ++p;
+	_token.append(start, p);
+	if (p < end) endNumber();
+	return p;
+}
+
+
+void PushParser::startValue(char c)
+{
+	switch (c)
+	{
+	case '{':
+	case '[':
+		startContainer(c);
+		break;
+	case '"':
+		_key = false;
+		_token.clear();
+		_state = STATE_STRING;
+		break;
+	case 't':
+		_pLiteral = "true";
+		_literalPos = 1;
+		_state = STATE_LITERAL;
+		break;
+	case 'f':
+		_pLiteral = "false";
+		_literalPos = 1;
+		_state = STATE_LITERAL;
+		break;
+	case 'n':
+		_pLiteral = "null";
+		_literalPos = 1;
+		_state = STATE_LITERAL;
+		break;
+	default:
+		if (c == '-' || isDigit(c))
+		{
+			_token.assign(1, c);
+			_state = STATE_NUMBER;
+		}
+		else fail(std::string("Unexpected character '") + c + "'");
+	}
+}
+
+
+void PushParser::startContainer(char type)
+{
+	if (_depth >= 0 && _stack.size() >= static_cast<std::size_t>(_depth))
+		fail("Maximum depth exceeded");
+
+	_stack.push_back(type);
+	if (type == '{')
+	{
+		if (_pHandler) _pHandler->startObject();
+		_state = STATE_OBJECT_FIRST;
+	}
+	else
+	{
+		if (_pHandler) _pHandler->startArray();
+		_state = STATE_ARRAY_FIRST;
+	}
+}
+
+
+void PushParser::endContainer(char type)
+{
+	if (_stack.back() != type)
+		fail(type == '{' ? "Unexpected end of object" : "Unexpected end of array");
+
+	_stack.pop_back();
+	if (_pHandler)
+	{
+		if (type == '{')
+			_pHandler->endObject();
+		else
+			_pHandler->endArray();
+	}
+	endValue();
+}
+
+
+void PushParser::endString()
+{
+	if (!UTF8Encoding::isValid(_token.data(), _token.size()))
+		fail("No legal UTF8 found");
+
+	if (_key)
+	{
+		if (_pHandler) _pHandler->key(_token);
+		_state = STATE_COLON;
+	}
+	else
+	{
+		if (_pHandler) _pHandler->value(_token);
+		endValue();
+	}
+}
+
+
+void PushParser::endNumber()
+{
+	bool isFloat;
+	if (!isValidNumber(_token, isFloat))
+		fail("Invalid number");
+
+	if (_pHandler)
+	{
+		if (isFloat)
+		{
+			double d;
+			if (!strToDouble(_token.data(), _token.size(), d))
+				fail("Invalid number");
+			_pHandler->value(d);
+		}
+		else
+		{
+			Poco::Int64 val;
+			if (NumberParser::tryParse64(_token, val))
+				_pHandler->value(val);
+			else
+				_pHandler->value(NumberParser::parseUnsigned64(_token));
+		}
+	}
+	endValue();
+}
+
+
+void PushParser::endLiteral()
+{
+	if (_pHandler)
+	{
+		switch (_pLiteral[0])
+		{
+		case 't':
+			_pHandler->value(true);
+			break;
+		case 'f':
+			_pHandler->value(false);
+			break;
+		default:
+			_pHandler->null();
+			break;
+		}
+	}
+	endValue();
+}
+
+
+void PushParser::endValue()
+{
+	_state = _stack.empty() ? STATE_END : STATE_COMMA;
+}
+
+
+void PushParser::escape(char c)
+{
+	if (_highSurrogate && c != 'u')
+		fail("Invalid surrogate pair in string");
+
+	switch (c)
+	{
+	case '"':  _token += '"'; break;
+	case '\\': _token += '\\'; break;
+	case '/':  _token += '/'; break;
+	case 'b':  _token += '\b'; break;
+	case 'f':  _token += '\f'; break;
+	case 'n':  _token += '\n'; break;
+	case 'r':  _token += '\r'; break;
+	case 't':  _token += '\t'; break;
+	case 'u':
+		_codePoint = 0;
+		_hexDigits = 0;
+		_state = STATE_UNICODE;
+		return;
+	default:
+		fail("Invalid escape sequence in string");
+	}
+	_state = STATE_STRING;
+}
+
+
+void PushParser::unicode(char c)
+{
+	unsigned h = hexValue(c);
+	if (h > 15) fail("Invalid unicode escape sequence in string");
+	_codePoint = (_codePoint << 4) | h;
+	if (++_hexDigits < 4) return;
+
+	UInt32 cp = _codePoint;
+	if (_highSurrogate)
+	{
+		if (cp < 0xDC00 || cp > 0xDFFF) fail("Invalid surrogate pair in string");
+		cp = 0x10000 + ((_highSurrogate - 0xD800) << 10) + (cp - 0xDC00);
+		_highSurrogate = 0;
+	}
+	else if (cp >= 0xD800 && cp <= 0xDBFF)
+	{
+		_highSurrogate = cp;
+		_state = STATE_STRING;
+		return;
+	}
+	else if (cp >= 0xDC00 && cp <= 0xDFFF)
+	{
+		fail("Dangling surrogate in string");
+	}
+	else if (cp == 0 && !_allowNullByte)
+	{
+		fail("Null bytes in strings not allowed.");
+	}
+	appendUTF8(_token, cp);
+	_state = STATE_STRING;
+}
+
+
+void PushParser::fail(const std::string& message)
+{
+	_state = STATE_ERROR;
+	throw JSONException(message);
+}
+
+
+} } // namespace Poco::JSON
@@ -37,6 +37,16 @@ Query::Query(const Var& source): _source(source)
 }
 
 
+Query::Query(const Document& source): _value(source.root())
+{
+}
+
+
+Query::Query(const Document::Value& source): _value(source)
+{
+}
+
+
 Query::~Query()
 {
 }
@@ -100,6 +110,8 @@ Array& Query::findArray(const std::string& path, Array& arr) const
 
 Var Query::find(const std::string& path) const
 {
+	if (_value.isValid()) return _value.find(path).asVar();
+
 	Var result = _source;
 	StringTokenizer tokenizer(path, ".");
 	for (StringTokenizer::Iterator token = tokenizer.begin(); token != tokenizer.end(); token++)
@@ -169,4 +181,12 @@ Var Query::find(const std::string& path) const
 }
 
 
+Var Query::find(const QueryPath& path) const
+{
+	if (_value.isValid()) return path.find(_value).asVar();
+
+	return path.find(_source);
+}
+
+
 } } // namespace Poco::JSON
@@ -0,0 +1,258 @@
+//
+// QueryHandler.cpp
+//
+// Library: JSON
+// Package: JSON
+// Module:  QueryHandler
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/JSON/QueryHandler.h"
+
+
+using Poco::Dynamic::Var;
+
+
+namespace Poco {
+namespace JSON {
+
+
+QueryHandler::QueryHandler(const QuerySet& querySet):
+	_querySet(querySet),
+	_values(querySet.size()),
+	_captureNode(QuerySet::NO_NODE),
+	_captureDepth(0)
+{
+}
+
+
+QueryHandler::~QueryHandler()
+{
+}
+
+
+void QueryHandler::reset()
+{
+	_values.resize(_querySet.size());
+	for (QuerySet::VarVec::iterator it = _values.begin(); it != _values.end(); ++it)
+	{
+		it->empty();
+	}
+	_stack.clear();
+	_capture.reset();
+	_captureNode = QuerySet::NO_NODE;
+	_captureDepth = 0;
+}
+
+
+void QueryHandler::startObject()
+{
+	if (_captureDepth > 0)
+	{
+		++_captureDepth;
+		_capture.startObject();
+	}
+	else startContainer(true);
+}
+
+
+void QueryHandler::endObject()
+{
+	if (_captureDepth > 0) _capture.endObject();
+	endContainer();
+}
+
+
+void QueryHandler::startArray()
+{
+	if (_captureDepth > 0)
+	{
+		++_captureDepth;
+		_capture.startArray();
+	}
+	else startContainer(false);
+}
+
+
+void QueryHandler::endArray()
+{
+	if (_captureDepth > 0) _capture.endArray();
+	endContainer();
+}
+
+
+void QueryHandler::key(const std::string& k)
+{
+	if (_captureDepth > 0)
+	{
+		_capture.key(k);
+	}
+	else if (!_stack.empty())
+	{
+		Frame& frame = _stack.back();
+		frame.member = frame.node != QuerySet::NO_NODE ? _querySet.child(frame.node, k) : QuerySet::NO_NODE;
+	}
+}
+
+
+void QueryHandler::null()
+{
+	if (_captureDepth > 0)
+		_capture.null();
+	else
+		setValue(Var());
+}
+
+
+void QueryHandler::value(int v)
+{
+	if (_captureDepth > 0)
+		_capture.value(v);
+	else
+		setValue(v);
+}
+
+
+void QueryHandler::value(unsigned v)
+{
+	if (_captureDepth > 0)
+		_capture.value(v);
+	else
+		setValue(v);
+}
+
+
+#if defined(POCO_HAVE_INT64)
+
+
+void QueryHandler::value(Int64 v)
+{
+	if (_captureDepth > 0)
+		_capture.value(v);
+	else
+		setValue(v);
+}
+
+
+void QueryHandler::value(UInt64 v)
+{
+	if (_captureDepth > 0)
+		_capture.value(v);
+	else
+		setValue(v);
+}
+
+
+#endif
+
+
+void QueryHandler::value(const std::string& s)
+{
+	if (_captureDepth > 0)
+		_capture.value(s);
+	else
+		setValue(s);
+}
+
+
+void QueryHandler::value(double d)
+{
+	if (_captureDepth > 0)
+		_capture.value(d);
+	else
+		setValue(d);
+}
+
+
+void QueryHandler::value(bool b)
+{
+	if (_captureDepth > 0)
+		_capture.value(b);
+	else
+		setValue(b);
+}
+
+
+std::size_t QueryHandler::target()
+{
+	if (_stack.empty()) return 0;
+
+	Frame& frame = _stack.back();
+	if (frame.object)
+	{
+		std::size_t node = frame.member;
+		frame.member = QuerySet::NO_NODE;
+		return node;
+	}
+	else
+	{
+		std::size_t index = frame.index++;
+		return frame.node != QuerySet::NO_NODE ? _querySet.child(frame.node, index) : QuerySet::NO_NODE;
+	}
+}
+
+
+void QueryHandler::setValue(const Var& value)
+{
+	std::size_t node = target();
+	if (node == QuerySet::NO_NODE) return;
+
+	const std::vector<std::size_t>& paths = _querySet._nodes[node].paths;
+	for (std::vector<std::size_t>::const_iterator it = paths.begin(); it != paths.end(); ++it)
+	{
+		_values[*it] = value;
+	}
+}
+
+
+void QueryHandler::startContainer(bool object)
+{
+	std::size_t node = target();
+	if (node != QuerySet::NO_NODE && !_querySet._nodes[node].paths.empty())
+	{
+		// The container itself is wanted, so build it completely.
+		_capture.reset();
+		_captureNode = node;
+		_captureDepth = 1;
+		if (object)
+			_capture.startObject();
+		else
+			_capture.startArray();
+		return;
+	}
+
+	Frame frame;
+	frame.node = (node != QuerySet::NO_NODE && !_querySet._nodes[node].children.empty()) ? node : QuerySet::NO_NODE;
+	frame.member = QuerySet::NO_NODE;
+	frame.index = 0;
+	frame.object = object;
+	_stack.push_back(frame);
+}
+
+
+void QueryHandler::endContainer()
+{
+	if (_captureDepth > 0)
+	{
+		if (--_captureDepth == 0)
+		{
+			// Paths below the captured container are
+			// found in the container that has been built.
+			_querySet.findNode(_captureNode, _capture.asVar(), _values);
+			_capture.reset();
+			_captureNode = QuerySet::NO_NODE;
+		}
+	}
+	else if (!_stack.empty())
+	{
+		_stack.pop_back();
+	}
+}
+
+
+} } // namespace Poco::JSON
@@ -0,0 +1,194 @@
+//
+// QueryPath.cpp
+//
+// Library: JSON
+// Package: JSON
+// Module:  QueryPath
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/JSON/QueryPath.h"
+#include "Poco/JSON/Object.h"
+#include "Poco/JSON/Array.h"
+#include "Poco/Ascii.h"
+#include "Poco/Exception.h"
+#include <limits>
+
+
+using Poco::Dynamic::Var;
+
+
+namespace
+{
+	const std::size_t MAX_INDEX = static_cast<std::size_t>(std::numeric_limits<int>::max());
+}
+
+
+namespace Poco {
+namespace JSON {
+
+
+QueryPath::QueryPath()
+{
+}
+
+
+QueryPath::QueryPath(const std::string& path)
+{
+	assign(path);
+}
+
+
+QueryPath::QueryPath(const char* path)
+{
+	assign(path);
+}
+
+
+QueryPath::~QueryPath()
+{
+}
+
+
+void QueryPath::assign(const std::string& path)
+{
+	StepVec steps;
+	parse(path, steps);
+	_path = path;
+	_steps.swap(steps);
+}
+
+
+void QueryPath::parse(const std::string& path, StepVec& steps)
+{
+	steps.clear();
+	std::string::const_iterator it = path.begin();
+	std::string::const_iterator end = path.end();
+	while (it != end)
+	{
+		std::string::const_iterator tokenEnd = it;
+		while (tokenEnd != end && *tokenEnd != '.') ++tokenEnd;
+
+		// The name ends at the first index in brackets;
+		// brackets without a valid index are part of the name.
+		std::string::const_iterator nameEnd = tokenEnd;
+		Step indexStep;
+		indexStep.isIndex = true;
+		std::vector<std::size_t> indexes;
+		for (std::string::const_iterator p = it; p != tokenEnd; ++p)
+		{
+			if (*p != '[') continue;
+			std::string::const_iterator q = p + 1;
+			std::size_t index = 0;
+			bool overflow = false;
+			while (q != tokenEnd && Ascii::isDigit(*q))
+			{
+				std::size_t digit = *q - '0';
+				if (index > (MAX_INDEX - digit)/10) overflow = true;
+				else index = index*10 + digit;
+				++q;
+			}
+			if (q == p + 1 || q == tokenEnd || *q != ']') continue;
+			if (overflow) throw SyntaxException("Not a valid integer", std::string(p + 1, q));
+
+			if (indexes.empty()) nameEnd = p;
+			indexes.push_back(index);
+			p = q;
+		}
+
+		if (nameEnd != it)
+		{
+			Step nameStep;
+			nameStep.name.assign(it, nameEnd);
+			nameStep.index = 0;
+			nameStep.isIndex = false;
+			steps.push_back(nameStep);
+		}
+		for (std::vector<std::size_t>::const_iterator itIndex = indexes.begin(); itIndex != indexes.end(); ++itIndex)
+		{
+			indexStep.index = *itIndex;
+			steps.push_back(indexStep);
+		}
+
+		it = tokenEnd;
+		if (it != end) ++it;
+	}
+}
+
+
+Var QueryPath::find(const Var& source) const
+{
+	const Var* pResult = findPtr(source);
+	return pResult ? *pResult : Var();
+}
+
+
+const Var* QueryPath::findPtr(const Var& source) const
+{
+	const Var* pValue = &source;
+	for (StepVec::const_iterator it = _steps.begin(); it != _steps.end() && pValue; ++it)
+	{
+		pValue = step(*pValue, *it);
+	}
+	return pValue;
+}
+
+
+Document::Value QueryPath::find(const Document::Value& source) const
+{
+	Document::Value value = source;
+	for (StepVec::const_iterator it = _steps.begin(); it != _steps.end() && value.isValid(); ++it)
+	{
+		value = step(value, *it);
+	}
+	return value;
+}
+
+
+const Var* QueryPath::step(const Var& value, const Step& step)
+{
+	const std::type_info& type = value.type();
+	if (step.isIndex)
+	{
+		const Array* pArray = 0;
+		if (type == typeid(Array::Ptr))
+			pArray = value.extract<Array::Ptr>().get();
+		else if (type == typeid(Array))
+			pArray = &value.extract<Array>();
+
+		if (pArray && step.index < pArray->size())
+			return &*(pArray->begin() + step.index);
+	}
+	else
+	{
+		const Object* pObject = 0;
+		if (type == typeid(Object::Ptr))
+			pObject = value.extract<Object::Ptr>().get();
+		else if (type == typeid(Object))
+			pObject = &value.extract<Object>();
+
+		if (pObject)
+		{
+			Object::ConstIterator it = pObject->find(step.name);
+			if (it != pObject->end()) return &it->second;
+		}
+	}
+	return 0;
+}
+
+
+Document::Value QueryPath::step(const Document::Value& value, const Step& step)
+{
+	if (step.isIndex)
+		return value.get(step.index);
+	else
+		return value.get(StringRef(step.name));
+}
+
+
+} } // namespace Poco::JSON
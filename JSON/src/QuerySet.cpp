@@ -0,0 +1,186 @@
+//
+// QuerySet.cpp
+//
+// Library: JSON
+// Package: JSON
+// Module:  QuerySet
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/JSON/QuerySet.h"
+
+
+using Poco::Dynamic::Var;
+
+
+namespace Poco {
+namespace JSON {
+
+
+const std::size_t QuerySet::NO_NODE;
+
+
+QuerySet::QuerySet():
+	_nodes(1)
+{
+	_nodes[0].step.index = 0;
+	_nodes[0].step.isIndex = false;
+	_nodes[0].nameChildren = 0;
+	_nodes[0].indexChildren = 0;
+}
+
+
+QuerySet::~QuerySet()
+{
+}
+
+
+std::size_t QuerySet::add(const std::string& path)
+{
+	QueryPath queryPath(path);
+	std::size_t node = 0;
+	const QueryPath::StepVec& steps = queryPath.steps();
+	for (QueryPath::StepVec::const_iterator it = steps.begin(); it != steps.end(); ++it)
+	{
+		std::size_t next = it->isIndex ? child(node, it->index) : child(node, it->name);
+		if (next == NO_NODE)
+		{
+			next = _nodes.size();
+			Node newNode;
+			newNode.step = *it;
+			newNode.nameChildren = 0;
+			newNode.indexChildren = 0;
+			_nodes.push_back(newNode);
+			_nodes[node].children.push_back(next);
+			if (it->isIndex)
+				++_nodes[node].indexChildren;
+			else
+				++_nodes[node].nameChildren;
+		}
+		node = next;
+	}
+	_nodes[node].paths.push_back(_paths.size());
+	_paths.push_back(queryPath);
+	return _paths.size() - 1;
+}
+
+
+void QuerySet::find(const Var& source, VarVec& results) const
+{
+	results.resize(_paths.size());
+	for (VarVec::iterator it = results.begin(); it != results.end(); ++it)
+	{
+		it->empty();
+	}
+	findNode(0, source, results);
+}
+
+
+void QuerySet::find(const Document::Value& source, ValueVec& results) const
+{
+	results.assign(_paths.size(), Document::Value());
+	if (source.isValid()) findNode(0, source, results);
+}
+
+
+std::size_t QuerySet::child(std::size_t node, const std::string& name) const
+{
+	const std::vector<std::size_t>& children = _nodes[node].children;
+	for (std::vector<std::size_t>::const_iterator it = children.begin(); it != children.end(); ++it)
+	{
+		const QueryPath::Step& step = _nodes[*it].step;
+		if (!step.isIndex && step.name == name) return *it;
+	}
+	return NO_NODE;
+}
+
+
+std::size_t QuerySet::child(std::size_t node, std::size_t index) const
+{
+	const std::vector<std::size_t>& children = _nodes[node].children;
+	for (std::vector<std::size_t>::const_iterator it = children.begin(); it != children.end(); ++it)
+	{
+		const QueryPath::Step& step = _nodes[*it].step;
+		if (step.isIndex && step.index == index) return *it;
+	}
+	return NO_NODE;
+}
+
+
+void QuerySet::findNode(std::size_t node, const Var& value, VarVec& results) const
+{
+	const Node& n = _nodes[node];
+	for (std::vector<std::size_t>::const_iterator it = n.paths.begin(); it != n.paths.end(); ++it)
+	{
+		results[*it] = value;
+	}
+	for (std::vector<std::size_t>::const_iterator it = n.children.begin(); it != n.children.end(); ++it)
+	{
+		const Var* pChild = QueryPath::step(value, _nodes[*it].step);
+		if (pChild) findNode(*it, *pChild, results);
+	}
+}
+
+
+void QuerySet::findNode(std::size_t node, const Document::Value& value, ValueVec& results) const
+{
+	const Node& n = _nodes[node];
+	for (std::vector<std::size_t>::const_iterator it = n.paths.begin(); it != n.paths.end(); ++it)
+	{
+		results[*it] = value;
+	}
+	if (n.children.empty()) return;
+
+	if (n.children.size() == 1)
+	{
+		Document::Value childValue = QueryPath::step(value, _nodes[n.children[0]].step);
+		if (childValue.isValid()) findNode(n.children[0], childValue, results);
+		return;
+	}
+
+	// Several children: look at every member or element once.
+	if (value.isObject() && n.nameChildren > 0)
+	{
+		std::size_t remaining = n.nameChildren;
+		for (Document::Iterator it = value.begin(), end = value.end(); it != end && remaining > 0; ++it)
+		{
+			StringRef key = it.key();
+			for (std::vector<std::size_t>::const_iterator itChild = n.children.begin(); itChild != n.children.end(); ++itChild)
+			{
+				const QueryPath::Step& step = _nodes[*itChild].step;
+				if (!step.isIndex && key == StringRef(step.name))
+				{
+					findNode(*itChild, it.value(), results);
+					--remaining;
+					break;
+				}
+			}
+		}
+	}
+	else if (value.isArray() && n.indexChildren > 0)
+	{
+		std::size_t remaining = n.indexChildren;
+		std::size_t index = 0;
+		for (Document::Iterator it = value.begin(), end = value.end(); it != end && remaining > 0; ++it, ++index)
+		{
+			for (std::vector<std::size_t>::const_iterator itChild = n.children.begin(); itChild != n.children.end(); ++itChild)
+			{
+				const QueryPath::Step& step = _nodes[*itChild].step;
+				if (step.isIndex && step.index == index)
+				{
+					findNode(*itChild, it.value(), results);
+					--remaining;
+					break;
+				}
+			}
+		}
+	}
+}
+
+
+} } // namespace Poco::JSON
@@ -15,7 +15,9 @@
 #include "Poco/JSON/Stringifier.h"
 #include "Poco/JSON/Array.h"
 #include "Poco/JSON/Object.h"
+#include "Poco/JSON/Writer.h"
 #include <iomanip>
+#include <cmath>
 
 
 using Poco::Dynamic::Var;
@@ -31,6 +33,14 @@ void Stringifier::stringify(const Var& any, std::ostream& out, unsigned int inde
 
 	if (step == -1) step = indent;
 
+	if (indent == 0 && step == 0 && (options & Poco::JSON_WRAP_STRINGS))
+	{
+		Writer writer(out, options);
+		writer.value(any);
+		writer.flush();
+		return;
+	}
+
 	if (any.type() == typeid(Object))
 	{
 		Object& o = const_cast<Object&>(any.extract<Object>());
@@ -59,6 +69,12 @@ void Stringifier::stringify(const Var& any, std::ostream& out, unsigned int inde
 	{
 		out << "null";
 	}
+	else if ((any.type() == typeid(double) && !std::isfinite(any.extract<double>())) ||
+		(any.type() == typeid(float) && !std::isfinite(any.extract<float>())))
+	{
+		// JSON cannot represent infinity and NaN.
+		out << "null";
+	}
 	else if (any.isNumeric() || any.isBoolean())
 	{
 		std::string value = any.convert<std::string>();
@@ -0,0 +1,822 @@
+//
+// Tape.cpp
+//
+// Library: JSON
+// Package: JSON
+// Module:  Tape
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/JSON/Tape.h"
+#include "Poco/JSON/JSONException.h"
+#include "Poco/JSON/Handler.h"
+#include "Poco/UTF8Encoding.h"
+#include "Poco/NumberParser.h"
+#include "Poco/NumericString.h"
+#include "Poco/CPUFeatures.h"
+#include <limits>
+#if defined(POCO_HAVE_X86_INTRINSICS)
+#include <smmintrin.h>
+#include <wmmintrin.h>
+#endif
+
+
+namespace
+{
+	using Poco::UInt8;
+	using Poco::UInt32;
+	using Poco::UInt64;
+
+	enum CharClass
+	{
+		CC_QUOTE      = 0x01,
+		CC_BACKSLASH  = 0x02,
+		CC_OPERATOR   = 0x04, // { } [ ] : ,
+		CC_WHITESPACE = 0x08,
+		CC_DIGIT      = 0x10
+	};
+
+	struct CharClassTable
+	{
+		UInt8 classes[256];
+
+		CharClassTable()
+		{
+			std::memset(classes, 0, sizeof(classes));
+			classes[static_cast<UInt8>('"')]  = CC_QUOTE;
+			classes[static_cast<UInt8>('\\')] = CC_BACKSLASH;
+			const char* ops = "{}[]:,";
+			for (const char* p = ops; *p; ++p) classes[static_cast<UInt8>(*p)] = CC_OPERATOR;
+			const char* ws = " \t\n\r";
+			for (const char* p = ws; *p; ++p) classes[static_cast<UInt8>(*p)] = CC_WHITESPACE;
+			for (char c = '0'; c <= '9'; ++c) classes[static_cast<UInt8>(c)] = CC_DIGIT;
+		}
+	};
+
+	const CharClassTable charClasses;
+
+	inline bool isDigit(char c)
+	{
+		return (charClasses.classes[static_cast<UInt8>(c)] & CC_DIGIT) != 0;
+	}
+
+	inline bool isTerminator(char c)
+	{
+		return (charClasses.classes[static_cast<UInt8>(c)] & (CC_OPERATOR | CC_WHITESPACE)) != 0;
+	}
+
+	struct BlockMasks
+	{
+		UInt64 quote;
+		UInt64 backslash;
+		UInt64 op;
+		UInt64 whitespace;
+	};
+
+	void classifyPortable(const char* block, BlockMasks& masks)
+	{
+		masks.quote = masks.backslash = masks.op = masks.whitespace = 0;
+		for (int i = 0; i < 64; ++i)
+		{
+			UInt64 bit = static_cast<UInt64>(1) << i;
+			UInt8 cc = charClasses.classes[static_cast<UInt8>(block[i])];
+			if (cc & CC_QUOTE) masks.quote |= bit;
+			if (cc & CC_BACKSLASH) masks.backslash |= bit;
+			if (cc & CC_OPERATOR) masks.op |= bit;
+			if (cc & CC_WHITESPACE) masks.whitespace |= bit;
+		}
+	}
+
+	inline UInt64 prefixXorPortable(UInt64 x)
+	{
+		x ^= x << 1;
+		x ^= x << 2;
+		x ^= x << 4;
+		x ^= x << 8;
+		x ^= x << 16;
+		x ^= x << 32;
+		return x;
+	}
+
+#if defined(POCO_HAVE_X86_INTRINSICS)
+
+	POCO_TARGET("sse4.2")
+	inline void classifySSE(const char* block, BlockMasks& masks)
+	{
+		masks.quote = masks.backslash = masks.op = masks.whitespace = 0;
+		for (int i = 0; i < 4; ++i)
+		{
+			__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16*i));
+			// '[' and ']' differ from '{' and '}' only in bit 5
+			__m128i lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+			__m128i op = _mm_or_si128(
+				_mm_or_si128(_mm_cmpeq_epi8(lower, _mm_set1_epi8('{')), _mm_cmpeq_epi8(lower, _mm_set1_epi8('}'))),
+				_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(':')), _mm_cmpeq_epi8(v, _mm_set1_epi8(','))));
+			__m128i ws = _mm_or_si128(
+				_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\t'))),
+				_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\r'))));
+			int shift = 16*i;
+			masks.quote      |= static_cast<UInt64>(static_cast<UInt32>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('"'))))) << shift;
+			masks.backslash  |= static_cast<UInt64>(static_cast<UInt32>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('\\'))))) << shift;
+			masks.op         |= static_cast<UInt64>(static_cast<UInt32>(_mm_movemask_epi8(op))) << shift;
+			masks.whitespace |= static_cast<UInt64>(static_cast<UInt32>(_mm_movemask_epi8(ws))) << shift;
+		}
+	}
+
+	POCO_TARGET("pclmul,sse4.2")
+	inline UInt64 prefixXorCLMUL(UInt64 x)
+	{
+		// carry-less multiplication by all ones computes the prefix XOR
+		__m128i product = _mm_clmulepi64_si128(_mm_set_epi64x(0, static_cast<Poco::Int64>(x)), _mm_set1_epi8(-1), 0);
+		UInt64 result;
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(&result), product);
+		return result;
+	}
+
+#endif // POCO_HAVE_X86_INTRINSICS
+
+	inline int countTrailingZeros(UInt64 x)
+	{
+#if defined(__GNUC__)
+		return __builtin_ctzll(x);
+#else
+		int n = 0;
+		while ((x & 1) == 0)
+		{
+			x >>= 1;
+			++n;
+		}
+		return n;
+#endif
+	}
+
+	class StructuralScanner
+		/// Computes the structural positions of a document,
+		/// block by block, carrying state across blocks.
+	{
+	public:
+		StructuralScanner():
+			_escapeCarry(0),
+			_inStringCarry(0),
+			_scalarCarry(0)
+		{
+		}
+
+		UInt64 structurals(const BlockMasks& masks, UInt64 inString)
+			/// Takes the prefix XOR of the unescaped quotes
+			/// of the block and returns its structurals.
+		{
+			inString ^= _inStringCarry;
+			_inStringCarry = static_cast<UInt64>(static_cast<Poco::Int64>(inString) >> 63);
+
+			UInt64 scalar = ~(masks.op | masks.whitespace);
+			UInt64 nonQuoteScalar = scalar & ~masks.quote;
+			UInt64 follows = (nonQuoteScalar << 1) | _scalarCarry;
+			_scalarCarry = nonQuoteScalar >> 63;
+			UInt64 starts = scalar & ~follows;
+
+			// Opening quotes are part of the string, closing quotes are not.
+			return ((masks.op | starts) & ~inString & ~masks.quote) | (masks.quote & inString);
+		}
+
+		UInt64 escaped(UInt64 backslash)
+			/// Returns the characters escaped by a backslash.
+		{
+			UInt64 escaped = _escapeCarry;
+			_escapeCarry = 0;
+			backslash &= ~escaped;
+			while (backslash)
+			{
+				int i = countTrailingZeros(backslash);
+				backslash &= backslash - 1;
+				if (i == 63)
+				{
+					_escapeCarry = 1;
+				}
+				else
+				{
+					UInt64 next = static_cast<UInt64>(1) << (i + 1);
+					escaped |= next;
+					backslash &= ~next;
+				}
+			}
+			return escaped;
+		}
+
+		bool inString() const
+		{
+			return _inStringCarry != 0;
+		}
+
+	private:
+		UInt64 _escapeCarry;
+		UInt64 _inStringCarry;
+		UInt64 _scalarCarry;
+	};
+
+	inline UInt32* flatten(UInt32* pOut, UInt32 base, UInt64 bits)
+	{
+		while (bits)
+		{
+			*pOut++ = base + static_cast<UInt32>(countTrailingZeros(bits));
+			bits &= bits - 1;
+		}
+		return pOut;
+	}
+
+	inline unsigned hexValue(char c)
+	{
+		if (c >= '0' && c <= '9') return c - '0';
+		if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+		if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+		return 16;
+	}
+
+	template <typename S>
+	inline void appendUTF8(S& str, UInt32 cp)
+	{
+		if (cp < 0x80)
+		{
+			str += static_cast<char>(cp);
+		}
+		else if (cp < 0x800)
+		{
+			str += static_cast<char>(0xC0 | (cp >> 6));
+			str += static_cast<char>(0x80 | (cp & 0x3F));
+		}
+		else if (cp < 0x10000)
+		{
+			str += static_cast<char>(0xE0 | (cp >> 12));
+			str += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+			str += static_cast<char>(0x80 | (cp & 0x3F));
+		}
+		else
+		{
+			str += static_cast<char>(0xF0 | (cp >> 18));
+			str += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+			str += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+			str += static_cast<char>(0x80 | (cp & 0x3F));
+		}
+	}
+
+	const double powersOf10[] =
+	{
+		1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+}
+
+
+namespace Poco {
+namespace JSON {
+
+
+Tape::Tape():
+	_pJSON(0),
+	_length(0),
+	_depth(-1),
+	_allowNullByte(true)
+{
+}
+
+
+Tape::Tape(Arena& arena):
+	_pJSON(0),
+	_length(0),
+	_index(ArenaAllocator<UInt32>(arena)),
+	_words(ArenaAllocator<UInt64>(arena)),
+	_stack(ArenaAllocator<std::size_t>(arena)),
+	_decoded(ArenaAllocator<char>(arena)),
+	_depth(-1),
+	_allowNullByte(true)
+{
+}
+
+
+Tape::~Tape()
+{
+}
+
+
+void Tape::clear()
+{
+	_words.clear();
+	_decoded.clear();
+	_pJSON = 0;
+	_length = 0;
+}
+
+
+void Tape::parse(const char* json, std::size_t length)
+{
+	clear();
+	if (length >= std::numeric_limits<UInt32>::max())
+		throw JSONException("JSON document too large");
+	if (!UTF8Encoding::isValid(json, length))
+		throw JSONException("No legal UTF8 found");
+
+	_pJSON = json;
+	_length = length;
+	try
+	{
+		build(index());
+	}
+	catch (...)
+	{
+		clear();
+		throw;
+	}
+}
+
+
+void Tape::emit(std::size_t pos, Handler& handler) const
+{
+	// For each open container: 'k' for an object expecting
+	// a key, 'v' for an object expecting a value, 'a' for an array.
+	std::vector<char> stack;
+	std::string str;
+	const std::size_t end = next(pos);
+	while (pos < end)
+	{
+		Type t = type(pos);
+		if (!stack.empty() && stack.back() == 'k' && t == TYPE_STRING)
+		{
+			getString(pos, str);
+			handler.key(str);
+			stack.back() = 'v';
+			pos += 2;
+			continue;
+		}
+		switch (t)
+		{
+		case TYPE_OBJECT:
+			handler.startObject();
+			stack.push_back('k');
+			++pos;
+			continue;
+		case TYPE_ARRAY:
+			handler.startArray();
+			stack.push_back('a');
+			++pos;
+			continue;
+		case TYPE_OBJECT_END:
+			handler.endObject();
+			stack.pop_back();
+			break;
+		case TYPE_ARRAY_END:
+			handler.endArray();
+			stack.pop_back();
+			break;
+		case TYPE_STRING:
+			getString(pos, str);
+			handler.value(str);
+			break;
+		case TYPE_INT64:
+			handler.value(getInt64(pos));
+			break;
+		case TYPE_UINT64:
+			handler.value(getUInt64(pos));
+			break;
+		case TYPE_DOUBLE:
+			handler.value(getDouble(pos));
+			break;
+		case TYPE_TRUE:
+			handler.value(true);
+			break;
+		case TYPE_FALSE:
+			handler.value(false);
+			break;
+		case TYPE_NULL:
+			handler.null();
+			break;
+		}
+		pos = (t == TYPE_OBJECT_END || t == TYPE_ARRAY_END) ? pos + 1 : next(pos);
+		if (!stack.empty() && stack.back() == 'v') stack.back() = 'k';
+	}
+}
+
+
+std::size_t Tape::index()
+{
+	_index.resize(_length + 1);
+	UInt32* pOut = &_index[0];
+	StructuralScanner scanner;
+
+#if defined(POCO_HAVE_X86_INTRINSICS)
+	const bool useSSE = CPUFeatures::hasSSE42();
+	const bool useCLMUL = useSSE && CPUFeatures::hasPCLMUL();
+#endif
+
+	char tail[BLOCK_SIZE];
+	for (std::size_t pos = 0; pos < _length; pos += BLOCK_SIZE)
+	{
+		const char* block = _pJSON + pos;
+		if (_length - pos < BLOCK_SIZE)
+		{
+			// pad the last block with whitespace
+			std::memset(tail, ' ', BLOCK_SIZE);
+			std::memcpy(tail, block, _length - pos);
+			block = tail;
+		}
+
+		BlockMasks masks;
+		UInt64 inString;
+#if defined(POCO_HAVE_X86_INTRINSICS)
+		if (useSSE)
+			classifySSE(block, masks);
+		else
+#endif
+			classifyPortable(block, masks);
+
+		masks.quote &= ~scanner.escaped(masks.backslash);
+
+#if defined(POCO_HAVE_X86_INTRINSICS)
+		if (useCLMUL)
+			inString = prefixXorCLMUL(masks.quote);
+		else
+#endif
+			inString = prefixXorPortable(masks.quote);
+
+		pOut = flatten(pOut, static_cast<UInt32>(pos), scanner.structurals(masks, inString));
+	}
+	if (scanner.inString())
+		throw JSONException("Unterminated string");
+
+	return static_cast<std::size_t>(pOut - &_index[0]);
+}
+
+
+void Tape::build(std::size_t count)
+{
+	enum State
+	{
+		STATE_VALUE,
+		STATE_KEY,
+		STATE_NEXT
+	};
+
+	const char* json = _pJSON;
+	const UInt32* pIndex = _index.empty() ? 0 : &_index[0];
+	_words.reserve(count + count/2 + 2);
+	_stack.clear();
+
+	if (count == 0) throw JSONException("Empty JSON document");
+
+	std::size_t i = 0;
+	State state = STATE_VALUE;
+	for (;;)
+	{
+		if (state == STATE_VALUE)
+		{
+			if (i == count) throw JSONException("Unexpected end of JSON document");
+			const char* p = json + pIndex[i++];
+			switch (*p)
+			{
+			case '{':
+			case '[':
+				if (_depth >= 0 && _stack.size() >= static_cast<std::size_t>(_depth))
+					throw JSONException("Maximum depth exceeded");
+				_stack.push_back(_words.size());
+				if (*p == '{')
+				{
+					append(TYPE_OBJECT, 0);
+					if (i < count && json[pIndex[i]] == '}')
+					{
+						++i;
+						closeContainer(TYPE_OBJECT_END);
+						state = STATE_NEXT;
+					}
+					else state = STATE_KEY;
+				}
+				else
+				{
+					append(TYPE_ARRAY, 0);
+					if (i < count && json[pIndex[i]] == ']')
+					{
+						++i;
+						closeContainer(TYPE_ARRAY_END);
+						state = STATE_NEXT;
+					}
+				}
+				continue;
+			case '"':
+				parseString(p);
+				break;
+			case 't':
+				parseLiteral(p, "true", 4, TYPE_TRUE);
+				break;
+			case 'f':
+				parseLiteral(p, "false", 5, TYPE_FALSE);
+				break;
+			case 'n':
+				parseLiteral(p, "null", 4, TYPE_NULL);
+				break;
+			case '-': case '0': case '1': case '2': case '3': case '4':
+			case '5': case '6': case '7': case '8': case '9':
+				parseNumber(p);
+				break;
+			default:
+				throw JSONException(std::string("Unexpected character '") + *p + "' in JSON document");
+			}
+			state = STATE_NEXT;
+		}
+		else if (state == STATE_KEY)
+		{
+			if (i == count) throw JSONException("Unexpected end of JSON document");
+			const char* p = json + pIndex[i++];
+			if (*p != '"') throw JSONException("Expected string as object key");
+			parseString(p);
+			if (i == count || json[pIndex[i]] != ':') throw JSONException("Expected ':' after object key");
+			++i;
+			state = STATE_VALUE;
+		}
+		else
+		{
+			if (_stack.empty()) break;
+			if (i == count) throw JSONException("Unexpected end of JSON document");
+			char c = json[pIndex[i++]];
+			bool inObject = type(_stack.back()) == TYPE_OBJECT;
+			if (c == ',')
+			{
+				state = inObject ? STATE_KEY : STATE_VALUE;
+			}
+			else if (inObject && c == '}')
+			{
+				closeContainer(TYPE_OBJECT_END);
+			}
+			else if (!inObject && c == ']')
+			{
+				closeContainer(TYPE_ARRAY_END);
+			}
+			else throw JSONException(inObject ? "Expected ',' or '}' in object" : "Expected ',' or ']' in array");
+		}
+	}
+	if (i != count) throw JSONException("Excess characters found after JSON end.");
+}
+
+
+void Tape::closeContainer(Type type)
+{
+	std::size_t start = _stack.back();
+	_stack.pop_back();
+	append(type, start);
+	_words[start] |= _words.size();
+}
+
+
+inline void Tape::append(Type type, UInt64 payload)
+{
+	_words.push_back((static_cast<UInt64>(type) << TYPE_SHIFT) | payload);
+}
+
+
+inline void Tape::appendValue(Type type, UInt64 value)
+{
+	append(type, 0);
+	_words.push_back(value);
+}
+
+
+const char* Tape::parseString(const char* p)
+{
+	const char* start = ++p;
+	const char* end = _pJSON + _length;
+#if defined(POCO_HAVE_X86_INTRINSICS) && (POCO_ARCH == POCO_ARCH_AMD64)
+	// SSE2 is part of the AMD64 base architecture
+	const __m128i quote = _mm_set1_epi8('"');
+	const __m128i backslash = _mm_set1_epi8('\\');
+	const __m128i control = _mm_set1_epi8(0x1F);
+	while (end - p >= 16)
+	{
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+		__m128i special = _mm_or_si128(
+			_mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)),
+			_mm_cmpeq_epi8(_mm_min_epu8(v, control), v));
+		int mask = _mm_movemask_epi8(special);
+		if (mask)
+		{
+			p += countTrailingZeros(static_cast<UInt64>(mask));
+			break;
+		}
+		p += 16;
+	}
+#endif
+	while (p < end && *p != '"' && *p != '\\' && static_cast<UInt8>(*p) >= 0x20) ++p;
+	if (p == end) throw JSONException("Unterminated string");
+	if (*p == '"')
+	{
+		append(TYPE_STRING, static_cast<UInt64>(start - _pJSON));
+		_words.push_back(static_cast<UInt64>(p - start));
+		return p + 1;
+	}
+	return decodeString(p, start);
+}
+
+
+const char* Tape::decodeString(const char* p, const char* start)
+{
+	std::size_t offset = _decoded.size();
+	_decoded.append(start, p);
+	const char* end = _pJSON + _length;
+	while (p < end && *p != '"')
+	{
+		unsigned char c = static_cast<unsigned char>(*p++);
+		if (c < 0x20)
+		{
+			throw JSONException("unescaped control character in string");
+		}
+		else if (c != '\\')
+		{
+			_decoded += static_cast<char>(c);
+			continue;
+		}
+		if (p == end) break;
+		switch (*p++)
+		{
+		case '"':  _decoded += '"'; break;
+		case '\\': _decoded += '\\'; break;
+		case '/':  _decoded += '/'; break;
+		case 'b':  _decoded += '\b'; break;
+		case 'f':  _decoded += '\f'; break;
+		case 'n':  _decoded += '\n'; break;
+		case 'r':  _decoded += '\r'; break;
+		case 't':  _decoded += '\t'; break;
+		case 'u':
+			{
+				UInt32 cp = 0;
+				for (int n = 0; n < 4; ++n)
+				{
+					unsigned h = p < end ? hexValue(*p++) : 16;
+					if (h > 15) throw JSONException("Invalid unicode escape sequence in string");
+					cp = (cp << 4) | h;
+				}
+				if (cp >= 0xD800 && cp <= 0xDBFF)
+				{
+					UInt32 low = 0;
+					if (end - p >= 6 && p[0] == '\\' && p[1] == 'u')
+					{
+						p += 2;
+						for (int n = 0; n < 4; ++n)
+						{
+							unsigned h = hexValue(*p++);
+							if (h > 15) throw JSONException("Invalid unicode escape sequence in string");
+							low = (low << 4) | h;
+						}
+					}
+					if (low < 0xDC00 || low > 0xDFFF) throw JSONException("Invalid surrogate pair in string");
+					cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+				}
+				else if (cp >= 0xDC00 && cp <= 0xDFFF)
+				{
+					throw JSONException("Dangling surrogate in string");
+				}
+				else if (cp == 0 && !_allowNullByte)
+				{
+					throw JSONException("Null bytes in strings not allowed.");
+				}
+				appendUTF8(_decoded, cp);
+			}
+			break;
+		default:
+			throw JSONException("Invalid escape sequence in string");
+		}
+	}
+	if (p == end) throw JSONException("Unterminated string");
+	append(TYPE_STRING, DECODED_FLAG | offset);
+	_words.push_back(_decoded.size() - offset);
+	return p + 1;
+}
+
+
+const char* Tape::parseLiteral(const char* p, const char* literal, std::size_t length, Type type)
+{
+	const char* end = _pJSON + _length;
+	if (static_cast<std::size_t>(end - p) < length || std::memcmp(p, literal, length) != 0 || (p + length < end && !isTerminator(p[length])))
+		throw JSONException(std::string("Invalid literal, expected '") + literal + "'");
+	append(type, 0);
+	return p + length;
+}
+
+
+const char* Tape::parseNumber(const char* p)
+{
+	const char* start = p;
+	const char* end = _pJSON + _length;
+	bool negative = (*p == '-');
+	if (negative) ++p;
+	if (p == end || !isDigit(*p)) throw JSONException("Invalid number");
+
+	// Accumulate up to 19 significant digits, which always fit into 64 bits.
+	UInt64 mantissa = 0;
+	int digits = 0;
+	int exponent = 0;
+	bool isFloat = false;
+	if (*p == '0')
+	{
+		++p;
+		if (p < end && isDigit(*p)) throw JSONException("Invalid number, leading zeros are not allowed");
+	}
+	else
+	{
+		while (p < end && isDigit(*p))
+		{
+			if (digits < 19)
+			{
+				mantissa = 10*mantissa + (*p - '0');
+				if (mantissa) ++digits;
+			}
+			else ++exponent;
+			++p;
+		}
+	}
+	if (p < end && *p == '.')
+	{
+		isFloat = true;
+		++p;
+		if (p == end || !isDigit(*p)) throw JSONException("Invalid number, expected digits after decimal point");
+		while (p < end && isDigit(*p))
+		{
+			if (digits < 19)
+			{
+				mantissa = 10*mantissa + (*p - '0');
+				if (mantissa) ++digits;
+				--exponent;
+			}
+			++p;
+		}
+	}
+	if (p < end && (*p == 'e' || *p == 'E'))
+	{
+		isFloat = true;
+		++p;
+		bool negativeExponent = false;
+		if (p < end && (*p == '+' || *p == '-'))
+		{
+			negativeExponent = (*p == '-');
+			++p;
+		}
+		if (p == end || !isDigit(*p)) throw JSONException("Invalid number, expected digits in exponent");
+		int exp = 0;
+		while (p < end && isDigit(*p))
+		{
+			if (exp < 100000) exp = 10*exp + (*p - '0');
+			++p;
+		}
+		exponent += negativeExponent ? -exp : exp;
+	}
+	if (p < end && !isTerminator(*p)) throw JSONException("Invalid number");
+
+	if (!isFloat && exponent == 0)
+	{
+		if (!negative && mantissa <= static_cast<UInt64>(std::numeric_limits<Int64>::max()))
+		{
+			appendValue(TYPE_INT64, mantissa);
+			return p;
+		}
+		else if (negative && mantissa <= static_cast<UInt64>(std::numeric_limits<Int64>::max()) + 1)
+		{
+			appendValue(TYPE_INT64, ~mantissa + 1);
+			return p;
+		}
+		else if (!negative)
+		{
+			appendValue(TYPE_UINT64, mantissa);
+			return p;
+		}
+	}
+	if (!isFloat)
+	{
+		// Out of range for 64-bit integers; reject it the way the streaming parser does.
+		appendValue(TYPE_UINT64, NumberParser::parseUnsigned64(std::string(start, p)));
+		return p;
+	}
+
+	double d;
+	if (digits < 19 && mantissa <= (static_cast<UInt64>(1) << 53) && exponent >= -22 && exponent <= 22)
+	{
+		// Both the mantissa and the power of ten are exact, so a single
+		// multiplication or division yields the correctly rounded result.
+		d = static_cast<double>(mantissa);
+		if (exponent < 0)
+			d /= powersOf10[-exponent];
+		else
+			d *= powersOf10[exponent];
+		if (negative) d = -d;
+	}
+	else if (!strToDouble(start, static_cast<std::size_t>(p - start), d))
+	{
+		throw JSONException("Invalid number");
+	}
+	UInt64 bits;
+	std::memcpy(&bits, &d, sizeof(bits));
+	appendValue(TYPE_DOUBLE, bits);
+	return p;
+}
+
+
+} } // namespace Poco::JSON
@@ -14,9 +14,12 @@
 
 #include "Poco/JSON/Template.h"
 #include "Poco/JSON/TemplateCache.h"
-#include "Poco/JSON/Query.h"
+#include "Poco/JSON/Object.h"
+#include "Poco/JSON/Array.h"
 #include "Poco/File.h"
 #include "Poco/FileStream.h"
+#include "Poco/NumberFormatter.h"
+#include "Poco/Ascii.h"
 
 
 using Poco::Dynamic::Var;
@@ -29,342 +32,78 @@ namespace JSON {
 POCO_IMPLEMENT_EXCEPTION(JSONTemplateException, Exception, "Template Exception")
 
 
-class Part
+namespace
 {
-public:
-	Part()
+	struct LoopFrame
+		/// A loop that is active while a template is rendered.
 	{
-	}
-
-	virtual ~Part()
-	{
-	}
-
-	virtual void render(const Var& data, std::ostream& out) const = 0;
-
-	typedef std::vector<SharedPtr<Part> > VectorParts;
-};
-
-
-class StringPart: public Part
-{
-public:
-	StringPart(): Part()
-	{
-	}
-
-	StringPart(const std::string& content): Part(), _content(content)
-	{
-	}
-
-	virtual ~StringPart()
-	{
-	}
-
-	void render(const Var& /*data*/, std::ostream& out) const
-	{
-		out << _content;
-	}
-
-	void setContent(const std::string& content)
-	{
-		_content = content;
-	}
-
-	inline std::string getContent() const
-	{
-		return _content;
-	}
-
-private:
-	std::string _content;
-};
-
-
-class MultiPart: public Part
-{
-public:
-	MultiPart()
-	{
-	}
-
-	virtual ~MultiPart()
-	{
-	}
-
-	virtual void addPart(Part* part)
-	{
-		_parts.push_back(part);
-	}
-
-	void render(const Var& data, std::ostream& out) const
-	{
-		for (VectorParts::const_iterator it = _parts.begin(); it != _parts.end(); ++it)
-		{
-			(*it)->render(data, out);
-		}
-	}
+		Array::Ptr  array;
+		std::size_t index;
+	};
 
-protected:
-	VectorParts _parts;
-};
 
+	const std::size_t NO_INSTRUCTION = static_cast<std::size_t>(-1);
 
-class EchoPart: public Part
-{
-public:
-	EchoPart(const std::string& query): Part(), _query(query)
-	{
-	}
 
-	virtual ~EchoPart()
+	const Var* lookup(const Var& data, const QueryPath& query)
 	{
-	}
-
-	void render(const Var& data, std::ostream& out) const
-	{
-		Query query(data);
-		Var value = query.find(_query);
-
-		if (!value.isEmpty())
-		{
-			out << value.convert<std::string>();
-		}
-	}
-
-private:
-	std::string _query;
-};
-
-
-class LogicQuery
-{
-public:
-	LogicQuery(const std::string& query): _queryString(query)
-	{
-	}
-
-	virtual ~LogicQuery()
-	{
-	}
-
-	virtual bool apply(const Var& data) const
-	{
-		bool logic = false;
-
-		Query query(data);
-		Var value = query.find(_queryString);
-
-		if (!value.isEmpty()) // When empty, logic will be false
-		{
-			if (value.isString())
-				// An empty string must result in false, otherwise true
-				// Which is not the case when we convert to bool with Var
-			{
-				std::string s = value.convert<std::string>();
-				logic = !s.empty();
-			}
-			else
-			{
-				// All other values, try to convert to bool
-				// An empty object or array will turn into false
-				// all other values depend on the convert<> in Var
-				logic = value.convert<bool>();
-			}
-		}
-
-		return logic;
-	}
-
-protected:
-	std::string _queryString;
-};
-
-
-class LogicExistQuery: public LogicQuery
-{
-public:
-	LogicExistQuery(const std::string& query): LogicQuery(query)
-	{
-	}
-
-	virtual ~LogicExistQuery()
-	{
-	}
-
-	virtual bool apply(const Var& data) const
-	{
-		Query query(data);
-		Var value = query.find(_queryString);
-
-		return !value.isEmpty();
-	}
-};
-
-
-class LogicElseQuery: public LogicQuery
-{
-public:
-	LogicElseQuery(): LogicQuery("")
-	{
-	}
-
-	virtual ~LogicElseQuery()
-	{
-	}
-
-	virtual bool apply(const Var& /*data*/) const
-	{
-		return true;
-	}
-};
-
-
-class LogicPart: public MultiPart
-{
-public:
-	LogicPart(): MultiPart()
-	{
-	}
-
-	virtual ~LogicPart()
-	{
-	}
-
-	void addPart(LogicQuery* query, Part* part)
-	{
-		MultiPart::addPart(part);
-		_queries.push_back(query);
-	}
-
-	void addPart(Part* part)
-	{
-		MultiPart::addPart(part);
-		_queries.push_back(new LogicElseQuery());
-	}
-
-	void render(const Var& data, std::ostream& out) const
-	{
-		int count = 0;
-		for (std::vector<SharedPtr<LogicQuery> >::const_iterator it = _queries.begin(); it != _queries.end(); ++it, ++count)
-		{
-			if ((*it)->apply(data) && _parts.size() > count)
-			{
-				_parts[count]->render(data, out);
-				break;
-			}
-		}
-	}
-
-private:
-	std::vector<SharedPtr<LogicQuery> > _queries;
-};
-
+		const std::type_info& type = data.type();
+		if (!data.isEmpty() &&
+			type != typeid(Object::Ptr) &&
+			type != typeid(Object) &&
+			type != typeid(Array::Ptr) &&
+			type != typeid(Array))
+			throw InvalidArgumentException("Only JSON Object, Array or pointers thereof allowed.");
 
-class LoopPart: public MultiPart
-{
-public:
-	LoopPart(const std::string& name, const std::string& query): MultiPart(), _name(name), _query(query)
-	{
+		return query.findPtr(data);
 	}
 
-	virtual ~LoopPart()
-	{
-	}
 
-	void render(const Var& data, std::ostream& out) const
+	bool isTrue(const Var* pValue)
 	{
-		Query query(data);
-
-		if (data.type() == typeid(Object::Ptr))
-		{
-			Object::Ptr dataObject = data.extract<Object::Ptr>();
-			Array::Ptr array = query.findArray(_query);
-			if (!array.isNull())
-			{
-				for (int i = 0; i < array->size(); i++)
-				{
-					Var value = array->get(i);
-					dataObject->set(_name, value);
-					MultiPart::render(data, out);
-				}
-				dataObject->remove(_name);
-			}
-		}
-	}
-
-private:
-	std::string _name;
-	std::string _query;
-};
-
-
-class IncludePart: public Part
-{
-public:
+		if (pValue == 0 || pValue->isEmpty()) return false;
 
-	IncludePart(const Path& parentPath, const Path& path):
-		Part(),
-		_path(path)
-	{
-		// When the path is relative, try to make it absolute based
-		// on the path of the parent template. When the file doesn't
-		// exist, we keep it relative and hope that the cache can
-		// resolve it.
-		if (_path.isRelative())
-		{
-			Path templatePath(parentPath, _path);
-			File templateFile(templatePath);
-			if (templateFile.exists())
-			{
-				_path = templatePath;
-			}
-		}
+		// An empty string must result in false, otherwise true,
+		// which is not the case when we convert to bool with Var.
+		// An empty object or array will turn into false, all
+		// other values depend on the convert<> in Var.
+		if (pValue->type() == typeid(std::string))
+			return !pValue->extract<std::string>().empty();
+		else if (pValue->isString())
+			return !pValue->convert<std::string>().empty();
+		else
+			return pValue->convert<bool>();
 	}
 
-	virtual ~IncludePart()
-	{
-	}
 
-	void render(const Var& data, std::ostream& out) const
+	void append(std::string& out, const Var& value)
 	{
-		TemplateCache* cache = TemplateCache::instance();
-		if (cache == 0)
-		{
-			Template tpl(_path);
-			tpl.parse();
-			tpl.render(data, out);
-		}
+		const std::type_info& type = value.type();
+		if (type == typeid(std::string))
+			out += value.extract<std::string>();
+		else if (type == typeid(int))
+			NumberFormatter::append(out, value.extract<int>());
+		else if (type == typeid(Int64))
+			NumberFormatter::append(out, value.extract<Int64>());
 		else
-		{
-			Template::Ptr tpl = cache->getTemplate(_path);
-			tpl->render(data, out);
-		}
+			out += value.convert<std::string>();
 	}
-
-private:
-	Path _path;
-};
+}
 
 
 Template::Template(const Path& templatePath):
-	_parts(0),
-	_currentPart(0),
 	_templatePath(templatePath)
 {
 }
 
 
-Template::Template():
-	_parts(0),
-	_currentPart(0)
+Template::Template()
 {
 }
 
 
 Template::~Template()
 {
-	delete _parts;
 }
 
 
@@ -383,15 +122,21 @@ void Template::parse(std::istream& in)
 {
 	_parseTime.update();
 
-	_parts = new MultiPart;
-	_currentPart = _parts;
+	_instructions.clear();
+	_text.clear();
+	_includes.clear();
+
+	std::vector<Block> blocks;
 
 	while (in.good())
 	{
 		std::string text = readText(in); // Try to read text first
 		if (text.length() > 0)
 		{
-			_currentPart->addPart(new StringPart(text));
+			std::size_t i = emit(Instruction::OP_TEXT);
+			_instructions[i].offset = _text.size();
+			_instructions[i].length = text.size();
+			_text += text;
 		}
 
 		if (in.bad())
@@ -412,7 +157,7 @@ void Template::parse(std::istream& in)
 			{
 				throw JSONTemplateException("Missing query in <? echo ?>");
 			}
-			_currentPart->addPart(new EchoPart(query));
+			emit(Instruction::OP_ECHO, query);
 		}
 		else if (command.compare("for") == 0)
 		{
@@ -429,27 +174,30 @@ void Template::parse(std::istream& in)
 				throw JSONTemplateException("Missing query in <? for ?> command");
 			}
 
-			_partStack.push(_currentPart);
-			LoopPart* part = new LoopPart(loopVariable, query);
-			_partStack.push(part);
-			_currentPart->addPart(part);
-			_currentPart = part;
+			Block block;
+			block.loop = true;
+			block.start = emit(Instruction::OP_FOR, query);
+			block.pending = NO_INSTRUCTION;
+			_instructions[block.start].name = loopVariable;
+			blocks.push_back(block);
 		}
 		else if (command.compare("else") == 0)
 		{
-			if (_partStack.size() == 0)
+			if (blocks.empty())
 			{
 				throw JSONTemplateException("Unexpected <? else ?> found");
 			}
-			_currentPart = _partStack.top();
-			LogicPart* lp = dynamic_cast<LogicPart*>(_currentPart);
-			if (lp == 0)
+			Block& block = blocks.back();
+			if (block.loop)
 			{
 				throw JSONTemplateException("Missing <? if ?> or <? ifexist ?> for <? else ?>");
 			}
-			MultiPart* part = new MultiPart();
-			lp->addPart(part);
-			_currentPart = part;
+			block.exits.push_back(emit(Instruction::OP_JUMP));
+			if (block.pending != NO_INSTRUCTION)
+			{
+				_instructions[block.pending].target = _instructions.size();
+			}
+			block.pending = NO_INSTRUCTION;
 		}
 		else if (command.compare("elsif") == 0 || command.compare("elif") == 0)
 		{
@@ -459,54 +207,49 @@ void Template::parse(std::istream& in)
 				throw JSONTemplateException("Missing query in <? " + command + " ?>");
 			}
 
-			if (_partStack.size() == 0)
+			if (blocks.empty())
 			{
 				throw JSONTemplateException("Unexpected <? elsif / elif ?> found");
 			}
 
-			_currentPart = _partStack.top();
-			LogicPart* lp = dynamic_cast<LogicPart*>(_currentPart);
-			if (lp == 0)
+			Block& block = blocks.back();
+			if (block.loop)
 			{
 				throw JSONTemplateException("Missing <? if ?> or <? ifexist ?> for <? elsif / elif ?>");
 			}
-			MultiPart* part = new MultiPart();
-			lp->addPart(new LogicQuery(query), part);
-			_currentPart = part;
+			block.exits.push_back(emit(Instruction::OP_JUMP));
+			if (block.pending != NO_INSTRUCTION)
+			{
+				_instructions[block.pending].target = _instructions.size();
+				block.pending = emit(Instruction::OP_IF, query);
+			}
+			// After an <? else ?>, the condition can never be reached.
 		}
 		else if (command.compare("endfor") == 0)
 		{
-			if (_partStack.size() < 2)
+			if (blocks.empty())
 			{
 				throw JSONTemplateException("Unexpected <? endfor ?> found");
 			}
-			MultiPart* loopPart = _partStack.top();
-			LoopPart* lp = dynamic_cast<LoopPart*>(loopPart);
-			if (lp == 0)
+			if (!blocks.back().loop)
 			{
 				throw JSONTemplateException("Missing <? for ?> command");
 			}
-			_partStack.pop();
-			_currentPart = _partStack.top();
-			_partStack.pop();
+			endBlock(blocks.back());
+			blocks.pop_back();
 		}
 		else if (command.compare("endif") == 0)
 		{
-			if (_partStack.size() < 2)
+			if (blocks.empty())
 			{
 				throw JSONTemplateException("Unexpected <? endif ?> found");
 			}
-
-			_currentPart = _partStack.top();
-			LogicPart* lp = dynamic_cast<LogicPart*>(_currentPart);
-			if (lp == 0)
+			if (blocks.back().loop)
 			{
 				throw JSONTemplateException("Missing <? if ?> or <? ifexist ?> for <? endif ?>");
 			}
-
-			_partStack.pop();
-			_currentPart = _partStack.top();
-			_partStack.pop();
+			endBlock(blocks.back());
+			blocks.pop_back();
 		}
 		else if (command.compare("if") == 0 || command.compare("ifexist") == 0)
 		{
@@ -515,19 +258,11 @@ void Template::parse(std::istream& in)
 			{
 				throw JSONTemplateException("Missing query in <? " + command + " ?>");
 			}
-			_partStack.push(_currentPart);
-			LogicPart* lp = new LogicPart();
-			_partStack.push(lp);
-			_currentPart->addPart(lp);
-			_currentPart = new MultiPart();
-			if (command.compare("ifexist") == 0)
-			{
-				lp->addPart(new LogicExistQuery(query), _currentPart);
-			}
-			else
-			{
-				lp->addPart(new LogicQuery(query), _currentPart);
-			}
+			Block block;
+			block.loop = false;
+			block.start = emit(command.compare("ifexist") == 0 ? Instruction::OP_IFEXIST : Instruction::OP_IF, query);
+			block.pending = block.start;
+			blocks.push_back(block);
 		}
 		else if (command.compare("include") == 0)
 		{
@@ -539,9 +274,25 @@ void Template::parse(std::istream& in)
 			}
 			else
 			{
-				Path resolvePath(_templatePath);
-				resolvePath.makeParent();
-				_currentPart->addPart(new IncludePart(resolvePath, filename));
+				// When the path is relative, try to make it absolute based
+				// on the path of this template. When the file doesn't
+				// exist, we keep it relative and hope that the cache can
+				// resolve it.
+				Path includePath(filename);
+				if (includePath.isRelative())
+				{
+					Path parentPath(_templatePath);
+					parentPath.makeParent();
+					Path templatePath(parentPath, includePath);
+					File templateFile(templatePath);
+					if (templateFile.exists())
+					{
+						includePath = templatePath;
+					}
+				}
+				std::size_t i = emit(Instruction::OP_INCLUDE);
+				_instructions[i].offset = _includes.size();
+				_includes.push_back(includePath);
 			}
 		}
 		else
@@ -573,6 +324,56 @@ void Template::parse(std::istream& in)
 			throw JSONTemplateException("Missing ?>");
 		}
 	}
+
+	// Blocks that are not closed end with the template.
+	while (!blocks.empty())
+	{
+		endBlock(blocks.back());
+		blocks.pop_back();
+	}
+}
+
+
+std::size_t Template::emit(Instruction::Opcode opcode)
+{
+	Instruction instruction;
+	instruction.opcode = opcode;
+	instruction.offset = 0;
+	instruction.length = 0;
+	instruction.target = NO_INSTRUCTION;
+	_instructions.push_back(instruction);
+	return _instructions.size() - 1;
+}
+
+
+std::size_t Template::emit(Instruction::Opcode opcode, const std::string& query)
+{
+	std::size_t i = emit(opcode);
+	_instructions[i].query.assign(query);
+	return i;
+}
+
+
+void Template::endBlock(const Block& block)
+{
+	if (block.loop)
+	{
+		std::size_t i = emit(Instruction::OP_ENDFOR);
+		_instructions[i].target = block.start;
+		_instructions[block.start].target = _instructions.size();
+	}
+	else
+	{
+		std::size_t end = _instructions.size();
+		if (block.pending != NO_INSTRUCTION)
+		{
+			_instructions[block.pending].target = end;
+		}
+		for (std::vector<std::size_t>::const_iterator it = block.exits.begin(); it != block.exits.end(); ++it)
+		{
+			_instructions[*it].target = end;
+		}
+	}
 }
 
 
@@ -694,7 +495,132 @@ std::string Template::readString(std::istream& in)
 
 void Template::render(const Var& data, std::ostream& out) const
 {
-	_parts->render(data, out);
+	std::string buffer;
+	render(data, buffer);
+	out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+}
+
+
+void Template::render(const Var& data, std::string& out) const
+{
+	Object::Ptr pDataObject;
+	if (data.type() == typeid(Object::Ptr))
+	{
+		pDataObject = data.extract<Object::Ptr>();
+	}
+
+	std::vector<LoopFrame> loops;
+	const std::size_t count = _instructions.size();
+	std::size_t pc = 0;
+	while (pc < count)
+	{
+		const Instruction& instruction = _instructions[pc];
+		switch (instruction.opcode)
+		{
+		case Instruction::OP_TEXT:
+			out.append(_text, instruction.offset, instruction.length);
+			++pc;
+			break;
+
+		case Instruction::OP_ECHO:
+			{
+				const Var* pValue = lookup(data, instruction.query);
+				if (pValue && !pValue->isEmpty())
+				{
+					append(out, *pValue);
+				}
+				++pc;
+			}
+			break;
+
+		case Instruction::OP_IF:
+			pc = isTrue(lookup(data, instruction.query)) ? pc + 1 : instruction.target;
+			break;
+
+		case Instruction::OP_IFEXIST:
+			{
+				const Var* pValue = lookup(data, instruction.query);
+				pc = (pValue && !pValue->isEmpty()) ? pc + 1 : instruction.target;
+			}
+			break;
+
+		case Instruction::OP_JUMP:
+			pc = instruction.target;
+			break;
+
+		case Instruction::OP_FOR:
+			{
+				const Var* pValue = lookup(data, instruction.query);
+				Array::Ptr array;
+				if (pDataObject && pValue)
+				{
+					if (pValue->type() == typeid(Array::Ptr))
+						array = pValue->extract<Array::Ptr>();
+					else if (pValue->type() == typeid(Array))
+						array = new Array(pValue->extract<Array>());
+				}
+				if (array.isNull())
+				{
+					pc = instruction.target;
+				}
+				else if (array->size() == 0)
+				{
+					pDataObject->remove(instruction.name);
+					pc = instruction.target;
+				}
+				else
+				{
+					LoopFrame frame;
+					frame.array = array;
+					frame.index = 0;
+					loops.push_back(frame);
+					pDataObject->set(instruction.name, array->get(0));
+					++pc;
+				}
+			}
+			break;
+
+		case Instruction::OP_ENDFOR:
+			{
+				LoopFrame& frame = loops.back();
+				const std::string& name = _instructions[instruction.target].name;
+				if (++frame.index < frame.array->size())
+				{
+					pDataObject->set(name, frame.array->get(static_cast<unsigned>(frame.index)));
+					pc = instruction.target + 1;
+				}
+				else
+				{
+					pDataObject->remove(name);
+					loops.pop_back();
+					++pc;
+				}
+			}
+			break;
+
+		case Instruction::OP_INCLUDE:
+			renderInclude(_includes[instruction.offset], data, out);
+			++pc;
+			break;
+		}
+	}
+}
+
+
+void Template::renderInclude(const Path& path, const Var& data, std::string& out) const
+{
+	TemplateCache* cache = TemplateCache::instance();
+	if (cache == 0)
+	{
+		Template tpl(path);
+		tpl.parse();
+		tpl.render(data, out);
+	}
+	else
+	{
+		Template::Ptr tpl = cache->getTemplate(path);
+		tpl->render(data, out);
+	}
 }
 
 
@@ -24,7 +24,8 @@ namespace JSON {
 TemplateCache* TemplateCache::_pInstance = 0;
 
 
-TemplateCache::TemplateCache()
+TemplateCache::TemplateCache():
+	_checkInterval(1, 0)
 {
 	setup();
 }
@@ -45,24 +46,39 @@ void TemplateCache::setup()
 
 Template::Ptr TemplateCache::getTemplate(const Path& path)
 {
+	std::string pathname = path.toString();
+
+	// Return a template that has been checked recently,
+	// without resolving the path or accessing the file again.
+	std::map<std::string, std::string>::const_iterator itResolved = _resolved.find(pathname);
+	if (itResolved != _resolved.end())
+	{
+		EntryMap::iterator it = _cache.find(itResolved->second);
+		if (it != _cache.end() && !it->second.lastCheck.isElapsed(_checkInterval.totalMicroseconds()))
+		{
+			return it->second.pTemplate;
+		}
+	}
+
 	if (_pLogger)
 	{
-		_pLogger->trace("Trying to load %s", path.toString());
+		_pLogger->trace("Trying to load %s", pathname);
 	}
 
 	Path templatePath = resolvePath(path);
 	std::string templatePathname = templatePath.toString();
-	
+	_resolved[pathname] = templatePathname;
+
 	if (_pLogger)
 	{
 		_pLogger->trace("Path resolved to %s", templatePathname);
 	}
-	
+
 	File templateFile(templatePathname);
 
 	Template::Ptr tpl;
 
-	std::map<std::string, Template::Ptr>::iterator it = _cache.find(templatePathname);
+	EntryMap::iterator it = _cache.find(templatePathname);
 	if (it == _cache.end())
 	{
 		if (templateFile.exists())
@@ -72,20 +88,7 @@ Template::Ptr TemplateCache::getTemplate(const Path& path)
 				_pLogger->information("Loading template %s", templatePath.toString());
 			}
 
-			tpl = new Template(templatePath);
-
-			try
-			{
-				tpl->parse();
-				_cache[templatePathname] = tpl;
-			}
-			catch (JSONTemplateException& jte)
-			{
-				if (_pLogger)
-				{
-					_pLogger->error("Template %s contains an error: %s", templatePath.toString(), jte.message());
-				}
-			}
+			tpl = loadTemplate(templatePath, templatePathname);
 		}
 		else
 		{
@@ -98,7 +101,7 @@ Template::Ptr TemplateCache::getTemplate(const Path& path)
 	}
 	else
 	{
-		tpl = it->second;
+		tpl = it->second.pTemplate;
 		if (tpl->parseTime() < templateFile.getLastModified())
 		{
 			if (_pLogger)
@@ -106,20 +109,34 @@ Template::Ptr TemplateCache::getTemplate(const Path& path)
 				_pLogger->information("Reloading template %s", templatePath.toString());
 			}
 
-			tpl = new Template(templatePath);
+			tpl = loadTemplate(templatePath, templatePathname);
+		}
+		else
+		{
+			it->second.lastCheck.update();
+		}
+	}
 
-			try
-			{
-				tpl->parse();
-				_cache[templatePathname] = tpl;
-			}
-			catch (JSONTemplateException& jte)
-			{
-				if (_pLogger)
-				{
-					_pLogger->error("Template %s contains an error: %s", templatePath.toString(), jte.message());
-				}
-			}
+	return tpl;
+}
+
+
+Template::Ptr TemplateCache::loadTemplate(const Path& templatePath, const std::string& templatePathname)
+{
+	Template::Ptr tpl = new Template(templatePath);
+
+	try
+	{
+		tpl->parse();
+		Entry& entry = _cache[templatePathname];
+		entry.pTemplate = tpl;
+		entry.lastCheck.update();
+	}
+	catch (JSONTemplateException& jte)
+	{
+		if (_pLogger)
+		{
+			_pLogger->error("Template %s contains an error: %s", templatePath.toString(), jte.message());
 		}
 	}
 
@@ -0,0 +1,621 @@
+//
+// Writer.cpp
+//
+// Library: JSON
+// Package: JSON
+// Module:  Writer
+//
+// Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/JSON/Writer.h"
+#include "Poco/JSON/Object.h"
+#include "Poco/JSON/Array.h"
+#include "Poco/JSON/JSONException.h"
+#include "Poco/NumericString.h"
+#include "Poco/CPUFeatures.h"
+#include <cstring>
+#include <cmath>
+#if defined(POCO_HAVE_X86_INTRINSICS) && (POCO_ARCH == POCO_ARCH_AMD64)
+#include <emmintrin.h>
+#endif
+
+
+namespace
+{
+	const char DIGIT_PAIRS[] =
+		"00010203040506070809"
+		"10111213141516171819"
+		"20212223242526272829"
+		"30313233343536373839"
+		"40414243444546474849"
+		"50515253545556575859"
+		"60616263646566676869"
+		"70717273747576777879"
+		"80818283848586878889"
+		"90919293949596979899";
+
+	const char HEX_DIGITS[] = "0123456789ABCDEF";
+
+	const int MAX_NUMBER_LENGTH = 64;
+
+	inline int countTrailingZeros(unsigned x)
+	{
+#if defined(__GNUC__)
+		return __builtin_ctz(x);
+#else
+		int n = 0;
+		while ((x & 1) == 0)
+		{
+			x >>= 1;
+			++n;
+		}
+		return n;
+#endif
+	}
+}
+
+
+namespace Poco {
+namespace JSON {
+
+
+Writer::Writer(std::ostream& out, int options, unsigned int indent):
+	_pStream(&out),
+	_pString(0),
+	_buffer(DEFAULT_BUFFER_SIZE)
+{
+	init(options, indent);
+}
+
+
+Writer::Writer(std::string& str, int options, unsigned int indent):
+	_pStream(0),
+	_pString(&str),
+	_buffer(DEFAULT_BUFFER_SIZE)
+{
+	init(options, indent);
+}
+
+
+Writer::~Writer()
+{
+	try
+	{
+		flush();
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
+}
+
+
+void Writer::init(int options, unsigned int indent)
+{
+	_pPos = _buffer.begin();
+	_pEnd = _buffer.end();
+	_indent = indent;
+	_escapeUnicode = (options & Poco::JSON_ESCAPE_UNICODE) != 0;
+	_first = true;
+	_afterKey = false;
+}
+
+
+void Writer::startObject()
+{
+	beforeValue();
+	writeChar('{');
+	_stack.push_back('{');
+	_first = true;
+}
+
+
+void Writer::endObject()
+{
+	beforeEnd('{');
+	writeChar('}');
+	afterValue();
+}
+
+
+void Writer::startArray()
+{
+	beforeValue();
+	writeChar('[');
+	_stack.push_back('[');
+	_first = true;
+}
+
+
+void Writer::endArray()
+{
+	beforeEnd('[');
+	writeChar(']');
+	afterValue();
+}
+
+
+void Writer::key(const std::string& name)
+{
+	key(name.data(), name.size());
+}
+
+
+void Writer::key(const char* name)
+{
+	key(name, std::strlen(name));
+}
+
+
+void Writer::key(const char* name, std::size_t length)
+{
+	if (_stack.empty() || _stack.back() != '{' || _afterKey)
+		throw JSONException("Writer: key outside of object or key without value");
+
+	if (!_first) writeChar(',');
+	if (_indent > 0) newLine(_stack.size());
+	writeString(name, length);
+	if (_indent > 0)
+		writeRaw(": ", 2);
+	else
+		writeChar(':');
+	_first = false;
+	_afterKey = true;
+}
+
+
+void Writer::value(const std::string& value)
+{
+	beforeValue();
+	writeString(value.data(), value.size());
+	afterValue();
+}
+
+
+void Writer::value(const char* value)
+{
+	beforeValue();
+	writeString(value, std::strlen(value));
+	afterValue();
+}
+
+
+void Writer::value(const char* value, std::size_t length)
+{
+	beforeValue();
+	writeString(value, length);
+	afterValue();
+}
+
+
+void Writer::value(int v)
+{
+	beforeValue();
+	writeInteger(v < 0 ? 0 - static_cast<UInt64>(v) : static_cast<UInt64>(v), v < 0);
+	afterValue();
+}
+
+
+void Writer::value(unsigned v)
+{
+	beforeValue();
+	writeInteger(v, false);
+	afterValue();
+}
+
+
+#if defined(POCO_HAVE_INT64)
+
+
+void Writer::value(Int64 v)
+{
+	beforeValue();
+	writeInteger(v < 0 ? 0 - static_cast<UInt64>(v) : static_cast<UInt64>(v), v < 0);
+	afterValue();
+}
+
+
+void Writer::value(UInt64 v)
+{
+	beforeValue();
+	writeInteger(v, false);
+	afterValue();
+}
+
+
+#endif
+
+
+void Writer::value(double d)
+{
+	beforeValue();
+	if (std::isfinite(d))
+	{
+		reserve(MAX_NUMBER_LENGTH);
+		doubleToStr(_pPos, MAX_NUMBER_LENGTH, d);
+		_pPos += std::strlen(_pPos);
+	}
+	else writeRaw("null", 4);
+	afterValue();
+}
+
+
+void Writer::value(float f)
+{
+	beforeValue();
+	if (std::isfinite(f))
+	{
+		reserve(MAX_NUMBER_LENGTH);
+		floatToStr(_pPos, MAX_NUMBER_LENGTH, f);
+		_pPos += std::strlen(_pPos);
+	}
+	else writeRaw("null", 4);
+	afterValue();
+}
+
+
+void Writer::value(bool b)
+{
+	beforeValue();
+	if (b)
+		writeRaw("true", 4);
+	else
+		writeRaw("false", 5);
+	afterValue();
+}
+
+
+void Writer::null()
+{
+	beforeValue();
+	writeRaw("null", 4);
+	afterValue();
+}
+
+
+void Writer::value(const Object& object)
+{
+	startObject();
+	object.forEach([this](const std::string& name, const Dynamic::Var& v)
+	{
+		key(name);
+		value(v);
+	});
+	endObject();
+}
+
+
+void Writer::value(const Array& array)
+{
+	startArray();
+	for (Array::ConstIterator it = array.begin(); it != array.end(); ++it)
+	{
+		value(*it);
+	}
+	endArray();
+}
+
+
+void Writer::value(const Dynamic::Var& any)
+{
+	const std::type_info& type = any.type();
+	if (type == typeid(Object::Ptr))
+	{
+		value(*any.extract<Object::Ptr>());
+	}
+	else if (type == typeid(Array::Ptr))
+	{
+		value(*any.extract<Array::Ptr>());
+	}
+	else if (type == typeid(Object))
+	{
+		value(any.extract<Object>());
+	}
+	else if (type == typeid(Array))
+	{
+		value(any.extract<Array>());
+	}
+	else if (any.isEmpty())
+	{
+		null();
+	}
+	else if (type == typeid(std::string))
+	{
+		value(any.extract<std::string>());
+	}
+	else if (type == typeid(double))
+	{
+		value(any.extract<double>());
+	}
+	else if (type == typeid(float))
+	{
+		value(any.extract<float>());
+	}
+	else if (type == typeid(bool))
+	{
+		value(any.extract<bool>());
+	}
+	else if (type == typeid(char))
+	{
+		char c = any.extract<char>();
+		value(&c, 1);
+	}
+	else if (any.isInteger())
+	{
+		beforeValue();
+		if (any.isSigned())
+		{
+			Int64 v = any.convert<Int64>();
+			writeInteger(v < 0 ? 0 - static_cast<UInt64>(v) : static_cast<UInt64>(v), v < 0);
+		}
+		else writeInteger(any.convert<UInt64>(), false);
+		afterValue();
+	}
+	else if (any.isNumeric() || any.isBoolean())
+	{
+		beforeValue();
+		std::string str = any.convert<std::string>();
+		writeRaw(str.data(), str.size());
+		afterValue();
+	}
+	else if (any.isString() || any.isDateTime() || any.isDate() || any.isTime())
+	{
+		value(any.convert<std::string>());
+	}
+	else
+	{
+		beforeValue();
+		std::string str = any.convert<std::string>();
+		writeRaw(str.data(), str.size());
+		afterValue();
+	}
+}
+
+
+void Writer::endLine()
+{
+	if (!_stack.empty() || _first)
+		throw JSONException("Writer: no complete top-level value to end");
+
+	writeChar('\n');
+	_first = true;
+}
+
+
+void Writer::flush()
+{
+	flushBuffer();
+}
+
+
+void Writer::beforeValue()
+{
+	if (_stack.empty())
+	{
+		// Separate several top-level values, as in JSON Lines.
+		if (!_first) writeChar('\n');
+	}
+	else if (_stack.back() == '{')
+	{
+		if (!_afterKey) throw JSONException("Writer: object member without key");
+	}
+	else
+	{
+		if (!_first) writeChar(',');
+		if (_indent > 0) newLine(_stack.size());
+	}
+	_afterKey = false;
+}
+
+
+void Writer::afterValue()
+{
+	_first = false;
+}
+
+
+void Writer::beforeEnd(char type)
+{
+	if (_stack.empty() || _stack.back() != type)
+		throw JSONException(type == '{' ? "Writer: no object to end" : "Writer: no array to end");
+	if (_afterKey)
+		throw JSONException("Writer: key without value");
+
+	_stack.pop_back();
+	if (_indent > 0 && !_first) newLine(_stack.size());
+}
+
+
+void Writer::newLine(std::size_t level)
+{
+	std::size_t n = level*_indent + 1;
+	reserve(n);
+	if (n > static_cast<std::size_t>(_pEnd - _pPos))
+	{
+		writeChar('\n');
+		for (std::size_t i = 1; i < n; ++i) writeChar(' ');
+		return;
+	}
+	*_pPos = '\n';
+	std::memset(_pPos + 1, ' ', n - 1);
+	_pPos += n;
+}
+
+
+void Writer::writeString(const char* str, std::size_t length)
+{
+	writeChar('"');
+	writeEscaped(str, str + length);
+	writeChar('"');
+}
+
+
+void Writer::writeEscaped(const char* p, const char* end)
+{
+	const char* run = p;
+	for (;;)
+	{
+#if defined(POCO_HAVE_X86_INTRINSICS) && (POCO_ARCH == POCO_ARCH_AMD64)
+		// SSE2 is part of the AMD64 base architecture
+		const __m128i quote = _mm_set1_epi8('"');
+		const __m128i backslash = _mm_set1_epi8('\\');
+		const __m128i slash = _mm_set1_epi8('/');
+		const __m128i control = _mm_set1_epi8(0x1F);
+		const __m128i high = _mm_set1_epi8(0x7F);
+		while (end - p >= 16)
+		{
+			__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+			__m128i special = _mm_or_si128(
+				_mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)),
+				_mm_or_si128(_mm_cmpeq_epi8(v, slash), _mm_cmpeq_epi8(_mm_min_epu8(v, control), v)));
+			if (_escapeUnicode)
+				special = _mm_or_si128(special, _mm_cmpeq_epi8(_mm_max_epu8(v, high), v));
+			int mask = _mm_movemask_epi8(special);
+			if (mask)
+			{
+				p += countTrailingZeros(static_cast<unsigned>(mask));
+				break;
+			}
+			p += 16;
+		}
+#endif
+		while (p < end)
+		{
+			UInt8 c = static_cast<UInt8>(*p);
+			if (c < 0x20 || c == '"' || c == '\\' || c == '/' || (c >= 0x7F && _escapeUnicode)) break;
+			++p;
+		}
+		if (p == end) break;
+
+		writeRaw(run, p - run);
+
+		UInt32 ch = static_cast<UInt8>(*p++);
+		char esc = 0;
+		switch (ch)
+		{
+		case '"':  esc = '"'; break;
+		case '\\': esc = '\\'; break;
+		case '/':  esc = '/'; break;
+		case '\n': esc = 'n'; break;
+		case '\t': esc = 't'; break;
+		case '\r': esc = 'r'; break;
+		case '\b': esc = 'b'; break;
+		case '\f': esc = 'f'; break;
+		default:   break;
+		}
+		if (esc)
+		{
+			reserve(2);
+			*_pPos++ = '\\';
+			*_pPos++ = esc;
+		}
+		else
+		{
+			if (ch >= 0x80)
+			{
+				// Decode a UTF-8 sequence the same lenient
+				// way as UTF8::escape() does.
+				static const UInt32 offsetsFromUTF8[6] =
+				{
+					0x00000000UL, 0x00003080UL, 0x000E2080UL,
+					0x03C82080UL, 0xFA082080UL, 0x82082080UL
+				};
+				unsigned sz = 1;
+				while (p < end && (*p & 0xC0) == 0x80 && sz < 6)
+				{
+					ch = (ch << 6) + static_cast<UInt8>(*p++);
+					++sz;
+				}
+				ch -= offsetsFromUTF8[sz - 1];
+			}
+			UInt32 units[2];
+			int count = 1;
+			units[0] = ch;
+			if (ch > 0xFFFF)
+			{
+				ch -= 0x10000;
+				units[0] = ((ch >> 10) & 0x03FF) + 0xD800;
+				units[1] = (ch & 0x03FF) + 0xDC00;
+				count = 2;
+			}
+			for (int i = 0; i < count; ++i)
+			{
+				reserve(6);
+				*_pPos++ = '\\';
+				*_pPos++ = 'u';
+				*_pPos++ = HEX_DIGITS[(units[i] >> 12) & 0xF];
+				*_pPos++ = HEX_DIGITS[(units[i] >> 8) & 0xF];
+				*_pPos++ = HEX_DIGITS[(units[i] >> 4) & 0xF];
+				*_pPos++ = HEX_DIGITS[units[i] & 0xF];
+			}
+		}
+		run = p;
+	}
+	writeRaw(run, p - run);
+}
+
+
+void Writer::writeInteger(UInt64 v, bool negative)
+{
+	char buffer[24];
+	char* pEnd = buffer + sizeof(buffer);
+	char* p = pEnd;
+	while (v >= 100)
+	{
+		unsigned i = static_cast<unsigned>(v % 100)*2;
+		v /= 100;
+		*--p = DIGIT_PAIRS[i + 1];
+		*--p = DIGIT_PAIRS[i];
+	}
+	if (v >= 10)
+	{
+		unsigned i = static_cast<unsigned>(v)*2;
+		*--p = DIGIT_PAIRS[i + 1];
+		*--p = DIGIT_PAIRS[i];
+	}
+	else *--p = static_cast<char>('0' + v);
+	if (negative) *--p = '-';
+	writeRaw(p, pEnd - p);
+}
+
+
+void Writer::writeRaw(const char* str, std::size_t length)
+{
+	if (static_cast<std::size_t>(_pEnd - _pPos) < length)
+	{
+		flushBuffer();
+		if (length > _buffer.size())
+		{
+			if (_pStream)
+				_pStream->write(str, static_cast<std::streamsize>(length));
+			else
+				_pString->append(str, length);
+			return;
+		}
+	}
+	std::memcpy(_pPos, str, length);
+	_pPos += length;
+}
+
+
+void Writer::flushBuffer()
+{
+	std::size_t length = _pPos - _buffer.begin();
+	if (length == 0) return;
+
+	if (_pStream)
+	{
+		_pStream->write(_buffer.begin(), static_cast<std::streamsize>(length));
+		if (!*_pStream) throw JSONException("Writer: cannot write to stream");
+	}
+	else _pString->append(_buffer.begin(), length);
+	_pPos = _buffer.begin();
+}
+
+
+} } // namespace Poco::JSON
@@ -12,10 +12,16 @@
 #include "Poco/CppUnit/TestCaller.h"
 #include "Poco/CppUnit/TestSuite.h"
 #include "Poco/Path.h"
+#include "Poco/Arena.h"
 #include "Poco/Environment.h"
 #include "Poco/File.h"
 #include "Poco/FileStream.h"
 #include "Poco/Glob.h"
+#include "Poco/StreamCopier.h"
+#include "Poco/NumberFormatter.h"
+#include "Poco/NumberParser.h"
+#include "Poco/String.h"
+#include "Poco/Stopwatch.h"
 #include "Poco/UTF8Encoding.h"
 #include "Poco/Latin1Encoding.h"
 #include "Poco/TextConverter.h"
@@ -23,7 +29,9 @@
 #include "Poco/Dynamic/Struct.h"
 #include "Poco/DateTime.h"
 #include "Poco/DateTimeFormatter.h"
+#include "Poco/JSON/TemplateCache.h"
 #include <set>
+#include <limits>
 #include <iostream>
 
 
@@ -1140,6 +1148,12 @@ void JSONTest::testQuery()
 	std::string firstChild = query.findValue("children[0]", "");
 	assertTrue (firstChild.compare("Jonas") == 0);
 
+	// an index applied to a value that is not an array is ignored,
+	// except with a QueryPath
+	assertTrue (query.find("name[0]") == "Franky");
+	assertTrue (query.find("address[1].city") == "The City");
+	assertTrue (query.find(QueryPath("name[0]")).isEmpty());
+
 	Poco::DynamicStruct ds = *result.extract<Object::Ptr>();
 	assertTrue (ds["name"] == "Franky");
 	assertTrue (ds["children"].size() == 2);
@@ -2168,6 +2182,2177 @@ void JSONTest::testMove()
 }
 
 
+void JSONTest::testIndexedParser()
+{
+	const char* docs[] = {
+		"{}",
+		"[]",
+		"[\"a string with more than sixty-four characters, which spans several blocks of the index\"]",
+		"  [ 1 , -2 , 3.5 , -0.25e-3 , 1E10 , 0 , -0 , true , false , null ]  ",
+		"{\"a\":{\"b\":[{\"c\":\"d\"},[],{}]},\"e\":\"\",\"f\":1.7976931348623157e308}",
+		"[12345678901234567890, 9223372036854775807, -9223372036854775808, 0.1, 1234567890123456789012345678.9]",
+		"{\"esc\":\"\\\" \\\\ \\/ \\b\\f\\n\\r\\t \\u00e9 \\ud83d\\ude00 end\",\"k\\\"q\":\"h\xc3\xa9llo w\xe2\x82\xacrld\"}",
+		"[42,-1.5e-7]"
+	};
+
+	for (std::size_t i = 0; i < sizeof(docs)/sizeof(docs[0]); ++i)
+	{
+		Parser parser;
+		Var expected = parser.parse(docs[i]);
+		std::ostringstream expectedStr;
+		Stringifier::stringify(expected, expectedStr);
+
+		parser.reset();
+		parser.setIndexed(true);
+		assertTrue (parser.getIndexed());
+		Var result = parser.parse(docs[i]);
+		std::ostringstream resultStr;
+		Stringifier::stringify(result, resultStr);
+		assertEqual (expectedStr.str(), resultStr.str());
+	}
+
+	Parser parser;
+	parser.setIndexed(true);
+	Var result = parser.parse("{\"int\":-42,\"uint\":18446744073709551615,\"double\":2.5,\"str\":\"x\\ty\"}");
+	Object::Ptr pObject = result.extract<Object::Ptr>();
+	assertTrue (pObject->getValue<Poco::Int64>("int") == -42);
+	assertTrue (pObject->get("uint").type() == typeid(Poco::UInt64));
+	assertTrue (pObject->getValue<Poco::UInt64>("uint") == 18446744073709551615ULL);
+	assertEqualDelta (2.5, pObject->getValue<double>("double"), 0.0);
+	assertTrue (pObject->getValue<std::string>("str") == "x\ty");
+
+	const char* invalid[] = {
+		"",
+		"[1,]",
+		"{\"a\" 1}",
+		"{\"a\":1,}",
+		"[1 2]",
+		"[\"unterminated]",
+		"[tru]",
+		"[truex]",
+		"[01]",
+		"[1.]",
+		"[-]",
+		"[1e]",
+		"[\"\\x\"]",
+		"[\"\\ud800\"]",
+		"{1:2}",
+		"[1]]",
+		"[1] x",
+		"[\"\xc3\x28\"]"
+	};
+
+	for (std::size_t i = 0; i < sizeof(invalid)/sizeof(invalid[0]); ++i)
+	{
+		try
+		{
+			parser.reset();
+			parser.parse(invalid[i]);
+			fail(std::string("must fail: ") + invalid[i]);
+		}
+		catch (Poco::Exception&)
+		{
+		}
+	}
+
+	parser.reset();
+	parser.setDepth(2);
+	parser.parse("[[1]]");
+	try
+	{
+		parser.reset();
+		parser.parse("[[[1]]]");
+		fail("must fail: maximum depth exceeded");
+	}
+	catch (JSONException&)
+	{
+	}
+
+	parser.reset();
+	parser.setDepth(-1);
+	parser.setAllowNullByte(false);
+	try
+	{
+		parser.parse("[\"\\u0000\"]");
+		fail("must fail: null byte");
+	}
+	catch (JSONException&)
+	{
+	}
+}
+
+
+void JSONTest::testIndexedJanssonFiles()
+{
+	std::set<std::string> paths;
+	Poco::Glob::glob(Poco::Path(getTestFilesPath("valid")), paths);
+	for (std::set<std::string>::iterator it = paths.begin(); it != paths.end(); ++it)
+	{
+		Poco::Path filePath(*it, "input");
+		if (!filePath.isFile() || !Poco::File(filePath).exists()) continue;
+
+		std::string json;
+		Poco::FileInputStream fis(filePath.toString());
+		Poco::StreamCopier::copyToString(fis, json);
+
+		Parser parser;
+		std::ostringstream expected;
+		Stringifier::stringify(parser.parse(json), expected);
+
+		parser.reset();
+		parser.setIndexed(true);
+		std::ostringstream result;
+		Stringifier::stringify(parser.parse(json), result);
+		assertEqual (expected.str(), result.str());
+	}
+
+	std::set<std::string> invalidPaths;
+	Poco::Glob::glob(Poco::Path(getTestFilesPath("invalid")), invalidPaths);
+	Poco::Glob::glob(Poco::Path(getTestFilesPath("invalid-unicode")), invalidPaths);
+	for (std::set<std::string>::iterator it = invalidPaths.begin(); it != invalidPaths.end(); ++it)
+	{
+		Poco::Path filePath(*it, "input");
+		if (!filePath.isFile() || !Poco::File(filePath).exists()) continue;
+
+		std::string json;
+		Poco::FileInputStream fis(filePath.toString());
+		Poco::StreamCopier::copyToString(fis, json);
+
+		Parser parser;
+		parser.setIndexed(true);
+		parser.setAllowNullByte(false);
+		try
+		{
+			parser.parse(json);
+			fail("must fail: " + filePath.toString());
+		}
+		catch (Poco::Exception&)
+		{
+		}
+	}
+}
+
+
+void JSONTest::testDocument()
+{
+	std::string json = "{ \"name\" : \"Franky\", \"age\" : 42, \"big\" : 18446744073709551615, \"height\" : 1.85, "
+		"\"married\" : false, \"spouse\" : null, \"nick\\tname\" : \"\\u00c4\\\"rger\", "
+		"\"children\" : [ { \"name\" : \"Sonny\", \"age\" : 7 }, { \"name\" : \"Sissy\", \"age\" : 5 } ], \"empty\" : {} }";
+
+	Document doc(json);
+	assertTrue (!doc.empty());
+
+	Document::Value root = doc.root();
+	assertTrue (root.isObject());
+	assertTrue (root.size() == 9);
+	assertTrue (root.has("name"));
+	assertTrue (!root.has("address"));
+
+	assertTrue (root["name"].isString());
+	assertTrue (root["name"].getString() == "Franky");
+	assertTrue (root["name"].getString().toString() == "Franky");
+	assertTrue (root["age"].isInteger());
+	assertTrue (root["age"].getInt64() == 42);
+	assertTrue (root["age"].getUInt64() == 42);
+	assertEqualDelta (42.0, root["age"].getDouble(), 0.0);
+	assertTrue (root["big"].getUInt64() == 18446744073709551615ULL);
+	assertEqualDelta (1.85, root["height"].getDouble(), 0.0);
+	assertTrue (root["married"].isBoolean());
+	assertTrue (!root["married"].getBool());
+	assertTrue (root["spouse"].isValid());
+	assertTrue (root["spouse"].isNull());
+	assertTrue (root["nick\tname"].getString() == "\xc3\x84\"rger");
+	assertTrue (root["empty"].isObject());
+	assertTrue (root["empty"].size() == 0);
+	assertTrue (root["empty"].begin() == root["empty"].end());
+
+	assertTrue (!root["address"].isValid());
+	assertTrue (!root["address"]["street"][0].isValid());
+	assertTrue (!root["name"][0].isValid());
+	assertTrue (!root["children"]["name"].isValid());
+	assertTrue (!root["children"][2].isValid());
+
+	try
+	{
+		root["big"].getInt64();
+		fail("must throw");
+	}
+	catch (Poco::RangeException&)
+	{
+	}
+
+	try
+	{
+		root["name"].getInt64();
+		fail("must throw");
+	}
+	catch (Poco::BadCastException&)
+	{
+	}
+
+	try
+	{
+		root["address"].getString();
+		fail("must throw");
+	}
+	catch (Poco::BadCastException&)
+	{
+	}
+
+	Document::Value children = root["children"];
+	assertTrue (children.isArray());
+	assertTrue (children.size() == 2);
+	assertTrue (children[1]["name"].getString() == "Sissy");
+	assertTrue (doc.find("children[0].name").getString() == "Sonny");
+	assertTrue (doc.find("children[1].age").getInt64() == 5);
+	assertTrue (!doc.find("children[2].age").isValid());
+	assertTrue (!doc.find("children[x]").isValid());
+	assertTrue (!doc.find("name.first").isValid());
+
+	Poco::Int64 sum = 0;
+	for (Document::Iterator it = children.begin(); it != children.end(); ++it)
+	{
+		sum += (*it)["age"].getInt64();
+	}
+	assertTrue (sum == 12);
+
+	std::vector<std::string> names;
+	for (Document::Iterator it = root.begin(); it != root.end(); ++it)
+	{
+		names.push_back(it.key().toString());
+	}
+	assertTrue (names.size() == 9);
+	assertTrue (names[0] == "name");
+	assertTrue (names[6] == "nick\tname");
+	assertTrue (names[8] == "empty");
+
+	Object::Ptr pChild = children[0].asObject();
+	assertTrue (pChild->getValue<std::string>("name") == "Sonny");
+	assertTrue (pChild->getValue<int>("age") == 7);
+
+	Poco::JSON::Array::Ptr pChildren = children.asArray();
+	assertTrue (pChildren->size() == 2);
+	assertTrue (root["age"].asVar() == 42);
+	assertTrue (root["spouse"].asVar().isEmpty());
+
+	Parser parser;
+	std::ostringstream expected;
+	Stringifier::stringify(parser.parse(json), expected);
+	std::ostringstream result;
+	Stringifier::stringify(doc.asVar(), result);
+	assertEqual (expected.str(), result.str());
+
+	doc.setPreserveObjectOrder(true);
+	Object::Ptr pRoot = doc.root().asObject();
+	assertTrue (pRoot->getNames()[0] == "name");
+	assertTrue (pRoot->getNames()[8] == "empty");
+
+	Document array;
+	array.parse(std::string("[1, [2, 3], \"four\"]"));
+	assertTrue (array[1][1].getInt64() == 3);
+	assertTrue (array.root()[2].getString() == "four");
+
+	const char* raw = "{\"a\":[true]}";
+	array.parse(raw, std::strlen(raw));
+	assertTrue (array.find("a[0]").getBool());
+
+	try
+	{
+		array.parse("{\"a\":}");
+		fail("must throw");
+	}
+	catch (JSONException&)
+	{
+	}
+	assertTrue (array.empty());
+	assertTrue (!array.root().isValid());
+}
+
+
+void JSONTest::testDocumentQuery()
+{
+	std::string json = "{ \"name\" : \"Franky\", \"children\" : [ \"Jonas\", \"Ellen\" ], "
+		"\"address\": { \"street\": \"A Street\", \"number\": 123, \"city\":\"The City\"} }";
+
+	Document doc(json);
+	Query query(doc);
+
+	std::string firstChild = query.findValue("children[0]", "");
+	assertTrue (firstChild == "Jonas");
+
+	assertTrue (query.findValue<int>("address.number", 0) == 123);
+	assertTrue (query.findValue<int>("address.zip", 1234) == 1234);
+	assertTrue (query.find("address.zip").isEmpty());
+
+	Object::Ptr pAddress = query.findObject("address");
+	assertTrue (!pAddress.isNull());
+	assertTrue (pAddress->getValue<std::string>("city") == "The City");
+
+	Object address;
+	query.findObject("address", address);
+	assertTrue (address.getValue<int>("number") == 123);
+
+	Poco::JSON::Array::Ptr pChildren = query.findArray("children");
+	assertTrue (!pChildren.isNull());
+	assertTrue (pChildren->getElement<std::string>(1) == "Ellen");
+	assertTrue (query.findArray("address").isNull());
+
+	Query subQuery(doc["address"]);
+	assertTrue (subQuery.findValue("street", "") == "A Street");
+}
+
+
+void JSONTest::testDocumentArena()
+{
+	Poco::Arena arena;
+	std::vector<std::string> messages;
+	for (int i = 0; i < 100; ++i)
+	{
+		messages.push_back("{\"id\":" + Poco::NumberFormatter::format(i) + ",\"name\":\"item\\t" + Poco::NumberFormatter::format(i) + "\",\"tags\":[1,2,3]}");
+	}
+	for (int round = 0; round < 2; ++round)
+	{
+		for (std::size_t i = 0; i < messages.size(); ++i)
+		{
+			Document doc(arena);
+			doc.parse(messages[i].data(), messages[i].size());
+			assertTrue (doc["id"].getInt64() == static_cast<Poco::Int64>(i));
+			assertTrue (doc["name"].getString() == "item\t" + Poco::NumberFormatter::format(i));
+			assertTrue (doc["tags"][2].getInt64() == 3);
+		}
+		assertTrue (arena.allocated() > 0);
+		arena.reset();
+		assertTrue (arena.allocated() == 0);
+	}
+
+	Document doc(arena);
+	try
+	{
+		doc.parse(std::string("{\"a\":[1,2}"));
+		fail ("invalid JSON - must throw");
+	}
+	catch (JSONException&)
+	{
+	}
+	assertTrue (doc.empty());
+	doc.parse(std::string("[\"\\u00e4\"]"));
+	assertTrue (doc[0].getString() == "\xC3\xA4");
+}
+
+
+void JSONTest::testFlatObject()
+{
+	Object obj(Poco::JSON_FLAT_STORAGE);
+	assertTrue (obj.isFlat());
+	assertTrue (obj.size() == 0);
+	assertTrue (obj.begin() == obj.end());
+	assertTrue (obj.find("foo") == obj.end());
+
+	obj.set("foo", 0);
+	obj.set("bar", "baz");
+	obj.set("foo", 1);
+	assertTrue (obj.size() == 2);
+	assertTrue (obj.getValue<int>("foo") == 1);
+	assertTrue (obj.getValue<std::string>("bar") == "baz");
+	assertTrue (obj.has("bar"));
+	assertTrue (!obj.has("baz"));
+	assertTrue (obj.isNull("baz"));
+	assertTrue (obj.optValue<int>("baz", 42) == 42);
+
+	// items stay in insertion order
+	Object::NameList names = obj.getNames();
+	assertTrue (names.size() == 2);
+	assertTrue (names[0] == "foo");
+	assertTrue (names[1] == "bar");
+
+	// enough items to create and grow the hash index
+	for (int i = 0; i < 100; ++i)
+	{
+		obj.set(Poco::NumberFormatter::format(i), i);
+	}
+	assertTrue (obj.size() == 102);
+	for (int i = 0; i < 100; ++i)
+	{
+		assertTrue (obj.getValue<int>(Poco::NumberFormatter::format(i)) == i);
+	}
+	obj.set("50", -50);
+	assertTrue (obj.size() == 102);
+	assertTrue (obj.getValue<int>("50") == -50);
+
+	obj.remove("foo");
+	obj.remove("50");
+	obj.remove("none");
+	assertTrue (obj.size() == 100);
+	assertTrue (!obj.has("foo"));
+	assertTrue (!obj.has("50"));
+	assertTrue (obj.getValue<int>("99") == 99);
+	assertTrue (obj.begin()->first == "bar");
+
+	int sum = 0;
+	for (Object::ConstIterator it = obj.begin(); it != obj.end(); ++it)
+	{
+		if (it->first != "bar") sum += it->second.convert<int>();
+	}
+	assertTrue (sum == 4950 - 50);
+
+	for (Object::Iterator it = obj.begin(); it != obj.end(); ++it)
+	{
+		if (it->first == "bar") it->second = "qux";
+	}
+	assertTrue (obj.getValue<std::string>("bar") == "qux");
+
+	Object copy(obj);
+	assertTrue (copy.isFlat());
+	assertTrue (copy.size() == 100);
+	assertTrue (copy.getValue<int>("42") == 42);
+	assertTrue (copy.getNames() == obj.getNames());
+
+	Object moved(std::move(copy));
+	assertTrue (moved.size() == 100);
+	assertTrue (moved.getValue<int>("42") == 42);
+	assertTrue (copy.size() == 0);
+
+	Object assigned;
+	assigned = moved;
+	assertTrue (assigned.isFlat());
+	assertTrue (assigned.getValue<int>("7") == 7);
+
+	obj.clear();
+	assertTrue (obj.size() == 0);
+	assertTrue (obj.isFlat());
+	obj.set("a", 1);
+	assertTrue (obj.getValue<int>("a") == 1);
+
+	std::string json = "{ \"name\" : \"Homer\", \"age\" : 38, \"wife\" : { \"name\" : \"Marge\", \"age\" : 36 }, \"children\" : [ \"Bart\", \"Lisa\" ] }";
+	Parser parser(new ParseHandler(false, true));
+	Var result = parser.parse(json);
+	Object::Ptr pObject = result.extract<Object::Ptr>();
+	assertTrue (pObject->isFlat());
+	assertTrue (pObject->getObject("wife")->isFlat());
+	assertTrue (pObject->getObject("wife")->getValue<int>("age") == 36);
+	assertTrue (pObject->getArray("children")->size() == 2);
+
+	std::ostringstream ostr;
+	Stringifier::condense(result, ostr);
+	assertTrue (ostr.str() == "{\"name\":\"Homer\",\"age\":38,\"wife\":{\"name\":\"Marge\",\"age\":36},\"children\":[\"Bart\",\"Lisa\"]}");
+
+	Poco::DynamicStruct ds = *pObject;
+	assertTrue (ds["wife"]["name"] == "Marge");
+	assertTrue (ds["children"][1] == "Lisa");
+
+	Query query(result);
+	assertTrue (query.findValue<int>("wife.age", 0) == 36);
+}
+
+
+void JSONTest::testObjectStorageBenchmark()
+{
+	const int count = 200000;
+	const char* keys[] = { "id", "name", "email", "active", "score", "tags" };
+	const int keyCount = sizeof(keys)/sizeof(keys[0]);
+
+	for (int flat = 0; flat < 2; ++flat)
+	{
+		Poco::Stopwatch sw;
+		std::vector<Object::Ptr> objects;
+		objects.reserve(count);
+		sw.start();
+		for (int i = 0; i < count; ++i)
+		{
+			Object::Ptr pObject = new Object(flat ? Poco::JSON_FLAT_STORAGE : 0);
+			for (int k = 0; k < keyCount; ++k)
+			{
+				pObject->set(keys[k], i);
+			}
+			objects.push_back(pObject);
+		}
+		sw.stop();
+		Poco::Timestamp::TimeDiff build = sw.elapsed();
+
+		Poco::Int64 sum = 0;
+		sw.restart();
+		for (int i = 0; i < count; ++i)
+		{
+			sum += objects[i]->get(keys[i % keyCount]).extract<int>();
+		}
+		sw.stop();
+		Poco::Timestamp::TimeDiff lookup = sw.elapsed();
+
+		sw.restart();
+		for (int i = 0; i < count; ++i)
+		{
+			for (Object::ConstIterator it = objects[i]->begin(); it != objects[i]->end(); ++it)
+			{
+				sum += it->second.extract<int>();
+			}
+		}
+		sw.stop();
+		Poco::Timestamp::TimeDiff iteration = sw.elapsed();
+
+		std::cout << (flat ? "flat: " : "map:  ") << "build " << build/1000 << " ms, lookup " << lookup/1000 << " ms, iteration " << iteration/1000 << " ms (" << sum << ")" << std::endl;
+	}
+}
+
+
+void JSONTest::testWriter()
+{
+	std::ostringstream ostr;
+	Writer writer(ostr);
+	writer.startObject();
+	writer.key("name");
+	writer.value("Homer");
+	writer.key("age");
+	writer.value(38);
+	writer.key("children");
+	writer.startArray();
+	writer.value("Bart");
+	writer.value(std::string("Lisa"));
+	writer.startObject();
+	writer.endObject();
+	writer.startArray();
+	writer.endArray();
+	writer.endArray();
+	writer.key("weight");
+	writer.value(108.5);
+	writer.key("married");
+	writer.value(true);
+	writer.key("job");
+	writer.null();
+	assertTrue (writer.depth() == 1);
+	writer.endObject();
+	assertTrue (writer.depth() == 0);
+	writer.flush();
+	assertEquals ("{\"name\":\"Homer\",\"age\":38,\"children\":[\"Bart\",\"Lisa\",{},[]],\"weight\":108.5,\"married\":true,\"job\":null}", ostr.str());
+
+	Object ordered(Poco::JSON_PRESERVE_KEY_ORDER);
+	ordered.set("z", 1);
+	ordered.set("a", 2);
+	ordered.set("m", 3);
+	Object sorted;
+	sorted.set("z", 1);
+	sorted.set("a", 2);
+	std::string names;
+	ordered.forEach([&names](const std::string& name, const Var&) { names += name; });
+	assertEquals ("zam", names);
+	std::string objects;
+	{
+		Writer objectWriter(objects);
+		objectWriter.startArray();
+		objectWriter.value(ordered);
+		objectWriter.value(sorted);
+		objectWriter.endArray();
+	}
+	assertEquals ("[{\"z\":1,\"a\":2,\"m\":3},{\"a\":2,\"z\":1}]", objects);
+
+	std::string str;
+	{
+		Writer strWriter(str);
+		strWriter.startArray();
+		strWriter.value(0);
+		strWriter.value(-1);
+		strWriter.value(std::numeric_limits<int>::min());
+		strWriter.value(std::numeric_limits<unsigned>::max());
+#if defined(POCO_HAVE_INT64)
+		strWriter.value(std::numeric_limits<Poco::Int64>::min());
+		strWriter.value(std::numeric_limits<Poco::UInt64>::max());
+#endif
+		strWriter.value(0.1);
+		strWriter.value(1.5f);
+		strWriter.value(std::numeric_limits<double>::infinity());
+		strWriter.value(false);
+		strWriter.endArray();
+		strWriter.startArray();
+		strWriter.endArray();
+	}
+#if defined(POCO_HAVE_INT64)
+	assertEquals ("[0,-1,-2147483648,4294967295,-9223372036854775808,18446744073709551615,0.1,1.5,null,false]\n[]", str);
+#else
+	assertEquals ("[0,-1,-2147483648,4294967295,0.1,1.5,null,false]\n[]", str);
+#endif
+
+	str.clear();
+	{
+		Writer indentWriter(str, 0, 2);
+		indentWriter.startObject();
+		indentWriter.key("a");
+		indentWriter.startArray();
+		indentWriter.value(1);
+		indentWriter.value(2);
+		indentWriter.endArray();
+		indentWriter.key("b");
+		indentWriter.startObject();
+		indentWriter.endObject();
+		indentWriter.endObject();
+	}
+	assertEquals ("{\n  \"a\": [\n    1,\n    2\n  ],\n  \"b\": {}\n}", str);
+
+	std::string json = "{\"a\":[1,2.5,\"x\",true,null,{\"b\":{}}],\"c\":\"d\"}";
+	Parser parser;
+	Var result = parser.parse(json);
+	str.clear();
+	{
+		Writer varWriter(str);
+		varWriter.value(result);
+	}
+	std::ostringstream condensed;
+	Stringifier::condense(result, condensed);
+	assertEquals (condensed.str(), str);
+
+	Writer misuse(str);
+	try
+	{
+		misuse.key("a");
+		fail ("key outside of object - must throw");
+	}
+	catch (JSONException&)
+	{
+	}
+	try
+	{
+		misuse.endObject();
+		fail ("no object to end - must throw");
+	}
+	catch (JSONException&)
+	{
+	}
+	misuse.startObject();
+	try
+	{
+		misuse.value(1);
+		fail ("value without key - must throw");
+	}
+	catch (JSONException&)
+	{
+	}
+	misuse.key("a");
+	try
+	{
+		misuse.endObject();
+		fail ("key without value - must throw");
+	}
+	catch (JSONException&)
+	{
+	}
+	try
+	{
+		misuse.endArray();
+		fail ("no array to end - must throw");
+	}
+	catch (JSONException&)
+	{
+	}
+}
+
+
+void JSONTest::testWriterEscape()
+{
+	std::string samples[] =
+	{
+		"",
+		"plain text that is longer than sixteen bytes",
+		"a\"b\\c/d\be\ff\ng\rh\ti",
+		std::string("\x01\x07\x0B\x1F\x7F", 5) + std::string(1, '\0'),
+		"0123456789abcde\"0123456789abcdef\\",
+		"\xC3\xA9t\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x98\x80 and a tail to exercise the vector loop \xC3\xA9",
+		"\x80\xFF lone continuation and invalid bytes"
+	};
+	const int sampleCount = sizeof(samples)/sizeof(samples[0]);
+
+	for (int options = 0; options < 2; ++options)
+	{
+		int flags = options ? Poco::JSON_ESCAPE_UNICODE : 0;
+		for (int i = 0; i < sampleCount; ++i)
+		{
+			std::string str;
+			{
+				Writer writer(str, flags);
+				writer.value(samples[i]);
+			}
+			assertEquals (Poco::toJSON(samples[i], flags | Poco::JSON_WRAP_STRINGS), str);
+		}
+	}
+
+	std::string str;
+	{
+		Writer writer(str, Poco::JSON_ESCAPE_UNICODE);
+		writer.value("a\x1F\x7F/\xC3\xA9\xF0\x9F\x98\x80\x0B");
+	}
+	assertEquals ("\"a\\u001F\\u007F\\/\\u00E9\\uD83D\\uDE00\\u000B\"", str);
+
+	std::string longString(3*Writer::DEFAULT_BUFFER_SIZE, 'x');
+	longString[Writer::DEFAULT_BUFFER_SIZE + 5] = '\n';
+	str.clear();
+	{
+		Writer writer(str);
+		writer.value(longString);
+	}
+	assertEquals (Poco::toJSON(longString, Poco::JSON_WRAP_STRINGS), str);
+}
+
+
+void JSONTest::testWriterBenchmark()
+{
+	const int count = 200000;
+
+	Object::Ptr pObject = new Object;
+	pObject->set("id", 12345);
+	pObject->set("name", "Homer Simpson");
+	pObject->set("email", "homer@springfield.example");
+	pObject->set("score", 98.25);
+	pObject->set("active", true);
+	Poco::JSON::Array::Ptr pTags = new Poco::JSON::Array;
+	pTags->add("donuts");
+	pTags->add("beer");
+	pObject->set("tags", pTags);
+
+	Poco::Stopwatch sw;
+	std::size_t size = 0;
+	sw.start();
+	for (int i = 0; i < count; ++i)
+	{
+		std::ostringstream ostr;
+		Stringifier::condense(pObject, ostr);
+		size += ostr.str().size();
+	}
+	sw.stop();
+	std::cout << "Stringifier: " << sw.elapsed()/1000 << " ms (" << size << " bytes)" << std::endl;
+
+	size = 0;
+	sw.restart();
+	for (int i = 0; i < count; ++i)
+	{
+		std::string str;
+		Writer writer(str);
+		writer.startObject();
+		writer.key("id");
+		writer.value(12345);
+		writer.key("name");
+		writer.value("Homer Simpson");
+		writer.key("email");
+		writer.value("homer@springfield.example");
+		writer.key("score");
+		writer.value(98.25);
+		writer.key("active");
+		writer.value(true);
+		writer.key("tags");
+		writer.startArray();
+		writer.value("donuts");
+		writer.value("beer");
+		writer.endArray();
+		writer.endObject();
+		writer.flush();
+		size += str.size();
+	}
+	sw.stop();
+	std::cout << "Writer:      " << sw.elapsed()/1000 << " ms (" << size << " bytes)" << std::endl;
+}
+
+
+void JSONTest::testPushParser()
+{
+	std::string json = "{ \"name\" : \"Franky\", \"age\" : 42, \"big\" : 18446744073709551615, \"neg\" : -9223372036854775808, "
+		"\"height\" : 1.85e0, \"married\" : false, \"nice\" : true, \"spouse\" : null, \"nick\\tname\" : \"\\u00c4\\\"rger\\ud83d\\ude00\", "
+		"\"utf8\" : \"\xc3\xa9t\xc3\xa9\", \"children\" : [ { \"name\" : \"Sonny\", \"age\" : 7 }, { \"name\" : \"Sissy\", \"age\" : 5 } ], "
+		"\"empty\" : {}, \"none\" : [], \"numbers\" : [0, -0.5, 12e-2, 3E+2] }";
+
+	Parser parser;
+	std::ostringstream expected;
+	Stringifier::condense(parser.parse(json), expected);
+
+	for (std::size_t chunkSize = 1; chunkSize <= json.size(); chunkSize = chunkSize < 8 ? chunkSize + 1 : chunkSize*3)
+	{
+		PushParser pushParser;
+		for (std::size_t pos = 0; pos < json.size(); pos += chunkSize)
+		{
+			assertTrue (!pushParser.done());
+			pushParser.feed(json.data() + pos, std::min(chunkSize, json.size() - pos));
+		}
+		assertTrue (pushParser.done());
+		pushParser.finish();
+		assertTrue (pushParser.offset() == json.size());
+
+		std::ostringstream result;
+		Stringifier::condense(pushParser.result(), result);
+		assertEqual (expected.str(), result.str());
+	}
+
+	PushParser pushParser;
+	pushParser.feed("[1, 2");
+	pushParser.feed("3]  \n");
+	pushParser.finish();
+	Poco::JSON::Array::Ptr pArray = pushParser.result().extract<Poco::JSON::Array::Ptr>();
+	assertTrue (pArray->size() == 2);
+	assertTrue (pArray->getElement<int>(1) == 23);
+
+	pushParser.reset();
+	assertTrue (!pushParser.done());
+	assertTrue (pushParser.offset() == 0);
+	pushParser.feed("{\"a\":[tr");
+	try
+	{
+		pushParser.finish();
+		fail ("incomplete document - must throw");
+	}
+	catch (JSONException&)
+	{
+	}
+	try
+	{
+		pushParser.feed("ue]}");
+		fail ("feed after error - must throw");
+	}
+	catch (JSONException&)
+	{
+	}
+
+	const char* invalid[] =
+	{
+		"{\"a\":1}x",
+		"[1,]",
+		"{\"a\" 1}",
+		"[01]",
+		"[1.]",
+		"[-]",
+		"[1e]",
+		"[tru]",
+		"[nul1]",
+		"[\"\\x\"]",
+		"[\"\\u12G4\"]",
+		"[\"\\ud83d\"]",
+		"[\"\\ude00\"]",
+		"[\"a\tb\"]",
+		"[\"\xc3\"]",
+		"[1}",
+		"{\"a\":1]",
+		"/* comment */ []",
+		"",
+		"   "
+	};
+	for (std::size_t i = 0; i < sizeof(invalid)/sizeof(invalid[0]); ++i)
+	{
+		pushParser.reset();
+		try
+		{
+			pushParser.feed(invalid[i]);
+			pushParser.finish();
+			fail (std::string("must fail: ") + invalid[i]);
+		}
+		catch (JSONException&)
+		{
+		}
+	}
+
+	pushParser.reset();
+	pushParser.setAllowComments(true);
+	pushParser.feed("/* a comment *");
+	pushParser.feed("*/ [1, /* another");
+	pushParser.feed(" one */ 2]/**/");
+	pushParser.finish();
+	assertTrue (pushParser.result().extract<Poco::JSON::Array::Ptr>()->size() == 2);
+
+	pushParser.reset();
+	pushParser.setAllowNullByte(false);
+	try
+	{
+		pushParser.feed("[\"\\u0000\"]");
+		fail ("null byte - must throw");
+	}
+	catch (JSONException&)
+	{
+	}
+
+	pushParser.reset();
+	pushParser.setDepth(2);
+	pushParser.feed("[[1]]");
+	pushParser.finish();
+	pushParser.reset();
+	try
+	{
+		pushParser.feed("[[[1]]]");
+		fail ("maximum depth exceeded - must throw");
+	}
+	catch (JSONException&)
+	{
+	}
+
+	std::ostringstream ostr;
+	PushParser printParser(new PrintHandler(ostr));
+	printParser.feed("{\"a\" : [1, \"b\"]}");
+	printParser.finish();
+	assertEqual ("{\"a\":[1,\"b\"]}", ostr.str());
+}
+
+
+void JSONTest::testPushParserJanssonFiles()
+{
+	std::set<std::string> paths;
+	Poco::Glob::glob(Poco::Path(getTestFilesPath("valid")), paths);
+	for (std::set<std::string>::iterator it = paths.begin(); it != paths.end(); ++it)
+	{
+		Poco::Path filePath(*it, "input");
+		if (!filePath.isFile() || !Poco::File(filePath).exists()) continue;
+
+		std::string json;
+		Poco::FileInputStream fis(filePath.toString());
+		Poco::StreamCopier::copyToString(fis, json);
+
+		Parser parser;
+		std::ostringstream expected;
+		Stringifier::stringify(parser.parse(json), expected);
+
+		PushParser pushParser;
+		for (std::string::const_iterator itc = json.begin(); itc != json.end(); ++itc)
+		{
+			pushParser.feed(&*itc, 1);
+		}
+		pushParser.finish();
+		std::ostringstream result;
+		Stringifier::stringify(pushParser.result(), result);
+		assertEqual (expected.str(), result.str());
+	}
+
+	std::set<std::string> invalidPaths;
+	Poco::Glob::glob(Poco::Path(getTestFilesPath("invalid")), invalidPaths);
+	Poco::Glob::glob(Poco::Path(getTestFilesPath("invalid-unicode")), invalidPaths);
+	for (std::set<std::string>::iterator it = invalidPaths.begin(); it != invalidPaths.end(); ++it)
+	{
+		Poco::Path filePath(*it, "input");
+		if (!filePath.isFile() || !Poco::File(filePath).exists()) continue;
+
+		std::string json;
+		Poco::FileInputStream fis(filePath.toString());
+		Poco::StreamCopier::copyToString(fis, json);
+
+		PushParser pushParser;
+		pushParser.setAllowNullByte(false);
+		try
+		{
+			pushParser.feed(json);
+			pushParser.finish();
+			fail("must fail: " + filePath.toString());
+		}
+		catch (Poco::Exception&)
+		{
+		}
+	}
+}
+
+
+void JSONTest::testNDJSONReader()
+{
+	std::ostringstream ostr;
+	const int count = 1000;
+	for (int i = 0; i < count; ++i)
+	{
+		ostr << "{\"id\":" << i << ",\"name\":\"record " << i << "\",\"tags\":[\"a\",\"b\"]}";
+		if (i % 7 == 0) ostr << '\r';
+		ostr << '\n';
+		if (i % 100 == 0) ostr << "\n  \n";
+	}
+	ostr << "[1,2]\n\"text\"\n42";
+
+	for (std::size_t batchSize = 1; batchSize <= 4096; batchSize *= 8)
+	{
+		std::istringstream istr(ostr.str());
+		NDJSONReader reader(istr);
+		reader.setBatchSize(batchSize);
+		Var record;
+		for (int i = 0; i < count; ++i)
+		{
+			assertTrue (reader.read(record));
+			Object::Ptr pObject = record.extract<Object::Ptr>();
+			assertTrue (pObject->getValue<int>("id") == i);
+			assertTrue (pObject->getValue<std::string>("name") == "record " + Poco::NumberFormatter::format(i));
+			assertTrue (pObject->getArray("tags")->size() == 2);
+		}
+		assertTrue (reader.read(record));
+		assertTrue (record.extract<Poco::JSON::Array::Ptr>()->size() == 2);
+		assertTrue (reader.read(record));
+		assertTrue (record.extract<std::string>() == "text");
+		assertTrue (reader.read(record));
+		assertTrue (record.convert<int>() == 42);
+		assertTrue (reader.lineNumber() == static_cast<std::size_t>(count + 2*(count/100) + 3));
+		assertTrue (!reader.read(record));
+		assertTrue (!reader.read(record));
+	}
+
+	std::istringstream istr("{\"a\":1}\n{\"a\":}\n\n{\"a\":3}\n");
+	NDJSONReader reader(istr);
+	Var record;
+	assertTrue (reader.read(record));
+	assertTrue (record.extract<Object::Ptr>()->getValue<int>("a") == 1);
+	try
+	{
+		reader.read(record);
+		fail ("invalid record - must throw");
+	}
+	catch (JSONException& exc)
+	{
+		assertTrue (exc.message().find("line 2") == 0);
+	}
+	assertTrue (reader.lineNumber() == 2);
+	assertTrue (reader.read(record));
+	assertTrue (record.extract<Object::Ptr>()->getValue<int>("a") == 3);
+	assertTrue (reader.lineNumber() == 4);
+	assertTrue (!reader.read(record));
+
+	std::istringstream orderStr("{\"z\":1,\"a\":2}");
+	NDJSONReader orderReader(orderStr);
+	orderReader.setPreserveObjectOrder(true);
+	assertTrue (orderReader.read(record));
+	std::ostringstream result;
+	Stringifier::condense(record, result);
+	assertEqual ("{\"z\":1,\"a\":2}", result.str());
+}
+
+
+void JSONTest::testNDJSONWriter()
+{
+	std::ostringstream ostr;
+	{
+		NDJSONWriter writer(ostr, 0, 2);
+		Object::Ptr pObject = new Object;
+		pObject->set("a", 1);
+		writer.write(pObject);
+		assertTrue (ostr.str().empty());
+
+		writer.writer().startObject();
+		writer.writer().key("level");
+		writer.writer().value("info");
+		writer.writer().endObject();
+		writer.endRecord();
+		assertEqual ("{\"a\":1}\n{\"level\":\"info\"}\n", ostr.str());
+
+		writer.write(Var("text"));
+		writer.writer().startArray();
+		try
+		{
+			writer.flush();
+			fail ("flush within a record - must throw");
+		}
+		catch (JSONException&)
+		{
+		}
+		try
+		{
+			writer.endRecord();
+			fail ("incomplete record - must throw");
+		}
+		catch (JSONException&)
+		{
+		}
+		writer.writer().endArray();
+		writer.endRecord();
+		assertTrue (writer.count() == 4);
+	}
+	assertEqual ("{\"a\":1}\n{\"level\":\"info\"}\n\"text\"\n[]\n", ostr.str());
+
+	std::istringstream istr(ostr.str());
+	NDJSONReader reader(istr);
+	Var record;
+	int n = 0;
+	while (reader.read(record)) ++n;
+	assertTrue (n == 4);
+}
+
+
+void JSONTest::testNDJSONBenchmark()
+{
+	const int count = 200000;
+	std::ostringstream ostr;
+	{
+		NDJSONWriter writer(ostr);
+		for (int i = 0; i < count; ++i)
+		{
+			writer.writer().startObject();
+			writer.writer().key("id");
+			writer.writer().value(i);
+			writer.writer().key("message");
+			writer.writer().value("The quick brown fox jumps over the lazy dog");
+			writer.writer().key("values");
+			writer.writer().startArray();
+			writer.writer().value(i*0.5);
+			writer.writer().value(true);
+			writer.writer().endArray();
+			writer.writer().endObject();
+			writer.endRecord();
+		}
+	}
+	std::string ndjson = ostr.str();
+
+	Poco::Stopwatch sw;
+	sw.start();
+	std::istringstream lineStr(ndjson);
+	std::string line;
+	Parser parser;
+	int n = 0;
+	while (std::getline(lineStr, line))
+	{
+		parser.reset();
+		parser.parse(line);
+		++n;
+	}
+	sw.stop();
+	std::cout << "Parser, line by line: " << sw.elapsed()/1000 << " ms (" << n << " records)" << std::endl;
+
+	sw.restart();
+	std::istringstream istr(ndjson);
+	NDJSONReader reader(istr);
+	Var record;
+	n = 0;
+	while (reader.read(record)) ++n;
+	sw.stop();
+	std::cout << "NDJSONReader:         " << sw.elapsed()/1000 << " ms (" << n << " records, " << Poco::Environment::processorCount() << " CPUs)" << std::endl;
+}
+
+
+void JSONTest::testQueryPath()
+{
+	QueryPath path("person.children[1][0].name");
+	assertEqual ("person.children[1][0].name", path.toString());
+	assertTrue (path.steps().size() == 5);
+	assertTrue (path.steps()[0].name == "person" && !path.steps()[0].isIndex);
+	assertTrue (path.steps()[1].name == "children");
+	assertTrue (path.steps()[2].isIndex && path.steps()[2].index == 1);
+	assertTrue (path.steps()[3].isIndex && path.steps()[3].index == 0);
+	assertTrue (path.steps()[4].name == "name");
+
+	QueryPath oddPath("a[x].b..c[2");
+	assertTrue (oddPath.steps().size() == 3);
+	assertTrue (oddPath.steps()[0].name == "a[x]");
+	assertTrue (oddPath.steps()[2].name == "c[2");
+
+	QueryPath maxPath("a[2147483647]");
+	assertTrue (maxPath.steps()[1].index == 2147483647);
+	try
+	{
+		QueryPath tooLarge("a[2147483648]");
+		fail("index too large - must throw");
+	}
+	catch (Poco::SyntaxException&)
+	{
+	}
+	try
+	{
+		QueryPath tooLarge("a[1000000000000000000000]");
+		fail("index too large - must throw");
+	}
+	catch (Poco::SyntaxException&)
+	{
+	}
+
+	std::string json = "{ \"person\" : { \"name\" : \"Franky\", \"children\" : [ [ { \"name\" : \"Jonas\" } ], [ { \"name\" : \"Ellen\" } ] ] }, \"a[x]\" : 1 }";
+	Parser parser;
+	Var result = parser.parse(json);
+
+	assertTrue (path.find(result) == "Ellen");
+	assertTrue (QueryPath("person.children[0][0].name").find(result) == "Jonas");
+	assertTrue (QueryPath("person.name").find(result) == "Franky");
+	assertTrue (QueryPath("a[x]").find(result) == 1);
+	assertTrue (QueryPath().find(result).type() == typeid(Object::Ptr));
+	assertTrue (QueryPath("person.children[2]").find(result).isEmpty());
+	assertTrue (QueryPath("person[0]").find(result).isEmpty());
+	assertTrue (QueryPath("person.name.first").find(result).isEmpty());
+	assertTrue (QueryPath("person.name").findPtr(result) != 0);
+	assertTrue (QueryPath("address").findPtr(result) == 0);
+
+	Object object = *result.extract<Object::Ptr>();
+	assertTrue (path.find(Var(object)) == "Ellen");
+
+	Document doc(json);
+	assertTrue (path.find(doc).getString() == "Ellen");
+	assertTrue (!QueryPath("person.children[2]").find(doc).isValid());
+
+	Query query(result);
+	assertTrue (query.find(path) == "Ellen");
+	Query docQuery(doc);
+	assertTrue (docQuery.find(path) == "Ellen");
+}
+
+
+void JSONTest::testQuerySet()
+{
+	std::string json = "{ \"id\" : 42, \"user\" : { \"name\" : \"Franky\", \"tags\" : [ \"a\", \"b\", \"c\" ], \"address\" : { \"city\" : \"The City\" } }, "
+		"\"ignored\" : { \"deep\" : [ 1, 2, { \"x\" : 3 } ] }, \"items\" : [ { \"sku\" : \"x1\" }, { \"sku\" : \"x2\" } ] }";
+
+	QuerySet querySet;
+	std::size_t id = querySet.add("id");
+	std::size_t name = querySet.add("user.name");
+	std::size_t tag = querySet.add("user.tags[2]");
+	std::size_t address = querySet.add("user.address");
+	std::size_t city = querySet.add("user.address.city");
+	std::size_t sku = querySet.add("items[1].sku");
+	std::size_t missing = querySet.add("user.phone");
+	std::size_t name2 = querySet.add("user.name");
+	assertTrue (querySet.size() == 8);
+	assertEqual ("user.tags[2]", querySet.path(tag).toString());
+
+	Parser parser;
+	Var result = parser.parse(json);
+	QuerySet::VarVec vars;
+	querySet.find(result, vars);
+	assertTrue (vars.size() == 8);
+	assertTrue (vars[id] == 42);
+	assertTrue (vars[name] == "Franky");
+	assertTrue (vars[name2] == "Franky");
+	assertTrue (vars[tag] == "c");
+	assertTrue (vars[address].type() == typeid(Object::Ptr));
+	assertTrue (vars[city] == "The City");
+	assertTrue (vars[sku] == "x2");
+	assertTrue (vars[missing].isEmpty());
+
+	Document doc(json);
+	QuerySet::ValueVec values;
+	querySet.find(doc, values);
+	assertTrue (values[id].getInt64() == 42);
+	assertTrue (values[name].getString() == "Franky");
+	assertTrue (values[name2].getString() == "Franky");
+	assertTrue (values[tag].getString() == "c");
+	assertTrue (values[address].isObject());
+	assertTrue (values[city].getString() == "The City");
+	assertTrue (values[sku].getString() == "x2");
+	assertTrue (!values[missing].isValid());
+
+	QueryHandler::Ptr pHandler = new QueryHandler(querySet);
+	Parser handlerParser(pHandler);
+	handlerParser.parse(json);
+	assertTrue (pHandler->result(id) == 42);
+	assertTrue (pHandler->result(name) == "Franky");
+	assertTrue (pHandler->result(name2) == "Franky");
+	assertTrue (pHandler->result(tag) == "c");
+	assertTrue (pHandler->result(address).extract<Object::Ptr>()->getValue<std::string>("city") == "The City");
+	assertTrue (pHandler->result(city) == "The City");
+	assertTrue (pHandler->result(sku) == "x2");
+	assertTrue (pHandler->result(missing).isEmpty());
+
+	PushParser pushParser(pHandler);
+	for (std::string::const_iterator it = json.begin(); it != json.end(); ++it)
+	{
+		pushParser.feed(&*it, 1);
+	}
+	pushParser.finish();
+	assertTrue (pHandler->results().size() == 8);
+	assertTrue (pHandler->result(name) == "Franky");
+	assertTrue (pHandler->result(city) == "The City");
+	assertTrue (pHandler->result(sku) == "x2");
+
+	pHandler->reset();
+	assertTrue (pHandler->result(name).isEmpty());
+}
+
+
+void JSONTest::testQueryPathBenchmark()
+{
+	const int count = 200000;
+	std::string json = "{ \"id\" : 42, \"user\" : { \"name\" : \"Franky\", \"tags\" : [ \"a\", \"b\", \"c\" ], \"address\" : { \"city\" : \"The City\" } }, "
+		"\"items\" : [ { \"sku\" : \"x1\" }, { \"sku\" : \"x2\" } ] }";
+	const char* paths[] = { "id", "user.name", "user.tags[2]", "user.address.city", "items[1].sku" };
+	const int pathCount = sizeof(paths)/sizeof(paths[0]);
+
+	Parser parser;
+	Var result = parser.parse(json);
+	Query query(result);
+	Poco::Stopwatch sw;
+	sw.start();
+	for (int i = 0; i < count; ++i)
+	{
+		for (int k = 0; k < pathCount; ++k) query.find(paths[k]);
+	}
+	sw.stop();
+	std::cout << "Query::find(std::string): " << sw.elapsed()/1000 << " ms" << std::endl;
+
+	std::vector<QueryPath> queryPaths;
+	for (int k = 0; k < pathCount; ++k) queryPaths.push_back(QueryPath(paths[k]));
+	sw.restart();
+	for (int i = 0; i < count; ++i)
+	{
+		for (int k = 0; k < pathCount; ++k) queryPaths[k].findPtr(result);
+	}
+	sw.stop();
+	std::cout << "QueryPath::findPtr():     " << sw.elapsed()/1000 << " ms" << std::endl;
+
+	QuerySet querySet;
+	for (int k = 0; k < pathCount; ++k) querySet.add(paths[k]);
+	Document doc(json);
+	QuerySet::ValueVec values;
+	sw.restart();
+	for (int i = 0; i < count; ++i)
+	{
+		querySet.find(doc, values);
+	}
+	sw.stop();
+	std::cout << "QuerySet::find(Document): " << sw.elapsed()/1000 << " ms" << std::endl;
+}
+
+
+void JSONTest::testTemplateCommands()
+{
+	Template tpl;
+	tpl.parse(
+		"<?for item items?>"
+		"<?if item.done?>+<?elsif item.name?>-<?else?>?<?endif?>"
+		"<?= item.name?>:<?= item.count?>"
+		"<?for tag item.tags?>[<?= tag?>]<?endfor?>;"
+		"<?endfor?>\n"
+		"<?ifexist zero?>zero=<?= zero?><?endif?>"
+		"<?if zero?>true<?else?>false<?endif?>"
+		"<?if missing?>missing<?elif empty?>empty<?elif name?> <?= name?><?endif?>");
+
+	Object::Ptr data = new Object();
+	Poco::JSON::Array::Ptr items = new Poco::JSON::Array();
+	Object::Ptr item = new Object();
+	item->set("name", "first");
+	item->set("done", true);
+	item->set("count", 1);
+	Poco::JSON::Array::Ptr tags = new Poco::JSON::Array();
+	tags->add("a");
+	tags->add("b");
+	item->set("tags", tags);
+	items->add(item);
+	item = new Object();
+	item->set("name", "second");
+	item->set("count", Poco::Int64(12345678901LL));
+	item->set("tags", new Poco::JSON::Array());
+	items->add(item);
+	item = new Object();
+	item->set("count", 2.5);
+	items->add(item);
+	data->set("items", items);
+	data->set("zero", 0);
+	data->set("empty", "");
+	data->set("name", "end");
+
+	const std::string expected = "+first:1[a][b];-second:12345678901;?:2.5;zero=0false end";
+
+	std::ostringstream ostr;
+	tpl.render(data, ostr);
+	assertEquals (expected, ostr.str());
+	assertTrue (!data->has("item"));
+	assertTrue (!data->has("tag"));
+
+	std::string out;
+	tpl.render(data, out);
+	assertEquals (expected, out);
+	tpl.render(data, out);
+	assertEquals (expected + expected, out);
+
+	// Blocks that are not closed end with the template.
+	tpl.parse("<?if name?>A<?for item items?>B");
+	out.clear();
+	tpl.render(data, out);
+	assertEquals (std::string("ABBB"), out);
+
+	const char* invalid[] =
+	{
+		"<?else?>",
+		"<?for item items?><?else?><?endfor?>",
+		"<?endif?>",
+		"<?if name?><?endfor?>",
+		"<?endfor?>",
+		"<?for item items?><?endif?>",
+		"<?echo?>",
+		"<?unknown?>",
+		"<?= name"
+	};
+	for (std::size_t i = 0; i < sizeof(invalid)/sizeof(invalid[0]); ++i)
+	{
+		try
+		{
+			tpl.parse(invalid[i]);
+			fail(std::string("must throw: ") + invalid[i]);
+		}
+		catch (JSONTemplateException&)
+		{
+		}
+	}
+
+	tpl.parse("<?= name?>");
+	try
+	{
+		out.clear();
+		tpl.render(Var("text"), out);
+		fail("must throw");
+	}
+	catch (Poco::InvalidArgumentException&)
+	{
+	}
+}
+
+
+void JSONTest::testTemplateCache()
+{
+	Poco::Path dir(Poco::Path::temp());
+	dir.pushDirectory("JSONTemplateCache-" + Poco::NumberFormatter::format(Poco::Timestamp().epochMicroseconds()));
+	Poco::File(dir).createDirectories();
+
+	Poco::Path mainPath(dir, "main.tpl");
+	Poco::Path includePath(dir, "include.tpl");
+	{
+		Poco::FileOutputStream fos(mainPath.toString());
+		fos << "Hello <?include \"include.tpl\"?>!";
+		Poco::FileOutputStream fos2(includePath.toString());
+		fos2 << "<?= name?>";
+	}
+
+	Object::Ptr data = new Object();
+	data->set("name", "Franky");
+
+	{
+		TemplateCache cache;
+		cache.addPath(dir);
+		cache.setCheckInterval(Poco::Timespan(3600, 0));
+
+		Template::Ptr pTemplate = cache.getTemplate(Poco::Path("main.tpl"));
+		std::string out;
+		pTemplate->render(data, out);
+		assertEquals (std::string("Hello Franky!"), out);
+
+		{
+			Poco::FileOutputStream fos(includePath.toString());
+			fos << "<?= name?> again";
+		}
+		Poco::File(includePath).setLastModified(pTemplate->parseTime() + Poco::Timespan(10, 0));
+
+		// Within the check interval, the changed file is not seen.
+		assertTrue (cache.getTemplate(Poco::Path("main.tpl")) == pTemplate);
+		out.clear();
+		pTemplate->render(data, out);
+		assertEquals (std::string("Hello Franky!"), out);
+
+		cache.setCheckInterval(Poco::Timespan(0));
+		assertTrue (cache.getTemplate(Poco::Path("main.tpl")) == pTemplate);
+		out.clear();
+		pTemplate->render(data, out);
+		assertEquals (std::string("Hello Franky again!"), out);
+	}
+
+	Poco::File(dir).remove(true);
+}
+
+
+void JSONTest::testTemplateBenchmark()
+{
+	const int count = 100000;
+	std::string source =
+		"<html><body><h1><?= title?></h1><ul>\n"
+		"<?for item items?><li class=\"<?if item.active?>active<?else?>inactive<?endif?>\">"
+		"<?= item.name?> (<?= item.id?>)</li>\n<?endfor?>"
+		"</ul></body></html>\n";
+
+	Object::Ptr data = new Object();
+	data->set("title", "Items");
+	Poco::JSON::Array::Ptr items = new Poco::JSON::Array();
+	for (int i = 0; i < 10; ++i)
+	{
+		Object::Ptr item = new Object();
+		item->set("id", i);
+		item->set("name", "Item " + Poco::NumberFormatter::format(i));
+		item->set("active", (i % 2) == 0);
+		items->add(item);
+	}
+	data->set("items", items);
+
+	Template tpl;
+	tpl.parse(source);
+
+	Poco::Stopwatch sw;
+	sw.start();
+	std::size_t size = 0;
+	for (int i = 0; i < count; ++i)
+	{
+		std::ostringstream ostr;
+		tpl.render(data, ostr);
+		size += ostr.str().size();
+	}
+	sw.stop();
+	std::cout << "render(ostream): " << sw.elapsed()/1000 << " ms (" << size << ")" << std::endl;
+
+	std::string out;
+	size = 0;
+	sw.restart();
+	for (int i = 0; i < count; ++i)
+	{
+		out.clear();
+		tpl.render(data, out);
+		size += out.size();
+	}
+	sw.stop();
+	std::cout << "render(string):  " << sw.elapsed()/1000 << " ms (" << size << ")" << std::endl;
+}
+
+
+void JSONTest::testCBOR()
+{
+	// Examples from RFC 8949, Appendix A.
+	struct
+	{
+		Var value;
+		const char* hex;
+	}
+	encoded[] =
+	{
+		{ 0, "00" },
+		{ 23, "17" },
+		{ 24, "1818" },
+		{ 100, "1864" },
+		{ 1000, "1903e8" },
+		{ 1000000, "1a000f4240" },
+		{ Poco::Int64(1000000000000LL), "1b000000e8d4a51000" },
+		{ Poco::UInt64(18446744073709551615ULL), "1bffffffffffffffff" },
+		{ -1, "20" },
+		{ -10, "29" },
+		{ -100, "3863" },
+		{ -1000, "3903e7" },
+		{ 1.1, "fb3ff199999999999a" },
+		{ 100000.0, "fa47c35000" },
+		{ -4.0, "fac0800000" },
+		{ false, "f4" },
+		{ true, "f5" },
+		{ Var(), "f6" },
+		{ std::string(), "60" },
+		{ "a", "6161" },
+		{ "IETF", "6449455446" },
+		{ "\xC3\xBC", "62c3bc" }
+	};
+	for (std::size_t i = 0; i < sizeof(encoded)/sizeof(encoded[0]); ++i)
+	{
+		std::string cbor;
+		{
+			CBORWriter writer(cbor);
+			writer.value(encoded[i].value);
+		}
+		assertEquals (std::string(encoded[i].hex), toHex(cbor));
+
+		CBORParser parser;
+		Var result = parser.parse(cbor);
+		if (encoded[i].value.isEmpty())
+			assertTrue (result.isEmpty());
+		else
+			assertTrue (result == encoded[i].value);
+	}
+
+	std::string cbor;
+	{
+		CBORWriter writer(cbor);
+		writer.startObject(2);
+		writer.key("a");
+		writer.value(1);
+		writer.key("b");
+		writer.startArray();
+		writer.value(2);
+		writer.value(3);
+		writer.endArray();
+		writer.endObject();
+		writer.binary("\x01\x02", 2);
+	}
+	assertEquals (std::string("a261610161629f0203ff420102"), toHex(cbor));
+
+	// Decoding of encodings that are not written by CBORWriter.
+	struct
+	{
+		const char* hex;
+		const char* json;
+	}
+	decoded[] =
+	{
+		{ "82f93e00f9c400", "[1.5,-4]" },
+		{ "9f018202039f0405ffff", "[1,[2,3],[4,5]]" },
+		{ "bf61610161629f0203ffff", "{\"a\":1,\"b\":[2,3]}" },
+		{ "827f657374726561646d696e67ff5f42010243030405ff", "[\"streaming\",\"\\u0001\\u0002\\u0003\\u0004\\u0005\"]" },
+		{ "82c074323031332d30332d32315432303a30343a30305ad818456449455446", "[\"2013-03-21T20:04:00Z\",\"dIETF\"]" },
+		{ "a201020304", "{\"1\":2,\"3\":4}" },
+		{ "a1206161", "{\"-1\":\"a\"}" },
+		{ "83f7f6c11a514b67b0", "[null,null,1363896240]" },
+		{ "80", "[]" },
+		{ "a0", "{}" }
+	};
+	for (std::size_t i = 0; i < sizeof(decoded)/sizeof(decoded[0]); ++i)
+	{
+		CBORParser parser;
+		std::ostringstream ostr;
+		Stringifier::condense(parser.parse(fromHex(decoded[i].hex)), ostr);
+		assertEquals (std::string(decoded[i].json), ostr.str());
+	}
+
+	CBORParser halfParser;
+	Var half = halfParser.parse(fromHex("83f97c00f9fc00f90001"));
+	Poco::JSON::Array::Ptr pHalf = half.extract<Poco::JSON::Array::Ptr>();
+	assertTrue (pHalf->getElement<double>(0) == std::numeric_limits<double>::infinity());
+	assertTrue (pHalf->getElement<double>(1) == -std::numeric_limits<double>::infinity());
+	assertTrue (pHalf->getElement<double>(2) == std::ldexp(1.0, -24));
+
+	// A sequence of values in a stream.
+	std::ostringstream ostr;
+	{
+		CBORWriter writer(ostr);
+		writer.value(1);
+		writer.startArray(1);
+		writer.value("x");
+		writer.endArray();
+		writer.value(2);
+	}
+	std::istringstream istr(ostr.str());
+	CBORParser parser;
+	assertTrue (parser.parse(istr) == 1);
+	Var result = parser.parse(istr);
+	assertTrue (result.extract<Poco::JSON::Array::Ptr>()->getElement<std::string>(0) == "x");
+	assertTrue (parser.parse(istr) == 2);
+	assertTrue (istr.peek() == std::char_traits<char>::eof());
+
+	const char* invalid[] =
+	{
+		"",
+		"19",
+		"6261",
+		"8201",
+		"a16161",
+		"ff",
+		"9fff01",
+		"bf6161ff",
+		"1c",
+		"f8ff",
+		"5f6161ff",
+		"a1816161"
+	};
+	for (std::size_t i = 0; i < sizeof(invalid)/sizeof(invalid[0]); ++i)
+	{
+		try
+		{
+			CBORParser parser;
+			parser.parse(fromHex(invalid[i]));
+			fail(std::string("must throw: ") + invalid[i]);
+		}
+		catch (JSONException&)
+		{
+		}
+	}
+
+	parser.setDepth(2);
+	parser.parse(fromHex("818100"));
+	try
+	{
+		parser.parse(fromHex("81818100"));
+		fail("must throw");
+	}
+	catch (JSONException&)
+	{
+	}
+
+	std::string out;
+	CBORWriter writer(out);
+	writer.startArray(1);
+	try
+	{
+		writer.endArray();
+		fail("must throw");
+	}
+	catch (JSONException&)
+	{
+	}
+	writer.value(1);
+	try
+	{
+		writer.value(2);
+		fail("must throw");
+	}
+	catch (JSONException&)
+	{
+	}
+	writer.endArray();
+	writer.startObject();
+	try
+	{
+		writer.value(1);
+		fail("must throw");
+	}
+	catch (JSONException&)
+	{
+	}
+	assertEquals (std::string("8101bf"), toHex(out));
+}
+
+
+void JSONTest::testMessagePack()
+{
+	struct
+	{
+		Var value;
+		const char* hex;
+	}
+	encoded[] =
+	{
+		{ 0, "00" },
+		{ 127, "7f" },
+		{ 128, "cc80" },
+		{ 256, "cd0100" },
+		{ 65536, "ce00010000" },
+		{ Poco::Int64(4294967296LL), "cf0000000100000000" },
+		{ Poco::UInt64(18446744073709551615ULL), "cfffffffffffffffff" },
+		{ -1, "ff" },
+		{ -32, "e0" },
+		{ -33, "d0df" },
+		{ -129, "d1ff7f" },
+		{ -32769, "d2ffff7fff" },
+		{ Poco::Int64(-2147483649LL), "d3ffffffff7fffffff" },
+		{ 1.5, "ca3fc00000" },
+		{ 1.1, "cb3ff199999999999a" },
+		{ false, "c2" },
+		{ true, "c3" },
+		{ Var(), "c0" },
+		{ std::string(), "a0" },
+		{ "a", "a161" },
+		{ std::string(32, 'x'), "d920" "7878787878787878787878787878787878787878787878787878787878787878" }
+	};
+	for (std::size_t i = 0; i < sizeof(encoded)/sizeof(encoded[0]); ++i)
+	{
+		std::string msgpack;
+		{
+			MessagePackWriter writer(msgpack);
+			writer.value(encoded[i].value);
+		}
+		assertEquals (std::string(encoded[i].hex), toHex(msgpack));
+
+		MessagePackParser parser;
+		Var result = parser.parse(msgpack);
+		if (encoded[i].value.isEmpty())
+			assertTrue (result.isEmpty());
+		else
+			assertTrue (result == encoded[i].value);
+	}
+
+	std::string msgpack;
+	{
+		MessagePackWriter writer(msgpack);
+		writer.startObject(2);
+		writer.key("a");
+		writer.value(1);
+		writer.key("b");
+		writer.startArray();
+		writer.value(2);
+		writer.value(3);
+		writer.endArray();
+		writer.endObject();
+		writer.binary("\x01\x02", 2);
+	}
+	assertEquals (std::string("82a16101a162dd000000020203c4020102"), toHex(msgpack));
+
+	// Sizes that are filled in are kept in the buffer until they are known.
+	std::ostringstream ostr;
+	{
+		MessagePackWriter writer(ostr);
+		writer.startArray();
+		for (int i = 0; i < 10000; ++i) writer.value(i);
+		assertTrue (ostr.str().empty());
+		try
+		{
+			writer.flush();
+			fail("must throw");
+		}
+		catch (JSONException&)
+		{
+		}
+		writer.endArray();
+		writer.value("next");
+	}
+	std::istringstream istr(ostr.str());
+	MessagePackParser parser;
+	Var result = parser.parse(istr);
+	assertTrue (result.extract<Poco::JSON::Array::Ptr>()->size() == 10000);
+	assertTrue (result.extract<Poco::JSON::Array::Ptr>()->get(9999) == 9999);
+	assertTrue (parser.parse(istr) == "next");
+
+	struct
+	{
+		const char* hex;
+		const char* json;
+	}
+	decoded[] =
+	{
+		{ "dc0002c0c3", "[null,true]" },
+		{ "de0001a16190", "{\"a\":[]}" },
+		{ "8201a162d0ffccff", "{\"-1\":255,\"1\":\"b\"}" },
+		{ "92c5000161d90162", "[\"a\",\"b\"]" }
+	};
+	for (std::size_t i = 0; i < sizeof(decoded)/sizeof(decoded[0]); ++i)
+	{
+		MessagePackParser parser;
+		parser.parse(fromHex(decoded[i].hex));
+		std::ostringstream ostr;
+		Stringifier::condense(parser.asVar(), ostr);
+		assertEquals (std::string(decoded[i].json), ostr.str());
+	}
+
+	const char* invalid[] =
+	{
+		"",
+		"cd01",
+		"a261",
+		"9201",
+		"81a161",
+		"c1",
+		"d40100",
+		"c70100",
+		"8190c0",
+		"0000"
+	};
+	for (std::size_t i = 0; i < sizeof(invalid)/sizeof(invalid[0]); ++i)
+	{
+		try
+		{
+			MessagePackParser parser;
+			parser.parse(fromHex(invalid[i]));
+			fail(std::string("must throw: ") + invalid[i]);
+		}
+		catch (JSONException&)
+		{
+		}
+	}
+}
+
+
+void JSONTest::testBinaryRoundTrip()
+{
+	std::string json = "{\"name\":\"Franky\",\"id\":-42,\"big\":12345678901234,\"ratio\":0.1,\"single\":0.5,"
+		"\"ok\":true,\"none\":null,\"children\":[{\"name\":\"Jonas\",\"tags\":[]},{\"name\":\"Ellen\",\"tags\":[\"a\",\"\\u00e9\"]}],"
+		"\"empty\":{}}";
+
+	Parser parser;
+	parser.setHandler(new ParseHandler(true));
+	Var value = parser.parse(json);
+	std::ostringstream expected;
+	Stringifier::condense(value, expected);
+
+	std::string cbor;
+	{
+		CBORWriter writer(cbor);
+		writer.value(value);
+	}
+	CBORParser cborParser(new ParseHandler(true));
+	std::ostringstream ostr;
+	Stringifier::condense(cborParser.parse(cbor), ostr);
+	assertEquals (expected.str(), ostr.str());
+
+	std::string msgpack;
+	{
+		MessagePackWriter writer(msgpack);
+		writer.value(value);
+	}
+	MessagePackParser msgpackParser(new ParseHandler(true));
+	ostr.str("");
+	Stringifier::condense(msgpackParser.parse(msgpack), ostr);
+	assertEquals (expected.str(), ostr.str());
+
+	// Conversion between formats through the Handler interface.
+	std::string transcoded;
+	{
+		Parser textParser(new MessagePackWriter(transcoded));
+		textParser.parse(json);
+	}
+	ostr.str("");
+	Stringifier::condense(msgpackParser.parse(transcoded), ostr);
+	assertEquals (expected.str(), ostr.str());
+
+	transcoded.clear();
+	{
+		MessagePackParser binaryParser(new CBORWriter(transcoded));
+		binaryParser.parse(msgpack);
+	}
+	ostr.str("");
+	Stringifier::condense(cborParser.parse(transcoded), ostr);
+	assertEquals (expected.str(), ostr.str());
+
+	transcoded.clear();
+	{
+		CBORParser binaryParser(new MessagePackWriter(transcoded));
+		binaryParser.parse(cbor);
+	}
+	ostr.str("");
+	Stringifier::condense(msgpackParser.parse(transcoded), ostr);
+	assertEquals (expected.str(), ostr.str());
+
+	assertTrue (cbor.size() < json.size());
+	assertTrue (msgpack.size() < json.size());
+}
+
+
+void JSONTest::testBinaryBenchmark()
+{
+	const int count = 20;
+	Poco::JSON::Array::Ptr records = new Poco::JSON::Array();
+	for (int i = 0; i < 10000; ++i)
+	{
+		Object::Ptr record = new Object();
+		record->set("id", i);
+		record->set("name", "Record " + Poco::NumberFormatter::format(i));
+		record->set("score", i * 0.25);
+		record->set("active", (i % 3) == 0);
+		Poco::JSON::Array::Ptr tags = new Poco::JSON::Array();
+		tags->add("alpha");
+		tags->add(i % 7);
+		record->set("tags", tags);
+		records->add(record);
+	}
+	Var value(records);
+
+	std::string json;
+	std::string cbor;
+	std::string msgpack;
+	Poco::Stopwatch sw;
+
+	sw.start();
+	for (int i = 0; i < count; ++i)
+	{
+		json.clear();
+		Writer writer(json);
+		writer.value(value);
+	}
+	sw.stop();
+	std::cout << "JSON:        write " << sw.elapsed()/1000 << " ms, ";
+	sw.restart();
+	for (int i = 0; i < count; ++i)
+	{
+		Parser parser;
+		parser.parse(json);
+	}
+	sw.stop();
+	std::cout << "parse " << sw.elapsed()/1000 << " ms, " << json.size() << " bytes" << std::endl;
+
+	sw.restart();
+	for (int i = 0; i < count; ++i)
+	{
+		cbor.clear();
+		CBORWriter writer(cbor);
+		writer.value(value);
+	}
+	sw.stop();
+	std::cout << "CBOR:        write " << sw.elapsed()/1000 << " ms, ";
+	sw.restart();
+	for (int i = 0; i < count; ++i)
+	{
+		CBORParser parser;
+		parser.parse(cbor);
+	}
+	sw.stop();
+	std::cout << "parse " << sw.elapsed()/1000 << " ms, " << cbor.size() << " bytes" << std::endl;
+
+	sw.restart();
+	for (int i = 0; i < count; ++i)
+	{
+		msgpack.clear();
+		MessagePackWriter writer(msgpack);
+		writer.value(value);
+	}
+	sw.stop();
+	std::cout << "MessagePack: write " << sw.elapsed()/1000 << " ms, ";
+	sw.restart();
+	for (int i = 0; i < count; ++i)
+	{
+		MessagePackParser parser;
+		parser.parse(msgpack);
+	}
+	sw.stop();
+	std::cout << "parse " << sw.elapsed()/1000 << " ms, " << msgpack.size() << " bytes" << std::endl;
+}
+
+
+void JSONTest::testMoveValues()
+{
+	int options[] = { 0, Poco::JSON_PRESERVE_KEY_ORDER, Poco::JSON_FLAT_STORAGE };
+	for (int i = 0; i < 3; ++i)
+	{
+		Object obj(options[i]);
+		Var name(std::string("a string too long to be stored in place"));
+		const std::string* pName = name.tryGet<std::string>();
+		obj.set("name", std::move(name));
+		assertTrue (name.isEmpty());
+		obj.set("id", 1);
+		Var id(2);
+		obj.set("id", std::move(id));
+		assertTrue (id.isEmpty());
+		assertTrue (obj.size() == 2);
+		assertTrue (obj.get("id") == 2);
+		Object::ConstIterator it = obj.find("name");
+		assertTrue (it != obj.end());
+		assertTrue (it->second.tryGet<std::string>() == pName);
+
+		std::ostringstream out;
+		obj.stringify(out);
+		if (options[i] != 0)
+			assertEquals ("{\"name\":\"a string too long to be stored in place\",\"id\":2}", out.str());
+		else
+			assertEquals ("{\"id\":2,\"name\":\"a string too long to be stored in place\"}", out.str());
+	}
+
+	Poco::JSON::Array arr;
+	Var value(std::string("element"));
+	arr.add(std::move(value));
+	assertTrue (value.isEmpty());
+	arr.add(value);
+	assertTrue (arr.size() == 2);
+	assertTrue (arr.get(0) == "element");
+	assertTrue (arr.isNull(1));
+
+	Parser parser;
+	Var result = parser.parse("{\"a\":[1,\"two\",{\"b\":null}],\"c\":\"d\"}");
+	std::ostringstream out;
+	result.extract<Object::Ptr>()->stringify(out);
+	assertEquals ("{\"a\":[1,\"two\",{\"b\":null}],\"c\":\"d\"}", out.str());
+
+	// Empty member names are valid.
+	parser.reset();
+	result = parser.parse("{\"\":1,\"a\":{\"\":[2]}}");
+	Object::Ptr pObj = result.extract<Object::Ptr>();
+	assertTrue (pObj->get("") == 1);
+	assertTrue (pObj->getObject("a")->getArray("")->get(0) == 2);
+}
+
+
+void JSONTest::testStringifyNonFinite()
+{
+	double inf = std::numeric_limits<double>::infinity();
+	double nan = std::numeric_limits<double>::quiet_NaN();
+
+	Object obj;
+	obj.set("inf", inf);
+	obj.set("nan", nan);
+	obj.set("ninf", -static_cast<float>(inf));
+
+	std::ostringstream compact;
+	obj.stringify(compact);
+	assertEquals ("{\"inf\":null,\"nan\":null,\"ninf\":null}", compact.str());
+
+	std::ostringstream indented;
+	obj.stringify(indented, 1);
+	assertEquals ("{\n \"inf\" : null,\n \"nan\" : null,\n \"ninf\" : null\n}", indented.str());
+
+	Poco::JSON::Array arr;
+	arr.add(nan);
+	arr.add(1.5);
+	std::ostringstream compactArray;
+	arr.stringify(compactArray);
+	assertEquals ("[null,1.5]", compactArray.str());
+	std::ostringstream indentedArray;
+	arr.stringify(indentedArray, 1);
+	assertEquals ("[\n null,\n 1.5\n]", indentedArray.str());
+
+	std::ostringstream scalar;
+	Stringifier::stringify(inf, scalar, 0, -1, 0);
+	assertEquals ("null", scalar.str());
+	std::ostringstream wrappedScalar;
+	Stringifier::stringify(nan, wrappedScalar);
+	assertEquals ("null", wrappedScalar.str());
+}
+
+
+void JSONTest::testVarBenchmark()
+{
+	const int count = 20;
+	std::string json = "[";
+	for (int i = 0; i < 10000; ++i)
+	{
+		if (i > 0) json += ",";
+		json += "{\"id\":";
+		json += Poco::NumberFormatter::format(i);
+		json += ",\"name\":\"Record ";
+		json += Poco::NumberFormatter::format(i);
+		json += "\",\"description\":\"A description that does not fit into a short string\",\"score\":0.25,\"tags\":[\"alpha\",\"beta\"]}";
+	}
+	json += "]";
+
+	Poco::Stopwatch sw;
+	Var result;
+
+	sw.start();
+	for (int i = 0; i < count; ++i)
+	{
+		Parser parser;
+		result = parser.parse(json);
+	}
+	sw.stop();
+	std::cout << "parse:         " << sw.elapsed()/1000 << " ms" << std::endl;
+
+	Poco::JSON::Array::Ptr records = result.extract<Poco::JSON::Array::Ptr>();
+	std::size_t length = 0;
+	sw.restart();
+	for (int i = 0; i < count; ++i)
+	{
+		for (Poco::JSON::Array::ConstIterator it = records->begin(); it != records->end(); ++it)
+		{
+			Object::Ptr record = it->extract<Object::Ptr>();
+			length += record->get("name").convert<std::string>().size();
+			length += record->get("description").convert<std::string>().size();
+		}
+	}
+	sw.stop();
+	std::cout << "get/convert:   " << sw.elapsed()/1000 << " ms" << std::endl;
+
+	sw.restart();
+	for (int i = 0; i < count; ++i)
+	{
+		for (Poco::JSON::Array::ConstIterator it = records->begin(); it != records->end(); ++it)
+		{
+			const Object& record = **it->tryGet<Object::Ptr>();
+			length += record.find("name")->second.tryGet<std::string>()->size();
+			length += record.find("description")->second.tryGet<std::string>()->size();
+		}
+	}
+	sw.stop();
+	std::cout << "find/tryGet:   " << sw.elapsed()/1000 << " ms" << std::endl;
+
+	sw.restart();
+	for (int i = 0; i < count; ++i)
+	{
+		Poco::JSON::Array copy;
+		for (Poco::JSON::Array::ConstIterator it = records->begin(); it != records->end(); ++it)
+		{
+			const Object& record = **it->tryGet<Object::Ptr>();
+			Object::Ptr pCopy = new Object;
+			for (Object::ConstIterator m = record.begin(); m != record.end(); ++m)
+			{
+				pCopy->set(m->first, m->second);
+			}
+			copy.add(pCopy);
+		}
+	}
+	sw.stop();
+	std::cout << "copy:          " << sw.elapsed()/1000 << " ms" << std::endl;
+
+	sw.restart();
+	for (int i = 0; i < count; ++i)
+	{
+		std::vector<Var> values;
+		for (int j = 0; j < 100000; ++j)
+		{
+			values.push_back(Var(std::string("a value that does not fit into a short string")));
+		}
+	}
+	sw.stop();
+	std::cout << "vector growth: " << sw.elapsed()/1000 << " ms (" << length << ")" << std::endl;
+}
+
+
+std::string JSONTest::toHex(const std::string& data)
+{
+	std::string hex;
+	for (std::string::const_iterator it = data.begin(); it != data.end(); ++it)
+	{
+		hex += Poco::NumberFormatter::formatHex(static_cast<unsigned char>(*it), 2);
+	}
+	return Poco::toLower(hex);
+}
+
+
+std::string JSONTest::fromHex(const std::string& hex)
+{
+	std::string data;
+	for (std::size_t i = 0; i + 1 < hex.size(); i += 2)
+	{
+		data += static_cast<char>(Poco::NumberParser::parseHex(hex.substr(i, 2)));
+	}
+	return data;
+}
+
+
 CppUnit::Test* JSONTest::suite()
 {
 	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("JSONTest");
@@ -2218,6 +4403,34 @@ CppUnit::Test* JSONTest::suite()
 	CppUnit_addTest(pSuite, JSONTest, testEscapeUnicode);
 	CppUnit_addTest(pSuite, JSONTest, testCopy);
 	CppUnit_addTest(pSuite, JSONTest, testMove);
+	CppUnit_addTest(pSuite, JSONTest, testIndexedParser);
+	CppUnit_addTest(pSuite, JSONTest, testIndexedJanssonFiles);
+	CppUnit_addTest(pSuite, JSONTest, testDocument);
+	CppUnit_addTest(pSuite, JSONTest, testDocumentQuery);
+	CppUnit_addTest(pSuite, JSONTest, testDocumentArena);
+	CppUnit_addTest(pSuite, JSONTest, testFlatObject);
+	// CppUnit_addTest(pSuite, JSONTest, testObjectStorageBenchmark);
+	CppUnit_addTest(pSuite, JSONTest, testWriter);
+	CppUnit_addTest(pSuite, JSONTest, testWriterEscape);
+	// CppUnit_addTest(pSuite, JSONTest, testWriterBenchmark);
+	CppUnit_addTest(pSuite, JSONTest, testPushParser);
+	CppUnit_addTest(pSuite, JSONTest, testPushParserJanssonFiles);
+	CppUnit_addTest(pSuite, JSONTest, testNDJSONReader);
+	CppUnit_addTest(pSuite, JSONTest, testNDJSONWriter);
+	// CppUnit_addTest(pSuite, JSONTest, testNDJSONBenchmark);
+	CppUnit_addTest(pSuite, JSONTest, testQueryPath);
+	CppUnit_addTest(pSuite, JSONTest, testQuerySet);
+	// CppUnit_addTest(pSuite, JSONTest, testQueryPathBenchmark);
+	CppUnit_addTest(pSuite, JSONTest, testTemplateCommands);
+	CppUnit_addTest(pSuite, JSONTest, testTemplateCache);
+	// CppUnit_addTest(pSuite, JSONTest, testTemplateBenchmark);
+	CppUnit_addTest(pSuite, JSONTest, testCBOR);
+	CppUnit_addTest(pSuite, JSONTest, testMessagePack);
+	CppUnit_addTest(pSuite, JSONTest, testBinaryRoundTrip);
+	// CppUnit_addTest(pSuite, JSONTest, testBinaryBenchmark);
+	CppUnit_addTest(pSuite, JSONTest, testMoveValues);
+	CppUnit_addTest(pSuite, JSONTest, testStringifyNonFinite);
+	// CppUnit_addTest(pSuite, JSONTest, testVarBenchmark);
 
 	return pSuite;
 }
@@ -18,12 +18,24 @@
 #include "Poco/CppUnit/TestCase.h"
 #include "Poco/JSON/Object.h"
 #include "Poco/JSON/Parser.h"
+#include "Poco/JSON/PushParser.h"
 #include "Poco/JSON/Query.h"
+#include "Poco/JSON/QueryPath.h"
+#include "Poco/JSON/QuerySet.h"
+#include "Poco/JSON/QueryHandler.h"
+#include "Poco/JSON/Document.h"
 #include "Poco/JSON/JSONException.h"
 #include "Poco/JSON/Stringifier.h"
 #include "Poco/JSON/ParseHandler.h"
 #include "Poco/JSON/PrintHandler.h"
 #include "Poco/JSON/Template.h"
+#include "Poco/JSON/Writer.h"
+#include "Poco/JSON/NDJSONReader.h"
+#include "Poco/JSON/NDJSONWriter.h"
+#include "Poco/JSON/CBORParser.h"
+#include "Poco/JSON/CBORWriter.h"
+#include "Poco/JSON/MessagePackParser.h"
+#include "Poco/JSON/MessagePackWriter.h"
 #include <sstream>
 
 
@@ -82,6 +94,35 @@ public:
 	void testCopy();
 	void testMove();
 
+	void testIndexedParser();
+	void testIndexedJanssonFiles();
+	void testDocument();
+	void testDocumentQuery();
+	void testDocumentArena();
+	void testFlatObject();
+	void testObjectStorageBenchmark();
+	void testWriter();
+	void testWriterEscape();
+	void testWriterBenchmark();
+	void testPushParser();
+	void testPushParserJanssonFiles();
+	void testNDJSONReader();
+	void testNDJSONWriter();
+	void testNDJSONBenchmark();
+	void testQueryPath();
+	void testQuerySet();
+	void testQueryPathBenchmark();
+	void testTemplateCommands();
+	void testTemplateCache();
+	void testTemplateBenchmark();
+	void testCBOR();
+	void testMessagePack();
+	void testBinaryRoundTrip();
+	void testBinaryBenchmark();
+	void testMoveValues();
+	void testStringifyNonFinite();
+	void testVarBenchmark();
+
 	void setUp();
 	void tearDown();
 
@@ -89,6 +130,8 @@ public:
 
 private:
 	std::string getTestFilesPath(const std::string& type);
+	static std::string toHex(const std::string& data);
+	static std::string fromHex(const std::string& hex);
 
 	template <typename T>
 	void testNumber(T number)
@@ -19,7 +19,7 @@
 
 
 #include "Poco/Net/Net.h"
-#include "Poco/MemoryPool.h"
+#include "Poco/ThreadCachedMemoryPool.h"
 #include <ios>
 
 
@@ -29,6 +29,9 @@ namespace Net {
 
 class Net_API HTTPBufferAllocator
 	/// A BufferAllocator for HTTP streams.
+	///
+	/// Buffers are taken from a ThreadCachedMemoryPool, so that
+	/// concurrent HTTP sessions do not contend for a single lock.
 {
 public:
 	static char* allocate(std::streamsize size);
@@ -40,7 +43,7 @@ public:
 	};
 
 private:
-	static Poco::MemoryPool _pool;
+	static Poco::ThreadCachedMemoryPool _pool;
 };
 
 
@@ -27,6 +27,11 @@
 
 
 namespace Poco {
+
+
+class FileInputStream;
+
+
 namespace Net {
 
 
@@ -175,6 +180,17 @@ public:
 		///
 		/// Always returns zero for platforms where not implemented.
 
+	virtual Poco::UInt64 sendFile(Poco::FileInputStream& istr);
+		/// Sends the contents of the given file stream, from its
+		/// current position to the end of the file, through the socket.
+		///
+		/// On Linux, a regular file is sent with sendfile() if the socket
+		/// is blocking and not secure, so that the file contents are not
+		/// copied to user space. Otherwise, the file is read in chunks which
+		/// are sent with sendBytes().
+		///
+		/// Returns the number of bytes sent.
+
 	virtual int receiveBytes(void* buffer, int length, int flags = 0);
 		/// Receives data from the socket and stores it
 		/// in buffer. Up to length bytes are received.
@@ -150,6 +150,16 @@ public:
 		/// Certain socket implementations may also return a negative
 		/// value denoting a certain condition.
 
+	Poco::UInt64 sendFile(Poco::FileInputStream& istr);
+		/// Sends the contents of the given file stream, from its
+		/// current position to the end of the file, through the socket.
+		///
+		/// On Linux, regular files are sent with sendfile() through
+		/// blocking, non-secure sockets, without copying the file
+		/// contents to user space.
+		///
+		/// Returns the number of bytes sent.
+
 	int receiveBytes(void* buffer, int length, int flags = 0);
 		/// Receives data from the socket and stores it
 		/// in buffer. Up to length bytes are received.
@@ -15,14 +15,14 @@
 #include "Poco/Net/HTTPBufferAllocator.h"
 
 
-using Poco::MemoryPool;
+using Poco::ThreadCachedMemoryPool;
 
 
 namespace Poco {
 namespace Net {
 
 
-MemoryPool HTTPBufferAllocator::_pool(HTTPBufferAllocator::BUFFER_SIZE, 16);
+ThreadCachedMemoryPool HTTPBufferAllocator::_pool(HTTPBufferAllocator::BUFFER_SIZE, 16);
 
 
 char* HTTPBufferAllocator::allocate(std::streamsize size)
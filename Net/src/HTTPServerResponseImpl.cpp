@@ -22,7 +22,6 @@
 #include "Poco/File.h"
 #include "Poco/Timestamp.h"
 #include "Poco/NumberFormatter.h"
-#include "Poco/StreamCopier.h"
 #include "Poco/CountingStream.h"
 #include "Poco/Exception.h"
 #include "Poco/FileStream.h"
@@ -33,7 +32,6 @@
 using Poco::File;
 using Poco::Timestamp;
 using Poco::NumberFormatter;
-using Poco::StreamCopier;
 using Poco::OpenFileException;
 using Poco::DateTimeFormatter;
 using Poco::DateTimeFormat;
@@ -128,7 +126,8 @@ void HTTPServerResponseImpl::sendFile(const std::string& path, const std::string
 		write(*_pStream);
 		if (_pRequest && _pRequest->getMethod() != HTTPRequest::HTTP_HEAD)
 		{
-			StreamCopier::copyStream(istr, *_pStream);
+			_pStream->flush();
+			_session.socket().sendFile(istr);
 		}
 	}
 	else throw OpenFileException(path);
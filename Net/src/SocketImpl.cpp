@@ -16,6 +16,7 @@
 #include "Poco/Net/NetException.h"
 #include "Poco/Net/StreamSocketImpl.h"
 #include "Poco/NumberFormatter.h"
+#include "Poco/FileStream.h"
 #include "Poco/Timestamp.h"
 #include <string.h> // FD_SET needs memset on some platforms, so we can't use <cstring>
 
@@ -40,6 +41,12 @@
 #endif
 
 
+#if POCO_OS == POCO_OS_LINUX || POCO_OS == POCO_OS_ANDROID
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#endif
+
+
 #if defined(sun) || defined(__sun) || defined(__sun__)
 #include <unistd.h>
 #include <stropts.h>
@@ -362,6 +369,77 @@ int SocketImpl::sendBytes(const SocketBufVec& buffers, int flags)
 }
 
 
+Poco::UInt64 SocketImpl::sendFile(Poco::FileInputStream& istr)
+{
+	Poco::UInt64 sent = 0;
+#if POCO_OS == POCO_OS_LINUX || POCO_OS == POCO_OS_ANDROID
+	Poco::FileStreamBuf* pBuf = istr.rdbuf();
+	struct stat st;
+	if (_blocking && !secure() && istr.good() && ::fstat(pBuf->nativeHandle(), &st) == 0 && S_ISREG(st.st_mode))
+	{
+		// discard buffered data, so that the file position matches the stream position
+		std::streampos pos = pBuf->pubseekoff(0, std::ios::cur, std::ios::in);
+		if (pos != std::streampos(-1))
+		{
+			checkBrokenTimeout(SELECT_WRITE);
+
+			off_t offset = static_cast<off_t>(pos);
+			bool eof = false;
+			for (;;)
+			{
+				if (_sockfd == POCO_INVALID_SOCKET) throw InvalidSocketException();
+				ssize_t rc = ::sendfile(_sockfd, pBuf->nativeHandle(), &offset, 0x40000000);
+				if (rc > 0)
+				{
+					sent += rc;
+				}
+				else if (rc == 0)
+				{
+					eof = true;
+					break;
+				}
+				else if (lastError() == POCO_EINTR)
+				{
+					continue;
+				}
+				else if (sent == 0 && (lastError() == EINVAL || lastError() == ENOSYS))
+				{
+					// not supported for this file; use sendBytes()
+					break;
+				}
+				else
+				{
+					pBuf->pubseekpos(offset, std::ios::in);
+					error();
+				}
+			}
+			pBuf->pubseekpos(offset, std::ios::in);
+			if (eof)
+			{
+				istr.setstate(std::ios::eofbit | std::ios::failbit);
+				return sent;
+			}
+		}
+	}
+#endif
+	Poco::Buffer<char> buffer(65536);
+	while (istr.read(buffer.begin(), static_cast<std::streamsize>(buffer.size())) || istr.gcount() > 0)
+	{
+		const char* p = buffer.begin();
+		int n = static_cast<int>(istr.gcount());
+		while (n > 0)
+		{
+			int rc = sendBytes(p, n);
+			if (rc <= 0) return sent;
+			p += rc;
+			n -= rc;
+			sent += rc;
+		}
+	}
+	return sent;
+}
+
+
 int SocketImpl::receiveBytes(void* buffer, int length, int flags)
 {
 	checkBrokenTimeout(SELECT_READ);
@@ -137,6 +137,12 @@ int StreamSocket::sendBytes(FIFOBuffer& fifoBuf)
 }
 
 
+Poco::UInt64 StreamSocket::sendFile(Poco::FileInputStream& istr)
+{
+	return impl()->sendFile(istr);
+}
+
+
 int StreamSocket::receiveBytes(void* buffer, int length, int flags)
 {
 	return impl()->receiveBytes(buffer, length, flags);
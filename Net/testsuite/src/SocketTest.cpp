@@ -22,6 +22,8 @@
 #include "Poco/FIFOBuffer.h"
 #include "Poco/Delegate.h"
 #include "Poco/File.h"
+#include "Poco/FileStream.h"
+#include "Poco/TemporaryFile.h"
 #include <iostream>
 
 
@@ -163,6 +165,43 @@ void SocketTest::testFIFOBuffer()
 }
 
 
+void SocketTest::testSendFile()
+{
+	std::string data;
+	for (int i = 0; i < 20000; ++i) data += static_cast<char>('a' + i % 26);
+	std::string path = Poco::TemporaryFile::tempName();
+	Poco::TemporaryFile::registerForDeletion(path);
+	Poco::FileOutputStream ostr(path);
+	ostr << data;
+	ostr.close();
+
+	ServerSocket serv;
+	serv.bind(SocketAddress("127.0.0.1", 0));
+	serv.listen();
+	StreamSocket ss;
+	ss.connect(SocketAddress("127.0.0.1", serv.address().port()));
+	StreamSocket peer = serv.acceptConnection();
+
+	Poco::FileInputStream istr(path);
+	char header[100];
+	istr.read(header, sizeof(header));
+	Poco::UInt64 n = peer.sendFile(istr);
+	assertTrue (n == data.size() - 100);
+	assertTrue (istr.eof());
+	peer.shutdownSend();
+
+	std::string received;
+	Buffer<char> buffer(4096);
+	int rc;
+	while ((rc = ss.receiveBytes(buffer.begin(), static_cast<int>(buffer.size()))) > 0)
+		received.append(buffer.begin(), rc);
+	assertTrue (received == data.substr(100));
+
+	ss.close();
+	peer.close();
+}
+
+
 void SocketTest::testConnect()
 {
 	ServerSocket serv;
@@ -579,6 +618,7 @@ CppUnit::Test* SocketTest::suite()
 	CppUnit_addTest(pSuite, SocketTest, testPoll);
 	CppUnit_addTest(pSuite, SocketTest, testAvailable);
 	CppUnit_addTest(pSuite, SocketTest, testFIFOBuffer);
+	CppUnit_addTest(pSuite, SocketTest, testSendFile);
 	CppUnit_addTest(pSuite, SocketTest, testConnect);
 	CppUnit_addTest(pSuite, SocketTest, testConnectRefused);
 	CppUnit_addTest(pSuite, SocketTest, testConnectRefusedNB);
@@ -28,6 +28,7 @@ public:
 	void testPoll();
 	void testAvailable();
 	void testFIFOBuffer();
+	void testSendFile();
 	void testConnect();
 	void testConnectRefused();
 	void testConnectRefusedNB();
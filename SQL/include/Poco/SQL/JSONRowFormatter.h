@@ -28,7 +28,7 @@ namespace SQL {
 class Poco_SQL_API JSONRowFormatter: public Poco::SQL::RowFormatter
 	/// Class for JSON formatting of data rows.
 	///
-	/// Formatter can be configured to operate in four modes (and
+	/// Formatter can be configured to operate in five modes (and
 	/// certain combinations thereof) :
 	///
 	///    - small (condensed mode, only array of values)
@@ -68,6 +68,13 @@ class Poco_SQL_API JSONRowFormatter: public Poco::SQL::RowFormatter
 	///        ]
 	///      }
 	///
+	///    - newline-delimited (one object per line, as in JSON Lines / NDJSON;
+	///      cannot be combined with other modes)
+	///
+	///      Example:
+	///      {"LastName":"Simpson","FirstName":"Bart","Address":"Springfield","Age":12}
+	///      {"LastName":"Simpson","FirstName":"Lisa","Address":"Springfield","Age":10}
+	///
 	/// Total row count will be specified by the Poco::SQLRecordSet. Note, however, that this is
 	/// not possible to do accurately in case of result set paging. For those cases, there is
 	/// setTotalRowCount() member function, which allows to explicitly set the total row count.
@@ -78,6 +85,7 @@ public:
 	static const int JSON_FMT_MODE_ROW_COUNT    = 2;
 	static const int JSON_FMT_MODE_COLUMN_NAMES = 4;
 	static const int JSON_FMT_MODE_FULL         = 8;
+	static const int JSON_FMT_MODE_NDJSON       = 16;
 
 	JSONRowFormatter(int mode = (JSON_FMT_MODE_COLUMN_NAMES | JSON_FMT_MODE_SMALL));
 		/// Creates a new JSONRowFormatter.
@@ -97,6 +105,7 @@ public:
 		///   JSON_FMT_MODE_ROW_COUNT
 		///   JSON_FMT_MODE_COLUMN_NAMES
 		///   JSON_FMT_MODE_FULL
+		///   JSON_FMT_MODE_NDJSON
 
 	bool printRowCount();
 		/// Returns true if row count printing is enabled,
@@ -114,9 +123,14 @@ public:
 		/// Returns true if full mode formatting is enabled,
 		/// false otherwise.
 
+	bool isNDJSON();
+		/// Returns true if newline-delimited formatting is enabled,
+		/// false otherwise.
+
 
 private:
 	void adjustPrefix();
+	void formatObject(const ValueVec& vals, std::ostream& str);
 
 	NameVecPtr _pNames;
 	int        _mode;
@@ -153,6 +167,12 @@ inline bool JSONRowFormatter::isFull()
 }
 
 
+inline bool JSONRowFormatter::isNDJSON()
+{
+	return (_mode & JSON_FMT_MODE_NDJSON) != 0;
+}
+
+
 } } // namespace Poco::SQL
 
 
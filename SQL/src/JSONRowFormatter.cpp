@@ -31,6 +31,7 @@ const int JSONRowFormatter::JSON_FMT_MODE_SMALL;
 const int JSONRowFormatter::JSON_FMT_MODE_ROW_COUNT;
 const int JSONRowFormatter::JSON_FMT_MODE_COLUMN_NAMES;
 const int JSONRowFormatter::JSON_FMT_MODE_FULL;
+const int JSONRowFormatter::JSON_FMT_MODE_NDJSON;
 
 
 JSONRowFormatter::JSONRowFormatter(int mode) : RowFormatter("{", "]}"),
@@ -53,7 +54,12 @@ JSONRowFormatter::~JSONRowFormatter()
 
 void JSONRowFormatter::adjustPrefix()
 {
-	if (printRowCount())
+	if (isNDJSON())
+	{
+		setPrefix("");
+		setPostfix("");
+	}
+	else if (printRowCount())
 	{
 		std::ostringstream ostr;
 		ostr << "{\"count\":" << getTotalRowCount() << ",";
@@ -66,6 +72,13 @@ void JSONRowFormatter::adjustPrefix()
 
 void JSONRowFormatter::setJSONMode(int mode)
 {
+	if (mode == JSON_FMT_MODE_NDJSON)
+	{
+		_mode = mode;
+		adjustPrefix();
+		return;
+	}
+
 	if (mode < JSON_FMT_MODE_SMALL ||
 		mode > (JSON_FMT_MODE_SMALL | JSON_FMT_MODE_ROW_COUNT | JSON_FMT_MODE_COLUMN_NAMES | JSON_FMT_MODE_FULL))
 	{
@@ -91,6 +104,13 @@ void JSONRowFormatter::setJSONMode(int mode)
 std::string& JSONRowFormatter::formatValues(const ValueVec& vals, std::string& formattedValues)
 {
 	std::ostringstream str;
+	if (isNDJSON())
+	{
+		formatObject(vals, str);
+		str << '\n';
+		return formattedValues = str.str();
+	}
+
 	if (!_firstTime) str << ',';
 	if (isSmall())
 	{
@@ -129,40 +149,46 @@ std::string& JSONRowFormatter::formatValues(const ValueVec& vals, std::string& f
 	}
 	else if (isFull())
 	{
-		str << '{';
-		ValueVec::const_iterator it = vals.begin();
-		ValueVec::const_iterator end = vals.end();
-		NameVec::iterator nIt = _pNames->begin();
-		NameVec::iterator nEnd = _pNames->end();
-		for (; it != end && nIt != nEnd; ++nIt)
+		formatObject(vals, str);
+	}
+
+	_firstTime = false;
+	return formattedValues = str.str();
+}
+
+
+void JSONRowFormatter::formatObject(const ValueVec& vals, std::ostream& str)
+{
+	str << '{';
+	ValueVec::const_iterator it = vals.begin();
+	ValueVec::const_iterator end = vals.end();
+	NameVec::iterator nIt = _pNames->begin();
+	NameVec::iterator nEnd = _pNames->end();
+	for (; it != end && nIt != nEnd; ++nIt)
+	{
+		if (!it->isEmpty())
 		{
-			if (!it->isEmpty())
+			if (it->isString() || it->isDate() || it->isTime())
 			{
-				if (it->isString() || it->isDate() || it->isTime())
-				{
-					std::string val = it->convert<std::string>();
-					trimInPlace(val);
-					str << '"' << *nIt << "\":" << toJSON(val);
-				}
-				else
-					str << '"' << *nIt << "\":" << it->convert<std::string>();
+				std::string val = it->convert<std::string>();
+				trimInPlace(val);
+				str << '"' << *nIt << "\":" << toJSON(val);
 			}
 			else
-				str << '"' << *nIt << "\":null";
-
-			if (++it != end) str << ',';
+				str << '"' << *nIt << "\":" << it->convert<std::string>();
 		}
-		str << '}';
-	}
+		else
+			str << '"' << *nIt << "\":null";
 
-	_firstTime = false;
-	return formattedValues = str.str();
+		if (++it != end) str << ',';
+	}
+	str << '}';
 }
 
 
 std::string& JSONRowFormatter::formatNames(const NameVecPtr pNames, std::string& formattedNames)
 {
-	if (isFull())
+	if (isFull() || isNDJSON())
 	{
 		// names are used in formatValues
 		if (pNames && !_pNames) _pNames = pNames;
@@ -1235,6 +1235,14 @@ void SQLTest::testJSONRowFormatter()
 	assertTrue (row1.namesToString() == "");
 	assertTrue (row1.valuesToString() == "{\"field0\":0,\"field1\":\"1\",\"field2\":\"2007-03-13T08:12:15Z\",\"field3\":null,\"field4\":4}");
 	assertTrue (row1.valuesToString() == ",{\"field0\":0,\"field1\":\"1\",\"field2\":\"2007-03-13T08:12:15Z\",\"field3\":null,\"field4\":4}");
+
+	row1.setFormatter(new JSONRowFormatter(JSONRowFormatter::JSON_FMT_MODE_NDJSON));
+	assertTrue (row1.getFormatter().prefix() == "");
+	assertTrue (row1.getFormatter().postfix() == "");
+	assertTrue (row1.getFormatter().getMode() == RowFormatter::FORMAT_PROGRESSIVE);
+	assertTrue (row1.namesToString() == "");
+	assertTrue (row1.valuesToString() == "{\"field0\":0,\"field1\":\"1\",\"field2\":\"2007-03-13T08:12:15Z\",\"field3\":null,\"field4\":4}\n");
+	assertTrue (row1.valuesToString() == "{\"field0\":0,\"field1\":\"1\",\"field2\":\"2007-03-13T08:12:15Z\",\"field3\":null,\"field4\":4}\n");
 }
 
 
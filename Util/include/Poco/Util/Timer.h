@@ -20,7 +20,9 @@
 
 #include "Poco/Util/Util.h"
 #include "Poco/Util/TimerTask.h"
-#include "Poco/TimedNotificationQueue.h"
+#include "Poco/TimingWheel.h"
+#include "Poco/Mutex.h"
+#include "Poco/Condition.h"
 #include "Poco/Thread.h"
 #include "Poco/Runnable.h"
 
@@ -41,6 +43,12 @@ class Util_API Timer: protected Poco::Runnable
 	/// Timer is safe for multithreaded use - multiple threads can schedule
 	/// new tasks simultaneously.
 	///
+	/// Scheduled tasks are kept in a Poco::TimingWheel with a resolution
+	/// of one millisecond, so scheduling a task takes constant time,
+	/// regardless of the number of pending tasks. Tasks are executed
+	/// no earlier than the time they have been scheduled for, but
+	/// may be executed up to one millisecond later.
+	///
 	/// Acknowledgement: The interface of this class has been inspired by
 	/// the java.util.Timer class from Java 1.3.
 {
@@ -161,9 +169,19 @@ protected:
 private:
 	Timer(const Timer&);
 	Timer& operator = (const Timer&);
+
+	void scheduleTimeout(Poco::TimingWheel::Timeout::Ptr pTimeout, Poco::Clock clock);
 	
-	Poco::TimedNotificationQueue _queue;
-	Poco::Thread _thread;
+	Poco::TimingWheel _wheel;
+	Poco::Mutex       _mutex;
+	Poco::Condition   _wakeUp;
+	Poco::Condition   _idle;
+	Poco::Clock       _wakeUpTime;
+	Poco::UInt64      _generation;
+	Poco::UInt64      _runGeneration;
+	bool              _running;
+	bool              _stopped;
+	Poco::Thread      _thread;
 };
 
 
@@ -73,7 +73,7 @@ private:
 	Poco::Timestamp _lastExecution;
 	bool _isCancelled;
 	
-	friend class TaskNotification;
+	friend class TaskTimeout;
 };
 
 
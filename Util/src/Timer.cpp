@@ -13,9 +13,8 @@
 
 
 #include "Poco/Util/Timer.h"
-#include "Poco/Notification.h"
 #include "Poco/ErrorHandler.h"
-#include "Poco/Event.h"
+#include "Poco/ScopedUnlock.h"
 
 
 using Poco::ErrorHandler;
@@ -25,102 +24,15 @@ namespace Poco {
 namespace Util {
 
 
-class TimerNotification: public Poco::Notification
+class TaskTimeout: public Poco::TimingWheel::Timeout
 {
 public:
-	TimerNotification(Poco::TimedNotificationQueue& queue):
-		_queue(queue)
-	{
-	}
-
-	~TimerNotification()
-	{
-	}
-
-	virtual bool execute() = 0;
-
-	Poco::TimedNotificationQueue& queue()
-	{
-		return _queue;
-	}
-
-private:
-	Poco::TimedNotificationQueue& _queue;
-};
-
-
-class StopNotification: public TimerNotification
-{
-public:
-	StopNotification(Poco::TimedNotificationQueue& queue):
-		TimerNotification(queue)
-	{
-	}
-
-	~StopNotification()
-	{
-	}
-
-	bool execute()
-	{
-		queue().clear();
-		return false;
-	}
-};
-
-
-class CancelNotification: public TimerNotification
-{
-public:
-	CancelNotification(Poco::TimedNotificationQueue& queue):
-		TimerNotification(queue)
-	{
-	}
-
-	~CancelNotification()
-	{
-	}
-
-	bool execute()
-	{
-		// Check if there's a StopNotification pending.
-		Poco::AutoPtr<TimerNotification> pNf = static_cast<TimerNotification*>(queue().dequeueNotification());
-		while (pNf)
-		{
-			if (pNf.cast<StopNotification>())
-			{
-				queue().clear();
-				_finished.set();
-				return false;
-			}
-			pNf = static_cast<TimerNotification*>(queue().dequeueNotification());
-		}
-
-		queue().clear();
-		_finished.set();
-		return true;
-	}
-
-	void wait()
-	{
-		_finished.wait();
-	}
-
-private:
-	Poco::Event _finished;
-};
-
-
-class TaskNotification: public TimerNotification
-{
-public:
-	TaskNotification(Poco::TimedNotificationQueue& queue, TimerTask::Ptr pTask):
-		TimerNotification(queue),
+	TaskTimeout(TimerTask::Ptr pTask):
 		_pTask(pTask)
 	{
 	}
 
-	~TaskNotification()
+	~TaskTimeout()
 	{
 	}
 
@@ -129,7 +41,7 @@ public:
 		return _pTask;
 	}
 
-	bool execute()
+	void execute()
 	{
 		if (!_pTask->isCancelled())
 		{
@@ -151,7 +63,10 @@ public:
 				ErrorHandler::handle();
 			}
 		}
-		return true;
+	}
+
+	virtual void reschedule(Poco::TimingWheel& /*wheel*/)
+	{
 	}
 
 private:
@@ -159,33 +74,27 @@ private:
 };
 
 
-class PeriodicTaskNotification: public TaskNotification
+class PeriodicTaskTimeout: public TaskTimeout
 {
 public:
-	PeriodicTaskNotification(Poco::TimedNotificationQueue& queue, TimerTask::Ptr pTask, long interval):
-		TaskNotification(queue, pTask),
+	PeriodicTaskTimeout(TimerTask::Ptr pTask, long interval):
+		TaskTimeout(pTask),
 		_interval(interval)
 	{
 	}
 
-	~PeriodicTaskNotification()
+	~PeriodicTaskTimeout()
 	{
 	}
 
-	bool execute()
+	void reschedule(Poco::TimingWheel& wheel)
 	{
-		TaskNotification::execute();
-
 		if (!task()->isCancelled())
 		{
-			Poco::Clock now;
 			Poco::Clock nextExecution;
 			nextExecution += static_cast<Poco::Clock::ClockDiff>(_interval)*1000;
-			if (nextExecution < now) nextExecution = now;
-			queue().enqueueNotification(this, nextExecution);
-			duplicate();
+			wheel.schedule(Poco::TimingWheel::Timeout::Ptr(this, true), nextExecution);
 		}
-		return true;
 	}
 
 private:
@@ -193,33 +102,29 @@ private:
 };
 
 
-class FixedRateTaskNotification: public TaskNotification
+class FixedRateTaskTimeout: public TaskTimeout
 {
 public:
-	FixedRateTaskNotification(Poco::TimedNotificationQueue& queue, TimerTask::Ptr pTask, long interval, Poco::Clock clock):
-		TaskNotification(queue, pTask),
+	FixedRateTaskTimeout(TimerTask::Ptr pTask, long interval, Poco::Clock clock):
+		TaskTimeout(pTask),
 		_interval(interval),
 		_nextExecution(clock)
 	{
 	}
 
-	~FixedRateTaskNotification()
+	~FixedRateTaskTimeout()
 	{
 	}
 
-	bool execute()
+	void reschedule(Poco::TimingWheel& wheel)
 	{
-		TaskNotification::execute();
-
 		if (!task()->isCancelled())
 		{
 			Poco::Clock now;
 			_nextExecution += static_cast<Poco::Clock::ClockDiff>(_interval)*1000;
 			if (_nextExecution < now) _nextExecution = now;
-			queue().enqueueNotification(this, _nextExecution);
-			duplicate();
+			wheel.schedule(Poco::TimingWheel::Timeout::Ptr(this, true), _nextExecution);
 		}
-		return true;
 	}
 
 private:
@@ -228,20 +133,49 @@ private:
 };
 
 
-Timer::Timer()
+namespace
+{
+	const long MAX_WAIT = 3600000; // milliseconds
+
+	Poco::Clock toClock(const Poco::Timestamp& time)
+	{
+		Poco::Timestamp tsNow;
+		Poco::Clock clock;
+		clock += time - tsNow;
+		return clock;
+	}
+}
+
+
+Timer::Timer():
+	_wakeUpTime(Poco::Clock::CLOCKVAL_MIN),
+	_generation(0),
+	_runGeneration(0),
+	_running(false),
+	_stopped(false)
 {
 	_thread.start(*this);
 }
 
 
-Timer::Timer(Poco::Thread::Priority priority)
+Timer::Timer(Poco::Thread::Priority priority):
+	_wakeUpTime(Poco::Clock::CLOCKVAL_MIN),
+	_generation(0),
+	_runGeneration(0),
+	_running(false),
+	_stopped(false)
 {
 	_thread.setPriority(priority);
 	_thread.start(*this);
 }
 
 
-Timer::Timer(int prio, int policy)
+Timer::Timer(int prio, int policy):
+	_wakeUpTime(Poco::Clock::CLOCKVAL_MIN),
+	_generation(0),
+	_runGeneration(0),
+	_running(false),
+	_stopped(false)
 {
 	_thread.setOSPriority(prio, policy);
 	_thread.start(*this);
@@ -252,7 +186,12 @@ Timer::~Timer()
 {
 	try
 	{
-		_queue.enqueueNotification(new StopNotification(_queue), Poco::Clock(0));
+		{
+			Poco::Mutex::ScopedLock lock(_mutex);
+			_stopped = true;
+			_wheel.clear();
+			_wakeUp.signal();
+		}
 		_thread.join();
 	}
 	catch (...)
@@ -264,11 +203,15 @@ Timer::~Timer()
 
 void Timer::cancel(bool wait)
 {
-	Poco::AutoPtr<CancelNotification> pNf = new CancelNotification(_queue);
-	_queue.enqueueNotification(pNf, Poco::Clock(0));
-	if (wait)
+	Poco::Mutex::ScopedLock lock(_mutex);
+	_wheel.clear();
+	++_generation;
+	if (wait && Poco::Thread::current() != &_thread)
 	{
-		pNf->wait();
+		while (_running && _runGeneration != _generation)
+		{
+			_idle.wait(_mutex);
+		}
 	}
 }
 
@@ -276,14 +219,14 @@ void Timer::cancel(bool wait)
 void Timer::schedule(TimerTask::Ptr pTask, Poco::Timestamp time)
 {
 	validateTask(pTask);
-	_queue.enqueueNotification(new TaskNotification(_queue, pTask), time);
+	scheduleTimeout(new TaskTimeout(pTask), toClock(time));
 }
 
 
 void Timer::schedule(TimerTask::Ptr pTask, Poco::Clock clock)
 {
 	validateTask(pTask);
-	_queue.enqueueNotification(new TaskNotification(_queue, pTask), clock);
+	scheduleTimeout(new TaskTimeout(pTask), clock);
 }
 
 
@@ -298,14 +241,14 @@ void Timer::schedule(TimerTask::Ptr pTask, long delay, long interval)
 void Timer::schedule(TimerTask::Ptr pTask, Poco::Timestamp time, long interval)
 {
 	validateTask(pTask);
-	_queue.enqueueNotification(new PeriodicTaskNotification(_queue, pTask, interval), time);
+	scheduleTimeout(new PeriodicTaskTimeout(pTask, interval), toClock(time));
 }
 
 
 void Timer::schedule(TimerTask::Ptr pTask, Poco::Clock clock, long interval)
 {
 	validateTask(pTask);
-	_queue.enqueueNotification(new PeriodicTaskNotification(_queue, pTask, interval), clock);
+	scheduleTimeout(new PeriodicTaskTimeout(pTask, interval), clock);
 }
 
 
@@ -320,28 +263,81 @@ void Timer::scheduleAtFixedRate(TimerTask::Ptr pTask, long delay, long interval)
 void Timer::scheduleAtFixedRate(TimerTask::Ptr pTask, Poco::Timestamp time, long interval)
 {
 	validateTask(pTask);
-	Poco::Timestamp tsNow;
-	Poco::Clock clock;
-	Poco::Timestamp::TimeDiff diff = time - tsNow;
-	clock += diff;
-	_queue.enqueueNotification(new FixedRateTaskNotification(_queue, pTask, interval, clock), clock);
+	Poco::Clock clock = toClock(time);
+	scheduleTimeout(new FixedRateTaskTimeout(pTask, interval, clock), clock);
 }
 
 
 void Timer::scheduleAtFixedRate(TimerTask::Ptr pTask, Poco::Clock clock, long interval)
 {
 	validateTask(pTask);
-	_queue.enqueueNotification(new FixedRateTaskNotification(_queue, pTask, interval, clock), clock);
+	scheduleTimeout(new FixedRateTaskTimeout(pTask, interval, clock), clock);
+}
+
+
+void Timer::scheduleTimeout(Poco::TimingWheel::Timeout::Ptr pTimeout, Poco::Clock clock)
+{
+	Poco::Mutex::ScopedLock lock(_mutex);
+	_wheel.schedule(pTimeout, clock);
+
+	// Only wake up the timer thread if it sleeps past the new deadline.
+	if (clock < _wakeUpTime) _wakeUp.signal();
 }
 
 
 void Timer::run()
 {
-	bool cont = true;
-	while (cont)
+	Poco::TimingWheel::TimeoutVec expired;
+	Poco::Mutex::ScopedLock lock(_mutex);
+	while (!_stopped)
 	{
-		Poco::AutoPtr<TimerNotification> pNf = static_cast<TimerNotification*>(_queue.waitDequeueNotification());
-		cont = pNf->execute();
+		_wheel.advance(Poco::Clock(), expired);
+		if (expired.empty())
+		{
+			Poco::Clock deadline;
+			if (_wheel.nextDeadline(deadline))
+			{
+				Poco::Clock::ClockDiff wait = deadline - Poco::Clock();
+				if (wait > 0)
+				{
+					Poco::Clock::ClockDiff milliseconds = (wait + 999)/1000;
+					_wakeUpTime = deadline;
+					_wakeUp.tryWait(_mutex, milliseconds < MAX_WAIT ? static_cast<long>(milliseconds) : MAX_WAIT);
+				}
+			}
+			else
+			{
+				_wakeUpTime = Poco::Clock(Poco::Clock::CLOCKVAL_MAX);
+				_wakeUp.wait(_mutex);
+			}
+			_wakeUpTime = Poco::Clock(Poco::Clock::CLOCKVAL_MIN);
+		}
+		else
+		{
+			// Tasks run without holding the mutex, so they can schedule
+			// further tasks. A cancel() stops the rest of the batch.
+			_running = true;
+			_runGeneration = _generation;
+			for (Poco::TimingWheel::TimeoutVec::iterator it = expired.begin(); it != expired.end(); ++it)
+			{
+				if (_stopped || _runGeneration != _generation) break;
+				TaskTimeout* pTimeout = static_cast<TaskTimeout*>(it->get());
+				{
+					Poco::ScopedUnlock<Poco::Mutex> unlock(_mutex);
+					pTimeout->execute();
+				}
+				if (!_stopped && _runGeneration == _generation)
+				{
+					pTimeout->reschedule(_wheel);
+				}
+			}
+			{
+				Poco::ScopedUnlock<Poco::Mutex> unlock(_mutex);
+				expired.clear();
+			}
+			_running = false;
+			_idle.broadcast();
+		}
 	}
 }
 
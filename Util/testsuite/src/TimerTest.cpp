@@ -13,6 +13,8 @@
 #include "Poco/CppUnit/TestSuite.h"
 #include "Poco/Util/Timer.h"
 #include "Poco/Util/TimerTaskAdapter.h"
+#include "Poco/AtomicCounter.h"
+#include "Poco/Random.h"
 
 
 using Poco::Util::Timer;
@@ -22,6 +24,36 @@ using Poco::Timestamp;
 using Poco::Clock;
 
 
+namespace
+{
+	class CountingTask: public TimerTask
+	{
+	public:
+		CountingTask(Clock due, Poco::AtomicCounter& counter, Poco::AtomicCounter& early, Poco::Event& done, int total):
+			_due(due),
+			_counter(counter),
+			_early(early),
+			_done(done),
+			_total(total)
+		{
+		}
+
+		void run()
+		{
+			if (Clock() < _due) ++_early;
+			if (++_counter == _total) _done.set();
+		}
+
+	private:
+		Clock _due;
+		Poco::AtomicCounter& _counter;
+		Poco::AtomicCounter& _early;
+		Poco::Event& _done;
+		int _total;
+	};
+}
+
+
 TimerTest::TimerTest(const std::string& name): CppUnit::TestCase(name)
 {
 }
@@ -260,6 +292,28 @@ void TimerTest::testCancelAllWaitStop()
 }
 
 
+void TimerTest::testScheduleMany()
+{
+	const int count = 20000;
+	Poco::AtomicCounter counter;
+	Poco::AtomicCounter early;
+	Poco::Event done;
+	Poco::Random rnd;
+
+	Timer timer;
+	for (int i = 0; i < count; ++i)
+	{
+		Clock due;
+		due += rnd.next(200000);
+		timer.schedule(new CountingTask(due, counter, early, done, count), due);
+	}
+
+	assertTrue (done.tryWait(10000));
+	assertTrue (counter.value() == count);
+	assertTrue (early.value() == 0);
+}
+
+
 void TimerTest::setUp()
 {
 }
@@ -290,6 +344,7 @@ CppUnit::Test* TimerTest::suite()
 	CppUnit_addTest(pSuite, TimerTest, testCancel);
 	CppUnit_addTest(pSuite, TimerTest, testCancelAllStop);
 	CppUnit_addTest(pSuite, TimerTest, testCancelAllWaitStop);
+	CppUnit_addTest(pSuite, TimerTest, testScheduleMany);
 
 	return pSuite;
 }
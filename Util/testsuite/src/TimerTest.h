@@ -35,6 +35,7 @@ public:
 	void testCancel();
 	void testCancelAllStop();
 	void testCancelAllWaitStop();
+	void testScheduleMany();
 
 	void setUp();
 	void tearDown();